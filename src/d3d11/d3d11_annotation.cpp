@@ -37,7 +37,7 @@ namespace dxvk {
   D3D11UserDefinedAnnotation<ContextType>::D3D11UserDefinedAnnotation(
           ContextType*          container,
     const Rc<DxvkDevice>&       dxvkDevice)
-  : m_container(container), m_eventDepth(0),
+  : m_container(container), m_gpuProfiler(&dxvkDevice->gpuProfiler()), m_eventDepth(0),
     m_annotationsEnabled(dxvkDevice->instance()->extensions().extDebugUtils) {
     if (!IsDeferred && m_annotationsEnabled)
       RegisterUserDefinedAnnotation<true>(this);
@@ -75,7 +75,7 @@ namespace dxvk {
   INT STDMETHODCALLTYPE D3D11UserDefinedAnnotation<ContextType>::BeginEvent(
           D3DCOLOR                Color,
           LPCWSTR                 Name) {
-    if (!m_annotationsEnabled)
+    if (!AnnotationsEnabled())
       return -1;
 
     D3D10DeviceLock lock = m_container->LockContext();
@@ -96,7 +96,7 @@ namespace dxvk {
 
   template<typename ContextType>
   INT STDMETHODCALLTYPE D3D11UserDefinedAnnotation<ContextType>::EndEvent() {
-    if (!m_annotationsEnabled)
+    if (!AnnotationsEnabled())
       return -1;
 
     D3D10DeviceLock lock = m_container->LockContext();
@@ -113,7 +113,7 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11UserDefinedAnnotation<ContextType>::SetMarker(
           D3DCOLOR                Color,
           LPCWSTR                 Name) {
-    if (!m_annotationsEnabled)
+    if (!AnnotationsEnabled())
       return;
 
     D3D10DeviceLock lock = m_container->LockContext();
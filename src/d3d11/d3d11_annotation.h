@@ -48,9 +48,14 @@ namespace dxvk {
 
   private:
 
-    ContextType*  m_container;
-    int32_t       m_eventDepth;
-    bool          m_annotationsEnabled;
+    ContextType*      m_container;
+    DxvkGpuProfiler*  m_gpuProfiler;
+    int32_t           m_eventDepth;
+    bool              m_annotationsEnabled;
+
+    bool AnnotationsEnabled() const {
+      return m_annotationsEnabled || m_gpuProfiler->isEnabled();
+    }
   };
 
 }
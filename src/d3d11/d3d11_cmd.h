@@ -1,5 +1,8 @@
 #pragma once
 
+#include "../dxvk/dxvk_buffer.h"
+#include "../dxvk/dxvk_image.h"
+
 #include "d3d11_include.h"
 
 namespace dxvk {
@@ -13,9 +16,23 @@ namespace dxvk {
   enum class D3D11CmdType {
     DrawIndirect,
     DrawIndirectIndexed,
+    CopyImage,
+    BindVertexBuffers,
   };
 
 
+  /**
+   * \brief Maximum number of regions per batched image copy
+   */
+  constexpr uint32_t D3D11MaxBatchedImageCopies = 32;
+
+
+  /**
+   * \brief Maximum number of bindings per batched vertex buffer update
+   */
+  constexpr uint32_t D3D11MaxBatchedVertexBuffers = 8;
+
+
   /**
    * \brief Command data header
    * 
@@ -40,4 +57,36 @@ namespace dxvk {
     uint32_t            stride;
   };
 
-}
\ No newline at end of file
+
+  /**
+   * \brief Batched image copy command data
+   *
+   * Stores consecutive image-to-image copies into the
+   * same destination image, so that they can be executed
+   * with one set of barriers. Destination extents are
+   * kept around in order to detect overlapping copies.
+   */
+  struct D3D11CmdCopyImageData : public D3D11CmdData {
+    Rc<DxvkImage>       dstImage;
+    uint32_t            count;
+    DxvkImageCopyRegion regions[D3D11MaxBatchedImageCopies];
+    VkExtent3D          dstExtents[D3D11MaxBatchedImageCopies];
+  };
+
+
+
+  /**
+   * \brief Batched vertex buffer binding command data
+   *
+   * Stores consecutive vertex buffer binding updates,
+   * so that setting multiple vertex buffers only
+   * requires one command on the CS thread.
+   */
+  struct D3D11CmdBindVertexBuffersData : public D3D11CmdData {
+    uint32_t            count;
+    uint32_t            slots[D3D11MaxBatchedVertexBuffers];
+    uint32_t            strides[D3D11MaxBatchedVertexBuffers];
+    DxvkBufferSlice     buffers[D3D11MaxBatchedVertexBuffers];
+  };
+
+}
@@ -107,6 +107,36 @@ namespace dxvk {
   }
   
   
+  void D3D11CommandList::Finalize() {
+    if (m_resources.size() < 2)
+      return;
+
+    // Only the last use of each subresource matters when the
+    // application later maps it. Entries are ordered by chunk
+    // ID, so walk backwards and keep the first entry we see.
+    std::unordered_set<TrackedSubresource, DxvkHash, DxvkEq> seen;
+
+    size_t count = 0;
+
+    for (size_t i = m_resources.size(); i > 0; i--) {
+      TrackedResource& entry = m_resources[i - 1];
+
+      TrackedSubresource key;
+      key.resource    = entry.ref.Get();
+      key.subresource = entry.ref.GetSubresource();
+
+      if (seen.insert(key).second) {
+        size_t dst = m_resources.size() - (++count);
+
+        if (dst != i - 1)
+          m_resources[dst] = std::move(entry);
+      }
+    }
+
+    m_resources.erase(m_resources.begin(), m_resources.end() - count);
+  }
+
+
   void D3D11CommandList::TrackResourceUsage(
           ID3D11Resource*     pResource,
           D3D11_RESOURCE_DIMENSION ResourceType,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <unordered_set>
 
 #include "d3d11_context.h"
 
@@ -36,6 +37,16 @@ namespace dxvk {
     void EmitToCsThread(
       const D3D11ChunkDispatchProc& DispatchProc);
 
+    /**
+     * \brief Finalizes command list
+     *
+     * Must be called once recording is complete. Compacts
+     * the resource tracking table so that executing the
+     * command list only updates each tracked subresource
+     * once, no matter how often it was used.
+     */
+    void Finalize();
+
     void TrackResourceUsage(
             ID3D11Resource*     pResource,
             D3D11_RESOURCE_DIMENSION ResourceType,
@@ -49,6 +60,23 @@ namespace dxvk {
       uint64_t          chunkId;
     };
 
+    struct TrackedSubresource {
+      ID3D11Resource*   resource;
+      UINT              subresource;
+
+      bool eq(const TrackedSubresource& other) const {
+        return resource    == other.resource
+            && subresource == other.subresource;
+      }
+
+      size_t hash() const {
+        DxvkHashState hash;
+        hash.add(reinterpret_cast<uintptr_t>(resource));
+        hash.add(subresource);
+        return hash;
+      }
+    };
+
     UINT m_contextFlags;
     
     std::vector<DxvkCsChunkRef>         m_chunks;
@@ -707,18 +707,16 @@ namespace dxvk {
     VkImageAspectFlags  clearAspect = formatInfo->aspectMask & (VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_DEPTH_BIT);
 
     // Clear all the rectangles that are specified
-    for (uint32_t i = 0; i < NumRects || i < 1; i++) {
-      if (pRect) {
-        if (pRect[i].left >= pRect[i].right
-        || pRect[i].top >= pRect[i].bottom)
-          continue;
-      }
-
-      if (bufView != nullptr) {
+    if (bufView != nullptr) {
+      for (uint32_t i = 0; i < NumRects || i < 1; i++) {
         VkDeviceSize offset = 0;
         VkDeviceSize length = bufView->info().rangeLength / formatInfo->elementSize;
 
         if (pRect) {
+          if (pRect[i].left >= pRect[i].right
+          || pRect[i].top >= pRect[i].bottom)
+            continue;
+
           offset = pRect[i].left;
           length = pRect[i].right - pRect[i].left;
         }
@@ -736,46 +734,70 @@ namespace dxvk {
             cClearValue.color);
         });
       }
+    }
 
-      if (imgView != nullptr) {
-        VkOffset3D offset = { 0, 0, 0 };
-        VkExtent3D extent = imgView->mipLevelExtent(0);
+    if (imgView != nullptr) {
+      // Gather all valid rects so that they can be cleared with
+      // a single clear operation rather than one clear per rect
+      std::vector<VkRect2D> rects;
 
-        if (pRect) {
-          offset = { pRect[i].left, pRect[i].top, 0 };
-          extent = {
+      if (pRect) {
+        rects.reserve(NumRects);
+
+        for (uint32_t i = 0; i < NumRects; i++) {
+          if (pRect[i].left >= pRect[i].right
+          || pRect[i].top >= pRect[i].bottom)
+            continue;
+
+          VkRect2D& rect = rects.emplace_back();
+          rect.offset = { pRect[i].left, pRect[i].top };
+          rect.extent = {
             uint32_t(pRect[i].right - pRect[i].left),
-            uint32_t(pRect[i].bottom - pRect[i].top), 1 };
+            uint32_t(pRect[i].bottom - pRect[i].top) };
         }
+      } else {
+        VkExtent3D extent = imgView->mipLevelExtent(0);
 
-        EmitCs([
-          cImageView    = imgView,
-          cAreaOffset   = offset,
-          cAreaExtent   = extent,
-          cClearAspect  = clearAspect,
-          cClearValue   = clearValue
-        ] (DxvkContext* ctx) {
-          const VkImageUsageFlags rtUsage =
-            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
-            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        VkRect2D& rect = rects.emplace_back();
+        rect.offset = { 0, 0 };
+        rect.extent = { extent.width, extent.height };
+      }
 
-          bool isFullSize = cImageView->mipLevelExtent(0) == cAreaExtent;
+      if (rects.empty())
+        return;
 
-          if ((cImageView->info().usage & rtUsage) && isFullSize) {
-            ctx->clearRenderTarget(
-              cImageView,
-              cClearAspect,
-              cClearValue);
-          } else {
-            ctx->clearImageView(
-              cImageView,
-              cAreaOffset,
-              cAreaExtent,
-              cClearAspect,
-              cClearValue);
-          }
-        });
-      }
+      EmitCs([
+        cImageView    = imgView,
+        cRects        = std::move(rects),
+        cClearAspect  = clearAspect,
+        cClearValue   = clearValue
+      ] (DxvkContext* ctx) {
+        const VkImageUsageFlags rtUsage =
+          VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+          VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+        VkExtent3D extent = cImageView->mipLevelExtent(0);
+
+        bool isFullSize = cRects.size() == 1
+          && cRects[0].offset.x == 0
+          && cRects[0].offset.y == 0
+          && cRects[0].extent.width  == extent.width
+          && cRects[0].extent.height == extent.height;
+
+        if ((cImageView->info().usage & rtUsage) && isFullSize) {
+          ctx->clearRenderTarget(
+            cImageView,
+            cClearAspect,
+            cClearValue);
+        } else {
+          ctx->clearImageViewRects(
+            cImageView,
+            cRects.size(),
+            cRects.data(),
+            cClearAspect,
+            cClearValue);
+        }
+      });
     }
   }
 
@@ -964,11 +986,9 @@ namespace dxvk {
           UINT            StartVertexLocation) {
     D3D10DeviceLock lock = LockContext();
 
-    EmitCs([=] (DxvkContext* ctx) {
-      ctx->draw(
-        VertexCount, 1,
-        StartVertexLocation, 0);
-    });
+    EmitCs(DxvkCsDraw {
+      VertexCount, 1,
+      StartVertexLocation, 0 });
   }
 
 
@@ -979,12 +999,10 @@ namespace dxvk {
           INT             BaseVertexLocation) {
     D3D10DeviceLock lock = LockContext();
 
-    EmitCs([=] (DxvkContext* ctx) {
-      ctx->drawIndexed(
-        IndexCount, 1,
-        StartIndexLocation,
-        BaseVertexLocation, 0);
-    });
+    EmitCs(DxvkCsDrawIndexed {
+      IndexCount, 1,
+      StartIndexLocation,
+      BaseVertexLocation, 0 });
   }
 
 
@@ -996,13 +1014,11 @@ namespace dxvk {
           UINT            StartInstanceLocation) {
     D3D10DeviceLock lock = LockContext();
 
-    EmitCs([=] (DxvkContext* ctx) {
-      ctx->draw(
-        VertexCountPerInstance,
-        InstanceCount,
-        StartVertexLocation,
-        StartInstanceLocation);
-    });
+    EmitCs(DxvkCsDraw {
+      VertexCountPerInstance,
+      InstanceCount,
+      StartVertexLocation,
+      StartInstanceLocation });
   }
 
 
@@ -1015,14 +1031,12 @@ namespace dxvk {
           UINT            StartInstanceLocation) {
     D3D10DeviceLock lock = LockContext();
 
-    EmitCs([=] (DxvkContext* ctx) {
-      ctx->drawIndexed(
-        IndexCountPerInstance,
-        InstanceCount,
-        StartIndexLocation,
-        BaseVertexLocation,
-        StartInstanceLocation);
-    });
+    EmitCs(DxvkCsDrawIndexed {
+      IndexCountPerInstance,
+      InstanceCount,
+      StartIndexLocation,
+      BaseVertexLocation,
+      StartInstanceLocation });
   }
 
 
@@ -1103,12 +1117,10 @@ namespace dxvk {
           UINT            ThreadGroupCountZ) {
     D3D10DeviceLock lock = LockContext();
 
-    EmitCs([=] (DxvkContext* ctx) {
-      ctx->dispatch(
-        ThreadGroupCountX,
-        ThreadGroupCountY,
-        ThreadGroupCountZ);
-    });
+    EmitCs(DxvkCsDispatch {
+      ThreadGroupCountX,
+      ThreadGroupCountY,
+      ThreadGroupCountZ });
   }
 
 
@@ -1148,6 +1160,10 @@ namespace dxvk {
 
       if (!equal)
         ApplyInputLayout();
+      else
+        m_redundantCmdCount += 1;
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1159,6 +1175,8 @@ namespace dxvk {
     if (m_state.ia.primitiveTopology != Topology) {
       m_state.ia.primitiveTopology = Topology;
       ApplyPrimitiveTopology();
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1175,18 +1193,16 @@ namespace dxvk {
     for (uint32_t i = 0; i < NumBuffers; i++) {
       auto newBuffer = static_cast<D3D11Buffer*>(ppVertexBuffers[i]);
 
-      if (m_state.ia.vertexBuffers[StartSlot + i].buffer != newBuffer) {
+      if (m_state.ia.vertexBuffers[StartSlot + i].buffer != newBuffer
+       || m_state.ia.vertexBuffers[StartSlot + i].offset != pOffsets[i]
+       || m_state.ia.vertexBuffers[StartSlot + i].stride != pStrides[i]) {
         m_state.ia.vertexBuffers[StartSlot + i].buffer = newBuffer;
         m_state.ia.vertexBuffers[StartSlot + i].offset = pOffsets[i];
         m_state.ia.vertexBuffers[StartSlot + i].stride = pStrides[i];
 
         BindVertexBuffer(StartSlot + i, newBuffer, pOffsets[i], pStrides[i]);
-      } else if (m_state.ia.vertexBuffers[StartSlot + i].offset != pOffsets[i]
-              || m_state.ia.vertexBuffers[StartSlot + i].stride != pStrides[i]) {
-        m_state.ia.vertexBuffers[StartSlot + i].offset = pOffsets[i];
-        m_state.ia.vertexBuffers[StartSlot + i].stride = pStrides[i];
-
-        BindVertexBufferRange(StartSlot + i, newBuffer, pOffsets[i], pStrides[i]);
+      } else {
+        m_redundantCmdCount += 1;
       }
     }
 
@@ -1216,6 +1232,8 @@ namespace dxvk {
       m_state.ia.indexBuffer.format = Format;
 
       BindIndexBufferRange(newBuffer, Offset, Format);
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1303,6 +1321,8 @@ namespace dxvk {
       m_state.vs = shader;
 
       BindShader<DxbcProgramType::VertexShader>(GetCommonShader(shader));
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1441,6 +1461,8 @@ namespace dxvk {
       m_state.hs = shader;
 
       BindShader<DxbcProgramType::HullShader>(GetCommonShader(shader));
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1579,6 +1601,8 @@ namespace dxvk {
       m_state.ds = shader;
 
       BindShader<DxbcProgramType::DomainShader>(GetCommonShader(shader));
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1717,6 +1741,8 @@ namespace dxvk {
       m_state.gs = shader;
 
       BindShader<DxbcProgramType::GeometryShader>(GetCommonShader(shader));
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1855,6 +1881,8 @@ namespace dxvk {
       m_state.ps = shader;
 
       BindShader<DxbcProgramType::PixelShader>(GetCommonShader(shader));
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -1993,6 +2021,8 @@ namespace dxvk {
       m_state.cs = shader;
 
       BindShader<DxbcProgramType::ComputeShader>(GetCommonShader(shader));
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -2235,13 +2265,22 @@ namespace dxvk {
       m_state.om.sampleMask = SampleMask;
 
       ApplyBlendState();
+    } else {
+      m_redundantCmdCount += 1;
     }
 
     if (BlendFactor != nullptr) {
-      for (uint32_t i = 0; i < 4; i++)
+      bool dirty = false;
+
+      for (uint32_t i = 0; i < 4; i++) {
+        dirty |= m_state.om.blendFactor[i] != BlendFactor[i];
         m_state.om.blendFactor[i] = BlendFactor[i];
+      }
 
-      ApplyBlendFactor();
+      if (dirty)
+        ApplyBlendFactor();
+      else
+        m_redundantCmdCount += 1;
     }
   }
 
@@ -2257,6 +2296,8 @@ namespace dxvk {
     if (m_state.om.dsState != depthStencilState) {
       m_state.om.dsState = depthStencilState;
       ApplyDepthStencilState();
+    } else {
+      m_redundantCmdCount += 1;
     }
 
     // The D3D11 runtime only appears to store the low 8 bits,
@@ -2266,6 +2307,8 @@ namespace dxvk {
     if (m_state.om.stencilRef != StencilRef) {
       m_state.om.stencilRef = StencilRef;
       ApplyStencilRef();
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -2369,6 +2412,8 @@ namespace dxvk {
 
       if (currScissorEnable != nextScissorEnable)
         ApplyViewportState();
+    } else {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -2400,6 +2445,8 @@ namespace dxvk {
 
     if (dirty)
       ApplyViewportState();
+    else
+      m_redundantCmdCount += 1;
   }
 
 
@@ -2435,6 +2482,8 @@ namespace dxvk {
 
       if (rsDesc.ScissorEnable)
         ApplyViewportState();
+    } else if (!dirty) {
+      m_redundantCmdCount += 1;
     }
   }
 
@@ -2579,10 +2628,7 @@ namespace dxvk {
     m_state.pr.predicateObject = predicate;
     m_state.pr.predicateValue  = PredicateValue;
 
-    static bool s_errorShown = false;
-
-    if (pPredicate && !std::exchange(s_errorShown, true))
-      Logger::err("D3D11DeviceContext::SetPredication: Stub");
+    ApplyPredicate();
   }
 
 
@@ -3206,6 +3252,32 @@ namespace dxvk {
   }
   
   
+  template<typename ContextType>
+  void D3D11CommonContext<ContextType>::ApplyPredicate() {
+    DxvkBufferSlice predicate;
+
+    if (m_state.pr.predicateObject != nullptr) {
+      predicate = m_state.pr.predicateObject->GetPredicate();
+
+      static bool s_errorShown = false;
+
+      if (!predicate.defined() && !std::exchange(s_errorShown, true))
+        Logger::err("D3D11DeviceContext::SetPredication: Predicate not supported");
+    }
+
+    // D3D11 skips rendering if the predicate matches the given
+    // value, whereas Vulkan skips rendering if it is zero
+    EmitCs([
+      cPredicate  = std::move(predicate),
+      cFlags      = m_state.pr.predicateValue
+        ? VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT
+        : VkConditionalRenderingFlagsEXT(0)
+    ] (DxvkContext* ctx) {
+      ctx->setPredicate(cPredicate, cFlags);
+    });
+  }
+
+
   template<typename ContextType>
   void D3D11CommonContext<ContextType>::ApplyStencilRef() {
     EmitCs([
@@ -3354,9 +3426,14 @@ namespace dxvk {
   template<DxbcProgramType ShaderStage>
   void D3D11CommonContext<ContextType>::BindShader(
     const D3D11CommonShader*    pShaderModule) {
-    if (pShaderModule) {
+    // Shaders that failed deferred translation are treated as unbound
+    Rc<DxvkShader> shader;
+
+    if (pShaderModule)
+      shader = pShaderModule->GetShader();
+
+    if (shader != nullptr) {
       auto buffer = pShaderModule->GetIcb();
-      auto shader = pShaderModule->GetShader();
 
       if (unlikely(shader->needsLibraryCompile()))
         m_device->requestCompileShader(shader);
@@ -3449,45 +3526,34 @@ namespace dxvk {
           D3D11Buffer*                      pBuffer,
           UINT                              Offset,
           UINT                              Stride) {
-    if (pBuffer) {
-      EmitCs([
-        cSlotId       = Slot,
-        cBufferSlice  = pBuffer->GetBufferSlice(Offset),
-        cStride       = Stride
-      ] (DxvkContext* ctx) mutable {
-        ctx->bindVertexBuffer(cSlotId,
-          Forwarder::move(cBufferSlice),
-          cStride);
-      });
-    } else {
-      EmitCs([
-        cSlotId       = Slot
-      ] (DxvkContext* ctx) {
-        ctx->bindVertexBuffer(cSlotId, DxvkBufferSlice(), 0);
-      });
+    // Append the binding to the previous command if it is a vertex
+    // buffer update, since no other commands can have been recorded
+    auto cmdData = static_cast<D3D11CmdBindVertexBuffersData*>(m_cmdData);
+
+    if (!cmdData || cmdData->type != D3D11CmdType::BindVertexBuffers
+     || cmdData->count >= D3D11MaxBatchedVertexBuffers) {
+      cmdData = EmitCsCmd<D3D11CmdBindVertexBuffersData>(
+        [] (DxvkContext* ctx, const D3D11CmdBindVertexBuffersData* data) {
+          for (uint32_t i = 0; i < data->count; i++) {
+            ctx->bindVertexBuffer(data->slots[i],
+              DxvkBufferSlice(data->buffers[i]),
+              data->strides[i]);
+          }
+        });
+
+      cmdData->type  = D3D11CmdType::BindVertexBuffers;
+      cmdData->count = 0;
     }
-  }
-  
-  
-  template<typename ContextType>
-  void D3D11CommonContext<ContextType>::BindVertexBufferRange(
-          UINT                              Slot,
-          D3D11Buffer*                      pBuffer,
-          UINT                              Offset,
-          UINT                              Stride) {
-    if (pBuffer) {
-      VkDeviceSize offset = Offset;
-      VkDeviceSize length = pBuffer->GetRemainingSize(Offset);
 
-      EmitCs([
-        cSlotId       = Slot,
-        cBufferOffset = offset,
-        cBufferLength = length,
-        cStride       = Stride
-      ] (DxvkContext* ctx) mutable {
-        ctx->bindVertexBufferRange(cSlotId,
-          cBufferOffset, cBufferLength, cStride);
-      });
+    uint32_t index = cmdData->count++;
+    cmdData->slots[index] = Slot;
+
+    if (pBuffer) {
+      cmdData->buffers[index] = pBuffer->GetBufferSlice(Offset);
+      cmdData->strides[index] = Stride;
+    } else {
+      cmdData->buffers[index] = DxvkBufferSlice();
+      cmdData->strides[index] = 0;
     }
   }
 
@@ -3558,17 +3624,23 @@ namespace dxvk {
         cBufferSlice  = pBuffer->GetBufferSlice(),
         cCounterSlice = pBuffer->GetSOCounter()
       ] (DxvkContext* ctx) mutable {
-        if (cCounterSlice.defined() && cOffset != ~0u) {
+        // Resetting the counter to zero is very common and does not
+        // require an explicit buffer update, so avoid the render pass
+        // split that an update would cause in that case.
+        DxvkBufferSlice counterSlice = cCounterSlice;
+
+        ctx->bindXfbBuffer(cSlotId,
+          Forwarder::move(cBufferSlice),
+          Forwarder::move(cCounterSlice),
+          cOffset == 0u);
+
+        if (counterSlice.defined() && cOffset && cOffset != ~0u) {
           ctx->updateBuffer(
-            cCounterSlice.buffer(),
-            cCounterSlice.offset(),
+            counterSlice.buffer(),
+            counterSlice.offset(),
             sizeof(cOffset),
             &cOffset);
         }
-
-        ctx->bindXfbBuffer(cSlotId,
-          Forwarder::move(cBufferSlice),
-          Forwarder::move(cCounterSlice));
       });
     } else {
       EmitCs([
@@ -3821,6 +3893,60 @@ namespace dxvk {
   }
 
 
+  template<typename ContextType>
+  void D3D11CommonContext<ContextType>::BatchCopyImage(
+    const Rc<DxvkImage>&                    DstImage,
+    const VkImageSubresourceLayers&         DstLayers,
+          VkOffset3D                        DstOffset,
+          VkExtent3D                        DstExtent,
+    const Rc<DxvkImage>&                    SrcImage,
+    const VkImageSubresourceLayers&         SrcLayers,
+          VkOffset3D                        SrcOffset,
+          VkExtent3D                        SrcExtent) {
+    // Append the copy to the previous command if it is a copy into the
+    // same image, since no other commands can have been recorded since.
+    // Copies within a batch must not overlap since the backend may
+    // execute them in any order.
+    auto cmdData = static_cast<D3D11CmdCopyImageData*>(m_cmdData);
+
+    bool canBatch = cmdData
+      && cmdData->type == D3D11CmdType::CopyImage
+      && cmdData->dstImage == DstImage
+      && cmdData->count < D3D11MaxBatchedImageCopies;
+
+    for (uint32_t i = 0; i < (canBatch ? cmdData->count : 0u); i++) {
+      const auto& region = cmdData->regions[i];
+
+      if (vk::checkSubresourceRangeOverlap(
+            vk::makeSubresourceRange(region.dstSubresource),
+            vk::makeSubresourceRange(DstLayers))
+       && util::checkRegionOverlap(region.dstOffset, cmdData->dstExtents[i], DstOffset, DstExtent))
+        canBatch = false;
+    }
+
+    if (!canBatch) {
+      cmdData = EmitCsCmd<D3D11CmdCopyImageData>(
+        [] (DxvkContext* ctx, const D3D11CmdCopyImageData* data) {
+          ctx->copyImageBatch(data->dstImage, data->count, data->regions);
+        });
+
+      cmdData->type     = D3D11CmdType::CopyImage;
+      cmdData->dstImage = DstImage;
+      cmdData->count    = 0;
+    }
+
+    auto& region = cmdData->regions[cmdData->count];
+    region.srcImage       = SrcImage;
+    region.srcSubresource = SrcLayers;
+    region.srcOffset      = SrcOffset;
+    region.dstSubresource = DstLayers;
+    region.dstOffset      = DstOffset;
+    region.extent         = SrcExtent;
+
+    cmdData->dstExtents[cmdData->count++] = DstExtent;
+  }
+
+
   template<typename ContextType>
   void D3D11CommonContext<ContextType>::CopyImage(
           D3D11CommonTexture*               pDstTexture,
@@ -3891,7 +4017,10 @@ namespace dxvk {
     bool dstIsImage = pDstTexture->GetMapMode() != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING;
     bool srcIsImage = pSrcTexture->GetMapMode() != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING;
 
-    if (dstIsImage && srcIsImage) {
+    if (dstIsImage && srcIsImage && pDstTexture != pSrcTexture) {
+      BatchCopyImage(pDstTexture->GetImage(), *pDstLayers, DstOffset, dstExtent,
+        pSrcTexture->GetImage(), *pSrcLayers, SrcOffset, SrcExtent);
+    } else if (dstIsImage && srcIsImage) {
       EmitCs([
         cDstImage  = pDstTexture->GetImage(),
         cSrcImage  = pSrcTexture->GetImage(),
@@ -4362,6 +4491,9 @@ namespace dxvk {
       // Unbind indirect draw buffer
       ctx->bindDrawBuffers(DxvkBufferSlice(), DxvkBufferSlice());
 
+      // Disable predication
+      ctx->setPredicate(DxvkBufferSlice(), 0);
+
       // Unbind index and vertex buffers
       ctx->bindIndexBuffer(DxvkBufferSlice(), VK_INDEX_TYPE_UINT32);
 
@@ -4547,14 +4679,19 @@ namespace dxvk {
     uint32_t uavSlotId = computeUavBinding       (DxbcProgramType::PixelShader, 0);
     uint32_t ctrSlotId = computeUavCounterBinding(DxbcProgramType::PixelShader, 0);
 
-    for (uint32_t i = 0; i < m_state.om.maxUav; i++) {
-      if (CheckViewOverlap(pView, m_state.om.uavs[i].ptr())) {
-        m_state.om.uavs[i] = nullptr;
+    int32_t uavId = m_state.om.uavMask.findNext(0);
+
+    while (uavId >= 0) {
+      if (CheckViewOverlap(pView, m_state.om.uavs[uavId].ptr())) {
+        m_state.om.uavs[uavId] = nullptr;
+        m_state.om.uavMask.clr(uavId);
 
         BindUnorderedAccessView<DxbcProgramType::PixelShader>(
-          uavSlotId + i, nullptr,
-          ctrSlotId + i, ~0u);
+          uavSlotId + uavId, nullptr,
+          ctrSlotId + uavId, ~0u);
       }
+
+      uavId = m_state.om.uavMask.findNext(uavId + 1);
     }
   }
 
@@ -4579,6 +4716,7 @@ namespace dxvk {
     ApplyRasterizerState();
     ApplyRasterizerSampleCount();
     ApplyViewportState();
+    ApplyPredicate();
 
     BindDrawBuffers(
       m_state.id.argBuffer.ptr(),
@@ -4707,6 +4845,8 @@ namespace dxvk {
         bindings.buffers[StartSlot + i].constantBound  = constantCount;
 
         BindConstantBuffer<ShaderStage>(slotId + i, newBuffer, 0, constantCount);
+      } else {
+        m_redundantCmdCount += 1;
       }
     }
 
@@ -4773,6 +4913,8 @@ namespace dxvk {
         bindings.buffers[StartSlot + i].constantBound  = constantBound;
 
         BindConstantBufferRange<ShaderStage>(slotId + i, constantOffset, constantBound);
+      } else {
+        m_redundantCmdCount += 1;
       }
     }
 
@@ -4808,6 +4950,8 @@ namespace dxvk {
 
         bindings.views[StartSlot + i] = resView;
         BindShaderResource<ShaderStage>(slotId + i, resView);
+      } else {
+        m_redundantCmdCount += 1;
       }
     }
 
@@ -4831,6 +4975,8 @@ namespace dxvk {
       if (bindings.samplers[StartSlot + i] != sampler) {
         bindings.samplers[StartSlot + i] = sampler;
         BindSampler<ShaderStage>(slotId + i, sampler);
+      } else {
+        m_redundantCmdCount += 1;
       }
     }
 
@@ -4904,6 +5050,7 @@ namespace dxvk {
 
           if (m_state.om.uavs[i] != uav || ctr != ~0u) {
             m_state.om.uavs[i] = uav;
+            m_state.om.uavMask.set(i, uav != nullptr);
 
             BindUnorderedAccessView<DxbcProgramType::PixelShader>(
               uavSlotId + i, uav,
@@ -5009,8 +5156,12 @@ namespace dxvk {
       for (uint32_t i = 0; !hazard && i < m_state.om.maxRtv; i++)
         hazard = CheckViewOverlap(pView, m_state.om.rtvs[i].ptr());
 
-      for (uint32_t i = 0; !hazard && i < m_state.om.maxUav; i++)
-        hazard = CheckViewOverlap(pView, m_state.om.uavs[i].ptr());
+      int32_t uav = m_state.om.uavMask.findNext(0);
+
+      while (uav >= 0 && !hazard) {
+        hazard = CheckViewOverlap(pView, m_state.om.uavs[uav].ptr());
+        uav = m_state.om.uavMask.findNext(uav + 1);
+      }
     }
 
     return hazard;
@@ -5067,7 +5218,8 @@ namespace dxvk {
       // Otherwise, to avoid large data copies on the CS thread,
       // write directly to a staging buffer and dispatch a copy
       DxvkBufferSlice stagingSlice = AllocStagingBuffer(Length);
-      std::memcpy(stagingSlice.mapPtr(0), pSrcData, Length);
+      bit::bcopyMapped(stagingSlice.mapPtr(0), pSrcData, Length,
+        !(stagingSlice.buffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_CACHED_BIT));
 
       EmitCs([
         cStagingSlice = std::move(stagingSlice),
@@ -5285,6 +5437,16 @@ namespace dxvk {
           context->UpdateMappedBuffer(bufferResource, offset, length, pSrcData, CopyFlags);
           return;
         }
+
+        // Partial updates to buffers in cached memory can rename the
+        // buffer and preserve the remaining contents on the CPU, which
+        // is cheaper than a staging copy followed by a GPU copy.
+        if constexpr (!IsDeferred) {
+          if (context->CanPreserveMappedBuffer(bufferResource)) {
+            context->UpdateMappedBuffer(bufferResource, offset, length, pSrcData, 0);
+            return;
+          }
+        }
       }
 
       // Otherwise we can't really do anything fancy, so just do a GPU copy
@@ -775,6 +775,8 @@ namespace dxvk {
     DxvkCsChunkRef              m_csChunk;
     D3D11CmdData*               m_cmdData;
 
+    uint32_t                    m_redundantCmdCount = 0;
+
     DxvkCsChunkRef AllocCsChunk();
     
     DxvkDataSlice AllocUpdateBufferSlice(size_t Size);
@@ -792,6 +794,8 @@ namespace dxvk {
     
     void ApplyDepthStencilState();
     
+    void ApplyPredicate();
+
     void ApplyStencilRef();
     
     void ApplyRasterizerState();
@@ -816,12 +820,6 @@ namespace dxvk {
             UINT                              Offset,
             UINT                              Stride);
 
-    void BindVertexBufferRange(
-            UINT                              Slot,
-            D3D11Buffer*                      pBuffer,
-            UINT                              Offset,
-            UINT                              Stride);
-
     void BindIndexBuffer(
             D3D11Buffer*                      pBuffer,
             UINT                              Offset,
@@ -878,6 +876,16 @@ namespace dxvk {
             VkDeviceSize                      SrcOffset,
             VkDeviceSize                      ByteCount);
 
+    void BatchCopyImage(
+      const Rc<DxvkImage>&                    DstImage,
+      const VkImageSubresourceLayers&         DstLayers,
+            VkOffset3D                        DstOffset,
+            VkExtent3D                        DstExtent,
+      const Rc<DxvkImage>&                    SrcImage,
+      const VkImageSubresourceLayers&         SrcLayers,
+            VkOffset3D                        SrcOffset,
+            VkExtent3D                        SrcExtent);
+
     void CopyImage(
             D3D11CommonTexture*               pDstTexture,
       const VkImageSubresourceLayers*         pDstLayers,
@@ -1103,6 +1111,13 @@ namespace dxvk {
       return data;
     }
 
+    void ReportRedundantCmds() {
+      if (m_redundantCmdCount) {
+        m_device->addStatCtr(DxvkStatCounter::CsRedundantCmds, m_redundantCmdCount);
+        m_redundantCmdCount = 0;
+      }
+    }
+
     void FlushCsChunk() {
       if (likely(!m_csChunk->empty())) {
         GetTypedContext()->EmitCsChunk(std::move(m_csChunk));
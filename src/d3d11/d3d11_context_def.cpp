@@ -173,6 +173,8 @@ namespace dxvk {
 
     // Make sure all commands are visible to the command list
     FlushCsChunk();
+
+    m_commandList->Finalize();
     
     if (ppCommandList)
       *ppCommandList = m_commandList.ref();
@@ -392,6 +394,7 @@ namespace dxvk {
   
   void D3D11DeferredContext::EmitCsChunk(DxvkCsChunkRef&& chunk) {
     m_chunkId = m_commandList->AddChunk(std::move(chunk));
+    ReportRedundantCmds();
   }
 
 
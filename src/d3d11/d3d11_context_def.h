@@ -21,7 +21,7 @@ namespace dxvk {
     D3D11_MAPPED_SUBRESOURCE  MapInfo;
   };
   
-  class D3D11DeferredContext : public D3D11CommonContext<D3D11DeferredContext> {
+  class D3D11DeferredContext final : public D3D11CommonContext<D3D11DeferredContext> {
     friend class D3D11CommonContext<D3D11DeferredContext>;
   public:
     
@@ -50,7 +50,7 @@ namespace dxvk {
       return;
 
     ExecuteFlush(GpuFlushType::ExplicitFlush, nullptr, true);
-    SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+    SynchronizeCsThread(DxvkCsThread::SynchronizeAll, DxvkCsSyncReason::Device);
     SynchronizeDevice();
   }
   
@@ -373,7 +373,7 @@ namespace dxvk {
       auto sequenceNumber = pResource->GetSequenceNumber();
 
       if (MapType != D3D11_MAP_READ && !MapFlags && bufferSize <= m_maxImplicitDiscardSize) {
-        SynchronizeCsThread(sequenceNumber);
+        SynchronizeCsThread(sequenceNumber, DxvkCsSyncReason::BufferWrite);
 
         bool hasWoAccess = buffer->isInUse(DxvkAccess::Write);
         bool hasRwAccess = buffer->isInUse(DxvkAccess::Read);
@@ -401,7 +401,7 @@ namespace dxvk {
         pMappedResource->DepthPitch = bufferSize;
         return S_OK;
       } else {
-        if (!WaitForResource(buffer, sequenceNumber, MapType, MapFlags))
+        if (!WaitForResource(buffer, sequenceNumber, MapType, MapFlags, GetMapSyncReason(false, MapType)))
           return DXGI_ERROR_WAS_STILL_DRAWING;
 
         DxvkBufferSliceHandle physSlice = pResource->GetMappedSlice();
@@ -458,7 +458,7 @@ namespace dxvk {
         MapFlags &= ~D3D11_MAP_FLAG_DO_NOT_WAIT;
 
       if (MapType != D3D11_MAP_WRITE_NO_OVERWRITE) {
-        if (!WaitForResource(mappedImage, sequenceNumber, MapType, MapFlags))
+        if (!WaitForResource(mappedImage, sequenceNumber, MapType, MapFlags, GetMapSyncReason(true, MapType)))
           return DXGI_ERROR_WAS_STILL_DRAWING;
       }
       
@@ -501,7 +501,7 @@ namespace dxvk {
         doFlags = DoWait;
       } else if (MapType != D3D11_MAP_WRITE_NO_OVERWRITE || mapMode == D3D11_COMMON_TEXTURE_MAP_MODE_BUFFER) {
         // Need to synchronize thread to determine pending GPU accesses
-        SynchronizeCsThread(sequenceNumber);
+        SynchronizeCsThread(sequenceNumber, GetMapSyncReason(true, MapType));
 
         // Don't implicitly discard large buffers or buffers of images with
         // multiple subresources, as that is likely to cause memory issues.
@@ -552,7 +552,7 @@ namespace dxvk {
             MapFlags &= ~D3D11_MAP_FLAG_DO_NOT_WAIT;
 
           // Wait for mapped buffer to become available
-          if (!WaitForResource(mappedBuffer, sequenceNumber, MapType, MapFlags))
+          if (!WaitForResource(mappedBuffer, sequenceNumber, MapType, MapFlags, GetMapSyncReason(true, MapType)))
             return DXGI_ERROR_WAS_STILL_DRAWING;
         }
 
@@ -698,6 +698,22 @@ namespace dxvk {
   }
 
 
+  bool D3D11ImmediateContext::CanPreserveMappedBuffer(
+          D3D11Buffer*                  pBuffer) {
+    auto buffer = pBuffer->GetBuffer();
+
+    // Same constraints as the implicit discard in MapBuffer,
+    // the previous contents must not be written by the GPU
+    if (!(buffer->memFlags() & VK_MEMORY_PROPERTY_HOST_CACHED_BIT)
+     || (pBuffer->Desc()->ByteWidth > m_maxImplicitDiscardSize)
+     || (pBuffer->Desc()->BindFlags & (D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_STREAM_OUTPUT)))
+      return false;
+
+    SynchronizeCsThread(pBuffer->GetSequenceNumber(), DxvkCsSyncReason::BufferWrite);
+    return !buffer->isInUse(DxvkAccess::Write);
+  }
+
+
   void D3D11ImmediateContext::UpdateMappedBuffer(
           D3D11Buffer*                  pDstBuffer,
           UINT                          Offset,
@@ -707,6 +723,7 @@ namespace dxvk {
     DxvkBufferSliceHandle slice;
 
     if (likely(CopyFlags != D3D11_COPY_NO_OVERWRITE)) {
+      DxvkBufferSliceHandle prevSlice = pDstBuffer->GetMappedSlice();
       slice = pDstBuffer->DiscardSlice();
 
       EmitCs([
@@ -715,11 +732,24 @@ namespace dxvk {
       ] (DxvkContext* ctx) {
         ctx->invalidateBuffer(cBuffer, cBufferSlice);
       });
+
+      // Partial updates must preserve the rest of the buffer unless
+      // the application discards it. Callers only do this for cached
+      // memory, since reading back uncached memory is very slow.
+      if (unlikely(Length < slice.length) && !(CopyFlags & D3D11_COPY_DISCARD)) {
+        auto srcBytes = reinterpret_cast<const char*>(prevSlice.mapPtr);
+        auto dstBytes = reinterpret_cast<char*>(slice.mapPtr);
+
+        std::memcpy(dstBytes, srcBytes, Offset);
+        std::memcpy(dstBytes + Offset + Length, srcBytes + Offset + Length,
+          slice.length - Offset - Length);
+      }
     } else {
       slice = pDstBuffer->GetMappedSlice();
     }
 
-    std::memcpy(reinterpret_cast<char*>(slice.mapPtr) + Offset, pSrcData, Length);
+    bit::bcopyMapped(reinterpret_cast<char*>(slice.mapPtr) + Offset, pSrcData, Length,
+      !(pDstBuffer->GetBuffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_CACHED_BIT));
   }
 
 
@@ -821,7 +851,9 @@ namespace dxvk {
   }
 
 
-  void D3D11ImmediateContext::SynchronizeCsThread(uint64_t SequenceNumber) {
+  void D3D11ImmediateContext::SynchronizeCsThread(
+          uint64_t                          SequenceNumber,
+          DxvkCsSyncReason                  Reason) {
     D3D10DeviceLock lock = LockContext();
 
     // Dispatch current chunk so that all commands
@@ -829,7 +861,7 @@ namespace dxvk {
     if (SequenceNumber > m_csSeqNum)
       FlushCsChunk();
     
-    m_csThread.synchronize(SequenceNumber);
+    m_csThread.synchronize(SequenceNumber, Reason);
   }
   
   
@@ -851,7 +883,8 @@ namespace dxvk {
     const Rc<DxvkResource>&                 Resource,
           uint64_t                          SequenceNumber,
           D3D11_MAP                         MapType,
-          UINT                              MapFlags) {
+          UINT                              MapFlags,
+          DxvkCsSyncReason                  Reason) {
     // Determine access type to wait for based on map mode
     DxvkAccess access = MapType == D3D11_MAP_READ
       ? DxvkAccess::Write
@@ -863,7 +896,7 @@ namespace dxvk {
     bool isInUse = Resource->isInUse(access);
 
     if (!isInUse) {
-      SynchronizeCsThread(SequenceNumber);
+      SynchronizeCsThread(SequenceNumber, Reason);
       isInUse = Resource->isInUse(access);
     }
 
@@ -871,16 +904,29 @@ namespace dxvk {
       if (isInUse) {
         // We don't have to wait, but misbehaving games may
         // still try to spin on `Map` until the resource is
-        // idle, so we should flush pending commands
-        ConsiderFlush(GpuFlushType::ImplicitSynchronization);
+        // idle, so we should flush pending commands. If the
+        // last command using the resource has already been
+        // submitted, flushing more work will not make it
+        // become idle any sooner, so just report the status.
+        if (SequenceNumber > m_flushSeqNum)
+          ConsiderFlush(GpuFlushType::ImplicitSynchronization);
+
         return false;
       }
     } else {
       if (isInUse) {
         // Make sure pending commands using the resource get
-        // executed on the the GPU if we have to wait for it
-        ExecuteFlush(GpuFlushType::ImplicitSynchronization, nullptr, false);
-        SynchronizeCsThread(SequenceNumber);
+        // executed on the the GPU if we have to wait for it.
+        // If the last command using the resource was recorded
+        // before the most recent flush, it has already been
+        // submitted, so we only need to wait for that submission
+        // rather than flushing all commands recorded since.
+        if (SequenceNumber > m_flushSeqNum)
+          ExecuteFlush(GpuFlushType::ImplicitSynchronization, nullptr, false);
+        else
+          m_parent->FlushInitContext();
+
+        SynchronizeCsThread(SequenceNumber, Reason);
 
         m_device->waitForResource(Resource, access);
       }
@@ -890,8 +936,19 @@ namespace dxvk {
   }
   
   
+  DxvkCsSyncReason D3D11ImmediateContext::GetMapSyncReason(
+          bool                              IsImage,
+          D3D11_MAP                         MapType) {
+    if (MapType == D3D11_MAP_READ)
+      return IsImage ? DxvkCsSyncReason::ImageRead : DxvkCsSyncReason::BufferRead;
+    else
+      return IsImage ? DxvkCsSyncReason::ImageWrite : DxvkCsSyncReason::BufferWrite;
+  }
+
+
   void D3D11ImmediateContext::EmitCsChunk(DxvkCsChunkRef&& chunk) {
     m_csSeqNum = m_csThread.dispatchChunk(std::move(chunk));
+    ReportRedundantCmds();
   }
 
 
@@ -979,6 +1036,10 @@ namespace dxvk {
     m_flushSeqNum = m_csSeqNum;
     m_flushTracker.notifyFlush(m_flushSeqNum, submissionId);
 
+    // Adjust flush heuristic based on how busy the GPU is
+    m_flushTracker.updatePacing(m_device->gpuIdleTicks());
+    m_device->setFlushPacing(m_flushTracker.getPacing().getScale());
+
     // If necessary, block calling thread until the
     // Vulkan queue submission is performed.
     if (synchronizeSubmission)
@@ -13,7 +13,7 @@ namespace dxvk {
   class D3D11Buffer;
   class D3D11CommonTexture;
 
-  class D3D11ImmediateContext : public D3D11CommonContext<D3D11ImmediateContext> {
+  class D3D11ImmediateContext final : public D3D11CommonContext<D3D11ImmediateContext> {
     friend class D3D11CommonContext<D3D11ImmediateContext>;
     friend class D3D11SwapChain;
     friend class D3D11VideoContext;
@@ -86,7 +86,8 @@ namespace dxvk {
             VkImageLayout               DstLayout);
 
     void SynchronizeCsThread(
-            uint64_t                          SequenceNumber);
+            uint64_t                          SequenceNumber,
+            DxvkCsSyncReason                  Reason);
 
     D3D10DeviceLock LockContext() {
       return m_multithread.AcquireLock();
@@ -139,6 +140,9 @@ namespace dxvk {
             UINT                        Subresource,
       const D3D11_COMMON_TEXTURE_REGION* pRegion);
 
+    bool CanPreserveMappedBuffer(
+            D3D11Buffer*                pBuffer);
+
     void UpdateMappedBuffer(
             D3D11Buffer*                pDstBuffer,
             UINT                        Offset,
@@ -154,7 +158,12 @@ namespace dxvk {
       const Rc<DxvkResource>&           Resource,
             uint64_t                    SequenceNumber,
             D3D11_MAP                   MapType,
-            UINT                        MapFlags);
+            UINT                        MapFlags,
+            DxvkCsSyncReason            Reason);
+
+    static DxvkCsSyncReason GetMapSyncReason(
+            bool                        IsImage,
+            D3D11_MAP                   MapType);
     
     void EmitCsChunk(DxvkCsChunkRef&& chunk);
 
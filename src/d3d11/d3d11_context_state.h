@@ -188,6 +188,8 @@ namespace dxvk {
     D3D11ShaderStageUavBinding        uavs  = { };
     D3D11RenderTargetViewBinding      rtvs  = { };
     Com<D3D11DepthStencilView, false> dsv   = { };
+
+    DxvkBindingSet<D3D11_1_UAV_SLOT_COUNT> uavMask = { };
     
     D3D11BlendState*        cbState = nullptr;
     D3D11DepthStencilState* dsState = nullptr;
@@ -209,6 +211,7 @@ namespace dxvk {
         rtvs[i] = nullptr;
 
       dsv = nullptr;
+      uavMask.clear();
 
       cbState = nullptr;
       dsState = nullptr;
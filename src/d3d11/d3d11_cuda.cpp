@@ -27,10 +27,14 @@ namespace dxvk {
 
   void CubinShaderLaunchInfo::insertResource(ID3D11Resource* pResource, DxvkAccessFlags access) {
     auto img = GetCommonTexture(pResource);
-    auto buf = GetCommonBuffer(pResource);
 
-    if (img)
+    if (img) {
       insertUniqueResource(images, img->GetImage(), access);
+      return;
+    }
+
+    auto buf = GetCommonBuffer(pResource);
+
     if (buf)
       insertUniqueResource(buffers, buf->GetBuffer(), access);
   }
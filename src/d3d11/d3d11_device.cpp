@@ -714,6 +714,15 @@ namespace dxvk {
       uint32_t attrCount = CompactSparseList(attrList.data(), attrMask);
       uint32_t bindCount = CompactSparseList(bindList.data(), bindMask);
 
+      // Sort attributes by location so that layouts which only differ
+      // in element order map to the same pipeline state. Bindings are
+      // already sorted by input slot after compaction.
+      std::stable_sort(attrList.begin(), attrList.begin() + attrCount, [] (
+          const DxvkVertexAttribute& a,
+          const DxvkVertexAttribute& b) {
+        return a.location < b.location;
+      });
+
       if (!ppInputLayout)
         return S_FALSE;
 
@@ -1911,6 +1920,8 @@ namespace dxvk {
 
     enabled.vk13.shaderDemoteToHelperInvocation                   = VK_TRUE;
 
+    enabled.extConditionalRendering.conditionalRendering          = supported.extConditionalRendering.conditionalRendering;
+
     enabled.extCustomBorderColor.customBorderColors               = supported.extCustomBorderColor.customBorderColorWithoutFormat;
     enabled.extCustomBorderColor.customBorderColorWithoutFormat   = supported.extCustomBorderColor.customBorderColorWithoutFormat;
 
@@ -1953,6 +1964,9 @@ namespace dxvk {
     enabled.core.features.shaderFloat64                           = supported.core.features.shaderFloat64;
     enabled.core.features.shaderInt64                             = supported.core.features.shaderInt64;
 
+    // Used by the swap chain blitter for compute presentation
+    enabled.core.features.shaderStorageImageWriteWithoutFormat    = supported.core.features.shaderStorageImageWriteWithoutFormat;
+
     return enabled;
   }
   
@@ -1976,27 +1990,36 @@ namespace dxvk {
     if (FAILED(hr))
       return hr;
 
-    auto shader = commonShader.GetShader();
+    // Shaders that are still being translated are validated
+    // by the translation worker instead
+    if (!commonShader.IsPending() && !IsShaderSupported(commonShader.GetShader()))
+      return E_INVALIDARG;
 
-    if (shader->flags().test(DxvkShaderFlag::ExportsStencilRef)
+    *pShaderModule = std::move(commonShader);
+    return S_OK;
+  }
+
+
+  bool D3D11Device::IsShaderSupported(
+    const Rc<DxvkShader>&         Shader) const {
+    if (Shader->flags().test(DxvkShaderFlag::ExportsStencilRef)
      && !m_dxvkDevice->features().extShaderStencilExport)
-      return E_INVALIDARG;
+      return false;
 
-    if (shader->flags().test(DxvkShaderFlag::ExportsViewportIndexLayerFromVertexStage)
+    if (Shader->flags().test(DxvkShaderFlag::ExportsViewportIndexLayerFromVertexStage)
      && (!m_dxvkDevice->features().vk12.shaderOutputViewportIndex
       || !m_dxvkDevice->features().vk12.shaderOutputLayer))
-      return E_INVALIDARG;
+      return false;
 
-    if (shader->flags().test(DxvkShaderFlag::UsesSparseResidency)
+    if (Shader->flags().test(DxvkShaderFlag::UsesSparseResidency)
      && !m_dxvkDevice->features().core.features.shaderResourceResidency)
-      return E_INVALIDARG;
+      return false;
 
-    if (shader->flags().test(DxvkShaderFlag::UsesFragmentCoverage)
+    if (Shader->flags().test(DxvkShaderFlag::UsesFragmentCoverage)
      && !m_dxvkDevice->properties().extConservativeRasterization.fullyCoveredFragmentShaderInputVariable)
-      return E_INVALIDARG;
+      return false;
 
-    *pShaderModule = std::move(commonShader);
-    return S_OK;
+    return true;
   }
 
 
@@ -2579,26 +2602,32 @@ namespace dxvk {
       }
 
       // The d3d11 nvapi provides us a texture but vulkan only lets us get the GPU address from an imageview.  So, make a private imageview and get the address from that...
+      // The view is kept alive by the texture, so that the address stays valid and repeated queries don't have to create a new view.
+      Rc<DxvkImageView> dxvkImageView = texture->GetInteropView();
 
-      D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
+      if (dxvkImageView == nullptr) {
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
 
-      const D3D11_COMMON_TEXTURE_DESC *texDesc = texture->Desc();
-      if (texDesc->ArraySize != 1) {
-        Logger::debug(str::format("GetResourceHandleGPUVirtualAddressAndSize(?) - unexpected array size: ", texDesc->ArraySize));
-      }
-      resourceViewDesc.Format = texDesc->Format;
-      resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-      resourceViewDesc.Texture2D.MostDetailedMip = 0;
-      resourceViewDesc.Texture2D.MipLevels = texDesc->MipLevels;
-
-      Com<ID3D11ShaderResourceView> pNewSRV;
-      HRESULT hr = m_device->CreateShaderResourceView(pResource, &resourceViewDesc, &pNewSRV);
-      if (FAILED(hr)) {
-        Logger::warn("GetResourceHandleGPUVirtualAddressAndSize() - private CreateShaderResourceView() failed");
-        return false;
+        const D3D11_COMMON_TEXTURE_DESC *texDesc = texture->Desc();
+        if (texDesc->ArraySize != 1) {
+          Logger::debug(str::format("GetResourceHandleGPUVirtualAddressAndSize(?) - unexpected array size: ", texDesc->ArraySize));
+        }
+        resourceViewDesc.Format = texDesc->Format;
+        resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        resourceViewDesc.Texture2D.MostDetailedMip = 0;
+        resourceViewDesc.Texture2D.MipLevels = texDesc->MipLevels;
+
+        Com<ID3D11ShaderResourceView> pNewSRV;
+        HRESULT hr = m_device->CreateShaderResourceView(pResource, &resourceViewDesc, &pNewSRV);
+        if (FAILED(hr)) {
+          Logger::warn("GetResourceHandleGPUVirtualAddressAndSize() - private CreateShaderResourceView() failed");
+          return false;
+        }
+
+        dxvkImageView = texture->SetInteropView(
+          static_cast<D3D11ShaderResourceView*>(pNewSRV.ptr())->GetImageView());
       }
 
-      Rc<DxvkImageView> dxvkImageView = static_cast<D3D11ShaderResourceView*>(pNewSRV.ptr())->GetImageView();
       VkImageView vkImageView = dxvkImageView->handle();
 
       VkImageViewAddressPropertiesNVX imageViewAddressProperties = {VK_STRUCTURE_TYPE_IMAGE_VIEW_ADDRESS_PROPERTIES_NVX};
@@ -3107,7 +3136,8 @@ namespace dxvk {
     }
     
     if (riid == __uuidof(IDXGIVkInteropDevice)
-     || riid == __uuidof(IDXGIVkInteropDevice1)) {
+     || riid == __uuidof(IDXGIVkInteropDevice1)
+     || riid == __uuidof(IDXGIVkInteropDevice2)) {
       *ppvObject = ref(&m_d3d11Interop);
       return S_OK;
     }
@@ -418,6 +418,15 @@ namespace dxvk {
       return &m_d3d11Options;
     }
 
+    /**
+     * \brief Checks whether a shader can be used on this device
+     *
+     * \param [in] Shader Translated shader
+     * \returns \c true if all features used by the shader are supported
+     */
+    bool IsShaderSupported(
+      const Rc<DxvkShader>&         Shader) const;
+
     D3D10Device* GetD3D10Interface() const {
       return m_d3d10Device;
     }
@@ -8,10 +8,8 @@ namespace dxvk {
   D3D11Initializer::D3D11Initializer(
           D3D11Device*                pParent)
   : m_parent(pParent),
-    m_device(pParent->GetDXVKDevice()),
-    m_context(m_device->createContext(DxvkContextType::Supplementary)) {
-    m_context->beginRecording(
-      m_device->createCommandList());
+    m_device(pParent->GetDXVKDevice()) {
+
   }
 
   
@@ -21,10 +19,14 @@ namespace dxvk {
 
 
   void D3D11Initializer::Flush() {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    // Submit all contexts so that every resource
+    // is initialized before the caller's commands
+    for (auto& slot : m_slots) {
+      std::lock_guard<dxvk::mutex> lock(slot.mutex);
 
-    if (m_transferCommands != 0)
-      FlushInternal();
+      if (slot.transferCommands != 0)
+        FlushInternal(slot);
+    }
   }
 
   void D3D11Initializer::InitBuffer(
@@ -61,41 +63,43 @@ namespace dxvk {
 
     auto counterSlice = counterView->slice();
 
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
-    m_transferCommands += 1;
+    Slot& slot = AcquireSlot();
+    std::lock_guard<dxvk::mutex> lock(slot.mutex, std::adopt_lock);
+    slot.transferCommands += 1;
 
     const uint32_t zero = 0;
-    m_context->updateBuffer(
+    slot.context->updateBuffer(
       counterSlice.buffer(),
       counterSlice.offset(),
       sizeof(zero), &zero);
 
-    FlushImplicit();
+    FlushImplicit(slot);
   }
 
 
   void D3D11Initializer::InitDeviceLocalBuffer(
           D3D11Buffer*                pBuffer,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    Slot& slot = AcquireSlot();
+    std::lock_guard<dxvk::mutex> lock(slot.mutex, std::adopt_lock);
 
     DxvkBufferSlice bufferSlice = pBuffer->GetBufferSlice();
 
     if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
-      m_transferMemory   += bufferSlice.length();
-      m_transferCommands += 1;
+      slot.transferMemory += bufferSlice.length();
+      slot.transferCommands += 1;
       
-      m_context->uploadBuffer(
+      slot.context->uploadBuffer(
         bufferSlice.buffer(),
         pInitialData->pSysMem);
     } else {
-      m_transferCommands += 1;
+      slot.transferCommands += 1;
 
-      m_context->initBuffer(
+      slot.context->initBuffer(
         bufferSlice.buffer());
     }
 
-    FlushImplicit();
+    FlushImplicit(slot);
   }
 
 
@@ -123,7 +127,8 @@ namespace dxvk {
   void D3D11Initializer::InitDeviceLocalTexture(
           D3D11CommonTexture*         pTexture,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    Slot& slot = AcquireSlot();
+    std::lock_guard<dxvk::mutex> lock(slot.mutex, std::adopt_lock);
     
     Rc<DxvkImage> image = pTexture->GetImage();
 
@@ -133,7 +138,24 @@ namespace dxvk {
     VkFormat packedFormat = m_parent->LookupPackedFormat(desc->Format, pTexture->GetFormatMode()).Format;
     auto formatInfo = lookupFormatInfo(packedFormat);
 
-    if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
+    if (pInitialData != nullptr && pInitialData->pSysMem != nullptr
+     && InitHostCopyTexture(pTexture, pInitialData)) {
+      // Image contents were written on the host, we
+      // only need to transition it to its final layout
+      slot.transferCommands += 1;
+
+      VkImageSubresourceRange subresources;
+      subresources.aspectMask     = formatInfo->aspectMask;
+      subresources.baseMipLevel   = 0;
+      subresources.levelCount     = desc->MipLevels;
+      subresources.baseArrayLayer = 0;
+      subresources.layerCount     = desc->ArraySize;
+
+      if (image->info().layout != VK_IMAGE_LAYOUT_GENERAL) {
+        slot.context->transformImage(image, subresources,
+          VK_IMAGE_LAYOUT_GENERAL, image->info().layout);
+      }
+    } else if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
       // pInitialData is an array that stores an entry for
       // every single subresource. Since we will define all
       // subresources, this counts as initialization.
@@ -146,8 +168,8 @@ namespace dxvk {
           VkExtent3D mipLevelExtent = pTexture->MipLevelExtent(level);
 
           if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING) {
-            m_transferCommands += 1;
-            m_transferMemory   += pTexture->GetSubresourceLayout(formatInfo->aspectMask, id).Size;
+            slot.transferCommands += 1;
+            slot.transferMemory += pTexture->GetSubresourceLayout(formatInfo->aspectMask, id).Size;
             
             VkImageSubresourceLayers subresourceLayers;
             subresourceLayers.aspectMask     = formatInfo->aspectMask;
@@ -156,13 +178,13 @@ namespace dxvk {
             subresourceLayers.layerCount     = 1;
             
             if (formatInfo->aspectMask != (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
-              m_context->uploadImage(
+              slot.context->uploadImage(
                 image, subresourceLayers,
                 pInitialData[id].pSysMem,
                 pInitialData[id].SysMemPitch,
                 pInitialData[id].SysMemSlicePitch);
             } else {
-              m_context->updateDepthStencilImage(
+              slot.context->updateDepthStencilImage(
                 image, subresourceLayers,
                 VkOffset2D { mipLevelOffset.x,     mipLevelOffset.y      },
                 VkExtent2D { mipLevelExtent.width, mipLevelExtent.height },
@@ -182,7 +204,7 @@ namespace dxvk {
       }
     } else {
       if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_STAGING) {
-        m_transferCommands += 1;
+        slot.transferCommands += 1;
         
         // While the Microsoft docs state that resource contents are
         // undefined if no initial data is provided, some applications
@@ -194,7 +216,7 @@ namespace dxvk {
         subresources.baseArrayLayer = 0;
         subresources.layerCount     = desc->ArraySize;
 
-        m_context->initImage(image, subresources, VK_IMAGE_LAYOUT_UNDEFINED);
+        slot.context->initImage(image, subresources, VK_IMAGE_LAYOUT_UNDEFINED);
       }
 
       if (mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_NONE) {
@@ -205,7 +227,91 @@ namespace dxvk {
       }
     }
 
-    FlushImplicit();
+    FlushImplicit(slot);
+  }
+
+
+  bool D3D11Initializer::InitHostCopyTexture(
+          D3D11CommonTexture*         pTexture,
+    const D3D11_SUBRESOURCE_DATA*     pInitialData) {
+    Rc<DxvkImage> image = pTexture->GetImage();
+
+    if (!(image->info().usage & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT))
+      return false;
+
+    auto desc = pTexture->Desc();
+    auto formatInfo = image->formatInfo();
+
+    // Host copies take row and slice pitches in texels, so
+    // fall back to a regular upload if the application's
+    // pitches are not a multiple of the element size.
+    small_vector<VkMemoryToImageCopyEXT, 16> regions;
+
+    for (uint32_t layer = 0; layer < desc->ArraySize; layer++) {
+      for (uint32_t level = 0; level < desc->MipLevels; level++) {
+        const uint32_t id = D3D11CalcSubresource(
+          level, layer, desc->MipLevels);
+
+        VkExtent3D mipLevelExtent = pTexture->MipLevelExtent(level);
+        VkExtent3D blockCount = util::computeBlockCount(mipLevelExtent, formatInfo->blockSize);
+
+        VkDeviceSize rowPitch = pInitialData[id].SysMemPitch;
+        VkDeviceSize slicePitch = pInitialData[id].SysMemSlicePitch;
+
+        if (blockCount.height <= 1u)
+          rowPitch = blockCount.width * formatInfo->elementSize;
+
+        if (blockCount.depth <= 1u)
+          slicePitch = blockCount.height * rowPitch;
+
+        if ((rowPitch % formatInfo->elementSize) || (slicePitch % rowPitch)
+         || (rowPitch < blockCount.width * formatInfo->elementSize))
+          return false;
+
+        VkMemoryToImageCopyEXT region = { VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT };
+        region.pHostPointer = pInitialData[id].pSysMem;
+        region.memoryRowLength = (rowPitch / formatInfo->elementSize) * formatInfo->blockSize.width;
+        region.memoryImageHeight = (slicePitch / rowPitch) * formatInfo->blockSize.height;
+        region.imageSubresource = { formatInfo->aspectMask, level, layer, 1u };
+        region.imageExtent = mipLevelExtent;
+
+        regions.push_back(region);
+      }
+    }
+
+    // The image was just created and has not been used by the
+    // GPU yet, so it can be written without synchronization.
+    // GENERAL is always a valid host copy destination layout.
+    auto vk = m_device->vkd();
+
+    VkHostImageLayoutTransitionInfoEXT transition = { VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT };
+    transition.image = image->handle();
+    transition.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    transition.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    transition.subresourceRange = image->getAvailableSubresources();
+
+    VkResult vr = vk->vkTransitionImageLayoutEXT(vk->device(), 1, &transition);
+
+    if (vr != VK_SUCCESS) {
+      Logger::err(str::format("D3D11: Host image layout transition failed: ", vr));
+      return false;
+    }
+
+    VkCopyMemoryToImageInfoEXT copy = { VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT };
+    copy.dstImage = image->handle();
+    copy.dstImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    copy.regionCount = regions.size();
+    copy.pRegions = regions.data();
+
+    vr = vk->vkCopyMemoryToImageEXT(vk->device(), &copy);
+
+    if (vr != VK_SUCCESS) {
+      // The regular upload path overwrites all subresources
+      Logger::err(str::format("D3D11: Host image copy failed: ", vr));
+      return false;
+    }
+
+    return true;
   }
 
 
@@ -250,38 +356,70 @@ namespace dxvk {
     }
 
     // Initialize the image on the GPU
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    Slot& slot = AcquireSlot();
+    std::lock_guard<dxvk::mutex> lock(slot.mutex, std::adopt_lock);
 
     VkImageSubresourceRange subresources = image->getAvailableSubresources();
     
-    m_context->initImage(image, subresources, VK_IMAGE_LAYOUT_PREINITIALIZED);
+    slot.context->initImage(image, subresources, VK_IMAGE_LAYOUT_PREINITIALIZED);
 
-    m_transferCommands += 1;
-    FlushImplicit();
+    slot.transferCommands += 1;
+    FlushImplicit(slot);
   }
 
 
   void D3D11Initializer::InitTiledTexture(
           D3D11CommonTexture*         pTexture) {
-    m_context->initSparseImage(pTexture->GetImage());
+    Slot& slot = AcquireSlot();
+    std::lock_guard<dxvk::mutex> lock(slot.mutex, std::adopt_lock);
+
+    slot.context->initSparseImage(pTexture->GetImage());
+
+    slot.transferCommands += 1;
+    FlushImplicit(slot);
+  }
+
+
+  D3D11Initializer::Slot& D3D11Initializer::AcquireSlot() {
+    // Prefer the first slot so that single-threaded
+    // applications only ever use one context
+    Slot* slot = nullptr;
+
+    for (auto& candidate : m_slots) {
+      if (candidate.mutex.try_lock()) {
+        slot = &candidate;
+        break;
+      }
+    }
+
+    if (!slot) {
+      slot = &m_slots[0];
+      slot->mutex.lock();
+    }
+
+    if (slot->context == nullptr) {
+      slot->context = m_device->createContext(DxvkContextType::Supplementary);
+      slot->context->beginRecording(m_device->createCommandList());
+    }
 
-    m_transferCommands += 1;
-    FlushImplicit();
+    return *slot;
   }
 
 
-  void D3D11Initializer::FlushImplicit() {
-    if (m_transferCommands > MaxTransferCommands
-     || m_transferMemory   > MaxTransferMemory)
-      FlushInternal();
+  void D3D11Initializer::FlushImplicit(
+          Slot&                       slot) {
+    if (slot.transferCommands > MaxTransferCommands
+     || slot.transferMemory   > MaxTransferMemory)
+      FlushInternal(slot);
   }
 
 
-  void D3D11Initializer::FlushInternal() {
-    m_context->flushCommandList(nullptr);
+  void D3D11Initializer::FlushInternal(
+          Slot&                       slot) {
+    slot.context->flushCommandList(nullptr);
     
-    m_transferCommands = 0;
-    m_transferMemory   = 0;
+    slot.transferCommands = 0;
+    slot.transferMemory   = 0;
   }
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "d3d11_buffer.h"
 #include "d3d11_texture.h"
 
@@ -14,10 +16,17 @@ namespace dxvk {
    * initialization. This includes initialization
    * with application-defined data, as well as
    * zero-initialization for buffers and images.
+   *
+   * Resources may be created from multiple threads at once,
+   * so the initializer keeps a small number of contexts that
+   * are created on demand. Each thread takes the first context
+   * that is not currently in use, so that concurrent resource
+   * creation does not serialize on a single context.
    */
   class D3D11Initializer {
     constexpr static size_t MaxTransferMemory    = 32 * 1024 * 1024;
     constexpr static size_t MaxTransferCommands  = 512;
+    constexpr static size_t MaxContexts          = 4;
   public:
 
     D3D11Initializer(
@@ -40,14 +49,20 @@ namespace dxvk {
     
   private:
 
-    dxvk::mutex       m_mutex;
+    struct Slot {
+      dxvk::mutex       mutex;
+      Rc<DxvkContext>   context;
+
+      size_t            transferCommands  = 0;
+      size_t            transferMemory    = 0;
+    };
 
     D3D11Device*      m_parent;
     Rc<DxvkDevice>    m_device;
-    Rc<DxvkContext>   m_context;
 
-    size_t            m_transferCommands  = 0;
-    size_t            m_transferMemory    = 0;
+    std::array<Slot, MaxContexts> m_slots;
+
+    Slot& AcquireSlot();
 
     void InitDeviceLocalBuffer(
             D3D11Buffer*                pBuffer,
@@ -61,6 +76,10 @@ namespace dxvk {
             D3D11CommonTexture*         pTexture,
       const D3D11_SUBRESOURCE_DATA*     pInitialData);
 
+    bool InitHostCopyTexture(
+            D3D11CommonTexture*         pTexture,
+      const D3D11_SUBRESOURCE_DATA*     pInitialData);
+
     void InitHostVisibleTexture(
             D3D11CommonTexture*         pTexture,
       const D3D11_SUBRESOURCE_DATA*     pInitialData);
@@ -68,8 +87,11 @@ namespace dxvk {
     void InitTiledTexture(
             D3D11CommonTexture*         pTexture);
 
-    void FlushImplicit();
-    void FlushInternal();
+    void FlushImplicit(
+            Slot&                       slot);
+
+    void FlushInternal(
+            Slot&                       slot);
 
   };
 
@@ -1,6 +1,7 @@
 #include "d3d11_context_imm.h"
 #include "d3d11_interop.h"
 #include "d3d11_device.h"
+#include "d3d11_fence.h"
 
 #include "../dxvk/dxvk_adapter.h"
 #include "../dxvk/dxvk_device.h"
@@ -85,7 +86,7 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11VkInterop::FlushRenderingCommands() {
     auto immediateContext = m_device->GetContext();
     immediateContext->Flush();
-    immediateContext->SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+    immediateContext->SynchronizeCsThread(DxvkCsThread::SynchronizeAll, DxvkCsSyncReason::Interop);
   }
   
   
@@ -157,4 +158,17 @@ namespace dxvk {
       return E_INVALIDARG;
     }
   }
-}
\ No newline at end of file
+
+
+  HRESULT STDMETHODCALLTYPE D3D11VkInterop::GetFenceSemaphore(
+          ID3D11Fence*                 pFence,
+          VkSemaphore*                 pSemaphore) {
+    if (!pFence || !pSemaphore)
+      return E_INVALIDARG;
+
+    auto fence = static_cast<D3D11Fence*>(pFence);
+    *pSemaphore = fence->GetFence()->handle();
+    return S_OK;
+  }
+  
+}
@@ -8,7 +8,7 @@ namespace dxvk {
 
   class D3D11Device;
   
-  class D3D11VkInterop : public ComObject<IDXGIVkInteropDevice1> {
+  class D3D11VkInterop : public ComObject<IDXGIVkInteropDevice2> {
     
   public:
     
@@ -57,6 +57,10 @@ namespace dxvk {
             VkImage                      vkImage,
             ID3D11Texture2D**            ppTexture2D);
     
+    HRESULT STDMETHODCALLTYPE GetFenceSemaphore(
+            ID3D11Fence*                 pFence,
+            VkSemaphore*                 pSemaphore);
+    
   private:
     
     IDXGIObject* m_container;
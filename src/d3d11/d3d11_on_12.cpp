@@ -13,7 +13,10 @@ namespace dxvk {
     m_device      (pDevice),
     m_d3d12Device (pD3D12Device),
     m_d3d12Queue  (pD3D12Queue) {
-
+    // Query the interop interface once, since wrapped
+    // resources may be acquired and released every frame
+    if (m_d3d12Device != nullptr)
+      m_d3d12Device->QueryInterface(__uuidof(ID3D12DXVKInteropDevice), reinterpret_cast<void**>(&m_interopDevice));
   }
 
 
@@ -46,9 +49,6 @@ namespace dxvk {
           D3D12_RESOURCE_STATES   OutputState,
           REFIID                  riid,
           void**                  ppResource11) {
-    Com<ID3D12DXVKInteropDevice> interopDevice;
-    m_d3d12Device->QueryInterface(__uuidof(ID3D12DXVKInteropDevice), reinterpret_cast<void**>(&interopDevice));
-
     D3D11_ON_12_RESOURCE_INFO info = { };
     info.InputState = InputState;
     info.OutputState = OutputState;
@@ -62,7 +62,7 @@ namespace dxvk {
     }
 
     // Query Vulkan resource handle and buffer offset as necessary
-    if (FAILED(interopDevice->GetVulkanResourceInfo(info.Resource.ptr(), &info.VulkanHandle, &info.VulkanOffset))) {
+    if (FAILED(m_interopDevice->GetVulkanResourceInfo(info.Resource.ptr(), &info.VulkanHandle, &info.VulkanOffset))) {
       Logger::err("D3D11on12Device::CreateWrappedResource: Failed to retrieve Vulkan resource info");
       return E_INVALIDARG;
     }
@@ -109,9 +109,6 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11on12Device::ReleaseWrappedResources(
           ID3D11Resource* const*  ppResources,
           UINT                    ResourceCount) {
-    Com<ID3D12DXVKInteropDevice> interopDevice;
-    m_d3d12Device->QueryInterface(__uuidof(ID3D12DXVKInteropDevice), reinterpret_cast<void**>(&interopDevice));
-
     for (uint32_t i = 0; i < ResourceCount; i++) {
       D3D11_ON_12_RESOURCE_INFO info;
 
@@ -121,7 +118,7 @@ namespace dxvk {
       }
 
       VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
-      interopDevice->GetVulkanImageLayout(info.Resource.ptr(), info.OutputState, &layout);
+      m_interopDevice->GetVulkanImageLayout(info.Resource.ptr(), info.OutputState, &layout);
       m_device->GetContext()->Release11on12Resource(ppResources[i], layout);
     }
   }
@@ -130,9 +127,6 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11on12Device::AcquireWrappedResources(
           ID3D11Resource* const*  ppResources,
           UINT                    ResourceCount) {
-    Com<ID3D12DXVKInteropDevice> interopDevice;
-    m_d3d12Device->QueryInterface(__uuidof(ID3D12DXVKInteropDevice), reinterpret_cast<void**>(&interopDevice));
-
     for (uint32_t i = 0; i < ResourceCount; i++) {
       D3D11_ON_12_RESOURCE_INFO info;
 
@@ -142,7 +136,7 @@ namespace dxvk {
       }
 
       VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
-      interopDevice->GetVulkanImageLayout(info.Resource.ptr(), info.InputState, &layout);
+      m_interopDevice->GetVulkanImageLayout(info.Resource.ptr(), info.InputState, &layout);
       m_device->GetContext()->Acquire11on12Resource(ppResources[i], layout);
     }
   }
@@ -70,6 +70,8 @@ namespace dxvk {
     Com<ID3D12Device>       m_d3d12Device;
     Com<ID3D12CommandQueue> m_d3d12Queue;
 
+    Com<ID3D12DXVKInteropDevice> m_interopDevice;
+
   };
 
 }
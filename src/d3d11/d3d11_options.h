@@ -118,6 +118,15 @@ namespace dxvk {
     /// race conditions.
     bool enableContextLock;
 
+    /// Translates shaders on worker threads instead of during
+    /// shader creation. Shaders that are bound before their
+    /// translation is complete will stall the binding thread.
+    bool asyncShaderTranslation;
+
+    /// Initializes default textures on the CPU via
+    /// VK_EXT_host_image_copy instead of staging buffers.
+    bool enableHostImageCopy;
+
     /// Shader dump path
     std::string shaderDumpPath;
   };
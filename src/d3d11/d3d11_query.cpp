@@ -26,6 +26,9 @@ namespace dxvk {
       case D3D11_QUERY_OCCLUSION_PREDICATE:
         m_query[0] = dxvkDevice->createGpuQuery(
           VK_QUERY_TYPE_OCCLUSION, 0, 0);
+
+        if (dxvkDevice->features().extConditionalRendering.conditionalRendering)
+          m_predicate = CreatePredicateBuffer();
         break;
         
       case D3D11_QUERY_TIMESTAMP:
@@ -209,6 +212,11 @@ namespace dxvk {
       
       default:
         ctx->endQuery(m_query[0]);
+
+        // This must happen before the reset counter is decremented
+        // since the app may read back query data at any time after
+        if (m_predicate.defined())
+          ctx->writePredicate(m_predicate, m_query[0]);
     }
 
     m_resetCtr.fetch_sub(1, std::memory_order_release);
@@ -344,6 +352,23 @@ namespace dxvk {
   }
 
 
+  DxvkBufferSlice D3D11Query::CreatePredicateBuffer() const {
+    Rc<DxvkDevice> device = m_parent->GetDXVKDevice();
+
+    DxvkBufferCreateInfo info;
+    info.size   = sizeof(uint32_t);
+    info.usage  = VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                | VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT
+                | VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT;
+    info.access = VK_ACCESS_TRANSFER_WRITE_BIT
+                | VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT;
+
+    return DxvkBufferSlice(device->createBuffer(info,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+  }
+
+
   HRESULT D3D11Query::ValidateDesc(const D3D11_QUERY_DESC1* pDesc) {
     if (pDesc->Query       >= D3D11_QUERY_PIPELINE_STATISTICS
      && pDesc->ContextType >  D3D11_CONTEXT_TYPE_3D)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../dxvk/dxvk_buffer.h"
 #include "../dxvk/dxvk_gpu_event.h"
 #include "../dxvk/dxvk_gpu_query.h"
 
@@ -81,6 +82,10 @@ namespace dxvk {
       m_stallFlag |= bit::popcnt(m_stallMask) >= 16;
     }
     
+    DxvkBufferSlice GetPredicate() const {
+      return m_predicate;
+    }
+
     D3D10Query* GetD3D10Iface() {
       return &m_d3d10;
     }
@@ -106,6 +111,8 @@ namespace dxvk {
     std::array<Rc<DxvkGpuQuery>, MaxGpuQueries> m_query;
     std::array<Rc<DxvkGpuEvent>, MaxGpuEvents>  m_event;
 
+    DxvkBufferSlice m_predicate;
+
     D3D10Query m_d3d10;
 
     uint32_t m_stallMask = 0;
@@ -114,6 +121,8 @@ namespace dxvk {
     std::atomic<uint32_t> m_resetCtr = { 0u };
 
     UINT64 GetTimestampQueryFrequency() const;
+
+    DxvkBufferSlice CreatePredicateBuffer() const;
     
   };
   
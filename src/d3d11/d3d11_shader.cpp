@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "d3d11_device.h"
 #include "d3d11_shader.h"
 
@@ -14,7 +16,6 @@ namespace dxvk {
     const void*           pShaderBytecode,
           size_t          BytecodeLength) {
     const std::string name = pShaderKey->toString();
-    Logger::debug(str::format("Compiling shader ", name));
     
     DxbcReader reader(
       reinterpret_cast<const char*>(pShaderBytecode),
@@ -29,26 +30,37 @@ namespace dxvk {
         std::ios_base::binary | std::ios_base::trunc));
     }
 
-    // Error out if the shader is invalid
-    DxbcModule module(reader);
-    auto programInfo = module.programInfo();
+    // Only shaders that were successfully compiled before can be
+    // in the shader cache, so there is no need to validate those
+    Sha1Hash compileHash = ComputeCompileHash(pDxbcModuleInfo);
+    m_shader = pDevice->GetDXVKDevice()->lookupShader(*pShaderKey, compileHash);
 
-    if (!programInfo)
-      throw DxvkError("Invalid shader binary.");
+    if (m_shader == nullptr) {
+      Logger::debug(str::format("Compiling shader ", name));
 
-    // Decide whether we need to create a pass-through
-    // geometry shader for vertex shader stream output
-    bool passthroughShader = pDxbcModuleInfo->xfb != nullptr
-      && (programInfo->type() == DxbcProgramType::VertexShader
-       || programInfo->type() == DxbcProgramType::DomainShader);
+      // Error out if the shader is invalid
+      DxbcModule module(reader);
+      auto programInfo = module.programInfo();
 
-    if (programInfo->shaderStage() != pShaderKey->type() && !passthroughShader)
-      throw DxvkError("Mismatching shader type.");
+      if (!programInfo)
+        throw DxvkError("Invalid shader binary.");
 
-    m_shader = passthroughShader
-      ? module.compilePassthroughShader(*pDxbcModuleInfo, name)
-      : module.compile                 (*pDxbcModuleInfo, name);
-    m_shader->setShaderKey(*pShaderKey);
+      // Decide whether we need to create a pass-through
+      // geometry shader for vertex shader stream output
+      bool passthroughShader = pDxbcModuleInfo->xfb != nullptr
+        && (programInfo->type() == DxbcProgramType::VertexShader
+         || programInfo->type() == DxbcProgramType::DomainShader);
+
+      if (programInfo->shaderStage() != pShaderKey->type() && !passthroughShader)
+        throw DxvkError("Mismatching shader type.");
+
+      m_shader = passthroughShader
+        ? module.compilePassthroughShader(*pDxbcModuleInfo, name)
+        : module.compile                 (*pDxbcModuleInfo, name);
+      m_shader->setShaderKey(*pShaderKey);
+
+      pDevice->GetDXVKDevice()->cacheShader(m_shader, compileHash);
+    }
     
     if (dumpPath.size() != 0) {
       std::ofstream dumpStream(
@@ -80,9 +92,139 @@ namespace dxvk {
     pDevice->GetDXVKDevice()->registerShader(m_shader);
   }
 
+
+  D3D11CommonShader::D3D11CommonShader(
+    const Rc<D3D11ShaderTranslation>& Translation)
+  : m_translation(Translation) {
+
+  }
+
+
+  Sha1Hash D3D11CommonShader::ComputeCompileHash(
+    const DxbcModuleInfo* pDxbcModuleInfo) {
+    const DxbcOptions& options = pDxbcModuleInfo->options;
+
+    // Stream output info is already part of the shader key. Pack all
+    // options into a flat array so that padding bytes are not hashed.
+    uint32_t maxTessFactor = 0;
+
+    if (pDxbcModuleInfo->tess)
+      std::memcpy(&maxTessFactor, &pDxbcModuleInfo->tess->maxTessFactor, sizeof(maxTessFactor));
+
+    std::array<uint64_t, 13> data = {{
+      DxbcCompilerRevision,
+      options.useDepthClipWorkaround,
+      options.supportsTypedUavLoadR32,
+      options.useSubgroupOpsForAtomicCounters,
+      options.zeroInitWorkgroupMemory,
+      options.invariantPosition,
+      options.forceVolatileTgsmAccess,
+      options.disableMsaa,
+      options.forceSampleRateShading,
+      options.enableSampleShadingInterlock,
+      options.floatControl.raw(),
+      options.minSsboAlignment,
+      maxTessFactor,
+    }};
+
+    return Sha1Hash::compute(data);
+  }
+
   
+  D3D11ShaderTranslation::D3D11ShaderTranslation(
+          D3D11Device*    pDevice,
+    const DxvkShaderKey*  pShaderKey,
+    const DxbcModuleInfo* pDxbcModuleInfo,
+    const void*           pShaderBytecode,
+          size_t          BytecodeLength)
+  : m_device  (pDevice),
+    m_key     (*pShaderKey),
+    m_info    (*pDxbcModuleInfo),
+    m_bytecode(reinterpret_cast<const char*>(pShaderBytecode),
+               reinterpret_cast<const char*>(pShaderBytecode) + BytecodeLength) {
+    if (m_info.tess) {
+      m_tess = *m_info.tess;
+      m_info.tess = &m_tess;
+    }
+
+    // Parsing the module is cheap compared to translation, so
+    // reject invalid shaders here in order for shader creation
+    // to fail the same way it does without deferred translation
+    DxbcReader reader(m_bytecode.data(), m_bytecode.size());
+    DxbcModule module(reader);
+
+    auto programInfo = module.programInfo();
+
+    if (!programInfo)
+      throw DxvkError("Invalid shader binary.");
+
+    if (programInfo->shaderStage() != pShaderKey->type())
+      throw DxvkError("Mismatching shader type.");
+  }
+
+
+  D3D11ShaderTranslation::~D3D11ShaderTranslation() {
+
+  }
+
+
+  void D3D11ShaderTranslation::Translate() {
+    auto state = D3D11ShaderTranslationState::Pending;
+
+    if (!m_state.compare_exchange_strong(state, D3D11ShaderTranslationState::Running))
+      return;
+
+    try {
+      D3D11CommonShader result(m_device, &m_key,
+        &m_info, m_bytecode.data(), m_bytecode.size());
+
+      if (m_device->IsShaderSupported(result.GetShader()))
+        m_result = std::move(result);
+      else
+        Logger::err(str::format("Shader ", m_key.toString(), " uses unsupported features"));
+    } catch (const DxvkError& e) {
+      Logger::err(e.message());
+    }
+
+    // The bytecode is no longer needed
+    m_bytecode = std::vector<char>();
+
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+      m_state.store(D3D11ShaderTranslationState::Done, std::memory_order_release);
+    }
+
+    m_cond.notify_all();
+  }
+
+
+  const D3D11CommonShader& D3D11ShaderTranslation::WaitForResult() {
+    // If no worker has picked up the shader yet, translate it
+    // here rather than waiting for all previous shaders.
+    Translate();
+
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    m_cond.wait(lock, [this] {
+      return m_state.load(std::memory_order_acquire) == D3D11ShaderTranslationState::Done;
+    });
+
+    return m_result;
+  }
+
+
   D3D11ShaderModuleSet:: D3D11ShaderModuleSet() { }
-  D3D11ShaderModuleSet::~D3D11ShaderModuleSet() { }
+
+
+  D3D11ShaderModuleSet::~D3D11ShaderModuleSet() {
+    { std::unique_lock<dxvk::mutex> lock(m_workerMutex);
+      m_workersStopped = true;
+    }
+
+    m_workerCond.notify_all();
+
+    for (auto& worker : m_workers)
+      worker.join();
+  }
   
   
   HRESULT D3D11ShaderModuleSet::GetShaderModule(
@@ -105,10 +247,17 @@ namespace dxvk {
     // This shader has not been compiled yet, so we have to create a
     // new module. This takes a while, so we won't lock the structure.
     D3D11CommonShader module;
+    Rc<D3D11ShaderTranslation> translation;
     
     try {
-      module = D3D11CommonShader(pDevice, pShaderKey,
-        pDxbcModuleInfo, pShaderBytecode, BytecodeLength);
+      if (pDevice->GetOptions()->asyncShaderTranslation && !pDxbcModuleInfo->xfb) {
+        translation = new D3D11ShaderTranslation(pDevice, pShaderKey,
+          pDxbcModuleInfo, pShaderBytecode, BytecodeLength);
+        module = D3D11CommonShader(translation);
+      } else {
+        module = D3D11CommonShader(pDevice, pShaderKey,
+          pDxbcModuleInfo, pShaderBytecode, BytecodeLength);
+      }
     } catch (const DxvkError& e) {
       Logger::err(e.message());
       return E_INVALIDARG;
@@ -126,9 +275,55 @@ namespace dxvk {
       }
     }
     
+    if (translation != nullptr)
+      EnqueueTranslation(translation);
+
     *pShader = std::move(module);
     return S_OK;
   }
+
+
+  void D3D11ShaderModuleSet::EnqueueTranslation(
+    const Rc<D3D11ShaderTranslation>& Translation) {
+    std::unique_lock<dxvk::mutex> lock(m_workerMutex);
+
+    if (m_workers.empty()) {
+      // Leave some headroom for the application's own loading
+      // threads as well as the pipeline compiler workers
+      uint32_t workerCount = dxvk::thread::hardware_concurrency() / 2;
+      workerCount = std::clamp(workerCount, 1u, 8u);
+
+      for (uint32_t i = 0; i < workerCount; i++)
+        m_workers.emplace_back([this] { RunWorker(); });
+    }
+
+    m_workerQueue.push(Translation);
+    m_workerCond.notify_one();
+  }
+
+
+  void D3D11ShaderModuleSet::RunWorker() {
+    env::setThreadName("dxvk-dxbc");
+
+    while (true) {
+      Rc<D3D11ShaderTranslation> translation;
+
+      { std::unique_lock<dxvk::mutex> lock(m_workerMutex);
+
+        m_workerCond.wait(lock, [this] {
+          return m_workersStopped || !m_workerQueue.empty();
+        });
+
+        if (m_workersStopped)
+          break;
+
+        translation = std::move(m_workerQueue.front());
+        m_workerQueue.pop();
+      }
+
+      translation->Translate();
+    }
+  }
   
 
   D3D11ExtShader::D3D11ExtShader(
@@ -165,8 +360,15 @@ namespace dxvk {
           SIZE_T*                 pCodeSize,
           void*                   pCode) {
     auto shader = m_shader->GetShader();
+
+    if (shader == nullptr)
+      return E_FAIL;
+
     auto code = shader->getRawCode();
 
+    if (!code.size())
+      return E_FAIL;
+
     HRESULT hr = S_OK;
 
     if (pCode) {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "../dxbc/dxbc_module.h"
 #include "../dxvk/dxvk_device.h"
@@ -10,6 +13,7 @@
 
 #include "../util/sha1/sha1_util.h"
 
+#include "../util/thread.h"
 #include "../util/util_env.h"
 
 #include "d3d11_device_child.h"
@@ -18,13 +22,16 @@
 namespace dxvk {
   
   class D3D11Device;
+  class D3D11ShaderTranslation;
   
   /**
    * \brief Common shader object
    * 
    * Stores the compiled SPIR-V shader and the SHA-1
    * hash of the original DXBC shader, which can be
-   * used to identify the shader.
+   * used to identify the shader. If the shader is
+   * translated asynchronously, accessing the shader
+   * waits for the translation to complete.
    */
   class D3D11CommonShader {
     
@@ -37,30 +44,131 @@ namespace dxvk {
       const DxbcModuleInfo* pDxbcModuleInfo,
       const void*           pShaderBytecode,
             size_t          BytecodeLength);
+    D3D11CommonShader(
+      const Rc<D3D11ShaderTranslation>& Translation);
     ~D3D11CommonShader();
 
-    Rc<DxvkShader> GetShader() const {
-      return m_shader;
-    }
+    inline Rc<DxvkShader> GetShader() const;
 
-    DxvkBufferSlice GetIcb() const {
-      return m_buffer != nullptr
-        ? DxvkBufferSlice(m_buffer)
-        : DxvkBufferSlice();
-    }
+    inline DxvkBufferSlice GetIcb() const;
     
     std::string GetName() const {
-      return m_shader->debugName();
+      return GetShader()->debugName();
+    }
+
+    /**
+     * \brief Checks whether the shader is translated asynchronously
+     * \returns \c true if the shader may not be available yet
+     */
+    bool IsPending() const {
+      return m_translation != nullptr;
     }
     
   private:
     
     Rc<DxvkShader> m_shader;
     Rc<DxvkBuffer> m_buffer;
+
+    Rc<D3D11ShaderTranslation> m_translation;
+
+    static Sha1Hash ComputeCompileHash(
+      const DxbcModuleInfo* pDxbcModuleInfo);
     
   };
 
 
+  /**
+   * \brief Shader translation state
+   */
+  enum class D3D11ShaderTranslationState : uint32_t {
+    Pending,
+    Running,
+    Done,
+  };
+
+
+  /**
+   * \brief Deferred shader translation
+   *
+   * Stores a copy of the shader bytecode so that the shader
+   * can be translated on a worker thread. If the shader is
+   * needed before any worker has started translating it,
+   * the calling thread translates it instead.
+   */
+  class D3D11ShaderTranslation : public RcObject {
+
+  public:
+
+    D3D11ShaderTranslation(
+            D3D11Device*    pDevice,
+      const DxvkShaderKey*  pShaderKey,
+      const DxbcModuleInfo* pDxbcModuleInfo,
+      const void*           pShaderBytecode,
+            size_t          BytecodeLength);
+
+    ~D3D11ShaderTranslation();
+
+    /**
+     * \brief Translates the shader
+     *
+     * Does nothing if translation has already been
+     * started by another thread. Safe to call from
+     * any thread.
+     */
+    void Translate();
+
+    /**
+     * \brief Retrieves translated shader
+     *
+     * Translates the shader on the calling thread if
+     * necessary, or waits for the worker to finish.
+     * \returns Translated shader. If translation
+     *    failed, the shader object will be \c nullptr.
+     */
+    const D3D11CommonShader& GetResult() {
+      if (likely(m_state.load(std::memory_order_acquire) == D3D11ShaderTranslationState::Done))
+        return m_result;
+
+      return WaitForResult();
+    }
+
+  private:
+
+    D3D11Device*          m_device;
+    DxvkShaderKey         m_key;
+    DxbcModuleInfo        m_info;
+    DxbcTessInfo          m_tess = { };
+    std::vector<char>     m_bytecode;
+
+    std::atomic<D3D11ShaderTranslationState> m_state = { D3D11ShaderTranslationState::Pending };
+
+    dxvk::mutex               m_mutex;
+    dxvk::condition_variable  m_cond;
+
+    D3D11CommonShader     m_result;
+
+    const D3D11CommonShader& WaitForResult();
+
+  };
+
+
+  Rc<DxvkShader> D3D11CommonShader::GetShader() const {
+    return likely(m_translation == nullptr)
+      ? m_shader
+      : m_translation->GetResult().GetShader();
+  }
+
+
+  DxvkBufferSlice D3D11CommonShader::GetIcb() const {
+    if (unlikely(m_translation != nullptr))
+      return m_translation->GetResult().GetIcb();
+
+    return m_buffer != nullptr
+      ? DxvkBufferSlice(m_buffer)
+      : DxvkBufferSlice();
+  }
+
+
   /**
    * \brief Extended shader interface
    */
@@ -197,6 +305,18 @@ namespace dxvk {
       DxvkShaderKey,
       D3D11CommonShader,
       DxvkHash, DxvkEq> m_modules;
+
+    dxvk::mutex                 m_workerMutex;
+    dxvk::condition_variable    m_workerCond;
+    bool                        m_workersStopped = false;
+
+    std::queue<Rc<D3D11ShaderTranslation>> m_workerQueue;
+    std::vector<dxvk::thread>   m_workers;
+
+    void EnqueueTranslation(
+      const Rc<D3D11ShaderTranslation>& Translation);
+
+    void RunWorker();
     
   };
   
@@ -1,12 +1,14 @@
 #pragma once
 
-#include <unordered_map>
+#include <memory>
 
 #include "d3d11_blend.h"
 #include "d3d11_depth_stencil.h"
 #include "d3d11_rasterizer.h"
 #include "d3d11_sampler.h"
 
+#include "../util/util_flat_map.h"
+
 namespace dxvk {
   
   class D3D11Device;
@@ -58,20 +60,20 @@ namespace dxvk {
       
       auto entry = m_objects.find(desc);
       
-      if (entry != m_objects.end())
-        return ref(&entry->second);
+      if (entry)
+        return ref(entry->get());
       
-      auto result = m_objects.emplace(
-        std::piecewise_construct,
-        std::tuple(desc),
-        std::tuple(device, desc));
-      return ref(&result.first->second);
+      auto& result = m_objects.emplace(desc,
+        std::make_unique<T>(device, desc));
+      return ref(result.get());
     }
     
   private:
     
+    // State objects are handed out by pointer, so they are
+    // allocated individually and survive the map growing.
     dxvk::mutex                                m_mutex;
-    std::unordered_map<DescType, T,
+    flat_hash_map<DescType, std::unique_ptr<T>,
       D3D11StateDescHash, D3D11StateDescEqual> m_objects;
     
   };
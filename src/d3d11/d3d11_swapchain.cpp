@@ -4,6 +4,8 @@
 
 #include "../util/util_win32_compat.h"
 
+#include "../wsi/wsi_monitor.h"
+
 namespace dxvk {
 
   static uint16_t MapGammaControlPoint(float x) {
@@ -334,6 +336,22 @@ namespace dxvk {
   }
 
 
+  void STDMETHODCALLTYPE D3D11SwapChain::SetDisplayMonitor(
+          HMONITOR                  hMonitor) {
+    if (!m_device->config().enableRefreshRatePacing)
+      return;
+
+    wsi::WsiRefreshInfo refreshInfo = { };
+
+    if (hMonitor)
+      wsi::getMonitorRefreshInfo(hMonitor, &refreshInfo);
+
+    m_presenter->setDisplayRefreshRate(
+      refreshInfo.refreshRate,
+      refreshInfo.variableRefresh);
+  }
+
+
   HRESULT D3D11SwapChain::PresentImage(UINT SyncInterval) {
     // Flush pending rendering commands before
     auto immediateContext = m_parent->GetContext();
@@ -342,6 +360,9 @@ namespace dxvk {
 
     // Bump our frame id.
     ++m_frameId;
+
+    if (m_latencyTracker != nullptr)
+      m_latencyTracker->notifyCpuPresent(m_frameId);
     
     for (uint32_t i = 0; i < SyncInterval || i < 1; i++) {
       SynchronizePresent();
@@ -384,13 +405,28 @@ namespace dxvk {
       if (m_hud != nullptr)
         m_hud->render(m_context, info.format, info.imageExtent);
       
-      if (i + 1 >= SyncInterval)
-        m_context->signal(m_frameLatencySignal, m_frameId);
+      // If possible, signal frame latency once the frame has actually
+      // been presented rather than when rendering has completed, so
+      // that the application cannot queue up frames in the WSI.
+      Rc<sync::Signal> presentSignal;
+
+      if (i + 1 >= SyncInterval) {
+        if (m_presenter->supportsPresentWait())
+          presentSignal = m_frameLatencySignal;
+        else
+          m_context->signal(m_frameLatencySignal, m_frameId);
+
+        if (m_latencyTracker != nullptr)
+          m_context->signal(m_latencyTracker, m_frameId);
+      }
 
-      SubmitPresent(immediateContext, sync, i);
+      SubmitPresent(immediateContext, sync, i, presentSignal);
     }
 
     SyncFrameLatency();
+
+    if (m_latencyTracker != nullptr)
+      m_latencyTracker->sleepAndBeginFrame(m_frameId);
     return S_OK;
   }
 
@@ -398,7 +434,8 @@ namespace dxvk {
   void D3D11SwapChain::SubmitPresent(
           D3D11ImmediateContext*  pContext,
     const vk::PresenterSync&      Sync,
-          uint32_t                FrameId) {
+          uint32_t                FrameId,
+    const Rc<sync::Signal>&       Signal) {
     auto lock = pContext->LockContext();
 
     // Present from CS thread so that we don't
@@ -408,6 +445,8 @@ namespace dxvk {
     pContext->EmitCs([this,
       cFrameId     = FrameId,
       cSync        = Sync,
+      cSignal      = Signal,
+      cSignalValue = m_frameId,
       cHud         = m_hud,
       cCommandList = m_context->endRecording()
     ] (DxvkContext* ctx) {
@@ -417,7 +456,7 @@ namespace dxvk {
       if (cHud != nullptr && !cFrameId)
         cHud->update();
 
-      m_device->presentImage(m_presenter, &m_presentStatus);
+      m_device->presentImage(m_presenter, cSignal, cSignalValue, &m_presentStatus);
     });
 
     pContext->FlushCsChunk();
@@ -434,9 +473,13 @@ namespace dxvk {
 
 
   void D3D11SwapChain::RecreateSwapChain(BOOL Vsync) {
-    // Ensure that we can safely destroy the swap chain
+    // Ensure that we can safely destroy the swap chain. Only
+    // wait for the commands that use the swap chain images,
+    // rather than for the entire device to go idle.
     m_device->waitForSubmission(&m_presentStatus);
-    m_device->waitForIdle();
+
+    for (const auto& view : m_imageViews)
+      m_device->waitForResource(view->image(), DxvkAccess::Read);
 
     m_presentStatus.result = VK_SUCCESS;
     m_dirtyHdrMetadata = true;
@@ -447,6 +490,7 @@ namespace dxvk {
     presenterDesc.numFormats      = PickFormats(m_desc.Format, presenterDesc.formats);
     presenterDesc.numPresentModes = PickPresentModes(Vsync, presenterDesc.presentModes);
     presenterDesc.fullScreenExclusive = PickFullscreenMode();
+    presenterDesc.imageUsage      = DxvkSwapchainBlitter::getSwapImageUsage(m_device.ptr());
 
     VkResult vr = m_presenter->recreateSwapChain(presenterDesc);
 
@@ -471,6 +515,9 @@ namespace dxvk {
   void D3D11SwapChain::CreateFrameLatencyEvent() {
     m_frameLatencySignal = new sync::CallbackFence(m_frameId);
 
+    if (m_device->config().latencySleep)
+      m_latencyTracker = new DxvkLatencyTracker(m_frameId);
+
     if (m_desc.Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT)
       m_frameLatencyEvent = CreateSemaphore(nullptr, m_frameLatency, DXGI_MAX_SWAP_CHAIN_BUFFERS, nullptr);
   }
@@ -485,6 +532,8 @@ namespace dxvk {
     presenterDevice.adapter       = m_device->adapter()->handle();
     presenterDevice.features.fullScreenExclusive = m_device->features().extFullScreenExclusive;
     presenterDevice.features.hdrMetadata = m_device->features().extHdrMetadata;
+    presenterDevice.features.presentWait = m_device->features().khrPresentWait.presentWait
+                                        && m_device->config().enablePresentWait;
 
     vk::PresenterDesc presenterDesc;
     presenterDesc.imageExtent     = { m_desc.Width, m_desc.Height };
@@ -492,6 +541,7 @@ namespace dxvk {
     presenterDesc.numFormats      = PickFormats(m_desc.Format, presenterDesc.formats);
     presenterDesc.numPresentModes = PickPresentModes(false, presenterDesc.presentModes);
     presenterDesc.fullScreenExclusive = PickFullscreenMode();
+    presenterDesc.imageUsage      = DxvkSwapchainBlitter::getSwapImageUsage(m_device.ptr());
 
     m_presenter = new vk::Presenter(
       m_device->adapter()->vki(),
@@ -526,7 +576,7 @@ namespace dxvk {
     imageInfo.extent      = { info.imageExtent.width, info.imageExtent.height, 1 };
     imageInfo.numLayers   = 1;
     imageInfo.mipLevels   = 1;
-    imageInfo.usage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    imageInfo.usage       = info.imageUsage;
     imageInfo.stages      = 0;
     imageInfo.access      = 0;
     imageInfo.tiling      = VK_IMAGE_TILING_OPTIMAL;
@@ -536,7 +586,7 @@ namespace dxvk {
     DxvkImageViewCreateInfo viewInfo;
     viewInfo.type         = VK_IMAGE_VIEW_TYPE_2D;
     viewInfo.format       = info.format.format;
-    viewInfo.usage        = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    viewInfo.usage        = info.imageUsage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT);
     viewInfo.aspect       = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.minLevel     = 0;
     viewInfo.numLevels    = 1;
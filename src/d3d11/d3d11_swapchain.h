@@ -4,6 +4,7 @@
 
 #include "../dxvk/hud/dxvk_hud.h"
 
+#include "../dxvk/dxvk_latency.h"
 #include "../dxvk/dxvk_swapchain_blitter.h"
 
 #include "../util/sync/sync_signal.h"
@@ -80,6 +81,9 @@ namespace dxvk {
     HRESULT STDMETHODCALLTYPE SetHDRMetaData(
       const DXGI_VK_HDR_METADATA*     pMetaData);
 
+    void STDMETHODCALLTYPE SetDisplayMonitor(
+            HMONITOR                  hMonitor);
+
   private:
 
     enum BindingIds : uint32_t {
@@ -115,6 +119,7 @@ namespace dxvk {
     uint32_t                m_frameLatencyCap = 0;
     HANDLE                  m_frameLatencyEvent = nullptr;
     Rc<sync::CallbackFence> m_frameLatencySignal;
+    Rc<DxvkLatencyTracker>  m_latencyTracker;
 
     HANDLE                  m_processHandle = nullptr;
 
@@ -131,7 +136,8 @@ namespace dxvk {
     void SubmitPresent(
             D3D11ImmediateContext*  pContext,
       const vk::PresenterSync&      Sync,
-            uint32_t                FrameId);
+            uint32_t                FrameId,
+      const Rc<sync::Signal>&       Signal);
 
     void SynchronizePresent();
 
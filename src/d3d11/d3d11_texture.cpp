@@ -202,11 +202,18 @@ namespace dxvk {
     if (imageInfo.tiling == VK_IMAGE_TILING_OPTIMAL && !isMultiPlane && imageInfo.sharing.mode == DxvkSharedHandleMode::None)
       imageInfo.layout = OptimizeLayout(imageInfo.usage);
 
+    // Hint that render targets may use fixed-rate compression. Skip
+    // UAVs since drivers typically cannot compress storage images.
+    if ((m_desc.BindFlags & (D3D11_BIND_RENDER_TARGET | D3D11_BIND_DEPTH_STENCIL))
+     && !(m_desc.BindFlags & D3D11_BIND_UNORDERED_ACCESS))
+      imageInfo.compression = VK_IMAGE_COMPRESSION_FIXED_RATE_DEFAULT_EXT;
+
     // For some formats, we need to enable sampled and/or
     // render target capabilities if available, but these
     // should in no way affect the default image layout
     imageInfo.usage |= EnableMetaCopyUsage(imageInfo.format, imageInfo.tiling);
     imageInfo.usage |= EnableMetaPackUsage(imageInfo.format, m_desc.CPUAccessFlags);
+    imageInfo.usage |= EnableMetaMipGenUsage(imageInfo.format, imageInfo.tiling);
     
     // Check if we can actually create the image
     if (!CheckImageSupport(&imageInfo, imageInfo.tiling)) {
@@ -222,6 +229,19 @@ namespace dxvk {
         "\n  Usage:   ", std::hex, m_desc.BindFlags,
         "\n  Flags:   ", std::hex, m_desc.MiscFlags));
     }
+
+    // Allow initial data to be uploaded on the host, but only if
+    // the additional usage does not make the image unsupported
+    VkImageUsageFlags hostCopyUsage = EnableHostCopyUsage(imageInfo.format, imageInfo.tiling);
+
+    if (hostCopyUsage && imageInfo.sharing.mode == DxvkSharedHandleMode::None
+     && imageInfo.sampleCount == VK_SAMPLE_COUNT_1_BIT && !isMultiPlane && !m_11on12.Resource) {
+      DxvkImageCreateInfo hostCopyInfo = imageInfo;
+      hostCopyInfo.usage |= hostCopyUsage;
+
+      if (CheckImageSupport(&hostCopyInfo, hostCopyInfo.tiling))
+        imageInfo.usage = hostCopyInfo.usage;
+    }
     
     // Create the image on a host-visible memory type
     // in case it is going to be mapped directly.
@@ -605,6 +625,59 @@ namespace dxvk {
   }
 
 
+  VkImageUsageFlags D3D11CommonTexture::EnableHostCopyUsage(
+          VkFormat              Format,
+          VkImageTiling         Tiling) const {
+    if (!m_device->GetOptions()->enableHostImageCopy
+     || !m_device->GetDXVKDevice()->features().extHostImageCopy.hostImageCopy)
+      return 0;
+
+    // Only device-local images without a mapping buffer are
+    // initialized through the regular upload path, and depth
+    // images need their data to be converted on the GPU
+    if (m_mapMode != D3D11_COMMON_TEXTURE_MAP_MODE_NONE
+     || lookupFormatInfo(Format)->aspectMask != VK_IMAGE_ASPECT_COLOR_BIT)
+      return 0;
+
+    DxvkFormatFeatures support = m_device->GetDXVKDevice()->getFormatFeatures(Format);
+
+    VkFormatFeatureFlags2 supportedFeatures = Tiling == VK_IMAGE_TILING_OPTIMAL
+      ? support.optimal
+      : support.linear;
+
+    if (!(supportedFeatures & VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT))
+      return 0;
+
+    return VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+  }
+
+
+  VkImageUsageFlags D3D11CommonTexture::EnableMetaMipGenUsage(
+          VkFormat              Format,
+          VkImageTiling         Tiling) const {
+    if (!(m_desc.MiscFlags & D3D11_RESOURCE_MISC_GENERATE_MIPS))
+      return 0;
+
+    // Allow mip maps to be generated with a compute
+    // shader if the format supports storage images
+    VkFormatFeatureFlags2 requestedFeatures
+      = VK_FORMAT_FEATURE_2_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+      | VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT
+      | VK_FORMAT_FEATURE_2_STORAGE_WRITE_WITHOUT_FORMAT_BIT;
+
+    DxvkFormatFeatures support = m_device->GetDXVKDevice()->getFormatFeatures(Format);
+
+    VkFormatFeatureFlags2 supportedFeatures = Tiling == VK_IMAGE_TILING_OPTIMAL
+      ? support.optimal
+      : support.linear;
+
+    if ((supportedFeatures & requestedFeatures) != requestedFeatures)
+      return 0;
+
+    return VK_IMAGE_USAGE_STORAGE_BIT;
+  }
+
+
   VkImageUsageFlags D3D11CommonTexture::EnableMetaPackUsage(
           VkFormat              Format,
           UINT                  CpuAccess) const {
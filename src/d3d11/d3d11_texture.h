@@ -437,6 +437,36 @@ namespace dxvk {
             DXGI_FORMAT         Format,
             UINT                Plane) const;
     
+    /**
+     * \brief Retrieves interop image view
+     *
+     * The view is owned by the texture so that any GPU
+     * address queried from it remains valid for as long
+     * as the texture itself is alive.
+     * \returns Interop view, or \c nullptr if none was set
+     */
+    Rc<DxvkImageView> GetInteropView() {
+      std::lock_guard lock(m_interopMutex);
+      return m_interopView;
+    }
+
+    /**
+     * \brief Sets interop image view
+     *
+     * If another thread set a view first, that
+     * view will be kept and returned instead.
+     * \param [in] View Image view of the entire image
+     * \returns Interop view
+     */
+    Rc<DxvkImageView> SetInteropView(const Rc<DxvkImageView>& View) {
+      std::lock_guard lock(m_interopMutex);
+
+      if (m_interopView == nullptr)
+        m_interopView = View;
+
+      return m_interopView;
+    }
+
     /**
      * \brief Retrieves D3D11on12 resource info
      * \returns 11on12 resource info
@@ -496,6 +526,9 @@ namespace dxvk {
     Rc<DxvkImage>                 m_image;
     std::vector<MappedBuffer>     m_buffers;
     std::vector<MappedInfo>       m_mapInfo;
+
+    dxvk::mutex                   m_interopMutex;
+    Rc<DxvkImageView>             m_interopView;
     
     MappedBuffer CreateMappedBuffer(
             UINT                  MipLevel) const;
@@ -512,6 +545,14 @@ namespace dxvk {
             VkFormat              Format,
             VkImageTiling         Tiling) const;
     
+    VkImageUsageFlags EnableHostCopyUsage(
+            VkFormat              Format,
+            VkImageTiling         Tiling) const;
+    
+    VkImageUsageFlags EnableMetaMipGenUsage(
+            VkFormat              Format,
+            VkImageTiling         Tiling) const;
+    
     VkImageUsageFlags EnableMetaPackUsage(
             VkFormat              Format,
             UINT                  CpuAccess) const;
@@ -1030,7 +1030,9 @@ namespace dxvk {
     bool hasStreamsEnabled = false;
 
     // Resetting and restoring all context state incurs
-    // a lot of overhead, so only do it as necessary
+    // a lot of overhead, so only do it as necessary.
+    // Update shadow copies of all input views up front
+    // so that all streams can be drawn in one render pass.
     for (uint32_t i = 0; i < StreamCount; i++) {
       auto streamState = videoProcessor->GetStreamState(i);
 
@@ -1039,18 +1041,29 @@ namespace dxvk {
 
       if (!hasStreamsEnabled) {
         m_ctx->ResetCommandListState();
-        BindOutputView(pOutputView);
         hasStreamsEnabled = true;
       }
 
-      BlitStream(streamState, &pStreams[i]);
+      CopyStreamInput(&pStreams[i]);
     }
 
-    if (hasStreamsEnabled) {
-      UnbindResources();
-      m_ctx->RestoreCommandListState();
+    if (!hasStreamsEnabled)
+      return S_OK;
+
+    BindOutputView(pOutputView);
+
+    for (uint32_t i = 0; i < StreamCount; i++) {
+      auto streamState = videoProcessor->GetStreamState(i);
+
+      if (!pStreams[i].Enable || !streamState)
+        continue;
+
+      BlitStream(streamState, &pStreams[i]);
     }
 
+    UnbindResources();
+    m_ctx->RestoreCommandListState();
+
     return S_OK;
   }
 
@@ -1184,6 +1197,10 @@ namespace dxvk {
           ID3D11VideoProcessorOutputView* pOutputView) {
     auto dxvkView = static_cast<D3D11VideoProcessorOutputView*>(pOutputView)->GetView();
 
+    CreateResources();
+
+    // Shaders and the sampler are the same for all
+    // streams, so only bind them once per blit
     m_ctx->EmitCs([this, cView = dxvkView] (DxvkContext* ctx) {
       DxvkRenderTargets rt;
       rt.color[0].view = cView;
@@ -1196,6 +1213,12 @@ namespace dxvk {
       iaState.primitiveRestart = VK_FALSE;
       iaState.patchVertexCount = 0;
       ctx->setInputAssemblyState(iaState);
+
+      ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(Rc<DxvkShader>(m_vs));
+      ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(Rc<DxvkShader>(m_fs));
+
+      ctx->bindUniformBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice(m_ubo));
+      ctx->bindResourceSampler(VK_SHADER_STAGE_FRAGMENT_BIT, 1, Rc<DxvkSampler>(m_sampler));
     });
 
     VkExtent3D viewExtent = dxvkView->mipLevelExtent(0);
@@ -1206,8 +1229,6 @@ namespace dxvk {
   void D3D11VideoContext::BlitStream(
     const D3D11VideoProcessorStreamState* pStreamState,
     const D3D11_VIDEO_PROCESSOR_STREAM*   pStream) {
-    CreateResources();
-
     if (pStream->PastFrames || pStream->FutureFrames)
       Logger::err("D3D11VideoContext: Ignoring non-zero PastFrames and FutureFrames");
 
@@ -1219,25 +1240,6 @@ namespace dxvk {
 
     auto view = static_cast<D3D11VideoProcessorInputView*>(pStream->pInputSurface);
 
-    if (view->NeedsCopy()) {
-      m_ctx->EmitCs([
-        cDstImage     = view->GetShadowCopy(),
-        cSrcImage     = view->GetImage(),
-        cSrcLayers    = view->GetImageSubresources()
-      ] (DxvkContext* ctx) {
-        VkImageSubresourceLayers cDstLayers;
-        cDstLayers.aspectMask = cSrcLayers.aspectMask;
-        cDstLayers.baseArrayLayer = 0;
-        cDstLayers.layerCount = cSrcLayers.layerCount;
-        cDstLayers.mipLevel = cSrcLayers.mipLevel;
-
-        ctx->copyImage(
-          cDstImage, cDstLayers, VkOffset3D(),
-          cSrcImage, cSrcLayers, VkOffset3D(),
-          cDstImage->info().extent);
-      });
-    }
-
     m_ctx->EmitCs([this,
       cStreamState  = *pStreamState,
       cViews        = view->GetViews(),
@@ -1286,22 +1288,36 @@ namespace dxvk {
       ctx->invalidateBuffer(m_ubo, uboSlice);
       ctx->setViewports(1, &viewport, &scissor);
 
-      ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(Rc<DxvkShader>(m_vs));
-      ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(Rc<DxvkShader>(m_fs));
-
-      ctx->bindUniformBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice(m_ubo));
-      ctx->bindResourceSampler(VK_SHADER_STAGE_FRAGMENT_BIT, 1, Rc<DxvkSampler>(m_sampler));
-
       for (uint32_t i = 0; i < cViews.size(); i++)
         ctx->bindResourceImageView(VK_SHADER_STAGE_FRAGMENT_BIT, 2 + i, Rc<DxvkImageView>(cViews[i]));
 
       ctx->draw(3, 1, 0, 0);
+    });
+  }
 
-      ctx->bindResourceSampler(VK_SHADER_STAGE_FRAGMENT_BIT, 1, nullptr);
 
-      for (uint32_t i = 0; i < cViews.size(); i++)
-        ctx->bindResourceImageView(VK_SHADER_STAGE_FRAGMENT_BIT, 2 + i, nullptr);
-    });
+  void D3D11VideoContext::CopyStreamInput(
+    const D3D11_VIDEO_PROCESSOR_STREAM*   pStream) {
+    auto view = static_cast<D3D11VideoProcessorInputView*>(pStream->pInputSurface);
+
+    if (view->NeedsCopy()) {
+      m_ctx->EmitCs([
+        cDstImage     = view->GetShadowCopy(),
+        cSrcImage     = view->GetImage(),
+        cSrcLayers    = view->GetImageSubresources()
+      ] (DxvkContext* ctx) {
+        VkImageSubresourceLayers cDstLayers;
+        cDstLayers.aspectMask = cSrcLayers.aspectMask;
+        cDstLayers.baseArrayLayer = 0;
+        cDstLayers.layerCount = cSrcLayers.layerCount;
+        cDstLayers.mipLevel = cSrcLayers.mipLevel;
+
+        ctx->copyImage(
+          cDstImage, cDstLayers, VkOffset3D(),
+          cSrcImage, cSrcLayers, VkOffset3D(),
+          cDstImage->info().extent);
+      });
+    }
   }
 
 
@@ -1382,6 +1398,10 @@ namespace dxvk {
       ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(nullptr);
 
       ctx->bindUniformBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice());
+      ctx->bindResourceSampler(VK_SHADER_STAGE_FRAGMENT_BIT, 1, nullptr);
+
+      for (uint32_t i = 0; i < 2; i++)
+        ctx->bindResourceImageView(VK_SHADER_STAGE_FRAGMENT_BIT, 2 + i, nullptr);
     });
   }
 
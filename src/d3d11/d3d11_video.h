@@ -611,6 +611,9 @@ namespace dxvk {
       const D3D11VideoProcessorStreamState* pStreamState,
       const D3D11_VIDEO_PROCESSOR_STREAM*   pStream);
 
+    void CopyStreamInput(
+      const D3D11_VIDEO_PROCESSOR_STREAM*   pStream);
+
     void CreateUniformBuffer();
 
     void CreateSampler();
@@ -46,7 +46,7 @@ namespace dxvk {
 
     }
 
-    inline bool IsDegenerate() { return min == max; }
+    inline bool IsDegenerate() const { return min == max; }
 
     inline void Conjoin(D3D9Range range) {
       if (IsDegenerate())
@@ -57,7 +57,7 @@ namespace dxvk {
       }
     }
 
-    inline bool Overlaps(D3D9Range range) {
+    inline bool Overlaps(D3D9Range range) const {
       if (IsDegenerate())
         return false;
 
@@ -70,6 +70,77 @@ namespace dxvk {
     uint32_t max = 0;
   };
 
+  /**
+   * \brief Set of buffer ranges
+   *
+   * Stores a small number of disjoint ranges. If a new range
+   * does not fit, it gets merged with the closest existing
+   * range, so the set may cover more than what was added,
+   * but never less.
+   */
+  class D3D9RangeSet {
+    constexpr static uint32_t MaxRanges = 8;
+  public:
+
+    inline bool Overlaps(D3D9Range range) const {
+      for (uint32_t i = 0; i < m_count; i++) {
+        if (m_ranges[i].Overlaps(range))
+          return true;
+      }
+
+      return false;
+    }
+
+    inline void Add(D3D9Range range) {
+      if (range.IsDegenerate())
+        return;
+
+      // Absorb all ranges that overlap or touch the new one
+      uint32_t count = 0;
+
+      for (uint32_t i = 0; i < m_count; i++) {
+        if (m_ranges[i].max >= range.min && m_ranges[i].min <= range.max) {
+          range.min = std::min(range.min, m_ranges[i].min);
+          range.max = std::max(range.max, m_ranges[i].max);
+        } else {
+          m_ranges[count++] = m_ranges[i];
+        }
+      }
+
+      m_count = count;
+
+      if (m_count == MaxRanges) {
+        uint32_t closest = 0;
+        uint32_t closestGap = ~0u;
+
+        for (uint32_t i = 0; i < m_count; i++) {
+          uint32_t gap = m_ranges[i].max < range.min
+            ? range.min - m_ranges[i].max
+            : m_ranges[i].min - range.max;
+
+          if (gap < closestGap) {
+            closest = i;
+            closestGap = gap;
+          }
+        }
+
+        range.min = std::min(range.min, m_ranges[closest].min);
+        range.max = std::max(range.max, m_ranges[closest].max);
+
+        m_ranges[closest] = m_ranges[--m_count];
+      }
+
+      m_ranges[m_count++] = range;
+    }
+
+    inline void Clear() { m_count = 0; }
+
+  private:
+
+    std::array<D3D9Range, MaxRanges> m_ranges;
+    uint32_t                         m_count = 0;
+  };
+
   class D3D9CommonBuffer {
     static constexpr VkDeviceSize BufferSliceAlignment = 64;
   public:
@@ -155,6 +226,17 @@ namespace dxvk {
      */
     inline D3D9Range& DirtyRange()  { return m_dirtyRange; }
 
+    /**
+     * \brief Ranges that the GPU may be accessing
+     *
+     * Only tracked for directly mapped buffers. Covers all data
+     * written by the application or the GPU since the buffer was
+     * last discarded, since the GPU can only read data that was
+     * previously written. Locking any other range of the buffer
+     * does not need to wait for the GPU.
+     */
+    inline D3D9RangeSet& UsedRanges() { return m_usedRanges; }
+
     /**
     * \brief Whether or not the buffer was written to by the GPU (in IDirect3DDevice9::ProcessVertices)
     */
@@ -237,6 +319,7 @@ namespace dxvk {
     DxvkBufferSliceHandle       m_sliceHandle;
 
     D3D9Range                   m_dirtyRange;
+    D3D9RangeSet                m_usedRanges;
 
     uint32_t                    m_lockCount = 0;
 
@@ -184,6 +184,10 @@ namespace dxvk {
 
     m_data.Map();
     uint8_t* ptr = reinterpret_cast<uint8_t*>(m_data.Ptr());
+
+    if (unlikely(ptr == nullptr))
+      return nullptr;
+
     ptr += m_memoryOffset[Subresource];
     return ptr;
   }
@@ -258,6 +262,55 @@ namespace dxvk {
   }
 
 
+  void D3D9CommonTexture::AddDirtyRegion(const D3DBOX& box, uint32_t layer) {
+    auto& regions = m_dirtyRegions[layer];
+
+    auto volume = [] (const D3DBOX& b) {
+      return uint64_t(b.Right - b.Left)
+           * uint64_t(b.Bottom - b.Top)
+           * uint64_t(b.Back - b.Front);
+    };
+
+    auto merge = [] (const D3DBOX& a, const D3DBOX& b) {
+      D3DBOX result;
+      result.Left   = std::min(a.Left,   b.Left);
+      result.Right  = std::max(a.Right,  b.Right);
+      result.Top    = std::min(a.Top,    b.Top);
+      result.Bottom = std::max(a.Bottom, b.Bottom);
+      result.Front  = std::min(a.Front,  b.Front);
+      result.Back   = std::max(a.Back,   b.Back);
+      return result;
+    };
+
+    // Skip boxes that are already covered by an existing region
+    for (size_t i = 0; i < regions.size(); i++) {
+      if (volume(merge(regions[i], box)) == volume(regions[i]))
+        return;
+    }
+
+    if (regions.size() < MaxDirtyRegions) {
+      regions.push_back(box);
+      return;
+    }
+
+    // Too many regions, merge the new box into the
+    // region that grows the least as a result
+    size_t bestIndex = 0;
+    uint64_t bestGrowth = ~0ull;
+
+    for (size_t i = 0; i < regions.size(); i++) {
+      uint64_t growth = volume(merge(regions[i], box)) - volume(regions[i]);
+
+      if (growth < bestGrowth) {
+        bestIndex = i;
+        bestGrowth = growth;
+      }
+    }
+
+    regions[bestIndex] = merge(regions[bestIndex], box);
+  }
+
+
   Rc<DxvkImage> D3D9CommonTexture::CreatePrimaryImage(D3DRESOURCETYPE ResourceType, bool TryOffscreenRT, HANDLE* pSharedHandle) const {
     DxvkImageCreateInfo imageInfo;
     imageInfo.type            = GetImageTypeFromResourceType(ResourceType);
@@ -355,6 +408,11 @@ namespace dxvk {
     if (imageInfo.tiling == VK_IMAGE_TILING_OPTIMAL && imageInfo.sharing.mode == DxvkSharedHandleMode::None)
       imageInfo.layout = OptimizeLayout(imageInfo.usage);
 
+    // Hint that render targets and depth buffers
+    // may use fixed-rate compression
+    if (isRT || isDS)
+      imageInfo.compression = VK_IMAGE_COMPRESSION_FIXED_RATE_DEFAULT_EXT;
+
     // For some formats, we need to enable render target
     // capabilities if available, but these should
     // in no way affect the default image layout
@@ -9,6 +9,7 @@
 #include "../dxvk/dxvk_device.h"
 
 #include "../util/util_bit.h"
+#include "../util/util_small_vector.h"
 
 namespace dxvk {
 
@@ -69,7 +70,7 @@ namespace dxvk {
   using D3D9SubresourceBitset = bit::bitset<caps::MaxSubresources>;
 
   class D3D9CommonTexture {
-
+    constexpr static uint32_t MaxDirtyRegions = 4;
   public:
 
     D3D9CommonTexture(
@@ -410,6 +411,8 @@ namespace dxvk {
         box.Bottom = std::min(box.Bottom, m_desc.Height);
         box.Back = std::min(box.Back, m_desc.Depth);
 
+        AddDirtyRegion(box, layer);
+
         D3DBOX& dirtyBox = m_dirtyBoxes[layer];
         if (dirtyBox.Left == dirtyBox.Right) {
           dirtyBox = box;
@@ -423,12 +426,16 @@ namespace dxvk {
         }
       } else {
         m_dirtyBoxes[layer] = { 0, 0, m_desc.Width, m_desc.Height, 0, m_desc.Depth };
+
+        m_dirtyRegions[layer].clear();
+        m_dirtyRegions[layer].push_back(m_dirtyBoxes[layer]);
       }
     }
 
     void ClearDirtyBoxes() {
       for (uint32_t i = 0; i < m_dirtyBoxes.size(); i++) {
         m_dirtyBoxes[i] = { 0, 0, 0, 0, 0, 0 };
+        m_dirtyRegions[i].clear();
       }
     }
 
@@ -436,6 +443,20 @@ namespace dxvk {
       return m_dirtyBoxes[layer];
     }
 
+    /**
+     * \brief Retrieves dirty regions of a layer
+     *
+     * Unlike the dirty box, which is the union of all dirty
+     * regions, this keeps disjoint regions separate as long
+     * as there are few of them, so that uploads do not have
+     * to cover the area in between.
+     * \param [in] layer Array layer or cube face
+     * \returns List of dirty boxes, in mip 0 coordinates
+     */
+    const small_vector<D3DBOX, MaxDirtyRegions>& GetDirtyRegions(uint32_t layer) const {
+      return m_dirtyRegions[layer];
+    }
+
     static VkImageType GetImageTypeFromResourceType(
             D3DRESOURCETYPE  Dimension);
 
@@ -531,9 +552,12 @@ namespace dxvk {
     D3DTEXTUREFILTERTYPE          m_mipFilter = D3DTEXF_LINEAR;
 
     std::array<D3DBOX, 6>         m_dirtyBoxes;
+    std::array<small_vector<D3DBOX, MaxDirtyRegions>, 6> m_dirtyRegions;
 
     D3D9VkInteropTexture          m_d3d9Interop;
 
+    void AddDirtyRegion(const D3DBOX& box, uint32_t layer);
+
     Rc<DxvkImage> CreatePrimaryImage(D3DRESOURCETYPE ResourceType, bool TryOffscreenRT, HANDLE* pSharedHandle) const;
 
     Rc<DxvkImage> CreateResolveImage() const;
@@ -12,6 +12,10 @@ namespace dxvk {
     uint32_t boolCount;
     uint32_t bitmaskCount;
 
+    // Float constants live in their own storage buffer
+    // (SWVP only), relative reads rely on robustness
+    bool     floatAsSsbo;
+
     uint32_t floatSize()     const { return floatCount   * 4 * sizeof(float); }
     uint32_t intSize()       const { return intCount     * 4 * sizeof(int); }
     uint32_t bitmaskSize()   const {
@@ -10,6 +10,7 @@
 #include "../util/util_math.h"
 #include "../util/util_vector.h"
 
+#include <algorithm>
 #include <cstdint>
 
 namespace dxvk {
@@ -44,11 +45,50 @@ namespace dxvk {
     D3D9ConstantBuffer        boolBuffer;
   };
 
+  /**
+   * \brief Dirty constant register range
+   *
+   * Union of all registers of one constant type
+   * that changed since the last upload.
+   */
+  struct D3D9ConstantRange {
+    uint32_t                  begin = 0u;
+    uint32_t                  end   = 0u;
+
+    bool empty() const {
+      return begin >= end;
+    }
+
+    void add(uint32_t first, uint32_t count) {
+      if (empty()) {
+        begin = first;
+        end   = first + count;
+      } else {
+        begin = std::min(begin, first);
+        end   = std::max(end, first + count);
+      }
+    }
+
+    bool overlaps(uint32_t first, uint32_t count) const {
+      return !empty() && begin < first + count && first < end;
+    }
+
+    void clear() {
+      begin = 0u;
+      end   = 0u;
+    }
+  };
+
   struct D3D9ConstantSets {
     D3D9SwvpConstantBuffers   swvp;
     D3D9ConstantBuffer        buffer;
     DxsoShaderMetaInfo        meta  = {};
+    /// Forces all constants to be uploaded, e.g.
+    /// if the range used by the shader changed
     bool                      dirty = true;
+    D3D9ConstantRange         dirtyF;
+    D3D9ConstantRange         dirtyI;
+    D3D9ConstantRange         dirtyB;
   };
 
 }
\ No newline at end of file
@@ -21,7 +21,28 @@ namespace dxvk {
   }
 
 
+  D3D9Cursor::~D3D9Cursor() {
+    for (const auto& entry : m_cache)
+      ::DestroyCursor(entry.cursor);
+  }
+
+
   HRESULT D3D9Cursor::SetHardwareCursor(UINT XHotSpot, UINT YHotSpot, const CursorBitmap& bitmap) {
+    Sha1Hash hash = Sha1Hash::compute(bitmap, sizeof(bitmap));
+
+    // Most recently used cursors are at the end of the list
+    for (auto e = m_cache.begin(); e != m_cache.end(); e++) {
+      if (e->hash == hash && e->xHotSpot == XHotSpot && e->yHotSpot == YHotSpot) {
+        D3D9CursorCacheEntry entry = *e;
+        m_cache.erase(e);
+        m_cache.push_back(entry);
+
+        m_hCursor = entry.cursor;
+        ShowCursor(m_visible);
+        return D3D_OK;
+      }
+    }
+
     DWORD mask[32];
     std::memset(mask, ~0, sizeof(mask));
 
@@ -32,19 +53,30 @@ namespace dxvk {
     info.hbmMask  = ::CreateBitmap(HardwareCursorWidth, HardwareCursorHeight, 1, 1,  mask);
     info.hbmColor = ::CreateBitmap(HardwareCursorWidth, HardwareCursorHeight, 1, 32, &bitmap[0]);
 
-    if (m_hCursor != nullptr)
-      ::DestroyCursor(m_hCursor);
-
     m_hCursor = ::CreateIconIndirect(&info);
 
     ::DeleteObject(info.hbmMask);
     ::DeleteObject(info.hbmColor);
 
+    // Evict the least recently used cursor. This is
+    // never the active one since that was just added.
+    if (m_cache.size() >= MaxCachedCursors) {
+      ::DestroyCursor(m_cache.front().cursor);
+      m_cache.erase(m_cache.begin());
+    }
+
+    m_cache.push_back({ hash, XHotSpot, YHotSpot, m_hCursor });
+
     ShowCursor(m_visible);
 
     return D3D_OK;
   }
 #else
+  D3D9Cursor::~D3D9Cursor() {
+
+  }
+
+
   void D3D9Cursor::UpdateCursor(int X, int Y) {
     Logger::warn("D3D9Cursor::UpdateCursor: Not supported on current platform.");
   }
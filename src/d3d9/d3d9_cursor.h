@@ -1,7 +1,11 @@
 #pragma once
 
+#include <vector>
+
 #include "d3d9_include.h"
 
+#include "../util/sha1/sha1_util.h"
+
 namespace dxvk {
 
   constexpr uint32_t HardwareCursorWidth     = 32u;
@@ -12,10 +16,31 @@ namespace dxvk {
   // Format Size of 4 bytes (ARGB)
   using CursorBitmap = uint8_t[HardwareCursorHeight * HardwareCursorPitch];
 
+  /**
+   * \brief Cached cursor
+   *
+   * Stores a cursor handle along with the hash of the
+   * bitmap and the hot spot it was created with, so that
+   * games cycling through a small set of cursor images do
+   * not have to create a new cursor every time.
+   */
+  struct D3D9CursorCacheEntry {
+    Sha1Hash  hash;
+    UINT      xHotSpot;
+    UINT      yHotSpot;
+#ifdef _WIN32
+    HCURSOR   cursor;
+#endif
+  };
+
   class D3D9Cursor {
 
+    constexpr static size_t MaxCachedCursors = 16;
+
   public:
 
+    ~D3D9Cursor();
+
     void UpdateCursor(int X, int Y);
 
     BOOL ShowCursor(BOOL bShow);
@@ -30,6 +55,8 @@ namespace dxvk {
     HCURSOR m_hCursor       = nullptr;
 #endif
 
+    std::vector<D3D9CursorCacheEntry> m_cache;
+
   };
 
 }
\ No newline at end of file
@@ -92,7 +92,7 @@ namespace dxvk {
       m_robustSSBOAlignment = m_dxvkDevice->properties().extRobustness2.robustStorageBufferAccessSizeAlignment;
       m_robustUBOAlignment  = m_dxvkDevice->properties().extRobustness2.robustUniformBufferAccessSizeAlignment;
       if (canSWVP) {
-        const uint32_t floatBufferAlignment = m_dxsoOptions.vertexFloatConstantBufferAsSSBO ? m_robustSSBOAlignment : m_robustUBOAlignment;
+        const uint32_t floatBufferAlignment = m_vsLayout.floatAsSsbo ? m_robustSSBOAlignment : m_robustUBOAlignment;
         useRobustConstantAccess &= m_vsLayout.floatSize() % floatBufferAlignment == 0;
         useRobustConstantAccess &= m_vsLayout.intSize() % m_robustUBOAlignment == 0;
         useRobustConstantAccess &= m_vsLayout.bitmaskSize() % m_robustUBOAlignment == 0;
@@ -114,6 +114,7 @@ namespace dxvk {
     }
 
     m_usingGraphicsPipelines = dxvkDevice->features().extGraphicsPipelineLibrary.graphicsPipelineLibrary;
+    m_ffUbershader = m_d3d9Options.ffUbershader && dxvkDevice->canUseGraphicsPipelineLibrary();
 
     CreateConstantBuffers();
 
@@ -164,7 +165,7 @@ namespace dxvk {
       return;
 
     Flush();
-    SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+    SynchronizeCsThread(DxvkCsThread::SynchronizeAll, DxvkCsSyncReason::Device);
 
     if (m_annotation)
       delete m_annotation;
@@ -400,7 +401,7 @@ namespace dxvk {
     ResetState(pPresentationParameters);
 
     Flush();
-    SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+    SynchronizeCsThread(DxvkCsThread::SynchronizeAll, DxvkCsSyncReason::Device);
 
     return D3D_OK;
   }
@@ -2564,30 +2565,67 @@ namespace dxvk {
     const uint32_t dataSize = GetUPDataSize(vertexCount, VertexStreamZeroStride);
     const uint32_t bufferSize = GetUPBufferSize(vertexCount, VertexStreamZeroStride);
 
-    auto upSlice = AllocUPBuffer(bufferSize);
-    FillUPVertexBuffer(upSlice.mapPtr, pVertexStreamZeroData, dataSize, bufferSize);
+    // Vertex data can only be appended to a pending batch if it does
+    // not need padding, since the padding would otherwise end up in
+    // between the vertices of the merged draw.
+    bool batchable = bufferSize <= dataSize
+      && CanBatchUPDraw(PrimitiveType, VertexStreamZeroStride);
 
-    EmitCs([this,
-      cBufferSlice  = std::move(upSlice.slice),
-      cPrimType     = PrimitiveType,
-      cStride       = VertexStreamZeroStride,
-      cVertexCount  = vertexCount
-    ](DxvkContext* ctx) mutable {
-      ApplyPrimitiveType(ctx, cPrimType);
+    if (batchable && m_upBatch.vertexCount) {
+      VkDeviceSize batchEnd = m_upBatch.offset + VkDeviceSize(m_upBatch.vertexCount) * m_upBatch.stride;
 
-      // Tests on Windows show that D3D9 does not do non-indexed instanced draws.
+      if (m_upBatch.primType == PrimitiveType
+       && m_upBatch.stride == VertexStreamZeroStride
+       && m_upBufferOffset == align(batchEnd, CACHE_LINE_SIZE)
+       && batchEnd + dataSize <= UPBufferSize) {
+        std::memcpy(reinterpret_cast<char*>(m_upBufferMapPtr) + batchEnd,
+          pVertexStreamZeroData, dataSize);
 
-      ctx->bindVertexBuffer(0, std::move(cBufferSlice), cStride);
-      ctx->draw(
-        cVertexCount, 1,
-        0, 0);
-      ctx->bindVertexBuffer(0, DxvkBufferSlice(), 0);
-    });
+        m_upBufferOffset = align(batchEnd + dataSize, CACHE_LINE_SIZE);
+        m_upBatch.vertexCount += vertexCount;
+        return D3D_OK;
+      }
+    }
+
+    FlushUPBatch();
+
+    // Batched draws need all vertex data to be present so
+    // that subsequent draws can be appended after it
+    const uint32_t allocSize = batchable ? dataSize : bufferSize;
+
+    auto upSlice = AllocUPBuffer(allocSize);
+    FillUPVertexBuffer(upSlice.mapPtr, pVertexStreamZeroData, dataSize, allocSize);
+
+    if (batchable && upSlice.slice.buffer() == m_upBuffer) {
+      m_upBatch.primType    = PrimitiveType;
+      m_upBatch.stride      = VertexStreamZeroStride;
+      m_upBatch.vertexCount = vertexCount;
+      m_upBatch.offset      = upSlice.slice.offset();
+    } else {
+      EmitCs([this,
+        cBufferSlice  = std::move(upSlice.slice),
+        cPrimType     = PrimitiveType,
+        cStride       = VertexStreamZeroStride,
+        cVertexCount  = vertexCount
+      ](DxvkContext* ctx) mutable {
+        ApplyPrimitiveType(ctx, cPrimType);
+
+        // Tests on Windows show that D3D9 does not do non-indexed instanced draws.
+
+        ctx->bindVertexBuffer(0, std::move(cBufferSlice), cStride);
+        ctx->draw(
+          cVertexCount, 1,
+          0, 0);
+        ctx->bindVertexBuffer(0, DxvkBufferSlice(), 0);
+      });
+    }
 
     m_state.vertexBuffers[0].vertexBuffer = nullptr;
     m_state.vertexBuffers[0].offset       = 0;
     m_state.vertexBuffers[0].stride       = 0;
 
+    m_managedVertexBuffers &= ~1u;
+
     return D3D_OK;
   }
 
@@ -2654,6 +2692,8 @@ namespace dxvk {
     m_state.vertexBuffers[0].offset       = 0;
     m_state.vertexBuffers[0].stride       = 0;
 
+    m_managedVertexBuffers &= ~1u;
+
     m_state.indices = nullptr;
 
     return D3D_OK;
@@ -2771,6 +2811,7 @@ namespace dxvk {
     }
 
     dst->SetNeedsReadback(true);
+    dst->UsedRanges().Add(D3D9Range(std::min(offset, dst->Desc()->Size), dst->Desc()->Size));
     TrackBufferMappingBufferSequenceNumber(dst);
 
     return D3D_OK;
@@ -3085,9 +3126,15 @@ namespace dxvk {
     auto& vbo = m_state.vertexBuffers[StreamNumber];
     bool needsUpdate = vbo.vertexBuffer != buffer;
 
-    if (needsUpdate)
+    if (needsUpdate) {
       vbo.vertexBuffer = buffer;
 
+      m_managedVertexBuffers &= ~(1u << StreamNumber);
+
+      if (buffer != nullptr && buffer->GetCommonBuffer()->Desc()->Pool != D3DPOOL_DEFAULT)
+        m_managedVertexBuffers |= 1u << StreamNumber;
+    }
+
     if (buffer != nullptr) {
       needsUpdate |= vbo.offset != OffsetInBytes
                   || vbo.stride != Stride;
@@ -4021,6 +4068,9 @@ namespace dxvk {
     // Enable depth bounds test if we support it.
     enabled.core.features.depthBounds = supported.core.features.depthBounds;
 
+    // Used by the swap chain blitter for compute presentation
+    enabled.core.features.shaderStorageImageWriteWithoutFormat = supported.core.features.shaderStorageImageWriteWithoutFormat;
+
     if (supported.extCustomBorderColor.customBorderColorWithoutFormat) {
       enabled.extCustomBorderColor.customBorderColors             = VK_TRUE;
       enabled.extCustomBorderColor.customBorderColorWithoutFormat = VK_TRUE;
@@ -4040,17 +4090,18 @@ namespace dxvk {
     m_vsLayout.intCount      = canSWVP ? caps::MaxOtherConstantsSoftware : caps::MaxOtherConstants;
     m_vsLayout.boolCount     = canSWVP ? caps::MaxOtherConstantsSoftware : caps::MaxOtherConstants;
     m_vsLayout.bitmaskCount  = align(m_vsLayout.boolCount, 32) / 32;
+    m_vsLayout.floatAsSsbo   = canSWVP && m_vsLayout.floatSize() >
+      m_dxvkDevice->properties().core.properties.limits.maxUniformBufferRange;
 
     m_psLayout.floatCount    = caps::MaxFloatConstantsPS;
     m_psLayout.intCount      = caps::MaxOtherConstants;
     m_psLayout.boolCount     = caps::MaxOtherConstants;
     m_psLayout.bitmaskCount = align(m_psLayout.boolCount, 32) / 32;
+    m_psLayout.floatAsSsbo   = false;
   }
 
 
   D3D9BufferSlice D3D9DeviceEx::AllocUPBuffer(VkDeviceSize size) {
-    constexpr VkDeviceSize UPBufferSize = 1 << 20;
-
     if (unlikely(m_upBuffer == nullptr || size > UPBufferSize)) {
       VkMemoryPropertyFlags memoryFlags
         = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
@@ -4104,6 +4155,44 @@ namespace dxvk {
   }
 
 
+  bool D3D9DeviceEx::CanBatchUPDraw(D3DPRIMITIVETYPE PrimitiveType, uint32_t Stride) {
+    // Strips and fans cannot be concatenated without
+    // changing the primitives that get assembled
+    if (PrimitiveType != D3DPT_POINTLIST
+     && PrimitiveType != D3DPT_LINELIST
+     && PrimitiveType != D3DPT_TRIANGLELIST)
+      return false;
+
+    return Stride != 0;
+  }
+
+
+  void D3D9DeviceEx::FlushUPBatch() {
+    if (!m_upBatch.vertexCount)
+      return;
+
+    D3D9UPDrawBatch batch = m_upBatch;
+    m_upBatch = D3D9UPDrawBatch();
+
+    VkDeviceSize size = VkDeviceSize(batch.vertexCount) * batch.stride;
+
+    EmitCs([this,
+      cBufferSlice  = DxvkBufferSlice(m_upBuffer, batch.offset, size),
+      cPrimType     = batch.primType,
+      cStride       = batch.stride,
+      cVertexCount  = batch.vertexCount
+    ](DxvkContext* ctx) mutable {
+      ApplyPrimitiveType(ctx, cPrimType);
+
+      ctx->bindVertexBuffer(0, std::move(cBufferSlice), cStride);
+      ctx->draw(
+        cVertexCount, 1,
+        0, 0);
+      ctx->bindVertexBuffer(0, DxvkBufferSlice(), 0);
+    });
+  }
+
+
   D3D9BufferSlice D3D9DeviceEx::AllocStagingBuffer(VkDeviceSize size) {
     m_stagingBufferAllocated += size;
 
@@ -4168,7 +4257,7 @@ namespace dxvk {
         if (!needsStall)
           break;
 
-        SynchronizeCsThread(payload.sequenceNumber);
+        SynchronizeCsThread(payload.sequenceNumber, DxvkCsSyncReason::StagingMemory);
         lastSequenceNumber = payload.sequenceNumber;
       }
 
@@ -4208,7 +4297,8 @@ namespace dxvk {
   bool D3D9DeviceEx::WaitForResource(
   const Rc<DxvkResource>&                 Resource,
         uint64_t                          SequenceNumber,
-        DWORD                             MapFlags) {
+        DWORD                             MapFlags,
+        DxvkCsSyncReason                  Reason) {
     // Wait for the any pending D3D9 command to be executed
     // on the CS thread so that we can determine whether the
     // resource is currently in use or not.
@@ -4219,7 +4309,7 @@ namespace dxvk {
       : DxvkAccess::Read;
 
     if (!Resource->isInUse(access))
-      SynchronizeCsThread(SequenceNumber);
+      SynchronizeCsThread(SequenceNumber, Reason);
 
     if (Resource->isInUse(access)) {
       if (MapFlags & D3DLOCK_DONOTWAIT) {
@@ -4233,7 +4323,7 @@ namespace dxvk {
         // Make sure pending commands using the resource get
         // executed on the the GPU if we have to wait for it
         Flush();
-        SynchronizeCsThread(SequenceNumber);
+        SynchronizeCsThread(SequenceNumber, Reason);
 
         m_dxvkDevice->waitForResource(Resource, access);
       }
@@ -4363,6 +4453,14 @@ namespace dxvk {
     // Don't use MapTexture here to keep the mapped list small while the resource is still locked.
     void* mapPtr = pResource->GetData(Subresource);
 
+#ifdef D3D9_ALLOW_UNMAPPING
+    if (unlikely(mapPtr == nullptr && pResource->GetMapMode() == D3D9_COMMON_TEXTURE_MAP_MODE_UNMAPPABLE)) {
+      Logger::warn("D3D9: Mapping texture failed, unmapping all textures");
+      UnmapLeastRecentlyUsedTextures(0);
+      mapPtr = pResource->GetData(Subresource);
+    }
+#endif
+
     if (unlikely(needsReadback)) {
       DxvkBufferSlice mappedBufferSlice = pResource->GetBufferSlice(Subresource);
       const Rc<DxvkBuffer> mappedBuffer = pResource->GetBuffer();
@@ -4444,7 +4542,11 @@ namespace dxvk {
         TrackTextureMappingBufferSequenceNumber(pResource, Subresource);
       }
 
-      if (!WaitForResource(mappedBuffer, pResource->GetMappingBufferSequenceNumber(Subresource), Flags))
+      DxvkCsSyncReason syncReason = (Flags & D3DLOCK_READONLY)
+        ? DxvkCsSyncReason::ImageRead
+        : DxvkCsSyncReason::ImageWrite;
+
+      if (!WaitForResource(mappedBuffer, pResource->GetMappingBufferSequenceNumber(Subresource), Flags, syncReason))
         return D3DERR_WASSTILLDRAWING;
     }
 
@@ -4571,14 +4673,25 @@ namespace dxvk {
     auto subresource = pResource->GetSubresourceFromIndex(
       formatInfo->aspectMask, Subresource);
 
-    const D3DBOX& box = pResource->GetDirtyBox(subresource.arrayLayer);
+    auto UploadBox = [&] (const D3DBOX& box) {
+      VkExtent3D mip0Extent = { box.Right - box.Left, box.Bottom - box.Top, box.Back - box.Front };
+      VkExtent3D extent = util::computeMipLevelExtent(mip0Extent, subresource.mipLevel);
+      VkOffset3D mip0Offset = { int32_t(box.Left), int32_t(box.Top), int32_t(box.Front) };
+      VkOffset3D offset = util::computeMipLevelOffset(mip0Offset, subresource.mipLevel);
+
+      UpdateTextureFromBuffer(pResource, pResource, Subresource, Subresource, offset, extent, offset);
+    };
 
-    VkExtent3D mip0Extent = { box.Right - box.Left, box.Bottom - box.Top, box.Back - box.Front };
-    VkExtent3D extent = util::computeMipLevelExtent(mip0Extent, subresource.mipLevel);
-    VkOffset3D mip0Offset = { int32_t(box.Left), int32_t(box.Top), int32_t(box.Front) };
-    VkOffset3D offset = util::computeMipLevelOffset(mip0Offset, subresource.mipLevel);
+    // The format converter always processes the whole subresource,
+    // so only upload disjoint regions separately for plain copies.
+    const auto& regions = pResource->GetDirtyRegions(subresource.arrayLayer);
 
-    UpdateTextureFromBuffer(pResource, pResource, Subresource, Subresource, offset, extent, offset);
+    if (pResource->GetFormatMapping().ConversionFormatInfo.FormatType == D3D9ConversionFormat_None && regions.size() > 1) {
+      for (size_t i = 0; i < regions.size(); i++)
+        UploadBox(regions[i]);
+    } else {
+      UploadBox(pResource->GetDirtyBox(subresource.arrayLayer));
+    }
 
     if (pResource->IsAutomaticMip())
       MarkTextureMipsDirty(pResource);
@@ -4619,7 +4732,7 @@ namespace dxvk {
       // That means that NeedsReadback is only true if the texture has been used with GetRTData or GetFrontbufferData before.
       // Those functions create a buffer, so the buffer always exists here.
       const Rc<DxvkBuffer>& buffer = pSrcTexture->GetBuffer();
-      WaitForResource(buffer, pSrcTexture->GetMappingBufferSequenceNumber(SrcSubresource), 0);
+      WaitForResource(buffer, pSrcTexture->GetMappingBufferSequenceNumber(SrcSubresource), 0, DxvkCsSyncReason::ImageRead);
       pSrcTexture->SetNeedsReadback(SrcSubresource, false);
     }
 
@@ -4722,13 +4835,24 @@ namespace dxvk {
         slice.mapPtr, mapPtr, srcBlockCount, formatElementSize,
         pitch, std::min(pSrcTexture->GetPlaneCount(), 2u) * pitch * srcBlockCount.height);
 
-      Flush();
-      SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+      // The converter records into its own context, so commands
+      // recorded by the CS thread up to this point must be submitted
+      // first. Doing this on the CS thread avoids stalling the
+      // application thread until all prior work is recorded.
+      EmitCs([this,
+        cConvertFormat = convertFormat,
+        cDstImage      = image,
+        cDstLayers     = convertedDstLayers,
+        cSrcSlice      = slice.slice
+      ] (DxvkContext* ctx) {
+        ctx->flushCommandList(nullptr);
 
-      m_converter->ConvertFormat(
-        convertFormat,
-        image, convertedDstLayers,
-        slice.slice);
+        m_converter->ConvertFormat(
+          cConvertFormat,
+          cDstImage, cDstLayers,
+          cSrcSlice);
+        m_converter->Flush();
+      });
     }
     UnmapTextures();
     FlushImplicit(false);
@@ -4815,6 +4939,10 @@ namespace dxvk {
       });
 
       pResource->SetNeedsReadback(false);
+
+      // The new slice does not contain any data that
+      // the GPU could be using, regardless of bounds
+      pResource->UsedRanges().Clear();
     }
     else {
       // Use map pointer from previous map operation. This
@@ -4827,16 +4955,31 @@ namespace dxvk {
       // NOOVERWRITE promises that they will not write in a currently used area.
       const bool noOverwrite = Flags & D3DLOCK_NOOVERWRITE;
       const bool directMapping = pResource->GetMapMode() == D3D9_COMMON_BUFFER_MAP_MODE_DIRECT;
-      const bool skipWait = (!needsReadback && (readOnly || !directMapping)) || noOverwrite;
+      // The GPU cannot be accessing ranges that were never written.
+      const bool unusedRange = directMapping && respectUserBounds
+        && !pResource->UsedRanges().Overlaps(lockRange);
+      const bool skipWait = (!needsReadback && (readOnly || !directMapping || unusedRange)) || noOverwrite;
       if (!skipWait) {
         const Rc<DxvkBuffer> mappingBuffer = pResource->GetBuffer<D3D9_COMMON_BUFFER_TYPE_MAPPING>();
-        if (!WaitForResource(mappingBuffer, pResource->GetMappingBufferSequenceNumber(), Flags))
+        DxvkCsSyncReason syncReason = readOnly
+          ? DxvkCsSyncReason::BufferRead
+          : DxvkCsSyncReason::BufferWrite;
+
+        if (!WaitForResource(mappingBuffer, pResource->GetMappingBufferSequenceNumber(), Flags, syncReason))
           return D3DERR_WASSTILLDRAWING;
 
         pResource->SetNeedsReadback(false);
       }
     }
 
+    if (directMapping && !(Flags & D3DLOCK_READONLY)) {
+      // Only the range given by the application will contain
+      // valid data, even if the buffer was discarded.
+      uint32_t writeOffset = std::min(OffsetToLock, desc.Size);
+      uint32_t writeSize = SizeToLock ? std::min(SizeToLock, desc.Size - writeOffset) : desc.Size - writeOffset;
+      pResource->UsedRanges().Add(D3D9Range(writeOffset, writeOffset + writeSize));
+    }
+
     uint8_t* data = reinterpret_cast<uint8_t*>(physSlice.mapPtr);
     // The offset/size is not clamped to or affected by the desc size.
     data += OffsetToLock;
@@ -4869,7 +5012,8 @@ namespace dxvk {
 
     D3D9BufferSlice slice = AllocStagingBuffer(range.max - range.min);
     void* srcData = reinterpret_cast<uint8_t*>(srcSlice.mapPtr) + range.min;
-    memcpy(slice.mapPtr, srcData, range.max - range.min);
+    bit::bcopyMapped(slice.mapPtr, srcData, range.max - range.min,
+      !(slice.slice.buffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_CACHED_BIT));
 
     EmitCs([
       cDstSlice  = dstBuffer,
@@ -4932,8 +5076,8 @@ namespace dxvk {
     if (StrongHint || pending <= MaxPendingSubmits) {
       auto now = dxvk::high_resolution_clock::now();
 
-      uint32_t delay = MinFlushIntervalUs
-                     + IncFlushIntervalUs * pending;
+      uint32_t delay = m_flushPacer.scale(MinFlushIntervalUs
+                                        + IncFlushIntervalUs * pending);
 
       // Prevent flushing too often in short intervals.
       if (now - m_lastFlush >= std::chrono::microseconds(delay))
@@ -4942,7 +5086,9 @@ namespace dxvk {
   }
 
 
-  void D3D9DeviceEx::SynchronizeCsThread(uint64_t SequenceNumber) {
+  void D3D9DeviceEx::SynchronizeCsThread(
+          uint64_t                          SequenceNumber,
+          DxvkCsSyncReason                  Reason) {
     D3D9DeviceLock lock = LockDevice();
 
     // Dispatch current chunk so that all commands
@@ -4950,7 +5096,7 @@ namespace dxvk {
     if (SequenceNumber > m_csSeqNum)
       FlushCsChunk();
 
-    m_csThread.synchronize(SequenceNumber);
+    m_csThread.synchronize(SequenceNumber, Reason);
   }
 
 
@@ -5088,11 +5234,6 @@ namespace dxvk {
 
     D3D9ConstantSets& constSet = m_consts[DxsoProgramType::VertexShader];
 
-    if (!constSet.dirty)
-      return;
-
-    constSet.dirty = false;
-
     uint32_t floatCount = m_vsFloatConstsCount;
     if (constSet.meta.needsConstantCopies) {
       auto shader = GetCommonShader(m_state.vertexShader);
@@ -5100,13 +5241,27 @@ namespace dxvk {
     }
     floatCount = std::min(floatCount, constSet.meta.maxConstIndexF);
 
+    const uint32_t intCount  = std::min(constSet.meta.maxConstIndexI, m_vsIntConstsCount);
+    const uint32_t boolCount = std::min(constSet.meta.maxConstIndexB, m_vsBoolConstsCount);
+
+    // Each constant type has its own buffer, so only upload the
+    // ones that have dirty registers within the used range
+    bool uploadF = constSet.dirty || constSet.dirtyF.overlaps(0, floatCount);
+    bool uploadI = constSet.dirty || constSet.dirtyI.overlaps(0, intCount);
+    bool uploadB = constSet.dirty || constSet.dirtyB.overlaps(0, boolCount);
+
+    constSet.dirty = false;
+    constSet.dirtyF.clear();
+    constSet.dirtyI.clear();
+    constSet.dirtyB.clear();
+
     const uint32_t floatDataSize = floatCount * sizeof(Vector4);
-    const uint32_t intDataSize   = std::min(constSet.meta.maxConstIndexI, m_vsIntConstsCount) * sizeof(Vector4i);
-    const uint32_t boolDataSize  = divCeil(std::min(constSet.meta.maxConstIndexB, m_vsBoolConstsCount), 32u) * uint32_t(sizeof(uint32_t));
+    const uint32_t intDataSize   = intCount * sizeof(Vector4i);
+    const uint32_t boolDataSize  = divCeil(boolCount, 32u) * uint32_t(sizeof(uint32_t));
 
     // Max copy source size is 8192 * 16 => always aligned to any plausible value
     // => we won't copy out of bounds
-    if (likely(constSet.meta.maxConstIndexF != 0)) {
+    if (likely(constSet.meta.maxConstIndexF != 0) && uploadF) {
       auto mapPtr = CopySoftwareConstants(constSet.buffer, Src.fConsts, floatDataSize);
 
       if (constSet.meta.needsConstantCopies) {
@@ -5123,10 +5278,10 @@ namespace dxvk {
 
     // Max copy source size is 2048 * 16 => always aligned to any plausible value
     // => we won't copy out of bounds
-    if (likely(constSet.meta.maxConstIndexI != 0))
+    if (likely(constSet.meta.maxConstIndexI != 0) && uploadI)
       CopySoftwareConstants(constSet.swvp.intBuffer, Src.iConsts, intDataSize);
 
-    if (likely(constSet.meta.maxConstIndexB != 0))
+    if (likely(constSet.meta.maxConstIndexB != 0) && uploadB)
       CopySoftwareConstants(constSet.swvp.boolBuffer, Src.bConsts, boolDataSize);
   }
 
@@ -5137,7 +5292,7 @@ namespace dxvk {
     size = align(size, alignment);
 
     auto mapPtr = dstBuffer.Alloc(size);
-    std::memcpy(mapPtr, src, size);
+    bit::bstream(mapPtr, src, size);
     return mapPtr;
   }
 
@@ -5150,11 +5305,6 @@ namespace dxvk {
     */
     D3D9ConstantSets& constSet = m_consts[ShaderStage];
 
-    if (!constSet.dirty)
-      return;
-
-    constSet.dirty = false;
-
     uint32_t floatCount = ShaderStage == DxsoProgramType::VertexShader ? m_vsFloatConstsCount : m_psFloatConstsCount;
     if (constSet.meta.needsConstantCopies) {
       auto shader = GetCommonShader(Shader);
@@ -5162,6 +5312,20 @@ namespace dxvk {
     }
     floatCount = std::min(constSet.meta.maxConstIndexF, floatCount);
 
+    // Bool constants are passed as spec constants, and changes
+    // to unused registers do not require a new upload either
+    bool upload = constSet.dirty
+      || constSet.dirtyF.overlaps(0, floatCount)
+      || constSet.dirtyI.overlaps(0, constSet.meta.maxConstIndexI);
+
+    constSet.dirty = false;
+    constSet.dirtyF.clear();
+    constSet.dirtyI.clear();
+    constSet.dirtyB.clear();
+
+    if (!upload)
+      return;
+
     const uint32_t intRange = caps::MaxOtherConstants * sizeof(Vector4i);
     const uint32_t intDataSize = constSet.meta.maxConstIndexI * sizeof(Vector4i);
     uint32_t floatDataSize = floatCount * sizeof(Vector4);
@@ -5173,9 +5337,9 @@ namespace dxvk {
     auto* dst = reinterpret_cast<HardwareLayoutType*>(mapPtr);
 
     if (constSet.meta.maxConstIndexI != 0)
-      std::memcpy(dst->iConsts, Src.iConsts, intDataSize);
+      bit::bstream(dst->iConsts, Src.iConsts, intDataSize);
     if (constSet.meta.maxConstIndexF != 0)
-      std::memcpy(dst->fConsts, Src.fConsts, floatDataSize);
+      bit::bstream(dst->fConsts, Src.fConsts, floatDataSize);
 
     if (constSet.meta.needsConstantCopies) {
       Vector4* data = reinterpret_cast<Vector4*>(dst->fConsts);
@@ -5295,8 +5459,9 @@ namespace dxvk {
   void D3D9DeviceEx::Flush() {
     D3D9DeviceLock lock = LockDevice();
 
+    FlushUPBatch();
+
     m_initializer->Flush();
-    m_converter->Flush();
 
     if (m_csIsBusy || !m_csChunk->empty()) {
       EmitStagingBufferMarker();
@@ -5310,8 +5475,13 @@ namespace dxvk {
       FlushCsChunk();
 
       // Reset flush timer used for implicit flushes
+      m_flushSeqNum = m_csSeqNum;
       m_lastFlush = dxvk::high_resolution_clock::now();
       m_csIsBusy = false;
+
+      // Adjust flush interval based on how busy the GPU is
+      m_flushPacer.update(m_dxvkDevice->gpuIdleTicks());
+      m_dxvkDevice->setFlushPacing(m_flushPacer.getScale());
     }
   }
 
@@ -6074,6 +6244,15 @@ namespace dxvk {
 
     NormalizeSamplerKey(key);
 
+    // Games often set the same sampler states for every
+    // draw, don't rebind the sampler if nothing changed
+    if ((m_boundSamplerMask & (1u << Sampler))
+     && D3D9SamplerKeyEq()(m_boundSamplerKeys[Sampler], key))
+      return;
+
+    m_boundSamplerKeys[Sampler] = key;
+    m_boundSamplerMask |= 1u << Sampler;
+
     auto samplerInfo = RemapStateSamplerShader(Sampler);
 
     const uint32_t slot = computeResourceSlotId(
@@ -6164,6 +6343,39 @@ namespace dxvk {
   }
 
 
+  void D3D9DeviceEx::BindTextures(uint32_t mask) {
+    std::array<Rc<DxvkImageView>, SamplerCount> imageViews;
+    uint32_t viewCount = 0;
+
+    for (uint32_t i : bit::BitMask(mask)) {
+      const bool srgb =
+        m_state.samplerStates[i][D3DSAMP_SRGBTEXTURE] & 0x1;
+
+      D3D9CommonTexture* commonTex =
+        GetCommonTexture(m_state.textures[i]);
+
+      imageViews[viewCount++] = commonTex->GetSampleView(srgb);
+    }
+
+    EmitCs([
+      cMask       = mask,
+      cImageViews = std::move(imageViews)
+    ](DxvkContext* ctx) mutable {
+      VkShaderStageFlags stage = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+      uint32_t index = 0;
+
+      for (uint32_t i : bit::BitMask(cMask)) {
+        auto shaderSampler = RemapStateSamplerShader(i);
+
+        uint32_t slot = computeResourceSlotId(shaderSampler.first,
+          DxsoBindingType::Image, uint32_t(shaderSampler.second));
+
+        ctx->bindResourceImageView(stage, slot, std::move(cImageViews[index++]));
+      }
+    });
+  }
+
+
   void D3D9DeviceEx::UnbindTextures(uint32_t mask) {
     EmitCs([
       cMask = mask
@@ -6193,8 +6405,13 @@ namespace dxvk {
     const uint32_t activeMask   = usedMask &  m_activeTextures;
     const uint32_t inactiveMask = usedMask & ~m_activeTextures;
 
-    for (uint32_t i : bit::BitMask(activeMask))
-      BindTexture(i);
+    // Use a single CS command if multiple textures changed,
+    // since many games rebind most textures for every draw
+    if (activeMask & (activeMask - 1)) {
+      BindTextures(activeMask);
+    } else if (activeMask) {
+      BindTexture(bit::tzcnt(activeMask));
+    }
 
     if (inactiveMask)
       UnbindTextures(inactiveMask);
@@ -6241,9 +6458,10 @@ namespace dxvk {
       m_lastHazardsRT = m_activeHazardsRT;
     }
 
-    for (uint32_t i = 0; i < caps::MaxStreams; i++) {
+    // Only buffers outside of the default pool can need an upload
+    for (uint32_t i : bit::BitMask(m_managedVertexBuffers)) {
       auto* vbo = GetCommonBuffer(m_state.vertexBuffers[i].vertexBuffer);
-      if (vbo != nullptr && vbo->NeedsUpload())
+      if (vbo->NeedsUpload())
         FlushBuffer(vbo);
     }
 
@@ -6278,26 +6496,7 @@ namespace dxvk {
     if (usedDirtyTextures)
       UndirtyTextures(usedDirtyTextures);
 
-    if (m_flags.test(D3D9DeviceFlag::DirtyBlendState))
-      BindBlendState();
-
-    if (m_flags.test(D3D9DeviceFlag::DirtyDepthStencilState))
-      BindDepthStencilState();
-
-    if (m_flags.test(D3D9DeviceFlag::DirtyRasterizerState))
-      BindRasterizerState();
-
-    if (m_flags.test(D3D9DeviceFlag::DirtyDepthBias))
-      BindDepthBias();
-
-    if (m_flags.test(D3D9DeviceFlag::DirtyMultiSampleState))
-      BindMultiSampleState();
-
-    if (m_flags.test(D3D9DeviceFlag::DirtyAlphaTestState))
-      BindAlphaTestState();
-
-    if (m_flags.test(D3D9DeviceFlag::DirtyClipPlanes))
-      UpdateClipPlanes();
+    BindDirtyRenderStates();
 
     UpdatePointMode(PrimitiveType == D3DPT_POINTLIST);
 
@@ -6395,6 +6594,41 @@ namespace dxvk {
   }
 
 
+  void D3D9DeviceEx::BindDirtyRenderStates() {
+    using BindFn = void (D3D9DeviceEx::*)();
+
+    // Indexed by flag, the functions are independent from each
+    // other so they can be called in any order. Each function
+    // clears its own dirty flag.
+    static const std::array<BindFn, 32> s_bindFns = [] {
+      std::array<BindFn, 32> fns = { };
+      fns[uint32_t(D3D9DeviceFlag::DirtyClipPlanes)]        = &D3D9DeviceEx::UpdateClipPlanes;
+      fns[uint32_t(D3D9DeviceFlag::DirtyDepthStencilState)] = &D3D9DeviceEx::BindDepthStencilState;
+      fns[uint32_t(D3D9DeviceFlag::DirtyBlendState)]        = &D3D9DeviceEx::BindBlendState;
+      fns[uint32_t(D3D9DeviceFlag::DirtyRasterizerState)]   = &D3D9DeviceEx::BindRasterizerState;
+      fns[uint32_t(D3D9DeviceFlag::DirtyDepthBias)]         = &D3D9DeviceEx::BindDepthBias;
+      fns[uint32_t(D3D9DeviceFlag::DirtyAlphaTestState)]    = &D3D9DeviceEx::BindAlphaTestState;
+      fns[uint32_t(D3D9DeviceFlag::DirtyMultiSampleState)]  = &D3D9DeviceEx::BindMultiSampleState;
+      return fns;
+    } ();
+
+    static const D3D9DeviceFlags s_bindMask(
+      D3D9DeviceFlag::DirtyClipPlanes,
+      D3D9DeviceFlag::DirtyDepthStencilState,
+      D3D9DeviceFlag::DirtyBlendState,
+      D3D9DeviceFlag::DirtyRasterizerState,
+      D3D9DeviceFlag::DirtyDepthBias,
+      D3D9DeviceFlag::DirtyAlphaTestState,
+      D3D9DeviceFlag::DirtyMultiSampleState);
+
+    // Usually none of these are dirty between draws
+    uint32_t dirtyMask = (m_flags & s_bindMask).raw();
+
+    for (uint32_t flag : bit::BitMask(dirtyMask))
+      (this->*s_bindFns[flag])();
+  }
+
+
   template <DxsoProgramType ShaderStage>
   void D3D9DeviceEx::BindShader(
   const D3D9CommonShader*                 pShaderModule) {
@@ -6440,80 +6674,18 @@ namespace dxvk {
         cStreamsInstanced = m_instancedData,
         cStreamFreq       = streamFreq
       ] (DxvkContext* ctx) {
-        cIaState.streamsInstanced = cStreamsInstanced;
-        cIaState.streamsUsed      = 0;
-
-        const auto& elements = cVertexDecl->GetElements();
-
-        std::array<DxvkVertexAttribute, 2 * caps::InputRegisterCount> attrList;
-        std::array<DxvkVertexBinding,   2 * caps::InputRegisterCount> bindList;
-
-        uint32_t attrMask = 0;
-        uint32_t bindMask = 0;
-
         const auto& isgn = cVertexShader != nullptr
           ? GetCommonShader(cVertexShader)->GetIsgn()
           : GetFixedFunctionIsgn();
 
-        for (uint32_t i = 0; i < isgn.elemCount; i++) {
-          const auto& decl = isgn.elems[i];
-
-          DxvkVertexAttribute attrib;
-          attrib.location = i;
-          attrib.binding  = NullStreamIdx;
-          attrib.format   = VK_FORMAT_R32G32B32A32_SFLOAT;
-          attrib.offset   = 0;
-
-          for (const auto& element : elements) {
-            DxsoSemantic elementSemantic = { static_cast<DxsoUsage>(element.Usage), element.UsageIndex };
-            if (elementSemantic.usage == DxsoUsage::PositionT)
-              elementSemantic.usage = DxsoUsage::Position;
-
-            if (elementSemantic == decl.semantic) {
-              attrib.binding = uint32_t(element.Stream);
-              attrib.format  = DecodeDecltype(D3DDECLTYPE(element.Type));
-              attrib.offset  = element.Offset;
-
-              cIaState.streamsUsed |= 1u << attrib.binding;
-              break;
-            }
-          }
-
-          attrList[i] = attrib;
+        const auto& layout = cVertexDecl->GetInputLayout(isgn, cStreamFreq);
 
-          DxvkVertexBinding binding;
-          binding.binding = attrib.binding;
-          binding.extent = attrib.offset + lookupFormatInfo(attrib.format)->elementSize;
-
-          uint32_t instanceData = cStreamFreq[binding.binding % caps::MaxStreams];
-          if (instanceData & D3DSTREAMSOURCE_INSTANCEDATA) {
-            binding.fetchRate = instanceData & 0x7FFFFF; // Remove instance packed-in flags in the data.
-            binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
-          }
-          else {
-            binding.fetchRate = 0;
-            binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-          }
-
-          if (bindMask & (1u << binding.binding)) {
-            bindList.at(binding.binding).extent = std::max(
-              bindList.at(binding.binding).extent, binding.extent);
-          } else {
-            bindList.at(binding.binding) = binding;
-          }
-
-          attrMask |= 1u << i;
-          bindMask |= 1u << binding.binding;
-        }
-
-        // Compact the attribute and binding lists to filter
-        // out attributes and bindings not used by the shader
-        uint32_t attrCount = CompactSparseList(attrList.data(), attrMask);
-        uint32_t bindCount = CompactSparseList(bindList.data(), bindMask);
+        cIaState.streamsInstanced = cStreamsInstanced;
+        cIaState.streamsUsed      = layout.streamsUsed;
 
         ctx->setInputLayout(
-          attrCount, attrList.data(),
-          bindCount, bindList.data());
+          layout.attrCount, layout.attrList.data(),
+          layout.bindCount, layout.bindList.data());
       });
     }
   }
@@ -6569,7 +6741,7 @@ namespace dxvk {
       cQuery->End(ctx);
     });
 
-    pQuery->NotifyEnd();
+    pQuery->NotifyEnd(GetCurrentSequenceNumber());
     if (unlikely(pQuery->IsEvent())) {
       pQuery->IsStalling()
         ? Flush()
@@ -6584,7 +6756,7 @@ namespace dxvk {
     m_state.vsConsts->bConsts[idx] &= ~mask;
     m_state.vsConsts->bConsts[idx] |= bits & mask;
 
-    m_consts[DxsoProgramTypes::VertexShader].dirty = true;
+    m_consts[DxsoProgramTypes::VertexShader].dirtyB.add(idx * 32, 32);
   }
 
 
@@ -6592,7 +6764,43 @@ namespace dxvk {
     m_state.psConsts->bConsts[idx] &= ~mask;
     m_state.psConsts->bConsts[idx] |= bits & mask;
 
-    m_consts[DxsoProgramTypes::PixelShader].dirty = true;
+    m_consts[DxsoProgramTypes::PixelShader].dirtyB.add(idx * 32, 32);
+  }
+
+
+  template <
+    DxsoProgramType  ProgramType,
+    D3D9ConstantType ConstantType,
+    typename         T>
+  bool D3D9DeviceEx::ConstantsChanged(
+          UINT  StartRegister,
+    const T*    pConstantData,
+          UINT  Count) {
+    auto CompareHelper = [&] (const auto& set) {
+      if constexpr (ConstantType == D3D9ConstantType::Float) {
+        // Values get modified with float emulation, don't bother
+        if (m_d3d9Options.d3d9FloatEmulation == D3D9FloatEmulation::Enabled)
+          return true;
+
+        return std::memcmp(set->fConsts[StartRegister].data, pConstantData, Count * sizeof(Vector4)) != 0;
+      } else if constexpr (ConstantType == D3D9ConstantType::Int) {
+        return std::memcmp(set->iConsts[StartRegister].data, pConstantData, Count * sizeof(Vector4i)) != 0;
+      } else {
+        for (uint32_t i = 0; i < Count; i++) {
+          uint32_t idx = StartRegister + i;
+          bool bit = (set->bConsts[idx / 32] >> (idx % 32)) & 1u;
+
+          if (bit != bool(pConstantData[i]))
+            return true;
+        }
+
+        return false;
+      }
+    };
+
+    return ProgramType == DxsoProgramTypes::VertexShader
+      ? CompareHelper(m_state.vsConsts)
+      : CompareHelper(m_state.psConsts);
   }
 
 
@@ -6646,30 +6854,40 @@ namespace dxvk {
         pConstantData,
         Count);
 
+    // Growing the used register range requires an upload even if
+    // the values did not change, since the uploaded range grows.
+    bool changed = false;
+
     if constexpr (ProgramType == DxsoProgramType::VertexShader) {
       if constexpr (ConstantType == D3D9ConstantType::Float) {
+        changed = StartRegister + Count > m_vsFloatConstsCount;
         m_vsFloatConstsCount = std::max(m_vsFloatConstsCount, StartRegister + Count);
       } else if constexpr (ConstantType == D3D9ConstantType::Int) {
+        changed = StartRegister + Count > m_vsIntConstsCount;
         m_vsIntConstsCount = std::max(m_vsIntConstsCount, StartRegister + Count);
       } else /* if constexpr (ConstantType == D3D9ConstantType::Bool) */ {
+        changed = StartRegister + Count > m_vsBoolConstsCount;
         m_vsBoolConstsCount = std::max(m_vsBoolConstsCount, StartRegister + Count);
       }
     } else {
       if constexpr (ConstantType == D3D9ConstantType::Float) {
+        changed = StartRegister + Count > m_psFloatConstsCount;
         m_psFloatConstsCount = std::max(m_psFloatConstsCount, StartRegister + Count);
       }
     }
 
-    if constexpr (ConstantType != D3D9ConstantType::Bool) {
-      uint32_t maxCount = ConstantType == D3D9ConstantType::Float
-        ? m_consts[ProgramType].meta.maxConstIndexF
-        : m_consts[ProgramType].meta.maxConstIndexI;
+    // Many games set all of their constants for every draw, so
+    // only mark registers as dirty if their values changed. The
+    // upload then gets skipped if no used register is dirty.
+    if (changed || ConstantsChanged<ProgramType, ConstantType, T>(StartRegister, pConstantData, Count)) {
+      D3D9ConstantSets& constSet = m_consts[ProgramType];
 
-      m_consts[ProgramType].dirty |= StartRegister < maxCount;
-    } else if constexpr (ProgramType == DxsoProgramType::VertexShader) {
-      if (unlikely(CanSWVP())) {
-        m_consts[DxsoProgramType::VertexShader].dirty |= StartRegister < m_consts[ProgramType].meta.maxConstIndexB;
-      }
+      if constexpr (ConstantType == D3D9ConstantType::Float)
+        constSet.dirtyF.add(StartRegister, Count);
+      else if constexpr (ConstantType == D3D9ConstantType::Int)
+        constSet.dirtyI.add(StartRegister, Count);
+      else
+        constSet.dirtyB.add(StartRegister, Count);
     }
 
     UpdateStateConstants<ProgramType, ConstantType, T>(
@@ -6949,13 +7167,59 @@ namespace dxvk {
       if (idx >= 1)
         key.Stages[idx - 1].Contents.ResultIsTemp = false;
 
+      if (m_ffUbershader) {
+        // The ubershader reads stage state from the constant buffer
+        std::array<D3D9FixedFunctionPSStage, caps::TextureStageCount> stages = { };
+
+        for (uint32_t i = 0; i < caps::TextureStageCount; i++) {
+          const auto& stage = key.Stages[i].Contents;
+
+          stages[i].ColorOp = stage.ColorOp | (stage.ColorArg0 << 8) | (stage.ColorArg1 << 16) | (stage.ColorArg2 << 24);
+          stages[i].AlphaOp = stage.AlphaOp | (stage.AlphaArg0 << 8) | (stage.AlphaArg1 << 16) | (stage.AlphaArg2 << 24);
+
+          stages[i].Flags = (stage.ProjectedCount << D3D9FFPSStageFlag_ProjectedCountShift);
+
+          if (stage.ResultIsTemp)
+            stages[i].Flags |= D3D9FFPSStageFlag_ResultIsTemp;
+          if (stage.Projected)
+            stages[i].Flags |= D3D9FFPSStageFlag_Projected;
+          if (stage.TextureBound)
+            stages[i].Flags |= D3D9FFPSStageFlag_TextureBound;
+          if (stage.GlobalSpecularEnable)
+            stages[i].Flags |= D3D9FFPSStageFlag_GlobalSpecularEnable;
+        }
+
+        if (std::memcmp(stages.data(), m_ffPixelStages.data(), sizeof(stages))) {
+          m_ffPixelStages = stages;
+          m_flags.set(D3D9DeviceFlag::DirtyFFPixelData);
+        }
+
+        EmitCs([
+          this,
+          cKey     = key,
+         &cShaders = m_ffModules
+        ](DxvkContext* ctx) {
+          ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(cShaders.GetPixelShader(this, cKey));
+        });
+      } else {
+        EmitCs([
+          this,
+          cKey     = key,
+         &cShaders = m_ffModules
+        ](DxvkContext* ctx) {
+          auto shader = cShaders.GetShaderModule(this, cKey);
+          ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(shader.GetShader());
+        });
+      }
+    } else if (m_ffUbershader && m_ffModules.HasPendingPixelShader()) {
+      // Swap in the specialized shader once it is ready
       EmitCs([
-        this,
-        cKey     = key,
-       &cShaders = m_ffModules
+        &cShaders = m_ffModules
       ](DxvkContext* ctx) {
-        auto shader = cShaders.GetShaderModule(this, cKey);
-        ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(shader.GetShader());
+        Rc<DxvkShader> shader = cShaders.GetPendingPixelShader();
+
+        if (shader != nullptr)
+          ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(std::move(shader));
       });
     }
 
@@ -6969,6 +7233,9 @@ namespace dxvk {
 
       D3D9FixedFunctionPS* data = reinterpret_cast<D3D9FixedFunctionPS*>(mapPtr);
       DecodeD3DCOLOR((D3DCOLOR)rs[D3DRS_TEXTUREFACTOR], data->textureFactor.data);
+
+      for (uint32_t i = 0; i < caps::TextureStageCount; i++)
+        data->Stages[i] = m_ffPixelStages[i];
     }
   }
 
@@ -7408,7 +7675,11 @@ namespace dxvk {
       if (FAILED(D3D9CommonTexture::NormalizeTextureProperties(this, &desc)))
         return D3DERR_NOTAVAILABLE;
 
-      m_autoDepthStencil = new D3D9Surface(this, &desc, nullptr, nullptr);
+      // Reuse the previous depth buffer if possible, its
+      // contents are undefined after a reset either way
+      if (m_autoDepthStencil == nullptr || !m_autoDepthStencil->CanReuse(&desc))
+        m_autoDepthStencil = new D3D9Surface(this, &desc, nullptr, nullptr);
+
       m_initializer->InitTexture(m_autoDepthStencil->GetCommonTexture());
       SetDepthStencilSurface(m_autoDepthStencil.ptr());
     }
@@ -7430,7 +7701,7 @@ namespace dxvk {
     ResetState(pPresentationParameters);
 
     Flush();
-    SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+    SynchronizeCsThread(DxvkCsThread::SynchronizeAll, DxvkCsSyncReason::Device);
 
     return D3D_OK;
   }
@@ -7462,6 +7733,14 @@ namespace dxvk {
 
 #ifdef D3D9_ALLOW_UNMAPPING
     if (likely(pTexture->GetMapMode() == D3D9_COMMON_TEXTURE_MAP_MODE_UNMAPPABLE)) {
+      if (unlikely(ptr == nullptr)) {
+        // We ran out of address space. Unmap everything that
+        // is not currently locked and try again once.
+        Logger::warn("D3D9: Mapping texture failed, unmapping all textures");
+        UnmapLeastRecentlyUsedTextures(0);
+        ptr = pTexture->GetData(Subresource);
+      }
+
       m_mappedTextures.insert(pTexture);
     }
 #endif
@@ -7497,10 +7776,17 @@ namespace dxvk {
     if (likely(mappedMemory < uint32_t(m_d3d9Options.textureMemory)))
       return;
 
-    uint32_t threshold = (m_d3d9Options.textureMemory / 4) * 3;
+    UnmapLeastRecentlyUsedTextures((m_d3d9Options.textureMemory / 4) * 3);
+#endif
+  }
+
 
+  void D3D9DeviceEx::UnmapLeastRecentlyUsedTextures(uint32_t Threshold) {
+    // Will only be called inside the device lock
+
+#ifdef D3D9_ALLOW_UNMAPPING
     auto iter = m_mappedTextures.leastRecentlyUsedIter();
-    while (m_memoryAllocator.MappedMemory() >= threshold && iter != m_mappedTextures.leastRecentlyUsedEndIter()) {
+    while (m_memoryAllocator.MappedMemory() >= Threshold && iter != m_mappedTextures.leastRecentlyUsedEndIter()) {
       if (unlikely((*iter)->IsAnySubresourceLocked() != 0)) {
         iter++;
         continue;
@@ -34,6 +34,7 @@
 #include <type_traits>
 #include <unordered_map>
 
+#include "../util/util_flush.h"
 #include "../util/util_lru.h"
 
 namespace dxvk {
@@ -110,6 +111,21 @@ namespace dxvk {
 
   using D3D9StagingBufferMarker = DxvkMarker<D3D9StagingBufferMarkerPayload>;
 
+  /**
+   * \brief Pending batch of non-indexed UP draws
+   *
+   * Consecutive \c DrawPrimitiveUP calls with list topologies
+   * and the same stride are merged into a single draw as long
+   * as their vertex data is contiguous in the UP buffer and no
+   * other command was recorded in between.
+   */
+  struct D3D9UPDrawBatch {
+    D3DPRIMITIVETYPE  primType    = D3DPRIMITIVETYPE(0);
+    uint32_t          stride      = 0u;
+    uint32_t          vertexCount = 0u;
+    VkDeviceSize      offset      = 0ull;
+  };
+
   class D3D9DeviceEx final : public ComObjectClamp<IDirect3DDevice9Ex> {
     constexpr static uint32_t DefaultFrameLatency = 3;
     constexpr static uint32_t MaxFrameLatency     = 20;
@@ -122,6 +138,8 @@ namespace dxvk {
 
     constexpr static VkDeviceSize StagingBufferSize = 4ull << 20;
 
+    constexpr static VkDeviceSize UPBufferSize = 1ull << 20;
+
     friend class D3D9SwapChainEx;
     friend class D3D9ConstantBuffer;
     friend class D3D9UserDefinedAnnotation;
@@ -691,7 +709,8 @@ namespace dxvk {
     bool WaitForResource(
       const Rc<DxvkResource>&                 Resource,
             uint64_t                          SequenceNumber,
-            DWORD                             MapFlags);
+            DWORD                             MapFlags,
+            DxvkCsSyncReason                  Reason);
 
     /**
      * \brief Locks a subresource of an image
@@ -763,7 +782,9 @@ namespace dxvk {
 
     void CreateConstantBuffers();
 
-    void SynchronizeCsThread(uint64_t SequenceNumber);
+    void SynchronizeCsThread(
+            uint64_t                          SequenceNumber,
+            DxvkCsSyncReason                  Reason);
 
     void Flush();
 
@@ -866,6 +887,8 @@ namespace dxvk {
 
     void BindTexture(DWORD SamplerSampler);
 
+    void BindTextures(uint32_t mask);
+
     void UnbindTextures(uint32_t mask);
 
     void UndirtySamplers(uint32_t mask);
@@ -889,6 +912,8 @@ namespace dxvk {
 
     void BindInputLayout();
 
+    void BindDirtyRenderStates();
+
     void BindVertexBuffer(
             UINT                              Slot,
             D3D9VertexBuffer*                 pBuffer,
@@ -917,6 +942,17 @@ namespace dxvk {
 
     void FlushImplicit(BOOL StrongHint);
 
+    /**
+     * \brief Checks whether commands have been submitted
+     *
+     * \param [in] SequenceNumber CS chunk sequence number
+     * \returns \c true if the given chunk and all chunks
+     *    before it have been flushed to the GPU.
+     */
+    bool IsSequenceNumberFlushed(uint64_t SequenceNumber) const {
+      return SequenceNumber <= m_flushSeqNum;
+    }
+
     bool ChangeReportedMemory(int64_t delta) {
       if (IsExtended())
         return true;
@@ -1002,6 +1038,9 @@ namespace dxvk {
 
     template<typename Cmd>
     void EmitCs(Cmd&& command) {
+      if (unlikely(m_upBatch.vertexCount))
+        FlushUPBatch();
+
       if (unlikely(!m_csChunk->push(command))) {
         EmitCsChunk(std::move(m_csChunk));
 
@@ -1013,6 +1052,9 @@ namespace dxvk {
     void EmitCsChunk(DxvkCsChunkRef&& chunk);
 
     void FlushCsChunk() {
+      if (unlikely(m_upBatch.vertexCount))
+        FlushUPBatch();
+
       if (likely(!m_csChunk->empty())) {
         EmitCsChunk(std::move(m_csChunk));
         m_csChunk = AllocCsChunk();
@@ -1027,6 +1069,10 @@ namespace dxvk {
 
     D3D9BufferSlice AllocUPBuffer(VkDeviceSize size);
 
+    bool CanBatchUPDraw(D3DPRIMITIVETYPE PrimitiveType, uint32_t Stride);
+
+    void FlushUPBatch();
+
     D3D9BufferSlice AllocStagingBuffer(VkDeviceSize size);
 
     void EmitStagingBufferMarker();
@@ -1109,6 +1155,15 @@ namespace dxvk {
         const T*    pConstantData,
               UINT  Count);
 
+    template <
+      DxsoProgramType  ProgramType,
+      D3D9ConstantType ConstantType,
+      typename         T>
+      bool ConstantsChanged(
+              UINT  StartRegister,
+        const T*    pConstantData,
+              UINT  Count);
+
     template <
       DxsoProgramType  ProgramType,
       D3D9ConstantType ConstantType,
@@ -1203,6 +1258,8 @@ namespace dxvk {
 
     void UnmapTextures();
 
+    void UnmapLeastRecentlyUsedTextures(uint32_t Threshold);
+
     uint64_t GetCurrentSequenceNumber();
 
     Com<D3D9InterfaceEx>            m_parent;
@@ -1244,6 +1301,7 @@ namespace dxvk {
     Rc<DxvkBuffer>                  m_upBuffer;
     VkDeviceSize                    m_upBufferOffset  = 0ull;
     void*                           m_upBufferMapPtr  = nullptr;
+    D3D9UPDrawBatch                 m_upBatch;
 
     DxvkStagingBuffer               m_stagingBuffer;
     VkDeviceSize                    m_stagingBufferAllocated      = 0ull;
@@ -1266,6 +1324,11 @@ namespace dxvk {
       D3D9SamplerKeyHash,
       D3D9SamplerKeyEq>             m_samplers;
 
+    // Keys of the samplers last bound to each sampler slot,
+    // so that redundant sampler binds can be skipped
+    std::array<D3D9SamplerKey, SamplerCount> m_boundSamplerKeys = { };
+    uint32_t                        m_boundSamplerMask       = 0;
+
     std::unordered_map<
       DWORD,
       Com<D3D9VertexDecl,
@@ -1300,6 +1363,10 @@ namespace dxvk {
     uint32_t                        m_activeTexturesToUpload = 0;
     uint32_t                        m_activeTexturesToGen    = 0;
 
+    // Streams with a buffer that is not in the default pool
+    // bound, i.e. buffers that may need to be uploaded on draw
+    uint32_t                        m_managedVertexBuffers   = 0;
+
     // m_fetch4Enabled is whether fetch4 is currently enabled
     // from the application.
     //
@@ -1326,6 +1393,9 @@ namespace dxvk {
     VkImageLayout                   m_hazardLayout = VK_IMAGE_LAYOUT_GENERAL;
 
     bool                            m_usingGraphicsPipelines = false;
+    bool                            m_ffUbershader = false;
+
+    std::array<D3D9FixedFunctionPSStage, caps::TextureStageCount> m_ffPixelStages = { };
 
     float                           m_depthBiasScale  = 0.0f;
 
@@ -1350,9 +1420,11 @@ namespace dxvk {
     DxvkCsChunkPool                 m_csChunkPool;
     dxvk::high_resolution_clock::time_point m_lastFlush
       = dxvk::high_resolution_clock::now();
+    GpuFlushPacer                   m_flushPacer;
     DxvkCsThread                    m_csThread;
     DxvkCsChunkRef                  m_csChunk;
     uint64_t                        m_csSeqNum = 0ull;
+    uint64_t                        m_flushSeqNum = 0ull;
     bool                            m_csIsBusy = false;
 
     std::atomic<int64_t>            m_availableMemory = { 0 };
@@ -688,6 +688,7 @@ namespace dxvk {
 
   enum D3D9FFPSMembers {
     TextureFactor = 0,
+    Stages,
 
     MemberCount
   };
@@ -732,7 +733,8 @@ namespace dxvk {
             Rc<DxvkDevice>           Device,
       const D3D9FFShaderKeyFS&       Key,
       const std::string&             Name,
-            D3D9FixedFunctionOptions Options);
+            D3D9FixedFunctionOptions Options,
+            bool                     Ubershader);
 
     Rc<DxvkShader> compile();
 
@@ -758,8 +760,26 @@ namespace dxvk {
 
     void compilePS();
 
+    void compileUberPS();
+
     void setupPS();
 
+    void emitPsOutput(uint32_t color);
+
+    template<typename GetTextureFn>
+    uint32_t emitTextureOp(
+            D3DTEXTUREOP                          op,
+            uint32_t                              dst,
+            std::array<uint32_t, TextureArgCount> arg,
+            uint32_t                              current,
+            uint32_t                              diffuse,
+      const GetTextureFn&                         getTexture);
+
+    uint32_t emitScalarReplicate(uint32_t reg);
+    uint32_t emitAlphaReplicate(uint32_t reg);
+    uint32_t emitComplement(uint32_t reg);
+    uint32_t emitSaturate(uint32_t reg);
+
     void emitPsSharedConstants();
 
     void emitVsClipping(uint32_t vtx);
@@ -787,6 +807,7 @@ namespace dxvk {
     DxsoProgramType       m_programType;
     D3D9FFShaderKeyVS     m_vsKey;
     D3D9FFShaderKeyFS     m_fsKey;
+    bool                  m_ubershader = false;
 
     D3D9FFVertexData      m_vs = { };
     D3D9FFPixelData       m_ps = { };
@@ -829,11 +850,13 @@ namespace dxvk {
           Rc<DxvkDevice>           Device,
     const D3D9FFShaderKeyFS&       Key,
     const std::string&             Name,
-          D3D9FixedFunctionOptions Options)
+          D3D9FixedFunctionOptions Options,
+          bool                     Ubershader)
   : m_module(spvVersion(1, 3)), m_options(Options) {
     m_programType = DxsoProgramTypes::PixelShader;
-    m_fsKey    = Key;
-    m_filename = Name;
+    m_fsKey      = Key;
+    m_filename   = Name;
+    m_ubershader = Ubershader;
   }
 
 
@@ -873,6 +896,8 @@ namespace dxvk {
 
     if (isVS())
       compileVS();
+    else if (m_ubershader)
+      compileUberPS();
     else
       compilePS();
 
@@ -1857,30 +1882,6 @@ namespace dxvk {
         return texture;
       };
 
-      auto ScalarReplicate = [&](uint32_t reg) {
-        std::array<uint32_t, 4> replicant = { reg, reg, reg, reg };
-        return m_module.opCompositeConstruct(m_vec4Type, replicant.size(), replicant.data());
-      };
-
-      auto AlphaReplicate = [&](uint32_t reg) {
-        uint32_t alphaComponentId = 3;
-        uint32_t alpha = m_module.opCompositeExtract(m_floatType, reg, 1, &alphaComponentId);
-
-        return ScalarReplicate(alpha);
-      };
-
-      auto Complement = [&](uint32_t reg) {
-        return m_module.opFSub(m_vec4Type,
-          m_module.constvec4f32(1.0f, 1.0f, 1.0f, 1.0f),
-          reg);
-      };
-
-      auto Saturate = [&](uint32_t reg) {
-        return m_module.opFClamp(m_vec4Type, reg,
-          m_module.constvec4f32(0.0f, 0.0f, 0.0f, 0.0f),
-          m_module.constvec4f32(1.0f, 1.0f, 1.0f, 1.0f));
-      };
-
       auto GetArg = [&] (uint32_t arg) {
         uint32_t reg = m_module.constvec4f32(1.0f, 1.0f, 1.0f, 1.0f);
 
@@ -1921,163 +1922,21 @@ namespace dxvk {
 
         // reg = 1 - reg
         if (arg & D3DTA_COMPLEMENT)
-          reg = Complement(reg);
+          reg = emitComplement(reg);
 
         // reg = reg.wwww
         if (arg & D3DTA_ALPHAREPLICATE)
-          reg = AlphaReplicate(reg);
+          reg = emitAlphaReplicate(reg);
 
         return reg;
       };
 
       auto DoOp = [&](D3DTEXTUREOP op, uint32_t dst, std::array<uint32_t, TextureArgCount> arg) {
-        switch (op) {
-          case D3DTOP_SELECTARG1:
-            dst = arg[1];
-            break;
-
-          case D3DTOP_SELECTARG2:
-            dst = arg[2];
-            break;
-
-          case D3DTOP_MODULATE4X:
-            dst = m_module.opFMul(m_vec4Type, arg[1], arg[2]);
-            dst = m_module.opVectorTimesScalar(m_vec4Type, dst, m_module.constf32(4.0f));
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_MODULATE2X:
-            dst = m_module.opFMul(m_vec4Type, arg[1], arg[2]);
-            dst = m_module.opVectorTimesScalar(m_vec4Type, dst, m_module.constf32(2.0f));
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_MODULATE:
-            dst = m_module.opFMul(m_vec4Type, arg[1], arg[2]);
-            break;
-
-          case D3DTOP_ADDSIGNED2X:
-            arg[2] = m_module.opFSub(m_vec4Type, arg[2],
-              m_module.constvec4f32(0.5f, 0.5f, 0.5f, 0.5f));
-
-            dst = m_module.opFAdd(m_vec4Type, arg[1], arg[2]);
-            dst = m_module.opVectorTimesScalar(m_vec4Type, dst, m_module.constf32(2.0f));
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_ADDSIGNED:
-            arg[2] = m_module.opFSub(m_vec4Type, arg[2],
-              m_module.constvec4f32(0.5f, 0.5f, 0.5f, 0.5f));
-
-            dst = m_module.opFAdd(m_vec4Type, arg[1], arg[2]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_ADD:
-            dst = m_module.opFAdd(m_vec4Type, arg[1], arg[2]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_SUBTRACT:
-            dst = m_module.opFSub(m_vec4Type, arg[1], arg[2]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_ADDSMOOTH:
-            dst = m_module.opFFma(m_vec4Type, Complement(arg[1]), arg[2], arg[1]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_BLENDDIFFUSEALPHA:
-            dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], AlphaReplicate(diffuse));
-            break;
-
-          case D3DTOP_BLENDTEXTUREALPHA:
-            dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], AlphaReplicate(GetTexture()));
-            break;
-
-          case D3DTOP_BLENDFACTORALPHA:
-            dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], AlphaReplicate(m_ps.constants.textureFactor));
-            break;
-
-          case D3DTOP_BLENDTEXTUREALPHAPM:
-            dst = m_module.opFFma(m_vec4Type, arg[2], Complement(AlphaReplicate(GetTexture())), arg[1]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_BLENDCURRENTALPHA:
-            dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], AlphaReplicate(current));
-            break;
-
-          case D3DTOP_PREMODULATE:
-            Logger::warn("D3DTOP_PREMODULATE: not implemented");
-            break;
-
-          case D3DTOP_MODULATEALPHA_ADDCOLOR:
-            dst = m_module.opFFma(m_vec4Type, AlphaReplicate(arg[1]), arg[2], arg[1]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_MODULATECOLOR_ADDALPHA:
-            dst = m_module.opFFma(m_vec4Type, arg[1], arg[2], AlphaReplicate(arg[1]));
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_MODULATEINVALPHA_ADDCOLOR:
-            dst = m_module.opFFma(m_vec4Type, Complement(AlphaReplicate(arg[1])), arg[2], arg[1]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_MODULATEINVCOLOR_ADDALPHA:
-            dst = m_module.opFFma(m_vec4Type, Complement(arg[1]), arg[2], AlphaReplicate(arg[1]));
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_BUMPENVMAPLUMINANCE:
-          case D3DTOP_BUMPENVMAP:
-            // Load texture for the next stage...
-            texture = GetTexture();
-            break;
-
-          case D3DTOP_DOTPRODUCT3: {
-            // Get vec3 of arg1 & 2
-            uint32_t vec3Type = m_module.defVectorType(m_floatType, 3);
-            std::array<uint32_t, 3> indices = { 0, 1, 2 };
-            arg[1] = m_module.opVectorShuffle(vec3Type, arg[1], arg[1], indices.size(), indices.data());
-            arg[2] = m_module.opVectorShuffle(vec3Type, arg[2], arg[2], indices.size(), indices.data());
-
-            // Bias according to spec.
-            arg[1] = m_module.opFSub(vec3Type, arg[1], m_module.constvec3f32(0.5f, 0.5f, 0.5f));
-            arg[2] = m_module.opFSub(vec3Type, arg[2], m_module.constvec3f32(0.5f, 0.5f, 0.5f));
-
-            // Do the dotting!
-            dst = m_module.opDot(m_floatType, arg[1], arg[2]);
-
-            // Multiply by 4 and replicate -> vec4
-            dst = m_module.opFMul(m_floatType, dst, m_module.constf32(4.0f));
-            dst = ScalarReplicate(dst);
-
-            // Saturate
-            dst = Saturate(dst);
-
-            break;
-          }
-
-          case D3DTOP_MULTIPLYADD:
-            dst = m_module.opFFma(m_vec4Type, arg[1], arg[2], arg[0]);
-            dst = Saturate(dst);
-            break;
-
-          case D3DTOP_LERP:
-            dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], arg[0]);
-            break;
+        // Load texture for the next stage...
+        if (op == D3DTOP_BUMPENVMAP || op == D3DTOP_BUMPENVMAPLUMINANCE)
+          texture = GetTexture();
 
-          default:
-            Logger::warn("Unhandled texture op!");
-            break;
-        }
-
-        return dst;
+        return emitTextureOp(op, dst, arg, current, diffuse, GetTexture);
       };
 
       uint32_t& dst = stage.ResultIsTemp ? temp : current;
@@ -2145,25 +2004,516 @@ namespace dxvk {
       current = m_module.opFAdd(m_vec4Type, current, specular);
     }
 
+    emitPsOutput(current);
+  }
+
+
+  void D3D9FFShaderCompiler::compileUberPS() {
+    setupPS();
+
+    uint32_t boolType  = m_module.defBoolType();
+    uint32_t bvec4Type = m_module.defVectorType(boolType, 4);
+    uint32_t uvec4Type = m_module.defVectorType(m_uint32Type, 4);
+
+    uint32_t vec4PtrType = m_module.defPointerType(m_vec4Type, spv::StorageClassPrivate);
+
+    uint32_t diffuse  = m_ps.in.COLOR[0];
+    uint32_t specular = m_ps.in.COLOR[1];
+
+    // Stage state is only known at runtime, so registers need
+    // to live in variables rather than SSA values.
+    uint32_t currentVar = m_module.newVar(vec4PtrType, spv::StorageClassPrivate);
+    uint32_t tempVar    = m_module.newVar(vec4PtrType, spv::StorageClassPrivate);
+    uint32_t textureVar = m_module.newVar(vec4PtrType, spv::StorageClassPrivate);
+    uint32_t resultVar  = m_module.newVar(vec4PtrType, spv::StorageClassPrivate);
+
+    m_module.setDebugName(currentVar, "current");
+    m_module.setDebugName(tempVar,    "temp");
+    m_module.setDebugName(textureVar, "texture");
+
+    // Current starts of as equal to diffuse.
+    m_module.opStore(currentVar, diffuse);
+    // Temp starts off as equal to vec4(0)
+    m_module.opStore(tempVar, m_module.constvec4f32(0.0f, 0.0f, 0.0f, 0.0f));
+    m_module.opStore(textureVar, m_module.constvec4f32(0.0f, 0.0f, 0.0f, 1.0f));
+
+    uint32_t unboundTextureConstId = m_module.constvec4f32(0.0f, 0.0f, 0.0f, 1.0f);
+
+    auto SelectVec4 = [&](uint32_t cond, uint32_t a, uint32_t b) {
+      std::array<uint32_t, 4> conds = { cond, cond, cond, cond };
+      return m_module.opSelect(m_vec4Type, m_module.opCompositeConstruct(
+        bvec4Type, conds.size(), conds.data()), a, b);
+    };
+
+    auto Extract = [&](uint32_t word, uint32_t offset, uint32_t count) {
+      return m_module.opBitFieldUExtract(m_uint32Type, word,
+        m_module.consti32(offset), m_module.consti32(count));
+    };
+
+    auto TestBits = [&](uint32_t word, uint32_t mask) {
+      return m_module.opINotEqual(boolType,
+        m_module.opBitwiseAnd(m_uint32Type, word, m_module.constu32(mask)),
+        m_module.constu32(0));
+    };
+
+    auto IsValue = [&](uint32_t value, uint32_t literal) {
+      return m_module.opIEqual(boolType, value, m_module.constu32(literal));
+    };
+
+    auto LoadShared = [&](uint32_t type, uint32_t index) {
+      uint32_t offset = m_module.constu32(index);
+      uint32_t ptr    = m_module.opAccessChain(m_module.defPointerType(type, spv::StorageClassUniform),
+        m_ps.sharedState, 1, &offset);
+
+      return m_module.opLoad(type, ptr);
+    };
+
+    // All ops that compute a new value, anything
+    // else leaves the destination register as-is.
+    static constexpr std::array<D3DTEXTUREOP, 22> textureOps = {
+      D3DTOP_SELECTARG1,
+      D3DTOP_SELECTARG2,
+      D3DTOP_MODULATE,
+      D3DTOP_MODULATE2X,
+      D3DTOP_MODULATE4X,
+      D3DTOP_ADD,
+      D3DTOP_ADDSIGNED,
+      D3DTOP_ADDSIGNED2X,
+      D3DTOP_SUBTRACT,
+      D3DTOP_ADDSMOOTH,
+      D3DTOP_BLENDDIFFUSEALPHA,
+      D3DTOP_BLENDTEXTUREALPHA,
+      D3DTOP_BLENDFACTORALPHA,
+      D3DTOP_BLENDTEXTUREALPHAPM,
+      D3DTOP_BLENDCURRENTALPHA,
+      D3DTOP_MODULATEALPHA_ADDCOLOR,
+      D3DTOP_MODULATECOLOR_ADDALPHA,
+      D3DTOP_MODULATEINVALPHA_ADDCOLOR,
+      D3DTOP_MODULATEINVCOLOR_ADDALPHA,
+      D3DTOP_DOTPRODUCT3,
+      D3DTOP_MULTIPLYADD,
+      D3DTOP_LERP,
+    };
+
+    std::array<uint32_t, caps::TextureStageCount> mergeLabels;
+
+    uint32_t globalSpecular = 0;
+    uint32_t prevColorOp    = 0;
+
+    for (uint32_t i = 0; i < caps::TextureStageCount; i++) {
+      std::array<uint32_t, 2> stageIndices = {
+        m_module.constu32(uint32_t(D3D9FFPSMembers::Stages)),
+        m_module.constu32(i) };
+
+      uint32_t stageData = m_module.opLoad(uvec4Type,
+        m_module.opAccessChain(m_module.defPointerType(uvec4Type, spv::StorageClassUniform),
+          m_ps.constantBuffer, stageIndices.size(), stageIndices.data()));
+
+      std::array<uint32_t, 3> wordIndices = { 0, 1, 2 };
+      uint32_t colorWord = m_module.opCompositeExtract(m_uint32Type, stageData, 1, &wordIndices[0]);
+      uint32_t alphaWord = m_module.opCompositeExtract(m_uint32Type, stageData, 1, &wordIndices[1]);
+      uint32_t flags     = m_module.opCompositeExtract(m_uint32Type, stageData, 1, &wordIndices[2]);
+
+      uint32_t colorOp = Extract(colorWord, 0, 8);
+      uint32_t alphaOp = Extract(alphaWord, 0, 8);
+
+      if (i == 0)
+        globalSpecular = TestBits(flags, D3D9FFPSStageFlag_GlobalSpecularEnable);
+
+      // This cancels all subsequent stages, so nest them
+      // inside the current stage's conditional block.
+      uint32_t stageLabel = m_module.allocateId();
+      mergeLabels[i] = m_module.allocateId();
+
+      m_module.opSelectionMerge(mergeLabels[i], spv::SelectionControlMaskNone);
+      m_module.opBranchConditional(
+        m_module.opINotEqual(boolType, colorOp, m_module.constu32(D3DTOP_DISABLE)),
+        stageLabel, mergeLabels[i]);
+      m_module.opLabel(stageLabel);
+
+      uint32_t textureBound = TestBits(flags, D3D9FFPSStageFlag_TextureBound);
+
+      uint32_t sampleLabel    = m_module.allocateId();
+      uint32_t sampleEndLabel = m_module.allocateId();
+
+      m_module.opSelectionMerge(sampleEndLabel, spv::SelectionControlMaskNone);
+      m_module.opBranchConditional(textureBound, sampleLabel, sampleEndLabel);
+      m_module.opLabel(sampleLabel);
+
+      {
+        uint32_t texcoordCnt = m_ps.samplers[i].texcoordCnt;
+
+        std::array<uint32_t, 4> indices = { 0, 1, 2, 3 };
+
+        uint32_t texcoord   = m_ps.in.TEXCOORD[i];
+        uint32_t texcoord_t = m_module.defVectorType(m_floatType, texcoordCnt);
+        texcoord = m_module.opVectorShuffle(texcoord_t,
+          texcoord, texcoord, texcoordCnt, indices.data());
+
+        // Apply projection manually since whether or not
+        // the stage is projected is not known up front.
+        uint32_t projCount = Extract(flags, D3D9FFPSStageFlag_ProjectedCountShift, 3);
+        uint32_t projIdx   = m_module.opSelect(m_uint32Type, IsValue(projCount, 0),
+          m_module.constu32(std::min(texcoordCnt + 1, 3u)),
+          m_module.opISub(m_uint32Type, projCount, m_module.constu32(1)));
+
+        uint32_t projValue = m_module.opVectorExtractDynamic(m_floatType, m_ps.in.TEXCOORD[i], projIdx);
+        uint32_t projScale = m_module.opSelect(m_floatType,
+          TestBits(flags, D3D9FFPSStageFlag_Projected),
+          m_module.opFDiv(m_floatType, m_module.constf32(1.0f), projValue),
+          m_module.constf32(1.0f));
+
+        texcoord = m_module.opVectorTimesScalar(texcoord_t, texcoord, projScale);
+
+        if (i != 0) {
+          uint32_t isBumpmap = m_module.opLogicalOr(boolType,
+            IsValue(prevColorOp, D3DTOP_BUMPENVMAP),
+            IsValue(prevColorOp, D3DTOP_BUMPENVMAPLUMINANCE));
+
+          uint32_t texture = m_module.opLoad(m_vec4Type, textureVar);
+          uint32_t t       = m_module.opVectorShuffle(m_vec2Type, texture, texture, 2, indices.data());
+          uint32_t coords  = texcoord;
+
+          for (uint32_t j = 0; j < 2; j++) {
+            uint32_t tc_m_n = m_module.opCompositeExtract(m_floatType, coords, 1, &j);
+            uint32_t bm     = LoadShared(m_vec2Type, D3D9SharedPSStages_Count * (i - 1) + D3D9SharedPSStages_BumpEnvMat0 + j);
+            uint32_t dot    = m_module.opDot(m_floatType, bm, t);
+
+            uint32_t result = m_module.opFAdd(m_floatType, tc_m_n, dot);
+            coords = m_module.opCompositeInsert(texcoord_t, result, coords, 1, &j);
+          }
+
+          std::array<uint32_t, 3> conds = { isBumpmap, isBumpmap, isBumpmap };
+          uint32_t condVec = m_module.opCompositeConstruct(
+            m_module.defVectorType(boolType, texcoordCnt), texcoordCnt, conds.data());
+
+          texcoord = m_module.opSelect(texcoord_t, condVec, coords, texcoord);
+        }
+
+        SpirvImageOperands imageOperands;
+        uint32_t imageVarId = m_module.opLoad(m_ps.samplers[i].typeId, m_ps.samplers[i].varId);
+        uint32_t texture    = m_module.opImageSampleImplicitLod(m_vec4Type, imageVarId, texcoord, imageOperands);
+
+        if (i != 0) {
+          uint32_t lScale  = LoadShared(m_floatType, D3D9SharedPSStages_Count * (i - 1) + D3D9SharedPSStages_BumpEnvLScale);
+          uint32_t lOffset = LoadShared(m_floatType, D3D9SharedPSStages_Count * (i - 1) + D3D9SharedPSStages_BumpEnvLOffset);
+
+          uint32_t zIndex = 2;
+          uint32_t scale = m_module.opCompositeExtract(m_floatType, texture, 1, &zIndex);
+                   scale = m_module.opFMul(m_floatType, scale, lScale);
+                   scale = m_module.opFAdd(m_floatType, scale, lOffset);
+                   scale = m_module.opFClamp(m_floatType, scale, m_module.constf32(0.0f), m_module.constf32(1.0));
+
+          texture = SelectVec4(IsValue(prevColorOp, D3DTOP_BUMPENVMAPLUMINANCE),
+            m_module.opVectorTimesScalar(m_vec4Type, texture, scale), texture);
+        }
+
+        m_module.opStore(textureVar, texture);
+      }
+
+      m_module.opBranch(sampleEndLabel);
+      m_module.opLabel(sampleEndLabel);
+
+      uint32_t current = m_module.opLoad(m_vec4Type, currentVar);
+      uint32_t temp    = m_module.opLoad(m_vec4Type, tempVar);
+      uint32_t texture = m_module.opLoad(m_vec4Type, textureVar);
+
+      std::array<std::pair<uint32_t, uint32_t>, 7> sources = {{
+        { D3DTA_CONSTANT, LoadShared(m_vec4Type, D3D9SharedPSStages_Count * i + D3D9SharedPSStages_Constant) },
+        { D3DTA_CURRENT,  current },
+        { D3DTA_DIFFUSE,  diffuse },
+        { D3DTA_SPECULAR, specular },
+        { D3DTA_TEMP,     temp },
+        { D3DTA_TEXTURE,  SelectVec4(textureBound, texture, unboundTextureConstId) },
+        { D3DTA_TFACTOR,  m_ps.constants.textureFactor },
+      }};
+
+      auto GetArg = [&] (uint32_t word, uint32_t index) {
+        uint32_t arg    = Extract(word, 8 * (index + 1), 8);
+        uint32_t select = m_module.opBitwiseAnd(m_uint32Type, arg, m_module.constu32(D3DTA_SELECTMASK));
+
+        uint32_t reg = m_module.constvec4f32(1.0f, 1.0f, 1.0f, 1.0f);
+
+        for (const auto& source : sources)
+          reg = SelectVec4(IsValue(select, source.first), source.second, reg);
+
+        // reg = 1 - reg
+        reg = SelectVec4(TestBits(arg, D3DTA_COMPLEMENT), emitComplement(reg), reg);
+
+        // reg = reg.wwww
+        reg = SelectVec4(TestBits(arg, D3DTA_ALPHAREPLICATE), emitAlphaReplicate(reg), reg);
+        return reg;
+      };
+
+      uint32_t resultIsTemp = TestBits(flags, D3D9FFPSStageFlag_ResultIsTemp);
+      uint32_t dst = SelectVec4(resultIsTemp, temp, current);
+
+      auto DoOp = [&](uint32_t op, uint32_t word) {
+        std::array<uint32_t, TextureArgCount> args;
+
+        for (uint32_t j = 0; j < TextureArgCount; j++)
+          args[j] = GetArg(word, j);
+
+        std::array<SpirvSwitchCaseLabel, textureOps.size()> caseLabels;
+
+        for (uint32_t j = 0; j < textureOps.size(); j++)
+          caseLabels[j] = { uint32_t(textureOps[j]), m_module.allocateId() };
+
+        uint32_t opMergeLabel = m_module.allocateId();
+        m_module.opStore(resultVar, dst);
+
+        m_module.opSelectionMerge(opMergeLabel, spv::SelectionControlMaskNone);
+        m_module.opSwitch(op, opMergeLabel, caseLabels.size(), caseLabels.data());
+
+        for (uint32_t j = 0; j < textureOps.size(); j++) {
+          m_module.opLabel(caseLabels[j].labelId);
+          m_module.opStore(resultVar, emitTextureOp(textureOps[j], dst, args,
+            current, diffuse, [texture] { return texture; }));
+          m_module.opBranch(opMergeLabel);
+        }
+
+        m_module.opLabel(opMergeLabel);
+        return m_module.opLoad(m_vec4Type, resultVar);
+      };
+
+      uint32_t colorResult = DoOp(colorOp, colorWord);
+      uint32_t alphaResult = DoOp(alphaOp, alphaWord);
+
+      // src0.x, src0.y, src0.z src1.w
+      std::array<uint32_t, 4> indices = { 0, 1, 2, 4 + 3 };
+      uint32_t result = m_module.opVectorShuffle(m_vec4Type,
+        colorResult, alphaResult, indices.size(), indices.data());
+
+      // D3DTOP_DOTPRODUCT3 also has special quirky behaviour here.
+      result = SelectVec4(IsValue(colorOp, D3DTOP_DOTPRODUCT3), colorResult, result);
+
+      m_module.opStore(tempVar,    SelectVec4(resultIsTemp, result, temp));
+      m_module.opStore(currentVar, SelectVec4(resultIsTemp, current, result));
+
+      prevColorOp = colorOp;
+    }
+
+    for (uint32_t i = caps::TextureStageCount; i > 0; i--) {
+      m_module.opBranch(mergeLabels[i - 1]);
+      m_module.opLabel(mergeLabels[i - 1]);
+    }
+
+    uint32_t current = m_module.opLoad(m_vec4Type, currentVar);
+
+    current = SelectVec4(globalSpecular, m_module.opFAdd(m_vec4Type, current,
+      m_module.opFMul(m_vec4Type, specular, m_module.constvec4f32(1.0f, 1.0f, 1.0f, 0.0f))),
+      current);
+
+    emitPsOutput(current);
+  }
+
+
+  void D3D9FFShaderCompiler::emitPsOutput(uint32_t color) {
     D3D9FogContext fogCtx;
     fogCtx.IsPixel     = true;
     fogCtx.RangeFog    = false;
     fogCtx.RenderState = m_rsBlock;
     fogCtx.vPos        = m_ps.in.POS;
     fogCtx.vFog        = m_ps.in.FOG;
-    fogCtx.oColor      = current;
+    fogCtx.oColor      = color;
     fogCtx.IsFixedFunction = true;
     fogCtx.IsPositionT = false;
     fogCtx.HasSpecular = false;
     fogCtx.Specular    = 0;
     fogCtx.SpecUBO     = m_specUbo;
-    current = DoFixedFunctionFog(m_spec, m_module, fogCtx);
+    color = DoFixedFunctionFog(m_spec, m_module, fogCtx);
 
-    m_module.opStore(m_ps.out.COLOR, current);
+    m_module.opStore(m_ps.out.COLOR, color);
 
     alphaTestPS();
   }
 
+
+  template<typename GetTextureFn>
+  uint32_t D3D9FFShaderCompiler::emitTextureOp(
+          D3DTEXTUREOP                          op,
+          uint32_t                              dst,
+          std::array<uint32_t, TextureArgCount> arg,
+          uint32_t                              current,
+          uint32_t                              diffuse,
+    const GetTextureFn&                         getTexture) {
+    switch (op) {
+      case D3DTOP_SELECTARG1:
+        dst = arg[1];
+        break;
+
+      case D3DTOP_SELECTARG2:
+        dst = arg[2];
+        break;
+
+      case D3DTOP_MODULATE4X:
+        dst = m_module.opFMul(m_vec4Type, arg[1], arg[2]);
+        dst = m_module.opVectorTimesScalar(m_vec4Type, dst, m_module.constf32(4.0f));
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_MODULATE2X:
+        dst = m_module.opFMul(m_vec4Type, arg[1], arg[2]);
+        dst = m_module.opVectorTimesScalar(m_vec4Type, dst, m_module.constf32(2.0f));
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_MODULATE:
+        dst = m_module.opFMul(m_vec4Type, arg[1], arg[2]);
+        break;
+
+      case D3DTOP_ADDSIGNED2X:
+        arg[2] = m_module.opFSub(m_vec4Type, arg[2],
+          m_module.constvec4f32(0.5f, 0.5f, 0.5f, 0.5f));
+
+        dst = m_module.opFAdd(m_vec4Type, arg[1], arg[2]);
+        dst = m_module.opVectorTimesScalar(m_vec4Type, dst, m_module.constf32(2.0f));
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_ADDSIGNED:
+        arg[2] = m_module.opFSub(m_vec4Type, arg[2],
+          m_module.constvec4f32(0.5f, 0.5f, 0.5f, 0.5f));
+
+        dst = m_module.opFAdd(m_vec4Type, arg[1], arg[2]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_ADD:
+        dst = m_module.opFAdd(m_vec4Type, arg[1], arg[2]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_SUBTRACT:
+        dst = m_module.opFSub(m_vec4Type, arg[1], arg[2]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_ADDSMOOTH:
+        dst = m_module.opFFma(m_vec4Type, emitComplement(arg[1]), arg[2], arg[1]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_BLENDDIFFUSEALPHA:
+        dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], emitAlphaReplicate(diffuse));
+        break;
+
+      case D3DTOP_BLENDTEXTUREALPHA:
+        dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], emitAlphaReplicate(getTexture()));
+        break;
+
+      case D3DTOP_BLENDFACTORALPHA:
+        dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], emitAlphaReplicate(m_ps.constants.textureFactor));
+        break;
+
+      case D3DTOP_BLENDTEXTUREALPHAPM:
+        dst = m_module.opFFma(m_vec4Type, arg[2], emitComplement(emitAlphaReplicate(getTexture())), arg[1]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_BLENDCURRENTALPHA:
+        dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], emitAlphaReplicate(current));
+        break;
+
+      case D3DTOP_PREMODULATE:
+        Logger::warn("D3DTOP_PREMODULATE: not implemented");
+        break;
+
+      case D3DTOP_MODULATEALPHA_ADDCOLOR:
+        dst = m_module.opFFma(m_vec4Type, emitAlphaReplicate(arg[1]), arg[2], arg[1]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_MODULATECOLOR_ADDALPHA:
+        dst = m_module.opFFma(m_vec4Type, arg[1], arg[2], emitAlphaReplicate(arg[1]));
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_MODULATEINVALPHA_ADDCOLOR:
+        dst = m_module.opFFma(m_vec4Type, emitComplement(emitAlphaReplicate(arg[1])), arg[2], arg[1]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_MODULATEINVCOLOR_ADDALPHA:
+        dst = m_module.opFFma(m_vec4Type, emitComplement(arg[1]), arg[2], emitAlphaReplicate(arg[1]));
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_BUMPENVMAPLUMINANCE:
+      case D3DTOP_BUMPENVMAP:
+        // Texture is loaded by the caller for the next stage.
+        break;
+
+      case D3DTOP_DOTPRODUCT3: {
+        // Get vec3 of arg1 & 2
+        uint32_t vec3Type = m_module.defVectorType(m_floatType, 3);
+        std::array<uint32_t, 3> indices = { 0, 1, 2 };
+        arg[1] = m_module.opVectorShuffle(vec3Type, arg[1], arg[1], indices.size(), indices.data());
+        arg[2] = m_module.opVectorShuffle(vec3Type, arg[2], arg[2], indices.size(), indices.data());
+
+        // Bias according to spec.
+        arg[1] = m_module.opFSub(vec3Type, arg[1], m_module.constvec3f32(0.5f, 0.5f, 0.5f));
+        arg[2] = m_module.opFSub(vec3Type, arg[2], m_module.constvec3f32(0.5f, 0.5f, 0.5f));
+
+        // Do the dotting!
+        dst = m_module.opDot(m_floatType, arg[1], arg[2]);
+
+        // Multiply by 4 and replicate -> vec4
+        dst = m_module.opFMul(m_floatType, dst, m_module.constf32(4.0f));
+        dst = emitScalarReplicate(dst);
+
+        // Saturate
+        dst = emitSaturate(dst);
+
+        break;
+      }
+
+      case D3DTOP_MULTIPLYADD:
+        dst = m_module.opFFma(m_vec4Type, arg[1], arg[2], arg[0]);
+        dst = emitSaturate(dst);
+        break;
+
+      case D3DTOP_LERP:
+        dst = m_module.opFMix(m_vec4Type, arg[2], arg[1], arg[0]);
+        break;
+
+      default:
+        Logger::warn("Unhandled texture op!");
+        break;
+    }
+
+    return dst;
+  }
+
+
+  uint32_t D3D9FFShaderCompiler::emitScalarReplicate(uint32_t reg) {
+    std::array<uint32_t, 4> replicant = { reg, reg, reg, reg };
+    return m_module.opCompositeConstruct(m_vec4Type, replicant.size(), replicant.data());
+  }
+
+
+  uint32_t D3D9FFShaderCompiler::emitAlphaReplicate(uint32_t reg) {
+    uint32_t alphaComponentId = 3;
+    uint32_t alpha = m_module.opCompositeExtract(m_floatType, reg, 1, &alphaComponentId);
+
+    return emitScalarReplicate(alpha);
+  }
+
+
+  uint32_t D3D9FFShaderCompiler::emitComplement(uint32_t reg) {
+    return m_module.opFSub(m_vec4Type,
+      m_module.constvec4f32(1.0f, 1.0f, 1.0f, 1.0f),
+      reg);
+  }
+
+
+  uint32_t D3D9FFShaderCompiler::emitSaturate(uint32_t reg) {
+    return m_module.opFClamp(m_vec4Type, reg,
+      m_module.constvec4f32(0.0f, 0.0f, 0.0f, 0.0f),
+      m_module.constvec4f32(1.0f, 1.0f, 1.0f, 1.0f));
+  }
+
+
   void D3D9FFShaderCompiler::setupPS() {
     setupRenderStateInfo();
     m_specUbo = SetupSpecUBO(m_module, m_bindings);
@@ -2194,9 +2544,15 @@ namespace dxvk {
 
     m_ps.out.COLOR   = declareIO(false, DxsoSemantic{ DxsoUsage::Color, 0 });
 
-    // Constant Buffer for PS.
+    // Constant Buffer for PS. Stage state is only used by the ubershader.
+    uint32_t stageArrayType = m_module.defArrayTypeUnique(
+      m_module.defVectorType(m_uint32Type, 4),
+      m_module.constu32(caps::TextureStageCount));
+    m_module.decorateArrayStride(stageArrayType, sizeof(D3D9FixedFunctionPSStage));
+
     std::array<uint32_t, uint32_t(D3D9FFPSMembers::MemberCount)> members = {
-      m_vec4Type // Texture Factor
+      m_vec4Type, // Texture Factor
+      stageArrayType,
     };
 
     const uint32_t structType =
@@ -2212,6 +2568,7 @@ namespace dxvk {
 
     m_module.setDebugName(structType, "D3D9FixedFunctionPS");
     m_module.setDebugMemberName(structType, 0, "textureFactor");
+    m_module.setDebugMemberName(structType, 1, "stages");
 
     m_ps.constantBuffer = m_module.newVar(
       m_module.defPointerType(structType, spv::StorageClassUniform),
@@ -2471,16 +2828,27 @@ namespace dxvk {
 
   D3D9FFShader::D3D9FFShader(
           D3D9DeviceEx*         pDevice,
-    const D3D9FFShaderKeyFS&    Key) {
-    Sha1Hash hash = Sha1Hash::compute(&Key, sizeof(Key));
+    const D3D9FFShaderKeyFS&    Key,
+          bool                  Ubershader) {
+    // Make sure the ubershader never aliases a specialized
+    // shader that happens to use the same key
+    const char uberTag[] = "UBER";
+
+    std::array<Sha1Data, 2> chunks = {{
+      { &Key,    sizeof(Key) },
+      { uberTag, Ubershader ? sizeof(uberTag) : 0 },
+    }};
+
+    Sha1Hash hash = Sha1Hash::compute(chunks.size(), chunks.data());
     DxvkShaderKey shaderKey = { VK_SHADER_STAGE_FRAGMENT_BIT, hash };
 
-    std::string name = str::format("FF_", shaderKey.toString());
+    std::string name = str::format(Ubershader ? "FF_UBER_" : "FF_", shaderKey.toString());
 
     D3D9FFShaderCompiler compiler(
       pDevice->GetDXVKDevice(),
       Key, name,
-      pDevice->GetOptions());
+      pDevice->GetOptions(),
+      Ubershader);
 
     m_shader = compiler.compile();
     m_isgn   = compiler.isgn();
@@ -2509,16 +2877,11 @@ namespace dxvk {
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyVS&    ShaderKey) {
     // Use the shader's unique key for the lookup
-    auto entry = m_vsModules.find(ShaderKey);
-    if (entry != m_vsModules.end())
-      return entry->second;
-    
-    D3D9FFShader shader(
-      pDevice, ShaderKey);
+    D3D9FFShader* entry = m_vsModules.find(ShaderKey);
+    if (entry)
+      return *entry;
 
-    m_vsModules.insert({ShaderKey, shader});
-
-    return shader;
+    return m_vsModules.emplace(ShaderKey, pDevice, ShaderKey);
   }
 
 
@@ -2526,42 +2889,82 @@ namespace dxvk {
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyFS&    ShaderKey) {
     // Use the shader's unique key for the lookup
-    auto entry = m_fsModules.find(ShaderKey);
-    if (entry != m_fsModules.end())
-      return entry->second;
-    
-    D3D9FFShader shader(
-      pDevice, ShaderKey);
+    D3D9FFShader* entry = m_fsModules.find(ShaderKey);
+    if (entry)
+      return *entry;
 
-    m_fsModules.insert({ShaderKey, shader});
-
-    return shader;
+    return m_fsModules.emplace(ShaderKey, pDevice, ShaderKey);
   }
 
 
-  size_t D3D9FFShaderKeyHash::operator () (const D3D9FFShaderKeyVS& key) const {
-    DxvkHashState state;
+  Rc<DxvkShader> D3D9FFShaderModuleSet::GetPixelShader(
+          D3D9DeviceEx*         pDevice,
+    const D3D9FFShaderKeyFS&    ShaderKey) {
+    D3D9FFShader* entry = m_fsModules.find(ShaderKey);
 
-    std::hash<uint32_t> uint32hash;
+    if (entry && entry->GetShader()->isLibraryReady()) {
+      m_fsPending.store(false);
+      return entry->GetShader();
+    }
 
-    for (uint32_t i = 0; i < std::size(key.Data.Primitive); i++)
-      state.add(uint32hash(key.Data.Primitive[i]));
+    // Creating the shader queues up the pipeline library,
+    // make sure it gets compiled before any other work.
+    Rc<DxvkShader> shader = GetShaderModule(pDevice, ShaderKey).GetShader();
+    pDevice->GetDXVKDevice()->requestCompileShader(shader);
 
-    return state;
-  }
+    // The ubershader only depends on texture types,
+    // since these determine the sampler declarations.
+    D3D9FFShaderKeyFS uberKey;
+    uint32_t uberIndex = 0;
 
+    for (uint32_t i = 0; i < caps::TextureStageCount; i++) {
+      uberKey.Stages[i].Contents.Type = ShaderKey.Stages[i].Contents.Type;
+      uberIndex |= ShaderKey.Stages[i].Contents.Type << (2 * i);
+    }
 
-  size_t D3D9FFShaderKeyHash::operator () (const D3D9FFShaderKeyFS& key) const {
-    DxvkHashState state;
+    D3D9FFShader* uber = m_fsUberModules.find(uberIndex);
 
-    std::hash<uint32_t> uint32hash;
+    if (!uber) {
+      uber = &m_fsUberModules.emplace(uberIndex, pDevice, uberKey, true);
+      pDevice->GetDXVKDevice()->requestCompileShader(uber->GetShader());
+    }
 
-    for (uint32_t i = 0; i < caps::TextureStageCount; i++) {
-      for (uint32_t j = 0; j < std::size(key.Stages[i].Primitive); j++)
-        state.add(uint32hash(key.Stages[i].Primitive[j]));
+    // If the ubershader itself is not ready yet, there
+    // is no benefit over using the specialized shader.
+    Rc<DxvkShader> uberShader = uber->GetShader();
+
+    if (!uberShader->isLibraryReady()) {
+      m_fsPending.store(false);
+      return shader;
     }
 
-    return state;
+    m_fsPendingKey = ShaderKey;
+    m_fsPending.store(true);
+    return uberShader;
+  }
+
+
+  Rc<DxvkShader> D3D9FFShaderModuleSet::GetPendingPixelShader() {
+    if (!m_fsPending.load())
+      return nullptr;
+
+    D3D9FFShader* entry = m_fsModules.find(m_fsPendingKey);
+
+    if (!entry || !entry->GetShader()->isLibraryReady())
+      return nullptr;
+
+    m_fsPending.store(false);
+    return entry->GetShader();
+  }
+
+
+  size_t D3D9FFShaderKeyHash::operator () (const D3D9FFShaderKeyVS& key) const {
+    return size_t(bit::bhash(&key));
+  }
+
+
+  size_t D3D9FFShaderKeyHash::operator () (const D3D9FFShaderKeyFS& key) const {
+    return size_t(bit::bhash(&key));
   }
 
 
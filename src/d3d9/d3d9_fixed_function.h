@@ -8,7 +8,8 @@
 
 #include "../dxso/dxso_isgn.h"
 
-#include <unordered_map>
+#include "../util/util_flat_map.h"
+
 #include <bitset>
 
 namespace dxvk {
@@ -215,7 +216,8 @@ namespace dxvk {
 
     D3D9FFShader(
             D3D9DeviceEx*         pDevice,
-      const D3D9FFShaderKeyFS&    Key);
+      const D3D9FFShaderKeyFS&    Key,
+            bool                  Ubershader = false);
 
     template <typename T>
     void Dump(D3D9DeviceEx* pDevice, const T& Key, const std::string& Name);
@@ -245,18 +247,60 @@ namespace dxvk {
             D3D9DeviceEx*         pDevice,
       const D3D9FFShaderKeyFS&    ShaderKey);
 
+    /**
+     * \brief Retrieves pixel shader to bind
+     *
+     * Returns the specialized shader if its pipeline library
+     * is ready. Otherwise, this schedules the specialized shader
+     * for compilation and returns an ubershader that reads the
+     * texture stage state from the constant buffer, so that
+     * draws do not stall on shader compilation. The specialized
+     * shader can be retrieved via \ref GetPendingPixelShader.
+     * \param [in] pDevice The device
+     * \param [in] ShaderKey Specialized shader key
+     * \returns Shader to bind
+     */
+    Rc<DxvkShader> GetPixelShader(
+            D3D9DeviceEx*         pDevice,
+      const D3D9FFShaderKeyFS&    ShaderKey);
+
+    /**
+     * \brief Retrieves pending specialized pixel shader
+     *
+     * \returns The specialized shader for the last key passed
+     *    to \ref GetPixelShader if it has become ready since,
+     *    or \c nullptr if the ubershader must remain bound.
+     */
+    Rc<DxvkShader> GetPendingPixelShader();
+
+    /**
+     * \brief Checks whether a specialized pixel shader is pending
+     *
+     * Safe to call from any thread.
+     * \returns \c true if the ubershader is currently in use
+     */
+    bool HasPendingPixelShader() const {
+      return m_fsPending.load();
+    }
+
   private:
 
-    std::unordered_map<
+    flat_hash_map<
       D3D9FFShaderKeyVS,
       D3D9FFShader,
       D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_vsModules;
 
-    std::unordered_map<
+    flat_hash_map<
       D3D9FFShaderKeyFS,
       D3D9FFShader,
       D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_fsModules;
 
+    flat_hash_map<
+      uint32_t, D3D9FFShader> m_fsUberModules;
+
+    D3D9FFShaderKeyFS m_fsPendingKey;
+    std::atomic<bool> m_fsPending = { false };
+
   };
 
 
@@ -7,6 +7,14 @@
 
 namespace dxvk {
 
+  /**
+   * \brief Format conversion helper
+   *
+   * Converts video and packed formats with compute shaders
+   * recorded into a separate context. Must only be used from
+   * the CS thread, so that conversions are ordered with the
+   * rest of the device's commands.
+   */
   class D3D9FormatHelper {
 
   public:
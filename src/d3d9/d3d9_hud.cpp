@@ -51,8 +51,11 @@ namespace dxvk::hud {
     if (elapsed.count() < UpdateInterval)
       return;
 
+    uint64_t mapCount = allocator->MapCount();
+
     m_allocatedString = str::format(m_maxAllocated >> 20, " MB (Used: ", m_maxUsed >> 20, " MB)");
-    m_mappedString = str::format(m_maxMapped >> 20, " MB");
+    m_mappedString = str::format(m_maxMapped >> 20, " MB (Maps: ", mapCount - m_lastMapCount, ")");
+    m_lastMapCount = mapCount;
     m_maxAllocated = 0;
     m_maxUsed = 0;
     m_maxMapped = 0;
@@ -51,6 +51,7 @@ namespace dxvk::hud {
         uint32_t m_maxAllocated = 0;
         uint32_t m_maxUsed      = 0;
         uint32_t m_maxMapped    = 0;
+        uint64_t m_lastMapCount = 0;
 
         dxvk::high_resolution_clock::time_point m_lastUpdate
           = dxvk::high_resolution_clock::now();
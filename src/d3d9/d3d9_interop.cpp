@@ -200,7 +200,7 @@ namespace dxvk {
 
   void STDMETHODCALLTYPE D3D9VkInteropDevice::FlushRenderingCommands() {
     m_device->Flush();
-    m_device->SynchronizeCsThread(DxvkCsThread::SynchronizeAll);
+    m_device->SynchronizeCsThread(DxvkCsThread::SynchronizeAll, DxvkCsSyncReason::Interop);
   }
 
   void STDMETHODCALLTYPE D3D9VkInteropDevice::LockSubmissionQueue() {
@@ -236,7 +236,7 @@ namespace dxvk {
   bool STDMETHODCALLTYPE D3D9VkInteropDevice::WaitForResource(
           IDirect3DResource9*  pResource,
           DWORD                MapFlags) {
-    return m_device->WaitForResource(GetDxvkResource(pResource), DxvkCsThread::SynchronizeAll, MapFlags);
+    return m_device->WaitForResource(GetDxvkResource(pResource), DxvkCsThread::SynchronizeAll, MapFlags, DxvkCsSyncReason::Interop);
   }
 
 }
@@ -56,6 +56,7 @@ namespace dxvk {
 
   void D3D9MemoryAllocator::NotifyMapped(uint32_t Size) {
     m_mappedMemory += Size;
+    m_mapCount += 1;
   }
 
   void D3D9MemoryAllocator::NotifyUnmapped(uint32_t Size) {
@@ -78,6 +79,10 @@ namespace dxvk {
     return m_allocatedMemory.load();
   }
 
+  uint64_t D3D9MemoryAllocator::MapCount() {
+    return m_mapCount.load();
+  }
+
   D3D9MemoryChunk::D3D9MemoryChunk(D3D9MemoryAllocator* Allocator, uint32_t Size)
     : m_allocator(Allocator), m_size(Size), m_mappingGranularity(m_allocator->MemoryGranularity() * 16) {
     m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE | SEC_COMMIT, 0, Size, nullptr);
@@ -104,13 +109,13 @@ namespace dxvk {
       alignmentDelta = memory->GetOffset() - alignedOffset;
       alignedSize = memory->GetSize() + alignmentDelta;
 
-      m_allocator->NotifyMapped(alignedSize);
       uint8_t* basePtr = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, alignedOffset, alignedSize));
       if (unlikely(basePtr == nullptr)) {
         DWORD error = GetLastError();
         Logger::err(str::format("Mapping non-persisted file failed: ", error, ", Mapped memory: ", m_allocator->MappedMemory()));
         return nullptr;
       }
+      m_allocator->NotifyMapped(alignedSize);
       return basePtr + alignmentDelta;
     }
 
@@ -118,7 +123,6 @@ namespace dxvk {
     // This should hopefully also reduce the amount of MapViewOfFile calls we do for tiny allocations.
     auto& mappingRange = m_mappingRanges[memory->GetOffset() /  m_mappingGranularity];
     if (unlikely(mappingRange.refCount == 0)) {
-      m_allocator->NotifyMapped(m_mappingGranularity);
       mappingRange.ptr = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, alignedOffset, m_mappingGranularity));
       if (unlikely(mappingRange.ptr == nullptr)) {
         DWORD error = GetLastError();
@@ -128,7 +132,11 @@ namespace dxvk {
         if (buffer) {
           LocalFree(buffer);
         }
+        // Don't take a reference to the failed mapping so that
+        // the caller can free up address space and try again
+        return nullptr;
       }
+      m_allocator->NotifyMapped(m_mappingGranularity);
     }
     mappingRange.refCount++;
     uint8_t* basePtr = static_cast<uint8_t*>(mappingRange.ptr);
@@ -309,6 +317,10 @@ namespace dxvk {
     return m_allocatedMemory.load();
   }
 
+  uint64_t D3D9MemoryAllocator::MapCount() {
+    return 0;
+  }
+
   D3D9Memory::D3D9Memory(D3D9MemoryAllocator* pAllocator, size_t Size)
     : m_allocator (pAllocator),
       m_ptr       (malloc(Size)),
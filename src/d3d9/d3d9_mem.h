@@ -114,6 +114,7 @@ namespace dxvk {
       uint32_t MappedMemory();
       uint32_t UsedMemory();
       uint32_t AllocatedMemory();
+      uint64_t MapCount();
       uint32_t MemoryGranularity() { return m_allocationGranularity; }
 
     private:
@@ -122,6 +123,7 @@ namespace dxvk {
       std::atomic<size_t> m_mappedMemory = 0;
       std::atomic<size_t> m_allocatedMemory = 0;
       std::atomic<size_t> m_usedMemory = 0;
+      std::atomic<uint64_t> m_mapCount = 0;
       uint32_t m_allocationGranularity;
   };
 
@@ -162,6 +164,7 @@ namespace dxvk {
       uint32_t MappedMemory();
       uint32_t UsedMemory();
       uint32_t AllocatedMemory();
+      uint64_t MapCount();
       void NotifyFreed(uint32_t Size) {
         m_allocatedMemory -= Size;
       }
@@ -74,6 +74,7 @@ namespace dxvk {
     this->seamlessCubes                 = config.getOption<bool>        ("d3d9.seamlessCubes",                 false);
     this->textureMemory                 = config.getOption<int32_t>     ("d3d9.textureMemory",                100) << 20;
     this->deviceLost                    = config.getOption<bool>        ("d3d9.deviceLost",                    false);
+    this->ffUbershader                  = config.getOption<bool>        ("d3d9.ffUbershader",                  false);
 
     std::string floatEmulation = Config::toLower(config.getOption<std::string>("d3d9.floatEmulation", "auto"));
     if (floatEmulation == "strict") {
@@ -151,6 +151,10 @@ namespace dxvk {
 
     /// Enable emulation of device loss when a fullscreen app loses focus
     bool deviceLost;
+
+    /// Use a fixed-function pixel ubershader while specialized
+    /// shaders are compiling. Requires graphics pipeline libraries.
+    bool ffUbershader;
   };
 
 }
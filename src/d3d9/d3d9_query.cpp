@@ -158,9 +158,14 @@ namespace dxvk {
 
     // If we get S_FALSE and it's not from the fact
     // they didn't call end, do some flushy stuff...
+    // Skip the flush if the commands that end the query
+    // were already submitted, since that would not make
+    // results available any sooner.
     if (flush && hr == S_FALSE && m_state != D3D9_VK_QUERY_BEGUN) {
       this->NotifyStall();
-      m_parent->FlushImplicit(FALSE);
+
+      if (!m_parent->IsSequenceNumberFlushed(m_endSeqNum))
+        m_parent->FlushImplicit(FALSE);
     }
 
     return hr;
@@ -85,6 +85,62 @@ namespace dxvk {
   }
 
 
+  D3D9CommonShader D3D9CommonShader::CreateCopy(
+          D3D9DeviceEx*         pDevice) const {
+    D3D9CommonShader result = *this;
+    result.m_shader = DxvkShaderCache::cloneShader(m_shader);
+
+    if (result.m_shader == nullptr)
+      throw DxvkError("D3D9CommonShader: Failed to copy shader");
+
+    if (pDevice)
+      pDevice->GetDXVKDevice()->registerShader(result.m_shader);
+
+    return result;
+  }
+
+
+  Sha1Hash D3D9CommonShader::ComputeCompileHash(
+          D3D9DeviceEx*         pDevice,
+          VkShaderStageFlagBits ShaderStage,
+    const DxsoModuleInfo*       pDxsoModuleInfo) {
+    const DxsoOptions& options = pDxsoModuleInfo->options;
+
+    const D3D9ConstantLayout& constantLayout = ShaderStage == VK_SHADER_STAGE_VERTEX_BIT
+      ? pDevice->GetVertexConstantLayout()
+      : pDevice->GetPixelConstantLayout();
+
+    // Pack everything into a flat array so that
+    // padding bytes do not end up in the hash.
+    std::array<uint64_t, 14> data = {{
+      options.strictConstantCopies,
+      uint64_t(options.d3d9FloatEmulation),
+      options.strictPow,
+      options.shaderModel,
+      options.invariantPosition,
+      options.forceSamplerTypeSpecConstants,
+      options.forceSampleRateShading,
+      options.longMad,
+      options.robustness2Supported,
+      constantLayout.floatCount,
+      constantLayout.intCount,
+      constantLayout.boolCount,
+      constantLayout.bitmaskCount,
+      constantLayout.floatAsSsbo,
+    }};
+
+    return Sha1Hash::compute(data);
+  }
+
+
+  dxvk::mutex D3D9ShaderModuleSet::s_translationMutex;
+
+  std::unordered_map<
+    D3D9ShaderModuleSet::TranslationKey,
+    D3D9CommonShader,
+    DxvkHash, DxvkEq> D3D9ShaderModuleSet::s_translations;
+
+
   void D3D9ShaderModuleSet::GetShaderModule(
             D3D9DeviceEx*         pDevice,
             D3D9CommonShader*     pShaderModule,
@@ -119,13 +175,24 @@ namespace dxvk {
         return;
       }
     }
-    
-    // This shader has not been compiled yet, so we have to create a
-    // new module. This takes a while, so we won't lock the structure.
-    *pShaderModule = D3D9CommonShader(
-      pDevice, ShaderStage, lookupKey,
-      pDxbcModuleInfo, pShaderBytecode,
-      info, &module);
+
+    // If another device has translated the same shader with
+    // the same options before, copy that instead of compiling
+    // the shader again. Otherwise, create a new module. This
+    // takes a while, so we won't lock the structure.
+    TranslationKey translationKey;
+    translationKey.shaderKey   = lookupKey;
+    translationKey.compileHash = D3D9CommonShader::ComputeCompileHash(
+      pDevice, ShaderStage, pDxbcModuleInfo);
+
+    if (!FindTranslation(pDevice, translationKey, pShaderModule)) {
+      *pShaderModule = D3D9CommonShader(
+        pDevice, ShaderStage, lookupKey,
+        pDxbcModuleInfo, pShaderBytecode,
+        info, &module);
+
+      AddTranslation(translationKey, *pShaderModule);
+    }
     
     // Insert the new module into the lookup table. If another thread
     // has compiled the same shader in the meantime, we should return
@@ -140,4 +207,36 @@ namespace dxvk {
     }
   }
 
+
+  bool D3D9ShaderModuleSet::FindTranslation(
+          D3D9DeviceEx*         pDevice,
+    const TranslationKey&       Key,
+          D3D9CommonShader*     pShaderModule) {
+    D3D9CommonShader prototype;
+
+    { std::lock_guard<dxvk::mutex> lock(s_translationMutex);
+
+      auto entry = s_translations.find(Key);
+      if (entry == s_translations.end())
+        return false;
+
+      prototype = entry->second;
+    }
+
+    *pShaderModule = prototype.CreateCopy(pDevice);
+    return true;
+  }
+
+
+  void D3D9ShaderModuleSet::AddTranslation(
+    const TranslationKey&       Key,
+    const D3D9CommonShader&     ShaderModule) {
+    // Store a copy that is not registered with any device,
+    // so that no per-device state is kept alive.
+    D3D9CommonShader prototype = ShaderModule.CreateCopy(nullptr);
+
+    std::lock_guard<dxvk::mutex> lock(s_translationMutex);
+    s_translations.insert({ Key, std::move(prototype) });
+  }
+
 }
@@ -54,6 +54,34 @@ namespace dxvk {
 
     uint32_t GetMaxDefinedConstant() const { return m_maxDefinedConst; }
 
+    /**
+     * \brief Creates a copy for another device
+     *
+     * Copies all shader metadata and creates a new
+     * shader object, which is registered with the
+     * given device if one is specified.
+     * \param [in] pDevice Device to use the copy with
+     * \returns Shader copy
+     */
+    D3D9CommonShader CreateCopy(
+            D3D9DeviceEx*         pDevice) const;
+
+    /**
+     * \brief Computes hash of translation parameters
+     *
+     * Covers all compiler options and the constant
+     * layout, i.e. everything other than the bytecode
+     * that affects the generated shader.
+     * \param [in] pDevice Device to query the constant layout from
+     * \param [in] ShaderStage Shader stage
+     * \param [in] pDxsoModuleInfo Module info
+     * \returns Compile hash
+     */
+    static Sha1Hash ComputeCompileHash(
+            D3D9DeviceEx*         pDevice,
+            VkShaderStageFlagBits ShaderStage,
+      const DxsoModuleInfo*       pDxsoModuleInfo);
+
   private:
 
     DxsoIsgn              m_isgn;
@@ -185,6 +213,13 @@ namespace dxvk {
    * and reuse them rather than creating new ones. This
    * class is thread-safe.
    */
+  /**
+   * \brief Shader module set
+   *
+   * Caches translated shaders per device. Translation results
+   * are also kept in a process-wide table, so that devices that
+   * are created later with the same options can reuse them.
+   */
   class D3D9ShaderModuleSet : public RcObject {
     
   public:
@@ -205,6 +240,39 @@ namespace dxvk {
       DxvkShaderKey,
       D3D9CommonShader,
       DxvkHash, DxvkEq> m_modules;
+
+    struct TranslationKey {
+      DxvkShaderKey shaderKey;
+      Sha1Hash      compileHash;
+
+      bool eq(const TranslationKey& other) const {
+        return shaderKey.eq(other.shaderKey)
+            && compileHash == other.compileHash;
+      }
+
+      size_t hash() const {
+        DxvkHashState state;
+        state.add(shaderKey.hash());
+        state.add(compileHash.dword(0));
+        return state;
+      }
+    };
+
+    static dxvk::mutex s_translationMutex;
+
+    static std::unordered_map<
+      TranslationKey,
+      D3D9CommonShader,
+      DxvkHash, DxvkEq> s_translations;
+
+    bool FindTranslation(
+            D3D9DeviceEx*         pDevice,
+      const TranslationKey&       Key,
+            D3D9CommonShader*     pShaderModule);
+
+    void AddTranslation(
+      const TranslationKey&       Key,
+      const D3D9CommonShader&     ShaderModule);
     
   };
 
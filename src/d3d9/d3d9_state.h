@@ -137,8 +137,26 @@ namespace dxvk {
   };
 
 
+  struct D3D9FixedFunctionPSStage {
+    uint32_t ColorOp;   // Op | Arg0 << 8 | Arg1 << 16 | Arg2 << 24
+    uint32_t AlphaOp;   // Op | Arg0 << 8 | Arg1 << 16 | Arg2 << 24
+    uint32_t Flags;     // See D3D9FFPSStageFlags
+    uint32_t Padding;
+  };
+
+  enum D3D9FFPSStageFlags : uint32_t {
+    D3D9FFPSStageFlag_ResultIsTemp          = 1u << 0,
+    D3D9FFPSStageFlag_Projected             = 1u << 1,
+    D3D9FFPSStageFlag_TextureBound          = 1u << 2,
+    D3D9FFPSStageFlag_GlobalSpecularEnable  = 1u << 3,
+    D3D9FFPSStageFlag_ProjectedCountShift   = 4,
+  };
+
   struct D3D9FixedFunctionPS {
     Vector4 textureFactor;
+
+    // Only read by the fixed-function ubershader
+    D3D9FixedFunctionPSStage Stages[caps::TextureStageCount];
   };
 
   enum D3D9SharedPSStages {
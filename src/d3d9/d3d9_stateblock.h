@@ -260,21 +260,13 @@ namespace dxvk {
       }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::VsConstants)) {
-        for (uint32_t i = 0; i < m_captures.vsConsts.fConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.vsConsts.fConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetVertexShaderConstantF(idx, (float*)&src->vsConsts->fConsts[idx], 1);
-          }
-        }
+        ForEachCapturedRange(m_captures.vsConsts.fConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetVertexShaderConstantF(idx, (float*)&src->vsConsts->fConsts[idx], count);
+        });
 
-        for (uint32_t i = 0; i < m_captures.vsConsts.iConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.vsConsts.iConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetVertexShaderConstantI(idx, (int*)&src->vsConsts->iConsts[idx], 1);
-          }
-        }
+        ForEachCapturedRange(m_captures.vsConsts.iConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetVertexShaderConstantI(idx, (int*)&src->vsConsts->iConsts[idx], count);
+        });
 
         if (m_captures.vsConsts.bConsts.any()) {
           for (uint32_t i = 0; i < m_captures.vsConsts.bConsts.dwordCount(); i++)
@@ -283,21 +275,13 @@ namespace dxvk {
       }
 
       if (m_captures.flags.test(D3D9CapturedStateFlag::PsConstants)) {
-        for (uint32_t i = 0; i < m_captures.psConsts.fConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.psConsts.fConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
-
-            dst->SetPixelShaderConstantF(idx, (float*)&src->psConsts->fConsts[idx], 1);
-          }
-        }
-
-        for (uint32_t i = 0; i < m_captures.psConsts.iConsts.dwordCount(); i++) {
-          for (uint32_t consts : bit::BitMask(m_captures.psConsts.iConsts.dword(i))) {
-            uint32_t idx = i * 32 + consts;
+        ForEachCapturedRange(m_captures.psConsts.fConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetPixelShaderConstantF(idx, (float*)&src->psConsts->fConsts[idx], count);
+        });
 
-            dst->SetPixelShaderConstantI(idx, (int*)&src->psConsts->iConsts[idx], 1);
-          }
-        }
+        ForEachCapturedRange(m_captures.psConsts.iConsts, [&] (uint32_t idx, uint32_t count) {
+          dst->SetPixelShaderConstantI(idx, (int*)&src->psConsts->iConsts[idx], count);
+        });
 
         if (m_captures.psConsts.bConsts.any()) {
           for (uint32_t i = 0; i < m_captures.psConsts.bConsts.dwordCount(); i++)
@@ -381,6 +365,40 @@ namespace dxvk {
 
   private:
 
+    /**
+     * \brief Iterates over ranges of captured registers
+     *
+     * Merges adjacent set bits into a single range so that
+     * constants can be applied with one call per range rather
+     * than one call per register.
+     * \param [in] captures Captured register mask
+     * \param [in] fn Callback taking the first register and count
+     */
+    template <size_t Bits, typename Fn>
+    static void ForEachCapturedRange(const bit::bitset<Bits>& captures, Fn&& fn) {
+      uint32_t start = 0;
+      uint32_t count = 0;
+
+      for (uint32_t i = 0; i < captures.dwordCount(); i++) {
+        for (uint32_t reg : bit::BitMask(captures.dword(i))) {
+          uint32_t idx = i * 32 + reg;
+
+          if (count && start + count == idx) {
+            count += 1;
+          } else {
+            if (count)
+              fn(start, count);
+
+            start = idx;
+            count = 1;
+          }
+        }
+      }
+
+      if (count)
+        fn(start, count);
+    }
+
     void CapturePixelRenderStates();
     void CapturePixelSamplerStates();
     void CapturePixelShaderStates();
@@ -196,4 +196,20 @@ namespace dxvk {
     m_container = nullptr;
   }
 
+
+  bool D3D9Surface::CanReuse(const D3D9_COMMON_TEXTURE_DESC* pDesc) {
+    if (this->GetRefCount() || m_dcDesc.hDC != nullptr
+     || m_texture->IsAnySubresourceLocked())
+      return false;
+
+    const auto* desc = m_texture->Desc();
+
+    return desc->Width              == pDesc->Width
+        && desc->Height             == pDesc->Height
+        && desc->Format             == pDesc->Format
+        && desc->Usage              == pDesc->Usage
+        && desc->MultiSample        == pDesc->MultiSample
+        && desc->MultisampleQuality == pDesc->MultisampleQuality;
+  }
+
 }
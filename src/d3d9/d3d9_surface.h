@@ -59,6 +59,18 @@ namespace dxvk {
 
     void ClearContainer();
 
+    /**
+     * \brief Checks whether the surface can be reused
+     *
+     * Used on device reset in order to keep swap chain and
+     * depth buffers whose properties did not change. This
+     * is only possible if the application does not hold
+     * any references to the surface and it is not mapped.
+     * \param [in] pDesc Desired surface properties
+     * \returns \c true if the surface can be reused
+     */
+    bool CanReuse(const D3D9_COMMON_TEXTURE_DESC* pDesc);
+
   private:
 
     D3D9GDIDesc m_dcDesc;
@@ -29,6 +29,7 @@ namespace dxvk {
     , m_context          (m_device->createContext(DxvkContextType::Supplementary))
     , m_frameLatencyCap  (pDevice->GetOptions()->maxFrameLatency)
     , m_frameLatencySignal(new sync::Fence(m_frameId))
+    , m_latencyTracker   (m_device->config().latencySleep ? new DxvkLatencyTracker(m_frameId) : nullptr)
     , m_dialog           (pDevice->GetOptions()->enableDialogMode) {
     this->NormalizePresentParameters(pPresentParams);
     m_presentParams = *pPresentParams;
@@ -744,6 +745,12 @@ namespace dxvk {
     // Bump our frame id.
     ++m_frameId;
 
+    if (m_latencyTracker != nullptr)
+      m_latencyTracker->notifyCpuPresent(m_frameId);
+
+    if (m_device->config().enableRefreshRatePacing)
+      UpdateDisplayMonitor();
+
     for (uint32_t i = 0; i < SyncInterval || i < 1; i++) {
       SynchronizePresent();
 
@@ -780,14 +787,21 @@ namespace dxvk {
       if (m_hud != nullptr)
         m_hud->render(m_context, info.format, info.imageExtent);
 
-      if (i + 1 >= SyncInterval)
+      if (i + 1 >= SyncInterval) {
         m_context->signal(m_frameLatencySignal, m_frameId);
 
+        if (m_latencyTracker != nullptr)
+          m_context->signal(m_latencyTracker, m_frameId);
+      }
+
       SubmitPresent(sync, i);
     }
 
     SyncFrameLatency();
 
+    if (m_latencyTracker != nullptr)
+      m_latencyTracker->sleepAndBeginFrame(m_frameId);
+
     // Rotate swap chain buffers so that the back
     // buffer at index 0 becomes the front buffer.
     for (uint32_t i = 1; i < m_backBuffers.size(); i++)
@@ -814,7 +828,7 @@ namespace dxvk {
       if (cHud != nullptr && !cFrameId)
         cHud->update();
 
-      m_device->presentImage(m_presenter, &m_presentStatus);
+      m_device->presentImage(m_presenter, nullptr, 0, &m_presentStatus);
     });
 
     m_parent->FlushCsChunk();
@@ -830,9 +844,13 @@ namespace dxvk {
   }
 
   void D3D9SwapChainEx::RecreateSwapChain(BOOL Vsync) {
-    // Ensure that we can safely destroy the swap chain
+    // Ensure that we can safely destroy the swap chain. Only
+    // wait for the commands that use the swap chain images,
+    // rather than for the entire device to go idle.
     m_device->waitForSubmission(&m_presentStatus);
-    m_device->waitForIdle();
+
+    for (const auto& view : m_imageViews)
+      m_device->waitForResource(view->image(), DxvkAccess::Read);
 
     m_presentStatus.result = VK_SUCCESS;
 
@@ -842,6 +860,7 @@ namespace dxvk {
     presenterDesc.numFormats      = PickFormats(EnumerateFormat(m_presentParams.BackBufferFormat), presenterDesc.formats);
     presenterDesc.numPresentModes = PickPresentModes(Vsync, presenterDesc.presentModes);
     presenterDesc.fullScreenExclusive = PickFullscreenMode();
+    presenterDesc.imageUsage      = DxvkSwapchainBlitter::getSwapImageUsage(m_device.ptr());
 
     VkResult vr = m_presenter->recreateSwapChain(presenterDesc);
 
@@ -876,6 +895,8 @@ namespace dxvk {
     presenterDevice.queueFamily   = graphicsQueue.queueFamily;
     presenterDevice.queue         = graphicsQueue.queueHandle;
     presenterDevice.adapter       = m_device->adapter()->handle();
+    presenterDevice.features.presentWait = m_device->features().khrPresentWait.presentWait
+                                        && m_device->config().enablePresentWait;
 
     vk::PresenterDesc presenterDesc;
     presenterDesc.imageExtent     = GetPresentExtent();
@@ -883,6 +904,7 @@ namespace dxvk {
     presenterDesc.numFormats      = PickFormats(EnumerateFormat(m_presentParams.BackBufferFormat), presenterDesc.formats);
     presenterDesc.numPresentModes = PickPresentModes(false, presenterDesc.presentModes);
     presenterDesc.fullScreenExclusive = PickFullscreenMode();
+    presenterDesc.imageUsage      = DxvkSwapchainBlitter::getSwapImageUsage(m_device.ptr());
 
     m_presenter = new vk::Presenter(
       m_device->adapter()->vki(),
@@ -891,6 +913,7 @@ namespace dxvk {
       presenterDesc);
 
     m_presenter->setFrameRateLimit(m_parent->GetOptions()->maxFrameRate);
+    m_displayMonitor = nullptr;
   }
 
 
@@ -918,7 +941,7 @@ namespace dxvk {
     imageInfo.extent      = { info.imageExtent.width, info.imageExtent.height, 1 };
     imageInfo.numLayers   = 1;
     imageInfo.mipLevels   = 1;
-    imageInfo.usage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    imageInfo.usage       = info.imageUsage;
     imageInfo.stages      = 0;
     imageInfo.access      = 0;
     imageInfo.tiling      = VK_IMAGE_TILING_OPTIMAL;
@@ -928,7 +951,7 @@ namespace dxvk {
     DxvkImageViewCreateInfo viewInfo;
     viewInfo.type         = VK_IMAGE_VIEW_TYPE_2D;
     viewInfo.format       = info.format.format;
-    viewInfo.usage        = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    viewInfo.usage        = info.imageUsage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT);
     viewInfo.aspect       = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.minLevel     = 0;
     viewInfo.numLevels    = 1;
@@ -957,15 +980,9 @@ namespace dxvk {
 
 
   HRESULT D3D9SwapChainEx::CreateBackBuffers(uint32_t NumBackBuffers) {
-    // Explicitly destroy current swap image before
-    // creating a new one to free up resources
-    DestroyBackBuffers();
-
     int NumFrontBuffer = HasFrontBuffer() ? 1 : 0;
     const uint32_t NumBuffers = NumBackBuffers + NumFrontBuffer;
 
-    m_backBuffers.reserve(NumBuffers);
-
     // Create new back buffer
     D3D9_COMMON_TEXTURE_DESC desc;
     desc.Width              = std::max(m_presentParams.BackBufferWidth,  1u);
@@ -984,17 +1001,33 @@ namespace dxvk {
     // Docs: Also note that - unlike textures - swap chain back buffers, render targets [..] can be locked
     desc.IsLockable         = TRUE;
 
-    for (uint32_t i = 0; i < NumBuffers; i++) {
-      D3D9Surface* surface;
-      try {
-        surface = new D3D9Surface(m_parent, &desc, this, nullptr);
-      } catch (const DxvkError& e) {
-        DestroyBackBuffers();
-        Logger::err(e.message());
-        return D3DERR_OUTOFVIDEOMEMORY;
-      }
+    // Keep the current back buffers if their properties
+    // did not change, e.g. when the device is reset after
+    // alt-tabbing, since recreating images can be slow
+    bool reuse = m_backBuffers.size() == NumBuffers;
+
+    for (uint32_t i = 0; i < m_backBuffers.size() && reuse; i++)
+      reuse = m_backBuffers[i]->CanReuse(&desc);
 
-      m_backBuffers.emplace_back(surface);
+    if (!reuse) {
+      // Explicitly destroy current swap image before
+      // creating a new one to free up resources
+      DestroyBackBuffers();
+
+      m_backBuffers.reserve(NumBuffers);
+
+      for (uint32_t i = 0; i < NumBuffers; i++) {
+        D3D9Surface* surface;
+        try {
+          surface = new D3D9Surface(m_parent, &desc, this, nullptr);
+        } catch (const DxvkError& e) {
+          DestroyBackBuffers();
+          Logger::err(e.message());
+          return D3DERR_OUTOFVIDEOMEMORY;
+        }
+
+        m_backBuffers.emplace_back(surface);
+      }
     }
 
     auto swapImage = m_backBuffers[0]->GetCommonTexture()->GetImage();
@@ -1142,6 +1175,28 @@ namespace dxvk {
   void D3D9SwapChainEx::NotifyDisplayRefreshRate(
           double                  RefreshRate) {
     m_displayRefreshRate = RefreshRate;
+    m_displayMonitor = nullptr;
+  }
+
+
+  void D3D9SwapChainEx::UpdateDisplayMonitor() {
+    // Let the presenter know about the refresh rate of the
+    // monitor that the window is on, so it can pace frames
+    HMONITOR monitor = wsi::getWindowMonitor(m_window);
+
+    if (monitor == m_displayMonitor)
+      return;
+
+    m_displayMonitor = monitor;
+
+    wsi::WsiRefreshInfo refreshInfo = { };
+
+    if (monitor)
+      wsi::getMonitorRefreshInfo(monitor, &refreshInfo);
+
+    m_presenter->setDisplayRefreshRate(
+      refreshInfo.refreshRate,
+      refreshInfo.variableRefresh);
   }
 
 
@@ -6,6 +6,7 @@
 
 #include "../dxvk/hud/dxvk_hud.h"
 
+#include "../dxvk/dxvk_latency.h"
 #include "../dxvk/dxvk_swapchain_blitter.h"
 
 #include "../util/sync/sync_signal.h"
@@ -118,6 +119,7 @@ namespace dxvk {
     uint64_t                  m_frameId           = D3D9DeviceEx::MaxFrameLatency;
     uint32_t                  m_frameLatencyCap   = 0;
     Rc<sync::Fence>           m_frameLatencySignal;
+    Rc<DxvkLatencyTracker>    m_latencyTracker;
 
     bool                      m_dirty    = true;
     bool                      m_vsync    = true;
@@ -131,6 +133,7 @@ namespace dxvk {
     wsi::DxvkWindowState      m_windowState;
 
     double                    m_displayRefreshRate = 0.0;
+    HMONITOR                  m_displayMonitor     = nullptr;
 
     bool                      m_warnedAboutGDIFallback = false;
 
@@ -178,6 +181,8 @@ namespace dxvk {
     void NotifyDisplayRefreshRate(
             double                  RefreshRate);
 
+    void UpdateDisplayMonitor();
+
     HRESULT EnterFullscreenMode(
             D3DPRESENT_PARAMETERS*  pPresentParams,
       const D3DDISPLAYMODEEX*       pFullscreenDisplayMode);
@@ -297,7 +297,22 @@ namespace dxvk {
 
   };
 
-  Rc<DxvkShader> D3D9SWVPEmulator::GetShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl) {
+  Rc<DxvkShader> D3D9SWVPEmulator::GetShaderModule(D3D9DeviceEx* pDevice, D3D9VertexDecl* pDecl) {
+    // Declarations are immutable, so the shader can be cached on the
+    // declaration itself and repeated ProcessVertices calls with the
+    // same declaration skip the table lookup entirely.
+    Rc<DxvkShader> shader = pDecl->GetSWVPShader();
+
+    if (unlikely(shader == nullptr)) {
+      shader = CreateShaderModule(pDevice, pDecl);
+      pDecl->SetSWVPShader(shader);
+    }
+
+    return shader;
+  }
+
+
+  Rc<DxvkShader> D3D9SWVPEmulator::CreateShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl) {
     auto& elements = pDecl->GetElements();
 
     // Use the shader's unique key for the lookup
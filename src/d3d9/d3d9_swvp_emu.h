@@ -23,10 +23,12 @@ namespace dxvk {
 
   public:
 
-    Rc<DxvkShader> GetShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl);
+    Rc<DxvkShader> GetShaderModule(D3D9DeviceEx* pDevice, D3D9VertexDecl* pDecl);
 
   private:
 
+    Rc<DxvkShader> CreateShaderModule(D3D9DeviceEx* pDevice, const D3D9VertexDecl* pDecl);
+
     dxvk::mutex                               m_mutex;
 
     std::unordered_map<
@@ -377,4 +377,108 @@ namespace dxvk {
     }
   }
 
+
+  const D3D9InputLayout& D3D9VertexDecl::GetInputLayout(
+    const DxsoIsgn&                               isgn,
+    const std::array<uint32_t, caps::MaxStreams>& streamFreq) {
+    for (const auto& entry : m_inputLayouts) {
+      if (entry.semanticCount != isgn.elemCount || entry.streamFreq != streamFreq)
+        continue;
+
+      bool match = true;
+
+      for (uint32_t i = 0; i < isgn.elemCount && match; i++)
+        match = entry.semantics[i] == isgn.elems[i].semantic;
+
+      if (match)
+        return entry.layout;
+    }
+
+    // Replace the oldest entry if the cache is full
+    InputLayoutEntry* entry;
+
+    if (m_inputLayouts.size() < MaxInputLayouts) {
+      entry = &m_inputLayouts.emplace_back();
+    } else {
+      entry = &m_inputLayouts[m_inputLayoutIndex];
+      m_inputLayoutIndex = (m_inputLayoutIndex + 1) % MaxInputLayouts;
+    }
+
+    for (uint32_t i = 0; i < isgn.elemCount; i++)
+      entry->semantics[i] = isgn.elems[i].semantic;
+
+    entry->semanticCount = isgn.elemCount;
+    entry->streamFreq = streamFreq;
+
+    ComputeInputLayout(entry->layout, isgn, streamFreq);
+    return entry->layout;
+  }
+
+
+  void D3D9VertexDecl::ComputeInputLayout(
+          D3D9InputLayout&                        layout,
+    const DxsoIsgn&                               isgn,
+    const std::array<uint32_t, caps::MaxStreams>& streamFreq) const {
+    layout.streamsUsed = 0;
+
+    uint32_t attrMask = 0;
+    uint32_t bindMask = 0;
+
+    for (uint32_t i = 0; i < isgn.elemCount; i++) {
+      const auto& decl = isgn.elems[i];
+
+      DxvkVertexAttribute attrib;
+      attrib.location = i;
+      attrib.binding  = caps::MaxStreams; // Null stream
+      attrib.format   = VK_FORMAT_R32G32B32A32_SFLOAT;
+      attrib.offset   = 0;
+
+      for (const auto& element : m_elements) {
+        DxsoSemantic elementSemantic = { static_cast<DxsoUsage>(element.Usage), element.UsageIndex };
+        if (elementSemantic.usage == DxsoUsage::PositionT)
+          elementSemantic.usage = DxsoUsage::Position;
+
+        if (elementSemantic == decl.semantic) {
+          attrib.binding = uint32_t(element.Stream);
+          attrib.format  = DecodeDecltype(D3DDECLTYPE(element.Type));
+          attrib.offset  = element.Offset;
+
+          layout.streamsUsed |= 1u << attrib.binding;
+          break;
+        }
+      }
+
+      layout.attrList[i] = attrib;
+
+      DxvkVertexBinding binding;
+      binding.binding = attrib.binding;
+      binding.extent = attrib.offset + lookupFormatInfo(attrib.format)->elementSize;
+
+      uint32_t instanceData = streamFreq[binding.binding % caps::MaxStreams];
+      if (instanceData & D3DSTREAMSOURCE_INSTANCEDATA) {
+        binding.fetchRate = instanceData & 0x7FFFFF; // Remove instance packed-in flags in the data.
+        binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+      }
+      else {
+        binding.fetchRate = 0;
+        binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+      }
+
+      if (bindMask & (1u << binding.binding)) {
+        layout.bindList.at(binding.binding).extent = std::max(
+          layout.bindList.at(binding.binding).extent, binding.extent);
+      } else {
+        layout.bindList.at(binding.binding) = binding;
+      }
+
+      attrMask |= 1u << i;
+      bindMask |= 1u << binding.binding;
+    }
+
+    // Compact the attribute and binding lists to filter
+    // out attributes and bindings not used by the shader
+    layout.attrCount = CompactSparseList(layout.attrList.data(), attrMask);
+    layout.bindCount = CompactSparseList(layout.bindList.data(), bindMask);
+  }
+
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "d3d9_device_child.h"
 #include "d3d9_util.h"
 
+#include "../dxso/dxso_isgn.h"
+
 #include <vector>
 
 namespace dxvk {
@@ -18,6 +20,22 @@ namespace dxvk {
   };
   using D3D9VertexDeclFlags = Flags<D3D9VertexDeclFlag>;
 
+  /**
+   * \brief Vertex input layout
+   *
+   * Vertex attributes and bindings for a vertex declaration,
+   * given a vertex shader input signature and the current
+   * stream source frequencies.
+   */
+  struct D3D9InputLayout {
+    uint32_t attrCount   = 0;
+    uint32_t bindCount   = 0;
+    uint32_t streamsUsed = 0;
+
+    std::array<DxvkVertexAttribute, 2 * caps::InputRegisterCount> attrList;
+    std::array<DxvkVertexBinding,   2 * caps::InputRegisterCount> bindList;
+  };
+
   using D3D9VertexDeclBase = D3D9DeviceChild<IDirect3DVertexDeclaration9>;
   class D3D9VertexDecl final : public D3D9VertexDeclBase {
 
@@ -66,8 +84,52 @@ namespace dxvk {
       return m_texcoordMask;
     }
 
+    /**
+     * \brief Cached SWVP emulation shader
+     *
+     * Only accessed from the CS thread, so that
+     * \c ProcessVertices does not have to look up
+     * the shader in the emulator's shared table.
+     * \returns Shader, or \c nullptr if not yet created
+     */
+    const Rc<DxvkShader>& GetSWVPShader() const {
+      return m_swvpShader;
+    }
+
+    void SetSWVPShader(const Rc<DxvkShader>& shader) {
+      m_swvpShader = shader;
+    }
+
+    /**
+     * \brief Looks up or computes an input layout
+     *
+     * Only accessed from the CS thread. Applications tend to
+     * use the same declaration with only a few different
+     * shaders, so the most recently used layouts are cached.
+     * \param [in] isgn Vertex shader input signature
+     * \param [in] streamFreq Stream source frequencies
+     * \returns Input layout
+     */
+    const D3D9InputLayout& GetInputLayout(
+      const DxsoIsgn&                               isgn,
+      const std::array<uint32_t, caps::MaxStreams>& streamFreq);
+
   private:
 
+    constexpr static uint32_t MaxInputLayouts = 8;
+
+    struct InputLayoutEntry {
+      std::array<DxsoSemantic, 2 * DxsoMaxInterfaceRegs> semantics;
+      uint32_t                                          semanticCount;
+      std::array<uint32_t, caps::MaxStreams>            streamFreq;
+      D3D9InputLayout                                   layout;
+    };
+
+    void ComputeInputLayout(
+            D3D9InputLayout&                        layout,
+      const DxsoIsgn&                               isgn,
+      const std::array<uint32_t, caps::MaxStreams>& streamFreq) const;
+
     bool MapD3DDeclToFvf(
       const D3DVERTEXELEMENT9& element,
             DWORD fvf,
@@ -97,6 +159,11 @@ namespace dxvk {
     // The size of Stream 0. That's all we care about.
     uint32_t                       m_size = 0;
 
+    Rc<DxvkShader>                 m_swvpShader;
+
+    std::vector<InputLayoutEntry>  m_inputLayouts;
+    uint32_t                       m_inputLayoutIndex = 0;
+
   };
 
 }
\ No newline at end of file
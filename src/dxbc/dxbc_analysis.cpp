@@ -27,6 +27,10 @@ namespace dxvk {
   
   
   void DxbcAnalyzer::processInstruction(const DxbcShaderInstruction& ins) {
+    processLoopInstruction(ins);
+    processBarrierInstruction(ins);
+    processTempWrites(ins);
+
     switch (ins.opClass) {
       case DxbcInstClass::Atomic: {
         const uint32_t operandId = ins.dstCount - 1;
@@ -48,6 +52,20 @@ namespace dxvk {
       case DxbcInstClass::ControlFlow: {
         if (ins.op == DxbcOpcode::Discard)
           m_analysis->usesKill = true;
+
+        if (ins.op == DxbcOpcode::Call
+         || ins.op == DxbcOpcode::Callc
+         || ins.op == DxbcOpcode::Label)
+          m_analysis->usesSubroutines = true;
+      } break;
+
+      case DxbcInstClass::Declaration: {
+        if (ins.op == DxbcOpcode::DclTemps)
+          m_analysis->tempCount = std::max(m_analysis->tempCount, ins.imm[0].u32);
+
+        if (ins.op == DxbcOpcode::DclHsForkPhaseInstanceCount
+         || ins.op == DxbcOpcode::DclHsJoinPhaseInstanceCount)
+          m_analysis->hsMaxPhaseInstanceCount = std::max(m_analysis->hsMaxPhaseInstanceCount, ins.imm[0].u32);
       } break;
       
       case DxbcInstClass::BufferLoad: {
@@ -95,6 +113,224 @@ namespace dxvk {
   }
   
   
+  void DxbcAnalyzer::processBarrierInstruction(const DxbcShaderInstruction& ins) {
+    if (ins.op == DxbcOpcode::Sync) {
+      DxbcBarrierInfo& barrier = m_analysis->barriers.emplace_back();
+      barrier.flags = ins.controls.syncFlags();
+
+      // Memory barriers without execution barriers do not
+      // make other threads' writes visible at this point
+      if (!barrier.flags.test(DxbcSyncFlag::ThreadsInGroup))
+        return;
+
+      bool hadMemoryFlags = barrier.flags.any(
+        DxbcSyncFlag::ThreadGroupSharedMemory,
+        DxbcSyncFlag::UavMemoryGroup,
+        DxbcSyncFlag::UavMemoryGlobal);
+
+      if (!m_tgsmAccessed)
+        barrier.flags.clr(DxbcSyncFlag::ThreadGroupSharedMemory);
+
+      if (barrier.flags.test(DxbcSyncFlag::ThreadGroupSharedMemory))
+        m_tgsmAccessed = false;
+
+      // A group-scope UAV barrier does not cover global scope, so
+      // track pending accesses for both scopes separately and only
+      // drop scopes that an earlier barrier has already covered.
+      if (barrier.flags.test(DxbcSyncFlag::UavMemoryGlobal)) {
+        if (!m_uavAccessedGlobal)
+          barrier.flags.clr(DxbcSyncFlag::UavMemoryGroup, DxbcSyncFlag::UavMemoryGlobal);
+
+        m_uavAccessedGroup  = false;
+        m_uavAccessedGlobal = false;
+      } else if (barrier.flags.test(DxbcSyncFlag::UavMemoryGroup)) {
+        if (!m_uavAccessedGroup)
+          barrier.flags.clr(DxbcSyncFlag::UavMemoryGroup);
+
+        m_uavAccessedGroup = false;
+      }
+
+      // An execution barrier that orders no memory is useless
+      if (hadMemoryFlags && barrier.flags == DxbcSyncFlags(DxbcSyncFlag::ThreadsInGroup))
+        barrier.flags.clrAll();
+
+      return;
+    }
+
+    // Only track accesses within a basic block, so
+    // that loops and branches are handled correctly
+    if (ins.opClass == DxbcInstClass::ControlFlow) {
+      m_tgsmAccessed      = true;
+      m_uavAccessedGroup  = true;
+      m_uavAccessedGlobal = true;
+      return;
+    }
+
+    bool uavAccessed = false;
+
+    for (uint32_t i = 0; i < ins.dstCount; i++) {
+      m_tgsmAccessed |= ins.dst[i].type == DxbcOperandType::ThreadGroupSharedMemory;
+      uavAccessed    |= ins.dst[i].type == DxbcOperandType::UnorderedAccessView;
+    }
+
+    for (uint32_t i = 0; i < ins.srcCount; i++) {
+      m_tgsmAccessed |= ins.src[i].type == DxbcOperandType::ThreadGroupSharedMemory;
+      uavAccessed    |= ins.src[i].type == DxbcOperandType::UnorderedAccessView;
+    }
+
+    m_uavAccessedGroup  |= uavAccessed;
+    m_uavAccessedGlobal |= uavAccessed;
+  }
+
+
+  void DxbcAnalyzer::processLoopInstruction(const DxbcShaderInstruction& ins) {
+    if (ins.op == DxbcOpcode::Loop) {
+      if (!m_loops.empty())
+        m_loops.back().depth += 1;
+
+      LoopState& loop = m_loops.emplace_back();
+      loop.index = m_analysis->loops.size();
+      loop.consts = m_tempConsts;
+
+      m_analysis->loops.emplace_back();
+      return;
+    }
+
+    if (m_loops.empty())
+      return;
+
+    LoopState& loop = m_loops.back();
+
+    switch (ins.op) {
+      case DxbcOpcode::If:
+      case DxbcOpcode::Switch:
+        loop.depth += 1;
+        return;
+
+      case DxbcOpcode::EndIf:
+      case DxbcOpcode::EndSwitch:
+        loop.depth -= 1;
+        return;
+
+      case DxbcOpcode::EndLoop:
+        finalizeLoop(loop);
+        m_loops.pop_back();
+
+        if (!m_loops.empty())
+          m_loops.back().depth -= 1;
+        return;
+
+      default:
+        break;
+    }
+
+    // Look for the exit condition at the very start of the loop body,
+    // i.e. a comparison of a scalar temp against a constant, followed
+    // by a conditional break on the result of that comparison.
+    loop.insCount += 1;
+
+    if (loop.insCount == 1) {
+      bool isCompare = ins.op == DxbcOpcode::IGe || ins.op == DxbcOpcode::ILt
+                    || ins.op == DxbcOpcode::UGe || ins.op == DxbcOpcode::ULt;
+
+      if (isCompare
+       && ins.dst[0].type == DxbcOperandType::Temp
+       && ins.dst[0].mask.popCount() == 1
+       && ins.src[0].type == DxbcOperandType::Temp
+       && ins.src[0].modifiers.isClear()
+       && ins.src[1].type == DxbcOperandType::Imm32) {
+        uint32_t comp = ins.dst[0].mask.firstSet();
+
+        loop.condition = 4 * ins.dst[0].idx[0].offset + comp;
+        loop.counter = 4 * ins.src[0].idx[0].offset + ins.src[0].swizzle[comp];
+        loop.limit = ins.src[1].componentCount == DxbcComponentCount::Component1
+          ? ins.src[1].imm.u32_1 : ins.src[1].imm.u32_4[comp];
+        loop.isSigned = ins.op == DxbcOpcode::IGe || ins.op == DxbcOpcode::ILt;
+        loop.breakIfTrue = ins.op == DxbcOpcode::IGe || ins.op == DxbcOpcode::UGe;
+      }
+    } else if (loop.insCount == 2 && loop.condition != ~0u) {
+      if (ins.op == DxbcOpcode::Breakc
+       && ins.src[0].type == DxbcOperandType::Temp
+       && 4 * ins.src[0].idx[0].offset + ins.src[0].swizzle[0] == loop.condition) {
+        bool breakIfNonZero = ins.controls.zeroTest() == DxbcZeroTest::TestNz;
+        loop.hasExit = breakIfNonZero == loop.breakIfTrue;
+      }
+    }
+  }
+
+
+  void DxbcAnalyzer::processTempWrites(const DxbcShaderInstruction& ins) {
+    for (uint32_t i = 0; i < ins.dstCount; i++) {
+      if (ins.dst[i].type != DxbcOperandType::Temp)
+        continue;
+
+      for (uint32_t c = 0; c < 4; c++) {
+        if (!ins.dst[i].mask[c])
+          continue;
+
+        uint32_t key = 4 * ins.dst[i].idx[0].offset + c;
+
+        // Only a constant increment at the top level of the loop
+        // body keeps the loop counter analyzable.
+        for (auto& loop : m_loops) {
+          if (key != loop.counter)
+            continue;
+
+          bool isIncrement = &loop == &m_loops.back()
+            && loop.depth == 0 && !loop.step
+            && ins.op == DxbcOpcode::IAdd
+            && ins.src[0].type == DxbcOperandType::Temp
+            && ins.src[0].modifiers.isClear()
+            && 4 * ins.src[0].idx[0].offset + ins.src[0].swizzle[c] == key
+            && ins.src[1].type == DxbcOperandType::Imm32;
+
+          if (isIncrement) {
+            loop.step = int32_t(ins.src[1].componentCount == DxbcComponentCount::Component1
+              ? ins.src[1].imm.u32_1 : ins.src[1].imm.u32_4[c]);
+          }
+
+          if (!isIncrement || loop.step <= 0)
+            loop.invalid = true;
+        }
+
+        if (ins.op == DxbcOpcode::Mov && i == 0
+         && !ins.modifiers.saturate
+         && ins.src[0].type == DxbcOperandType::Imm32) {
+          m_tempConsts[key] = ins.src[0].componentCount == DxbcComponentCount::Component1
+            ? ins.src[0].imm.u32_1 : ins.src[0].imm.u32_4[c];
+        } else {
+          m_tempConsts.erase(key);
+        }
+      }
+    }
+  }
+
+
+  void DxbcAnalyzer::finalizeLoop(const LoopState& loop) {
+    if (!loop.hasExit || loop.invalid || loop.step <= 0)
+      return;
+
+    auto init = loop.consts.find(loop.counter);
+
+    if (init == loop.consts.end())
+      return;
+
+    int64_t first = loop.isSigned ? int64_t(int32_t(init->second)) : int64_t(init->second);
+    int64_t limit = loop.isSigned ? int64_t(int32_t(loop.limit))   : int64_t(loop.limit);
+
+    uint64_t tripCount = first < limit
+      ? uint64_t(limit - first + loop.step - 1) / uint64_t(loop.step)
+      : 0u;
+
+    if (tripCount > uint64_t(~0u))
+      return;
+
+    auto& info = m_analysis->loops[loop.index];
+    info.tripCountKnown = true;
+    info.tripCount = uint32_t(tripCount);
+  }
+
+
   DxbcClipCullInfo DxbcAnalyzer::getClipCullInfo(const Rc<DxbcIsgn>& sgn) const {
     DxbcClipCullInfo result;
     
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include "dxbc_chunk_isgn.h"
 #include "dxbc_decoder.h"
 #include "dxbc_defs.h"
@@ -41,6 +44,35 @@ namespace dxvk {
     uint32_t numCullPlanes = 0;
   };
   
+  /**
+   * \brief Info about a loop
+   *
+   * Stores the trip count of loops that use the
+   * common counter pattern emitted by fxc, i.e.
+   * a counter initialized to a constant before
+   * the loop, a comparison against a constant
+   * limit at the start of the loop body, and a
+   * constant increment.
+   */
+  struct DxbcLoopInfo {
+    bool     tripCountKnown = false;
+    uint32_t tripCount      = 0;
+  };
+
+  /**
+   * \brief Info about a sync instruction
+   *
+   * Stores the synchronization flags that are actually
+   * needed. Memory flags are removed if the respective
+   * memory was not accessed since the last barrier with
+   * the same or a wider scope within the same basic
+   * block, and the instruction is dropped entirely if
+   * none are left.
+   */
+  struct DxbcBarrierInfo {
+    DxbcSyncFlags flags = 0;
+  };
+
   /**
    * \brief Shader analysis info
    */
@@ -54,6 +86,19 @@ namespace dxvk {
     
     bool usesDerivatives  = false;
     bool usesKill         = false;
+    bool usesSubroutines  = false;
+
+    uint32_t tempCount    = 0;
+
+    /// Highest instance count of any hull
+    /// shader fork or join phase
+    uint32_t hsMaxPhaseInstanceCount = 1;
+
+    /// Loop info, in the order in which loops appear
+    std::vector<DxbcLoopInfo> loops;
+
+    /// Barrier info, in the order in which sync instructions appear
+    std::vector<DxbcBarrierInfo> barriers;
   };
   
   /**
@@ -85,12 +130,47 @@ namespace dxvk {
       const DxbcShaderInstruction&  ins);
     
   private:
+
+    struct LoopState {
+      uint32_t index        = 0;
+      uint32_t depth        = 0;
+      uint32_t insCount     = 0;
+      uint32_t counter      = ~0u;
+      uint32_t condition    = ~0u;
+      uint32_t limit        = 0;
+      int32_t  step         = 0;
+      bool     isSigned     = false;
+      bool     breakIfTrue  = false;
+      bool     hasExit      = false;
+      bool     invalid      = false;
+
+      std::unordered_map<uint32_t, uint32_t> consts;
+    };
     
     Rc<DxbcIsgn> m_isgn;
     Rc<DxbcIsgn> m_osgn;
     Rc<DxbcIsgn> m_psgn;
     
     DxbcAnalysisInfo* m_analysis = nullptr;
+
+    std::unordered_map<uint32_t, uint32_t> m_tempConsts;
+    std::vector<LoopState>                 m_loops;
+
+    bool m_tgsmAccessed      = false;
+    bool m_uavAccessedGroup  = false;
+    bool m_uavAccessedGlobal = false;
+
+    void processLoopInstruction(
+      const DxbcShaderInstruction&  ins);
+
+    void processBarrierInstruction(
+      const DxbcShaderInstruction&  ins);
+
+    void processTempWrites(
+      const DxbcShaderInstruction&  ins);
+
+    void finalizeLoop(
+      const LoopState&              loop);
     
     DxbcClipCullInfo getClipCullInfo(
       const Rc<DxbcIsgn>& sgn) const;
@@ -19,7 +19,11 @@ namespace dxvk {
     m_isgn       (isgn),
     m_osgn       (osgn),
     m_psgn       (psgn),
-    m_analysis   (&analysis) {
+    m_analysis   (&analysis),
+    m_rRegs      (ArenaAllocator<uint32_t>(m_module.getArena())),
+    m_xRegs      (ArenaAllocator<DxbcXreg>(m_module.getArena())),
+    m_gRegs      (ArenaAllocator<DxbcGreg>(m_module.getArena())),
+    m_controlFlowBlocks(ArenaAllocator<DxbcCfgBlock>(m_module.getArena())) {
     // Declare an entry point ID. We'll need it during the
     // initialization phase where the execution mode is set.
     m_entryPointId = m_module.allocateId();
@@ -811,8 +815,10 @@ namespace dxvk {
     const uint32_t bufferId     = ins.dst[0].idx[0].offset;
     const uint32_t elementCount = ins.dst[0].idx[1].offset;
 
-    this->emitDclConstantBufferVar(bufferId, elementCount,
-      str::format("cb", bufferId).c_str());
+    // Defer the actual declaration until the buffer gets
+    // accessed, so that buffers which are declared but never
+    // used by the shader do not occupy a descriptor binding.
+    m_constantBuffers.at(bufferId).size = elementCount;
   }
   
   
@@ -1337,7 +1343,17 @@ namespace dxvk {
     // count embedded within the opcode token.
     m_hs.vertexCountOut = ins.controls.controlPointCount();
     
-    m_hs.outputPerPatch  = emitTessInterfacePerPatch(spv::StorageClassPrivate);
+    // If every fork and join phase instance can run on its own
+    // invocation, patch constants are written to the per-patch
+    // output directly, since all invocations have to see them.
+    m_hs.parallelPhases = m_analysis->hsMaxPhaseInstanceCount > 1
+                       && m_analysis->hsMaxPhaseInstanceCount <= m_hs.vertexCountOut;
+    
+    m_hs.outputPerPatchClass = m_hs.parallelPhases
+      ? spv::StorageClassOutput
+      : spv::StorageClassPrivate;
+    
+    m_hs.outputPerPatch  = emitTessInterfacePerPatch(m_hs.outputPerPatchClass);
     m_hs.outputPerVertex = emitTessInterfacePerVertex(spv::StorageClassOutput, m_hs.vertexCountOut);
     
     m_module.setOutputVertices(m_entryPointId, m_hs.vertexCountOut);
@@ -2573,7 +2589,18 @@ namespace dxvk {
   void DxbcCompiler::emitBarrier(const DxbcShaderInstruction& ins) {
     // sync takes no operands. Instead, the synchronization
     // scope is defined by the operand control bits.
-    const DxbcSyncFlags flags = ins.controls.syncFlags();
+    DxbcSyncFlags flags = ins.controls.syncFlags();
+    
+    // Skip redundant barriers, as well as memory scopes
+    // that were not accessed since the previous barrier
+    uint32_t barrierIndex = m_barrierIndex++;
+    
+    if (barrierIndex < m_analysis->barriers.size()) {
+      flags = m_analysis->barriers[barrierIndex].flags;
+      
+      if (flags.isClear())
+        return;
+    }
     
     uint32_t executionScope   = spv::ScopeInvocation;
     uint32_t memoryScope      = spv::ScopeInvocation;
@@ -2812,6 +2839,19 @@ namespace dxvk {
     // Retrieve common info about the buffer
     const DxbcBufferInfo bufferInfo = getBufferInfo(srcReg);
     
+    // If the accessed data is known to be 16-byte aligned, read
+    // one whole vector rather than loading each dword separately
+    if (isStructured && dstReg.mask.popCount() > 1
+     && canUseVec4BufferAccess(bufferInfo, ins.src[1])) {
+      const DxbcRegisterValue vectorIndex = emitCalcBufferIndexVec4(
+        emitRegisterLoad(ins.src[0], DxbcRegMask(true, false, false, false)),
+        ins.src[1].imm.u32_1, bufferInfo.stride);
+      
+      emitRegisterStore(dstReg, emitRawBufferLoadVec4(srcReg,
+        vectorIndex, dstReg.mask));
+      return;
+    }
+    
     // Compute element index
     const DxbcRegisterValue elementIndex = isStructured
       ? emitCalcBufferIndexStructured(
@@ -2851,6 +2891,19 @@ namespace dxvk {
     // Retrieve common info about the buffer
     const DxbcBufferInfo bufferInfo = getBufferInfo(dstReg);
     
+    // A vector store would overwrite unwritten components,
+    // so this only works if all four components are written
+    if (isStructured && dstReg.mask == DxbcRegMask(true, true, true, true)
+     && canUseVec4BufferAccess(bufferInfo, ins.src[1])) {
+      const DxbcRegisterValue vectorIndex = emitCalcBufferIndexVec4(
+        emitRegisterLoad(ins.src[0], DxbcRegMask(true, false, false, false)),
+        ins.src[1].imm.u32_1, bufferInfo.stride);
+      
+      emitRawBufferStoreVec4(dstReg, vectorIndex,
+        emitRegisterLoad(srcReg, dstReg.mask));
+      return;
+    }
+    
     // Compute element index
     const DxbcRegisterValue elementIndex = isStructured
       ? emitCalcBufferIndexStructured(
@@ -4065,11 +4118,24 @@ namespace dxvk {
     
     m_module.opBranch(block.b_loop.labelHeader);
     m_module.opLabel (block.b_loop.labelHeader);
+
+    // Ask the driver to unroll loops with a small, known trip
+    // count. This is only a hint, so the analysis being overly
+    // optimistic about the trip count is not an issue.
+    uint32_t loopControl = spv::LoopControlMaskNone;
+    uint32_t loopIndex = m_loopIndex++;
+
+    if (loopIndex < m_analysis->loops.size()) {
+      const auto& loopInfo = m_analysis->loops[loopIndex];
+
+      if (loopInfo.tripCountKnown && loopInfo.tripCount <= MaxUnrollTripCount)
+        loopControl = spv::LoopControlUnrollMask;
+    }
     
     m_module.opLoopMerge(
       block.b_loop.labelBreak,
       block.b_loop.labelContinue,
-      spv::LoopControlMaskNone);
+      loopControl);
     
     m_module.opBranch(block.b_loop.labelBegin);
     m_module.opLabel (block.b_loop.labelBegin);
@@ -4879,7 +4945,7 @@ namespace dxvk {
                   : InputArray { m_ds.inputPerVertex,  spv::StorageClassInput   };
         case DxbcOperandType::InputPatchConstant:
           return m_programInfo.type() == DxbcProgramType::HullShader
-                  ? InputArray { m_hs.outputPerPatch, spv::StorageClassPrivate }
+                  ? InputArray { m_hs.outputPerPatch, m_hs.outputPerPatchClass }
                   : InputArray { m_ds.inputPerPatch,  spv::StorageClassInput   };
         case DxbcOperandType::OutputControlPoint:
           return InputArray { m_hs.outputPerVertex, spv::StorageClassOutput };
@@ -4930,7 +4996,7 @@ namespace dxvk {
       } else {
         uint32_t ptrTypeId  = m_module.defPointerType(
           getVectorTypeId(result.type),
-          spv::StorageClassPrivate);
+          m_hs.outputPerPatchClass);
         
         result.id = m_module.opAccessChain(
           ptrTypeId, m_hs.outputPerPatch,
@@ -5398,6 +5464,70 @@ namespace dxvk {
   }
 
 
+  DxbcRegisterValue DxbcCompiler::emitRawBufferLoadVec4(
+    const DxbcRegister&           operand,
+          DxbcRegisterValue       vectorIndex,
+          DxbcRegMask             writeMask) {
+    const DxbcBufferInfo bufferInfo = getBufferInfo(operand);
+    
+    uint32_t vectorTypeId = getVectorTypeId({ DxbcScalarType::Uint32, 4 });
+    uint32_t pointerTypeId = m_module.defPointerType(vectorTypeId, spv::StorageClassStorageBuffer);
+    
+    SpirvMemoryOperands memoryOperands;
+
+    if (bufferInfo.coherence) {
+      memoryOperands.flags |= spv::MemoryAccessNonPrivatePointerMask;
+
+      if (bufferInfo.coherence != spv::ScopeInvocation) {
+        memoryOperands.flags |= spv::MemoryAccessMakePointerVisibleMask;
+        memoryOperands.makeVisible = m_module.constu32(bufferInfo.coherence);
+      }
+    }
+
+    uint32_t indices[2] = { m_module.constu32(0), vectorIndex.id };
+    
+    DxbcRegisterValue result;
+    result.type.ctype  = DxbcScalarType::Uint32;
+    result.type.ccount = 4;
+    result.id = m_module.opLoad(vectorTypeId,
+      m_module.opAccessChain(pointerTypeId,
+        getRawSsboVec4Var(operand), 2, indices),
+      memoryOperands);
+    return emitRegisterSwizzle(result, operand.swizzle, writeMask);
+  }
+
+
+  void DxbcCompiler::emitRawBufferStoreVec4(
+    const DxbcRegister&           operand,
+          DxbcRegisterValue       vectorIndex,
+          DxbcRegisterValue       value) {
+    const DxbcBufferInfo bufferInfo = getBufferInfo(operand);
+    
+    value = emitRegisterBitcast(value, DxbcScalarType::Uint32);
+    
+    uint32_t vectorTypeId = getVectorTypeId({ DxbcScalarType::Uint32, 4 });
+    uint32_t pointerTypeId = m_module.defPointerType(vectorTypeId, spv::StorageClassStorageBuffer);
+    
+    SpirvMemoryOperands memoryOperands;
+
+    if (bufferInfo.coherence) {
+      memoryOperands.flags |= spv::MemoryAccessNonPrivatePointerMask;
+
+      if (bufferInfo.coherence != spv::ScopeInvocation) {
+        memoryOperands.flags |= spv::MemoryAccessMakePointerAvailableMask;
+        memoryOperands.makeAvailable = m_module.constu32(bufferInfo.coherence);
+      }
+    }
+
+    uint32_t indices[2] = { m_module.constu32(0), vectorIndex.id };
+    
+    m_module.opStore(
+      m_module.opAccessChain(pointerTypeId,
+        getRawSsboVec4Var(operand), 2, indices),
+      value.id, memoryOperands);
+  }
+
+
   DxbcRegisterValue DxbcCompiler::emitQueryBufferSize(
     const DxbcRegister&           resource) {
     const DxbcBufferInfo bufferInfo = getBufferInfo(resource);
@@ -5547,6 +5677,28 @@ namespace dxvk {
   }
   
   
+  DxbcRegisterValue DxbcCompiler::emitCalcBufferIndexVec4(
+          DxbcRegisterValue       structId,
+          uint32_t                structOffset,
+          uint32_t                structStride) {
+    DxbcRegisterValue result;
+    result.type.ctype  = DxbcScalarType::Sint32;
+    result.type.ccount = 1;
+    
+    uint32_t typeId = getVectorTypeId(result.type);
+    
+    result.id = m_module.opIMul(typeId, structId.id,
+      m_module.consti32(structStride / 16));
+    
+    if (structOffset) {
+      result.id = m_module.opIAdd(typeId, result.id,
+        m_module.consti32(structOffset / 16));
+    }
+    
+    return result;
+  }
+  
+  
   DxbcRegisterValue DxbcCompiler::emitCalcTexCoord(
           DxbcRegisterValue       coordVector,
     const DxbcImageInfo&          imageInfo) {
@@ -5694,6 +5846,11 @@ namespace dxvk {
     
     uint32_t regId = reg.idx[0].offset;
     DxbcRegisterValue constId = emitIndexLoad(reg.idx[1]);
+
+    if (!m_constantBuffers.at(regId).varId) {
+      this->emitDclConstantBufferVar(regId, m_constantBuffers.at(regId).size,
+        str::format("cb", regId).c_str());
+    }
     
     uint32_t ptrTypeId = getPointerTypeId(info);
     
@@ -5846,6 +6003,9 @@ namespace dxvk {
       } else {
         emitValueStore(getIndexableTempPtr(reg, vectorId), value, reg.mask);
       }
+    } else if (reg.type == DxbcOperandType::Output && m_hs.parallelPhases
+            && m_hs.currPhaseType != DxbcCompilerHsPhase::ControlPoint) {
+      emitHsPatchConstantStore(reg, value);
     } else {
       emitValueStore(emitGetOperandPtr(reg), value, reg.mask);
     }
@@ -5973,7 +6133,7 @@ namespace dxvk {
         outputReg.id = m_module.opAccessChain(
           m_module.defPointerType(
             getVectorTypeId(outputReg.type),
-            spv::StorageClassPrivate),
+            m_hs.outputPerPatchClass),
           m_hs.outputPerPatch,
           1, &registerIndex);
       }
@@ -6676,6 +6836,33 @@ namespace dxvk {
       case DxbcProgramType::PixelShader:    emitPsInit(); break;
       case DxbcProgramType::ComputeShader:  emitCsInit(); break;
     }
+
+    // Declare temps as local variables of the main function if
+    // no other function can access them. Drivers can promote
+    // function-local variables to SSA values much more easily
+    // than private variables, which reduces compile times.
+    if (m_programInfo.type() != DxbcProgramType::HullShader
+     && !m_analysis->usesSubroutines)
+      emitTempVariables(spv::StorageClassFunction);
+  }
+
+
+  void DxbcCompiler::emitTempVariables(spv::StorageClass storageClass) {
+    m_rRegs.resize(m_analysis->tempCount, 0u);
+
+    for (uint32_t i = 0; i < m_analysis->tempCount; i++) {
+      DxbcRegisterInfo info;
+      info.type.ctype   = DxbcScalarType::Float32;
+      info.type.ccount  = 4;
+      info.type.alength = 0;
+      info.sclass       = storageClass;
+
+      uint32_t varId = emitNewVariable(info);
+      m_rRegs.at(i) = varId;
+
+      m_module.setDebugName(varId,
+        str::format("r", i).c_str());
+    }
   }
   
   
@@ -6915,18 +7102,40 @@ namespace dxvk {
     this->emitHsControlPointPhase(m_hs.cpPhase);
     this->emitHsPhaseBarrier();
     
-    // Fork-join phases and output setup
-    this->emitHsInvocationBlockBegin(1);
-    
-    for (const auto& phase : m_hs.forkPhases)
-      this->emitHsForkJoinPhase(phase);
-    
-    for (const auto& phase : m_hs.joinPhases)
-      this->emitHsForkJoinPhase(phase);
+    if (m_hs.parallelPhases) {
+      // Fork phases are independent from each other, so all of
+      // them can run at once. Join phases may read patch constants
+      // written by any fork phase instance, so they need a barrier.
+      for (const auto& phase : m_hs.forkPhases)
+        this->emitHsForkJoinPhaseParallel(phase);
+      
+      this->emitHsPhaseBarrier();
+      
+      for (const auto& phase : m_hs.joinPhases)
+        this->emitHsForkJoinPhaseParallel(phase);
+      
+      this->emitHsPhaseBarrier();
+      
+      // Patch constants already live in the output
+      // variable, only system values need to be set
+      this->emitHsInvocationBlockBegin(1);
+      this->emitOutputSetup();
+      this->emitHsInvocationBlockEnd();
+    } else {
+      // Fork-join phases and output setup
+      this->emitHsInvocationBlockBegin(1);
+      
+      for (const auto& phase : m_hs.forkPhases)
+        this->emitHsForkJoinPhase(phase);
+      
+      for (const auto& phase : m_hs.joinPhases)
+        this->emitHsForkJoinPhase(phase);
+      
+      this->emitOutputSetup();
+      this->emitHsOutputSetup();
+      this->emitHsInvocationBlockEnd();
+    }
     
-    this->emitOutputSetup();
-    this->emitHsOutputSetup();
-    this->emitHsInvocationBlockEnd();
     this->emitFunctionEnd();
   }
   
@@ -7114,6 +7323,71 @@ namespace dxvk {
   }
   
   
+  void DxbcCompiler::emitHsForkJoinPhaseParallel(
+    const DxbcCompilerHsForkJoinPhase&      phase) {
+    // Instance i of the phase runs on invocation i
+    uint32_t invocationId = m_module.opLoad(
+      getScalarTypeId(DxbcScalarType::Uint32),
+      m_hs.builtinInvocationId);
+    
+    uint32_t condition = m_module.opULessThan(
+      m_module.defBoolType(), invocationId,
+      m_module.constu32(phase.instanceCount));
+    
+    uint32_t labelIf  = m_module.allocateId();
+    uint32_t labelEnd = m_module.allocateId();
+    
+    m_module.opSelectionMerge(labelEnd, spv::SelectionControlMaskNone);
+    m_module.opBranchConditional(condition, labelIf, labelEnd);
+    m_module.opLabel(labelIf);
+    
+    m_module.opFunctionCall(
+      m_module.defVoidType(),
+      phase.functionId, 1,
+      &invocationId);
+    
+    m_module.opBranch(labelEnd);
+    m_module.opLabel (labelEnd);
+  }
+  
+  
+  void DxbcCompiler::emitHsPatchConstantStore(
+    const DxbcRegister&           reg,
+          DxbcRegisterValue       value) {
+    // Multiple invocations may write different components of the
+    // same register, so a read-modify-write of the whole vector
+    // would race. Store each written component separately.
+    DxbcRegisterPointer ptr = emitGetOperandPtr(reg);
+    
+    if (value.type.ctype != ptr.type.ctype)
+      value = emitRegisterBitcast(value, ptr.type.ctype);
+    
+    if (value.type.ccount == 1)
+      value = emitRegisterExtend(value, reg.mask.popCount());
+    
+    uint32_t scalarTypeId = getScalarTypeId(ptr.type.ctype);
+    uint32_t ptrTypeId = m_module.defPointerType(scalarTypeId, spv::StorageClassOutput);
+    uint32_t srcIndex = 0;
+    
+    for (uint32_t i = 0; i < 4; i++) {
+      if (!reg.mask[i])
+        continue;
+      
+      uint32_t componentId = value.type.ccount > 1
+        ? m_module.opCompositeExtract(scalarTypeId, value.id, 1, &srcIndex)
+        : value.id;
+      
+      uint32_t index = m_module.constu32(i);
+      
+      m_module.opStore(
+        m_module.opAccessChain(ptrTypeId, ptr.id, 1, &index),
+        componentId);
+      
+      srcIndex += 1;
+    }
+  }
+  
+  
   void DxbcCompiler::emitDclInputArray(uint32_t vertexCount) {
     DxbcVectorType info;
     info.ctype   = DxbcScalarType::Float32;
@@ -7623,6 +7897,83 @@ namespace dxvk {
   }
   
   
+  bool DxbcCompiler::canUseVec4BufferAccess(
+    const DxbcBufferInfo&         bufferInfo,
+    const DxbcRegister&           structOffset) {
+    // Structures with a 16-byte aligned stride are bound at a
+    // 16-byte aligned offset, so an immediate offset that is a
+    // multiple of 16 is enough to prove alignment. Raw buffers
+    // are not handled since their size may not be a multiple of
+    // 16 bytes, and robustness must work on a per-dword basis.
+    if (!bufferInfo.isSsbo || (bufferInfo.stride & 0xF))
+      return false;
+    
+    if (structOffset.type != DxbcOperandType::Imm32)
+      return false;
+    
+    uint32_t offset = structOffset.imm.u32_1;
+    return !(offset & 0xF) && offset + 16 <= bufferInfo.stride;
+  }
+  
+  
+  uint32_t DxbcCompiler::getRawSsboVec4Var(
+    const DxbcRegister&           operand) {
+    const uint32_t registerId = operand.idx[0].offset;
+    const bool isUav = operand.type == DxbcOperandType::UnorderedAccessView;
+    
+    uint32_t& vec4VarId = isUav
+      ? m_uavs.at(registerId).vec4VarId
+      : m_textures.at(registerId).vec4VarId;
+    
+    if (vec4VarId)
+      return vec4VarId;
+    
+    // Declare a second view of the same SSBO that treats
+    // the buffer as an array of vectors rather than dwords
+    uint32_t elemType   = getVectorTypeId({ DxbcScalarType::Uint32, 4 });
+    uint32_t arrayType  = m_module.defRuntimeArrayTypeUnique(elemType);
+    uint32_t structType = m_module.defStructTypeUnique(1, &arrayType);
+    uint32_t ptrType    = m_module.defPointerType(structType, spv::StorageClassStorageBuffer);
+    
+    vec4VarId = m_module.newVar(ptrType, spv::StorageClassStorageBuffer);
+    
+    m_module.decorateArrayStride(arrayType, 4 * sizeof(uint32_t));
+    m_module.decorate(structType, spv::DecorationBlock);
+    m_module.memberDecorateOffset(structType, 0, 0);
+    
+    m_module.setDebugName(structType,
+      str::format(isUav ? "u" : "t", registerId, "_v4_t").c_str());
+    m_module.setDebugMemberName(structType, 0, "m");
+    m_module.setDebugName(vec4VarId,
+      str::format(isUav ? "u" : "t", registerId, "_v4").c_str());
+    
+    uint32_t bindingId = isUav
+      ? computeUavBinding(m_programInfo.type(), registerId)
+      : computeSrvBinding(m_programInfo.type(), registerId);
+    
+    m_module.decorateDescriptorSet(vec4VarId, 0);
+    m_module.decorateBinding(vec4VarId, bindingId);
+    
+    VkAccessFlags access = isUav
+      ? m_analysis->uavInfos[registerId].accessFlags
+      : VkAccessFlags(VK_ACCESS_SHADER_READ_BIT);
+    
+    if (!(access & VK_ACCESS_SHADER_WRITE_BIT)) {
+      m_module.decorate(vec4VarId, spv::DecorationNonWritable);
+    } else {
+      // Both variables refer to the same memory
+      m_module.decorate(vec4VarId, spv::DecorationAliased);
+      m_module.decorate(isUav ? m_uavs.at(registerId).varId
+        : m_textures.at(registerId).varId, spv::DecorationAliased);
+    }
+    
+    if (!(access & VK_ACCESS_SHADER_READ_BIT))
+      m_module.decorate(vec4VarId, spv::DecorationNonReadable);
+    
+    return vec4VarId;
+  }
+  
+  
   uint32_t DxbcCompiler::getTexSizeDim(const DxbcImageInfo& imageType) const {
     switch (imageType.dim) {
       case spv::DimBuffer:  return 1 + imageType.array;
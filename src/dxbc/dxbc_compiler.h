@@ -265,6 +265,9 @@ namespace dxvk {
     uint32_t outputPerPatch        = 0;
     uint32_t outputPerVertex       = 0;
     
+    spv::StorageClass outputPerPatchClass = spv::StorageClassPrivate;
+    bool              parallelPhases      = false;
+    
     uint32_t invocationBlockBegin  = 0;
     uint32_t invocationBlockEnd    = 0;
 
@@ -362,7 +365,7 @@ namespace dxvk {
    * and information about the shader resource bindings.
    */
   class DxbcCompiler {
-    
+    constexpr static uint32_t MaxUnrollTripCount = 16;
   public:
     
     DxbcCompiler(
@@ -417,12 +420,12 @@ namespace dxvk {
     ////////////////////////////////////////////////
     // Temporary r# vector registers with immediate
     // indexing, and x# vector array registers.
-    std::vector<uint32_t> m_rRegs;
-    std::vector<DxbcXreg> m_xRegs;
+    std::vector<uint32_t, ArenaAllocator<uint32_t>> m_rRegs;
+    std::vector<DxbcXreg, ArenaAllocator<DxbcXreg>> m_xRegs;
     
     /////////////////////////////////////////////
     // Thread group shared memory (g#) registers
-    std::vector<DxbcGreg> m_gRegs;
+    std::vector<DxbcGreg, ArenaAllocator<DxbcGreg>> m_gRegs;
     
     ///////////////////////////////////////////////////////////
     // v# registers as defined by the shader. The type of each
@@ -459,7 +462,13 @@ namespace dxvk {
     ///////////////////////////////////////////////
     // Control flow information. Stores labels for
     // currently active if-else blocks and loops.
-    std::vector<DxbcCfgBlock> m_controlFlowBlocks;
+    std::vector<DxbcCfgBlock, ArenaAllocator<DxbcCfgBlock>> m_controlFlowBlocks;
+
+    // Index of the next loop, used to look up loop info
+    uint32_t m_loopIndex = 0;
+
+    // Index of the next sync instruction, used to look up barrier info
+    uint32_t m_barrierIndex = 0;
     
     //////////////////////////////////////////////
     // Function state tracking. Required in order
@@ -955,6 +964,16 @@ namespace dxvk {
             DxbcRegisterValue       elementIndex,
             DxbcRegisterValue       value);
     
+    DxbcRegisterValue emitRawBufferLoadVec4(
+      const DxbcRegister&           operand,
+            DxbcRegisterValue       vectorIndex,
+            DxbcRegMask             writeMask);
+    
+    void emitRawBufferStoreVec4(
+      const DxbcRegister&           operand,
+            DxbcRegisterValue       vectorIndex,
+            DxbcRegisterValue       value);
+    
     //////////////////////////
     // Resource query methods
     DxbcRegisterValue emitQueryBufferSize(
@@ -983,6 +1002,11 @@ namespace dxvk {
     DxbcRegisterValue emitCalcBufferIndexRaw(
             DxbcRegisterValue       byteOffset);
     
+    DxbcRegisterValue emitCalcBufferIndexVec4(
+            DxbcRegisterValue       structId,
+            uint32_t                structOffset,
+            uint32_t                structStride);
+    
     DxbcRegisterValue emitCalcTexCoord(
             DxbcRegisterValue       coordVector,
       const DxbcImageInfo&          imageInfo);
@@ -1086,6 +1110,9 @@ namespace dxvk {
     //////////////////////////////////////
     // Common function definition methods
     void emitInit();
+
+    void emitTempVariables(
+            spv::StorageClass       storageClass);
     
     void emitFunctionBegin(
             uint32_t                entryPoint,
@@ -1132,6 +1159,13 @@ namespace dxvk {
     void emitHsForkJoinPhase(
       const DxbcCompilerHsForkJoinPhase&      phase);
     
+    void emitHsForkJoinPhaseParallel(
+      const DxbcCompilerHsForkJoinPhase&      phase);
+    
+    void emitHsPatchConstantStore(
+      const DxbcRegister&           reg,
+            DxbcRegisterValue       value);
+    
     void emitHsPhaseBarrier();
     
     void emitHsInvocationBlockBegin(
@@ -1194,6 +1228,13 @@ namespace dxvk {
     DxbcBufferInfo getBufferInfo(
       const DxbcRegister& reg);
     
+    bool canUseVec4BufferAccess(
+      const DxbcBufferInfo&         bufferInfo,
+      const DxbcRegister&           structOffset);
+    
+    uint32_t getRawSsboVec4Var(
+      const DxbcRegister&           operand);
+    
     uint32_t getTexSizeDim(
       const DxbcImageInfo& imageType) const;
     
@@ -80,6 +80,7 @@ namespace dxvk {
     uint32_t          colorTypeId   = 0;
     uint32_t          depthTypeId   = 0;
     uint32_t          structStride  = 0;
+    uint32_t          vec4VarId     = 0;
     bool              isRawSsbo     = false;
   };
   
@@ -101,6 +102,7 @@ namespace dxvk {
     uint32_t          imageTypeId   = 0;
     uint32_t          structStride  = 0;
     uint32_t          coherence     = 0;
+    uint32_t          vec4VarId     = 0;
     bool              isRawSsbo     = false;
   };
   
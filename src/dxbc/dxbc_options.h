@@ -6,6 +6,17 @@ namespace dxvk {
 
   struct D3D11Options;
 
+  /**
+   * \brief DXBC compiler revision
+   *
+   * Part of the compile hash of translated shaders. Must
+   * be bumped whenever a change to the compiler affects
+   * the generated code or shader metadata, so that shaders
+   * cached by a development build with the same version
+   * number are not reused.
+   */
+  constexpr uint32_t DxbcCompilerRevision = 1;
+
   enum class DxbcFloatControlFlag : uint32_t {
     DenormFlushToZero32,
     DenormPreserve64,
@@ -115,6 +115,9 @@ IDXGIVkSwapChain : public IUnknown {
 
   virtual HRESULT STDMETHODCALLTYPE SetHDRMetaData(
     const DXGI_VK_HDR_METADATA*     pMetaData) = 0;
+
+  virtual void STDMETHODCALLTYPE SetDisplayMonitor(
+          HMONITOR                  hMonitor) = 0;
 };
 
 
@@ -364,6 +367,7 @@ IDXGIVkInteropDevice : public IUnknown {
 };
 
 struct D3D11_TEXTURE2D_DESC1;
+struct ID3D11Fence;
 struct ID3D11Texture2D;
 
 /**
@@ -389,6 +393,31 @@ IDXGIVkInteropDevice1 : public IDXGIVkInteropDevice {
           ID3D11Texture2D**     ppTexture2D) = 0;
 };
 
+/**
+ * \brief See IDXGIVkInteropDevice.
+ */
+MIDL_INTERFACE("e2ef5fa5-dc21-4af7-90c4-f67ef6a09325")
+IDXGIVkInteropDevice2 : public IDXGIVkInteropDevice1 {
+  /**
+   * \brief Queries the timeline semaphore of a fence
+   *
+   * Allows external Vulkan code, such as a VR runtime
+   * consuming images obtained through the interop
+   * surface interface, to synchronize with rendering
+   * without flushing or locking the submission queue.
+   * The semaphore is signaled and waited on by the
+   * D3D11 context's \c Signal and \c Wait methods.
+   * The semaphore is owned by the fence and must not
+   * be destroyed by the caller.
+   * \param [in] pFence The D3D11 fence
+   * \param [out] pSemaphore Timeline semaphore handle
+   * \returns \c S_OK on success
+   */
+  virtual HRESULT STDMETHODCALLTYPE GetFenceSemaphore(
+          ID3D11Fence*          pFence,
+          VkSemaphore*          pSemaphore) = 0;
+};
+
 /**
  * \brief DXGI adapter interface for Vulkan interop
  *
@@ -433,6 +462,7 @@ struct __declspec(uuid("4c5e1b0d-b0c8-4131-bfd8-9b2476f7f408")) IDXGIVkInteropFa
 struct __declspec(uuid("3a6d8f2c-b0e8-4ab4-b4dc-4fd24891bfa5")) IDXGIVkInteropAdapter;
 struct __declspec(uuid("e2ef5fa5-dc21-4af7-90c4-f67ef6a09323")) IDXGIVkInteropDevice;
 struct __declspec(uuid("e2ef5fa5-dc21-4af7-90c4-f67ef6a09324")) IDXGIVkInteropDevice1;
+struct __declspec(uuid("e2ef5fa5-dc21-4af7-90c4-f67ef6a09325")) IDXGIVkInteropDevice2;
 struct __declspec(uuid("5546cf8c-77e7-4341-b05d-8d4d5000e77d")) IDXGIVkInteropSurface;
 struct __declspec(uuid("1e7895a1-1bc3-4f9c-a670-290a4bc9581a")) IDXGIVkSurfaceFactory;
 struct __declspec(uuid("e4a9059e-b569-46ab-8de7-501bd2bc7f7a")) IDXGIVkSwapChain;
@@ -445,6 +475,7 @@ __CRT_UUID_DECL(IDXGIVkInteropFactory,     0x4c5e1b0d,0xb0c8,0x4131,0xbf,0xd8,0x
 __CRT_UUID_DECL(IDXGIVkInteropAdapter,     0x3a6d8f2c,0xb0e8,0x4ab4,0xb4,0xdc,0x4f,0xd2,0x48,0x91,0xbf,0xa5);
 __CRT_UUID_DECL(IDXGIVkInteropDevice,      0xe2ef5fa5,0xdc21,0x4af7,0x90,0xc4,0xf6,0x7e,0xf6,0xa0,0x93,0x23);
 __CRT_UUID_DECL(IDXGIVkInteropDevice1,     0xe2ef5fa5,0xdc21,0x4af7,0x90,0xc4,0xf6,0x7e,0xf6,0xa0,0x93,0x24);
+__CRT_UUID_DECL(IDXGIVkInteropDevice2,     0xe2ef5fa5,0xdc21,0x4af7,0x90,0xc4,0xf6,0x7e,0xf6,0xa0,0x93,0x25);
 __CRT_UUID_DECL(IDXGIVkInteropSurface,     0x5546cf8c,0x77e7,0x4341,0xb0,0x5d,0x8d,0x4d,0x50,0x00,0xe7,0x7d);
 __CRT_UUID_DECL(IDXGIVkSurfaceFactory,     0x1e7895a1,0x1bc3,0x4f9c,0xa6,0x70,0x29,0x0a,0x4b,0xc9,0x58,0x1a);
 __CRT_UUID_DECL(IDXGIVkSwapChain,          0xe4a9059e,0xb569,0x46ab,0x8d,0xe7,0x50,0x1b,0xd2,0xbc,0x7f,0x7a);
@@ -95,6 +95,29 @@ namespace dxvk {
   }
 
 
+  std::vector<wsi::WsiMode> DxgiMonitorInfo::GetDisplayModes(
+          HMONITOR                hMonitor) {
+    std::lock_guard<dxvk::mutex> lock(m_modeMutex);
+
+    auto entry = m_modeData.find(hMonitor);
+
+    if (entry != m_modeData.end())
+      return entry->second;
+
+    // Monitor handles do not get reused when displays are
+    // added or removed, so the mode list can be cached
+    // for as long as the monitor handle remains valid.
+    std::vector<wsi::WsiMode> modes;
+    wsi::WsiMode mode = { };
+
+    for (uint32_t i = 0; wsi::getDisplayMode(hMonitor, i, &mode); i++)
+      modes.push_back(mode);
+
+    m_modeData.insert({ hMonitor, modes });
+    return modes;
+  }
+
+
   uint32_t GetMonitorFormatBpp(DXGI_FORMAT Format) {
     switch (Format) {
       case DXGI_FORMAT_R8G8B8A8_UNORM:
@@ -2,6 +2,7 @@
 
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "dxgi_interfaces.h"
 #include "dxgi_options.h"
@@ -44,6 +45,18 @@ namespace dxvk {
 
     DXGI_COLOR_SPACE_TYPE DefaultColorSpace() const;
 
+    /**
+     * \brief Queries display modes of a monitor
+     *
+     * Enumerating display modes through the platform
+     * can be slow, so the list of modes is queried
+     * once per monitor and cached afterwards.
+     * \param [in] hMonitor Monitor handle
+     * \returns All display modes of the monitor
+     */
+    std::vector<wsi::WsiMode> GetDisplayModes(
+            HMONITOR                hMonitor);
+
   private:
 
     IUnknown* m_parent;
@@ -52,6 +65,9 @@ namespace dxvk {
     dxvk::mutex                                        m_monitorMutex;
     std::unordered_map<HMONITOR, DXGI_VK_MONITOR_DATA> m_monitorData;
 
+    dxvk::mutex                                        m_modeMutex;
+    std::unordered_map<HMONITOR, std::vector<wsi::WsiMode>> m_modeData;
+
     std::atomic<DXGI_COLOR_SPACE_TYPE> m_globalColorSpace;
 
   };
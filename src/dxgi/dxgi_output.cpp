@@ -347,14 +347,11 @@ namespace dxvk {
 
     // Walk over all modes that the display supports and
     // return those that match the requested format etc.
-    wsi::WsiMode devMode = { };
-    
-    uint32_t srcModeId = 0;
     uint32_t dstModeId = 0;
     
     std::vector<DXGI_MODE_DESC1> modeList;
     
-    while (wsi::getDisplayMode(m_monitor, srcModeId++, &devMode)) {
+    for (const auto& devMode : m_monitorInfo->GetDisplayModes(m_monitor)) {
       // Only enumerate interlaced modes if requested.
       if (devMode.interlaced && !(Flags & DXGI_ENUM_MODES_INTERLACED))
         continue;
@@ -290,6 +290,15 @@ namespace dxvk {
     std::lock_guard<dxvk::recursive_mutex> lockWin(m_lockWindow);
     std::lock_guard<dxvk::mutex> lockBuf(m_lockBuffer);
 
+    // Let the presenter know about the monitor that the window is
+    // on, so that it can pace frames according to its refresh rate
+    HMONITOR displayMonitor = wsi::getWindowMonitor(m_window);
+
+    if (displayMonitor != m_displayMonitor) {
+      m_displayMonitor = displayMonitor;
+      m_presenter->SetDisplayMonitor(displayMonitor);
+    }
+
     try {
       HRESULT hr = m_presenter->Present(SyncInterval, PresentFlags, nullptr);
 
@@ -751,6 +760,8 @@ namespace dxvk {
       ReleaseMonitorData();
     }
 
+    // Refresh rate may have changed
+    m_displayMonitor = nullptr;
     return S_OK;
   }
   
@@ -762,6 +773,7 @@ namespace dxvk {
     if (!wsi::restoreDisplayMode())
       return DXGI_ERROR_NOT_CURRENTLY_AVAILABLE;
 
+    m_displayMonitor = nullptr;
     return S_OK;
   }
   
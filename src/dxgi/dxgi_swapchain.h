@@ -188,6 +188,7 @@ namespace dxvk {
     Com<IDXGIVkSwapChain>           m_presenter;
     
     HMONITOR                        m_monitor;
+    HMONITOR                        m_displayMonitor = nullptr;
     wsi::DxvkWindowState            m_windowState;
     
     HRESULT EnterFullscreenMode(
@@ -23,7 +23,8 @@ namespace dxvk {
     , m_programInfo( programInfo )
     , m_analysis   ( &analysis )
     , m_layout     ( &layout )
-    , m_module     ( spvVersion(1, 3) ) {
+    , m_module     ( spvVersion(1, 3) )
+    , m_controlFlowBlocks( ArenaAllocator<DxsoCfgBlock>(m_module.getArena()) ) {
     // Declare an entry point ID. We'll need it during the
     // initialization phase where the execution mode is set.
     m_entryPointId = m_module.allocateId();
@@ -316,7 +317,7 @@ namespace dxvk {
     uint32_t member;
     bool asSsbo;
     if constexpr (ConstantBufferType == DxsoConstantBufferType::Float) {
-      asSsbo = m_moduleInfo.options.vertexFloatConstantBufferAsSSBO;
+      asSsbo = m_layout->floatAsSsbo;
 
       // float f[8192]
       member =  m_module.defArrayTypeUnique(
@@ -952,7 +953,13 @@ namespace dxvk {
 
       result.id = m_module.opLoad(typeId, ptrId);
 
-      if (relative && !m_moduleInfo.options.robustness2Supported) {
+      // Relative reads from the SWVP storage buffer are kept within
+      // the bound range by robustBufferAccess, so only apply the
+      // explicit bounds check to uniform buffers.
+      bool floatSsbo = reg.id.type == DxsoRegisterType::Const
+        && isSwvp() && m_layout->floatAsSsbo;
+
+      if (relative && !floatSsbo && !m_moduleInfo.options.robustness2Supported) {
         uint32_t constCount = m_module.constu32(m_layout->floatCount);
 
         // Expand condition to bvec4 since the result has four components
@@ -319,7 +319,7 @@ namespace dxvk {
     ///////////////////////////////////////////////
     // Control flow information. Stores labels for
     // currently active if-else blocks and loops.
-    std::vector<DxsoCfgBlock> m_controlFlowBlocks;
+    std::vector<DxsoCfgBlock, ArenaAllocator<DxsoCfgBlock>> m_controlFlowBlocks;
 
     //////////////////////////////////////////////
     // Function state tracking. Required in order
@@ -9,10 +9,7 @@ namespace dxvk {
   DxsoOptions::DxsoOptions(D3D9DeviceEx* pDevice, const D3D9Options& options) {
     const Rc<DxvkDevice> device = pDevice->GetDXVKDevice();
 
-    const Rc<DxvkAdapter> adapter = device->adapter();
-
     const DxvkDeviceFeatures& devFeatures = device->features();
-    const DxvkDeviceInfo& devInfo = adapter->devicePropertiesExt();
 
     // Apply shader-related options
     strictConstantCopies = options.strictConstantCopies;
@@ -27,8 +24,6 @@ namespace dxvk {
     forceSamplerTypeSpecConstants = options.forceSamplerTypeSpecConstants;
     forceSampleRateShading = options.forceSampleRateShading;
 
-    vertexFloatConstantBufferAsSSBO = pDevice->GetVertexConstantLayout().floatSize() > devInfo.core.properties.limits.maxUniformBufferRange;
-
     longMad = options.longMad;
     robustness2Supported = devFeatures.extRobustness2.robustBufferAccess2;
   }
@@ -39,9 +39,6 @@ namespace dxvk {
     /// Interpolate pixel shader inputs at the sample location rather than pixel center
     bool forceSampleRateShading;
 
-    /// Should the SWVP float constant buffer be a SSBO (because of the size on NV)
-    bool vertexFloatConstantBufferAsSSBO;
-
     /// Should we make our Mads a FFma or do it the long way with an FMul and an FAdd?
     /// This solves some rendering bugs in games that have z-pass shaders which
     /// don't match entirely to the regular vertex shader in this way.
@@ -5,6 +5,8 @@
 #include "dxvk_device.h"
 #include "dxvk_instance.h"
 
+#include "../util/util_time.h"
+
 namespace dxvk {
 
   DxvkDeviceQueue getDeviceQueue(const Rc<vk::DeviceFn>& vkd, uint32_t family, uint32_t index) {
@@ -28,6 +30,7 @@ namespace dxvk {
     this->queryDeviceInfo();
     this->queryDeviceFeatures();
     this->queryDeviceQueues();
+    this->queryFormatFeatures();
 
     m_hasMemoryBudget = m_deviceExtensions.supports(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
   }
@@ -36,6 +39,17 @@ namespace dxvk {
   DxvkAdapter::~DxvkAdapter() {
     
   }
+
+
+  Rc<DxvkShaderCache> DxvkAdapter::getShaderCache(
+          DxvkDevice*         device) {
+    std::lock_guard lock(m_shaderCacheMutex);
+
+    if (m_shaderCache == nullptr)
+      m_shaderCache = new DxvkShaderCache(device);
+
+    return m_shaderCache;
+  }
   
   
   DxvkAdapterMemoryInfo DxvkAdapter::getMemoryHeapInfo() const {
@@ -78,6 +92,31 @@ namespace dxvk {
   
   
   DxvkFormatFeatures DxvkAdapter::getFormatFeatures(VkFormat format) const {
+    const DxvkFormatInfo* formatInfo = lookupFormatInfo(format);
+
+    if (likely(formatInfo != nullptr))
+      return m_formatFeatures[formatInfo - g_formatInfos.data()];
+
+    return queryFormatFeatures(format);
+  }
+
+
+  std::optional<DxvkFormatLimits> DxvkAdapter::getFormatLimits(
+    const DxvkFormatQuery&          query) const {
+    std::lock_guard lock(m_formatLimitMutex);
+
+    auto entry = m_formatLimits.find(query);
+
+    if (entry != m_formatLimits.end())
+      return entry->second;
+
+    auto result = queryFormatLimits(query);
+    m_formatLimits.insert({ query, result });
+    return result;
+  }
+
+
+  DxvkFormatFeatures DxvkAdapter::queryFormatFeatures(VkFormat format) const {
     VkFormatProperties3 properties3 = { VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3 };
     VkFormatProperties2 properties2 = { VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2, &properties3 };
     m_vki->vkGetPhysicalDeviceFormatProperties2(m_handle, format, &properties2);
@@ -90,7 +129,7 @@ namespace dxvk {
   }
 
 
-  std::optional<DxvkFormatLimits> DxvkAdapter::getFormatLimits(
+  std::optional<DxvkFormatLimits> DxvkAdapter::queryFormatLimits(
     const DxvkFormatQuery&          query) const {
     VkPhysicalDeviceExternalImageFormatInfo externalInfo = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_IMAGE_FORMAT_INFO };
     externalInfo.handleType = query.handleType;
@@ -307,6 +346,8 @@ namespace dxvk {
                 || !required.vk13.maintenance4)
         && (m_deviceFeatures.extAttachmentFeedbackLoopLayout.attachmentFeedbackLoopLayout
                 || !required.extAttachmentFeedbackLoopLayout.attachmentFeedbackLoopLayout)
+        && (m_deviceFeatures.extConditionalRendering.conditionalRendering
+                || !required.extConditionalRendering.conditionalRendering)
         && (m_deviceFeatures.extConservativeRasterization
                 || !required.extConservativeRasterization)
         && (m_deviceFeatures.extCustomBorderColor.customBorderColors
@@ -315,14 +356,22 @@ namespace dxvk {
                 || !required.extCustomBorderColor.customBorderColorWithoutFormat)
         && (m_deviceFeatures.extDepthClipEnable.depthClipEnable
                 || !required.extDepthClipEnable.depthClipEnable)
+        && (m_deviceFeatures.extDescriptorBuffer.descriptorBuffer
+                || !required.extDescriptorBuffer.descriptorBuffer)
         && (m_deviceFeatures.extGraphicsPipelineLibrary.graphicsPipelineLibrary
                 || !required.extGraphicsPipelineLibrary.graphicsPipelineLibrary)
+        && (m_deviceFeatures.extHostImageCopy.hostImageCopy
+                || !required.extHostImageCopy.hostImageCopy)
+        && (m_deviceFeatures.extImageCompressionControl.imageCompressionControl
+                || !required.extImageCompressionControl.imageCompressionControl)
         && (m_deviceFeatures.extMemoryBudget
                 || !required.extMemoryBudget)
         && (m_deviceFeatures.extMemoryPriority.memoryPriority
                 || !required.extMemoryPriority.memoryPriority)
         && (m_deviceFeatures.extNonSeamlessCubeMap.nonSeamlessCubeMap
                 || !required.extNonSeamlessCubeMap.nonSeamlessCubeMap)
+        && (m_deviceFeatures.extPageableDeviceLocalMemory.pageableDeviceLocalMemory
+                || !required.extPageableDeviceLocalMemory.pageableDeviceLocalMemory)
         && (m_deviceFeatures.extRobustness2.robustBufferAccess2
                 || !required.extRobustness2.robustBufferAccess2)
         && (m_deviceFeatures.extRobustness2.robustImageAccess2
@@ -342,7 +391,11 @@ namespace dxvk {
         && (m_deviceFeatures.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor
                 || !required.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor)
         && (m_deviceFeatures.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor
-                || !required.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor);
+                || !required.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor)
+        && (m_deviceFeatures.khrPresentId.presentId
+                || !required.khrPresentId.presentId)
+        && (m_deviceFeatures.khrPresentWait.presentWait
+                || !required.khrPresentWait.presentWait);
   }
   
   
@@ -354,6 +407,8 @@ namespace dxvk {
   Rc<DxvkDevice> DxvkAdapter::createDevice(
     const Rc<DxvkInstance>&   instance,
           DxvkDeviceFeatures  enabledFeatures) {
+    auto t0 = high_resolution_clock::now();
+
     DxvkDeviceExtensions devExtensions;
     auto devExtensionList = getExtensionList(devExtensions);
 
@@ -372,6 +427,20 @@ namespace dxvk {
       enabledFeatures.vk12.bufferDeviceAddress = VK_TRUE;
     }
 
+    // Descriptor buffers are opt-in for now. They also require
+    // buffer device addresses for all buffers used in shaders.
+    bool enableDescriptorBuffer = instance->options().enableDescriptorBuffer &&
+      m_deviceExtensions.supports(devExtensions.extDescriptorBuffer.name()) &&
+      m_deviceFeatures.extDescriptorBuffer.descriptorBuffer &&
+      m_deviceFeatures.vk12.bufferDeviceAddress;
+
+    if (enableDescriptorBuffer) {
+      devExtensions.extDescriptorBuffer.setMode(DxvkExtMode::Optional);
+
+      enabledFeatures.extDescriptorBuffer.descriptorBuffer = VK_TRUE;
+      enabledFeatures.vk12.bufferDeviceAddress = VK_TRUE;
+    }
+
     DxvkNameSet extensionsEnabled;
 
     if (!m_deviceExtensions.enableExtensions(
@@ -432,6 +501,10 @@ namespace dxvk {
     // Used to make pipeline library stuff less clunky
     enabledFeatures.extExtendedDynamicState3.extendedDynamicState3AlphaToCoverageEnable =
       m_deviceFeatures.extExtendedDynamicState3.extendedDynamicState3AlphaToCoverageEnable;
+    enabledFeatures.extExtendedDynamicState3.extendedDynamicState3ColorBlendEnable =
+      m_deviceFeatures.extExtendedDynamicState3.extendedDynamicState3ColorBlendEnable;
+    enabledFeatures.extExtendedDynamicState3.extendedDynamicState3ColorBlendEquation =
+      m_deviceFeatures.extExtendedDynamicState3.extendedDynamicState3ColorBlendEquation;
     enabledFeatures.extExtendedDynamicState3.extendedDynamicState3DepthClipEnable =
       m_deviceFeatures.extExtendedDynamicState3.extendedDynamicState3DepthClipEnable &&
       m_deviceFeatures.extDepthClipEnable.depthClipEnable;
@@ -445,10 +518,25 @@ namespace dxvk {
     enabledFeatures.extGraphicsPipelineLibrary.graphicsPipelineLibrary =
       m_deviceFeatures.extGraphicsPipelineLibrary.graphicsPipelineLibrary;
 
+    // Host image copy is only used for texture initialization,
+    // enable it if supported so that the option can use it
+    enabledFeatures.extHostImageCopy.hostImageCopy =
+      m_deviceFeatures.extHostImageCopy.hostImageCopy;
+
+    // Used to request fixed-rate compression for render targets
+    enabledFeatures.extImageCompressionControl.imageCompressionControl =
+      m_deviceFeatures.extImageCompressionControl.imageCompressionControl;
+
     // Enable memory priority if supported to improve memory management
     enabledFeatures.extMemoryPriority.memoryPriority =
       m_deviceFeatures.extMemoryPriority.memoryPriority;
 
+    // Allows the driver to page out low-priority device memory
+    // allocations instead of failing or stalling under pressure
+    enabledFeatures.extPageableDeviceLocalMemory.pageableDeviceLocalMemory =
+      m_deviceFeatures.extMemoryPriority.memoryPriority &&
+      m_deviceFeatures.extPageableDeviceLocalMemory.pageableDeviceLocalMemory;
+
     // Require robustBufferAccess2 since we use the robustness alignment
     // info in a number of places, and require null descriptor support
     // since we no longer have a fallback for those in the backend
@@ -460,6 +548,15 @@ namespace dxvk {
     enabledFeatures.extShaderModuleIdentifier.shaderModuleIdentifier =
       m_deviceFeatures.extShaderModuleIdentifier.shaderModuleIdentifier;
 
+    // Used for frame pacing based on actual present timings.
+    // Present wait is useless without present IDs.
+    enabledFeatures.khrPresentId.presentId =
+      m_deviceFeatures.khrPresentId.presentId;
+
+    enabledFeatures.khrPresentWait.presentWait =
+      m_deviceFeatures.khrPresentId.presentId &&
+      m_deviceFeatures.khrPresentWait.presentWait;
+
     // Create pNext chain for additional device features
     initFeatureChain(enabledFeatures, devExtensions, instance->extensions());
 
@@ -524,7 +621,7 @@ namespace dxvk {
       extensionsEnabled.disableExtension(devExtensions.nvxBinaryImport);
       extensionsEnabled.disableExtension(devExtensions.nvxImageViewHandle);
 
-      enabledFeatures.vk12.bufferDeviceAddress = VK_FALSE;
+      enabledFeatures.vk12.bufferDeviceAddress = enableDescriptorBuffer;
 
       extensionNameList = extensionsEnabled.toNameList();
       info.enabledExtensionCount      = extensionNameList.count();
@@ -543,7 +640,14 @@ namespace dxvk {
     queues.transfer = getDeviceQueue(vkd, queueFamilies.transfer, 0);
     queues.sparse = getDeviceQueue(vkd, queueFamilies.sparse, 0);
 
-    return new DxvkDevice(instance, this, vkd, enabledFeatures, queues, DxvkQueueCallback());
+    auto t1 = high_resolution_clock::now();
+    Rc<DxvkDevice> result = new DxvkDevice(instance, this, vkd, enabledFeatures, queues, DxvkQueueCallback());
+    auto t2 = high_resolution_clock::now();
+
+    Logger::info(str::format("Startup: Created Vulkan device in ",
+      std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count(), " ms, DXVK device in ",
+      std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(), " ms"));
+    return result;
   }
 
 
@@ -583,6 +687,10 @@ namespace dxvk {
           enabledFeatures.extAttachmentFeedbackLoopLayout = *reinterpret_cast<const VkPhysicalDeviceAttachmentFeedbackLoopLayoutFeaturesEXT*>(f);
           break;
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT:
+          enabledFeatures.extConditionalRendering = *reinterpret_cast<const VkPhysicalDeviceConditionalRenderingFeaturesEXT*>(f);
+          break;
+
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CUSTOM_BORDER_COLOR_FEATURES_EXT:
           enabledFeatures.extCustomBorderColor = *reinterpret_cast<const VkPhysicalDeviceCustomBorderColorFeaturesEXT*>(f);
           break;
@@ -591,6 +699,10 @@ namespace dxvk {
           enabledFeatures.extDepthClipEnable = *reinterpret_cast<const VkPhysicalDeviceDepthClipEnableFeaturesEXT*>(f);
           break;
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT:
+          enabledFeatures.extDescriptorBuffer = *reinterpret_cast<const VkPhysicalDeviceDescriptorBufferFeaturesEXT*>(f);
+          break;
+
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT:
           enabledFeatures.extExtendedDynamicState3 = *reinterpret_cast<const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT*>(f);
           break;
@@ -603,6 +715,14 @@ namespace dxvk {
           enabledFeatures.extGraphicsPipelineLibrary = *reinterpret_cast<const VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT*>(f);
           break;
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT:
+          enabledFeatures.extHostImageCopy = *reinterpret_cast<const VkPhysicalDeviceHostImageCopyFeaturesEXT*>(f);
+          break;
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_COMPRESSION_CONTROL_FEATURES_EXT:
+          enabledFeatures.extImageCompressionControl = *reinterpret_cast<const VkPhysicalDeviceImageCompressionControlFeaturesEXT*>(f);
+          break;
+
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT:
           enabledFeatures.extMemoryPriority = *reinterpret_cast<const VkPhysicalDeviceMemoryPriorityFeaturesEXT*>(f);
           break;
@@ -611,6 +731,10 @@ namespace dxvk {
           enabledFeatures.extNonSeamlessCubeMap = *reinterpret_cast<const VkPhysicalDeviceNonSeamlessCubeMapFeaturesEXT*>(f);
           break;
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT:
+          enabledFeatures.extPageableDeviceLocalMemory = *reinterpret_cast<const VkPhysicalDevicePageableDeviceLocalMemoryFeaturesEXT*>(f);
+          break;
+
         case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT:
           enabledFeatures.extRobustness2 = *reinterpret_cast<const VkPhysicalDeviceRobustness2FeaturesEXT*>(f);
           break;
@@ -627,6 +751,14 @@ namespace dxvk {
           enabledFeatures.extVertexAttributeDivisor = *reinterpret_cast<const VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT*>(f);
           break;
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR:
+          enabledFeatures.khrPresentId = *reinterpret_cast<const VkPhysicalDevicePresentIdFeaturesKHR*>(f);
+          break;
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR:
+          enabledFeatures.khrPresentWait = *reinterpret_cast<const VkPhysicalDevicePresentWaitFeaturesKHR*>(f);
+          break;
+
         default:
           // Ignore any unknown feature structs
           break;
@@ -749,6 +881,11 @@ namespace dxvk {
     m_deviceInfo.vk13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_PROPERTIES;
     m_deviceInfo.vk13.pNext = std::exchange(m_deviceInfo.core.pNext, &m_deviceInfo.vk13);
 
+    if (m_deviceExtensions.supports(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME)) {
+      m_deviceFeatures.extConditionalRendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+      m_deviceFeatures.extConditionalRendering.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extConditionalRendering);
+    }
+
     if (m_deviceExtensions.supports(VK_EXT_CONSERVATIVE_RASTERIZATION_EXTENSION_NAME)) {
       m_deviceInfo.extConservativeRasterization.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONSERVATIVE_RASTERIZATION_PROPERTIES_EXT;
       m_deviceInfo.extConservativeRasterization.pNext = std::exchange(m_deviceInfo.core.pNext, &m_deviceInfo.extConservativeRasterization);
@@ -759,6 +896,11 @@ namespace dxvk {
       m_deviceInfo.extCustomBorderColor.pNext = std::exchange(m_deviceInfo.core.pNext, &m_deviceInfo.extCustomBorderColor);
     }
 
+    if (m_deviceExtensions.supports(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+      m_deviceInfo.extDescriptorBuffer.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+      m_deviceInfo.extDescriptorBuffer.pNext = std::exchange(m_deviceInfo.core.pNext, &m_deviceInfo.extDescriptorBuffer);
+    }
+
     if (m_deviceExtensions.supports(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
       m_deviceInfo.extExtendedDynamicState3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_PROPERTIES_EXT;
       m_deviceInfo.extExtendedDynamicState3.pNext = std::exchange(m_deviceInfo.core.pNext, &m_deviceInfo.extExtendedDynamicState3);
@@ -842,6 +984,11 @@ namespace dxvk {
       m_deviceFeatures.extDepthClipEnable.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extDepthClipEnable);
     }
 
+    if (m_deviceExtensions.supports(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+      m_deviceFeatures.extDescriptorBuffer.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+      m_deviceFeatures.extDescriptorBuffer.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extDescriptorBuffer);
+    }
+
     if (m_deviceExtensions.supports(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
       m_deviceFeatures.extExtendedDynamicState3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
       m_deviceFeatures.extExtendedDynamicState3.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extExtendedDynamicState3);
@@ -860,6 +1007,11 @@ namespace dxvk {
       m_deviceFeatures.extGraphicsPipelineLibrary.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extGraphicsPipelineLibrary);
     }
 
+    if (m_deviceExtensions.supports(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)) {
+      m_deviceFeatures.extHostImageCopy.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+      m_deviceFeatures.extHostImageCopy.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extHostImageCopy);
+    }
+
     if (m_deviceExtensions.supports(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
       m_deviceFeatures.extMemoryBudget = VK_TRUE;
 
@@ -868,11 +1020,21 @@ namespace dxvk {
       m_deviceFeatures.extMemoryPriority.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extMemoryPriority);
     }
 
+    if (m_deviceExtensions.supports(VK_EXT_IMAGE_COMPRESSION_CONTROL_EXTENSION_NAME)) {
+      m_deviceFeatures.extImageCompressionControl.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_COMPRESSION_CONTROL_FEATURES_EXT;
+      m_deviceFeatures.extImageCompressionControl.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extImageCompressionControl);
+    }
+
     if (m_deviceExtensions.supports(VK_EXT_NON_SEAMLESS_CUBE_MAP_EXTENSION_NAME)) {
       m_deviceFeatures.extNonSeamlessCubeMap.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_NON_SEAMLESS_CUBE_MAP_FEATURES_EXT;
       m_deviceFeatures.extNonSeamlessCubeMap.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extNonSeamlessCubeMap);
     }
 
+    if (m_deviceExtensions.supports(VK_EXT_PAGEABLE_DEVICE_LOCAL_MEMORY_EXTENSION_NAME)) {
+      m_deviceFeatures.extPageableDeviceLocalMemory.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT;
+      m_deviceFeatures.extPageableDeviceLocalMemory.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extPageableDeviceLocalMemory);
+    }
+
     if (m_deviceExtensions.supports(VK_EXT_ROBUSTNESS_2_EXTENSION_NAME)) {
       m_deviceFeatures.extRobustness2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT;
       m_deviceFeatures.extRobustness2.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extRobustness2);
@@ -908,6 +1070,16 @@ namespace dxvk {
     if (m_deviceExtensions.supports(VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME))
       m_deviceFeatures.khrExternalSemaphoreWin32 = VK_TRUE;
 
+    if (m_deviceExtensions.supports(VK_KHR_PRESENT_ID_EXTENSION_NAME)) {
+      m_deviceFeatures.khrPresentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+      m_deviceFeatures.khrPresentId.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.khrPresentId);
+    }
+
+    if (m_deviceExtensions.supports(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+      m_deviceFeatures.khrPresentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+      m_deviceFeatures.khrPresentWait.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.khrPresentWait);
+    }
+
     if (m_deviceExtensions.supports(VK_NVX_BINARY_IMPORT_EXTENSION_NAME))
       m_deviceFeatures.nvxBinaryImport = VK_TRUE;
 
@@ -929,6 +1101,18 @@ namespace dxvk {
   }
 
 
+  void DxvkAdapter::queryFormatFeatures() {
+    uint32_t index = 0;
+
+    for (const auto& group : g_formatGroups) {
+      for (uint32_t i = uint32_t(group.first); i <= uint32_t(group.second); i++, index++) {
+        if (i != VK_FORMAT_UNDEFINED)
+          m_formatFeatures[index] = queryFormatFeatures(VkFormat(i));
+      }
+    }
+  }
+
+
   uint32_t DxvkAdapter::findQueueFamily(
           VkQueueFlags          mask,
           VkQueueFlags          flags) const {
@@ -947,17 +1131,22 @@ namespace dxvk {
       &devExtensions.amdMemoryOverallocationBehaviour,
       &devExtensions.amdShaderFragmentMask,
       &devExtensions.extAttachmentFeedbackLoopLayout,
+      &devExtensions.extConditionalRendering,
       &devExtensions.extConservativeRasterization,
       &devExtensions.extCustomBorderColor,
       &devExtensions.extDepthClipEnable,
+      &devExtensions.extDescriptorBuffer,
       &devExtensions.extExtendedDynamicState3,
       &devExtensions.extFragmentShaderInterlock,
       &devExtensions.extFullScreenExclusive,
       &devExtensions.extGraphicsPipelineLibrary,
       &devExtensions.extHdrMetadata,
+      &devExtensions.extHostImageCopy,
+      &devExtensions.extImageCompressionControl,
       &devExtensions.extMemoryBudget,
       &devExtensions.extMemoryPriority,
       &devExtensions.extNonSeamlessCubeMap,
+      &devExtensions.extPageableDeviceLocalMemory,
       &devExtensions.extRobustness2,
       &devExtensions.extShaderModuleIdentifier,
       &devExtensions.extShaderStencilExport,
@@ -967,6 +1156,8 @@ namespace dxvk {
       &devExtensions.khrExternalMemoryWin32,
       &devExtensions.khrExternalSemaphoreWin32,
       &devExtensions.khrPipelineLibrary,
+      &devExtensions.khrPresentId,
+      &devExtensions.khrPresentWait,
       &devExtensions.khrSwapchain,
       &devExtensions.nvxBinaryImport,
       &devExtensions.nvxImageViewHandle,
@@ -998,6 +1189,11 @@ namespace dxvk {
       enabledFeatures.extAttachmentFeedbackLoopLayout.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extAttachmentFeedbackLoopLayout);
     }
 
+    if (devExtensions.extConditionalRendering) {
+      enabledFeatures.extConditionalRendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+      enabledFeatures.extConditionalRendering.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extConditionalRendering);
+    }
+
     if (devExtensions.extConservativeRasterization)
       enabledFeatures.extConservativeRasterization = VK_TRUE;
 
@@ -1011,6 +1207,11 @@ namespace dxvk {
       enabledFeatures.extDepthClipEnable.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extDepthClipEnable);
     }
 
+    if (devExtensions.extDescriptorBuffer) {
+      enabledFeatures.extDescriptorBuffer.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+      enabledFeatures.extDescriptorBuffer.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extDescriptorBuffer);
+    }
+
     if (devExtensions.extExtendedDynamicState3) {
       enabledFeatures.extExtendedDynamicState3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
       enabledFeatures.extExtendedDynamicState3.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extExtendedDynamicState3);
@@ -1029,6 +1230,11 @@ namespace dxvk {
       enabledFeatures.extGraphicsPipelineLibrary.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extGraphicsPipelineLibrary);
     }
 
+    if (devExtensions.extHostImageCopy) {
+      enabledFeatures.extHostImageCopy.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+      enabledFeatures.extHostImageCopy.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extHostImageCopy);
+    }
+
     if (devExtensions.extMemoryBudget)
       enabledFeatures.extMemoryBudget = VK_TRUE;
 
@@ -1037,11 +1243,21 @@ namespace dxvk {
       enabledFeatures.extMemoryPriority.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extMemoryPriority);
     }
 
+    if (devExtensions.extImageCompressionControl) {
+      enabledFeatures.extImageCompressionControl.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_COMPRESSION_CONTROL_FEATURES_EXT;
+      enabledFeatures.extImageCompressionControl.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extImageCompressionControl);
+    }
+
     if (devExtensions.extNonSeamlessCubeMap) {
       enabledFeatures.extNonSeamlessCubeMap.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_NON_SEAMLESS_CUBE_MAP_FEATURES_EXT;
       enabledFeatures.extNonSeamlessCubeMap.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extNonSeamlessCubeMap);
     }
 
+    if (devExtensions.extPageableDeviceLocalMemory) {
+      enabledFeatures.extPageableDeviceLocalMemory.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT;
+      enabledFeatures.extPageableDeviceLocalMemory.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extPageableDeviceLocalMemory);
+    }
+
     if (devExtensions.extShaderModuleIdentifier) {
       enabledFeatures.extShaderModuleIdentifier.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT;
       enabledFeatures.extShaderModuleIdentifier.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.extShaderModuleIdentifier);
@@ -1077,6 +1293,16 @@ namespace dxvk {
     if (devExtensions.khrExternalSemaphoreWin32)
       enabledFeatures.khrExternalSemaphoreWin32 = VK_TRUE;
 
+    if (devExtensions.khrPresentId) {
+      enabledFeatures.khrPresentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+      enabledFeatures.khrPresentId.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.khrPresentId);
+    }
+
+    if (devExtensions.khrPresentWait) {
+      enabledFeatures.khrPresentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+      enabledFeatures.khrPresentWait.pNext = std::exchange(enabledFeatures.core.pNext, &enabledFeatures.khrPresentWait);
+    }
+
     if (devExtensions.nvxBinaryImport)
       enabledFeatures.nvxBinaryImport = VK_TRUE;
 
@@ -1155,6 +1381,8 @@ namespace dxvk {
       "\n  extension supported                    : ", features.amdShaderFragmentMask ? "1" : "0",
       "\n", VK_EXT_ATTACHMENT_FEEDBACK_LOOP_LAYOUT_EXTENSION_NAME,
       "\n  attachmentFeedbackLoopLayout           : ", features.extAttachmentFeedbackLoopLayout.attachmentFeedbackLoopLayout ? "1" : "0",
+      "\n", VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME,
+      "\n  conditionalRendering                   : ", features.extConditionalRendering.conditionalRendering ? "1" : "0",
       "\n", VK_EXT_CONSERVATIVE_RASTERIZATION_EXTENSION_NAME,
       "\n  extension supported                    : ", features.extConservativeRasterization ? "1" : "0",
       "\n", VK_EXT_CUSTOM_BORDER_COLOR_EXTENSION_NAME,
@@ -1162,8 +1390,12 @@ namespace dxvk {
       "\n  customBorderColorWithoutFormat         : ", features.extCustomBorderColor.customBorderColorWithoutFormat ? "1" : "0",
       "\n", VK_EXT_DEPTH_CLIP_ENABLE_EXTENSION_NAME,
       "\n  depthClipEnable                        : ", features.extDepthClipEnable.depthClipEnable ? "1" : "0",
+      "\n", VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+      "\n  descriptorBuffer                       : ", features.extDescriptorBuffer.descriptorBuffer ? "1" : "0",
       "\n", VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
       "\n  extDynamicState3AlphaToCoverageEnable  : ", features.extExtendedDynamicState3.extendedDynamicState3AlphaToCoverageEnable ? "1" : "0",
+      "\n  extDynamicState3ColorBlendEnable       : ", features.extExtendedDynamicState3.extendedDynamicState3ColorBlendEnable ? "1" : "0",
+      "\n  extDynamicState3ColorBlendEquation     : ", features.extExtendedDynamicState3.extendedDynamicState3ColorBlendEquation ? "1" : "0",
       "\n  extDynamicState3DepthClipEnable        : ", features.extExtendedDynamicState3.extendedDynamicState3DepthClipEnable ? "1" : "0",
       "\n  extDynamicState3RasterizationSamples   : ", features.extExtendedDynamicState3.extendedDynamicState3RasterizationSamples ? "1" : "0",
       "\n  extDynamicState3SampleMask             : ", features.extExtendedDynamicState3.extendedDynamicState3SampleMask ? "1" : "0",
@@ -1174,12 +1406,18 @@ namespace dxvk {
       "\n  extension supported                    : ", features.extFullScreenExclusive ? "1" : "0",
       "\n", VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
       "\n  graphicsPipelineLibrary                : ", features.extGraphicsPipelineLibrary.graphicsPipelineLibrary ? "1" : "0",
+      "\n", VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+      "\n  hostImageCopy                          : ", features.extHostImageCopy.hostImageCopy ? "1" : "0",
+      "\n", VK_EXT_IMAGE_COMPRESSION_CONTROL_EXTENSION_NAME,
+      "\n  imageCompressionControl                : ", features.extImageCompressionControl.imageCompressionControl ? "1" : "0",
       "\n", VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
       "\n  extension supported                    : ", features.extMemoryBudget ? "1" : "0",
       "\n", VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME,
       "\n  memoryPriority                         : ", features.extMemoryPriority.memoryPriority ? "1" : "0",
       "\n", VK_EXT_NON_SEAMLESS_CUBE_MAP_EXTENSION_NAME,
       "\n  nonSeamlessCubeMap                     : ", features.extNonSeamlessCubeMap.nonSeamlessCubeMap ? "1" : "0",
+      "\n", VK_EXT_PAGEABLE_DEVICE_LOCAL_MEMORY_EXTENSION_NAME,
+      "\n  pageableDeviceLocalMemory              : ", features.extPageableDeviceLocalMemory.pageableDeviceLocalMemory ? "1" : "0",
       "\n", VK_EXT_ROBUSTNESS_2_EXTENSION_NAME,
       "\n  robustBufferAccess2                    : ", features.extRobustness2.robustBufferAccess2 ? "1" : "0",
       "\n  robustImageAccess2                     : ", features.extRobustness2.robustImageAccess2 ? "1" : "0",
@@ -1202,6 +1440,10 @@ namespace dxvk {
       "\n  extension supported                    : ", features.khrExternalMemoryWin32 ? "1" : "0",
       "\n", VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME,
       "\n  extension supported                    : ", features.khrExternalSemaphoreWin32 ? "1" : "0",
+      "\n", VK_KHR_PRESENT_ID_EXTENSION_NAME,
+      "\n  presentId                              : ", features.khrPresentId.presentId ? "1" : "0",
+      "\n", VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+      "\n  presentWait                            : ", features.khrPresentWait.presentWait ? "1" : "0",
       "\n", VK_NVX_BINARY_IMPORT_EXTENSION_NAME,
       "\n  extension supported                    : ", features.nvxBinaryImport ? "1" : "0",
       "\n", VK_NVX_IMAGE_VIEW_HANDLE_EXTENSION_NAME,
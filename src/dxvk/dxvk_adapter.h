@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <optional>
+#include <unordered_map>
 
 #include "dxvk_device_info.h"
 #include "dxvk_extensions.h"
@@ -12,6 +13,7 @@ namespace dxvk {
   
   class DxvkDevice;
   class DxvkInstance;
+  class DxvkShaderCache;
 
   using DxvkQueueCallback = std::function<void (bool)>;
 
@@ -159,6 +161,8 @@ namespace dxvk {
     /**
      * \brief Queries format feature support
      *
+     * Features of all known formats are queried on
+     * adapter creation, so this is a table lookup.
      * \param [in] format Format to query
      * \returns Format feature bits
      */
@@ -168,6 +172,8 @@ namespace dxvk {
     /**
      * \brief Queries format limits
      *
+     * Results are cached, since applications tend to
+     * query the same formats and usages many times.
      * \param [in] query Format query info
      * \returns Format limits if the given image is supported
      */
@@ -286,6 +292,17 @@ namespace dxvk {
         m_linkedToDGPU = true;
     }
 
+    /**
+     * \brief Retrieves shared shader cache
+     *
+     * Creates the shader cache on first use. All devices
+     * created from this adapter share the same cache.
+     * \param [in] device Device requesting the cache
+     * \returns Shader cache
+     */
+    Rc<DxvkShaderCache> getShaderCache(
+            DxvkDevice*         device);
+
     /**
      * \brief Retrieves linked integrated GPU
      * \returns Integrated GPU adapter
@@ -319,6 +336,16 @@ namespace dxvk {
 
     std::vector<VkQueueFamilyProperties> m_queueFamilies;
 
+    std::array<DxvkFormatFeatures, DxvkFormatCount> m_formatFeatures = { };
+
+    mutable dxvk::mutex m_formatLimitMutex;
+    mutable std::unordered_map<DxvkFormatQuery,
+      std::optional<DxvkFormatLimits>,
+      DxvkHash, DxvkEq> m_formatLimits;
+
+    dxvk::mutex         m_shaderCacheMutex;
+    Rc<DxvkShaderCache> m_shaderCache;
+
     std::array<std::atomic<uint64_t>, VK_MAX_MEMORY_HEAPS> m_memoryAllocated = { };
     std::array<std::atomic<uint64_t>, VK_MAX_MEMORY_HEAPS> m_memoryUsed = { };
 
@@ -326,6 +353,13 @@ namespace dxvk {
     void queryDeviceInfo();
     void queryDeviceFeatures();
     void queryDeviceQueues();
+    void queryFormatFeatures();
+
+    DxvkFormatFeatures queryFormatFeatures(
+            VkFormat                  format) const;
+
+    std::optional<DxvkFormatLimits> queryFormatLimits(
+      const DxvkFormatQuery&          query) const;
 
     uint32_t findQueueFamily(
             VkQueueFlags          mask,
@@ -13,7 +13,8 @@ namespace dxvk {
     | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
     | VK_ACCESS_TRANSFER_READ_BIT
     | VK_ACCESS_MEMORY_READ_BIT
-    | VK_ACCESS_TRANSFORM_FEEDBACK_COUNTER_READ_BIT_EXT;
+    | VK_ACCESS_TRANSFORM_FEEDBACK_COUNTER_READ_BIT_EXT
+    | VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT;
     
   constexpr static VkAccessFlags AccessWriteMask
     = VK_ACCESS_SHADER_WRITE_BIT
@@ -48,7 +49,8 @@ namespace dxvk {
     | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
     | VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT
     | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
-    | VK_PIPELINE_STAGE_TRANSFORM_FEEDBACK_BIT_EXT;
+    | VK_PIPELINE_STAGE_TRANSFORM_FEEDBACK_BIT_EXT
+    | VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT;
 
   DxvkBarrierSet:: DxvkBarrierSet(DxvkCmdBuffer cmdBuffer)
   : m_cmdBuffer(cmdBuffer) {
@@ -293,6 +295,41 @@ namespace dxvk {
   }
 
 
+  bool DxvkBarrierSet::hasImageBarriers(VkImage image) const {
+    for (const auto& barrier : m_imgBarriers) {
+      if (barrier.image == image)
+        return true;
+    }
+
+    return false;
+  }
+
+
+  void DxvkBarrierSet::merge(DxvkBarrierSet& barriers) {
+    // Move pending barriers over so that both sets can be recorded
+    // with a single pipeline barrier. The hazard tracking info of the
+    // other set is dropped, just like it would be after recording.
+    // Callers must ensure that the image barriers of both sets do
+    // not contain layout transitions for the same image.
+    m_allBarrierSrcStages |= barriers.m_allBarrierSrcStages;
+
+    m_memBarrier.srcStageMask  |= barriers.m_memBarrier.srcStageMask;
+    m_memBarrier.srcAccessMask |= barriers.m_memBarrier.srcAccessMask;
+    m_memBarrier.dstStageMask  |= barriers.m_memBarrier.dstStageMask;
+    m_memBarrier.dstAccessMask |= barriers.m_memBarrier.dstAccessMask;
+
+    m_bufBarriers.insert(m_bufBarriers.end(),
+      barriers.m_bufBarriers.begin(),
+      barriers.m_bufBarriers.end());
+
+    m_imgBarriers.insert(m_imgBarriers.end(),
+      barriers.m_imgBarriers.begin(),
+      barriers.m_imgBarriers.end());
+
+    barriers.reset();
+  }
+
+
   void DxvkBarrierSet::finalize(const Rc<DxvkCommandList>& commandList) {
     // Emit host barrier if necessary
     if (m_hostBarrierSrcStages) {
@@ -312,6 +349,20 @@ namespace dxvk {
   void DxvkBarrierSet::recordCommands(const Rc<DxvkCommandList>& commandList) {
     VkDependencyInfo depInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
 
+    // Barriers within the same batch are not ordered against each
+    // other, so layout transitions must include the source scope of
+    // the global memory barrier in order to not race with any writes
+    // that were made available through it. This matters if barriers
+    // of another set were merged into this one.
+    if (m_memBarrier.srcAccessMask) {
+      for (auto& barrier : m_imgBarriers) {
+        if (barrier.oldLayout != barrier.newLayout) {
+          barrier.srcStageMask  |= m_memBarrier.srcStageMask;
+          barrier.srcAccessMask |= m_memBarrier.srcAccessMask;
+        }
+      }
+    }
+
     if (m_memBarrier.srcStageMask | m_memBarrier.dstStageMask) {
       depInfo.memoryBarrierCount = 1;
       depInfo.pMemoryBarriers = &m_memBarrier;
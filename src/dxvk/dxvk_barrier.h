@@ -576,6 +576,12 @@ namespace dxvk {
       return m_allBarrierSrcStages;
     }
     
+    bool hasImageBarriers(
+            VkImage                   image) const;
+
+    void merge(
+            DxvkBarrierSet&           barriers);
+
     void finalize(
       const Rc<DxvkCommandList>&      commandList);
 
@@ -5,17 +5,109 @@
 #include <algorithm>
 
 namespace dxvk {
+
+  /// Number of submissions without any slice allocations
+  /// after which a buffer releases its extra backing buffers
+  constexpr uint64_t BufferIdleSubmissionCount = 256;
+
+
+  DxvkBufferSliceRing::DxvkBufferSliceRing(
+          uint32_t              capacity)
+  : m_mask  (capacity - 1),
+    m_cells (new Cell[capacity]) {
+    for (uint32_t i = 0; i < capacity; i++) {
+      m_cells[i].index.store(i, std::memory_order_relaxed);
+      m_cells[i].sequenceNumber.store(0, std::memory_order_relaxed);
+    }
+  }
+
+
+  DxvkBufferSliceRing::~DxvkBufferSliceRing() {
+
+  }
+
+
+  bool DxvkBufferSliceRing::push(
+    const DxvkBufferSliceHandle& slice,
+          uint64_t              sequenceNumber) {
+    uint64_t pos = m_tail.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+      cell = &m_cells[pos & m_mask];
+
+      int64_t diff = int64_t(cell->index.load(std::memory_order_acquire)) - int64_t(pos);
+
+      if (!diff) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->slice = slice;
+    cell->sequenceNumber.store(sequenceNumber, std::memory_order_relaxed);
+    cell->index.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+
+  DxvkBufferSliceRing::PopResult DxvkBufferSliceRing::pop(
+          uint64_t              completed,
+          DxvkBufferSliceHandle& slice) {
+    uint64_t pos = m_head.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+      cell = &m_cells[pos & m_mask];
+
+      int64_t diff = int64_t(cell->index.load(std::memory_order_acquire)) - int64_t(pos + 1);
+
+      if (!diff) {
+        // The cell cannot be overwritten while the head still points
+        // to it, so the sequence number is valid if the CAS succeeds
+        if (cell->sequenceNumber.load(std::memory_order_relaxed) > completed)
+          return PopResult::Busy;
+
+        if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return PopResult::Empty;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    }
+
+    slice = cell->slice;
+    cell->index.store(pos + m_mask + 1, std::memory_order_release);
+    return PopResult::Success;
+  }
+
   
   DxvkBuffer::DxvkBuffer(
           DxvkDevice*           device,
     const DxvkBufferCreateInfo& createInfo,
           DxvkMemoryAllocator&  memAlloc,
           VkMemoryPropertyFlags memFlags)
-  : m_vkd           (device->vkd()),
+  : m_device        (device),
+    m_vkd           (device->vkd()),
     m_info          (createInfo),
     m_memAlloc      (&memAlloc),
     m_memFlags      (memFlags),
     m_shaderStages  (util::shaderStages(createInfo.stages)) {
+    // Descriptor buffers reference shader resources by address
+    constexpr VkBufferUsageFlags DescriptorUsage
+      = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+      | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+      | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+      | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT;
+
+    if (device->canUseDescriptorBuffer() && (m_info.usage & DescriptorUsage))
+      m_info.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
     if (!(m_info.flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT)) {
       // Align slices so that we don't violate any alignment
       // requirements imposed by the Vulkan device/driver
@@ -31,17 +123,30 @@ namespace dxvk {
         ? MaxBufferSize / m_physSliceStride
         : 1;
 
+      // Small uniform buffers share their backing storage with
+      // other buffers, so that binding a different buffer only
+      // changes the offset of a dynamic uniform buffer descriptor.
+      // Small vertex buffers do the same so that creating them
+      // does not need to create and bind a Vulkan buffer.
+      if (canUseUniformHeap(device, sliceAlignment))
+        m_heap = &device->uniformHeap();
+      else if (canUseVertexHeap(device, sliceAlignment))
+        m_heap = &device->vertexHeap();
+
       // Allocate the initial set of buffer slices. Only clear
       // buffer memory if there is more than one slice, since
       // we expect the client api to initialize the first slice.
       m_buffer = allocBuffer(m_physSliceCount, m_physSliceCount > 1);
 
       m_physSlice.handle = m_buffer.buffer;
-      m_physSlice.offset = 0;
+      m_physSlice.offset = m_buffer.offset;
       m_physSlice.length = m_physSliceLength;
-      m_physSlice.mapPtr = m_buffer.memory.mapPtr(0);
+      m_physSlice.mapPtr = m_buffer.mapPtr;
 
       m_lazyAlloc = m_physSliceCount > 1;
+
+      m_physSliceInitCount = m_physSliceCount;
+      m_totalSliceCount = m_physSliceCount;
     } else {
       m_physSliceLength = createInfo.size;
       m_physSliceStride = createInfo.size;
@@ -67,7 +172,8 @@ namespace dxvk {
     const DxvkBufferCreateInfo& createInfo,
     const DxvkBufferImportInfo& importInfo,
           VkMemoryPropertyFlags memFlags)
-  : m_vkd           (device->vkd()),
+  : m_device        (device),
+    m_vkd           (device->vkd()),
     m_info          (createInfo),
     m_import        (importInfo),
     m_memAlloc      (nullptr),
@@ -89,13 +195,212 @@ namespace dxvk {
 
   DxvkBuffer::~DxvkBuffer() {
     for (const auto& buffer : m_buffers)
-      m_vkd->vkDestroyBuffer(m_vkd->device(), buffer.buffer, nullptr);
+      freeBuffer(buffer.handle, buffer.sliceCount);
+
+    freeBuffer(m_buffer, m_physSliceInitCount);
+  }
+
+
+  DxvkBufferSliceHandle DxvkBuffer::allocSlice() {
+    uint64_t completed = m_device->completedSequenceNumber();
+
+    if (unlikely(completed > m_lastAllocSequence.load(std::memory_order_relaxed) + BufferIdleSubmissionCount))
+      trimSlices(completed);
+
+    m_lastAllocSequence.store(completed, std::memory_order_relaxed);
+
+    DxvkBufferSliceHandle result;
+
+    if (likely(popSlice(completed, result)))
+      return result;
+
+    return allocSliceSlow(completed);
+  }
+
+
+  void DxvkBuffer::retireSlice(
+    const DxvkBufferSliceHandle& slice,
+          uint64_t              sequenceNumber) {
+    uint32_t ringCount = m_ringCount.load(std::memory_order_acquire);
 
-    m_vkd->vkDestroyBuffer(m_vkd->device(), m_buffer.buffer, nullptr);
+    // Producers only ever push to the most recently created
+    // ring, so that older rings only contain older slices.
+    if (likely(ringCount && m_rings[ringCount - 1]->push(slice, sequenceNumber)))
+      return;
+
+    std::unique_lock<sync::Spinlock> freeLock(m_freeMutex);
+    ringCount = m_ringCount.load(std::memory_order_relaxed);
+
+    while (ringCount < MaxRingCount) {
+      if (ringCount && m_rings[ringCount - 1]->push(slice, sequenceNumber))
+        return;
+
+      m_rings[ringCount] = std::make_unique<DxvkBufferSliceRing>(MinRingCapacity << ringCount);
+      m_ringCount.store(++ringCount, std::memory_order_release);
+    }
+
+    if (m_rings[ringCount - 1]->push(slice, sequenceNumber))
+      return;
+
+    // Can only happen with millions of slices in flight. The
+    // slice will be freed along with its backing buffer.
+    Logger::err("DxvkBuffer: Failed to retire buffer slice");
+  }
+
+
+  bool DxvkBuffer::popSlice(
+          uint64_t              completed,
+          DxvkBufferSliceHandle& slice) {
+    uint32_t ringCount = m_ringCount.load(std::memory_order_acquire);
+
+    for (uint32_t i = 0; i < ringCount; i++) {
+      auto result = m_rings[i]->pop(completed, slice);
+
+      if (result == DxvkBufferSliceRing::PopResult::Success)
+        return true;
+
+      // Newer rings can only contain newer slices
+      if (result == DxvkBufferSliceRing::PopResult::Busy)
+        return false;
+    }
+
+    return false;
+  }
+
+
+  DxvkBufferSliceHandle DxvkBuffer::allocSliceSlow(
+          uint64_t              completed) {
+    std::unique_lock<sync::Spinlock> freeLock(m_freeMutex);
+
+    // Another thread may have retired slices in the meantime
+    DxvkBufferSliceHandle result;
+
+    if (popSlice(completed, result))
+      return result;
+
+    // If there are no slices available, create a new
+    // backing buffer and add all slices to the free list.
+    if (unlikely(m_freeSlices.empty())) {
+      if (likely(!m_lazyAlloc)) {
+        VkDeviceSize sliceCount = m_physSliceCount;
+        m_physSliceCount = std::min(m_physSliceCount * 2, m_physSliceMaxCount);
+
+        // Allocating memory can take a while, don't make other
+        // threads renaming the same buffer spin on the lock.
+        // The new buffer is not visible to trimSlices until
+        // it is added to the list, so this is safe.
+        freeLock.unlock();
+
+        DxvkBufferHandle handle = allocBuffer(sliceCount, true);
+
+        freeLock.lock();
+
+        // Another thread may have published a new backing buffer
+        // while the lock was not held. Use its slices and discard
+        // ours, so that racing threads do not add duplicate buffers.
+        if (unlikely(!m_freeSlices.empty())) {
+          result = m_freeSlices.back();
+          m_freeSlices.pop_back();
+
+          freeLock.unlock();
+
+          freeBuffer(handle, sliceCount);
+          return result;
+        }
+
+        for (uint32_t i = 0; i < sliceCount; i++)
+          pushSlice(handle, i);
+
+        m_buffers.push_back({ std::move(handle), sliceCount });
+        m_totalSliceCount += sliceCount;
+      } else {
+        for (uint32_t i = 1; i < m_physSliceCount; i++)
+          pushSlice(m_buffer, i);
+
+        m_lazyAlloc = false;
+      }
+    }
+
+    // Take the first slice from the queue
+    result = m_freeSlices.back();
+    m_freeSlices.pop_back();
+    return result;
+  }
+
+
+  void DxvkBuffer::trimSlices(
+          uint64_t              completed) {
+    // Buffer views are cached per slice, so we
+    // cannot safely destroy any backing buffers
+    constexpr VkBufferUsageFlags ViewUsage
+      = VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+      | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT;
+
+    if (m_info.usage & ViewUsage)
+      return;
+
+    std::unique_lock<sync::Spinlock> freeLock(m_freeMutex);
+
+    if (m_lazyAlloc || m_buffers.empty())
+      return;
+
+    // Gather all slices that are not in use anymore. Backing
+    // buffers can only be destroyed if all slices other than
+    // the current one are accounted for, otherwise the client
+    // API or a pending command list may still hold some.
+    std::vector<DxvkBufferSliceHandle> slices = std::move(m_freeSlices);
+    DxvkBufferSliceHandle slice;
+
+    while (popSlice(completed, slice))
+      slices.push_back(slice);
+
+    if (slices.size() + 1 == m_totalSliceCount) {
+      for (auto i = m_buffers.begin(); i != m_buffers.end(); ) {
+        if (!ownsSlice(i->handle, i->sliceCount, m_physSlice)) {
+          freeBuffer(i->handle, i->sliceCount);
+          i = m_buffers.erase(i);
+        } else {
+          i++;
+        }
+      }
+
+      m_totalSliceCount = m_physSliceInitCount;
+
+      for (const auto& b : m_buffers)
+        m_totalSliceCount += b.sliceCount;
+
+      slices.erase(std::remove_if(slices.begin(), slices.end(),
+        [this] (const DxvkBufferSliceHandle& s) {
+          if (ownsSlice(m_buffer, m_physSliceInitCount, s))
+            return false;
+
+          for (const auto& b : m_buffers) {
+            if (ownsSlice(b.handle, b.sliceCount, s))
+              return false;
+          }
+
+          return true;
+        }), slices.end());
+
+      m_physSliceCount = m_physSliceInitCount;
+    }
+
+    // Slices that were taken from the rings are known
+    // to be unused, so they can go to the free list.
+    m_freeSlices = std::move(slices);
   }
   
   
   DxvkBufferHandle DxvkBuffer::allocBuffer(VkDeviceSize sliceCount, bool clear) const {
+    if (m_heap) {
+      DxvkBufferHandle handle = m_heap->alloc(m_memFlags, m_physSliceStride * sliceCount);
+
+      if (clear && handle.mapPtr)
+        std::memset(handle.mapPtr, 0, m_physSliceStride * sliceCount);
+
+      return handle;
+    }
+
     VkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
     info.flags = m_info.flags;
     info.size = m_physSliceStride * sliceCount;
@@ -143,6 +448,11 @@ namespace dxvk {
     if (isGpuWritable)
       hints.set(DxvkMemoryFlag::GpuWritable);
 
+    // Only buffers accessed through descriptor buffers need memory
+    // with device address support, keep it out of everything else
+    if (m_info.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+      hints.set(DxvkMemoryFlag::DeviceAddress);
+
     // Staging buffers that can't even be used as a transfer destinations
     // are likely short-lived, so we should put them on a separate memory
     // pool in order to avoid fragmentation
@@ -150,19 +460,43 @@ namespace dxvk {
      && (m_info.usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
       hints.set(DxvkMemoryFlag::Transient);
 
+    // Categorize the allocation for memory statistics
+    constexpr VkBufferUsageFlags transferUsage
+      = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+      | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+    if (m_info.usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+      memoryProperties.category = DxvkMemoryCategory::ConstantBuffer;
+    else if (m_info.usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT))
+      memoryProperties.category = DxvkMemoryCategory::GeometryBuffer;
+    else if (!(m_info.usage & ~transferUsage))
+      memoryProperties.category = DxvkMemoryCategory::Staging;
+
     handle.memory = m_memAlloc->alloc(memoryRequirements, memoryProperties, hints);
     
     if (m_vkd->vkBindBufferMemory(m_vkd->device(), handle.buffer,
         handle.memory.memory(), handle.memory.offset()) != VK_SUCCESS)
       throw DxvkError("DxvkBuffer: Failed to bind device memory");
+
+    handle.mapPtr = handle.memory.mapPtr(0);
     
     if (clear && (m_memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
-      std::memset(handle.memory.mapPtr(0), 0, info.size);
+      std::memset(handle.mapPtr, 0, info.size);
 
     return handle;
   }
 
 
+  void DxvkBuffer::freeBuffer(
+    const DxvkBufferHandle&     handle,
+          VkDeviceSize          sliceCount) const {
+    if (m_heap)
+      m_heap->free(m_memFlags, handle, m_physSliceStride * sliceCount);
+    else
+      m_device->reclaimer().destroyBuffer(handle.buffer);
+  }
+
+
   DxvkBufferHandle DxvkBuffer::createSparseBuffer() const {
     VkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
     info.flags = m_info.flags;
@@ -222,6 +556,47 @@ namespace dxvk {
   }
 
 
+  bool DxvkBuffer::canUseUniformHeap(
+          DxvkDevice*           device,
+          VkDeviceSize          sliceAlignment) const {
+    if (!device->canUseDynamicUniformBuffers())
+      return false;
+
+    if (!(m_info.usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT))
+      return false;
+
+    // Only map-based updates are cheap enough to benefit
+    return (m_memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        && isHeapCompatible(device->uniformHeap(), sliceAlignment,
+             VkDeviceSize(device->config().uniformHeapThreshold));
+  }
+
+
+  bool DxvkBuffer::canUseVertexHeap(
+          DxvkDevice*           device,
+          VkDeviceSize          sliceAlignment) const {
+    if (!(m_info.usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT))
+      return false;
+
+    return isHeapCompatible(device->vertexHeap(), sliceAlignment,
+      VkDeviceSize(device->config().vertexHeapThreshold));
+  }
+
+
+  bool DxvkBuffer::isHeapCompatible(
+    const DxvkBufferHeap&       heap,
+          VkDeviceSize          sliceAlignment,
+          VkDeviceSize          threshold) const {
+    static_assert(DxvkBufferHeap::MaxBlockSize >= (256 << 10));
+
+    if ((m_info.usage & ~heap.usage()) || m_info.flags)
+      return false;
+
+    return sliceAlignment <= DxvkBufferHeap::BlockAlignment
+        && m_info.size <= threshold;
+  }
+
+
 
   
   DxvkBufferView::DxvkBufferView(
@@ -237,14 +612,14 @@ namespace dxvk {
   
   
   DxvkBufferView::~DxvkBufferView() {
-    if (m_views.empty()) {
-      m_vkd->vkDestroyBufferView(
-        m_vkd->device(), m_bufferView, nullptr);
+    DxvkObjectReclaimer& reclaimer = m_buffer->m_device->reclaimer();
+
+    if (!m_views.size()) {
+      reclaimer.destroyBufferView(m_bufferView);
     } else {
-      for (const auto& pair : m_views) {
-        m_vkd->vkDestroyBufferView(
-          m_vkd->device(), pair.second, nullptr);
-      }
+      m_views.for_each([&reclaimer] (const DxvkBufferSliceHandle&, VkBufferView view) {
+        reclaimer.destroyBufferView(view);
+      });
     }
   }
   
@@ -275,17 +650,21 @@ namespace dxvk {
   void DxvkBufferView::updateBufferView(
     const DxvkBufferSliceHandle& slice) {
     if (m_info.format != VK_FORMAT_UNDEFINED) {
-      if (m_views.empty())
-        m_views.insert({ m_bufferSlice, m_bufferView });
+      // Views for recycled slices are kept alive, so that
+      // buffers discarded every frame stop creating views
+      // once all slices in their ring have been used once.
+      if (!m_views.size())
+        m_views.emplace(m_bufferSlice, m_bufferView);
 
       m_bufferSlice = slice;
 
-      auto entry = m_views.find(slice);
-      if (entry != m_views.end()) {
-        m_bufferView = entry->second;
+      VkBufferView* view = m_views.find(slice);
+
+      if (view) {
+        m_bufferView = *view;
       } else {
         m_bufferView = createBufferView(m_bufferSlice);
-        m_views.insert({ m_bufferSlice, m_bufferView });
+        m_views.emplace(m_bufferSlice, m_bufferView);
       }
     } else {
       m_bufferSlice = slice;
@@ -297,14 +676,9 @@ namespace dxvk {
   DxvkBufferTracker::~DxvkBufferTracker() { }
   
   
-  void DxvkBufferTracker::reset() {
-    std::sort(m_entries.begin(), m_entries.end(),
-      [] (const Entry& a, const Entry& b) {
-        return a.slice.handle < b.slice.handle;
-      });
-
+  void DxvkBufferTracker::retire(uint64_t sequenceNumber) {
     for (const auto& e : m_entries)
-      e.buffer->freeSlice(e.slice);
+      e.buffer->retireSlice(e.slice, sequenceNumber);
       
     m_entries.clear();
   }
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
+#include "../util/util_flat_map.h"
+
 #include "dxvk_descriptor.h"
 #include "dxvk_format.h"
 #include "dxvk_hash.h"
@@ -76,9 +81,13 @@ namespace dxvk {
    * 
    * Stores a Vulkan buffer handle and the
    * memory object that is bound to the buffer.
+   * Blocks from the uniform heap do not own any
+   * memory and start at a non-zero buffer offset.
    */
   struct DxvkBufferHandle {
     VkBuffer      buffer = VK_NULL_HANDLE;
+    VkDeviceSize  offset = 0;
+    void*         mapPtr = nullptr;
     DxvkMemory    memory;
   };
   
@@ -112,6 +121,73 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Retired buffer slice ring
+   *
+   * Bounded lock-free queue of buffer slices that are no longer
+   * the current backing storage of a buffer, each tagged with the
+   * sequence number of the submission after which the slice can
+   * be reused. Since submissions complete in order and slices are
+   * retired in submission order, only the oldest slice needs to be
+   * checked. Safe to use from multiple producers and consumers.
+   */
+  class DxvkBufferSliceRing {
+
+  public:
+
+    enum class PopResult : uint32_t {
+      Success,
+      Empty,
+      Busy,
+    };
+
+    explicit DxvkBufferSliceRing(
+            uint32_t              capacity);
+
+    ~DxvkBufferSliceRing();
+
+    /**
+     * \brief Adds a retired slice
+     *
+     * \param [in] slice The buffer slice
+     * \param [in] sequenceNumber Submission sequence number
+     * \returns \c false if the ring is full
+     */
+    bool push(
+      const DxvkBufferSliceHandle& slice,
+            uint64_t              sequenceNumber);
+
+    /**
+     * \brief Takes the oldest slice if it is no longer in use
+     *
+     * \param [in] completed Last completed sequence number
+     * \param [out] slice The buffer slice
+     * \returns \c Busy if the oldest slice is still in use
+     */
+    PopResult pop(
+            uint64_t              completed,
+            DxvkBufferSliceHandle& slice);
+
+  private:
+
+    struct Cell {
+      std::atomic<uint64_t> index;
+      std::atomic<uint64_t> sequenceNumber;
+      DxvkBufferSliceHandle slice;
+    };
+
+    uint64_t                m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(CACHE_LINE_SIZE)
+    std::atomic<uint64_t>   m_head = { 0ull };
+
+    alignas(CACHE_LINE_SIZE)
+    std::atomic<uint64_t>   m_tail = { 0ull };
+
+  };
+
+
   /**
    * \brief Virtual buffer resource
    * 
@@ -119,6 +195,8 @@ namespace dxvk {
    * unformatted data. Can be accessed by the host
    * if allocated on an appropriate memory type.
    */
+  class DxvkBufferHeap;
+
   class DxvkBuffer : public DxvkPagedResource {
     friend class DxvkBufferView;
   public:
@@ -266,55 +344,30 @@ namespace dxvk {
     
     /**
      * \brief Allocates new buffer slice
+     *
+     * Reuses retired slices whose last submission has completed
+     * without taking any locks. Only if none are available, a new
+     * backing buffer gets created, with the number of slices per
+     * backing buffer growing geometrically. Buffers that have not
+     * allocated any slices for a while drop their extra backing
+     * buffers on the next allocation.
      * \returns The new buffer slice
      */
-    DxvkBufferSliceHandle allocSlice() {
-      std::unique_lock<sync::Spinlock> freeLock(m_freeMutex);
-      
-      // If no slices are available, swap the two free lists.
-      if (unlikely(m_freeSlices.empty())) {
-        std::unique_lock<sync::Spinlock> swapLock(m_swapMutex);
-        std::swap(m_freeSlices, m_nextSlices);
-      }
-
-      // If there are still no slices available, create a new
-      // backing buffer and add all slices to the free list.
-      if (unlikely(m_freeSlices.empty())) {
-        if (likely(!m_lazyAlloc)) {
-          DxvkBufferHandle handle = allocBuffer(m_physSliceCount, true);
-
-          for (uint32_t i = 0; i < m_physSliceCount; i++)
-            pushSlice(handle, i);
-
-          m_buffers.push_back(std::move(handle));
-          m_physSliceCount = std::min(m_physSliceCount * 2, m_physSliceMaxCount);
-        } else {
-          for (uint32_t i = 1; i < m_physSliceCount; i++)
-            pushSlice(m_buffer, i);
-
-          m_lazyAlloc = false;
-        }
-      }
-      
-      // Take the first slice from the queue
-      DxvkBufferSliceHandle result = m_freeSlices.back();
-      m_freeSlices.pop_back();
-      return result;
-    }
+    DxvkBufferSliceHandle allocSlice();
     
     /**
-     * \brief Frees a buffer slice
+     * \brief Retires a buffer slice
      * 
      * Marks the slice as free so that it can be used for
-     * subsequent allocations. Called automatically when
-     * the slice is no longer needed by the GPU.
-     * \param [in] slice The buffer slice to free
+     * subsequent allocations once the given submission
+     * has completed. Called automatically when a command
+     * list that renamed the buffer gets submitted.
+     * \param [in] slice The buffer slice to retire
+     * \param [in] sequenceNumber Submission sequence number
      */
-    void freeSlice(const DxvkBufferSliceHandle& slice) {
-      // Add slice to a separate free list to reduce lock contention.
-      std::unique_lock<sync::Spinlock> swapLock(m_swapMutex);
-      m_nextSlices.push_back(slice);
-    }
+    void retireSlice(
+      const DxvkBufferSliceHandle& slice,
+            uint64_t              sequenceNumber);
 
     /**
      * \brief Checks whether the buffer is imported
@@ -326,10 +379,20 @@ namespace dxvk {
 
   private:
 
+    constexpr static uint32_t MaxRingCount = 16;
+    constexpr static uint32_t MinRingCapacity = 64;
+
+    struct BackingBuffer {
+      DxvkBufferHandle  handle;
+      VkDeviceSize      sliceCount;
+    };
+
+    DxvkDevice*             m_device;
     Rc<vk::DeviceFn>        m_vkd;
     DxvkBufferCreateInfo    m_info;
     DxvkBufferImportInfo    m_import;
     DxvkMemoryAllocator*    m_memAlloc;
+    DxvkBufferHeap*         m_heap = nullptr;
     VkMemoryPropertyFlags   m_memFlags;
     VkShaderStageFlags      m_shaderStages;
     
@@ -337,6 +400,12 @@ namespace dxvk {
     DxvkBufferSliceHandle   m_physSlice;
     uint32_t                m_vertexStride = 0;
 
+    alignas(CACHE_LINE_SIZE)
+    std::atomic<uint32_t>   m_ringCount = { 0u };
+    std::atomic<uint64_t>   m_lastAllocSequence = { 0ull };
+
+    std::array<std::unique_ptr<DxvkBufferSliceRing>, MaxRingCount> m_rings;
+
     alignas(CACHE_LINE_SIZE)
     sync::Spinlock          m_freeMutex;
 
@@ -344,32 +413,68 @@ namespace dxvk {
     VkDeviceSize            m_physSliceLength   = 0;
     VkDeviceSize            m_physSliceStride   = 0;
     VkDeviceSize            m_physSliceCount    = 1;
+    VkDeviceSize            m_physSliceInitCount = 1;
     VkDeviceSize            m_physSliceMaxCount = 1;
+    VkDeviceSize            m_totalSliceCount   = 1;
 
-    std::vector<DxvkBufferHandle>       m_buffers;
+    std::vector<BackingBuffer>          m_buffers;
     std::vector<DxvkBufferSliceHandle>  m_freeSlices;
 
-    alignas(CACHE_LINE_SIZE)
-    sync::Spinlock                      m_swapMutex;
-    std::vector<DxvkBufferSliceHandle>  m_nextSlices;
-
     void pushSlice(const DxvkBufferHandle& handle, uint32_t index) {
       DxvkBufferSliceHandle slice;
       slice.handle = handle.buffer;
       slice.length = m_physSliceLength;
-      slice.offset = m_physSliceStride * index;
-      slice.mapPtr = handle.memory.mapPtr(slice.offset);
+      slice.offset = handle.offset + m_physSliceStride * index;
+      slice.mapPtr = handle.mapPtr
+        ? reinterpret_cast<char*>(handle.mapPtr) + m_physSliceStride * index
+        : nullptr;
       m_freeSlices.push_back(slice);
     }
 
+    bool ownsSlice(
+      const DxvkBufferHandle&     handle,
+            VkDeviceSize          sliceCount,
+      const DxvkBufferSliceHandle& slice) const {
+      return slice.handle == handle.buffer
+          && slice.offset >= handle.offset
+          && slice.offset <  handle.offset + m_physSliceStride * sliceCount;
+    }
+
+    bool popSlice(
+            uint64_t              completed,
+            DxvkBufferSliceHandle& slice);
+
+    DxvkBufferSliceHandle allocSliceSlow(
+            uint64_t              completed);
+
+    void trimSlices(
+            uint64_t              completed);
+
     DxvkBufferHandle allocBuffer(
             VkDeviceSize          sliceCount,
             bool                  clear) const;
 
+    void freeBuffer(
+      const DxvkBufferHandle&     handle,
+            VkDeviceSize          sliceCount) const;
+
     DxvkBufferHandle createSparseBuffer() const;
 
     VkDeviceSize computeSliceAlignment(
             DxvkDevice*           device) const;
+
+    bool canUseUniformHeap(
+            DxvkDevice*           device,
+            VkDeviceSize          sliceAlignment) const;
+
+    bool canUseVertexHeap(
+            DxvkDevice*           device,
+            VkDeviceSize          sliceAlignment) const;
+
+    bool isHeapCompatible(
+      const DxvkBufferHeap&       heap,
+            VkDeviceSize          sliceAlignment,
+            VkDeviceSize          threshold) const;
     
   };
   
@@ -667,6 +772,20 @@ namespace dxvk {
         m_info.rangeOffset,
         m_info.rangeLength);
     }
+
+    /**
+     * \brief Checks whether the view is backed by a slice
+     *
+     * Equivalent to comparing the slice against \ref slice,
+     * but does not create a temporary buffer reference.
+     * \param [in] slice The buffer slice to check
+     * \returns \c true if the view covers the given slice
+     */
+    bool matchesSlice(const DxvkBufferSlice& slice) const {
+      return slice.buffer() == m_buffer
+          && slice.offset() == m_info.rangeOffset
+          && slice.length() == m_info.rangeLength;
+    }
     
     /**
      * \brief Updates the buffer view
@@ -692,7 +811,7 @@ namespace dxvk {
     DxvkBufferSliceHandle     m_bufferSlice;
     VkBufferView              m_bufferView;
 
-    std::unordered_map<
+    flat_hash_map<
       DxvkBufferSliceHandle,
       VkBufferView,
       DxvkHash, DxvkEq> m_views;
@@ -724,7 +843,7 @@ namespace dxvk {
      * \brief Add buffer slice for tracking
      *
      * The slice will be returned to the
-     * buffer on the next call to \c reset.
+     * buffer on the next call to \c retire.
      * \param [in] buffer The parent buffer
      * \param [in] slice The buffer slice
      */
@@ -734,8 +853,12 @@ namespace dxvk {
     
     /**
      * \brief Returns tracked buffer slices
+     *
+     * The slices can be reused once the submission
+     * with the given sequence number has completed.
+     * \param [in] sequenceNumber Submission sequence number
      */
-    void reset();
+    void retire(uint64_t sequenceNumber);
     
   private:
     
@@ -0,0 +1,218 @@
+#include "dxvk_device.h"
+#include "dxvk_buffer_heap.h"
+
+namespace dxvk {
+
+  constexpr auto BufferHeapGracePeriod = std::chrono::seconds(5);
+
+  DxvkBufferHeap::DxvkBufferHeap(
+          DxvkDevice*           device,
+          VkBufferUsageFlags    usage,
+          VkAccessFlags         access)
+  : m_device(device), m_usage(usage), m_access(access) {
+
+  }
+
+
+  DxvkBufferHeap::~DxvkBufferHeap() {
+
+  }
+
+
+  DxvkBufferHandle DxvkBufferHeap::alloc(
+          VkMemoryPropertyFlags memFlags,
+          VkDeviceSize          size) {
+    uint32_t sizeClass = computeSizeClass(size);
+    VkDeviceSize blockSize = MinBlockSize << sizeClass;
+
+    std::lock_guard lock(m_mutex);
+    Pool& pool = getPool(memFlags);
+
+    DxvkBufferHandle handle;
+
+    if (!pool.freeBlocks[sizeClass].empty()) {
+      Block block = pool.freeBlocks[sizeClass].back();
+      pool.freeBlocks[sizeClass].pop_back();
+
+      pool.pages[block.page].liveBlocks += 1;
+
+      handle.buffer = block.buffer;
+      handle.offset = block.offset;
+      handle.mapPtr = block.mapPtr;
+      return handle;
+    }
+
+    // Carve a new block out of the current page. The rest of a page
+    // that is too small for the block is wasted, but that is at most
+    // one block per page since blocks are small compared to pages.
+    if (pool.pageOffset + blockSize > PageSize) {
+      pool.currentPage = createPage(pool);
+      pool.pageOffset = 0;
+    }
+
+    Page& page = pool.pages[pool.currentPage];
+    page.liveBlocks += 1;
+
+    DxvkBufferSliceHandle slice = page.buffer->getSliceHandle();
+
+    handle.buffer = slice.handle;
+    handle.offset = slice.offset + pool.pageOffset;
+    handle.mapPtr = slice.mapPtr
+      ? reinterpret_cast<char*>(slice.mapPtr) + pool.pageOffset
+      : nullptr;
+
+    pool.pageOffset += blockSize;
+    return handle;
+  }
+
+
+  void DxvkBufferHeap::free(
+          VkMemoryPropertyFlags memFlags,
+    const DxvkBufferHandle&     handle,
+          VkDeviceSize          size) {
+    uint32_t sizeClass = computeSizeClass(size);
+
+    std::lock_guard lock(m_mutex);
+    Pool& pool = getPool(memFlags);
+
+    Block block;
+    block.buffer = handle.buffer;
+    block.offset = handle.offset;
+    block.mapPtr = handle.mapPtr;
+    block.page   = findPage(pool, handle);
+
+    if (block.page == ~0u) {
+      Logger::err("DxvkBufferHeap: Freed block not part of any page");
+      return;
+    }
+
+    Page& page = pool.pages[block.page];
+
+    if (!(--page.liveBlocks))
+      page.idleTime = high_resolution_clock::now();
+
+    pool.freeBlocks[sizeClass].push_back(block);
+  }
+
+
+  void DxvkBufferHeap::trim() {
+    std::lock_guard lock(m_mutex);
+
+    auto now = high_resolution_clock::now();
+
+    for (auto& pool : m_pools) {
+      bool trimmed = false;
+
+      for (uint32_t i = 0; i < pool.pages.size(); i++) {
+        Page& page = pool.pages[i];
+
+        if (page.buffer == nullptr || page.liveBlocks
+         || now - page.idleTime <= BufferHeapGracePeriod)
+          continue;
+
+        // Keep the slot around so that page indices of
+        // blocks from other pages remain valid
+        page.buffer = nullptr;
+        trimmed = true;
+
+        if (pool.currentPage == i) {
+          pool.currentPage = ~0u;
+          pool.pageOffset = PageSize;
+        }
+      }
+
+      if (!trimmed)
+        continue;
+
+      for (auto& blocks : pool.freeBlocks) {
+        for (size_t i = 0; i < blocks.size(); ) {
+          if (pool.pages[blocks[i].page].buffer == nullptr) {
+            blocks[i] = blocks.back();
+            blocks.pop_back();
+          } else {
+            i++;
+          }
+        }
+      }
+    }
+  }
+
+
+  DxvkBufferHeap::Pool& DxvkBufferHeap::getPool(
+          VkMemoryPropertyFlags memFlags) {
+    // There are only ever one or two distinct sets of
+    // memory flags in practice, so a linear search is fine
+    for (auto& pool : m_pools) {
+      if (pool.memFlags == memFlags)
+        return pool;
+    }
+
+    Pool& pool = m_pools.emplace_back();
+    pool.memFlags = memFlags;
+    return pool;
+  }
+
+
+  uint32_t DxvkBufferHeap::createPage(
+          Pool&                 pool) {
+    DxvkBufferCreateInfo info;
+    info.size   = PageSize;
+    info.usage  = m_usage;
+    info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    info.access = m_access
+                | VK_ACCESS_TRANSFER_READ_BIT
+                | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    if (m_usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+      info.stages |= m_device->getShaderPipelineStages();
+
+    if (m_usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+      info.stages |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+
+    // Reuse the slot of a previously trimmed page if possible
+    uint32_t index = 0;
+
+    while (index < pool.pages.size() && pool.pages[index].buffer != nullptr)
+      index++;
+
+    if (index == pool.pages.size())
+      pool.pages.emplace_back();
+
+    Page& page = pool.pages[index];
+    page.buffer = m_device->createBuffer(info, pool.memFlags);
+    page.liveBlocks = 0;
+    page.idleTime = high_resolution_clock::now();
+    return index;
+  }
+
+
+  uint32_t DxvkBufferHeap::findPage(
+          Pool&                 pool,
+    const DxvkBufferHandle&     handle) {
+    for (uint32_t i = 0; i < pool.pages.size(); i++) {
+      if (pool.pages[i].buffer == nullptr)
+        continue;
+
+      DxvkBufferSliceHandle slice = pool.pages[i].buffer->getSliceHandle();
+
+      if (slice.handle == handle.buffer
+       && handle.offset >= slice.offset
+       && handle.offset < slice.offset + PageSize)
+        return i;
+    }
+
+    return ~0u;
+  }
+
+
+  uint32_t DxvkBufferHeap::computeSizeClass(
+          VkDeviceSize          size) {
+    uint32_t sizeClass = 0;
+
+    while ((MinBlockSize << sizeClass) < size)
+      sizeClass += 1;
+
+    return sizeClass;
+  }
+
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_time.h"
+
+#include "dxvk_buffer.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+
+  /**
+   * \brief Shared buffer heap
+   *
+   * Small buffers would normally each get their own Vulkan
+   * buffer and memory binding. The heap instead suballocates
+   * the backing storage of such buffers from a small number
+   * of large Vulkan buffers with fixed usage flags. For uniform
+   * buffers, this means that with dynamic uniform buffer
+   * descriptors, only descriptor offsets change between draws.
+   * For vertex buffers, creating a buffer does not need to
+   * create or bind any Vulkan objects in most cases.
+   *
+   * Blocks are allocated in power-of-two size classes and are
+   * recycled per size class, since buffers tend to allocate
+   * and free blocks of the same few sizes over and over.
+   * Pages without any live blocks are destroyed once they
+   * have not been used for a while.
+   */
+  class DxvkBufferHeap {
+    constexpr static VkDeviceSize PageSize      = 4ull << 20;
+    constexpr static VkDeviceSize MinBlockSize  = 256ull;
+    constexpr static uint32_t     ClassCount    = 11u;
+  public:
+
+    /// Maximum size of a single block, in bytes
+    constexpr static VkDeviceSize MaxBlockSize  = MinBlockSize << (ClassCount - 1);
+
+    /// Alignment of all block offsets, in bytes
+    constexpr static VkDeviceSize BlockAlignment = MinBlockSize;
+
+    DxvkBufferHeap(
+            DxvkDevice*           device,
+            VkBufferUsageFlags    usage,
+            VkAccessFlags         access);
+
+    ~DxvkBufferHeap();
+
+    /**
+     * \brief Queries usage flags of heap pages
+     *
+     * Buffers can only use the heap if their
+     * usage flags are a subset of these.
+     * \returns Buffer usage flags
+     */
+    VkBufferUsageFlags usage() const {
+      return m_usage;
+    }
+
+    /**
+     * \brief Allocates a block
+     *
+     * The returned handle does not own any memory. Its
+     * offset and mapping pointer identify the block within
+     * the given heap buffer.
+     * \param [in] memFlags Memory property flags
+     * \param [in] size Block size, at most \c MaxBlockSize
+     * \returns Buffer handle for the block
+     */
+    DxvkBufferHandle alloc(
+            VkMemoryPropertyFlags memFlags,
+            VkDeviceSize          size);
+
+    /**
+     * \brief Frees a block
+     *
+     * The block must not be in use by the GPU anymore.
+     * \param [in] memFlags Memory property flags
+     * \param [in] handle Buffer handle returned by \ref alloc
+     * \param [in] size Block size as passed to \ref alloc
+     */
+    void free(
+            VkMemoryPropertyFlags memFlags,
+      const DxvkBufferHandle&     handle,
+            VkDeviceSize          size);
+
+    /**
+     * \brief Destroys idle pages
+     *
+     * Called once per frame, destroys all pages that have
+     * had no live blocks for longer than the grace period.
+     * Free blocks of those pages are discarded.
+     */
+    void trim();
+
+  private:
+
+    struct Block {
+      VkBuffer      buffer;
+      VkDeviceSize  offset;
+      void*         mapPtr;
+      uint32_t      page;
+    };
+
+    struct Page {
+      Rc<DxvkBuffer>    buffer;
+      uint32_t          liveBlocks = 0;
+      high_resolution_clock::time_point idleTime;
+    };
+
+    struct Pool {
+      VkMemoryPropertyFlags memFlags = 0;
+      std::vector<Page> pages;
+      uint32_t currentPage = ~0u;
+      VkDeviceSize pageOffset = PageSize;
+      std::array<std::vector<Block>, ClassCount> freeBlocks;
+    };
+
+    DxvkDevice*           m_device;
+    VkBufferUsageFlags    m_usage;
+    VkAccessFlags         m_access;
+
+    dxvk::mutex           m_mutex;
+    std::vector<Pool>     m_pools;
+
+    Pool& getPool(
+            VkMemoryPropertyFlags memFlags);
+
+    uint32_t createPage(
+            Pool&                 pool);
+
+    uint32_t findPage(
+            Pool&                 pool,
+      const DxvkBufferHandle&     handle);
+
+    static uint32_t computeSizeClass(
+            VkDeviceSize          size);
+
+  };
+
+}
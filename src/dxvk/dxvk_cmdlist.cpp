@@ -108,7 +108,10 @@ namespace dxvk {
   : m_device(device) {
     auto vk = m_device->vkd();
 
+    // Command buffers are only ever recorded and submitted once
+    // before the entire pool gets reset, so they are short-lived
     VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
     poolInfo.queueFamilyIndex = queueFamily;
 
     if (vk->vkCreateCommandPool(vk->device(), &poolInfo, nullptr, &m_commandPool))
@@ -155,14 +158,47 @@ namespace dxvk {
   }
 
 
+  VkCommandBuffer DxvkCommandPool::getSecondaryCommandBuffer(
+    const VkCommandBufferInheritanceInfo& inheritanceInfo) {
+    auto vk = m_device->vkd();
+
+    if (m_nextSecondary == m_secondaryBuffers.size()) {
+      VkCommandBufferAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+      allocInfo.commandPool = m_commandPool;
+      allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+      allocInfo.commandBufferCount = 1;
+
+      VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+      if (vk->vkAllocateCommandBuffers(vk->device(), &allocInfo, &commandBuffer))
+        throw DxvkError("DxvkCommandPool: Failed to allocate secondary command buffer");
+
+      m_secondaryBuffers.push_back(commandBuffer);
+    }
+
+    VkCommandBuffer commandBuffer = m_secondaryBuffers[m_nextSecondary++];
+
+    VkCommandBufferBeginInfo info = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+               | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    info.pInheritanceInfo = &inheritanceInfo;
+
+    if (vk->vkBeginCommandBuffer(commandBuffer, &info))
+      throw DxvkError("DxvkCommandPool: Failed to begin secondary command buffer");
+
+    return commandBuffer;
+  }
+
+
   void DxvkCommandPool::reset() {
     auto vk = m_device->vkd();
 
-    if (m_next) {
+    if (m_next || m_nextSecondary) {
       if (vk->vkResetCommandPool(vk->device(), m_commandPool, 0))
         throw DxvkError("DxvkCommandPool: Failed to reset command pool");
 
       m_next = 0;
+      m_nextSecondary = 0;
     }
   }
 
@@ -358,6 +394,22 @@ namespace dxvk {
   }
 
   
+  void DxvkCommandList::beginSecondaryCommandBuffer(
+    const VkCommandBufferInheritanceInfo& inheritanceInfo) {
+    m_primaryExecBuffer = m_cmd.execBuffer;
+    m_cmd.execBuffer = m_graphicsPool->getSecondaryCommandBuffer(inheritanceInfo);
+  }
+
+
+  VkCommandBuffer DxvkCommandList::endSecondaryCommandBuffer() {
+    VkCommandBuffer secondary = m_cmd.execBuffer;
+    this->endCommandBuffer(secondary);
+
+    m_cmd.execBuffer = std::exchange(m_primaryExecBuffer, VK_NULL_HANDLE);
+    return secondary;
+  }
+
+  
   VkResult DxvkCommandList::synchronizeFence() {
     return m_vkd->vkWaitForFences(m_vkd->device(), 1, &m_fence, VK_TRUE, ~0ull);
   }
@@ -368,9 +420,6 @@ namespace dxvk {
     // that are no longer in use
     m_resources.reset();
 
-    // Return buffer memory slices
-    m_bufferTracker.reset();
-
     // Return query and event handles
     m_gpuQueryTracker.reset();
     m_gpuEventTracker.reset();
@@ -164,6 +164,15 @@ namespace dxvk {
      */
     VkCommandBuffer getCommandBuffer();
 
+    /**
+     * \brief Retrieves or allocates a secondary command buffer
+     *
+     * \param [in] inheritanceInfo Inheritance info
+     * \returns New secondary command buffer in begun state
+     */
+    VkCommandBuffer getSecondaryCommandBuffer(
+      const VkCommandBufferInheritanceInfo& inheritanceInfo);
+
     /**
      * \brief Resets command pool and all command buffers
      */
@@ -177,6 +186,9 @@ namespace dxvk {
     std::vector<VkCommandBuffer>  m_commandBuffers;
     size_t                        m_next        = 0;
 
+    std::vector<VkCommandBuffer>  m_secondaryBuffers;
+    size_t                        m_nextSecondary = 0;
+
   };
 
 
@@ -248,6 +260,58 @@ namespace dxvk {
      * to split the command list into multiple submissions.
      */
     void next();
+
+    /**
+     * \brief Checks whether any commands have been recorded
+     *
+     * Only considers the current set of command buffers,
+     * i.e. commands recorded since the last call to \ref next.
+     * \returns \c true if any command buffer has been used
+     */
+    bool hasPendingCommands() const {
+      return m_cmd.usedFlags != 0;
+    }
+
+    /**
+     * \brief Begins recording a secondary command buffer
+     *
+     * Redirects all commands that would be recorded into the exec
+     * buffer to a secondary command buffer that continues a render
+     * pass instance, until \ref endSecondaryCommandBuffer is called.
+     * \param [in] inheritanceInfo Inheritance info
+     */
+    void beginSecondaryCommandBuffer(
+      const VkCommandBufferInheritanceInfo& inheritanceInfo);
+
+    /**
+     * \brief Ends recording a secondary command buffer
+     *
+     * Subsequent commands will be recorded into the
+     * primary exec buffer again.
+     * \returns The secondary command buffer
+     */
+    VkCommandBuffer endSecondaryCommandBuffer();
+
+    /**
+     * \brief Begins a new resource tracking scope
+     *
+     * Resources tracked from now on can be identified
+     * with \ref isTrackedInScope.
+     */
+    void beginTrackingScope() {
+      m_resources.beginScope();
+    }
+
+    /**
+     * \brief Checks whether a resource was tracked in the current scope
+     *
+     * \param [in] rc The resource to check
+     * \returns \c true if the resource was used in the current scope
+     */
+    template<typename T>
+    bool isTrackedInScope(const Rc<T>& rc) const {
+      return m_resources.isTrackedInScope(rc.ptr());
+    }
     
     /**
      * \brief Frees buffer slice
@@ -263,6 +327,18 @@ namespace dxvk {
       const DxvkBufferSliceHandle&    slice) {
       m_bufferTracker.freeBufferSlice(buffer, slice);
     }
+
+    /**
+     * \brief Retires buffer slices
+     *
+     * Returns all slices freed in this command list to their
+     * buffers. Called when the command list gets submitted.
+     * \param [in] sequenceNumber Submission sequence number
+     */
+    void retireBufferSlices(
+            uint64_t                  sequenceNumber) {
+      m_bufferTracker.retire(sequenceNumber);
+    }
     
     /**
      * \brief Adds a resource to track
@@ -270,10 +346,14 @@ namespace dxvk {
      * Adds a resource to the internal resource tracker.
      * Resources will be kept alive and "in use" until
      * the device can guarantee that the submission has
-     * completed.
+     * completed. Tracking a paged resource for write
+     * access increments its write sequence number.
      */
     template<DxvkAccess Access, typename T>
     void trackResource(const Rc<T>& rc) {
+      if constexpr (Access == DxvkAccess::Write && std::is_base_of_v<DxvkPagedResource, T>)
+        rc->markWritten();
+
       m_resources.trackResource<Access>(rc.ptr());
     }
     
@@ -415,6 +495,15 @@ namespace dxvk {
     }
 
 
+    void cmdBeginConditionalRendering(
+      const VkConditionalRenderingBeginInfoEXT* pConditionalRenderingBegin) {
+      m_cmd.usedFlags.set(DxvkCmdBuffer::ExecBuffer);
+
+      m_vkd->vkCmdBeginConditionalRenderingEXT(
+        m_cmd.execBuffer, pConditionalRenderingBegin);
+    }
+
+
     void cmdBeginRendering(
       const VkRenderingInfo*        pRenderingInfo) {
       m_cmd.usedFlags.set(DxvkCmdBuffer::ExecBuffer);
@@ -445,6 +534,14 @@ namespace dxvk {
     }
     
     
+    void cmdBindDescriptorBuffers(
+            uint32_t                  bufferCount,
+      const VkDescriptorBufferBindingInfoEXT* bindingInfos) {
+      m_vkd->vkCmdBindDescriptorBuffersEXT(m_cmd.execBuffer,
+        bufferCount, bindingInfos);
+    }
+
+
     void cmdBindDescriptorSets(
             VkPipelineBindPoint       pipeline,
             VkPipelineLayout          pipelineLayout,
@@ -459,6 +556,19 @@ namespace dxvk {
     }
 
 
+    void cmdSetDescriptorBufferOffsets(
+            VkPipelineBindPoint       pipeline,
+            VkPipelineLayout          pipelineLayout,
+            uint32_t                  firstSet,
+            uint32_t                  setCount,
+      const uint32_t*                 bufferIndices,
+      const VkDeviceSize*             offsets) {
+      m_vkd->vkCmdSetDescriptorBufferOffsetsEXT(m_cmd.execBuffer,
+        pipeline, pipelineLayout, firstSet, setCount,
+        bufferIndices, offsets);
+    }
+
+
     void cmdBindIndexBuffer(
             VkBuffer                buffer,
             VkDeviceSize            offset,
@@ -722,11 +832,28 @@ namespace dxvk {
     }
     
     
+    void cmdExecuteCommands(
+            uint32_t                commandBufferCount,
+      const VkCommandBuffer*        pCommandBuffers) {
+      m_cmd.usedFlags.set(DxvkCmdBuffer::ExecBuffer);
+
+      m_vkd->vkCmdExecuteCommands(m_cmd.execBuffer,
+        commandBufferCount, pCommandBuffers);
+    }
+
+
     void cmdEndRendering() {
       m_vkd->vkCmdEndRendering(m_cmd.execBuffer);
     }
 
     
+    void cmdEndConditionalRendering() {
+      m_cmd.usedFlags.set(DxvkCmdBuffer::ExecBuffer);
+
+      m_vkd->vkCmdEndConditionalRenderingEXT(m_cmd.execBuffer);
+    }
+
+
     void cmdEndTransformFeedback(
             uint32_t                  firstBuffer,
             uint32_t                  bufferCount,
@@ -800,7 +927,18 @@ namespace dxvk {
     void cmdSetBlendConstants(const float blendConstants[4]) {
       m_vkd->vkCmdSetBlendConstants(m_cmd.execBuffer, blendConstants);
     }
-    
+
+
+    void cmdSetBlendState(
+            uint32_t                attachmentCount,
+      const VkBool32*               blendEnables,
+      const VkColorBlendEquationEXT* blendEquations) {
+      m_vkd->vkCmdSetColorBlendEnableEXT(m_cmd.execBuffer,
+        0, attachmentCount, blendEnables);
+      m_vkd->vkCmdSetColorBlendEquationEXT(m_cmd.execBuffer,
+        0, attachmentCount, blendEquations);
+    }
+
 
     void cmdSetDepthBiasState(
             VkBool32                depthBiasEnable) {
@@ -1026,6 +1164,7 @@ namespace dxvk {
     VkFence                   m_fence         = VK_NULL_HANDLE;
 
     DxvkCommandSubmissionInfo m_cmd;
+    VkCommandBuffer           m_primaryExecBuffer = VK_NULL_HANDLE;
 
     vk::PresenterSync         m_wsiSemaphores = { };
 
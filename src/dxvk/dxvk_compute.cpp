@@ -103,6 +103,7 @@ namespace dxvk {
   VkPipeline DxvkComputePipeline::createPipeline(
     const DxvkComputePipelineStateInfo& state) const {
     auto vk = m_device->vkd();
+    auto t0 = high_resolution_clock::now();
 
     DxvkPipelineSpecConstantState scState(m_shaders.cs->getSpecConstantMask(), state.sc);
     
@@ -111,11 +112,17 @@ namespace dxvk {
       m_shaders.cs->getCode(m_bindings, DxvkShaderModuleCreateInfo()),
       &scState.scInfo);
 
+    if (!stageInfo.isValid())
+      return VK_NULL_HANDLE;
+
     VkComputePipelineCreateInfo info = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
     info.stage                = *stageInfo.getStageInfos();
     info.layout               = m_bindings->getPipelineLayout(false);
     info.basePipelineIndex    = -1;
 
+    if (m_device->canUseDescriptorBuffer())
+      info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
     VkPipeline pipeline = VK_NULL_HANDLE;
     VkResult vr = vk->vkCreateComputePipelines(vk->device(),
           VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
@@ -126,6 +133,8 @@ namespace dxvk {
       return VK_NULL_HANDLE;
     }
 
+    const DxvkShader* shader = m_shaders.cs.ptr();
+    m_stats->addCompileTime(DxvkPipelineCompileType::Compute, 1, &shader, t0);
     return pipeline;
   }
 
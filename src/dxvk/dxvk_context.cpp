@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <vector>
 #include <utility>
@@ -5,6 +6,8 @@
 #include "dxvk_device.h"
 #include "dxvk_context.h"
 
+#include "../util/util_time.h"
+
 namespace dxvk {
   
   DxvkContext::DxvkContext(const Rc<DxvkDevice>& device, DxvkContextType type)
@@ -17,7 +20,8 @@ namespace dxvk {
     m_execAcquires(DxvkCmdBuffer::ExecBuffer),
     m_execBarriers(DxvkCmdBuffer::ExecBuffer),
     m_queryManager(m_common->queryPool()),
-    m_staging     (device, StagingBufferSize) {
+    m_staging     (device, StagingBufferSize),
+    m_descriptorHeap(device, DescriptorHeapSize) {
     // Init framebuffer info with default render pass in case
     // the app does not explicitly bind any render targets
     m_state.om.framebufferInfo = makeFramebufferInfo(m_state.om.renderTargets);
@@ -61,6 +65,27 @@ namespace dxvk {
     // requested rasterizer sample count changes
     if (m_device->features().core.features.variableMultisampleRate)
       m_features.set(DxvkContextFeature::VariableMultisampleRate);
+
+    // Skipping draws is opt-in since it causes visible artifacts
+    if (m_device->config().enableAsyncPipelines)
+      m_features.set(DxvkContextFeature::AsyncPipelineCompile);
+
+    // Debug labels cannot span multiple command buffers,
+    // so don't use secondary command buffers in that case
+    if (m_device->config().enableRenderPassResolve
+     && !m_device->instance()->extensions().extDebugUtils)
+      m_features.set(DxvkContextFeature::RenderPassResolve);
+
+    // Dynamic blend state allows pipelines that only differ in blend
+    // modes to share the same Vulkan pipeline, so use it if possible
+    if (m_device->features().extExtendedDynamicState3.extendedDynamicState3ColorBlendEnable
+     && m_device->features().extExtendedDynamicState3.extendedDynamicState3ColorBlendEquation)
+      m_features.set(DxvkContextFeature::DynamicBlendState);
+
+    // Images are created in the general layout in this case,
+    // so render to them in that layout as well
+    if (m_device->config().useGeneralLayout)
+      m_features.set(DxvkContextFeature::GeneralLayout);
   }
   
   
@@ -76,13 +101,46 @@ namespace dxvk {
     if (m_descriptorPool == nullptr)
       m_descriptorPool = m_descriptorManager->getDescriptorPool();
 
+    // Resources referenced by cached sets are only guaranteed
+    // to stay alive while the previous command list is in use
+    m_descriptorPool->resetSetCache();
+
+    // Pipelines may have been invalidated by shader overrides,
+    // and all state gets re-applied for the new command list
+    uint32_t invalidations = m_common->pipelineManager().getInvalidationCount();
+
+    if (unlikely(invalidations != m_lookupCacheInvalidations)) {
+      m_gpLookupCache.fill(nullptr);
+      m_cpLookupCache.fill(nullptr);
+
+      m_lookupCacheInvalidations = invalidations;
+    }
+
     this->beginCurrentCommands();
+
+    if (unlikely(m_device->tracer())) {
+      m_traceQuery = m_device->createGpuQuery(VK_QUERY_TYPE_TIMESTAMP, 0, 0);
+      this->writeTimestamp(m_traceQuery);
+    }
   }
   
   
   Rc<DxvkCommandList> DxvkContext::endRecording() {
     this->endCurrentCommands();
 
+    m_queryManager.flushReadbacks(m_cmd);
+
+    if (unlikely(m_passQuery != nullptr))
+      this->endProfiledPass();
+
+    if (unlikely(m_traceQuery != nullptr)) {
+      Rc<DxvkGpuQuery> endQuery = m_device->createGpuQuery(VK_QUERY_TYPE_TIMESTAMP, 0, 0);
+      this->writeTimestamp(endQuery);
+
+      m_device->tracer()->addGpuZone("Command list",
+        std::exchange(m_traceQuery, nullptr), endQuery);
+    }
+
     if (m_descriptorPool->shouldSubmit(false)) {
       m_cmd->trackDescriptorPool(m_descriptorPool, m_descriptorManager);
       m_descriptorPool = m_descriptorManager->getDescriptorPool();
@@ -120,6 +178,30 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::bindXfbBuffer(
+          uint32_t              binding,
+          DxvkBufferSlice&&     buffer,
+          DxvkBufferSlice&&     counter,
+          bool                  resetCounter) {
+    // End transform feedback with the old counters bound
+    // so that their values get written back correctly.
+    this->pauseTransformFeedback();
+
+    // If the previous counter was never used, write the
+    // reset value so that it can be read back or drawn.
+    if (unlikely(m_state.xfb.counterResetMask & (1u << binding)))
+      this->resolveXfbCounterResets(1u << binding);
+
+    m_state.xfb.buffers [binding] = std::move(buffer);
+    m_state.xfb.counters[binding] = std::move(counter);
+
+    if (resetCounter && m_state.xfb.counters[binding].defined())
+      m_state.xfb.counterResetMask |= 1u << binding;
+
+    m_flags.set(DxvkContextFlag::GpDirtyXfbBuffers);
+  }
+
+
   void DxvkContext::blitImage(
     const Rc<DxvkImage>&        dstImage,
     const VkComponentMapping&   dstMapping,
@@ -379,10 +461,44 @@ namespace dxvk {
         util::invertComponentMapping(imageView->info().swizzle));
     }
     
-    if (viewUsage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
-      this->clearImageViewFb(imageView, offset, extent, aspect, value);
-    else if (viewUsage & VK_IMAGE_USAGE_STORAGE_BIT)
+    if (viewUsage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+      VkRect2D rect;
+      rect.offset = { offset.x, offset.y };
+      rect.extent = { extent.width, extent.height };
+
+      this->clearImageViewFb(imageView, 1, &rect, aspect, value);
+    } else if (viewUsage & VK_IMAGE_USAGE_STORAGE_BIT) {
       this->clearImageViewCs(imageView, offset, extent, value);
+    }
+  }
+
+
+  void DxvkContext::clearImageViewRects(
+    const Rc<DxvkImageView>&    imageView,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
+          VkImageAspectFlags    aspect,
+          VkClearValue          value) {
+    const VkImageUsageFlags viewUsage = imageView->info().usage;
+
+    if (!rectCount)
+      return;
+
+    if (viewUsage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+      if (aspect & VK_IMAGE_ASPECT_COLOR_BIT) {
+        value.color = util::swizzleClearColor(value.color,
+          util::invertComponentMapping(imageView->info().swizzle));
+      }
+
+      this->clearImageViewFb(imageView, rectCount, rects, aspect, value);
+    } else {
+      for (uint32_t i = 0; i < rectCount; i++) {
+        this->clearImageView(imageView,
+          VkOffset3D { rects[i].offset.x, rects[i].offset.y, 0 },
+          VkExtent3D { rects[i].extent.width, rects[i].extent.height, 1u },
+          aspect, value);
+      }
+    }
   }
   
   
@@ -500,7 +616,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isBufferDirty(srcSlice, DxvkAccess::Read))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr() });
 
     // Initialize the image if the entire subresource is covered
     VkImageLayout dstImageLayoutInitial  = dstImage->info().layout;
@@ -560,15 +676,7 @@ namespace dxvk {
     this->prepareImage(dstImage, vk::makeSubresourceRange(dstSubresource));
     this->prepareImage(srcImage, vk::makeSubresourceRange(srcSubresource));
 
-    bool useFb = dstSubresource.aspectMask != srcSubresource.aspectMask;
-
-    if (m_device->perfHints().preferFbDepthStencilCopy) {
-      useFb |= (dstSubresource.aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
-            && (dstImage->info().usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
-            && (srcImage->info().usage & VK_IMAGE_USAGE_SAMPLED_BIT);
-    }
-
-    if (!useFb) {
+    if (!this->useFbForImageCopy(dstImage, dstSubresource, srcImage, srcSubresource)) {
       this->copyImageHw(
         dstImage, dstSubresource, dstOffset,
         srcImage, srcSubresource, srcOffset,
@@ -582,6 +690,196 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::copyImageBatch(
+    const Rc<DxvkImage>&        dstImage,
+          uint32_t              regionCount,
+    const DxvkImageCopyRegion*  regions) {
+    this->spillRenderPass(true);
+
+    // Regions that need special treatment go through the regular
+    // copy path, everything else is recorded with one barrier
+    // batch and one copy command per source image.
+    small_vector<const DxvkImageCopyRegion*, 64> hwRegions;
+
+    for (uint32_t i = 0; i < regionCount; i++) {
+      const auto& region = regions[i];
+
+      if (region.srcImage == dstImage
+       || this->useFbForImageCopy(dstImage, region.dstSubresource, region.srcImage, region.srcSubresource)) {
+        this->copyImage(
+          dstImage, region.dstSubresource, region.dstOffset,
+          region.srcImage, region.srcSubresource, region.srcOffset,
+          region.extent);
+      } else if (!this->copyImageClear(dstImage, region.dstSubresource, region.dstOffset,
+          region.extent, region.srcImage, region.srcSubresource)) {
+        hwRegions.push_back(&region);
+      }
+    }
+
+    if (hwRegions.empty())
+      return;
+
+    // Compute the subresources touched in each image, so that
+    // each image is only transitioned once for the entire batch
+    struct SrcImageInfo {
+      Rc<DxvkImage>           image;
+      VkImageSubresourceRange range;
+    };
+
+    small_vector<SrcImageInfo, 16> srcImages;
+
+    auto dstRange = vk::makeSubresourceRange(hwRegions[0]->dstSubresource);
+
+    for (size_t i = 0; i < hwRegions.size(); i++) {
+      const DxvkImageCopyRegion* region = hwRegions[i];
+
+      auto regionDstRange = vk::makeSubresourceRange(region->dstSubresource);
+      auto regionSrcRange = vk::makeSubresourceRange(region->srcSubresource);
+
+      this->prepareImage(dstImage, regionDstRange);
+      this->prepareImage(region->srcImage, regionSrcRange);
+
+      dstRange = vk::unionSubresourceRange(dstRange, regionDstRange);
+
+      bool found = false;
+
+      for (size_t j = 0; j < srcImages.size(); j++) {
+        SrcImageInfo& src = srcImages[j];
+
+        if (src.image == region->srcImage) {
+          src.range = vk::unionSubresourceRange(src.range, regionSrcRange);
+          found = true;
+          break;
+        }
+      }
+
+      if (!found)
+        srcImages.push_back({ region->srcImage, regionSrcRange });
+    }
+
+    bool dirty = m_execBarriers.isImageDirty(dstImage, dstRange, DxvkAccess::Write);
+
+    for (size_t i = 0; i < srcImages.size() && !dirty; i++)
+      dirty = m_execBarriers.isImageDirty(srcImages[i].image, srcImages[i].range, DxvkAccess::Write);
+
+    if (dirty) {
+      bool canMerge = !m_execBarriers.hasImageBarriers(dstImage->handle());
+
+      for (size_t i = 0; i < srcImages.size() && canMerge; i++)
+        canMerge = !m_execBarriers.hasImageBarriers(srcImages[i].image->handle());
+
+      if (canMerge)
+        m_execAcquires.merge(m_execBarriers);
+      else
+        m_execBarriers.recordCommands(m_cmd);
+    }
+
+    VkImageLayout dstImageLayout = dstImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    if (dstImageLayout != dstImage->info().layout) {
+      m_execAcquires.accessImage(
+        dstImage, dstRange,
+        dstImage->info().layout,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        dstImageLayout,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT);
+    }
+
+    for (size_t i = 0; i < srcImages.size(); i++) {
+      const SrcImageInfo& src = srcImages[i];
+      VkImageLayout srcImageLayout = src.image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+      if (srcImageLayout != src.image->info().layout) {
+        m_execAcquires.accessImage(
+          src.image, src.range,
+          src.image->info().layout,
+          VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+          srcImageLayout,
+          VK_PIPELINE_STAGE_TRANSFER_BIT,
+          VK_ACCESS_TRANSFER_READ_BIT);
+      }
+    }
+
+    m_execAcquires.recordCommands(m_cmd);
+
+    auto dstFormatInfo = dstImage->formatInfo();
+
+    for (size_t i = 0; i < srcImages.size(); i++) {
+      const SrcImageInfo& src = srcImages[i];
+      small_vector<VkImageCopy2, 64> copyRegions;
+
+      for (size_t j = 0; j < hwRegions.size(); j++) {
+        const DxvkImageCopyRegion* region = hwRegions[j];
+
+        if (region->srcImage != src.image)
+          continue;
+
+        for (auto aspects = region->dstSubresource.aspectMask; aspects; ) {
+          auto aspect = vk::getNextAspect(aspects);
+
+          VkImageCopy2 copyRegion = { VK_STRUCTURE_TYPE_IMAGE_COPY_2 };
+          copyRegion.srcSubresource = region->srcSubresource;
+          copyRegion.srcSubresource.aspectMask = aspect;
+          copyRegion.srcOffset = region->srcOffset;
+          copyRegion.dstSubresource = region->dstSubresource;
+          copyRegion.dstSubresource.aspectMask = aspect;
+          copyRegion.dstOffset = region->dstOffset;
+          copyRegion.extent = region->extent;
+
+          if (dstFormatInfo->flags.test(DxvkFormatFlag::MultiPlane)) {
+            auto plane = &dstFormatInfo->planes[vk::getPlaneIndex(aspect)];
+            copyRegion.srcOffset.x /= plane->blockSize.width;
+            copyRegion.srcOffset.y /= plane->blockSize.height;
+            copyRegion.dstOffset.x /= plane->blockSize.width;
+            copyRegion.dstOffset.y /= plane->blockSize.height;
+            copyRegion.extent.width /= plane->blockSize.width;
+            copyRegion.extent.height /= plane->blockSize.height;
+          }
+
+          copyRegions.push_back(copyRegion);
+        }
+      }
+
+      VkCopyImageInfo2 copyInfo = { VK_STRUCTURE_TYPE_COPY_IMAGE_INFO_2 };
+      copyInfo.srcImage = src.image->handle();
+      copyInfo.srcImageLayout = src.image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+      copyInfo.dstImage = dstImage->handle();
+      copyInfo.dstImageLayout = dstImageLayout;
+      copyInfo.regionCount = copyRegions.size();
+      copyInfo.pRegions = copyRegions.data();
+
+      m_cmd->cmdCopyImage(DxvkCmdBuffer::ExecBuffer, &copyInfo);
+    }
+
+    m_execBarriers.accessImage(
+      dstImage, dstRange,
+      dstImageLayout,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      dstImage->info().layout,
+      dstImage->info().stages,
+      dstImage->info().access);
+
+    m_cmd->trackResource<DxvkAccess::Write>(dstImage);
+
+    for (size_t i = 0; i < srcImages.size(); i++) {
+      const SrcImageInfo& src = srcImages[i];
+
+      m_execBarriers.accessImage(
+        src.image, src.range,
+        src.image->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL),
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT,
+        src.image->info().layout,
+        src.image->info().stages,
+        src.image->info().access);
+
+      m_cmd->trackResource<DxvkAccess::Read>(src.image);
+    }
+  }
+
+
   void DxvkContext::copyImageRegion(
     const Rc<DxvkImage>&        dstImage,
           VkImageSubresourceLayers dstSubresource,
@@ -671,7 +969,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isBufferDirty(dstSlice, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ srcImage.ptr() });
 
     // Select a suitable image layout for the transfer op
     VkImageLayout srcImageLayoutTransfer = srcImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
@@ -722,6 +1020,22 @@ namespace dxvk {
     this->spillRenderPass(true);
     this->prepareImage(srcImage, vk::makeSubresourceRange(srcSubresource));
 
+    // If the exact same pack operation has been performed before
+    // and neither resource has been written since, the buffer
+    // still holds the correct data and we can skip the copy.
+    bool usePackCache = m_device->config().cachePackedDepthStencil;
+
+    DxvkImagePackedCopy packedCopy = { };
+    packedCopy.subresource = srcSubresource;
+    packedCopy.srcOffset   = srcOffset;
+    packedCopy.srcExtent   = srcExtent;
+    packedCopy.dstOffset   = dstOffset;
+    packedCopy.dstExtent   = dstExtent;
+    packedCopy.format      = format;
+
+    if (usePackCache && this->findPackedCopy(dstBuffer, dstBufferOffset, srcImage, packedCopy))
+      return;
+
     this->invalidateState();
 
     // Retrieve compute pipeline for the given format
@@ -763,7 +1077,7 @@ namespace dxvk {
     auto subresourceRange = vk::makeSubresourceRange(srcSubresource);
 
     if (m_execBarriers.isImageDirty(srcImage, subresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ srcImage.ptr() });
     
     if (srcImage->info().layout != layout) {
       m_execAcquires.accessImage(
@@ -773,10 +1087,10 @@ namespace dxvk {
         layout,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         VK_ACCESS_SHADER_READ_BIT);
-      
-      m_execAcquires.recordCommands(m_cmd);
     }
 
+    m_execAcquires.recordCommands(m_cmd);
+
     // Execute the actual pack operation
     DxvkMetaPackArgs args;
     args.srcOffset = srcOffset;
@@ -823,6 +1137,9 @@ namespace dxvk {
 
     m_cmd->trackResource<DxvkAccess::Write>(dstBuffer);
     m_cmd->trackResource<DxvkAccess::Read>(srcImage);
+
+    if (usePackCache)
+      this->addPackedCopy(dstBuffer, dstBufferOffset, srcImage, packedCopy);
   }
   
   
@@ -1245,6 +1562,9 @@ namespace dxvk {
       this->commitComputeBarriers<false>();
       this->commitComputeBarriers<true>();
 
+      if (unlikely(m_device->gpuProfiler().isEnabled()) && m_passQuery == nullptr)
+        this->beginProfiledPass("Compute");
+
       m_queryManager.beginQueries(m_cmd,
         VK_QUERY_TYPE_PIPELINE_STATISTICS);
       
@@ -1270,6 +1590,9 @@ namespace dxvk {
       this->commitComputeBarriers<false>();
       this->commitComputeBarriers<true>();
 
+      if (unlikely(m_device->gpuProfiler().isEnabled()) && m_passQuery == nullptr)
+        this->beginProfiledPass("Compute");
+
       m_queryManager.beginQueries(m_cmd,
         VK_QUERY_TYPE_PIPELINE_STATISTICS);
       
@@ -1405,6 +1728,10 @@ namespace dxvk {
     const DxvkBufferSlice&  counterBuffer,
           uint32_t          counterDivisor,
           uint32_t          counterBias) {
+    // Counters with a pending reset have not been written yet
+    if (unlikely(m_state.xfb.counterResetMask))
+      this->resolveXfbCounterResets(m_state.xfb.counterResetMask);
+
     if (this->commitGraphicsState<false, false>()) {
       auto physSlice = counterBuffer.getSliceHandle();
 
@@ -1423,13 +1750,18 @@ namespace dxvk {
     const Rc<DxvkBuffer>&           buffer) {
     auto slice = buffer->getSliceHandle();
 
-    m_cmd->cmdFillBuffer(DxvkCmdBuffer::InitBuffer,
+    // Buffer fills are supported on transfer queues, so clear the
+    // buffer there in order to not stall any graphics work
+    m_cmd->cmdFillBuffer(DxvkCmdBuffer::SdmaBuffer,
       slice.handle, slice.offset,
       dxvk::align(slice.length, 4), 0);
 
-    m_initBarriers.accessBuffer(slice,
+    m_sdmaBarriers.releaseBuffer(
+      m_initBarriers, slice,
+      m_device->queues().transfer.queueFamily,
       VK_PIPELINE_STAGE_TRANSFER_BIT,
       VK_ACCESS_TRANSFER_WRITE_BIT,
+      m_device->queues().graphics.queueFamily,
       buffer->info().stages,
       buffer->info().access);
 
@@ -1662,6 +1994,11 @@ namespace dxvk {
           VkFilter                  filter) {
     if (imageView->info().numLevels <= 1)
       return;
+
+    if (this->canGenerateMipmapsCompute(imageView, filter)) {
+      this->generateMipmapsCompute(imageView, filter);
+      return;
+    }
     
     this->spillRenderPass(false);
     this->invalidateState();
@@ -1670,7 +2007,7 @@ namespace dxvk {
     Rc<DxvkMetaMipGenRenderPass> mipGenerator = new DxvkMetaMipGenRenderPass(m_device->vkd(), imageView);
     
     if (m_execBarriers.isImageDirty(imageView->image(), imageView->imageSubresources(), DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ imageView->image().ptr() });
 
     VkImageLayout dstLayout = imageView->pickLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
     VkImageLayout srcLayout = imageView->pickLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
@@ -1771,6 +2108,9 @@ namespace dxvk {
         m_execAcquires.recordCommands(m_cmd);
       }
 
+      if (unlikely(m_device->gpuProfiler().isEnabled()))
+        this->beginProfiledPass("Render pass");
+
       m_cmd->cmdBeginRendering(&renderingInfo);
       m_cmd->cmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeInfo.pipeHandle);
       m_cmd->cmdBindDescriptorSet(VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -1827,6 +2167,187 @@ namespace dxvk {
     m_cmd->trackResource<DxvkAccess::None>(mipGenerator);
     m_cmd->trackResource<DxvkAccess::Write>(imageView->image());
   }
+
+
+  bool DxvkContext::canGenerateMipmapsCompute(
+    const Rc<DxvkImageView>&    imageView,
+          VkFilter              filter) const {
+    // The compute shader averages texels in shared memory,
+    // which is only equivalent to bilinear filtering
+    if (filter != VK_FILTER_LINEAR)
+      return false;
+
+    const DxvkImageCreateInfo& imageInfo = imageView->imageInfo();
+
+    if (imageInfo.type != VK_IMAGE_TYPE_2D
+     || imageInfo.sampleCount != VK_SAMPLE_COUNT_1_BIT
+     || !(imageInfo.usage & VK_IMAGE_USAGE_STORAGE_BIT)
+     || imageView->info().aspect != VK_IMAGE_ASPECT_COLOR_BIT)
+      return false;
+
+    auto formatInfo = lookupFormatInfo(imageView->info().format);
+
+    if (formatInfo->flags.any(DxvkFormatFlag::SampledUInt, DxvkFormatFlag::SampledSInt))
+      return false;
+
+    DxvkFormatFeatures features = m_device->getFormatFeatures(imageView->info().format);
+
+    VkFormatFeatureFlags2 supported = imageInfo.tiling == VK_IMAGE_TILING_OPTIMAL
+      ? features.optimal
+      : features.linear;
+
+    VkFormatFeatureFlags2 required = VK_FORMAT_FEATURE_2_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+                                   | VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT
+                                   | VK_FORMAT_FEATURE_2_STORAGE_WRITE_WITHOUT_FORMAT_BIT;
+
+    return (supported & required) == required;
+  }
+
+
+  void DxvkContext::generateMipmapsCompute(
+    const Rc<DxvkImageView>&    imageView,
+          VkFilter              filter) {
+    constexpr uint32_t MaxLevelsPerPass = DxvkMetaMipGenObjects::MaxLevelsPerPass;
+    constexpr uint32_t DstTileSize = DxvkMetaMipGenObjects::TileSize / 2;
+
+    this->spillRenderPass(false);
+    this->invalidateState();
+
+    const Rc<DxvkImage>& image = imageView->image();
+    VkImageSubresourceRange subresources = imageView->imageSubresources();
+
+    if (m_execBarriers.isImageDirty(image, subresources, DxvkAccess::Write))
+      this->flushBarriersForAcquire({ image.ptr() });
+
+    // Keep all levels in the general layout so that levels written
+    // by one dispatch can be read by the next one without another
+    // layout transition. Only the top level needs to be preserved.
+    VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL;
+
+    if (imageView->imageInfo().layout != layout) {
+      VkImageSubresourceRange srcSubresources = subresources;
+      srcSubresources.levelCount = 1;
+
+      VkImageSubresourceRange dstSubresources = subresources;
+      dstSubresources.baseMipLevel += 1;
+      dstSubresources.levelCount -= 1;
+
+      m_execAcquires.accessImage(image, srcSubresources,
+        imageView->imageInfo().layout,
+        imageView->imageInfo().stages, 0,
+        layout,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT);
+
+      m_execAcquires.accessImage(image, dstSubresources,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        imageView->imageInfo().stages, 0,
+        layout,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
+    m_execAcquires.recordCommands(m_cmd);
+
+    DxvkMetaMipGenPipeline pipeInfo = m_common->metaMipGen().getPipeline();
+    VkSampler sampler = m_common->metaBlit().getSampler(filter);
+
+    m_cmd->cmdBindPipeline(
+      VK_PIPELINE_BIND_POINT_COMPUTE,
+      pipeInfo.pipeHandle);
+
+    uint32_t levelCount = imageView->info().numLevels;
+
+    for (uint32_t srcLevel = 0; srcLevel + 1 < levelCount; srcLevel += MaxLevelsPerPass) {
+      uint32_t passLevels = std::min(levelCount - srcLevel - 1, MaxLevelsPerPass);
+
+      // The bottom level of the previous pass is the source of this one
+      if (srcLevel) {
+        VkImageSubresourceRange srcSubresources = subresources;
+        srcSubresources.baseMipLevel += srcLevel;
+        srcSubresources.levelCount = 1;
+
+        m_execAcquires.accessImage(image, srcSubresources,
+          layout,
+          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          VK_ACCESS_SHADER_WRITE_BIT,
+          layout,
+          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+          VK_ACCESS_SHADER_READ_BIT);
+        m_execAcquires.recordCommands(m_cmd);
+      }
+
+      // Use identity swizzles, storage image views require them
+      DxvkImageViewCreateInfo viewInfo;
+      viewInfo.type      = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+      viewInfo.format    = imageView->info().format;
+      viewInfo.usage     = VK_IMAGE_USAGE_SAMPLED_BIT;
+      viewInfo.aspect    = imageView->info().aspect;
+      viewInfo.minLevel  = imageView->info().minLevel + srcLevel;
+      viewInfo.numLevels = 1;
+      viewInfo.minLayer  = imageView->info().minLayer;
+      viewInfo.numLayers = imageView->info().numLayers;
+
+      Rc<DxvkImageView> srcView = m_device->createImageView(image, viewInfo);
+      m_cmd->trackResource<DxvkAccess::None>(srcView);
+
+      DxvkMetaMipGenDescriptors descriptors = { };
+      descriptors.src = srcView->getDescriptor(VK_IMAGE_VIEW_TYPE_2D_ARRAY, layout).image;
+      descriptors.src.sampler = sampler;
+
+      // Unused descriptors must still be valid, so point
+      // them to the last level written by this pass
+      viewInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+
+      for (uint32_t i = 0; i < MaxLevelsPerPass; i++) {
+        if (i < passLevels) {
+          viewInfo.minLevel = imageView->info().minLevel + srcLevel + i + 1;
+
+          Rc<DxvkImageView> dstView = m_device->createImageView(image, viewInfo);
+          m_cmd->trackResource<DxvkAccess::None>(dstView);
+
+          descriptors.dst[i] = dstView->getDescriptor(VK_IMAGE_VIEW_TYPE_2D_ARRAY, layout).image;
+        } else {
+          descriptors.dst[i] = descriptors.dst[passLevels - 1];
+        }
+      }
+
+      VkDescriptorSet dset = m_descriptorPool->alloc(pipeInfo.dsetLayout);
+      m_cmd->updateDescriptorSetWithTemplate(dset, pipeInfo.dsetTemplate, &descriptors);
+
+      m_cmd->cmdBindDescriptorSet(
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        pipeInfo.pipeLayout, dset,
+        0, nullptr);
+
+      VkExtent3D dstExtent = imageView->mipLevelExtent(srcLevel + 1);
+
+      DxvkMetaMipGenArgs args;
+      args.dstExtent  = { dstExtent.width, dstExtent.height };
+      args.levelCount = passLevels;
+
+      m_cmd->cmdPushConstants(
+        pipeInfo.pipeLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(args), &args);
+
+      m_cmd->cmdDispatch(
+        (dstExtent.width  + DstTileSize - 1) / DstTileSize,
+        (dstExtent.height + DstTileSize - 1) / DstTileSize,
+        imageView->info().numLayers);
+    }
+
+    m_execBarriers.accessImage(image, subresources,
+      layout,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_READ_BIT |
+      VK_ACCESS_SHADER_WRITE_BIT,
+      imageView->imageInfo().layout,
+      imageView->imageInfo().stages,
+      imageView->imageInfo().access);
+
+    m_cmd->trackResource<DxvkAccess::Write>(image);
+  }
   
   
   void DxvkContext::invalidateBuffer(
@@ -1873,13 +2394,21 @@ namespace dxvk {
     const Rc<DxvkImage>&            srcImage,
     const VkImageResolve&           region,
           VkFormat                  format) {
+    if (format == VK_FORMAT_UNDEFINED)
+      format = srcImage->info().format;
+
+    // If the source image is being rendered to in the current render
+    // pass, let the render pass perform the resolve when it ends.
+    bool inlineResolve = this->resolveImageInline(dstImage, srcImage, region, format);
+
     this->spillRenderPass(true);
+
+    if (inlineResolve)
+      return;
+
     this->prepareImage(dstImage, vk::makeSubresourceRange(region.dstSubresource));
     this->prepareImage(srcImage, vk::makeSubresourceRange(region.srcSubresource));
 
-    if (format == VK_FORMAT_UNDEFINED)
-      format = srcImage->info().format;
-
     bool useFb = srcImage->info().format != format
               || dstImage->info().format != format;
 
@@ -2311,7 +2840,8 @@ namespace dxvk {
 
     auto stagingSlice = m_staging.alloc(CACHE_LINE_SIZE, bufferSlice.length);
     auto stagingHandle = stagingSlice.getSliceHandle();
-    std::memcpy(stagingHandle.mapPtr, data, bufferSlice.length);
+    bit::bcopyMapped(stagingHandle.mapPtr, data, bufferSlice.length,
+      !(stagingSlice.buffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_CACHED_BIT));
 
     VkBufferCopy2 copyRegion = { VK_STRUCTURE_TYPE_BUFFER_COPY_2 };
     copyRegion.srcOffset = stagingHandle.offset;
@@ -2465,6 +2995,19 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::setPredicate(
+    const DxvkBufferSlice&    predicate,
+          VkConditionalRenderingFlagsEXT flags) {
+    if (!m_state.cond.predicate.matches(predicate)
+     || m_state.cond.flags != flags) {
+      this->pauseConditionalRendering();
+
+      m_state.cond.predicate = predicate;
+      m_state.cond.flags = flags;
+    }
+  }
+
+
   void DxvkContext::setInputAssemblyState(const DxvkInputAssemblyState& ia) {
     m_state.gp.state.ia = DxvkIaInfo(
       ia.primitiveTopology,
@@ -2579,7 +3122,8 @@ namespace dxvk {
     m_state.gp.state.om = DxvkOmInfo(
       lo.enableLogicOp,
       lo.logicOp,
-      m_state.gp.state.om.feedbackLoop());
+      m_state.gp.state.om.feedbackLoop(),
+      m_state.gp.state.om.dynamicBlend());
     
     m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
   }
@@ -2588,7 +3132,7 @@ namespace dxvk {
   void DxvkContext::setBlendMode(
           uint32_t            attachment,
     const DxvkBlendMode&      blendMode) {
-    m_state.gp.state.omBlend[attachment] = DxvkOmAttachmentBlend(
+    DxvkOmAttachmentBlend blend(
       blendMode.enableBlending,
       blendMode.colorSrcFactor,
       blendMode.colorDstFactor,
@@ -2597,8 +3141,40 @@ namespace dxvk {
       blendMode.alphaDstFactor,
       blendMode.alphaBlendOp,
       blendMode.writeMask);
-    
-    m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
+
+    if (!m_features.test(DxvkContextFeature::DynamicBlendState)) {
+      m_state.gp.state.omBlend[attachment] = blend;
+      m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
+      return;
+    }
+
+    m_state.dyn.omBlend[attachment] = blend;
+    m_flags.set(DxvkContextFlag::GpDirtyBlendState);
+
+    // Dual-source blending requires patching the fragment shader,
+    // so keep blend state static for pipelines that use it
+    const auto& blend0 = m_state.dyn.omBlend[0];
+
+    VkBool32 dynamicBlend = !blend0.blendEnable() || !(
+      util::isDualSourceBlendFactor(blend0.srcColorBlendFactor()) ||
+      util::isDualSourceBlendFactor(blend0.dstColorBlendFactor()) ||
+      util::isDualSourceBlendFactor(blend0.srcAlphaBlendFactor()) ||
+      util::isDualSourceBlendFactor(blend0.dstAlphaBlendFactor()));
+
+    if (dynamicBlend != m_state.gp.state.om.dynamicBlend()) {
+      m_state.gp.state.om.setDynamicBlend(dynamicBlend);
+
+      for (uint32_t i = 0; i < MaxNumRenderTargets; i++)
+        m_state.gp.state.omBlend[i] = getPipelineBlendMode(i);
+
+      m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
+    } else if (!dynamicBlend || blend.colorWriteMask()
+        != m_state.gp.state.omBlend[attachment].colorWriteMask()) {
+      // With dynamic blending, only write mask changes
+      // require looking up a different pipeline
+      m_state.gp.state.omBlend[attachment] = getPipelineBlendMode(attachment);
+      m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
+    }
   }
 
 
@@ -2610,10 +3186,20 @@ namespace dxvk {
   void DxvkContext::updatePageTable(
     const DxvkSparseBindInfo&   bindInfo,
           DxvkSparseBindFlags   flags) {
-    // Split command buffers here so that we execute
-    // the sparse binding operation at the right time
-    if (!flags.test(DxvkSparseBindFlag::SkipSynchronization))
-      this->splitCommands();
+    // Split command buffers here so that we execute the sparse binding
+    // operation at the right time. If nothing was recorded since the
+    // last split, e.g. because the app issues several tile mapping
+    // updates in a row, the binds are merged into the same operation
+    // and there is no need to start over with a clean state.
+    if (!flags.test(DxvkSparseBindFlag::SkipSynchronization)) {
+      this->endCurrentCommands();
+
+      if (m_cmd->hasPendingCommands()) {
+        m_cmd->next();
+
+        this->beginCurrentCommands();
+      }
+    }
 
     DxvkSparsePageAllocator* srcAllocator = bindInfo.srcAllocator.ptr();
     DxvkSparsePageTable* dstPageTable = bindInfo.dstResource->getSparsePageTable();
@@ -2698,6 +3284,50 @@ namespace dxvk {
   }
 
 
+  void DxvkContext::writePredicate(
+    const DxvkBufferSlice&    predicate,
+    const Rc<DxvkGpuQuery>&   query) {
+    this->spillRenderPass(true);
+
+    auto predSlice = predicate.getSliceHandle();
+
+    // Conditional rendering reads are not tracked by the barrier
+    // set, so explicitly wait for any prior draws to complete.
+    m_execBarriers.accessMemory(
+      VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT, 0,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT);
+    m_execBarriers.recordCommands(m_cmd);
+
+    DxvkGpuQueryHandle handle = { };
+    bool canCopy = query->getCopyHandle(handle);
+
+    if (canCopy && handle.queryPool) {
+      m_cmd->cmdCopyQueryPoolResults(
+        handle.queryPool, handle.queryId, 1,
+        predSlice.handle, predSlice.offset,
+        sizeof(uint32_t), VK_QUERY_RESULT_WAIT_BIT);
+
+      m_cmd->trackResource<DxvkAccess::None>(query);
+    } else {
+      // If the query has no handles at all, no samples passed
+      uint32_t value = canCopy ? 0u : 1u;
+
+      m_cmd->cmdUpdateBuffer(DxvkCmdBuffer::ExecBuffer,
+        predSlice.handle, predSlice.offset,
+        sizeof(value), &value);
+    }
+
+    m_execBarriers.accessBuffer(predSlice,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      predicate.buffer()->info().stages,
+      predicate.buffer()->info().access);
+
+    m_cmd->trackResource<DxvkAccess::Write>(predicate.buffer());
+  }
+
+
   void DxvkContext::signalGpuEvent(const Rc<DxvkGpuEvent>& event) {
     this->spillRenderPass(true);
     
@@ -2808,6 +3438,14 @@ namespace dxvk {
 
 
   void DxvkContext::beginDebugLabel(VkDebugUtilsLabelEXT *label) {
+    if (unlikely(m_device->gpuProfiler().isEnabled())) {
+      // Render passes keep the name they started with
+      if (m_passQuery != nullptr && !m_flags.test(DxvkContextFlag::GpRenderPassBound))
+        this->endProfiledPass();
+
+      m_debugLabels.push_back(label->pLabelName);
+    }
+
     if (!m_device->instance()->extensions().extDebugUtils)
       return;
 
@@ -2815,6 +3453,14 @@ namespace dxvk {
   }
 
   void DxvkContext::endDebugLabel() {
+    if (unlikely(m_device->gpuProfiler().isEnabled())) {
+      if (m_passQuery != nullptr && !m_flags.test(DxvkContextFlag::GpRenderPassBound))
+        this->endProfiledPass();
+
+      if (!m_debugLabels.empty())
+        m_debugLabels.pop_back();
+    }
+
     if (!m_device->instance()->extensions().extDebugUtils)
       return;
 
@@ -2842,7 +3488,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr(), srcImage.ptr() });
 
     bool srcIsDepthStencil = region.srcSubresource.aspectMask & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
 
@@ -3021,7 +3667,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr(), srcImage.ptr() });
 
     // Prepare the two images for transfer ops if necessary
     auto dstLayout = dstImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -3241,8 +3887,8 @@ namespace dxvk {
 
   void DxvkContext::clearImageViewFb(
     const Rc<DxvkImageView>&    imageView,
-          VkOffset3D            offset,
-          VkExtent3D            extent,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
           VkImageAspectFlags    aspect,
           VkClearValue          value) {
     this->updateFramebuffer();
@@ -3313,7 +3959,7 @@ namespace dxvk {
       }
 
       // We cannot leverage render pass clears
-      // because we clear only part of the view
+      // because we clear only parts of the view
       m_cmd->cmdBeginRendering(&renderingInfo);
     } else {
       // Make sure the render pass is active so
@@ -3330,15 +3976,18 @@ namespace dxvk {
     if ((aspect & VK_IMAGE_ASPECT_COLOR_BIT) && (attachmentIndex >= 0))
       clearInfo.colorAttachment   = m_state.om.framebufferInfo.getColorAttachmentIndex(attachmentIndex);
 
-    VkClearRect clearRect;
-    clearRect.rect.offset.x       = offset.x;
-    clearRect.rect.offset.y       = offset.y;
-    clearRect.rect.extent.width   = extent.width;
-    clearRect.rect.extent.height  = extent.height;
-    clearRect.baseArrayLayer      = 0;
-    clearRect.layerCount          = imageView->info().numLayers;
+    small_vector<VkClearRect, 16> clearRects;
+
+    for (uint32_t i = 0; i < rectCount; i++) {
+      VkClearRect clearRect;
+      clearRect.rect                = rects[i];
+      clearRect.baseArrayLayer      = 0;
+      clearRect.layerCount          = imageView->info().numLayers;
+
+      clearRects.push_back(clearRect);
+    }
 
-    m_cmd->cmdClearAttachments(1, &clearInfo, 1, &clearRect);
+    m_cmd->cmdClearAttachments(1, &clearInfo, clearRects.size(), clearRects.data());
 
     // Unbind temporary framebuffer
     if (attachmentIndex < 0) {
@@ -3453,7 +4102,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr(), srcImage.ptr() });
 
     VkImageLayout dstImageLayout = dstImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
     VkImageLayout srcImageLayout = srcImage->pickLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
@@ -3632,7 +4281,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr(), srcImage.ptr() });
 
     // Flag used to determine whether we can do an UNDEFINED transition    
     bool doDiscard = dstImage->isFullSubresource(dstSubresource, extent);
@@ -3803,6 +4452,80 @@ namespace dxvk {
   }
 
 
+  bool DxvkContext::findPackedCopy(
+    const Rc<DxvkBuffer>&       dstBuffer,
+          VkDeviceSize          dstBufferOffset,
+    const Rc<DxvkImage>&        srcImage,
+          DxvkImagePackedCopy&  packedCopy) {
+    auto dstSlice = dstBuffer->getSliceHandle(dstBufferOffset, 0);
+
+    packedCopy.bufferCookie        = dstBuffer->cookie();
+    packedCopy.bufferHandle        = dstSlice.handle;
+    packedCopy.bufferOffset        = dstSlice.offset;
+    packedCopy.bufferWriteSequence = dstBuffer->getWriteSequence();
+    packedCopy.imageWriteSequence  = srcImage->getWriteSequence();
+
+    for (size_t i = 0; i < srcImage->m_packedCopies.size(); i++) {
+      if (srcImage->m_packedCopies[i].eq(packedCopy))
+        return true;
+    }
+
+    return false;
+  }
+
+
+  void DxvkContext::addPackedCopy(
+    const Rc<DxvkBuffer>&       dstBuffer,
+          VkDeviceSize          dstBufferOffset,
+    const Rc<DxvkImage>&        srcImage,
+          DxvkImagePackedCopy&  packedCopy) {
+    // The pack operation itself wrote the buffer, so we
+    // need to update the sequence numbers accordingly
+    packedCopy.bufferWriteSequence = dstBuffer->getWriteSequence();
+    packedCopy.imageWriteSequence  = srcImage->getWriteSequence();
+
+    auto& entries = srcImage->m_packedCopies;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (entries[i].bufferCookie == packedCopy.bufferCookie
+       && entries[i].subresource == packedCopy.subresource) {
+        entries[i] = packedCopy;
+        return;
+      }
+    }
+
+    // Only keep a small number of entries around, images
+    // are typically only read back into one buffer anyway.
+    // Drop the oldest one, small_vector::erase does not
+    // update the size of the vector.
+    if (entries.size() >= MaxPackedCopiesPerImage) {
+      for (size_t i = 1; i < entries.size(); i++)
+        entries[i - 1] = entries[i];
+
+      entries.pop_back();
+    }
+
+    entries.push_back(packedCopy);
+  }
+
+
+  bool DxvkContext::useFbForImageCopy(
+    const Rc<DxvkImage>&        dstImage,
+          VkImageSubresourceLayers dstSubresource,
+    const Rc<DxvkImage>&        srcImage,
+          VkImageSubresourceLayers srcSubresource) const {
+    bool useFb = dstSubresource.aspectMask != srcSubresource.aspectMask;
+
+    if (m_device->perfHints().preferFbDepthStencilCopy) {
+      useFb |= (dstSubresource.aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+            && (dstImage->info().usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
+            && (srcImage->info().usage & VK_IMAGE_USAGE_SAMPLED_BIT);
+    }
+
+    return useFb;
+  }
+
+
   bool DxvkContext::copyImageClear(
     const Rc<DxvkImage>&        dstImage,
           VkImageSubresourceLayers dstSubresource,
@@ -4061,7 +4784,7 @@ namespace dxvk {
     
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr(), srcImage.ptr() });
     
     // We only support resolving to the entire image
     // area, so we might as well discard its contents
@@ -4143,7 +4866,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr(), srcImage.ptr() });
 
     // Transition both images to usable layouts if necessary. For the source image we
     // can be fairly leniet since writable layouts are allowed for resolve attachments.
@@ -4247,7 +4970,7 @@ namespace dxvk {
 
     if (m_execBarriers.isImageDirty(dstImage, dstSubresourceRange, DxvkAccess::Write)
      || m_execBarriers.isImageDirty(srcImage, srcSubresourceRange, DxvkAccess::Write))
-      m_execBarriers.recordCommands(m_cmd);
+      this->flushBarriersForAcquire({ dstImage.ptr(), srcImage.ptr() });
 
     // Discard the destination image if we're fully writing it,
     // and transition the image layout if necessary
@@ -4490,6 +5213,7 @@ namespace dxvk {
         DxvkContextFlag::GpDirtyIndexBuffer,
         DxvkContextFlag::GpDirtyXfbBuffers,
         DxvkContextFlag::GpDirtyBlendConstants,
+        DxvkContextFlag::GpDirtyBlendState,
         DxvkContextFlag::GpDirtyStencilRef,
         DxvkContextFlag::GpDirtyMultisampleState,
         DxvkContextFlag::GpDirtyRasterizerState,
@@ -4507,6 +5231,11 @@ namespace dxvk {
         m_state.om.framebufferInfo,
         m_state.om.renderPassOps);
 
+      // Render passes may use secondary command buffers, and
+      // meta operations may have bound pipelines with static
+      // vertex strides, so rebind all vertex buffers
+      m_vbBound.count = 0;
+
       // Track the final layout of each render target
       this->applyRenderTargetStoreLayouts();
 
@@ -4528,6 +5257,7 @@ namespace dxvk {
       m_flags.clr(DxvkContextFlag::GpRenderPassBound);
 
       this->pauseTransformFeedback();
+      this->pauseConditionalRendering();
       
       m_queryManager.endQueries(m_cmd, VK_QUERY_TYPE_OCCLUSION);
       m_queryManager.endQueries(m_cmd, VK_QUERY_TYPE_PIPELINE_STATISTICS);
@@ -4730,14 +5460,23 @@ namespace dxvk {
     VkRenderingAttachmentInfo depthInfo = { VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
     VkImageAspectFlags depthStencilAspects = 0;
 
+    VkImageAspectFlags depthStencilWritable = 0;
+
     if (framebufferInfo.getDepthTarget().view != nullptr) {
       const auto& depthTarget = framebufferInfo.getDepthTarget();
       depthStencilAspects = depthTarget.view->info().aspect;
+      depthStencilWritable = vk::getWritableAspectsForLayout(depthTarget.layout);
       depthInfo.imageView = depthTarget.view->handle();
       depthInfo.imageLayout = depthTarget.layout;
       depthInfo.loadOp = ops.depthOps.loadOpD;
       depthInfo.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 
+      // Aspects bound in a read-only layout cannot be written
+      // during the render pass, so there is nothing to store
+      if (!(depthStencilWritable & VK_IMAGE_ASPECT_DEPTH_BIT)
+       && depthInfo.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+        depthInfo.storeOp = VK_ATTACHMENT_STORE_OP_NONE;
+
       if (ops.depthOps.loadOpD == VK_ATTACHMENT_LOAD_OP_CLEAR)
         depthInfo.clearValue.depthStencil.depth = ops.depthOps.clearValue.depth;
     }
@@ -4748,6 +5487,10 @@ namespace dxvk {
       stencilInfo.loadOp = ops.depthOps.loadOpS;
       stencilInfo.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 
+      if (!(depthStencilWritable & VK_IMAGE_ASPECT_STENCIL_BIT)
+       && stencilInfo.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+        stencilInfo.storeOp = VK_ATTACHMENT_STORE_OP_NONE;
+
       if (ops.depthOps.loadOpS == VK_ATTACHMENT_LOAD_OP_CLEAR)
         stencilInfo.clearValue.depthStencil.stencil = ops.depthOps.clearValue.stencil;
     }
@@ -4768,7 +5511,63 @@ namespace dxvk {
     if (depthStencilAspects & VK_IMAGE_ASPECT_STENCIL_BIT)
       renderingInfo.pStencilAttachment = &stencilInfo;
 
-    m_cmd->cmdBeginRendering(&renderingInfo);
+    if (this->canUseSecondaryRenderPass(framebufferInfo)) {
+      // Only begin the render pass instance once it ends, so
+      // that resolve attachments can still be added until then
+      auto& pass = m_secondaryPass;
+      pass.colorInfos = colorInfos;
+      pass.depthInfo = depthInfo;
+      pass.stencilInfo = stencilInfo;
+
+      pass.renderingInfo = renderingInfo;
+      pass.renderingInfo.flags |= VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+
+      if (renderingInfo.pColorAttachments)
+        pass.renderingInfo.pColorAttachments = pass.colorInfos.data();
+      if (renderingInfo.pDepthAttachment)
+        pass.renderingInfo.pDepthAttachment = &pass.depthInfo;
+      if (renderingInfo.pStencilAttachment)
+        pass.renderingInfo.pStencilAttachment = &pass.stencilInfo;
+
+      std::array<VkFormat, MaxNumRenderTargets> colorFormats = { };
+
+      for (uint32_t i = 0; i < colorInfoCount; i++) {
+        const auto& colorTarget = framebufferInfo.getColorTarget(i);
+
+        if (colorTarget.view != nullptr)
+          colorFormats[i] = colorTarget.view->info().format;
+      }
+
+      VkCommandBufferInheritanceRenderingInfo renderingInheritance = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO };
+      renderingInheritance.colorAttachmentCount = colorInfoCount;
+      renderingInheritance.pColorAttachmentFormats = colorFormats.data();
+      renderingInheritance.rasterizationSamples = VkSampleCountFlagBits(framebufferInfo.getSampleCount());
+
+      if (depthStencilAspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+        renderingInheritance.depthAttachmentFormat = framebufferInfo.getDepthTarget().view->info().format;
+
+      if (depthStencilAspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+        renderingInheritance.stencilAttachmentFormat = framebufferInfo.getDepthTarget().view->info().format;
+
+      VkCommandBufferInheritanceInfo inheritanceInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+      inheritanceInfo.pNext = &renderingInheritance;
+
+      if (unlikely(m_device->gpuProfiler().isEnabled()))
+        this->beginProfiledPass("Render pass");
+
+      m_cmd->beginSecondaryCommandBuffer(inheritanceInfo);
+      m_cmd->beginTrackingScope();
+
+      // Secondary command buffers do not inherit any state
+      m_flags.set(
+        DxvkContextFlag::GpRenderPassSecondaryCmds,
+        DxvkContextFlag::DirtyDescriptorBuffer);
+    } else {
+      if (unlikely(m_device->gpuProfiler().isEnabled()))
+        this->beginProfiledPass("Render pass");
+
+      m_cmd->cmdBeginRendering(&renderingInfo);
+    }
     
     for (uint32_t i = 0; i < framebufferInfo.numAttachments(); i++) {
       m_cmd->trackResource<DxvkAccess::None> (framebufferInfo.getAttachment(i).view);
@@ -4780,7 +5579,15 @@ namespace dxvk {
   
   
   void DxvkContext::renderPassUnbindFramebuffer() {
-    m_cmd->cmdEndRendering();
+    if (m_flags.test(DxvkContextFlag::GpRenderPassSecondaryCmds)) {
+      m_flags.clr(DxvkContextFlag::GpRenderPassSecondaryCmds);
+      this->renderPassExecuteSecondary();
+    } else {
+      m_cmd->cmdEndRendering();
+    }
+
+    if (unlikely(m_passQuery != nullptr))
+      this->endProfiledPass();
 
     // If there are pending layout transitions, execute them immediately
     // since the backend expects images to be in the store layout after
@@ -4790,6 +5597,163 @@ namespace dxvk {
   }
   
   
+  bool DxvkContext::canUseSecondaryRenderPass(
+    const DxvkFramebufferInfo&  framebufferInfo) const {
+    // Only multisampled render passes benefit from resolve attachments
+    if (!m_features.test(DxvkContextFeature::RenderPassResolve)
+     || framebufferInfo.getSampleCount() <= VK_SAMPLE_COUNT_1_BIT)
+      return false;
+
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      if (framebufferInfo.getColorTarget(i).view != nullptr)
+        return true;
+    }
+
+    return false;
+  }
+
+
+  void DxvkContext::renderPassExecuteSecondary() {
+    VkCommandBuffer secondary = m_cmd->endSecondaryCommandBuffer();
+
+    auto& pass = m_secondaryPass;
+
+    // Resolve attachments are written in their entirety, so
+    // we can discard their contents before the render pass
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      const auto& view = pass.resolveViews[i];
+
+      if (view != nullptr) {
+        m_execAcquires.accessImage(view->image(),
+          view->imageSubresources(),
+          VK_IMAGE_LAYOUT_UNDEFINED,
+          view->imageInfo().stages,
+          view->imageInfo().access,
+          pass.colorInfos[i].resolveImageLayout,
+          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+      }
+    }
+
+    m_execAcquires.recordCommands(m_cmd);
+
+    m_cmd->cmdBeginRendering(&pass.renderingInfo);
+    m_cmd->cmdExecuteCommands(1, &secondary);
+    m_cmd->cmdEndRendering();
+
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      Rc<DxvkImageView> view = std::move(pass.resolveViews[i]);
+
+      if (view != nullptr) {
+        m_execBarriers.accessImage(view->image(),
+          view->imageSubresources(),
+          pass.colorInfos[i].resolveImageLayout,
+          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+          view->imageInfo().layout,
+          view->imageInfo().stages,
+          view->imageInfo().access);
+
+        m_cmd->trackResource<DxvkAccess::None>(view);
+        m_cmd->trackResource<DxvkAccess::Write>(view->image());
+      }
+    }
+
+    // State bound in the primary command buffer becomes
+    // undefined after executing a secondary command buffer
+    this->unbindComputePipeline();
+
+    m_descriptorState.dirtyStages(VK_SHADER_STAGE_COMPUTE_BIT);
+
+    m_flags.set(
+      DxvkContextFlag::DirtyPushConstants,
+      DxvkContextFlag::DirtyDescriptorBuffer);
+  }
+
+
+  bool DxvkContext::resolveImageInline(
+    const Rc<DxvkImage>&            dstImage,
+    const Rc<DxvkImage>&            srcImage,
+    const VkImageResolve&           region,
+          VkFormat                  format) {
+    if (!m_flags.test(DxvkContextFlag::GpRenderPassSecondaryCmds))
+      return false;
+
+    // The render pass can only resolve entire attachments
+    if (region.srcSubresource.aspectMask != VK_IMAGE_ASPECT_COLOR_BIT
+     || !srcImage->isFullSubresource(region.srcSubresource, region.extent)
+     || !dstImage->isFullSubresource(region.dstSubresource, region.extent)
+     || !(dstImage->info().usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
+     || dstImage->info().sampleCount != VK_SAMPLE_COUNT_1_BIT
+     || dstImage->info().format != format)
+      return false;
+
+    const auto& fbInfo = m_state.om.framebufferInfo;
+    int32_t index = -1;
+
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      const auto& view = fbInfo.getColorTarget(i).view;
+
+      if (view == nullptr)
+        continue;
+
+      // The resolve destination must not be in use by
+      // the render pass in any way, including resolves
+      const auto& resolveView = m_secondaryPass.resolveViews[i];
+
+      if (view->image() == dstImage
+       || (resolveView != nullptr && resolveView->image() == dstImage))
+        return false;
+
+      auto subresources = view->imageSubresources();
+
+      if (view->image() == srcImage && view->info().format == format
+       && subresources.baseMipLevel == region.srcSubresource.mipLevel
+       && subresources.baseArrayLayer == region.srcSubresource.baseArrayLayer
+       && subresources.layerCount == region.srcSubresource.layerCount)
+        index = int32_t(i);
+    }
+
+    if (index < 0 || m_secondaryPass.resolveViews[index] != nullptr)
+      return false;
+
+    // We are going to change the layout of the destination before the
+    // render pass, so it must not be accessed inside the render pass
+    if (m_cmd->isTrackedInScope(dstImage)
+     || m_execBarriers.isImageDirty(dstImage, vk::makeSubresourceRange(region.dstSubresource), DxvkAccess::Write))
+      return false;
+
+    for (const auto& entry : m_deferredClears) {
+      if (entry.imageView->image() == dstImage)
+        return false;
+    }
+
+    DxvkImageViewCreateInfo viewInfo;
+    viewInfo.type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = format;
+    viewInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    viewInfo.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.minLevel = region.dstSubresource.mipLevel;
+    viewInfo.numLevels = 1;
+    viewInfo.minLayer = region.dstSubresource.baseArrayLayer;
+    viewInfo.numLayers = region.dstSubresource.layerCount;
+
+    Rc<DxvkImageView> view = m_device->createImageView(dstImage, viewInfo);
+
+    auto formatInfo = lookupFormatInfo(format);
+
+    auto& colorInfo = m_secondaryPass.colorInfos[index];
+    colorInfo.resolveMode = formatInfo->flags.any(DxvkFormatFlag::SampledUInt, DxvkFormatFlag::SampledSInt)
+      ? VK_RESOLVE_MODE_SAMPLE_ZERO_BIT
+      : VK_RESOLVE_MODE_AVERAGE_BIT;
+    colorInfo.resolveImageView = view->handle();
+    colorInfo.resolveImageLayout = dstImage->pickLayout(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+    m_secondaryPass.resolveViews[index] = std::move(view);
+    return true;
+  }
+
+
   void DxvkContext::resetRenderPassOps(
     const DxvkRenderTargets&    renderTargets,
           DxvkRenderPassOps&    renderPassOps) {
@@ -4829,8 +5793,16 @@ namespace dxvk {
 
         if (physSlice.handle != VK_NULL_HANDLE)
           m_cmd->trackResource<DxvkAccess::Read>(m_state.xfb.counters[i].buffer());
+
+        // Not passing a counter buffer makes transform feedback start
+        // writing at the start of the buffer, and the counter will be
+        // written when transform feedback gets paused.
+        if (m_state.xfb.counterResetMask & (1u << i))
+          ctrBuffers[i] = VK_NULL_HANDLE;
       }
-      
+
+      m_state.xfb.counterResetMask = 0u;
+
       m_cmd->cmdBeginTransformFeedback(
         0, MaxNumXfbBuffers, ctrBuffers, ctrOffsets);
       
@@ -4866,6 +5838,46 @@ namespace dxvk {
   }
 
 
+  void DxvkContext::resolveXfbCounterResets(uint32_t mask) {
+    const uint32_t zero = 0u;
+
+    m_state.xfb.counterResetMask &= ~mask;
+
+    for (uint32_t i : bit::BitMask(mask)) {
+      const auto& counter = m_state.xfb.counters[i];
+
+      this->updateBuffer(counter.buffer(),
+        counter.offset(), sizeof(zero), &zero);
+    }
+  }
+
+
+  void DxvkContext::startConditionalRendering() {
+    if (!m_flags.test(DxvkContextFlag::GpCondActive)) {
+      m_flags.set(DxvkContextFlag::GpCondActive);
+
+      auto predSlice = m_state.cond.predicate.getSliceHandle();
+
+      VkConditionalRenderingBeginInfoEXT beginInfo = { VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT };
+      beginInfo.buffer = predSlice.handle;
+      beginInfo.offset = predSlice.offset;
+      beginInfo.flags = m_state.cond.flags;
+
+      m_cmd->cmdBeginConditionalRendering(&beginInfo);
+      m_cmd->trackResource<DxvkAccess::Read>(m_state.cond.predicate.buffer());
+    }
+  }
+
+
+  void DxvkContext::pauseConditionalRendering() {
+    if (m_flags.test(DxvkContextFlag::GpCondActive)) {
+      m_flags.clr(DxvkContextFlag::GpCondActive);
+
+      m_cmd->cmdEndConditionalRendering();
+    }
+  }
+
+
   void DxvkContext::unbindComputePipeline() {
     m_flags.set(DxvkContextFlag::CpDirtyPipelineState);
 
@@ -4919,6 +5931,7 @@ namespace dxvk {
       DxvkContextFlag::GpDirtyIndexBuffer,
       DxvkContextFlag::GpDirtyXfbBuffers,
       DxvkContextFlag::GpDirtyBlendConstants,
+      DxvkContextFlag::GpDirtyBlendState,
       DxvkContextFlag::GpDirtyStencilRef,
       DxvkContextFlag::GpDirtyMultisampleState,
       DxvkContextFlag::GpDirtyRasterizerState,
@@ -4974,12 +5987,50 @@ namespace dxvk {
   }
   
   
+  std::pair<VkPipeline, DxvkGraphicsPipelineType> DxvkContext::getGraphicsPipelineHandleAsync() {
+    auto pipelineInfo = m_state.gp.pipeline->tryGetPipelineHandle(m_state.gp.state);
+
+    if (likely(pipelineInfo.first))
+      return pipelineInfo;
+
+    // Reset the stall budget on every new frame, and keep track of
+    // how many frames in a row had to skip draws so far
+    uint32_t frameId = m_device->getCurrentFrameId();
+
+    if (m_asyncFrameId != frameId) {
+      m_asyncSkipFrames = m_asyncSkippedDraws ? m_asyncSkipFrames + 1 : 0;
+      m_asyncFrameId = frameId;
+      m_asyncStallTime = 0;
+      m_asyncSkippedDraws = false;
+    }
+
+    const auto& options = m_device->config();
+
+    // Stall on the pipeline if we are within the per-frame budget, or if
+    // draws have been skipped for too long. Otherwise, skip the draw.
+    if (m_asyncStallTime < uint64_t(std::max(options.asyncPipelineStallBudget, 0))
+     || m_asyncSkipFrames >= uint32_t(std::max(options.asyncPipelineMaxSkipFrames, 0))) {
+      auto t0 = dxvk::high_resolution_clock::now();
+      pipelineInfo = m_state.gp.pipeline->getPipelineHandle(m_state.gp.state);
+      auto t1 = dxvk::high_resolution_clock::now();
+
+      m_asyncStallTime += std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+      return pipelineInfo;
+    }
+
+    m_asyncSkippedDraws = true;
+    m_cmd->addStatCtr(DxvkStatCounter::CmdDrawCallsSkipped, 1);
+    return pipelineInfo;
+  }
+
+
   bool DxvkContext::updateGraphicsPipelineState(DxvkGlobalPipelineBarrier srcBarrier) {
     bool oldIndependentSets = m_flags.test(DxvkContextFlag::GpIndependentSets);
 
     // Check which dynamic states need to be active. States that
     // are not dynamic will be invalidated in the command buffer.
     m_flags.clr(DxvkContextFlag::GpDynamicBlendConstants,
+                DxvkContextFlag::GpDynamicBlendState,
                 DxvkContextFlag::GpDynamicDepthStencilState,
                 DxvkContextFlag::GpDynamicDepthBias,
                 DxvkContextFlag::GpDynamicDepthBounds,
@@ -4991,16 +6042,35 @@ namespace dxvk {
     m_flags.set(m_state.gp.state.useDynamicBlendConstants()
       ? DxvkContextFlag::GpDynamicBlendConstants
       : DxvkContextFlag::GpDirtyBlendConstants);
+
+    // Blend state depends on render target formats and swizzles
+    // in some cases, so re-apply it whenever the pipeline changes
+    if (m_state.gp.state.om.dynamicBlend()) {
+      m_flags.set(DxvkContextFlag::GpDynamicBlendState,
+                  DxvkContextFlag::GpDirtyBlendState);
+    }
     
     m_flags.set((!m_state.gp.flags.test(DxvkGraphicsPipelineFlag::HasRasterizerDiscard))
       ? DxvkContextFlag::GpDynamicRasterizerState
       : DxvkContextFlag::GpDirtyRasterizerState);
 
-    // Retrieve and bind actual Vulkan pipeline handle
-    auto pipelineInfo = m_state.gp.pipeline->getPipelineHandle(m_state.gp.state);
+    // Retrieve and bind actual Vulkan pipeline handle. Query the optimized
+    // pipeline count first so that we never miss a pipeline that finishes
+    // compiling between these two calls.
+    m_state.gp.optimizedCount = m_state.gp.pipeline->getOptimizedPipelineCount();
+
+    auto pipelineInfo = unlikely(m_features.test(DxvkContextFeature::AsyncPipelineCompile))
+      ? this->getGraphicsPipelineHandleAsync()
+      : m_state.gp.pipeline->getPipelineHandle(m_state.gp.state);
+
+    if (unlikely(!pipelineInfo.first)) {
+      // The independent sets flag was cleared above, so make sure that
+      // descriptors get re-bound with a compatible layout next time
+      if (oldIndependentSets)
+        m_descriptorState.dirtyStages(VK_SHADER_STAGE_ALL_GRAPHICS);
 
-    if (unlikely(!pipelineInfo.first))
       return false;
+    }
 
     m_cmd->cmdBindPipeline(
       VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -5119,6 +6189,11 @@ namespace dxvk {
   
   template<VkPipelineBindPoint BindPoint>
   void DxvkContext::updateResourceBindings(const DxvkBindingLayoutObjects* layout) {
+    if (m_device->canUseDescriptorBuffer()) {
+      this->updateDescriptorBufferBindings<BindPoint>(layout);
+      return;
+    }
+
     const auto& bindings = layout->layout();
 
     // Ensure that the arrays we write descriptor info to are big enough
@@ -5140,25 +6215,30 @@ namespace dxvk {
     dirtySetMask &= layoutSetMask;
 
     std::array<VkDescriptorSet, DxvkDescriptorSets::SetCount> sets;
-    m_descriptorPool->alloc(layout, dirtySetMask, sets.data());
+    std::array<uint32_t, MaxNumDynamicUniformBuffers> dynamicOffsets;
 
     uint32_t descriptorCount = 0;
+    uint32_t dynamicOffsetCount = 0;
 
     for (auto setIndex : bit::BitMask(dirtySetMask)) {
       uint32_t bindingCount = bindings.getBindingCount(setIndex);
-      VkDescriptorSet set = sets[setIndex];
+      uint32_t descriptorStart = descriptorCount;
+
+      uint32_t dynamicBufferCount = layout->getDynamicBufferCount(setIndex);
+      uint32_t dynamicBufferIndex = 0;
 
       for (uint32_t j = 0; j < bindingCount; j++) {
         const auto& binding = bindings.getBinding(setIndex, j);
 
         if (!useDescriptorTemplates) {
           auto& descriptorWrite = m_descriptorWrites[descriptorCount];
-          descriptorWrite.dstSet = set;
           descriptorWrite.dstBinding = j;
           descriptorWrite.descriptorType = binding.descriptorType;
         }
 
+        // Zero-initialize so that the set cache can compare raw data
         auto& descriptorInfo = m_descriptors[descriptorCount++];
+        descriptorInfo = DxvkDescriptorInfo();
 
         switch (binding.descriptorType) {
           case VK_DESCRIPTOR_TYPE_SAMPLER: {
@@ -5282,6 +6362,17 @@ namespace dxvk {
               descriptorInfo.buffer.offset = 0;
               descriptorInfo.buffer.range = VK_WHOLE_SIZE;
             }
+
+            // Pass the offset of dynamic uniform buffers separately, so
+            // that the set cache hits if only the buffer offset changed.
+            if (dynamicBufferIndex < dynamicBufferCount) {
+              dynamicOffsets[dynamicOffsetCount++] = uint32_t(descriptorInfo.buffer.offset);
+              descriptorInfo.buffer.offset = 0;
+              dynamicBufferIndex += 1;
+
+              if (!useDescriptorTemplates)
+                m_descriptorWrites[descriptorCount - 1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            }
           } break;
 
           case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: {
@@ -5304,11 +6395,29 @@ namespace dxvk {
         }
       }
 
-      if (useDescriptorTemplates) {
-        m_cmd->updateDescriptorSetWithTemplate(set,
-          layout->getSetUpdateTemplate(setIndex),
-          &m_descriptors[0]);
-        descriptorCount = 0;
+      // Skip the update entirely if we already wrote a
+      // set with identical contents for the current pool
+      bool found = false;
+
+      VkDescriptorSet set = m_descriptorPool->allocCached(layout, setIndex,
+        bindingCount, &m_descriptors[descriptorStart], found);
+      sets[setIndex] = set;
+
+      if (found) {
+        m_cmd->addStatCtr(DxvkStatCounter::DescriptorSetCacheHits, 1);
+        descriptorCount = descriptorStart;
+      } else {
+        m_cmd->addStatCtr(DxvkStatCounter::DescriptorSetCacheMisses, 1);
+
+        if (useDescriptorTemplates) {
+          m_cmd->updateDescriptorSetWithTemplate(set,
+            layout->getSetUpdateTemplate(setIndex),
+            &m_descriptors[0]);
+          descriptorCount = 0;
+        } else {
+          for (uint32_t j = descriptorStart; j < descriptorCount; j++)
+            m_descriptorWrites[j].dstSet = set;
+        }
       }
 
       // If the next set is not dirty, update and bind all previously
@@ -5328,7 +6437,218 @@ namespace dxvk {
         m_cmd->cmdBindDescriptorSets(BindPoint,
           layout->getPipelineLayout(independentSets),
           firstSet, setIndex - firstSet + 1, &sets[firstSet],
-          0, nullptr);
+          dynamicOffsetCount, dynamicOffsets.data());
+
+        dynamicOffsetCount = 0;
+      }
+    }
+  }
+
+
+  template<VkPipelineBindPoint BindPoint>
+  void DxvkContext::updateDescriptorBufferBindings(const DxvkBindingLayoutObjects* layout) {
+    const auto& bindings = layout->layout();
+
+    bool independentSets = BindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS
+                        && m_flags.test(DxvkContextFlag::GpIndependentSets);
+
+    uint32_t layoutSetMask = layout->getSetMask();
+    uint32_t dirtySetMask = BindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS
+      ? m_descriptorState.getDirtyGraphicsSets()
+      : m_descriptorState.getDirtyComputeSets();
+    dirtySetMask &= layoutSetMask;
+
+    if (!dirtySetMask)
+      return;
+
+    VkDeviceSize setAlignment = m_descriptorHeap.getSetAlignment();
+    VkDeviceSize dataSize = 0;
+
+    for (auto setIndex : bit::BitMask(dirtySetMask))
+      dataSize += align(layout->getSetSize(setIndex), setAlignment);
+
+    VkDeviceSize dataOffset = DxvkDescriptorHeap::InvalidOffset;
+    bool rebindBuffer = m_flags.test(DxvkContextFlag::DirtyDescriptorBuffer);
+
+    if (!rebindBuffer) {
+      dataOffset = m_descriptorHeap.alloc(dataSize);
+      rebindBuffer = dataOffset == DxvkDescriptorHeap::InvalidOffset;
+    }
+
+    if (rebindBuffer) {
+      // Binding a new buffer invalidates the set offsets of both
+      // bind points, so all sets need to be written again.
+      m_descriptorState.dirtyStages(
+        VK_SHADER_STAGE_ALL_GRAPHICS |
+        VK_SHADER_STAGE_COMPUTE_BIT);
+
+      dirtySetMask = layoutSetMask;
+      dataSize = 0;
+
+      for (auto setIndex : bit::BitMask(dirtySetMask))
+        dataSize += align(layout->getSetSize(setIndex), setAlignment);
+
+      dataOffset = m_descriptorHeap.alloc(dataSize);
+
+      if (dataOffset == DxvkDescriptorHeap::InvalidOffset) {
+        // A fresh buffer is guaranteed to fit all sets
+        m_descriptorHeap.reset(dataSize);
+        dataOffset = m_descriptorHeap.alloc(dataSize);
+      }
+
+      VkDescriptorBufferBindingInfoEXT bindingInfo = m_descriptorHeap.getBindingInfo();
+      m_cmd->cmdBindDescriptorBuffers(1, &bindingInfo);
+      m_cmd->trackResource<DxvkAccess::Read>(m_descriptorHeap.getBuffer());
+
+      m_flags.clr(DxvkContextFlag::DirtyDescriptorBuffer);
+    }
+
+    std::array<uint32_t, DxvkDescriptorSets::SetCount> bufferIndices = { };
+    std::array<VkDeviceSize, DxvkDescriptorSets::SetCount> setOffsets;
+
+    for (auto setIndex : bit::BitMask(dirtySetMask)) {
+      uint32_t bindingCount = bindings.getBindingCount(setIndex);
+
+      setOffsets[setIndex] = dataOffset;
+
+      for (uint32_t j = 0; j < bindingCount; j++) {
+        const auto& binding = bindings.getBinding(setIndex, j);
+        const auto& res = m_rc[binding.resourceBinding];
+
+        VkDescriptorGetInfoEXT descriptorInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT };
+        descriptorInfo.type = binding.descriptorType;
+
+        VkDescriptorImageInfo imageInfo = { };
+        VkDescriptorAddressInfoEXT addressInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT };
+        VkSampler sampler = VK_NULL_HANDLE;
+
+        switch (binding.descriptorType) {
+          case VK_DESCRIPTOR_TYPE_SAMPLER: {
+            if (res.sampler != nullptr) {
+              sampler = res.sampler->handle();
+
+              if (m_rcTracked.set(binding.resourceBinding))
+                m_cmd->trackResource<DxvkAccess::None>(res.sampler);
+            } else {
+              sampler = m_common->dummyResources().samplerHandle();
+            }
+
+            descriptorInfo.data.pSampler = &sampler;
+          } break;
+
+          case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+          case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: {
+            if (res.imageView != nullptr && res.imageView->handle(binding.viewType) != VK_NULL_HANDLE) {
+              imageInfo.imageView = res.imageView->handle(binding.viewType);
+              imageInfo.imageLayout = res.imageView->imageInfo().layout;
+
+              if (m_rcTracked.set(binding.resourceBinding)) {
+                m_cmd->trackResource<DxvkAccess::None>(res.imageView);
+
+                if (binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+                  m_cmd->trackResource<DxvkAccess::Write>(res.imageView->image());
+                else
+                  m_cmd->trackResource<DxvkAccess::Read>(res.imageView->image());
+              }
+            }
+
+            if (binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+              descriptorInfo.data.pStorageImage = &imageInfo;
+            else
+              descriptorInfo.data.pSampledImage = &imageInfo;
+          } break;
+
+          case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
+            if (res.sampler != nullptr && res.imageView != nullptr
+             && res.imageView->handle(binding.viewType) != VK_NULL_HANDLE) {
+              imageInfo.sampler = res.sampler->handle();
+              imageInfo.imageView = res.imageView->handle(binding.viewType);
+              imageInfo.imageLayout = res.imageView->imageInfo().layout;
+
+              if (m_rcTracked.set(binding.resourceBinding)) {
+                m_cmd->trackResource<DxvkAccess::None>(res.sampler);
+                m_cmd->trackResource<DxvkAccess::None>(res.imageView);
+                m_cmd->trackResource<DxvkAccess::Read>(res.imageView->image());
+              }
+            } else {
+              imageInfo.sampler = m_common->dummyResources().samplerHandle();
+            }
+
+            descriptorInfo.data.pCombinedImageSampler = &imageInfo;
+          } break;
+
+          case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+          case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: {
+            const VkDescriptorAddressInfoEXT* texelInfo = nullptr;
+
+            if (res.bufferView != nullptr) {
+              res.bufferView->updateView();
+
+              auto slice = res.bufferView->getSliceHandle();
+              addressInfo.address = m_descriptorHeap.getBufferAddress(slice);
+              addressInfo.range = slice.length;
+              addressInfo.format = res.bufferView->info().format;
+              texelInfo = &addressInfo;
+
+              if (m_rcTracked.set(binding.resourceBinding)) {
+                m_cmd->trackResource<DxvkAccess::None>(res.bufferView);
+
+                if (binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER)
+                  m_cmd->trackResource<DxvkAccess::Write>(res.bufferView->buffer());
+                else
+                  m_cmd->trackResource<DxvkAccess::Read>(res.bufferView->buffer());
+              }
+            }
+
+            if (binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER)
+              descriptorInfo.data.pStorageTexelBuffer = texelInfo;
+            else
+              descriptorInfo.data.pUniformTexelBuffer = texelInfo;
+          } break;
+
+          case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+          case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: {
+            const VkDescriptorAddressInfoEXT* bufferInfo = nullptr;
+
+            if (res.bufferSlice.length()) {
+              auto slice = res.bufferSlice.getSliceHandle();
+              addressInfo.address = m_descriptorHeap.getBufferAddress(slice);
+              addressInfo.range = slice.length;
+              bufferInfo = &addressInfo;
+
+              if (m_rcTracked.set(binding.resourceBinding)) {
+                if (binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                  m_cmd->trackResource<DxvkAccess::Write>(res.bufferSlice.buffer());
+                else
+                  m_cmd->trackResource<DxvkAccess::Read>(res.bufferSlice.buffer());
+              }
+            }
+
+            if (binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+              descriptorInfo.data.pStorageBuffer = bufferInfo;
+            else
+              descriptorInfo.data.pUniformBuffer = bufferInfo;
+          } break;
+
+          default:
+            continue;
+        }
+
+        m_descriptorHeap.writeDescriptor(descriptorInfo,
+          dataOffset + layout->getBindingOffset(setIndex, j));
+      }
+
+      dataOffset += align(layout->getSetSize(setIndex), setAlignment);
+
+      // Set offsets for consecutive dirty sets in one go
+      if (!(((dirtySetMask >> 1) >> setIndex) & 1u)) {
+        uint32_t firstSet = bit::tzcnt(dirtySetMask);
+        dirtySetMask &= (~1u) << setIndex;
+
+        m_cmd->cmdSetDescriptorBufferOffsets(BindPoint,
+          layout->getPipelineLayout(independentSets),
+          firstSet, setIndex - firstSet + 1,
+          &bufferIndices[firstSet], &setOffsets[firstSet]);
       }
     }
   }
@@ -5360,26 +6680,72 @@ namespace dxvk {
 
       this->spillRenderPass(true);
 
-      DxvkFramebufferInfo fbInfo = makeFramebufferInfo(m_state.om.renderTargets);
-      this->updateRenderTargetLayouts(fbInfo, m_state.om.framebufferInfo);
+      const DxvkFramebufferCacheEntry& fb = lookupFramebufferInfo(m_state.om.renderTargets);
+      this->updateRenderTargetLayouts(fb.info, m_state.om.framebufferInfo);
 
       // Update relevant graphics pipeline state
-      m_state.gp.state.ms.setSampleCount(fbInfo.getSampleCount());
-      m_state.gp.state.rt = fbInfo.getRtInfo();
-      m_state.om.framebufferInfo = fbInfo;
+      m_state.gp.state.ms.setSampleCount(fb.info.getSampleCount());
+      m_state.gp.state.rt = fb.rtInfo;
+      m_state.om.framebufferInfo = fb.info;
 
-      for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
-        const Rc<DxvkImageView>& attachment = fbInfo.getColorTarget(i).view;
+      for (uint32_t i = 0; i < MaxNumRenderTargets; i++)
+        m_state.gp.state.omSwizzle[i] = fb.omSwizzle[i];
+
+      m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
+    }
+  }
 
-        VkComponentMapping mapping = attachment != nullptr
-          ? util::invertComponentMapping(attachment->info().swizzle)
-          : VkComponentMapping();
 
-        m_state.gp.state.omSwizzle[i] = DxvkOmAttachmentSwizzle(mapping);
+  const DxvkFramebufferCacheEntry& DxvkContext::lookupFramebufferInfo(
+    const DxvkRenderTargets&      renderTargets) {
+    // Games commonly alternate between a small set of render
+    // targets, so look for a recently used entry first and
+    // move it to the front if we find one.
+    for (uint32_t i = 0; i < m_fbCacheSize; i++) {
+      if (m_fbCache[i].info.usesTargets(renderTargets)) {
+        std::rotate(m_fbCache.begin(), m_fbCache.begin() + i, m_fbCache.begin() + i + 1);
+        return m_fbCache[0];
       }
+    }
 
-      m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
+    // Evict the least recently used entry otherwise
+    m_fbCacheSize = std::min<uint32_t>(m_fbCacheSize + 1, m_fbCache.size());
+
+    std::rotate(m_fbCache.begin(), m_fbCache.begin() + m_fbCacheSize - 1, m_fbCache.begin() + m_fbCacheSize);
+
+    DxvkFramebufferCacheEntry& entry = m_fbCache[0];
+    entry.info = makeFramebufferInfo(renderTargets);
+    entry.rtInfo = entry.info.getRtInfo();
+
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      const Rc<DxvkImageView>& attachment = entry.info.getColorTarget(i).view;
+
+      VkComponentMapping mapping = attachment != nullptr
+        ? util::invertComponentMapping(attachment->info().swizzle)
+        : VkComponentMapping();
+
+      entry.omSwizzle[i] = DxvkOmAttachmentSwizzle(mapping);
+    }
+
+    return entry;
+  }
+
+
+  void DxvkContext::applyGeneralRenderTargetLayouts(
+          DxvkRenderTargets&    renderTargets) const {
+    // Read-only depth layouts are left alone since they
+    // affect which aspects the pipeline is allowed to write
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      DxvkAttachment& attachment = renderTargets.color[i];
+
+      if (attachment.view != nullptr && attachment.layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
+        attachment.layout = attachment.view->pickLayout(attachment.layout);
     }
+
+    DxvkAttachment& depth = renderTargets.depth;
+
+    if (depth.view != nullptr && depth.layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+      depth.layout = depth.view->pickLayout(depth.layout);
   }
 
 
@@ -5514,6 +6880,23 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::flushBarriersForAcquire(
+          std::initializer_list<const DxvkImage*> images) {
+    // Pending barriers can only be recorded together with the acquire
+    // barriers if none of the images to acquire have a pending layout
+    // transition, since both transitions would end up in the same
+    // pipeline barrier without a defined order.
+    for (const DxvkImage* image : images) {
+      if (m_execBarriers.hasImageBarriers(image->handle())) {
+        m_execBarriers.recordCommands(m_cmd);
+        return;
+      }
+    }
+
+    m_execAcquires.merge(m_execBarriers);
+  }
+
+
   void DxvkContext::prepareImage(
     const Rc<DxvkImage>&          image,
     const VkImageSubresourceRange& subresources,
@@ -5640,9 +7023,53 @@ namespace dxvk {
 
     // Vertex bindigs get remapped when compiling the
     // pipeline, so this actually does the right thing
-    m_cmd->cmdBindVertexBuffers(0, m_state.gp.state.il.bindingCount(),
-      buffers.data(), offsets.data(), lengths.data(),
-      newDynamicStrides ? strides.data() : nullptr);
+    uint32_t bindingCount = m_state.gp.state.il.bindingCount();
+
+    if (!m_vbBound.count || m_vbBound.dynamicStrides != newDynamicStrides) {
+      m_cmd->cmdBindVertexBuffers(0, bindingCount,
+        buffers.data(), offsets.data(), lengths.data(),
+        newDynamicStrides ? strides.data() : nullptr);
+
+      m_vbBound.count = bindingCount;
+      m_vbBound.dynamicStrides = newDynamicStrides;
+    } else {
+      // Merge adjacent bindings that changed since the last
+      // update into as few bind calls as possible
+      uint32_t first = 0u;
+      uint32_t count = 0u;
+
+      for (uint32_t i = 0; i <= bindingCount; i++) {
+        bool changed = i < bindingCount
+          && (i >= m_vbBound.count
+           || m_vbBound.buffers[i] != buffers[i]
+           || m_vbBound.offsets[i] != offsets[i]
+           || m_vbBound.lengths[i] != lengths[i]
+           || (newDynamicStrides && m_vbBound.strides[i] != strides[i]));
+
+        if (changed) {
+          if (!count)
+            first = i;
+
+          count += 1;
+        } else if (count) {
+          m_cmd->cmdBindVertexBuffers(first, count,
+            &buffers[first], &offsets[first], &lengths[first],
+            newDynamicStrides ? &strides[first] : nullptr);
+
+          count = 0u;
+        }
+      }
+
+      m_vbBound.count = std::max(m_vbBound.count, bindingCount);
+    }
+
+    for (uint32_t i = 0; i < bindingCount; i++) {
+      m_vbBound.buffers[i] = buffers[i];
+      m_vbBound.offsets[i] = offsets[i];
+      m_vbBound.lengths[i] = lengths[i];
+      m_vbBound.strides[i] = strides[i];
+    }
+
   }
   
   
@@ -5689,6 +7116,19 @@ namespace dxvk {
   }
 
   
+  DxvkOmAttachmentBlend DxvkContext::getPipelineBlendMode(uint32_t attachment) const {
+    const auto& blend = m_state.dyn.omBlend[attachment];
+
+    if (!m_state.gp.state.om.dynamicBlend())
+      return blend;
+
+    return DxvkOmAttachmentBlend(VK_FALSE,
+      VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+      VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+      blend.colorWriteMask());
+  }
+
+
   void DxvkContext::updateDynamicState() {
     if (unlikely(m_flags.test(DxvkContextFlag::GpDirtyViewport))) {
       m_flags.clr(DxvkContextFlag::GpDirtyViewport);
@@ -5762,6 +7202,46 @@ namespace dxvk {
       m_cmd->cmdSetBlendConstants(&m_state.dyn.blendConstants.r);
     }
 
+    if (unlikely(m_flags.all(DxvkContextFlag::GpDirtyBlendState,
+                             DxvkContextFlag::GpDynamicBlendState))) {
+      m_flags.clr(DxvkContextFlag::GpDirtyBlendState);
+
+      std::array<VkBool32,                MaxNumRenderTargets> blendEnables   = { };
+      std::array<VkColorBlendEquationEXT, MaxNumRenderTargets> blendEquations = { };
+
+      uint32_t attachmentCount = 0;
+
+      for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+        VkFormat format = m_state.gp.state.rt.getColorFormat(i);
+
+        if (!format)
+          continue;
+
+        const auto& blend = m_state.dyn.omBlend[i];
+
+        attachmentCount = i + 1;
+        blendEnables[i] = blend.blendEnable();
+        blendEquations[i] = blend.equation();
+
+        // Fix up blending for emulated alpha-only render targets
+        // the same way that pipeline compilation would
+        auto formatInfo = lookupFormatInfo(format);
+
+        if (blendEnables[i] && formatInfo->componentMask == VK_COLOR_COMPONENT_R_BIT
+         && m_state.gp.state.omSwizzle[i].rIndex() == 3) {
+          auto& eq = blendEquations[i];
+          eq.srcColorBlendFactor = util::remapAlphaToColorBlendFactor(
+            std::exchange(eq.srcAlphaBlendFactor, VK_BLEND_FACTOR_ONE));
+          eq.dstColorBlendFactor = util::remapAlphaToColorBlendFactor(
+            std::exchange(eq.dstAlphaBlendFactor, VK_BLEND_FACTOR_ZERO));
+          eq.colorBlendOp = std::exchange(eq.alphaBlendOp, VK_BLEND_OP_ADD);
+        }
+      }
+
+      if (attachmentCount)
+        m_cmd->cmdSetBlendState(attachmentCount, blendEnables.data(), blendEquations.data());
+    }
+
     if (m_flags.all(DxvkContextFlag::GpDirtyRasterizerState,
                     DxvkContextFlag::GpDynamicRasterizerState)) {
       m_flags.clr(DxvkContextFlag::GpDirtyRasterizerState);
@@ -5882,6 +7362,13 @@ namespace dxvk {
     if (m_flags.test(DxvkContextFlag::GpDirtySpecConstants))
       this->updateSpecConstants<VK_PIPELINE_BIND_POINT_GRAPHICS>();
 
+    // If a base pipeline is bound, swap in the optimized variant as soon
+    // as it becomes available, rather than waiting for a state change.
+    if (unlikely(m_flags.test(DxvkContextFlag::GpIndependentSets))) {
+      if (m_state.gp.pipeline->getOptimizedPipelineCount() != m_state.gp.optimizedCount)
+        m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
+    }
+
     if (m_flags.test(DxvkContextFlag::GpDirtyPipelineState)) {
       DxvkGlobalPipelineBarrier barrier = { };
 
@@ -5904,6 +7391,9 @@ namespace dxvk {
     
     if (m_state.gp.flags.test(DxvkGraphicsPipelineFlag::HasTransformFeedback))
       this->updateTransformFeedbackState();
+
+    if (unlikely(m_state.cond.predicate.defined()))
+      this->startConditionalRendering();
     
     this->updateDynamicState();
     
@@ -5913,6 +7403,9 @@ namespace dxvk {
     if (m_flags.test(DxvkContextFlag::DirtyDrawBuffer) && Indirect)
       this->trackDrawBuffer();
 
+    if (unlikely(m_flags.test(DxvkContextFlag::GpIndependentSets)))
+      m_cmd->addStatCtr(DxvkStatCounter::CmdDrawCallsBase, 1);
+
     return true;
   }
   
@@ -6335,14 +7828,23 @@ namespace dxvk {
   void DxvkContext::beginCurrentCommands() {
     // Mark all resources as untracked
     m_vbTracked.clear();
+    m_vbBound.count = 0;
     m_rcTracked.clear();
 
+    // Cached framebuffer infos keep their views alive,
+    // so don't hold on to them across submissions
+    for (uint32_t i = 0; i < m_fbCacheSize; i++)
+      m_fbCache[i].info = DxvkFramebufferInfo();
+
+    m_fbCacheSize = 0;
+
     // The current state of the internal command buffer is
     // undefined, so we have to bind and set up everything
     // before any draw or dispatch command is recorded.
     m_flags.clr(
       DxvkContextFlag::GpRenderPassBound,
       DxvkContextFlag::GpXfbActive,
+      DxvkContextFlag::GpCondActive,
       DxvkContextFlag::GpIndependentSets);
 
     m_flags.set(
@@ -6353,6 +7855,7 @@ namespace dxvk {
       DxvkContextFlag::GpDirtyIndexBuffer,
       DxvkContextFlag::GpDirtyXfbBuffers,
       DxvkContextFlag::GpDirtyBlendConstants,
+      DxvkContextFlag::GpDirtyBlendState,
       DxvkContextFlag::GpDirtyStencilRef,
       DxvkContextFlag::GpDirtyMultisampleState,
       DxvkContextFlag::GpDirtyRasterizerState,
@@ -6361,7 +7864,8 @@ namespace dxvk {
       DxvkContextFlag::GpDirtyDepthBounds,
       DxvkContextFlag::GpDirtyDepthStencilState,
       DxvkContextFlag::CpDirtyPipelineState,
-      DxvkContextFlag::DirtyDrawBuffer);
+      DxvkContextFlag::DirtyDrawBuffer,
+      DxvkContextFlag::DirtyDescriptorBuffer);
 
     m_descriptorState.dirtyStages(
       VK_SHADER_STAGE_ALL_GRAPHICS |
@@ -6382,6 +7886,45 @@ namespace dxvk {
   }
 
 
+  void DxvkContext::beginProfiledPass(
+    const char*                 name) {
+    if (m_passQuery != nullptr)
+      this->endProfiledPass();
+
+    m_passName = m_debugLabels.empty()
+      ? std::string(name)
+      : m_debugLabels.back();
+
+    m_passQuery = m_device->createGpuQuery(VK_QUERY_TYPE_TIMESTAMP, 0, 0);
+    this->writeTimestamp(m_passQuery);
+
+    // The query manager begins and ends the statistics query
+    // around every draw and dispatch recorded within the pass
+    if (unlikely(m_device->gpuProfiler().hasPipelineStats())) {
+      m_passStatsQuery = m_device->createGpuQuery(VK_QUERY_TYPE_PIPELINE_STATISTICS, 0, 0);
+      this->beginQuery(m_passStatsQuery);
+    }
+  }
+
+
+  void DxvkContext::endProfiledPass() {
+    Rc<DxvkGpuQuery> endQuery = m_device->createGpuQuery(VK_QUERY_TYPE_TIMESTAMP, 0, 0);
+    this->writeTimestamp(endQuery);
+
+    if (m_passStatsQuery != nullptr)
+      this->endQuery(m_passStatsQuery);
+
+    if (unlikely(m_device->tracer())) {
+      m_device->tracer()->addGpuPass(std::string(m_passName),
+        m_passQuery, endQuery, m_passStatsQuery);
+    }
+
+    m_device->gpuProfiler().addPass(std::move(m_passName),
+      std::exchange(m_passQuery, nullptr), endQuery,
+      std::exchange(m_passStatsQuery, nullptr));
+  }
+
+
   void DxvkContext::splitCommands() {
     // This behaves the same as a pair of endRecording and
     // beginRecording calls, except that we keep the same
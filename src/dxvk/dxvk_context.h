@@ -5,6 +5,7 @@
 #include "dxvk_cmdlist.h"
 #include "dxvk_context_state.h"
 #include "dxvk_data.h"
+#include "dxvk_descriptor_heap.h"
 #include "dxvk_objects.h"
 #include "dxvk_queue.h"
 #include "dxvk_resource.h"
@@ -22,6 +23,8 @@ namespace dxvk {
    */
   class DxvkContext : public RcObject {
     constexpr static VkDeviceSize StagingBufferSize = 4ull << 20;
+    constexpr static VkDeviceSize DescriptorHeapSize = 1ull << 20;
+    constexpr static uint32_t MaxPackedCopiesPerImage = 4;
   public:
     
     DxvkContext(const Rc<DxvkDevice>& device, DxvkContextType type);
@@ -95,6 +98,9 @@ namespace dxvk {
       // Set up default render pass ops
       m_state.om.renderTargets = std::move(targets);
 
+      if (unlikely(m_features.test(DxvkContextFeature::GeneralLayout)))
+        this->applyGeneralRenderTargetLayouts(m_state.om.renderTargets);
+
       if (unlikely(m_state.gp.state.om.feedbackLoop() != feedbackLoop)) {
         m_state.gp.state.om.setFeedbackLoop(feedbackLoop);
         m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
@@ -191,7 +197,8 @@ namespace dxvk {
 
       m_rc[slot].bufferSlice = std::move(buffer);
 
-      m_descriptorState.dirtyBuffers(stages);
+      if (isResourceSlotActive(slot))
+        m_descriptorState.dirtyBuffers(stages);
     }
 
     /**
@@ -207,7 +214,8 @@ namespace dxvk {
             VkDeviceSize          length) {
       m_rc[slot].bufferSlice.setRange(offset, length);
 
-      m_descriptorState.dirtyBuffers(stages);
+      if (isResourceSlotActive(slot))
+        m_descriptorState.dirtyBuffers(stages);
     }
     
     /**
@@ -221,6 +229,11 @@ namespace dxvk {
             VkShaderStageFlags    stages,
             uint32_t              slot,
             Rc<DxvkImageView>&&   view) {
+      // Rebinding the same view does not change any
+      // descriptors, so avoid rewriting descriptor sets
+      if (m_rc[slot].imageView == view && m_rc[slot].bufferView == nullptr)
+        return;
+
       if (m_rc[slot].bufferView != nullptr) {
         m_rc[slot].bufferSlice = DxvkBufferSlice();
         m_rc[slot].bufferView  = nullptr;
@@ -229,7 +242,8 @@ namespace dxvk {
       m_rc[slot].imageView = std::move(view);
       m_rcTracked.clr(slot);
 
-      m_descriptorState.dirtyViews(stages);
+      if (isResourceSlotActive(slot))
+        m_descriptorState.dirtyViews(stages);
     }
 
     /**
@@ -243,11 +257,24 @@ namespace dxvk {
             VkShaderStageFlags    stages,
             uint32_t              slot,
             Rc<DxvkBufferView>&&  view) {
+      if (view != nullptr && m_rc[slot].bufferView == view
+       && view->matchesSlice(m_rc[slot].bufferSlice))
+        return;
+
       if (m_rc[slot].imageView != nullptr)
         m_rc[slot].imageView = nullptr;
 
       if (view != nullptr) {
-        m_rc[slot].bufferSlice = view->slice();
+        // Views are frequently rebound for the same buffer, only
+        // replace the buffer reference if it actually changes.
+        if (m_rc[slot].bufferSlice.buffer() == view->buffer()) {
+          m_rc[slot].bufferSlice.setRange(
+            view->info().rangeOffset,
+            view->info().rangeLength);
+        } else {
+          m_rc[slot].bufferSlice = view->slice();
+        }
+
         m_rc[slot].bufferView = std::move(view);
       } else {
         m_rc[slot].bufferSlice = DxvkBufferSlice();
@@ -256,7 +283,8 @@ namespace dxvk {
 
       m_rcTracked.clr(slot);
 
-      m_descriptorState.dirtyViews(stages);
+      if (isResourceSlotActive(slot))
+        m_descriptorState.dirtyViews(stages);
     }
 
     /**
@@ -272,10 +300,14 @@ namespace dxvk {
             VkShaderStageFlags    stages,
             uint32_t              slot,
             Rc<DxvkSampler>&&     sampler) {
+      if (m_rc[slot].sampler == sampler)
+        return;
+
       m_rc[slot].sampler = std::move(sampler);
       m_rcTracked.clr(slot);
 
-      m_descriptorState.dirtyViews(stages);
+      if (isResourceSlotActive(slot))
+        m_descriptorState.dirtyViews(stages);
     }
 
     /**
@@ -367,19 +399,20 @@ namespace dxvk {
     /**
      * \brief Binds transform feedback buffer
      * 
+     * If \c resetCounter is set, the counter is not written
+     * immediately. Instead, the next transform feedback pass
+     * starts writing at the beginning of the buffer, which
+     * avoids breaking the current render pass.
      * \param [in] binding Xfb buffer binding
      * \param [in] buffer The buffer to bind
      * \param [in] counter Xfb counter buffer
+     * \param [in] resetCounter Whether to reset the counter to zero
      */
     void bindXfbBuffer(
             uint32_t              binding,
             DxvkBufferSlice&&     buffer,
-            DxvkBufferSlice&&     counter) {
-      m_state.xfb.buffers [binding] = std::move(buffer);
-      m_state.xfb.counters[binding] = std::move(counter);
-
-      m_flags.set(DxvkContextFlag::GpDirtyXfbBuffers);
-    }
+            DxvkBufferSlice&&     counter,
+            bool                  resetCounter = false);
 
     /**
      * \brief Blits an image
@@ -474,6 +507,25 @@ namespace dxvk {
             VkExtent3D            extent,
             VkImageAspectFlags    aspect,
             VkClearValue          value);
+
+    /**
+     * \brief Clears multiple rects of an image view
+     *
+     * Behaves like \ref clearImageView for each rect, except
+     * that for render target views, all rects are cleared
+     * with a single clear operation.
+     * \param [in] imageView The image view
+     * \param [in] rectCount Number of rects to clear
+     * \param [in] rects Rects to clear
+     * \param [in] aspect Aspect mask to clear
+     * \param [in] value The clear value
+     */
+    void clearImageViewRects(
+      const Rc<DxvkImageView>&    imageView,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
+            VkImageAspectFlags    aspect,
+            VkClearValue          value);
     
     /**
      * \brief Copies data from one buffer to another
@@ -552,6 +604,24 @@ namespace dxvk {
             VkOffset3D            srcOffset,
             VkExtent3D            extent);
     
+    /**
+     * \brief Copies multiple regions into an image
+     *
+     * Equivalent to calling \ref copyImage for each region,
+     * but records regions that use the same source image
+     * with a single copy command, and only emits one set of
+     * barriers for the destination image. Destination
+     * regions must not overlap, and source images must be
+     * different from the destination image.
+     * \param [in] dstImage Destination image
+     * \param [in] regionCount Number of regions
+     * \param [in] regions Copy regions
+     */
+    void copyImageBatch(
+      const Rc<DxvkImage>&        dstImage,
+            uint32_t              regionCount,
+      const DxvkImageCopyRegion*  regions);
+    
     /**
      * \brief Copies overlapping image region
      *
@@ -1160,6 +1230,20 @@ namespace dxvk {
      */
     void setStencilReference(
             uint32_t            reference);
+
+    /**
+     * \brief Sets predicate for conditional rendering
+     *
+     * Subsequent draws will be skipped depending on the 32-bit
+     * value stored in the given buffer. Requires the conditional
+     * rendering feature to be enabled on the device.
+     * \param [in] predicate Predicate buffer slice, or an
+     *    undefined slice to disable conditional rendering
+     * \param [in] flags Conditional rendering flags
+     */
+    void setPredicate(
+      const DxvkBufferSlice&    predicate,
+            VkConditionalRenderingFlagsEXT flags);
     
     /**
      * \brief Sets input assembly state
@@ -1298,6 +1382,21 @@ namespace dxvk {
      */
     void writeTimestamp(
       const Rc<DxvkGpuQuery>&   query);
+
+    /**
+     * \brief Writes occlusion query result to a predicate
+     *
+     * Writes a non-zero value to the predicate if any samples
+     * passed. If the result cannot be copied on the GPU, e.g.
+     * because it spans multiple command lists, the predicate
+     * is conservatively set to a non-zero value. The query
+     * must have been ended before calling this.
+     * \param [in] predicate Predicate buffer slice
+     * \param [in] query Occlusion query
+     */
+    void writePredicate(
+      const DxvkBufferSlice&    predicate,
+      const Rc<DxvkGpuQuery>&   query);
     
     /**
      * \brief Queues a signal
@@ -1387,13 +1486,27 @@ namespace dxvk {
     DxvkObjects*            m_common;
     
     Rc<DxvkCommandList>     m_cmd;
+    Rc<DxvkGpuQuery>        m_traceQuery;
+    Rc<DxvkGpuQuery>        m_passQuery;
+    Rc<DxvkGpuQuery>        m_passStatsQuery;
+    std::string             m_passName;
+    std::vector<std::string> m_debugLabels;
     Rc<DxvkBuffer>          m_zeroBuffer;
 
+    // Per-draw state, kept together and starting on its
+    // own cache line since commitGraphicsState reads all
+    // of it for every draw call
+    alignas(CACHE_LINE_SIZE)
     DxvkContextFlags        m_flags;
-    DxvkContextState        m_state;
     DxvkContextFeatures     m_features;
     DxvkDescriptorState     m_descriptorState;
 
+    DxvkBindingSet<MaxNumVertexBindings + 1>  m_vbTracked;
+    DxvkVertexBufferBindings                  m_vbBound;
+    DxvkBindingSet<MaxNumResourceSlots>       m_rcTracked;
+
+    DxvkContextState        m_state;
+
     Rc<DxvkDescriptorPool>  m_descriptorPool;
     Rc<DxvkDescriptorManager> m_descriptorManager;
 
@@ -1406,23 +1519,32 @@ namespace dxvk {
 
     DxvkGpuQueryManager     m_queryManager;
     DxvkStagingBuffer       m_staging;
+    DxvkDescriptorHeap      m_descriptorHeap;
     
     DxvkGlobalPipelineBarrier m_globalRoGraphicsBarrier;
     DxvkGlobalPipelineBarrier m_globalRwGraphicsBarrier;
 
     DxvkRenderTargetLayouts m_rtLayouts = { };
 
-    DxvkBindingSet<MaxNumVertexBindings + 1>  m_vbTracked;
-    DxvkBindingSet<MaxNumResourceSlots>       m_rcTracked;
+    std::array<DxvkFramebufferCacheEntry, 4> m_fbCache;
+    uint32_t                                 m_fbCacheSize = 0;
+
+    uint32_t                m_asyncFrameId      = 0;
+    uint32_t                m_asyncSkipFrames   = 0;
+    uint64_t                m_asyncStallTime    = 0;
+    bool                    m_asyncSkippedDraws = false;
 
     std::vector<DxvkDeferredClear> m_deferredClears;
 
+    DxvkSecondaryRenderPass m_secondaryPass = { };
+
     std::vector<VkWriteDescriptorSet> m_descriptorWrites;
     std::vector<DxvkDescriptorInfo>   m_descriptors;
 
     std::array<DxvkShaderResourceSlot, MaxNumResourceSlots>  m_rc;
     std::array<DxvkGraphicsPipeline*, 4096> m_gpLookupCache = { };
     std::array<DxvkComputePipeline*,   256> m_cpLookupCache = { };
+    uint32_t                                m_lookupCacheInvalidations = 0;
 
     void blitImageFb(
       const Rc<DxvkImage>&        dstImage,
@@ -1461,8 +1583,8 @@ namespace dxvk {
 
     void clearImageViewFb(
       const Rc<DxvkImageView>&    imageView,
-            VkOffset3D            offset,
-            VkExtent3D            extent,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
             VkImageAspectFlags    aspect,
             VkClearValue          value);
     
@@ -1500,6 +1622,38 @@ namespace dxvk {
             VkOffset3D            srcOffset,
             VkExtent3D            extent);
 
+    bool findPackedCopy(
+      const Rc<DxvkBuffer>&       dstBuffer,
+            VkDeviceSize          dstBufferOffset,
+      const Rc<DxvkImage>&        srcImage,
+            DxvkImagePackedCopy&  packedCopy);
+
+    void addPackedCopy(
+      const Rc<DxvkBuffer>&       dstBuffer,
+            VkDeviceSize          dstBufferOffset,
+      const Rc<DxvkImage>&        srcImage,
+            DxvkImagePackedCopy&  packedCopy);
+
+    bool resolveImageInline(
+      const Rc<DxvkImage>&            dstImage,
+      const Rc<DxvkImage>&            srcImage,
+      const VkImageResolve&           region,
+            VkFormat                  format);
+
+    bool useFbForImageCopy(
+      const Rc<DxvkImage>&        dstImage,
+            VkImageSubresourceLayers dstSubresource,
+      const Rc<DxvkImage>&        srcImage,
+            VkImageSubresourceLayers srcSubresource) const;
+
+    bool canGenerateMipmapsCompute(
+      const Rc<DxvkImageView>&    imageView,
+            VkFilter              filter) const;
+
+    void generateMipmapsCompute(
+      const Rc<DxvkImageView>&    imageView,
+            VkFilter              filter);
+
     bool copyImageClear(
       const Rc<DxvkImage>&        dstImage,
             VkImageSubresourceLayers dstSubresource,
@@ -1596,6 +1750,11 @@ namespace dxvk {
       const DxvkFramebufferInfo&  framebufferInfo,
       const DxvkRenderPassOps&    ops);
     
+    bool canUseSecondaryRenderPass(
+      const DxvkFramebufferInfo&  framebufferInfo) const;
+
+    void renderPassExecuteSecondary();
+
     void renderPassUnbindFramebuffer();
     
     void resetRenderPassOps(
@@ -1604,6 +1763,11 @@ namespace dxvk {
 
     void startTransformFeedback();
     void pauseTransformFeedback();
+
+    void resolveXfbCounterResets(uint32_t mask);
+
+    void startConditionalRendering();
+    void pauseConditionalRendering();
     
     void unbindComputePipeline();
     bool updateComputePipelineState();
@@ -1612,6 +1776,8 @@ namespace dxvk {
     bool updateGraphicsPipeline();
     bool updateGraphicsPipelineState(DxvkGlobalPipelineBarrier srcBarrier);
 
+    std::pair<VkPipeline, DxvkGraphicsPipelineType> getGraphicsPipelineHandleAsync();
+
     template<VkPipelineBindPoint BindPoint>
     void resetSpecConstants(
             uint32_t                newMask);
@@ -1624,6 +1790,9 @@ namespace dxvk {
     template<VkPipelineBindPoint BindPoint>
     void updateResourceBindings(const DxvkBindingLayoutObjects* layout);
 
+    template<VkPipelineBindPoint BindPoint>
+    void updateDescriptorBufferBindings(const DxvkBindingLayoutObjects* layout);
+
     void updateComputeShaderResources();
     void updateGraphicsShaderResources();
 
@@ -1631,7 +1800,13 @@ namespace dxvk {
       const DxvkRenderTargets&      renderTargets);
 
     void updateFramebuffer();
+
+    const DxvkFramebufferCacheEntry& lookupFramebufferInfo(
+      const DxvkRenderTargets&      renderTargets);
     
+    void applyGeneralRenderTargetLayouts(
+            DxvkRenderTargets&    renderTargets) const;
+
     void applyRenderTargetLoadLayouts();
 
     void applyRenderTargetStoreLayouts();
@@ -1656,12 +1831,18 @@ namespace dxvk {
       const VkImageSubresourceRange& subresources,
             bool                    flushClears = true);
 
+    void flushBarriersForAcquire(
+            std::initializer_list<const DxvkImage*> images);
+
     bool updateIndexBufferBinding();
     void updateVertexBufferBindings();
 
     void updateTransformFeedbackBuffers();
     void updateTransformFeedbackState();
 
+    DxvkOmAttachmentBlend getPipelineBlendMode(
+            uint32_t                attachment) const;
+
     void updateDynamicState();
 
     template<VkPipelineBindPoint BindPoint>
@@ -1731,6 +1912,19 @@ namespace dxvk {
 
     void splitCommands();
 
+    void beginProfiledPass(
+      const char*                 name);
+
+    void endProfiledPass();
+
+    bool isResourceSlotActive(uint32_t slot) const {
+      // Binding a new pipeline dirties all of its descriptor
+      // sets anyway, so slots that neither of the currently
+      // bound pipelines use need not invalidate any sets.
+      return (m_state.gp.pipeline && m_state.gp.pipeline->getBindings()->usesResourceSlot(slot))
+          || (m_state.cp.pipeline && m_state.cp.pipeline->getBindings()->usesResourceSlot(slot));
+    }
+
   };
   
 }
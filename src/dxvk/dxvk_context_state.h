@@ -23,7 +23,9 @@ namespace dxvk {
   enum class DxvkContextFlag : uint32_t  {
     GpRenderPassBound,          ///< Render pass is currently bound
     GpRenderPassSuspended,      ///< Render pass is currently suspended
+    GpRenderPassSecondaryCmds,  ///< Render pass is recorded into a secondary command buffer
     GpXfbActive,                ///< Transform feedback is enabled
+    GpCondActive,               ///< Conditional rendering is enabled
     GpDirtyFramebuffer,         ///< Framebuffer binding is out of date
     GpDirtyPipeline,            ///< Graphics pipeline binding is out of date
     GpDirtyPipelineState,       ///< Graphics pipeline needs to be recompiled
@@ -31,6 +33,7 @@ namespace dxvk {
     GpDirtyIndexBuffer,         ///< Index buffer binding are out of date
     GpDirtyXfbBuffers,          ///< Transform feedback buffer bindings are out of date
     GpDirtyBlendConstants,      ///< Blend constants have changed
+    GpDirtyBlendState,          ///< Blend enable and equations have changed
     GpDirtyDepthStencilState,   ///< Depth-stencil state has changed
     GpDirtyDepthBias,           ///< Depth bias has changed
     GpDirtyDepthBounds,         ///< Depth bounds have changed
@@ -40,6 +43,7 @@ namespace dxvk {
     GpDirtyViewport,            ///< Viewport state has changed
     GpDirtySpecConstants,       ///< Graphics spec constants are out of date
     GpDynamicBlendConstants,    ///< Blend constants are dynamic
+    GpDynamicBlendState,        ///< Blend enable and equations are dynamic
     GpDynamicDepthStencilState, ///< Depth-stencil state is dynamic
     GpDynamicDepthBias,         ///< Depth bias is dynamic
     GpDynamicDepthBounds,       ///< Depth bounds are dynamic
@@ -54,6 +58,7 @@ namespace dxvk {
     
     DirtyDrawBuffer,            ///< Indirect argument buffer is dirty
     DirtyPushConstants,         ///< Push constant data has changed
+    DirtyDescriptorBuffer,      ///< Descriptor buffer needs to be bound
   };
   
   using DxvkContextFlags = Flags<DxvkContextFlag>;
@@ -65,6 +70,10 @@ namespace dxvk {
   enum class DxvkContextFeature : uint32_t {
     TrackGraphicsPipeline,
     VariableMultisampleRate,
+    AsyncPipelineCompile,
+    RenderPassResolve,
+    DynamicBlendState,
+    GeneralLayout,
     FeatureCount
   };
 
@@ -99,8 +108,43 @@ namespace dxvk {
     std::array<uint32_t,        DxvkLimits::MaxNumVertexBindings> vertexStrides = { };
     std::array<uint32_t,        DxvkLimits::MaxNumVertexBindings> vertexExtents = { };
   };
+
+
+  /**
+   * \brief Vertex buffer bindings
+   *
+   * Stores the vertex buffer bindings that were last
+   * set in the current command buffer, so that only
+   * bindings that actually changed get updated. Only
+   * the first \c count bindings are known to be valid.
+   */
+  struct DxvkVertexBufferBindings {
+    uint32_t count          = 0;
+    bool     dynamicStrides = false;
+
+    std::array<VkBuffer,     DxvkLimits::MaxNumVertexBindings> buffers = { };
+    std::array<VkDeviceSize, DxvkLimits::MaxNumVertexBindings> offsets = { };
+    std::array<VkDeviceSize, DxvkLimits::MaxNumVertexBindings> lengths = { };
+    std::array<VkDeviceSize, DxvkLimits::MaxNumVertexBindings> strides = { };
+  };
   
   
+  /**
+   * \brief Framebuffer cache entry
+   *
+   * Stores a framebuffer description along with the
+   * pipeline state derived from it, so that switching
+   * back to recently used render targets does not need
+   * to recompute any of it.
+   */
+  struct DxvkFramebufferCacheEntry {
+    DxvkFramebufferInfo     info;
+    DxvkRtInfo              rtInfo;
+
+    std::array<DxvkOmAttachmentSwizzle, DxvkLimits::MaxNumRenderTargets> omSwizzle = { };
+  };
+
+
   struct DxvkViewportState {
     uint32_t viewportCount = 0;
     std::array<VkViewport, DxvkLimits::MaxNumViewports> viewports    = { };
@@ -123,9 +167,16 @@ namespace dxvk {
   struct DxvkXfbState {
     std::array<DxvkBufferSlice, MaxNumXfbBuffers> buffers;
     std::array<DxvkBufferSlice, MaxNumXfbBuffers> counters;
+    uint32_t                                      counterResetMask = 0u;
   };
   
   
+  struct DxvkCondRenderState {
+    DxvkBufferSlice                 predicate;
+    VkConditionalRenderingFlagsEXT  flags = 0;
+  };
+
+
   struct DxvkSpecConstantState {
     uint32_t                                  mask = 0;
     std::array<uint32_t, MaxNumSpecConstants> data = { };
@@ -133,10 +184,11 @@ namespace dxvk {
   
   
   struct DxvkGraphicsPipelineState {
-    DxvkGraphicsPipelineShaders   shaders;
-    DxvkGraphicsPipelineStateInfo state;
     DxvkGraphicsPipelineFlags     flags;
     DxvkGraphicsPipeline*         pipeline = nullptr;
+    uint32_t                      optimizedCount = 0;
+    DxvkGraphicsPipelineShaders   shaders;
+    DxvkGraphicsPipelineStateInfo state;
     DxvkSpecConstantState         constants;
   };
   
@@ -156,6 +208,8 @@ namespace dxvk {
     uint32_t            stencilReference  = 0;
     VkCullModeFlags     cullMode          = VK_CULL_MODE_BACK_BIT;
     VkFrontFace         frontFace         = VK_FRONT_FACE_CLOCKWISE;
+
+    std::array<DxvkOmAttachmentBlend, DxvkLimits::MaxNumRenderTargets> omBlend = { };
   };
 
 
@@ -165,6 +219,23 @@ namespace dxvk {
     VkImageAspectFlags clearAspects;
     VkClearValue clearValue;
   };
+
+
+  /**
+   * \brief Render pass recorded into a secondary command buffer
+   *
+   * Stores the rendering info of the current render pass
+   * instance, which only gets begun in the primary command
+   * buffer once the render pass ends. This allows adding
+   * resolve attachments after recording the contents.
+   */
+  struct DxvkSecondaryRenderPass {
+    VkRenderingInfo renderingInfo;
+    std::array<VkRenderingAttachmentInfo, MaxNumRenderTargets> colorInfos;
+    VkRenderingAttachmentInfo depthInfo;
+    VkRenderingAttachmentInfo stencilInfo;
+    std::array<Rc<DxvkImageView>, MaxNumRenderTargets> resolveViews;
+  };
   
   
   /**
@@ -172,17 +243,20 @@ namespace dxvk {
    * 
    * Stores all bound shaders, resources,
    * and constant pipeline state objects.
+   * State that is read on every draw comes
+   * first so that it shares cache lines.
    */
   struct DxvkContextState {
-    DxvkIndirectDrawState     id;
+    DxvkGraphicsPipelineState gp;
     DxvkVertexInputState      vi;
-    DxvkViewportState         vp;
-    DxvkOutputMergerState     om;
-    DxvkPushConstantState     pc;
+    DxvkIndirectDrawState     id;
     DxvkXfbState              xfb;
+    DxvkCondRenderState       cond;
+    DxvkPushConstantState     pc;
     DxvkDynamicState          dyn;
+    DxvkViewportState         vp;
+    DxvkOutputMergerState     om;
     
-    DxvkGraphicsPipelineState gp;
     DxvkComputePipelineState  cp;
   };
   
@@ -25,8 +25,8 @@ namespace dxvk {
       
       while (cmd != nullptr) {
         auto next = cmd->next();
-        cmd->exec(ctx);
-        cmd->~DxvkCsCmd();
+        executeCmd(cmd, ctx);
+        destroyCmd(cmd);
         cmd = next;
       }
 
@@ -34,7 +34,7 @@ namespace dxvk {
       m_tail = nullptr;
     } else {
       while (cmd != nullptr) {
-        cmd->exec(ctx);
+        executeCmd(cmd, ctx);
         cmd = cmd->next();
       }
     }
@@ -46,7 +46,7 @@ namespace dxvk {
 
     while (cmd != nullptr) {
       auto next = cmd->next();
-      cmd->~DxvkCsCmd();
+      destroyCmd(cmd);
       cmd = next;
     }
     
@@ -63,24 +63,46 @@ namespace dxvk {
   
   
   DxvkCsChunkPool::~DxvkCsChunkPool() {
-    for (DxvkCsChunk* chunk : m_chunks)
-      delete chunk;
+    freeChunks(m_freeList.exchange(nullptr));
+
+    for (auto& slot : m_cache)
+      freeChunks(slot.chunks.exchange(nullptr));
   }
   
   
   DxvkCsChunk* DxvkCsChunkPool::allocChunk(DxvkCsChunkFlags flags) {
-    DxvkCsChunk* chunk = nullptr;
+    CacheSlot& slot = m_cache[getCacheSlot()];
+
+    // Take ownership of the entire cached list so that no
+    // other thread can pop from it while we're using it
+    DxvkCsChunk* chunk = slot.chunks.exchange(nullptr, std::memory_order_acquire);
 
-    { std::lock_guard<dxvk::mutex> lock(m_mutex);
-      
-      if (m_chunks.size() != 0) {
-        chunk = m_chunks.back();
-        m_chunks.pop_back();
-      }
-    }
-    
     if (!chunk)
+      chunk = m_freeList.exchange(nullptr, std::memory_order_acquire);
+
+    if (likely(chunk != nullptr)) {
+      DxvkCsChunk* head = chunk->m_nextFree;
+      chunk->m_nextFree = nullptr;
+
+      // Return remaining chunks to the cache. If another thread
+      // mapped to the same slot has populated it in the meantime,
+      // move our list back to the global free list instead.
+      if (head) {
+        DxvkCsChunk* expected = nullptr;
+
+        if (!slot.chunks.compare_exchange_strong(expected, head,
+            std::memory_order_release, std::memory_order_relaxed)) {
+          DxvkCsChunk* tail = head;
+
+          while (tail->m_nextFree)
+            tail = tail->m_nextFree;
+
+          pushChunks(m_freeList, head, tail);
+        }
+      }
+    } else {
       chunk = new DxvkCsChunk();
+    }
     
     chunk->init(flags);
     return chunk;
@@ -89,9 +111,39 @@ namespace dxvk {
   
   void DxvkCsChunkPool::freeChunk(DxvkCsChunk* chunk) {
     chunk->reset();
-    
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
-    m_chunks.push_back(chunk);
+    pushChunks(m_freeList, chunk, chunk);
+  }
+
+
+  void DxvkCsChunkPool::pushChunks(
+          std::atomic<DxvkCsChunk*>&  list,
+          DxvkCsChunk*                head,
+          DxvkCsChunk*                tail) {
+    DxvkCsChunk* next = list.load(std::memory_order_acquire);
+
+    do {
+      tail->m_nextFree = next;
+    } while (!list.compare_exchange_weak(next, head,
+      std::memory_order_release,
+      std::memory_order_acquire));
+  }
+
+
+  void DxvkCsChunkPool::freeChunks(
+          DxvkCsChunk*                head) {
+    while (head) {
+      DxvkCsChunk* next = head->m_nextFree;
+      delete head;
+      head = next;
+    }
+  }
+
+
+  uint32_t DxvkCsChunkPool::getCacheSlot() {
+    // Win32 thread IDs are multiples of four, so
+    // discard the low bits to get a better spread
+    uint32_t id = uint32_t(dxvk::this_thread::get_id());
+    return (id ^ (id >> 2) ^ (id >> 6)) % CacheSlotCount;
   }
   
   
@@ -99,52 +151,100 @@ namespace dxvk {
     const Rc<DxvkDevice>&   device,
     const Rc<DxvkContext>&  context)
   : m_device(device), m_context(context),
+    m_queue(std::make_unique<QueueEntry[]>(QueueSize)),
     m_thread([this] { threadFunc(); }) {
-    
+    const DxvkOptions& options = m_device->config();
+
+    if (options.raiseCsThreadPriority)
+      m_thread.set_priority(ThreadPriority::Highest);
+
+    if (options.pinWorkerThreads)
+      m_thread.set_affinity(getCpuCoreMask(CpuCoreType::Performance));
   }
   
   
   DxvkCsThread::~DxvkCsThread() {
-    { std::unique_lock<dxvk::mutex> lock(m_mutex);
-      m_stopped.store(true);
-    }
-    
-    m_condOnAdd.notify_one();
+    m_stopped.store(true);
+    m_condOnAdd.notifyAll();
+
     m_thread.join();
+
+    logSyncStats();
+  }
+
+
+  void DxvkCsThread::logSyncStats() {
+    // Counters are shared between all CS threads of
+    // the device, so this reports device-wide totals
+    DxvkStatCounters counters = m_device->getStatCounters();
+
+    if (!counters.getCtr(DxvkStatCounter::CsSyncCount))
+      return;
+
+    Logger::info(str::format("CS thread synchronizations: ",
+      counters.getCtr(DxvkStatCounter::CsSyncCount), " (",
+      counters.getCtr(DxvkStatCounter::CsSyncTicks) / 1000, " ms)"));
+
+    for (uint32_t i = 0; i < DxvkCsSyncReasonCount; i++) {
+      auto reason = DxvkCsSyncReason(i);
+      uint64_t count = counters.getCtr(getCsSyncCountCtr(reason));
+
+      if (count) {
+        Logger::info(str::format("  ", getCsSyncReasonName(reason), ": ", count,
+          " (", counters.getCtr(getCsSyncTicksCtr(reason)) / 1000, " ms)"));
+      }
+    }
   }
   
   
   uint64_t DxvkCsThread::dispatchChunk(DxvkCsChunkRef&& chunk) {
-    uint64_t seq;
+    uint64_t seq = ++m_chunksDispatched;
 
-    { std::unique_lock<dxvk::mutex> lock(m_mutex);
-      seq = ++m_chunksDispatched;
-      m_chunksQueued.push(std::move(chunk));
+    // If the queue is full, wait for the CS thread to consume
+    // the entry. This should only happen in pathological cases
+    // where the CS thread is thousands of chunks behind.
+    if (unlikely(seq > m_chunksExecuted.load(std::memory_order_acquire) + QueueSize)) {
+      sync::spin(200, [this, seq] {
+        return seq <= m_chunksExecuted.load(std::memory_order_acquire) + QueueSize;
+      });
     }
-    
-    m_condOnAdd.notify_one();
+
+    QueueEntry& entry = m_queue[seq % QueueSize];
+    entry.chunk = std::move(chunk);
+    entry.seq.store(seq);
+
+    // This is a single atomic load unless the CS
+    // thread is actually sleeping on the queue.
+    m_condOnAdd.notifyAll();
+
     return seq;
   }
   
   
-  void DxvkCsThread::synchronize(uint64_t seq) {
+  void DxvkCsThread::synchronize(
+          uint64_t          seq,
+          DxvkCsSyncReason  reason) {
     // Avoid locking if we know the sync is a no-op, may
     // reduce overhead if this is being called frequently
     if (seq > m_chunksExecuted.load(std::memory_order_acquire)) {
-      std::unique_lock<dxvk::mutex> lock(m_mutex);
-
       if (seq == SynchronizeAll)
         seq = m_chunksDispatched.load();
 
+      DxvkTraceScope zone(m_device->tracer(), "Sync CS thread");
+
       auto t0 = dxvk::high_resolution_clock::now();
-      m_condOnSync.wait(lock, [this, seq] {
+
+      m_condOnSync.wait(1000, [this, seq] {
         return m_chunksExecuted.load() >= seq;
       });
+
       auto t1 = dxvk::high_resolution_clock::now();
       auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
 
       m_device->addStatCtr(DxvkStatCounter::CsSyncCount, 1);
       m_device->addStatCtr(DxvkStatCounter::CsSyncTicks, ticks.count());
+      m_device->addStatCtr(getCsSyncCountCtr(reason), 1);
+      m_device->addStatCtr(getCsSyncTicksCtr(reason), ticks.count());
     }
   }
   
@@ -152,34 +252,28 @@ namespace dxvk {
   void DxvkCsThread::threadFunc() {
     env::setThreadName("dxvk-cs");
 
-    DxvkCsChunkRef chunk;
-
     try {
       while (!m_stopped.load()) {
-        { std::unique_lock<dxvk::mutex> lock(m_mutex);
-          if (chunk) {
-            m_chunksExecuted++;
-            m_condOnSync.notify_one();
-            
-            chunk = DxvkCsChunkRef();
-          }
-          
-          if (m_chunksQueued.size() == 0) {
-            m_condOnAdd.wait(lock, [this] {
-              return (m_chunksQueued.size() != 0)
-                  || (m_stopped.load());
-            });
-          }
-          
-          if (m_chunksQueued.size() != 0) {
-            chunk = std::move(m_chunksQueued.front());
-            m_chunksQueued.pop();
-          }
-        }
-        
-        if (chunk) {
+        uint64_t seq = m_chunksExecuted.load() + 1;
+
+        m_condOnAdd.wait(100, [this, seq] {
+          return isChunkReady(seq) || m_stopped.load();
+        });
+
+        if (isChunkReady(seq)) {
+          DxvkCsChunkRef chunk = std::move(m_queue[seq % QueueSize].chunk);
+
           m_context->addStatCtr(DxvkStatCounter::CsChunkCount, 1);
-          chunk->executeAll(m_context.ptr());
+
+          { DxvkTraceScope zone(m_device->tracer(), "Execute chunk");
+            chunk->executeAll(m_context.ptr());
+          }
+
+          // Release the chunk before signaling completion
+          // so that the pool can recycle it immediately
+          chunk = DxvkCsChunkRef();
+          m_chunksExecuted.store(seq);
+          m_condOnSync.notifyAll();
         }
       }
     } catch (const DxvkError& e) {
@@ -188,4 +282,4 @@ namespace dxvk {
     }
   }
   
-}
\ No newline at end of file
+}
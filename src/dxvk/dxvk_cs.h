@@ -1,17 +1,91 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
-#include <queue>
 
 #include "../util/thread.h"
 
+#include "../util/sync/sync_futex.h"
+
 #include "dxvk_device.h"
 #include "dxvk_context.h"
 
 namespace dxvk {
   
+  /**
+   * \brief Command type
+   *
+   * Frequently used commands with trivial arguments
+   * are executed directly by the chunk rather than
+   * through a virtual call, and are not destroyed.
+   */
+  enum class DxvkCsCmdType : uint32_t {
+    Generic,
+    Draw,
+    DrawIndexed,
+    Dispatch,
+  };
+
+
+  /**
+   * \brief Draw command
+   */
+  struct DxvkCsDraw {
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+
+    void operator () (DxvkContext* ctx) const {
+      ctx->draw(vertexCount, instanceCount, firstVertex, firstInstance);
+    }
+  };
+
+
+  /**
+   * \brief Indexed draw command
+   */
+  struct DxvkCsDrawIndexed {
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t  vertexOffset;
+    uint32_t firstInstance;
+
+    void operator () (DxvkContext* ctx) const {
+      ctx->drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    }
+  };
+
+
+  /**
+   * \brief Dispatch command
+   */
+  struct DxvkCsDispatch {
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+
+    void operator () (DxvkContext* ctx) const {
+      ctx->dispatch(x, y, z);
+    }
+  };
+
+
+  /**
+   * \brief Command type for a given function object
+   */
+  template<typename T>
+  constexpr DxvkCsCmdType DxvkCsCmdTypeOf = DxvkCsCmdType::Generic;
+
+  template<> constexpr DxvkCsCmdType DxvkCsCmdTypeOf<DxvkCsDraw>        = DxvkCsCmdType::Draw;
+  template<> constexpr DxvkCsCmdType DxvkCsCmdTypeOf<DxvkCsDrawIndexed> = DxvkCsCmdType::DrawIndexed;
+  template<> constexpr DxvkCsCmdType DxvkCsCmdTypeOf<DxvkCsDispatch>    = DxvkCsCmdType::Dispatch;
+
+
   /**
    * \brief Command stream operation
    * 
@@ -21,8 +95,21 @@ namespace dxvk {
   class DxvkCsCmd {
     
   public:
+
+    DxvkCsCmd() { }
+
+    DxvkCsCmd(DxvkCsCmdType type)
+    : m_type(type) { }
     
     virtual ~DxvkCsCmd() { }
+
+    /**
+     * \brief Command type
+     * \returns Command type
+     */
+    DxvkCsCmdType type() const {
+      return m_type;
+    }
     
     /**
      * \brief Retrieves next command in a command chain
@@ -51,7 +138,8 @@ namespace dxvk {
     
   private:
     
-    DxvkCsCmd* m_next = nullptr;
+    DxvkCsCmd*    m_next = nullptr;
+    DxvkCsCmdType m_type = DxvkCsCmdType::Generic;
     
   };
   
@@ -68,7 +156,8 @@ namespace dxvk {
   public:
     
     DxvkCsTypedCmd(T&& cmd)
-    : m_command(std::move(cmd)) { }
+    : DxvkCsCmd(DxvkCsCmdTypeOf<T>),
+      m_command(std::move(cmd)) { }
     
     DxvkCsTypedCmd             (DxvkCsTypedCmd&&) = delete;
     DxvkCsTypedCmd& operator = (DxvkCsTypedCmd&&) = delete;
@@ -76,6 +165,10 @@ namespace dxvk {
     void exec(DxvkContext* ctx) {
       m_command(ctx);
     }
+
+    const T& command() const {
+      return m_command;
+    }
     
   private:
     
@@ -138,6 +231,7 @@ namespace dxvk {
    * Stores a list of commands.
    */
   class DxvkCsChunk : public RcObject {
+    friend class DxvkCsChunkPool;
     constexpr static size_t MaxBlockSize = 16384;
   public:
     
@@ -242,9 +336,31 @@ namespace dxvk {
     DxvkCsCmd* m_tail = nullptr;
 
     DxvkCsChunkFlags m_flags;
+
+    DxvkCsChunk* m_nextFree = nullptr;
     
     alignas(64)
     char m_data[MaxBlockSize];
+
+    template<typename T>
+    static void executeTyped(DxvkCsCmd* cmd, DxvkContext* ctx) {
+      static_cast<DxvkCsTypedCmd<T>*>(cmd)->command()(ctx);
+    }
+
+    static void executeCmd(DxvkCsCmd* cmd, DxvkContext* ctx) {
+      switch (cmd->type()) {
+        case DxvkCsCmdType::Draw:         executeTyped<DxvkCsDraw>(cmd, ctx); break;
+        case DxvkCsCmdType::DrawIndexed:  executeTyped<DxvkCsDrawIndexed>(cmd, ctx); break;
+        case DxvkCsCmdType::Dispatch:     executeTyped<DxvkCsDispatch>(cmd, ctx); break;
+        default:                          cmd->exec(ctx);
+      }
+    }
+
+    static void destroyCmd(DxvkCsCmd* cmd) {
+      // Built-in commands have nothing to release
+      if (cmd->type() == DxvkCsCmdType::Generic)
+        cmd->~DxvkCsCmd();
+    }
     
   };
   
@@ -255,9 +371,16 @@ namespace dxvk {
    * Implements a pool of CS chunks which can be
    * recycled. The goal is to reduce the number
    * of dynamic memory allocations.
+   *
+   * Freed chunks are pushed to a lock-free list. In order
+   * to avoid ABA issues, chunks are never popped from that
+   * list individually. Instead, a thread will take the entire
+   * list and move it into a cache slot selected by its thread
+   * ID, so that concurrent allocations rarely touch the same
+   * cache line and never have to take a lock.
    */
   class DxvkCsChunkPool {
-    
+    constexpr static uint32_t CacheSlotCount = 16;
   public:
     
     DxvkCsChunkPool();
@@ -285,9 +408,23 @@ namespace dxvk {
     void freeChunk(DxvkCsChunk* chunk);
     
   private:
-    
-    dxvk::mutex               m_mutex;
-    std::vector<DxvkCsChunk*> m_chunks;
+
+    struct alignas(CACHE_LINE_SIZE) CacheSlot {
+      std::atomic<DxvkCsChunk*> chunks = { nullptr };
+    };
+
+    std::atomic<DxvkCsChunk*>             m_freeList = { nullptr };
+    std::array<CacheSlot, CacheSlotCount> m_cache;
+
+    static void pushChunks(
+            std::atomic<DxvkCsChunk*>&  list,
+            DxvkCsChunk*                head,
+            DxvkCsChunk*                tail);
+
+    static void freeChunks(
+            DxvkCsChunk*                head);
+
+    static uint32_t getCacheSlot();
     
   };
   
@@ -379,7 +516,7 @@ namespace dxvk {
    * commands on a DXVK context. 
    */
   class DxvkCsThread {
-    
+    constexpr static uint64_t QueueSize = 4096;
   public:
 
     constexpr static uint64_t SynchronizeAll = ~0ull;
@@ -407,8 +544,11 @@ namespace dxvk {
      * number. If the sequence number is 0, this will wait
      * for all pending chunks to complete execution.
      * \param [in] seq Sequence number to wait for.
+     * \param [in] reason What caused the synchronization
      */
-    void synchronize(uint64_t seq);
+    void synchronize(
+            uint64_t          seq,
+            DxvkCsSyncReason  reason);
     
     /**
      * \brief Retrieves last executed sequence number
@@ -421,21 +561,44 @@ namespace dxvk {
     }
 
   private:
+
+    /**
+     * \brief Queue entry
+     *
+     * The sequence number is used to determine
+     * whether the entry can be written or read,
+     * similar to a bounded MPMC queue. An entry
+     * for chunk \c n is ready to be consumed once
+     * its sequence number is equal to \c n.
+     */
+    struct alignas(CACHE_LINE_SIZE) QueueEntry {
+      std::atomic<uint64_t> seq = { 0ull };
+      DxvkCsChunkRef        chunk;
+    };
     
     Rc<DxvkDevice>              m_device;
     Rc<DxvkContext>             m_context;
 
+    alignas(CACHE_LINE_SIZE)
     std::atomic<uint64_t>       m_chunksDispatched = { 0ull };
+    alignas(CACHE_LINE_SIZE)
     std::atomic<uint64_t>       m_chunksExecuted   = { 0ull };
-    
+
     std::atomic<bool>           m_stopped = { false };
-    dxvk::mutex                 m_mutex;
-    dxvk::condition_variable    m_condOnAdd;
-    dxvk::condition_variable    m_condOnSync;
-    std::queue<DxvkCsChunkRef>  m_chunksQueued;
+    sync::FutexCondition        m_condOnAdd;
+    sync::FutexCondition        m_condOnSync;
+
+    std::unique_ptr<QueueEntry[]> m_queue;
+
     dxvk::thread                m_thread;
     
     void threadFunc();
+
+    void logSyncStats();
+
+    bool isChunkReady(uint64_t seq) const {
+      return m_queue[seq % QueueSize].seq.load() == seq;
+    }
     
   };
   
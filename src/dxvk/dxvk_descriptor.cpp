@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "dxvk_descriptor.h"
 #include "dxvk_device.h"
 
@@ -99,6 +101,66 @@ namespace dxvk {
   }
 
 
+  VkDescriptorSet DxvkDescriptorPool::allocCached(
+    const DxvkBindingLayoutObjects* layout,
+          uint32_t                  setIndex,
+          uint32_t                  descriptorCount,
+    const DxvkDescriptorInfo*       descriptors,
+          bool&                     found) {
+    VkDescriptorSetLayout setLayout = layout->getSetLayout(setIndex);
+
+    // Descriptor infos are zero-initialized by the caller,
+    // so we can safely hash and compare the raw data.
+    static_assert(sizeof(DxvkDescriptorInfo) % sizeof(size_t) == 0);
+
+    auto data = reinterpret_cast<const size_t*>(descriptors);
+    size_t dataSize = descriptorCount * sizeof(DxvkDescriptorInfo);
+
+    DxvkHashState hash;
+    hash.add(size_t(setLayout));
+
+    for (size_t i = 0; i < dataSize / sizeof(size_t); i++)
+      hash.add(data[i]);
+
+    auto range = m_setCache.equal_range(hash);
+
+    for (auto i = range.first; i != range.second; i++) {
+      const SetCacheEntry& entry = i->second;
+
+      if (entry.layout == setLayout && entry.dataCount == descriptorCount
+       && !std::memcmp(&m_setCacheData[entry.dataIndex], descriptors, dataSize)) {
+        found = true;
+        return entry.set;
+      }
+    }
+
+    VkDescriptorSet set = allocSet(
+      getSetMapCached(layout)->sets[setIndex], setLayout);
+    m_setsUsed += 1;
+
+    if (m_setCacheData.size() + descriptorCount > MaxCachedDescriptors)
+      resetSetCache();
+
+    SetCacheEntry entry;
+    entry.layout = setLayout;
+    entry.set = set;
+    entry.dataIndex = m_setCacheData.size();
+    entry.dataCount = descriptorCount;
+
+    m_setCacheData.insert(m_setCacheData.end(), descriptors, descriptors + descriptorCount);
+    m_setCache.insert({ size_t(hash), entry });
+
+    found = false;
+    return set;
+  }
+
+
+  void DxvkDescriptorPool::resetSetCache() {
+    m_setCache.clear();
+    m_setCacheData.clear();
+  }
+
+
   void DxvkDescriptorPool::reset() {
     // As a heuristic to save memory, check how many descriptors
     // have actively been used in the past couple of submissions.
@@ -135,6 +197,8 @@ namespace dxvk {
     }
 
     m_cachedEntry = { nullptr, nullptr };
+
+    resetSetCache();
   }
 
 
@@ -296,7 +360,7 @@ namespace dxvk {
     // Samplers and uniform buffers may be special on some implementations
     // so we should allocate space for a reasonable number of both, but
     // assume that all other descriptor types share pool memory.
-    std::array<VkDescriptorPoolSize, 8> pools = {{
+    std::array<VkDescriptorPoolSize, 9> pools = {{
       { VK_DESCRIPTOR_TYPE_SAMPLER,                m_maxSets * 1  },
       { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_maxSets / 4  },
       { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          m_maxSets / 2  },
@@ -305,11 +369,16 @@ namespace dxvk {
       { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,   m_maxSets / 64 },
       { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         m_maxSets * 2  },
       { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         m_maxSets / 2  },
+      { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, m_maxSets * 2  },
     }};
+
+    // Only reserve dynamic uniform buffers if any layouts use them
+    uint32_t poolCount = m_device->canUseDynamicUniformBuffers()
+      ? pools.size() : pools.size() - 1;
     
     VkDescriptorPoolCreateInfo info = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
     info.maxSets       = m_maxSets;
-    info.poolSizeCount = pools.size();
+    info.poolSizeCount = poolCount;
     info.pPoolSizes    = pools.data();
     
     VkDescriptorPool pool = VK_NULL_HANDLE;
@@ -80,7 +80,7 @@ namespace dxvk {
    * to be updated.
    */
   class DxvkDescriptorPool : public RcObject {
-
+    constexpr static size_t MaxCachedDescriptors = 16384;
   public:
 
     DxvkDescriptorPool(
@@ -119,6 +119,36 @@ namespace dxvk {
     VkDescriptorSet alloc(
             VkDescriptorSetLayout     layout);
 
+    /**
+     * \brief Allocates a descriptor set with the given contents
+     *
+     * Returns an existing set if a set with identical contents
+     * has been written since the set cache was last reset.
+     * Otherwise, allocates a new set, which the caller must
+     * then update with the given descriptors.
+     * \param [in] layout Binding layout
+     * \param [in] setIndex Descriptor set index
+     * \param [in] descriptorCount Number of descriptors
+     * \param [in] descriptors Descriptor infos
+     * \param [out] found \c true if the set is already written
+     * \returns The descriptor set
+     */
+    VkDescriptorSet allocCached(
+      const DxvkBindingLayoutObjects* layout,
+            uint32_t                  setIndex,
+            uint32_t                  descriptorCount,
+      const DxvkDescriptorInfo*       descriptors,
+            bool&                     found);
+
+    /**
+     * \brief Resets descriptor set cache
+     *
+     * Must be called whenever resources referenced by cached
+     * sets may have been destroyed, i.e. whenever a new command
+     * list is started, since handles can be reused after that.
+     */
+    void resetSetCache();
+
     /**
      * \brief Resets pool
      */
@@ -150,6 +180,18 @@ namespace dxvk {
       const DxvkBindingLayoutObjects*,
       DxvkDescriptorSetMap*>  m_cachedEntry;
 
+    struct SetCacheEntry {
+      VkDescriptorSetLayout   layout;
+      VkDescriptorSet         set;
+      size_t                  dataIndex;
+      uint32_t                dataCount;
+    };
+
+    std::unordered_multimap<
+      size_t, SetCacheEntry>  m_setCache;
+
+    std::vector<DxvkDescriptorInfo> m_setCacheData;
+
     uint32_t m_setsAllocated  = 0;
     uint32_t m_setsUsed       = 0;
 
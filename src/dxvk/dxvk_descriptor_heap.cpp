@@ -0,0 +1,123 @@
+#include "dxvk_descriptor_heap.h"
+#include "dxvk_device.h"
+
+namespace dxvk {
+
+  DxvkDescriptorHeap::DxvkDescriptorHeap(
+    const Rc<DxvkDevice>&     device,
+          VkDeviceSize        size)
+  : m_device(device), m_size(size) {
+    if (!m_device->canUseDescriptorBuffer())
+      return;
+
+    const auto& props = m_device->properties().extDescriptorBuffer;
+    bool robust = m_device->features().core.features.robustBufferAccess;
+
+    m_setAlignment = props.descriptorBufferOffsetAlignment;
+
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_SAMPLER]                = props.samplerDescriptorSize;
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER] = props.combinedImageSamplerDescriptorSize;
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE]          = props.sampledImageDescriptorSize;
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE]          = props.storageImageDescriptorSize;
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER]   = robust ? props.robustUniformTexelBufferDescriptorSize : props.uniformTexelBufferDescriptorSize;
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER]   = robust ? props.robustStorageTexelBufferDescriptorSize : props.storageTexelBufferDescriptorSize;
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER]         = robust ? props.robustUniformBufferDescriptorSize : props.uniformBufferDescriptorSize;
+    m_descriptorSizes[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER]         = robust ? props.robustStorageBufferDescriptorSize : props.storageBufferDescriptorSize;
+  }
+
+
+  DxvkDescriptorHeap::~DxvkDescriptorHeap() {
+
+  }
+
+
+  VkDeviceSize DxvkDescriptorHeap::alloc(
+          VkDeviceSize        size) {
+    VkDeviceSize alignedSize = align(size, m_setAlignment);
+
+    if (m_buffer == nullptr || m_offset + alignedSize > m_size)
+      return InvalidOffset;
+
+    VkDeviceSize offset = m_offset;
+    m_offset += alignedSize;
+    return offset;
+  }
+
+
+  void DxvkDescriptorHeap::reset(
+          VkDeviceSize        minSize) {
+    if (m_buffer != nullptr) {
+      m_retiredBuffers.push(std::move(m_buffer));
+      m_buffer = nullptr;
+
+      while (m_retiredBuffers.size() > MaxRetiredBuffers)
+        m_retiredBuffers.pop();
+    }
+
+    // Retired buffers are too small to be
+    // reused if the heap needs to grow
+    VkDeviceSize alignedSize = align(minSize, m_setAlignment);
+
+    if (alignedSize > m_size) {
+      m_size = std::max(2 * m_size, alignedSize);
+      m_retiredBuffers = { };
+    }
+
+    // Submissions complete in order, so the oldest
+    // buffer is the most likely one to be unused
+    if (!m_retiredBuffers.empty() && m_retiredBuffers.front()->isExclusive()) {
+      m_buffer = std::move(m_retiredBuffers.front());
+      m_retiredBuffers.pop();
+    }
+
+    if (m_buffer == nullptr)
+      m_buffer = createBuffer();
+
+    m_address = getBufferAddress(m_buffer->getSliceHandle());
+    m_offset = 0;
+  }
+
+
+  VkDescriptorBufferBindingInfoEXT DxvkDescriptorHeap::getBindingInfo() const {
+    VkDescriptorBufferBindingInfoEXT info = { VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT };
+    info.address = m_address;
+    info.usage = m_buffer->info().usage;
+    return info;
+  }
+
+
+  VkDeviceAddress DxvkDescriptorHeap::getBufferAddress(
+    const DxvkBufferSliceHandle& slice) const {
+    auto vk = m_device->vkd();
+
+    VkBufferDeviceAddressInfo info = { VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO };
+    info.buffer = slice.handle;
+
+    return vk->vkGetBufferDeviceAddress(vk->device(), &info) + slice.offset;
+  }
+
+
+  void DxvkDescriptorHeap::writeDescriptor(
+    const VkDescriptorGetInfoEXT& info,
+          VkDeviceSize        offset) {
+    auto vk = m_device->vkd();
+
+    vk->vkGetDescriptorEXT(vk->device(), &info,
+      m_descriptorSizes[info.type], m_buffer->mapPtr(offset));
+  }
+
+
+  Rc<DxvkBuffer> DxvkDescriptorHeap::createBuffer() const {
+    DxvkBufferCreateInfo info;
+    info.size   = m_size;
+    info.usage  = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT
+                | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT
+                | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    info.stages = m_device->getShaderPipelineStages();
+    info.access = VK_ACCESS_SHADER_READ_BIT;
+
+    return m_device->createBuffer(info,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  }
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <queue>
+
+#include "dxvk_buffer.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+
+  /**
+   * \brief Descriptor heap
+   *
+   * Linear allocator for descriptor buffer memory. Shader
+   * resource descriptors are written directly into a host
+   * visible buffer. Filled buffers are retired and reused
+   * once the GPU is done with them, similar to staging
+   * buffers. Only used if descriptor buffers are enabled.
+   */
+  class DxvkDescriptorHeap {
+    constexpr static size_t MaxRetiredBuffers = 4;
+  public:
+
+    constexpr static VkDeviceSize InvalidOffset = ~0ull;
+
+    /**
+     * \brief Creates descriptor heap
+     *
+     * \param [in] device DXVK device
+     * \param [in] size Descriptor buffer size
+     */
+    DxvkDescriptorHeap(
+      const Rc<DxvkDevice>&     device,
+            VkDeviceSize        size);
+
+    ~DxvkDescriptorHeap();
+
+    /**
+     * \brief Allocates descriptor memory
+     *
+     * Suballocates from the current buffer. If there
+     * is not enough space left, the allocation fails
+     * and the caller must call \c reset and rebind
+     * the descriptor buffer.
+     * \param [in] size Number of bytes to allocate
+     * \returns Offset of the allocation, or
+     *    \c InvalidOffset if the buffer is full.
+     */
+    VkDeviceSize alloc(
+            VkDeviceSize        size);
+
+    /**
+     * \brief Retires current buffer
+     *
+     * Replaces the current buffer with a retired buffer
+     * that is no longer in use, or a new buffer. If the
+     * requested size does not fit into a buffer of the
+     * current size, the heap grows accordingly.
+     * \param [in] minSize Number of bytes that must
+     *    be available in the new buffer
+     */
+    void reset(
+            VkDeviceSize        minSize);
+
+    /**
+     * \brief Queries current descriptor buffer
+     * \returns Descriptor buffer
+     */
+    const Rc<DxvkBuffer>& getBuffer() const {
+      return m_buffer;
+    }
+
+    /**
+     * \brief Queries binding info of the current buffer
+     * \returns Descriptor buffer binding info
+     */
+    VkDescriptorBufferBindingInfoEXT getBindingInfo() const;
+
+    /**
+     * \brief Queries alignment of descriptor sets
+     * \returns Required offset alignment
+     */
+    VkDeviceSize getSetAlignment() const {
+      return m_setAlignment;
+    }
+
+    /**
+     * \brief Queries device address of a buffer slice
+     *
+     * \param [in] slice Buffer slice handle
+     * \returns Device address of the slice
+     */
+    VkDeviceAddress getBufferAddress(
+      const DxvkBufferSliceHandle& slice) const;
+
+    /**
+     * \brief Writes a descriptor
+     *
+     * \param [in] info Descriptor info
+     * \param [in] offset Offset within the current buffer
+     */
+    void writeDescriptor(
+      const VkDescriptorGetInfoEXT& info,
+            VkDeviceSize        offset);
+
+  private:
+
+    Rc<DxvkDevice>  m_device;
+    Rc<DxvkBuffer>  m_buffer;
+    VkDeviceSize    m_offset = 0;
+    VkDeviceSize    m_size;
+
+    VkDeviceAddress m_address = 0;
+    VkDeviceSize    m_setAlignment = 1;
+
+    std::array<size_t, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT + 1> m_descriptorSizes = { };
+
+    std::queue<Rc<DxvkBuffer>> m_retiredBuffers;
+
+    Rc<DxvkBuffer> createBuffer() const;
+
+  };
+
+}
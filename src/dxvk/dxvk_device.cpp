@@ -14,13 +14,25 @@ namespace dxvk {
     m_instance          (instance),
     m_adapter           (adapter),
     m_vkd               (vkd),
+    m_reclaimer         (std::make_unique<DxvkObjectReclaimer>(vkd, m_options.enableDeferredDestruction)),
+    m_fenceWaiter       (std::make_unique<DxvkFenceWaiter>(vkd)),
     m_features          (features),
     m_properties        (adapter->devicePropertiesExt()),
     m_perfHints         (getPerfHints()),
+    m_tracer            (createTracer()),
+    m_gpuProfiler       (m_properties.core.properties.limits.timestampPeriod),
     m_objects           (this),
     m_queues            (queues),
     m_submissionQueue   (this, queueCallback) {
-
+    m_shaderCache = m_adapter->getShaderCache(this);
+    m_telemetry   = createTelemetry();
+
+    if (m_options.profilePipelineStats) {
+      if (m_features.core.features.pipelineStatisticsQuery)
+        m_gpuProfiler.enablePipelineStats();
+      else
+        Logger::warn("DXVK: Pipeline statistics profiling not supported by device");
+    }
   }
   
   
@@ -39,6 +51,13 @@ namespace dxvk {
     // Stop workers explicitly in order to prevent
     // access to structures that are being destroyed.
     m_objects.pipelineManager().stopWorkerThreads();
+
+    // Pending GPU zones reference queries, which
+    // must be released before the query pool.
+    if (m_tracer)
+      m_tracer->flush();
+
+    m_gpuProfiler.flush();
   }
 
 
@@ -67,6 +86,51 @@ namespace dxvk {
   }
 
 
+  bool DxvkDevice::canUseDescriptorBuffer() const {
+    // The feature is only enabled if requested by the user
+    return m_features.extDescriptorBuffer.descriptorBuffer
+        && m_features.vk12.bufferDeviceAddress;
+  }
+
+
+  bool DxvkDevice::canUseDynamicUniformBuffers() const {
+    // Descriptor buffers do not support dynamic descriptors. Also require
+    // enough dynamic buffers for both graphics sets that contain UBOs.
+    return m_options.uniformHeapThreshold > 0
+        && !canUseDescriptorBuffer()
+        && m_properties.core.properties.limits.maxDescriptorSetUniformBuffersDynamic >= 2;
+  }
+
+
+  uint32_t DxvkDevice::getMaxDynamicUniformBuffers() const {
+    if (!canUseDynamicUniformBuffers())
+      return 0;
+
+    return std::min<uint32_t>(MaxNumDynamicUniformBuffers,
+      m_properties.core.properties.limits.maxDescriptorSetUniformBuffersDynamic);
+  }
+
+
+  DxvkBufferHeap& DxvkDevice::uniformHeap() {
+    return m_objects.uniformHeap();
+  }
+
+
+  DxvkBufferHeap& DxvkDevice::vertexHeap() {
+    return m_objects.vertexHeap();
+  }
+
+
+  DxvkImagePool& DxvkDevice::imagePool() {
+    return m_objects.imagePool();
+  }
+
+
+  DxvkStagingPool& DxvkDevice::stagingPool() {
+    return m_objects.stagingPool();
+  }
+
+
   bool DxvkDevice::mustTrackPipelineLifetime() const {
     switch (m_options.trackPipelineLifetime) {
       case Tristate::True:
@@ -174,25 +238,30 @@ namespace dxvk {
   Rc<DxvkImage> DxvkDevice::createImage(
     const DxvkImageCreateInfo&  createInfo,
           VkMemoryPropertyFlags memoryType) {
-    return new DxvkImage(this, createInfo, m_objects.memoryManager(), memoryType);
+    Rc<DxvkImage> image = new DxvkImage(this, createInfo, m_objects.memoryManager(), memoryType);
+
+    if (createInfo.sampleCount != VK_SAMPLE_COUNT_1_BIT)
+      prewarmResolvePipelines(createInfo);
+
+    return image;
   }
   
   
   Rc<DxvkImageView> DxvkDevice::createImageView(
     const Rc<DxvkImage>&            image,
     const DxvkImageViewCreateInfo&  createInfo) {
-    return new DxvkImageView(m_vkd, image, createInfo);
+    return image->createView(createInfo);
   }
   
   
   Rc<DxvkSampler> DxvkDevice::createSampler(
     const DxvkSamplerCreateInfo&  createInfo) {
-    return new DxvkSampler(this, createInfo);
+    return m_objects.samplerPool().createSampler(createInfo);
   }
   
   
   Rc<DxvkSparsePageAllocator> DxvkDevice::createSparsePageAllocator() {
-    return new DxvkSparsePageAllocator(m_objects.memoryManager());
+    return new DxvkSparsePageAllocator(m_objects.sparsePagePool());
   }
 
 
@@ -207,6 +276,11 @@ namespace dxvk {
     result.setCtr(DxvkStatCounter::PipeTasksDone,     workers.tasksCompleted);
     result.setCtr(DxvkStatCounter::PipeTasksTotal,    workers.tasksTotal);
     result.setCtr(DxvkStatCounter::GpuIdleTicks,      m_submissionQueue.gpuIdleTicks());
+    result.setCtr(DxvkStatCounter::QueueSubmitLatency, m_submissionQueue.submitLatencyTicks());
+    result.setCtr(DxvkStatCounter::QueueDepthSum,     m_submissionQueue.queueDepthSum());
+    result.setCtr(DxvkStatCounter::SamplerCount,      m_objects.samplerPool().getSamplerCount());
+    result.setCtr(DxvkStatCounter::ImageCompressedCount, m_compressedImageCount.load(std::memory_order_relaxed));
+    result.setCtr(DxvkStatCounter::QueueFlushPacing,  m_flushPacing.load(std::memory_order_relaxed));
 
     std::lock_guard<sync::Spinlock> lock(m_statLock);
     result.merge(m_statCounters);
@@ -235,6 +309,21 @@ namespace dxvk {
   }
 
 
+  DxvkBarStats DxvkDevice::getBarStats() {
+    return m_objects.memoryManager().getBarStats();
+  }
+
+
+  DxvkMemoryCategoryStats DxvkDevice::getMemoryCategoryStats() {
+    return m_objects.memoryManager().getCategoryStats();
+  }
+
+
+  DxvkShaderCodeStats DxvkDevice::getShaderCodeStats() {
+    return m_shaderCache->getCodeStats();
+  }
+
+
   uint32_t DxvkDevice::getCurrentFrameId() const {
     return m_statCounters.getCtr(DxvkStatCounter::QueuePresentCount);
   }
@@ -243,6 +332,25 @@ namespace dxvk {
   void DxvkDevice::registerShader(const Rc<DxvkShader>& shader) {
     m_objects.pipelineManager().registerShader(shader);
   }
+
+
+  bool DxvkDevice::isCompilingPipelines() {
+    return m_objects.pipelineManager().isCompiling();
+  }
+
+
+  Rc<DxvkShader> DxvkDevice::lookupShader(
+    const DxvkShaderKey&            key,
+    const Sha1Hash&                 compileHash) {
+    return m_shaderCache->lookupShader(key, compileHash);
+  }
+
+
+  void DxvkDevice::cacheShader(
+    const Rc<DxvkShader>&           shader,
+    const Sha1Hash&                 compileHash) {
+    m_shaderCache->addShader(shader, compileHash);
+  }
   
   
   void DxvkDevice::requestCompileShader(
@@ -253,12 +361,32 @@ namespace dxvk {
 
   void DxvkDevice::presentImage(
     const Rc<vk::Presenter>&        presenter,
+    const Rc<sync::Signal>&         signal,
+          uint64_t                  signalValue,
           DxvkSubmitStatus*         status) {
     status->result = VK_NOT_READY;
 
     DxvkPresentInfo presentInfo;
-    presentInfo.presenter = presenter;
+    presentInfo.presenter   = presenter;
+    presentInfo.signal      = signal;
+    presentInfo.signalValue = signalValue;
     m_submissionQueue.present(presentInfo, status);
+
+    if (unlikely(m_tracer))
+      m_tracer->endFrame();
+
+    if (unlikely(m_telemetry))
+      m_telemetry->endFrame(this);
+
+    m_gpuProfiler.endFrame();
+
+    m_shaderCache->endFrame();
+    m_objects.pipelineManager().endFrame();
+    m_objects.imagePool().trim();
+    m_objects.stagingPool().trim();
+    m_objects.uniformHeap().trim();
+    m_objects.vertexHeap().trim();
+    m_reclaimer->notifyFrame();
     
     std::lock_guard<sync::Spinlock> statLock(m_statLock);
     m_statCounters.addCtr(DxvkStatCounter::QueuePresentCount, 1);
@@ -281,6 +409,7 @@ namespace dxvk {
     VkResult result = status->result.load();
 
     if (result == VK_NOT_READY) {
+      DxvkTraceScope zone(m_tracer.get(), "Wait for submission");
       m_submissionQueue.synchronizeSubmission(status);
       result = status->result.load();
     }
@@ -291,6 +420,8 @@ namespace dxvk {
 
   void DxvkDevice::waitForResource(const Rc<DxvkResource>& resource, DxvkAccess access) {
     if (resource->isInUse(access)) {
+      DxvkTraceScope zone(m_tracer.get(), "Wait for resource");
+
       auto t0 = dxvk::high_resolution_clock::now();
 
       m_submissionQueue.synchronizeUntil([resource, access] {
@@ -328,6 +459,87 @@ namespace dxvk {
   }
 
 
+  std::unique_ptr<DxvkTracer> DxvkDevice::createTracer() {
+    std::string path = env::getEnvVar("DXVK_TRACE_PATH");
+
+    if (path.empty())
+      path = m_options.tracePath;
+
+    if (path.empty())
+      return nullptr;
+
+    env::createDirectory(path);
+
+    std::string fileName = str::format(path, "/",
+      env::getExeBaseName(), "_trace.json");
+
+    return std::make_unique<DxvkTracer>(fileName,
+      m_properties.core.properties.limits.timestampPeriod);
+  }
+
+
+  std::unique_ptr<DxvkTelemetry> DxvkDevice::createTelemetry() {
+    std::string env = env::getEnvVar("DXVK_TELEMETRY");
+
+    bool enable = env.empty()
+      ? m_options.enableTelemetry
+      : env == "1";
+
+    if (!enable)
+      return nullptr;
+
+    auto telemetry = std::make_unique<DxvkTelemetry>();
+
+    if (!telemetry->isValid())
+      return nullptr;
+
+    return telemetry;
+  }
+
+
+  void DxvkDevice::prewarmResolvePipelines(
+    const DxvkImageCreateInfo&  createInfo) {
+    // Color images get resolved in a fragment shader if the resolve
+    // format differs from the image format, or if the device prefers
+    // that path in general. Compile those pipelines in the background
+    // so that the first resolve of any given format does not stall.
+    small_vector<VkFormat, 4> formats;
+
+    if (m_perfHints.preferFbResolve)
+      formats.push_back(createInfo.format);
+
+    for (uint32_t i = 0; i < createInfo.viewFormatCount; i++) {
+      if (createInfo.viewFormats[i] != createInfo.format)
+        formats.push_back(createInfo.viewFormats[i]);
+    }
+
+    std::lock_guard lock(m_metaPrewarmMutex);
+
+    for (uint32_t i = 0; i < formats.size(); i++) {
+      const DxvkFormatInfo* formatInfo = lookupFormatInfo(formats[i]);
+
+      if (!formatInfo || formatInfo->aspectMask != VK_IMAGE_ASPECT_COLOR_BIT)
+        continue;
+
+      if (!(m_adapter->getFormatFeatures(formats[i]).optimal & VK_FORMAT_FEATURE_2_COLOR_ATTACHMENT_BIT))
+        continue;
+
+      DxvkMetaResolvePipelineKey key;
+      key.format  = formats[i];
+      key.samples = createInfo.sampleCount;
+      key.modeD   = VK_RESOLVE_MODE_NONE;
+      key.modeS   = VK_RESOLVE_MODE_NONE;
+
+      if (!m_metaPrewarmResolves.insert(key).second)
+        continue;
+
+      m_objects.pipelineManager().requestCompileMetaPipeline([this, key] {
+        m_objects.metaResolve().getPipeline(key.format, key.samples, key.modeD, key.modeS);
+      });
+    }
+  }
+
+
   void DxvkDevice::recycleCommandList(const Rc<DxvkCommandList>& cmdList) {
     m_recycledCommandLists.returnObject(cmdList);
   }
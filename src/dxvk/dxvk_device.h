@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_set>
+
 #include "dxvk_adapter.h"
 #include "dxvk_buffer.h"
 #include "dxvk_compute.h"
@@ -8,6 +10,7 @@
 #include "dxvk_extensions.h"
 #include "dxvk_fence.h"
 #include "dxvk_framebuffer.h"
+#include "dxvk_gpu_profiler.h"
 #include "dxvk_image.h"
 #include "dxvk_instance.h"
 #include "dxvk_memory.h"
@@ -16,12 +19,16 @@
 #include "dxvk_options.h"
 #include "dxvk_pipemanager.h"
 #include "dxvk_queue.h"
+#include "dxvk_reclaim.h"
 #include "dxvk_recycler.h"
 #include "dxvk_renderpass.h"
 #include "dxvk_sampler.h"
 #include "dxvk_shader.h"
+#include "dxvk_shader_cache.h"
 #include "dxvk_sparse.h"
 #include "dxvk_stats.h"
+#include "dxvk_telemetry.h"
+#include "dxvk_trace.h"
 #include "dxvk_unbound.h"
 #include "dxvk_marker.h"
 
@@ -108,6 +115,28 @@ namespace dxvk {
       return m_vkd->device();
     }
 
+    /**
+     * \brief Object reclaimer
+     *
+     * Must be used to destroy Vulkan objects that
+     * are no longer in use by the GPU.
+     * \returns Object reclaimer
+     */
+    DxvkObjectReclaimer& reclaimer() const {
+      return *m_reclaimer;
+    }
+
+    /**
+     * \brief Fence waiter
+     *
+     * Device-wide worker that dispatches
+     * fence events on completion.
+     * \returns Fence waiter
+     */
+    DxvkFenceWaiter& fenceWaiter() const {
+      return *m_fenceWaiter;
+    }
+
     /**
      * \brief Device options
      * \returns Device options
@@ -115,6 +144,22 @@ namespace dxvk {
     const DxvkOptions& config() const {
       return m_options;
     }
+
+    /**
+     * \brief Timeline tracer
+     * \returns Tracer, or \c nullptr if tracing is disabled
+     */
+    DxvkTracer* tracer() const {
+      return m_tracer.get();
+    }
+
+    /**
+     * \brief GPU pass profiler
+     * \returns GPU pass profiler
+     */
+    DxvkGpuProfiler& gpuProfiler() {
+      return m_gpuProfiler;
+    }
     
     /**
      * \brief Queue handles
@@ -226,6 +271,58 @@ namespace dxvk {
      */
     bool canUsePipelineCacheControl() const;
 
+    /**
+     * \brief Checks whether descriptor buffers can be used
+     *
+     * If this returns \c true, all DXVK pipelines use descriptor
+     * buffers instead of descriptor sets for shader resources.
+     * \returns \c true if descriptor buffers are enabled.
+     */
+    bool canUseDescriptorBuffer() const;
+
+    /**
+     * \brief Checks whether dynamic uniform buffers can be used
+     *
+     * If this returns \c true, pipeline layouts use dynamic uniform
+     * buffer descriptors where possible, and small uniform buffers
+     * are suballocated from the shared uniform heap.
+     * \returns \c true if dynamic uniform buffers are enabled.
+     */
+    bool canUseDynamicUniformBuffers() const;
+
+    /**
+     * \brief Queries number of dynamic uniform buffers
+     *
+     * Maximum number of dynamic uniform
+     * buffers in a single pipeline layout.
+     * \returns Dynamic uniform buffer count, or 0
+     */
+    uint32_t getMaxDynamicUniformBuffers() const;
+
+    /**
+     * \brief Shared uniform buffer heap
+     * \returns Uniform heap
+     */
+    DxvkBufferHeap& uniformHeap();
+
+    /**
+     * \brief Shared vertex buffer heap
+     * \returns Vertex heap
+     */
+    DxvkBufferHeap& vertexHeap();
+
+    /**
+     * \brief Image pool
+     * \returns Image pool
+     */
+    DxvkImagePool& imagePool();
+
+    /**
+     * \brief Staging buffer pool
+     * \returns Staging buffer pool
+     */
+    DxvkStagingPool& stagingPool();
+
     /**
      * \brief Checks whether pipelines should be tracked
      * \returns \c true if pipelines need to be tracked
@@ -404,6 +501,24 @@ namespace dxvk {
      */
     DxvkMemoryStats getMemoryStats(uint32_t heap);
 
+    /**
+     * \brief Retrieves mappable video memory statistics
+     * \returns Per-category usage of host-visible video memory
+     */
+    DxvkBarStats getBarStats();
+
+    /**
+     * \brief Retrieves per-category memory statistics
+     * \returns Memory usage by resource category
+     */
+    DxvkMemoryCategoryStats getMemoryCategoryStats();
+
+    /**
+     * \brief Retrieves shader code eviction statistics
+     * \returns Shader code eviction stats
+     */
+    DxvkShaderCodeStats getShaderCodeStats();
+
     /**
      * \brief Retreves current frame ID
      * \returns Current frame ID
@@ -440,6 +555,39 @@ namespace dxvk {
      */
     void registerShader(
       const Rc<DxvkShader>&         shader);
+
+    /**
+     * \brief Checks whether pipelines are being compiled
+     *
+     * Includes state cache entries that have not been
+     * dispatched to the compiler workers yet.
+     * \returns \c true if any pipelines are pending
+     */
+    bool isCompilingPipelines();
+
+    /**
+     * \brief Looks up a previously translated shader
+     *
+     * Queries the on-disk shader cache. The compile hash
+     * must identify all client API options that affect
+     * the shader translation.
+     * \param [in] key Shader key
+     * \param [in] compileHash Compile options hash
+     * \returns Cached shader, or \c nullptr
+     */
+    Rc<DxvkShader> lookupShader(
+      const DxvkShaderKey&          key,
+      const Sha1Hash&               compileHash);
+
+    /**
+     * \brief Adds a shader to the shader cache
+     *
+     * \param [in] shader Newly translated shader
+     * \param [in] compileHash Compile options hash
+     */
+    void cacheShader(
+      const Rc<DxvkShader>&         shader,
+      const Sha1Hash&               compileHash);
     
     /**
      * \brief Prioritizes compilation of a given shader
@@ -455,10 +603,14 @@ namespace dxvk {
      * the submission thread. The status of this operation
      * can be retrieved with \ref waitForSubmission.
      * \param [in] presenter The presenter
+     * \param [in] signal Signal to notify on present completion
+     * \param [in] signalValue Value to signal
      * \param [out] status Present status
      */
     void presentImage(
       const Rc<vk::Presenter>&        presenter,
+      const Rc<sync::Signal>&         signal,
+            uint64_t                  signalValue,
             DxvkSubmitStatus*         status);
     
     /**
@@ -506,6 +658,36 @@ namespace dxvk {
       return m_submissionQueue.pendingSubmissions();
     }
 
+    /**
+     * \brief Last completed submission sequence number
+     *
+     * All command lists submitted up to and including
+     * this sequence number have finished execution.
+     * \returns Last completed sequence number
+     */
+    uint64_t completedSequenceNumber() const {
+      return m_submissionQueue.completedSequenceNumber();
+    }
+
+    /**
+     * \brief Total GPU idle time
+     * \returns GPU idle time, in microseconds
+     */
+    uint64_t gpuIdleTicks() const {
+      return m_submissionQueue.gpuIdleTicks();
+    }
+
+    /**
+     * \brief Reports current flush pacing
+     *
+     * Used by the front-ends to expose their
+     * flush heuristics through the HUD.
+     * \param [in] scale Flush threshold scale, in percent
+     */
+    void setFlushPacing(uint32_t scale) {
+      m_flushPacing.store(scale, std::memory_order_relaxed);
+    }
+
     /**
      * \brief Increments a given stat counter
      *
@@ -517,6 +699,17 @@ namespace dxvk {
       m_statCounters.addCtr(counter, value);
     }
 
+    /**
+     * \brief Updates number of compressed images
+     *
+     * Called when an image that uses fixed-rate
+     * compression is created or destroyed.
+     * \param [in] delta Number of images added
+     */
+    void trackCompressedImages(int32_t delta) {
+      m_compressedImageCount.fetch_add(delta, std::memory_order_relaxed);
+    }
+
     /**
      * \brief Waits for a given submission
      * 
@@ -551,22 +744,50 @@ namespace dxvk {
     Rc<DxvkAdapter>             m_adapter;
     Rc<vk::DeviceFn>            m_vkd;
 
+    // Must outlive all objects that release resources
+    std::unique_ptr<DxvkObjectReclaimer> m_reclaimer;
+
+    // Must outlive all fences
+    std::unique_ptr<DxvkFenceWaiter> m_fenceWaiter;
+
     DxvkDeviceFeatures          m_features;
     DxvkDeviceInfo              m_properties;
     
     DxvkDevicePerfHints         m_perfHints;
+    std::unique_ptr<DxvkTracer> m_tracer;
+    std::unique_ptr<DxvkTelemetry> m_telemetry;
+    DxvkGpuProfiler             m_gpuProfiler;
     DxvkObjects                 m_objects;
+    Rc<DxvkShaderCache>         m_shaderCache;
 
     sync::Spinlock              m_statLock;
     DxvkStatCounters            m_statCounters;
+
+    std::atomic<uint32_t>       m_flushPacing = { 100u };
+    std::atomic<int32_t>        m_compressedImageCount = { 0 };
     
     DxvkDeviceQueueSet          m_queues;
     
-    DxvkRecycler<DxvkCommandList, 16> m_recycledCommandLists;
+    // Large enough to hold every command list that can be in
+    // flight at once, so that we never have to create new
+    // command pools once the peak number has been reached
+    DxvkRecycler<DxvkCommandList, MaxNumQueuedCommandBuffers + 4> m_recycledCommandLists;
     
     DxvkSubmissionQueue m_submissionQueue;
 
+    dxvk::mutex                 m_metaPrewarmMutex;
+    std::unordered_set<
+      DxvkMetaResolvePipelineKey,
+      DxvkHash, DxvkEq>         m_metaPrewarmResolves;
+
     DxvkDevicePerfHints getPerfHints();
+
+    void prewarmResolvePipelines(
+      const DxvkImageCreateInfo&  createInfo);
+
+    std::unique_ptr<DxvkTracer> createTracer();
+
+    std::unique_ptr<DxvkTelemetry> createTelemetry();
     
     void recycleCommandList(
       const Rc<DxvkCommandList>& cmdList);
@@ -3,10 +3,196 @@
 
 namespace dxvk {
 
+  DxvkFenceWaiter::DxvkFenceWaiter(
+    const Rc<vk::DeviceFn>&     vkd)
+  : m_vkd(vkd) {
+
+  }
+
+
+  DxvkFenceWaiter::~DxvkFenceWaiter() {
+    if (m_thread.joinable()) {
+      { std::unique_lock<dxvk::mutex> lock(m_mutex);
+        m_stopped = true;
+
+        if (m_waiting)
+          wakeUp();
+
+        m_condOnAdd.notify_one();
+      }
+
+      m_thread.join();
+    }
+
+    m_vkd->vkDestroySemaphore(m_vkd->device(), m_wakeSemaphore, nullptr);
+  }
+
+
+  void DxvkFenceWaiter::enqueueWait(
+          DxvkFence*            fence,
+          uint64_t              value,
+          DxvkFenceEvent&&      event) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    if (!m_thread.joinable()) {
+      VkSemaphoreTypeCreateInfo typeInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+      typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+
+      VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &typeInfo };
+
+      VkResult vr = m_vkd->vkCreateSemaphore(m_vkd->device(),
+        &semaphoreInfo, nullptr, &m_wakeSemaphore);
+
+      if (vr != VK_SUCCESS)
+        throw DxvkError("Failed to create timeline semaphore");
+
+      m_thread = dxvk::thread([this] { run(); });
+    }
+
+    m_entries.push_back({ fence, value, std::move(event) });
+
+    // Interrupt the current wait so that the
+    // new fence gets added to the wait list
+    if (m_waiting)
+      wakeUp();
+
+    m_condOnAdd.notify_one();
+  }
+
+
+  void DxvkFenceWaiter::cancelWaits(
+          DxvkFence*            fence) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    size_t count = m_entries.size();
+
+    for (size_t i = 0; i < m_entries.size(); ) {
+      if (m_entries[i].fence == fence) {
+        if (i + 1 < m_entries.size())
+          m_entries[i] = std::move(m_entries.back());
+
+        m_entries.pop_back();
+      } else {
+        i++;
+      }
+    }
+
+    // The semaphore can only be part of the current
+    // wait if there were any pending waits for it. The
+    // worker may already be back in a new wait by the time
+    // we get to run again, so wait for the generation to
+    // change rather than for m_waiting to be cleared.
+    if (m_waiting && m_entries.size() != count) {
+      uint64_t generation = m_waitGeneration;
+      wakeUp();
+
+      m_condOnWake.wait(lock, [this, generation] {
+        return m_waitGeneration != generation;
+      });
+    }
+  }
+
+
+  void DxvkFenceWaiter::wakeUp() {
+    VkSemaphoreSignalInfo signalInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO };
+    signalInfo.semaphore = m_wakeSemaphore;
+    signalInfo.value = ++m_wakeValue;
+
+    VkResult vr = m_vkd->vkSignalSemaphore(m_vkd->device(), &signalInfo);
+
+    if (vr != VK_SUCCESS)
+      Logger::err(str::format("Failed to signal semaphore: ", vr));
+  }
+
+
+  void DxvkFenceWaiter::run() {
+    env::setThreadName("dxvk-fence");
+
+    std::vector<VkSemaphore> semaphores;
+    std::vector<uint64_t> values;
+
+    while (true) {
+      std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+      m_waiting = false;
+      m_waitGeneration += 1;
+      m_condOnWake.notify_all();
+
+      m_condOnAdd.wait(lock, [this] {
+        return !m_entries.empty() || m_stopped;
+      });
+
+      if (m_stopped)
+        return;
+
+      // Dispatch all events whose fence has reached the desired
+      // value, and gather the lowest pending value for each fence
+      semaphores.clear();
+      values.clear();
+
+      semaphores.push_back(m_wakeSemaphore);
+      values.push_back(m_wakeValue + 1);
+
+      for (size_t i = 0; i < m_entries.size(); ) {
+        auto& entry = m_entries[i];
+
+        if (entry.fence->getValue() >= entry.value) {
+          entry.event();
+
+          if (i + 1 < m_entries.size())
+            entry = std::move(m_entries.back());
+
+          m_entries.pop_back();
+          continue;
+        }
+
+        size_t index = 1;
+
+        while (index < semaphores.size() && semaphores[index] != entry.fence->handle())
+          index++;
+
+        if (index == semaphores.size()) {
+          semaphores.push_back(entry.fence->handle());
+          values.push_back(entry.value);
+        } else {
+          values[index] = std::min(values[index], entry.value);
+        }
+
+        i++;
+      }
+
+      if (m_entries.empty())
+        continue;
+
+      m_waiting = true;
+      lock.unlock();
+
+      VkSemaphoreWaitInfo waitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+      waitInfo.flags = VK_SEMAPHORE_WAIT_ANY_BIT;
+      waitInfo.semaphoreCount = semaphores.size();
+      waitInfo.pSemaphores = semaphores.data();
+      waitInfo.pValues = values.data();
+
+      VkResult vr = m_vkd->vkWaitSemaphores(
+        m_vkd->device(), &waitInfo, ~0ull);
+
+      if (vr != VK_SUCCESS) {
+        Logger::err(str::format("Failed to wait for semaphores: ", vr));
+
+        lock.lock();
+        m_waiting = false;
+        m_waitGeneration += 1;
+        m_condOnWake.notify_all();
+        return;
+      }
+    }
+  }
+
+
   DxvkFence::DxvkFence(
           DxvkDevice*           device,
     const DxvkFenceCreateInfo&  info)
-  : m_vkd(device->vkd()), m_info(info) {
+  : m_vkd(device->vkd()), m_waiter(&device->fenceWaiter()), m_info(info) {
     VkSemaphoreTypeCreateInfo typeInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
     typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
     typeInfo.initialValue = info.initialValue;
@@ -60,33 +246,16 @@ namespace dxvk {
 
 
   DxvkFence::~DxvkFence() {
-    if (m_thread.joinable()) {
-      {
-        std::unique_lock<dxvk::mutex> lock(m_mutex);
-        m_running = false;
-        m_condVar.notify_one();
-      }
-      m_thread.join();
-    }
+    m_waiter->cancelWaits(this);
     m_vkd->vkDestroySemaphore(m_vkd->device(), m_semaphore, nullptr);
   }
 
 
   void DxvkFence::enqueueWait(uint64_t value, DxvkFenceEvent&& event) {
-    if (value > getValue()) {
-      std::unique_lock<dxvk::mutex> lock(m_mutex);
-      m_queue.emplace(value, std::move(event));
-
-      if (!m_running) {
-        m_running = true;
-        m_thread = dxvk::thread([this] { run(); });
-      } else {
-        m_condVar.notify_one();
-      }
-      lock.unlock();
-    } else {
+    if (value > getValue())
+      m_waiter->enqueueWait(this, value, std::move(event));
+    else
       event();
-    }
   }
 
   void DxvkFence::wait(uint64_t value) {
@@ -102,60 +271,6 @@ namespace dxvk {
     }
   }
 
-  void DxvkFence::run() {
-    uint64_t value = 0ull;
-
-    VkSemaphoreWaitInfo waitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
-    waitInfo.semaphoreCount = 1;
-    waitInfo.pSemaphores = &m_semaphore;
-    waitInfo.pValues = &value;
-
-    while (true) {
-      std::unique_lock<dxvk::mutex> lock(m_mutex);
-
-      m_condVar.wait(lock, [&]() { return !m_queue.empty() || !m_running; });
-
-      // Query actual semaphore value and start from there, so that
-      // we can skip over large increments in the semaphore value
-      VkResult vr = m_vkd->vkGetSemaphoreCounterValue(m_vkd->device(), m_semaphore, &value);
-
-      if (vr != VK_SUCCESS) {
-        Logger::err(str::format("Failed to query semaphore value: ", vr));
-        return;
-      }
-
-      // Signal all enqueued events whose value is not greater than
-      // the current semaphore value
-      while (!m_queue.empty() && m_queue.top().value <= value) {
-        m_queue.top().event();
-        m_queue.pop();
-      }
-
-      if (!m_running)
-        return;
-
-      if (m_queue.empty())
-        continue;
-
-      lock.unlock();
-
-      // Wait for the semaphore to be singaled again and update state.
-      // The timeout is unfortunate, but we can't always know when a
-      // signal operation has been recorded, and the alternative would
-      // be to create a teardown semaphore and use WAIT_ANY, which may
-      // be fall back to a busy-wait loop on some drivers.
-      value += 1;
-
-      vr = m_vkd->vkWaitSemaphores(
-        m_vkd->device(), &waitInfo, 10'000'000ull);
-
-      if (vr != VK_SUCCESS && vr != VK_TIMEOUT) {
-        Logger::err(str::format("Failed to wait for semaphore: ", vr));
-        return;
-      }
-    }
-  }
-
   uint64_t DxvkFence::getValue() {
     uint64_t value = 0;
     VkResult vr = m_vkd->vkGetSemaphoreCounterValue(m_vkd->device(), m_semaphore, &value);
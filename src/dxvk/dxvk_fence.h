@@ -1,7 +1,6 @@
 #pragma once
 
 #include <functional>
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -13,6 +12,7 @@ namespace dxvk {
 
   class DxvkDevice;
   class DxvkFence;
+  class DxvkFenceWaiter;
 
   using DxvkFenceEvent = std::function<void ()>;
 
@@ -43,6 +43,80 @@ namespace dxvk {
     uint64_t value;
   };
 
+  /**
+   * \brief Fence waiter
+   *
+   * Device-wide worker thread that waits for any number of
+   * fences at once, using a single \c vkWaitSemaphores call
+   * with \c VK_SEMAPHORE_WAIT_ANY_BIT, and invokes enqueued
+   * events once their fence has reached the desired value.
+   * An internal timeline semaphore is used to wake up the
+   * thread when the set of pending waits changes. The
+   * thread is only started once the first wait gets
+   * enqueued.
+   */
+  class DxvkFenceWaiter {
+
+  public:
+
+    DxvkFenceWaiter(
+      const Rc<vk::DeviceFn>&     vkd);
+
+    ~DxvkFenceWaiter();
+
+    /**
+     * \brief Enqueues fence wait
+     *
+     * \param [in] fence The fence
+     * \param [in] value Value to wait for
+     * \param [in] event Callback
+     */
+    void enqueueWait(
+            DxvkFence*            fence,
+            uint64_t              value,
+            DxvkFenceEvent&&      event);
+
+    /**
+     * \brief Removes all pending waits for a fence
+     *
+     * Must be called before the fence is destroyed. Ensures
+     * that the worker thread no longer accesses the fence's
+     * semaphore when this returns.
+     * \param [in] fence The fence
+     */
+    void cancelWaits(
+            DxvkFence*            fence);
+
+  private:
+
+    struct Entry {
+      DxvkFence*      fence;
+      uint64_t        value;
+      DxvkFenceEvent  event;
+    };
+
+    Rc<vk::DeviceFn>                m_vkd;
+    VkSemaphore                     m_wakeSemaphore = VK_NULL_HANDLE;
+    uint64_t                        m_wakeValue     = 0;
+
+    bool                            m_stopped = false;
+    bool                            m_waiting = false;
+    uint64_t                        m_waitGeneration = 0;
+
+    dxvk::mutex                     m_mutex;
+    dxvk::condition_variable        m_condOnAdd;
+    dxvk::condition_variable        m_condOnWake;
+    std::vector<Entry>              m_entries;
+
+    dxvk::thread                    m_thread;
+
+    void wakeUp();
+
+    void run();
+
+  };
+
+
   /**
    * \brief Fence
    *
@@ -99,35 +173,11 @@ namespace dxvk {
 
   private:
 
-    struct QueueItem {
-      QueueItem() { }
-      QueueItem(uint64_t v, DxvkFenceEvent&& e)
-      : value(v), event(std::move(e)) { }
-
-      uint64_t        value;
-      DxvkFenceEvent  event;
-
-      bool operator == (const QueueItem& item) const { return value == item.value; }
-      bool operator != (const QueueItem& item) const { return value != item.value; }
-      bool operator <  (const QueueItem& item) const { return value <  item.value; }
-      bool operator <= (const QueueItem& item) const { return value <= item.value; }
-      bool operator >  (const QueueItem& item) const { return value >  item.value; }
-      bool operator >= (const QueueItem& item) const { return value >= item.value; }
-    };
-
     Rc<vk::DeviceFn>                m_vkd;
+    DxvkFenceWaiter*                m_waiter;
     DxvkFenceCreateInfo             m_info;
     VkSemaphore                     m_semaphore;
 
-    std::priority_queue<QueueItem>  m_queue;
-    bool                            m_running    = false;
-
-    dxvk::mutex                     m_mutex;
-    dxvk::condition_variable        m_condVar;
-    dxvk::thread                    m_thread;
-
-    void run();
-
   };
 
 }
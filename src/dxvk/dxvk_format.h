@@ -1,5 +1,6 @@
 #pragma once
 
+#include "dxvk_hash.h"
 #include "dxvk_include.h"
 
 namespace dxvk {
@@ -45,6 +46,26 @@ namespace dxvk {
     VkImageUsageFlags           usage;
     VkImageCreateFlags          flags;
     VkExternalMemoryHandleTypeFlagBits handleType;
+
+    bool eq(const DxvkFormatQuery& other) const {
+      return format     == other.format
+          && type       == other.type
+          && tiling     == other.tiling
+          && usage      == other.usage
+          && flags      == other.flags
+          && handleType == other.handleType;
+    }
+
+    size_t hash() const {
+      DxvkHashState hash;
+      hash.add(uint32_t(format));
+      hash.add(uint32_t(type));
+      hash.add(uint32_t(tiling));
+      hash.add(usage);
+      hash.add(flags);
+      hash.add(uint32_t(handleType));
+      return hash;
+    }
   };
 
   /**
@@ -92,6 +113,9 @@ namespace dxvk {
   /// Format lookup table
   extern const std::array<DxvkFormatInfo, DxvkFormatCount> g_formatInfos;
 
+  /// Ranges of formats in the lookup table, in order
+  extern const std::array<std::pair<VkFormat, VkFormat>, 4> g_formatGroups;
+
   /**
    * \brief Looks up format info
    *
@@ -43,6 +43,19 @@ namespace dxvk {
 
 
   bool DxvkFramebufferInfo::hasTargets(const DxvkRenderTargets& renderTargets) {
+    bool eq = isEquivalentView(m_renderTargets.depth.view, renderTargets.depth.view)
+           && m_renderTargets.depth.layout == renderTargets.depth.layout;
+
+    for (uint32_t i = 0; i < MaxNumRenderTargets && eq; i++) {
+      eq &= isEquivalentView(m_renderTargets.color[i].view, renderTargets.color[i].view)
+         && m_renderTargets.color[i].layout == renderTargets.color[i].layout;
+    }
+
+    return eq;
+  }
+
+
+  bool DxvkFramebufferInfo::usesTargets(const DxvkRenderTargets& renderTargets) const {
     bool eq = m_renderTargets.depth.view   == renderTargets.depth.view
            && m_renderTargets.depth.layout == renderTargets.depth.layout;
 
@@ -55,6 +68,28 @@ namespace dxvk {
   }
 
 
+  bool DxvkFramebufferInfo::isEquivalentView(
+    const Rc<DxvkImageView>&  a,
+    const Rc<DxvkImageView>&  b) {
+    if (a == b)
+      return true;
+
+    if (a == nullptr || b == nullptr)
+      return false;
+
+    // Applications commonly create multiple views for the same
+    // subresources. Rendering to either view is identical as
+    // long as format and swizzle match, so there is no need
+    // to end the current render pass in that case.
+    const VkComponentMapping& sa = a->info().swizzle;
+    const VkComponentMapping& sb = b->info().swizzle;
+
+    return a->matchesView(b)
+        && sa.r == sb.r && sa.g == sb.g
+        && sa.b == sb.b && sa.a == sb.a;
+  }
+
+
   bool DxvkFramebufferInfo::isFullSize(const Rc<DxvkImageView>& view) const {
     return m_renderSize.width  == view->mipLevelExtent(0).width
         && m_renderSize.height == view->mipLevelExtent(0).height
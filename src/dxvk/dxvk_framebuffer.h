@@ -185,10 +185,21 @@ namespace dxvk {
      *
      * \param [in] renderTargets Render targets to check
      * \returns \c true if the render targets are the same
-     *          as the ones used for this framebuffer object.
+     *          as the ones used for this framebuffer object,
+     *          or if all views are equivalent to them.
      */
     bool hasTargets(const DxvkRenderTargets& renderTargets);
 
+    /**
+     * \brief Checks whether the framebuffer uses the given targets
+     *
+     * Unlike \ref hasTargets, this requires all views to be
+     * identical rather than equivalent.
+     * \param [in] renderTargets Render targets to check
+     * \returns \c true if all views and layouts are the same
+     */
+    bool usesTargets(const DxvkRenderTargets& renderTargets) const;
+
     /**
      * \brief Checks whether view and framebuffer sizes match
      *
@@ -229,6 +240,10 @@ namespace dxvk {
     DxvkFramebufferSize computeRenderSize(
       const DxvkFramebufferSize& defaultSize) const;
 
+    static bool isEquivalentView(
+      const Rc<DxvkImageView>&  a,
+      const Rc<DxvkImageView>&  b);
+
     DxvkFramebufferSize computeRenderTargetSize(
       const Rc<DxvkImageView>& renderTarget) const;
 
@@ -0,0 +1,141 @@
+#include <algorithm>
+
+#include "dxvk_gpu_profiler.h"
+
+namespace dxvk {
+
+  DxvkGpuProfiler::DxvkGpuProfiler(
+          float                 timestampPeriod)
+  : m_timestampPeriod(double(timestampPeriod)) {
+
+  }
+
+
+  DxvkGpuProfiler::~DxvkGpuProfiler() {
+
+  }
+
+
+  void DxvkGpuProfiler::addPass(
+          std::string&&         name,
+    const Rc<DxvkGpuQuery>&     begin,
+    const Rc<DxvkGpuQuery>&     end,
+    const Rc<DxvkGpuQuery>&     stats) {
+    Pass pass;
+    pass.name     = std::move(name);
+    pass.begin    = begin;
+    pass.end      = end;
+    pass.stats    = stats;
+    pass.frameId  = m_frameId.load();
+
+    std::lock_guard lock(m_mutex);
+    m_passes.push(std::move(pass));
+  }
+
+
+  void DxvkGpuProfiler::resolvePasses() {
+    std::lock_guard lock(m_mutex);
+
+    while (!m_passes.empty()) {
+      Pass& pass = m_passes.front();
+
+      DxvkQueryData beginData = { };
+      DxvkQueryData endData = { };
+      DxvkQueryData statsData = { };
+
+      DxvkGpuQueryStatus beginStatus = pass.begin->getData(beginData);
+      DxvkGpuQueryStatus endStatus = pass.end->getData(endData);
+      DxvkGpuQueryStatus statsStatus = pass.stats != nullptr
+        ? pass.stats->getData(statsData)
+        : DxvkGpuQueryStatus::Available;
+
+      if (beginStatus == DxvkGpuQueryStatus::Pending
+       || endStatus   == DxvkGpuQueryStatus::Pending
+       || statsStatus == DxvkGpuQueryStatus::Pending)
+        break;
+
+      // Passes are resolved in submission order, so the first
+      // pass of a new frame means that the previous one is done
+      if (pass.frameId != m_currFrameId) {
+        finishFrame();
+        m_currFrameId = pass.frameId;
+      }
+
+      if (beginStatus == DxvkGpuQueryStatus::Available
+       && endStatus   == DxvkGpuQueryStatus::Available
+       && endData.timestamp.time >= beginData.timestamp.time) {
+        uint64_t ticks = endData.timestamp.time - beginData.timestamp.time;
+
+        auto entry = m_currFrame.find(pass.name);
+
+        if (entry == m_currFrame.end()) {
+          DxvkGpuPassStats stats = { pass.name, 0ull, 0u, { } };
+          entry = m_currFrame.emplace(std::move(pass.name), std::move(stats)).first;
+        }
+
+        entry->second.timeNs += uint64_t(double(ticks) * m_timestampPeriod);
+        entry->second.count += 1;
+
+        if (statsStatus == DxvkGpuQueryStatus::Available)
+          accumulateStats(entry->second.stats, statsData.statistic);
+      }
+
+      m_passes.pop();
+    }
+  }
+
+
+  void DxvkGpuProfiler::endFrame() {
+    if (isEnabled())
+      m_frameId += 1;
+  }
+
+
+  void DxvkGpuProfiler::flush() {
+    std::lock_guard lock(m_mutex);
+    m_passes = std::queue<Pass>();
+  }
+
+
+  std::vector<DxvkGpuPassStats> DxvkGpuProfiler::getFrameStats() const {
+    std::lock_guard lock(m_statsMutex);
+    return m_lastFrame;
+  }
+
+
+  void DxvkGpuProfiler::accumulateStats(
+          DxvkQueryStatisticData& dst,
+    const DxvkQueryStatisticData& src) {
+    dst.iaVertices       += src.iaVertices;
+    dst.iaPrimitives     += src.iaPrimitives;
+    dst.vsInvocations    += src.vsInvocations;
+    dst.gsInvocations    += src.gsInvocations;
+    dst.gsPrimitives     += src.gsPrimitives;
+    dst.clipInvocations  += src.clipInvocations;
+    dst.clipPrimitives   += src.clipPrimitives;
+    dst.fsInvocations    += src.fsInvocations;
+    dst.tcsPatches       += src.tcsPatches;
+    dst.tesInvocations   += src.tesInvocations;
+    dst.csInvocations    += src.csInvocations;
+  }
+
+
+  void DxvkGpuProfiler::finishFrame() {
+    std::vector<DxvkGpuPassStats> stats;
+    stats.reserve(m_currFrame.size());
+
+    for (auto& entry : m_currFrame)
+      stats.push_back(std::move(entry.second));
+
+    m_currFrame.clear();
+
+    std::sort(stats.begin(), stats.end(),
+      [] (const DxvkGpuPassStats& a, const DxvkGpuPassStats& b) {
+        return a.timeNs > b.timeNs;
+      });
+
+    std::lock_guard lock(m_statsMutex);
+    m_lastFrame = std::move(stats);
+  }
+
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../util/thread.h"
+
+#include "dxvk_gpu_query.h"
+
+namespace dxvk {
+
+  /**
+   * \brief GPU pass statistics
+   *
+   * Accumulated GPU time of all passes
+   * with the same name within a frame.
+   */
+  struct DxvkGpuPassStats {
+    std::string name;
+    uint64_t    timeNs;
+    uint32_t    count;
+    /// Accumulated pipeline statistics. Only
+    /// valid if pipeline statistics are enabled.
+    DxvkQueryStatisticData stats;
+  };
+
+
+  /**
+   * \brief GPU pass profiler
+   *
+   * Collects timestamp query pairs that contexts record
+   * around render passes and runs of dispatches, and
+   * accumulates the GPU time per pass name and frame.
+   * Profiling is disabled by default and has no cost
+   * until it is enabled, e.g. by a HUD item.
+   */
+  class DxvkGpuProfiler {
+
+  public:
+
+    DxvkGpuProfiler(
+            float                 timestampPeriod);
+
+    ~DxvkGpuProfiler();
+
+    /**
+     * \brief Checks whether profiling is enabled
+     * \returns \c true if contexts should record passes
+     */
+    bool isEnabled() const {
+      return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Enables profiling
+     *
+     * Profiling cannot be disabled again, since
+     * contexts may be recording passes at any time.
+     */
+    void enable() {
+      m_enabled.store(true);
+    }
+
+    /**
+     * \brief Checks whether pipeline statistics are recorded
+     * \returns \c true if contexts should record a pipeline
+     *    statistics query for each pass
+     */
+    bool hasPipelineStats() const {
+      return m_pipelineStats.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Enables pipeline statistics
+     *
+     * Implicitly enables profiling. Requires
+     * pipeline statistics query support.
+     */
+    void enablePipelineStats() {
+      m_pipelineStats.store(true);
+      m_enabled.store(true);
+    }
+
+    /**
+     * \brief Adds a pass
+     *
+     * The pass is attributed to the current frame.
+     * \param [in] name Pass name
+     * \param [in] begin Timestamp query at the start of the pass
+     * \param [in] end Timestamp query at the end of the pass
+     * \param [in] stats Pipeline statistics query, may be \c nullptr
+     */
+    void addPass(
+            std::string&&         name,
+      const Rc<DxvkGpuQuery>&     begin,
+      const Rc<DxvkGpuQuery>&     end,
+      const Rc<DxvkGpuQuery>&     stats);
+
+    /**
+     * \brief Resolves pending passes
+     *
+     * Reads back timestamps for passes that have completed
+     * execution. Should be called whenever a command list
+     * has finished executing.
+     */
+    void resolvePasses();
+
+    /**
+     * \brief Marks the end of a frame
+     *
+     * Subsequently added passes will be
+     * attributed to the next frame.
+     */
+    void endFrame();
+
+    /**
+     * \brief Discards all pending passes
+     *
+     * Must be called before the device destroys its
+     * query pools, since pending passes reference queries.
+     */
+    void flush();
+
+    /**
+     * \brief Retrieves statistics of the last complete frame
+     *
+     * Passes are sorted by GPU time in descending order.
+     * \returns Per-pass statistics
+     */
+    std::vector<DxvkGpuPassStats> getFrameStats() const;
+
+  private:
+
+    struct Pass {
+      std::string       name;
+      Rc<DxvkGpuQuery>  begin;
+      Rc<DxvkGpuQuery>  end;
+      Rc<DxvkGpuQuery>  stats;
+      uint64_t          frameId;
+    };
+
+    double                    m_timestampPeriod;
+
+    std::atomic<bool>         m_enabled = { false };
+    std::atomic<bool>         m_pipelineStats = { false };
+    std::atomic<uint64_t>     m_frameId = { 0ull };
+
+    dxvk::mutex               m_mutex;
+    std::queue<Pass>          m_passes;
+
+    uint64_t                  m_currFrameId = 0;
+    std::unordered_map<std::string, DxvkGpuPassStats> m_currFrame;
+
+    mutable dxvk::mutex       m_statsMutex;
+    std::vector<DxvkGpuPassStats> m_lastFrame;
+
+    void finishFrame();
+
+    static void accumulateStats(
+            DxvkQueryStatisticData& dst,
+      const DxvkQueryStatisticData& src);
+
+  };
+
+}
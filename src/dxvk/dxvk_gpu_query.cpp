@@ -93,16 +93,28 @@ namespace dxvk {
     const DxvkGpuQueryHandle& handle) {
     DxvkQueryData tmpData = { };
 
-    // Try to copy query data to temporary structure
-    VkResult result = m_vkd->vkGetQueryPoolResults(m_vkd->device(),
-      handle.queryPool, handle.queryId, 1,
-      sizeof(DxvkQueryData), &tmpData,
-      sizeof(DxvkQueryData), VK_QUERY_RESULT_64_BIT);
-    
-    if (result == VK_NOT_READY)
-      return DxvkGpuQueryStatus::Pending;
-    else if (result != VK_SUCCESS)
-      return DxvkGpuQueryStatus::Failed;
+    if (handle.resultData) {
+      // The availability word is written by the same copy as the
+      // result, so if it is set, the result is known to be valid
+      auto data = reinterpret_cast<const volatile uint64_t*>(handle.resultData);
+
+      if (!data[1])
+        return DxvkGpuQueryStatus::Pending;
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      tmpData.occlusion.samplesPassed = data[0];
+    } else {
+      // Try to copy query data to temporary structure
+      VkResult result = m_vkd->vkGetQueryPoolResults(m_vkd->device(),
+        handle.queryPool, handle.queryId, 1,
+        sizeof(DxvkQueryData), &tmpData,
+        sizeof(DxvkQueryData), VK_QUERY_RESULT_64_BIT);
+
+      if (result == VK_NOT_READY)
+        return DxvkGpuQueryStatus::Pending;
+      else if (result != VK_SUCCESS)
+        return DxvkGpuQueryStatus::Failed;
+    }
     
     // Add numbers to the destination structure
     switch (m_type) {
@@ -182,7 +194,9 @@ namespace dxvk {
   : m_device        (device),
     m_vkd           (device->vkd()),
     m_queryType     (queryType),
-    m_queryPoolSize (queryPoolSize) {
+    m_queryPoolSize (queryPoolSize),
+    m_useReadback   (queryType == VK_QUERY_TYPE_OCCLUSION
+                  && device->config().enableQueryReadback) {
 
   }
 
@@ -206,6 +220,14 @@ namespace dxvk {
     
     DxvkGpuQueryHandle result = m_handles.back();
     m_handles.pop_back();
+
+    // Queries only get returned to the allocator once all
+    // GPU work is done, so the result can be safely cleared
+    if (result.resultData) {
+      result.resultData[0] = 0;
+      result.resultData[1] = 0;
+    }
+
     return result;
   }
 
@@ -245,8 +267,38 @@ namespace dxvk {
 
     m_pools.push_back(queryPool);
 
-    for (uint32_t i = 0; i < m_queryPoolSize; i++)
-      m_handles.push_back({ this, queryPool, i });
+    DxvkBufferSliceHandle resultSlice = { };
+
+    if (m_useReadback) {
+      DxvkBufferCreateInfo bufferInfo;
+      bufferInfo.size   = m_queryPoolSize * ReadbackStride;
+      bufferInfo.usage  = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+      bufferInfo.stages = VK_PIPELINE_STAGE_TRANSFER_BIT
+                        | VK_PIPELINE_STAGE_HOST_BIT;
+      bufferInfo.access = VK_ACCESS_TRANSFER_WRITE_BIT
+                        | VK_ACCESS_HOST_READ_BIT;
+
+      Rc<DxvkBuffer> buffer = m_device->createBuffer(bufferInfo,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+        VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
+      resultSlice = buffer->getSliceHandle();
+      m_resultBuffers.push_back(std::move(buffer));
+    }
+
+    for (uint32_t i = 0; i < m_queryPoolSize; i++) {
+      DxvkGpuQueryHandle handle = { this, queryPool, i };
+
+      if (resultSlice.handle) {
+        handle.resultBuffer = resultSlice.handle;
+        handle.resultOffset = resultSlice.offset + i * ReadbackStride;
+        handle.resultData = reinterpret_cast<uint64_t*>(
+          reinterpret_cast<char*>(resultSlice.mapPtr) + i * ReadbackStride);
+      }
+
+      m_handles.push_back(handle);
+    }
   }
 
 
@@ -372,6 +424,59 @@ namespace dxvk {
   }
 
 
+  void DxvkGpuQueryManager::flushReadbacks(
+    const Rc<DxvkCommandList>&  cmd) {
+    if (m_pendingReadbacks.empty())
+      return;
+
+    // Sort queries so that we can copy the results of
+    // consecutive queries with a single command
+    std::sort(m_pendingReadbacks.begin(), m_pendingReadbacks.end(),
+      [] (const DxvkGpuQueryHandle& a, const DxvkGpuQueryHandle& b) {
+        if (a.queryPool != b.queryPool)
+          return a.queryPool < b.queryPool;
+        return a.queryId < b.queryId;
+      });
+
+    size_t first = 0;
+
+    for (size_t i = 1; i <= m_pendingReadbacks.size(); i++) {
+      const auto& base = m_pendingReadbacks[first];
+
+      if (i < m_pendingReadbacks.size()) {
+        const auto& next = m_pendingReadbacks[i];
+
+        if (next.queryPool == base.queryPool
+         && next.queryId == base.queryId + (i - first))
+          continue;
+      }
+
+      cmd->cmdCopyQueryPoolResults(base.queryPool,
+        base.queryId, i - first, base.resultBuffer, base.resultOffset,
+        DxvkGpuQueryAllocator::ReadbackStride,
+        VK_QUERY_RESULT_64_BIT |
+        VK_QUERY_RESULT_WAIT_BIT |
+        VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+      first = i;
+    }
+
+    VkMemoryBarrier2 barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+    barrier.srcStageMask  = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.dstStageMask  = VK_PIPELINE_STAGE_2_HOST_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+
+    VkDependencyInfo depInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    depInfo.memoryBarrierCount = 1;
+    depInfo.pMemoryBarriers = &barrier;
+
+    cmd->cmdPipelineBarrier(DxvkCmdBuffer::ExecBuffer, &depInfo);
+
+    m_pendingReadbacks.clear();
+  }
+
+
   void DxvkGpuQueryManager::beginSingleQuery(
     const Rc<DxvkCommandList>&  cmd,
     const Rc<DxvkGpuQuery>&     query) {
@@ -414,6 +519,9 @@ namespace dxvk {
         handle.queryId);
     }
 
+    if (handle.resultData)
+      m_pendingReadbacks.push_back(handle);
+
     cmd->trackResource<DxvkAccess::None>(query);
   }
   
@@ -10,6 +10,7 @@
 
 namespace dxvk {
 
+  class DxvkBuffer;
   class DxvkCommandList;
 
   class DxvkGpuQueryPool;
@@ -102,11 +103,19 @@ namespace dxvk {
    * the actual pool and query index. Since
    * query pools have to be reset on the GPU,
    * this also comes with a reset event.
+   *
+   * If query readback is enabled, the result
+   * buffer stores the query result followed
+   * by its availability, which are copied
+   * there at the end of the submission.
    */
   struct DxvkGpuQueryHandle {
     DxvkGpuQueryAllocator* allocator  = nullptr;
     VkQueryPool            queryPool  = VK_NULL_HANDLE;
     uint32_t               queryId    = 0;
+    VkBuffer               resultBuffer = VK_NULL_HANDLE;
+    VkDeviceSize           resultOffset = 0;
+    uint64_t*              resultData = nullptr;
   };
 
 
@@ -158,6 +167,25 @@ namespace dxvk {
       return m_handles.back();
     }
 
+    /**
+     * \brief Retrieves handle for GPU-side result copies
+     *
+     * Only meaningful for occlusion queries. Fails if the
+     * result depends on more than one query handle, or if
+     * it is already known to be non-zero.
+     * \param [out] handle The only query handle, or a
+     *    null handle if no samples can have passed
+     * \returns \c true if the result can be copied
+     */
+    bool getCopyHandle(
+            DxvkGpuQueryHandle& handle) const {
+      if (m_handles.size() > 1 || m_queryData.occlusion.samplesPassed)
+        return false;
+
+      handle = this->handle();
+      return true;
+    }
+
     /**
      * \brief Query index
      * 
@@ -252,6 +280,10 @@ namespace dxvk {
 
   public:
 
+    /// Size of a single query result in the result
+    /// buffer, including the availability value
+    constexpr static VkDeviceSize ReadbackStride = 2 * sizeof(uint64_t);
+
     DxvkGpuQueryAllocator(
             DxvkDevice*         device,
             VkQueryType         queryType,
@@ -285,10 +317,12 @@ namespace dxvk {
     Rc<vk::DeviceFn>  m_vkd;
     VkQueryType       m_queryType;
     uint32_t          m_queryPoolSize;
+    bool              m_useReadback;
     
     dxvk::mutex                     m_mutex;
     std::vector<DxvkGpuQueryHandle> m_handles;
     std::vector<VkQueryPool>        m_pools;
+    std::vector<Rc<DxvkBuffer>>     m_resultBuffers;
 
     void createQueryPool();
 
@@ -400,12 +434,27 @@ namespace dxvk {
       const Rc<DxvkCommandList>&  cmd,
             VkQueryType           type);
 
+    /**
+     * \brief Copies query results to result buffers
+     *
+     * Records copies for all queries that were ended since
+     * the last call, so that their results can be read on
+     * the host without querying the Vulkan query pool. Must
+     * be called outside of a render pass at the end of a
+     * command list.
+     * \param [in] cmd Command list
+     */
+    void flushReadbacks(
+      const Rc<DxvkCommandList>&  cmd);
+
   private:
 
     DxvkGpuQueryPool*             m_pool;
     uint32_t                      m_activeTypes;
     std::vector<Rc<DxvkGpuQuery>> m_activeQueries;
 
+    std::vector<DxvkGpuQueryHandle> m_pendingReadbacks;
+
     void beginSingleQuery(
       const Rc<DxvkCommandList>&  cmd,
       const Rc<DxvkGpuQuery>&     query);
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iomanip>
 
 #include "../util/util_time.h"
@@ -81,6 +82,15 @@ namespace dxvk {
       }
     }
 
+    // Canonicalize attribute order, so that input layouts which
+    // only differ in the order of their elements can share the
+    // same vertex input library.
+    std::sort(viAttributes.begin(), viAttributes.begin() + attrCount, [] (
+        const VkVertexInputAttributeDescription& a,
+        const VkVertexInputAttributeDescription& b) {
+      return a.location < b.location;
+    });
+
     if (attrCount) {
       viInfo.vertexAttributeDescriptionCount = attrCount;
       viInfo.pVertexAttributeDescriptions = viAttributes.data();
@@ -186,6 +196,10 @@ namespace dxvk {
     info.pDynamicState        = &dyInfo;
     info.basePipelineIndex    = -1;
 
+    // All libraries of a linked pipeline must use the same binding model
+    if (m_device->canUseDescriptorBuffer())
+      info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
     VkResult vr = vk->vkCreateGraphicsPipelines(vk->device(),
       VK_NULL_HANDLE, 1, &info, nullptr, &m_pipeline);
 
@@ -308,6 +322,13 @@ namespace dxvk {
     // We need to be fully consistent with the pipeline state here, and
     // while we could consistently infer it, just don't take any chances
     cbUseDynamicBlendConstants = state.useDynamicBlendConstants();
+
+    // Blend enable and equations are set at draw time. The attachment
+    // states only carry the write mask in that case, so pipelines only
+    // differing in blend state can share the same output state.
+    cbUseDynamicBlendState = state.om.dynamicBlend()
+      && device->features().extExtendedDynamicState3.extendedDynamicState3ColorBlendEnable
+      && device->features().extExtendedDynamicState3.extendedDynamicState3ColorBlendEquation;
   }
 
 
@@ -325,6 +346,7 @@ namespace dxvk {
            && msInfo.alphaToOneEnable         == other.msInfo.alphaToOneEnable
            && msSampleMask                    == other.msSampleMask
            && cbUseDynamicBlendConstants      == other.cbUseDynamicBlendConstants
+           && cbUseDynamicBlendState          == other.cbUseDynamicBlendState
            && feedbackLoop                    == other.feedbackLoop;
 
     for (uint32_t i = 0; i < rtInfo.colorAttachmentCount && eq; i++)
@@ -364,6 +386,7 @@ namespace dxvk {
     hash.add(uint32_t(msInfo.alphaToOneEnable));
     hash.add(uint32_t(msSampleMask));
     hash.add(uint32_t(cbUseDynamicBlendConstants));
+    hash.add(uint32_t(cbUseDynamicBlendState));
     hash.add(uint32_t(feedbackLoop));
 
     for (uint32_t i = 0; i < rtInfo.colorAttachmentCount; i++)
@@ -394,7 +417,7 @@ namespace dxvk {
     auto vk = m_device->vkd();
 
     uint32_t dynamicStateCount = 0;
-    std::array<VkDynamicState, 4> dynamicStates = { };
+    std::array<VkDynamicState, 6> dynamicStates = { };
 
     if (m_device->features().extExtendedDynamicState3.extendedDynamicState3RasterizationSamples
      && m_device->features().extExtendedDynamicState3.extendedDynamicState3SampleMask
@@ -409,6 +432,11 @@ namespace dxvk {
     if (state.cbUseDynamicBlendConstants)
       dynamicStates[dynamicStateCount++] = VK_DYNAMIC_STATE_BLEND_CONSTANTS;
 
+    if (state.cbUseDynamicBlendState) {
+      dynamicStates[dynamicStateCount++] = VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT;
+      dynamicStates[dynamicStateCount++] = VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT;
+    }
+
     VkPipelineDynamicStateCreateInfo dyInfo = { VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
 
     if (dynamicStateCount) {
@@ -423,6 +451,9 @@ namespace dxvk {
     if (state.feedbackLoop & VK_IMAGE_ASPECT_DEPTH_BIT)
       flags |= VK_PIPELINE_CREATE_DEPTH_STENCIL_ATTACHMENT_FEEDBACK_LOOP_BIT_EXT;
 
+    if (m_device->canUseDescriptorBuffer())
+      flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
     // pNext is non-const for some reason, but this is only an input
     // structure, so we should be able to safely use const_cast.
     VkGraphicsPipelineLibraryCreateInfoEXT libInfo = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT };
@@ -650,6 +681,13 @@ namespace dxvk {
     
     if (state.useDynamicBlendConstants())
       dyStates[dyInfo.dynamicStateCount++] = VK_DYNAMIC_STATE_BLEND_CONSTANTS;
+
+    if (state.om.dynamicBlend()
+     && device->features().extExtendedDynamicState3.extendedDynamicState3ColorBlendEnable
+     && device->features().extExtendedDynamicState3.extendedDynamicState3ColorBlendEquation) {
+      dyStates[dyInfo.dynamicStateCount++] = VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT;
+      dyStates[dyInfo.dynamicStateCount++] = VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT;
+    }
     
     if (state.useDynamicStencilRef())
       dyStates[dyInfo.dynamicStateCount++] = VK_DYNAMIC_STATE_STENCIL_REFERENCE;
@@ -940,8 +978,10 @@ namespace dxvk {
         // which will then acquire it to increment the use counter.
         lock.unlock();
 
-        // If necessary, compile an optimized pipeline variant
-        if (!instance->fastHandle.load())
+        // If creating the base pipeline failed, compile an optimized
+        // variant right away. Otherwise, wait until the pipeline has
+        // been used often enough for that to be worth the effort.
+        if (!instance->fastHandle.load() && !instance->baseHandle.load())
           m_workers->compileGraphicsPipeline(this, state, DxvkPipelinePriority::Low);
 
         // Only store pipelines in the state cache that cannot benefit
@@ -955,6 +995,62 @@ namespace dxvk {
     // been compiled yet, use the slower base pipeline instead.
     VkPipeline fastHandle = instance->fastHandle.load();
 
+    if (likely(fastHandle != VK_NULL_HANDLE))
+      return std::make_pair(fastHandle, DxvkGraphicsPipelineType::FastPipeline);
+
+    // Deferred instances have no base pipeline, so wait for the worker
+    // to finish. This returns immediately if the worker is already done.
+    if (unlikely(instance->isDeferred)) {
+      fastHandle = this->getOptimizedPipeline(state);
+      instance->fastHandle.store(fastHandle, std::memory_order_release);
+      return std::make_pair(fastHandle, DxvkGraphicsPipelineType::FastPipeline);
+    }
+
+    // Base pipelines are cheap to create, but specialization constants
+    // such as D3D9 sampler types get read from a uniform buffer instead,
+    // which is slower. Only compile optimized variants for state
+    // combinations that are used a lot, so that combinations which
+    // only show up briefly do not keep the workers busy.
+    if (instance->useCount.fetch_add(1u, std::memory_order_relaxed) + 1u == HotPipelineUseCount)
+      m_workers->compileGraphicsPipeline(this, state, DxvkPipelinePriority::Low);
+
+    return std::make_pair(instance->baseHandle.load(), DxvkGraphicsPipelineType::BasePipeline);
+  }
+
+
+  std::pair<VkPipeline, DxvkGraphicsPipelineType> DxvkGraphicsPipeline::tryGetPipelineHandle(
+    const DxvkGraphicsPipelineStateInfo& state) {
+    DxvkGraphicsPipelineInstance* instance = this->findInstance(state);
+
+    if (unlikely(!instance)) {
+      // Fast-linking pipelines is cheap enough, and workers will not
+      // compile optimized pipelines if pipeline libraries are forced.
+      if (this->canCreateBasePipeline(state)
+       || m_device->config().enableGraphicsPipelineLibrary == Tristate::True)
+        return this->getPipelineHandle(state);
+
+      // Exit early if the state vector is invalid
+      if (!this->validatePipelineState(state, true))
+        return std::make_pair(VK_NULL_HANDLE, DxvkGraphicsPipelineType::FastPipeline);
+
+      std::unique_lock<dxvk::mutex> lock(m_mutex);
+      instance = this->findInstance(state);
+
+      if (!instance) {
+        // Add an instance without any pipeline handles so that
+        // subsequent calls know that compilation is in progress
+        instance = &(*m_pipelines.emplace(state, VK_NULL_HANDLE, VK_NULL_HANDLE, true));
+        m_stats->numGraphicsPipelines += 1;
+
+        lock.unlock();
+
+        m_workers->compileGraphicsPipeline(this, state, DxvkPipelinePriority::High);
+        this->writePipelineStateToCache(state);
+      }
+    }
+
+    VkPipeline fastHandle = instance->fastHandle.load();
+
     if (likely(fastHandle != VK_NULL_HANDLE))
       return std::make_pair(fastHandle, DxvkGraphicsPipelineType::FastPipeline);
 
@@ -1000,6 +1096,17 @@ namespace dxvk {
     // Log pipeline state on error
     if (!pipeline)
       this->logPipelineState(LogLevel::Error, state);
+    else
+      m_optimizedCount.fetch_add(1, std::memory_order_release);
+  }
+
+
+  bool DxvkGraphicsPipeline::hasOptimizedPipeline(
+    const DxvkGraphicsPipelineStateInfo& state) {
+    DxvkGraphicsPipelineInstance* instance = this->findInstance(state);
+
+    return instance && (instance->fastHandle.load()
+      || instance->isCompiling.load());
   }
 
 
@@ -1064,8 +1171,12 @@ namespace dxvk {
   
   DxvkGraphicsPipelineInstance* DxvkGraphicsPipeline::findInstance(
     const DxvkGraphicsPipelineStateInfo& state) {
+    // Compare hashes first to avoid full state comparisons
+    // when a pipeline has a large number of instances
+    size_t hash = state.hash();
+
     for (auto& instance : m_pipelines) {
-      if (instance.state == state)
+      if (instance.stateHash == hash && instance.state == state)
         return &instance;
     }
     
@@ -1187,6 +1298,9 @@ namespace dxvk {
     info.layout             = m_bindings->getPipelineLayout(true);
     info.basePipelineIndex  = -1;
 
+    if (m_device->canUseDescriptorBuffer())
+      info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
     VkPipeline pipeline = VK_NULL_HANDLE;
     VkResult vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
 
@@ -1213,9 +1327,9 @@ namespace dxvk {
     // buggy on some drivers in the past, so just don't allow it.
     VkPipeline handle = createOptimizedPipeline(key);
 
-    if (handle)
-      m_fastPipelines.insert({ key, handle });
-
+    // Also remember failed pipelines, deferred instances
+    // would otherwise try to recompile them on every draw
+    m_fastPipelines.insert({ key, handle });
     return handle;
   }
 
@@ -1223,6 +1337,7 @@ namespace dxvk {
   VkPipeline DxvkGraphicsPipeline::createOptimizedPipeline(
     const DxvkGraphicsPipelineFastInstanceKey& key) const {
     auto vk = m_device->vkd();
+    auto t0 = high_resolution_clock::now();
 
     DxvkShaderStageInfo stageInfo(m_device);
     stageInfo.addStage(VK_SHADER_STAGE_VERTEX_BIT, getShaderCode(m_shaders.vs, key.shState.vsInfo), &key.scState.scInfo);
@@ -1236,6 +1351,9 @@ namespace dxvk {
     if (m_shaders.fs != nullptr)
       stageInfo.addStage(VK_SHADER_STAGE_FRAGMENT_BIT, getShaderCode(m_shaders.fs, key.shState.fsInfo), &key.scState.scInfo);
 
+    if (!stageInfo.isValid())
+      return VK_NULL_HANDLE;
+
     VkGraphicsPipelineCreateInfo info = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, &key.foState.rtInfo };
     info.stageCount               = stageInfo.getStageCount();
     info.pStages                  = stageInfo.getStageInfos();
@@ -1260,6 +1378,9 @@ namespace dxvk {
     if (key.foState.feedbackLoop & VK_IMAGE_ASPECT_DEPTH_BIT)
       info.flags |= VK_PIPELINE_CREATE_DEPTH_STENCIL_ATTACHMENT_FEEDBACK_LOOP_BIT_EXT;
 
+    if (m_device->canUseDescriptorBuffer())
+      info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
     VkPipeline pipeline = VK_NULL_HANDLE;
     VkResult vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
 
@@ -1268,6 +1389,12 @@ namespace dxvk {
       return VK_NULL_HANDLE;
     }
 
+    std::array<const DxvkShader*, 5> shaders = {
+      m_shaders.vs.ptr(), m_shaders.tcs.ptr(), m_shaders.tes.ptr(),
+      m_shaders.gs.ptr(), m_shaders.fs.ptr() };
+
+    m_stats->addCompileTime(DxvkPipelineCompileType::Optimized,
+      shaders.size(), shaders.data(), t0);
     return pipeline;
   }
   
@@ -1559,7 +1686,9 @@ namespace dxvk {
 
         sstr << "  " << i << ": " << format << " [" << r << g << b << a << "] blend: ";
 
-        if (blend.blendEnable())
+        if (state.om.dynamicBlend())
+          sstr << "dynamic" << std::endl;
+        else if (blend.blendEnable())
           sstr << "yes (c:" << blend.srcColorBlendFactor() << "," << blend.dstColorBlendFactor() << "," << blend.colorBlendOp()
                <<     ";a:" << blend.srcAlphaBlendFactor() << "," << blend.dstAlphaBlendFactor() << "," << blend.alphaBlendOp() << ")" << std::endl;
         else
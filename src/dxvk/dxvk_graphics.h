@@ -116,6 +116,7 @@ namespace dxvk {
 
     VkSampleMask                                    msSampleMask               = 0u;
     VkBool32                                        cbUseDynamicBlendConstants = VK_FALSE;
+    VkBool32                                        cbUseDynamicBlendState     = VK_FALSE;
 
     std::array<VkPipelineColorBlendAttachmentState, MaxNumRenderTargets> cbAttachments  = { };
     std::array<VkFormat,                            MaxNumRenderTargets> rtColorFormats = { };
@@ -217,7 +218,7 @@ namespace dxvk {
             DxvkGraphicsPipelineFlags       flags);
 
     VkPipelineDynamicStateCreateInfo  dyInfo    = { VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
-    std::array<VkDynamicState, 12>    dyStates  = { };
+    std::array<VkDynamicState, 14>    dyStates  = { };
 
     bool eq(const DxvkGraphicsPipelineDynamicState& other) const;
 
@@ -348,16 +349,22 @@ namespace dxvk {
     DxvkGraphicsPipelineInstance(
       const DxvkGraphicsPipelineStateInfo&  state_,
             VkPipeline                      baseHandle_,
-            VkPipeline                      fastHandle_)
+            VkPipeline                      fastHandle_,
+            bool                            isDeferred_ = false)
     : state       (state_),
+      stateHash   (state_.hash()),
       baseHandle  (baseHandle_),
       fastHandle  (fastHandle_),
-      isCompiling (fastHandle_ != VK_NULL_HANDLE) { }
+      isCompiling (fastHandle_ != VK_NULL_HANDLE),
+      isDeferred  (isDeferred_) { }
 
     DxvkGraphicsPipelineStateInfo state;
+    size_t                        stateHash   = 0;
     std::atomic<VkPipeline>       baseHandle  = { VK_NULL_HANDLE };
     std::atomic<VkPipeline>       fastHandle  = { VK_NULL_HANDLE };
     std::atomic<VkBool32>         isCompiling = { VK_FALSE };
+    std::atomic<uint32_t>         useCount    = { 0u };
+    bool                          isDeferred  = false;
   };
 
 
@@ -451,7 +458,9 @@ namespace dxvk {
    * pipeline state vector.
    */
   class DxvkGraphicsPipeline {
-    
+    /// Number of times a base pipeline has to be bound
+    /// before an optimized variant gets compiled
+    constexpr static uint32_t HotPipelineUseCount = 16;
   public:
     
     DxvkGraphicsPipeline(
@@ -526,6 +535,21 @@ namespace dxvk {
      */
     std::pair<VkPipeline, DxvkGraphicsPipelineType> getPipelineHandle(
       const DxvkGraphicsPipelineStateInfo&    state);
+
+    /**
+     * \brief Pipeline handle without stalling
+     *
+     * If no pipeline for the given state exists and it cannot
+     * be fast-linked, this will dispatch the pipeline to the
+     * compiler workers rather than compiling it on the calling
+     * thread. A subsequent call to \ref getPipelineHandle will
+     * wait for the pipeline to finish compiling.
+     * \param [in] state Pipeline state vector
+     * \returns Pipeline handle and handle type, or a null
+     *    handle if the pipeline is still being compiled.
+     */
+    std::pair<VkPipeline, DxvkGraphicsPipelineType> tryGetPipelineHandle(
+      const DxvkGraphicsPipelineStateInfo&    state);
     
     /**
      * \brief Compiles a pipeline
@@ -537,6 +561,28 @@ namespace dxvk {
     void compilePipeline(
       const DxvkGraphicsPipelineStateInfo&    state);
 
+    /**
+     * \brief Checks for an optimized pipeline
+     *
+     * \param [in] state Pipeline state vector
+     * \returns \c true if an optimized pipeline for the given
+     *    state has been compiled or is currently being compiled
+     */
+    bool hasOptimizedPipeline(
+      const DxvkGraphicsPipelineStateInfo&    state);
+
+    /**
+     * \brief Queries number of optimized pipelines
+     *
+     * Incremented whenever an optimized pipeline variant finishes
+     * compiling in the background. This allows the context to
+     * cheaply check whether a bound base pipeline can be replaced.
+     * \returns Number of optimized pipelines compiled so far
+     */
+    uint32_t getOptimizedPipelineCount() const {
+      return m_optimizedCount.load(std::memory_order_acquire);
+    }
+
     /**
      * \brief Acquires the pipeline
      *
@@ -579,6 +625,7 @@ namespace dxvk {
     dxvk::mutex                                   m_mutex;
     sync::List<DxvkGraphicsPipelineInstance>      m_pipelines;
     uint32_t                                      m_useCount = 0;
+    std::atomic<uint32_t>                         m_optimizedCount = { 0u };
 
     std::unordered_map<
       DxvkGraphicsPipelineBaseInstanceKey,
@@ -442,10 +442,12 @@ namespace dxvk {
     DxvkOmInfo(
             VkBool32           enableLogicOp,
             VkLogicOp          logicOp,
-            VkImageAspectFlags feedbackLoop)
+            VkImageAspectFlags feedbackLoop,
+            VkBool32           dynamicBlend)
     : m_enableLogicOp (uint16_t(enableLogicOp)),
       m_logicOp       (uint16_t(logicOp)),
       m_feedbackLoop  (uint16_t(feedbackLoop)),
+      m_dynamicBlend  (uint16_t(dynamicBlend)),
       m_reserved      (0) { }
     
     VkBool32 enableLogicOp() const {
@@ -464,12 +466,30 @@ namespace dxvk {
       m_feedbackLoop = uint16_t(feedbackLoop);
     }
 
+    /**
+     * \brief Checks whether blend state is dynamic
+     *
+     * If set, blend enable and blend equations are not part of
+     * the pipeline state, and the attachment blend states only
+     * store the color write mask. Also implies dynamic blend
+     * constants, since the blend factors are not known.
+     * \returns \c VK_TRUE if blend state is dynamic
+     */
+    VkBool32 dynamicBlend() const {
+      return VkBool32(m_dynamicBlend);
+    }
+
+    void setDynamicBlend(VkBool32 dynamicBlend) {
+      m_dynamicBlend = uint16_t(dynamicBlend);
+    }
+
   private:
 
     uint16_t m_enableLogicOp          : 1;
     uint16_t m_logicOp                : 4;
     uint16_t m_feedbackLoop           : 2;
-    uint16_t m_reserved               : 9;
+    uint16_t m_dynamicBlend           : 1;
+    uint16_t m_reserved               : 8;
 
   };
 
@@ -641,6 +661,17 @@ namespace dxvk {
       return result;
     }
 
+    VkColorBlendEquationEXT equation() const {
+      VkColorBlendEquationEXT result;
+      result.srcColorBlendFactor = VkBlendFactor(m_srcColorBlendFactor);
+      result.dstColorBlendFactor = VkBlendFactor(m_dstColorBlendFactor);
+      result.colorBlendOp        = VkBlendOp(m_colorBlendOp);
+      result.srcAlphaBlendFactor = VkBlendFactor(m_srcAlphaBlendFactor);
+      result.dstAlphaBlendFactor = VkBlendFactor(m_dstAlphaBlendFactor);
+      result.alphaBlendOp        = VkBlendOp(m_alphaBlendOp);
+      return result;
+    }
+
   private:
 
     uint32_t m_blendEnable            : 1;
@@ -741,6 +772,10 @@ namespace dxvk {
       return !bit::bcmpeq(this, &other);
     }
 
+    size_t hash() const {
+      return size_t(bit::bhash(this));
+    }
+
     bool useDynamicStencilRef() const {
       return ds.enableStencilTest();
     }
@@ -766,7 +801,7 @@ namespace dxvk {
     }
 
     bool useDynamicBlendConstants() const {
-      bool result = false;
+      bool result = om.dynamicBlend();
       
       for (uint32_t i = 0; i < MaxNumRenderTargets && !result; i++) {
         result |= rt.getColorFormat(i) && omBlend[i].blendEnable()
@@ -1,6 +1,7 @@
 #include "dxvk_image.h"
 
 #include "dxvk_device.h"
+#include "dxvk_image_pool.h"
 
 namespace dxvk {
   
@@ -17,6 +18,32 @@ namespace dxvk {
       m_viewFormats[i] = createInfo.viewFormats[i];
     m_info.viewFormats = m_viewFormats.data();
 
+    if (m_info.compression != VK_IMAGE_COMPRESSION_DEFAULT_EXT && !canCompressImage())
+      m_info.compression = VK_IMAGE_COMPRESSION_DEFAULT_EXT;
+
+    // Keep images in a single layout if requested. Shared images
+    // and swap chain images must use the layout that was asked for.
+    if (device->config().useGeneralLayout
+     && m_info.tiling == VK_IMAGE_TILING_OPTIMAL
+     && m_info.sharing.mode == DxvkSharedHandleMode::None
+     && !m_info.shared
+     && m_info.layout != VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+     && m_info.layout != VK_IMAGE_LAYOUT_ATTACHMENT_FEEDBACK_LOOP_OPTIMAL_EXT)
+      m_info.layout = VK_IMAGE_LAYOUT_GENERAL;
+
+    // Reuse a recently destroyed image with identical
+    // properties if possible, since its contents are
+    // undefined anyway.
+    if (device->imagePool().isEnabled()
+     && DxvkImagePool::canPoolImage(m_info, m_memFlags)) {
+      m_pool = &device->imagePool();
+
+      if (m_pool->acquire(DxvkImagePool::getKey(m_info, m_memFlags), m_image)) {
+        queryCompression();
+        return;
+      }
+    }
+
     // If defined, we should provide a format list, which
     // allows some drivers to enable image compression
     VkImageFormatListCreateInfo formatList = { VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO };
@@ -42,6 +69,12 @@ namespace dxvk {
     if ((m_shared = canShareImage(info, createInfo.sharing)))
       externalInfo.pNext = std::exchange(info.pNext, &externalInfo);
 
+    VkImageCompressionControlEXT compressionInfo = { VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_CONTROL_EXT };
+    compressionInfo.flags = m_info.compression;
+
+    if (m_info.compression != VK_IMAGE_COMPRESSION_DEFAULT_EXT)
+      compressionInfo.pNext = std::exchange(info.pNext, &compressionInfo);
+
     if (m_vkd->vkCreateImage(m_vkd->device(), &info, nullptr, &m_image.image)) {
       throw DxvkError(str::format(
         "DxvkImage: Failed to create image:",
@@ -110,6 +143,15 @@ namespace dxvk {
       if (isGpuWritable)
         hints.set(DxvkMemoryFlag::GpuWritable);
 
+      // Categorize the allocation for memory statistics. Linear
+      // host-visible images are mapped directly by the application.
+      memoryProperties.category = DxvkMemoryCategory::Texture;
+
+      if (m_info.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
+        memoryProperties.category = DxvkMemoryCategory::RenderTarget;
+      else if (m_info.tiling == VK_IMAGE_TILING_LINEAR && (m_memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+        memoryProperties.category = DxvkMemoryCategory::Staging;
+
       m_image.memory = memAlloc.alloc(memoryRequirements, memoryProperties, hints);
 
       // Try to bind the allocated memory slice to the image
@@ -134,6 +176,7 @@ namespace dxvk {
 
         DxvkMemoryProperties memoryProperties = { };
         memoryProperties.flags = m_memFlags;
+        memoryProperties.category = DxvkMemoryCategory::Texture;
 
         // Set size and alignment to match the metadata requirements
         auto& core = memoryRequirements.core.memoryRequirements;
@@ -144,6 +187,8 @@ namespace dxvk {
           memoryProperties, DxvkMemoryFlag::GpuReadable);
       }
     }
+
+    queryCompression();
   }
   
   
@@ -161,11 +206,19 @@ namespace dxvk {
   
   
   DxvkImage::~DxvkImage() {
+    if (m_compressed)
+      m_device->trackCompressedImages(-1);
+
+    // Images are only destroyed once the GPU is done
+    // with them, so they can go to the pool directly
+    if (m_pool && m_pool->release(DxvkImagePool::getKey(m_info, m_memFlags), m_image))
+      return;
+
     // This is a bit of a hack to determine whether
     // the image is implementation-handled or not
     if ((m_image.memory.memory())
      || (m_info.flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT))
-      m_vkd->vkDestroyImage(m_vkd->device(), m_image.image, nullptr);
+      m_device->reclaimer().destroyImage(m_image.image);
   }
 
 
@@ -227,6 +280,93 @@ namespace dxvk {
   }
 
 
+  bool DxvkImage::canCompressImage() const {
+    // Fixed-rate compression is lossy, so only use it on request
+    return m_device->config().enableFixedRateCompression
+        && m_device->features().extImageCompressionControl.imageCompressionControl
+        && m_info.tiling == VK_IMAGE_TILING_OPTIMAL
+        && m_info.sharing.mode == DxvkSharedHandleMode::None
+        && !(m_info.flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT);
+  }
+
+
+  void DxvkImage::queryCompression() {
+    if (m_info.compression == VK_IMAGE_COMPRESSION_DEFAULT_EXT)
+      return;
+
+    // The driver may ignore the request, so ask whether
+    // the first aspect actually ended up being compressed
+    VkImageAspectFlags aspects = formatInfo()->aspectMask;
+
+    VkImageSubresource2EXT subresource = { VK_STRUCTURE_TYPE_IMAGE_SUBRESOURCE_2_EXT };
+    subresource.imageSubresource.aspectMask = aspects & -aspects;
+
+    VkImageCompressionPropertiesEXT compression = { VK_STRUCTURE_TYPE_IMAGE_COMPRESSION_PROPERTIES_EXT };
+    VkSubresourceLayout2EXT layout = { VK_STRUCTURE_TYPE_SUBRESOURCE_LAYOUT_2_EXT, &compression };
+
+    m_vkd->vkGetImageSubresourceLayout2EXT(m_vkd->device(),
+      m_image.image, &subresource, &layout);
+
+    m_compressed = compression.imageCompressionFixedRateFlags != 0;
+
+    if (m_compressed)
+      m_device->trackCompressedImages(1);
+  }
+
+
+  Rc<DxvkImageView> DxvkImage::createView(
+    const DxvkImageViewCreateInfo& info) {
+    std::lock_guard lock(m_viewMutex);
+
+    // The cache does not own any references. Views that are
+    // currently being destroyed will fail to acquire a new
+    // reference and remove themselves from the cache later.
+    for (size_t i = 0; i < m_viewCache.size(); i++) {
+      DxvkImageView* view = m_viewCache[i];
+
+      if (view->m_info.eq(info) && view->tryIncRef()) {
+        Rc<DxvkImageView> result = view;
+        view->decRef();
+        return result;
+      }
+    }
+
+    Rc<DxvkImageView> view = new DxvkImageView(m_vkd, this, info);
+    m_viewCache.push_back(view.ptr());
+    return view;
+  }
+
+
+  void DxvkImage::removeView(
+          DxvkImageView*        view) {
+    std::lock_guard lock(m_viewMutex);
+
+    for (size_t i = 0; i < m_viewCache.size(); i++) {
+      if (m_viewCache[i] == view) {
+        m_viewCache[i] = m_viewCache[m_viewCache.size() - 1];
+        m_viewCache.pop_back();
+        return;
+      }
+    }
+  }
+
+
+  bool DxvkImageViewCreateInfo::eq(const DxvkImageViewCreateInfo& other) const {
+    return type       == other.type
+        && format     == other.format
+        && usage      == other.usage
+        && aspect     == other.aspect
+        && minLevel   == other.minLevel
+        && numLevels  == other.numLevels
+        && minLayer   == other.minLayer
+        && numLayers  == other.numLayers
+        && swizzle.r  == other.swizzle.r
+        && swizzle.g  == other.swizzle.g
+        && swizzle.b  == other.swizzle.b
+        && swizzle.a  == other.swizzle.a;
+  }
+
+
   DxvkImageView::DxvkImageView(
     const Rc<vk::DeviceFn>&         vkd,
     const Rc<DxvkImage>&            image,
@@ -277,8 +417,10 @@ namespace dxvk {
   
   
   DxvkImageView::~DxvkImageView() {
+    m_image->removeView(this);
+
     for (uint32_t i = 0; i < ViewCount; i++)
-      m_vkd->vkDestroyImageView(m_vkd->device(), m_views[i], nullptr);
+      m_image->m_device->reclaimer().destroyImageView(m_views[i]);
   }
 
   
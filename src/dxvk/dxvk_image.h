@@ -69,6 +69,10 @@ namespace dxvk {
 
     // Shared handle info
     DxvkSharedHandleInfo sharing;
+
+    // Compression hint. Only honoured if fixed-rate
+    // compression is enabled and supported.
+    VkImageCompressionFlagsEXT compression = VK_IMAGE_COMPRESSION_DEFAULT_EXT;
   };
   
   
@@ -103,6 +107,8 @@ namespace dxvk {
       VK_COMPONENT_SWIZZLE_IDENTITY,
       VK_COMPONENT_SWIZZLE_IDENTITY,
     };
+
+    bool eq(const DxvkImageViewCreateInfo& other) const;
   };
 
 
@@ -115,6 +121,46 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Packed depth-stencil copy
+   *
+   * Describes a previous pack operation from a depth-stencil
+   * image into a buffer, along with the write sequence numbers
+   * of both resources at the time. If neither resource has been
+   * written since, the pack operation does not need to be
+   * executed again.
+   */
+  struct DxvkImagePackedCopy {
+    uint64_t                  bufferCookie;
+    VkBuffer                  bufferHandle;
+    VkDeviceSize              bufferOffset;
+    uint64_t                  bufferWriteSequence;
+    uint64_t                  imageWriteSequence;
+    VkImageSubresourceLayers  subresource;
+    VkOffset2D                srcOffset;
+    VkExtent2D                srcExtent;
+    VkOffset2D                dstOffset;
+    VkExtent2D                dstExtent;
+    VkFormat                  format;
+
+    bool eq(const DxvkImagePackedCopy& other) const {
+      return bufferCookie        == other.bufferCookie
+          && bufferHandle        == other.bufferHandle
+          && bufferOffset        == other.bufferOffset
+          && bufferWriteSequence == other.bufferWriteSequence
+          && imageWriteSequence  == other.imageWriteSequence
+          && subresource         == other.subresource
+          && srcOffset           == other.srcOffset
+          && srcExtent           == other.srcExtent
+          && dstOffset           == other.dstOffset
+          && dstExtent           == other.dstExtent
+          && format              == other.format;
+    }
+  };
+
+
+  class DxvkImagePool;
+
   /**
    * \brief DXVK image
    * 
@@ -185,6 +231,14 @@ namespace dxvk {
     VkMemoryPropertyFlags memFlags() const {
       return m_memFlags;
     }
+
+    /**
+     * \brief Checks whether the image uses fixed-rate compression
+     * \returns \c true if the driver compresses the image
+     */
+    bool isCompressed() const {
+      return m_compressed;
+    }
     
     /**
      * \brief Map pointer
@@ -330,21 +384,47 @@ namespace dxvk {
      * \returns The shared handle with the type given by DxvkSharedHandleInfo::type
      */
     HANDLE sharedHandle() const;
+
+    /**
+     * \brief Creates or reuses an image view
+     *
+     * If a live view with the exact same properties already
+     * exists for this image, that view will be returned
+     * instead of creating a new one.
+     * \param [in] info Image view properties
+     * \returns Image view object
+     */
+    Rc<DxvkImageView> createView(
+      const DxvkImageViewCreateInfo& info);
     
   private:
     
     Rc<vk::DeviceFn>      m_vkd;
-    const DxvkDevice*     m_device;
+    DxvkDevice*           m_device;
     DxvkImageCreateInfo   m_info;
     VkMemoryPropertyFlags m_memFlags;
     DxvkPhysicalImage     m_image;
+    DxvkImagePool*        m_pool = nullptr;
 
-    bool m_shared = false;
+    bool m_shared     = false;
+    bool m_compressed = false;
 
     small_vector<VkFormat, 4> m_viewFormats;
+
+    dxvk::mutex               m_viewMutex;
+    small_vector<DxvkImageView*, 4> m_viewCache;
+
+    small_vector<DxvkImagePackedCopy, 4> m_packedCopies;
     
+    void removeView(
+            DxvkImageView*        view);
+
     bool canShareImage(const VkImageCreateInfo&  createInfo, const DxvkSharedHandleInfo& sharingInfo) const;
 
+    bool canCompressImage() const;
+
+    void queryCompression();
+
   };
   
   
@@ -560,5 +640,21 @@ namespace dxvk {
     void createView(VkImageViewType type, uint32_t numLayers);
     
   };
+
+
+  /**
+   * \brief Image copy region
+   *
+   * Describes one copy into a destination image
+   * when multiple copies are batched together.
+   */
+  struct DxvkImageCopyRegion {
+    Rc<DxvkImage>             srcImage;
+    VkImageSubresourceLayers  srcSubresource;
+    VkOffset3D                srcOffset;
+    VkImageSubresourceLayers  dstSubresource;
+    VkOffset3D                dstOffset;
+    VkExtent3D                extent;
+  };
   
 }
@@ -0,0 +1,162 @@
+#include "dxvk_device.h"
+#include "dxvk_image_pool.h"
+
+namespace dxvk {
+
+  /// Time after which unused pooled images are destroyed
+  constexpr auto ImagePoolGracePeriod = std::chrono::seconds(5);
+
+
+  bool DxvkImagePoolKey::eq(const DxvkImagePoolKey& other) const {
+    return type           == other.type
+        && format         == other.format
+        && flags          == other.flags
+        && sampleCount    == other.sampleCount
+        && extent.width   == other.extent.width
+        && extent.height  == other.extent.height
+        && extent.depth   == other.extent.depth
+        && numLayers      == other.numLayers
+        && mipLevels      == other.mipLevels
+        && usage          == other.usage
+        && access         == other.access
+        && memFlags       == other.memFlags
+        && compression    == other.compression
+        && viewFormats    == other.viewFormats;
+  }
+
+
+  DxvkImagePool::DxvkImagePool(
+          DxvkDevice*           device)
+  : m_device  (device),
+    m_maxSize (VkDeviceSize(device->config().imagePoolSize) << 20) {
+
+  }
+
+
+  DxvkImagePool::~DxvkImagePool() {
+    for (auto& entry : m_entries)
+      destroyImage(entry.image);
+  }
+
+
+  bool DxvkImagePool::canPoolImage(
+    const DxvkImageCreateInfo&  info,
+          VkMemoryPropertyFlags memFlags) {
+    // Image contents must be undefined on creation, and the
+    // image must not be visible to anything outside of DXVK
+    return info.tiling == VK_IMAGE_TILING_OPTIMAL
+        && info.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED
+        && info.sharing.mode == DxvkSharedHandleMode::None
+        && !(info.flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT)
+        && !(memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+  }
+
+
+  DxvkImagePoolKey DxvkImagePool::getKey(
+    const DxvkImageCreateInfo&  info,
+          VkMemoryPropertyFlags memFlags) {
+    DxvkImagePoolKey key;
+    key.type        = info.type;
+    key.format      = info.format;
+    key.flags       = info.flags;
+    key.sampleCount = info.sampleCount;
+    key.extent      = info.extent;
+    key.numLayers   = info.numLayers;
+    key.mipLevels   = info.mipLevels;
+    key.usage       = info.usage;
+    key.access      = info.access;
+    key.memFlags    = memFlags;
+    key.compression = info.compression;
+    key.viewFormats.assign(info.viewFormats,
+      info.viewFormats + info.viewFormatCount);
+    return key;
+  }
+
+
+  bool DxvkImagePool::acquire(
+    const DxvkImagePoolKey&     key,
+          DxvkPhysicalImage&    image) {
+    std::lock_guard lock(m_mutex);
+
+    // Prefer the most recently released image
+    for (size_t i = m_entries.size(); i; i--) {
+      Entry& entry = m_entries[i - 1];
+
+      if (entry.key.eq(key)) {
+        m_size -= entry.image.memory.length();
+
+        image.image  = entry.image.image;
+        image.memory = std::move(entry.image.memory);
+
+        m_entries.erase(m_entries.begin() + (i - 1));
+        m_device->addStatCtr(DxvkStatCounter::ImagePoolHits, 1);
+        return true;
+      }
+    }
+
+    m_device->addStatCtr(DxvkStatCounter::ImagePoolMisses, 1);
+    return false;
+  }
+
+
+  bool DxvkImagePool::release(
+    const DxvkImagePoolKey&     key,
+          DxvkPhysicalImage&    image) {
+    VkDeviceSize size = image.memory.length();
+
+    if (size > m_maxSize)
+      return false;
+
+    std::lock_guard lock(m_mutex);
+
+    // Make room by destroying the oldest images first
+    size_t evictCount = 0;
+
+    while (m_size + size > m_maxSize) {
+      m_size -= m_entries[evictCount].image.memory.length();
+      destroyImage(m_entries[evictCount++].image);
+    }
+
+    m_entries.erase(m_entries.begin(), m_entries.begin() + evictCount);
+
+    Entry& entry = m_entries.emplace_back();
+    entry.key = key;
+    entry.image.image  = std::exchange(image.image, VK_NULL_HANDLE);
+    entry.image.memory = std::move(image.memory);
+    entry.releaseTime = high_resolution_clock::now();
+
+    m_size += size;
+    return true;
+  }
+
+
+  void DxvkImagePool::trim() {
+    if (!isEnabled())
+      return;
+
+    auto now = high_resolution_clock::now();
+
+    std::lock_guard lock(m_mutex);
+
+    // Entries are stored in release order
+    size_t evictCount = 0;
+
+    while (evictCount < m_entries.size()
+        && now - m_entries[evictCount].releaseTime > ImagePoolGracePeriod) {
+      m_size -= m_entries[evictCount].image.memory.length();
+      destroyImage(m_entries[evictCount++].image);
+    }
+
+    m_entries.erase(m_entries.begin(), m_entries.begin() + evictCount);
+  }
+
+
+  void DxvkImagePool::destroyImage(
+          DxvkPhysicalImage&    image) {
+    m_device->reclaimer().destroyImage(image.image);
+
+    image.image  = VK_NULL_HANDLE;
+    image.memory = DxvkMemory();
+  }
+
+}
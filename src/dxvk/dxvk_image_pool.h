@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_time.h"
+
+#include "dxvk_image.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+
+  /**
+   * \brief Image pool key
+   *
+   * Stores all image properties that affect how the
+   * Vulkan image is created and what kind of memory
+   * it is bound to.
+   */
+  struct DxvkImagePoolKey {
+    VkImageType           type        = VK_IMAGE_TYPE_2D;
+    VkFormat              format      = VK_FORMAT_UNDEFINED;
+    VkImageCreateFlags    flags       = 0;
+    VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
+    VkExtent3D            extent      = { };
+    uint32_t              numLayers   = 0;
+    uint32_t              mipLevels   = 0;
+    VkImageUsageFlags     usage       = 0;
+    VkAccessFlags         access      = 0;
+    VkMemoryPropertyFlags memFlags    = 0;
+    VkImageCompressionFlagsEXT compression = VK_IMAGE_COMPRESSION_DEFAULT_EXT;
+    std::vector<VkFormat> viewFormats;
+
+    bool eq(const DxvkImagePoolKey& other) const;
+  };
+
+
+  /**
+   * \brief Image pool
+   *
+   * Keeps the Vulkan image and memory of recently destroyed
+   * images alive for a short amount of time, so that engines
+   * which create and destroy identical images over and over
+   * can reuse them without creating new Vulkan objects. Only
+   * images whose contents are undefined on creation can be
+   * pooled, i.e. optimal-tiling device images without sharing
+   * or sparse residency. The total size of pooled images is
+   * capped, with the oldest images being destroyed first.
+   */
+  class DxvkImagePool {
+
+  public:
+
+    DxvkImagePool(
+            DxvkDevice*           device);
+
+    ~DxvkImagePool();
+
+    /**
+     * \brief Checks whether the pool is enabled
+     * \returns \c true if images can be pooled
+     */
+    bool isEnabled() const {
+      return m_maxSize != 0;
+    }
+
+    /**
+     * \brief Checks whether an image can be pooled
+     *
+     * \param [in] info Image create info
+     * \param [in] memFlags Memory property flags
+     * \returns \c true if the image is eligible
+     */
+    static bool canPoolImage(
+      const DxvkImageCreateInfo&  info,
+            VkMemoryPropertyFlags memFlags);
+
+    /**
+     * \brief Computes pool key for an image
+     *
+     * \param [in] info Image create info
+     * \param [in] memFlags Memory property flags
+     * \returns Pool key
+     */
+    static DxvkImagePoolKey getKey(
+      const DxvkImageCreateInfo&  info,
+            VkMemoryPropertyFlags memFlags);
+
+    /**
+     * \brief Takes a matching image from the pool
+     *
+     * \param [in] key Pool key
+     * \param [out] image Image and memory
+     * \returns \c true if a matching image was found
+     */
+    bool acquire(
+      const DxvkImagePoolKey&     key,
+            DxvkPhysicalImage&    image);
+
+    /**
+     * \brief Returns an image to the pool
+     *
+     * The image must not be in use by the GPU. If the image
+     * is too large to fit into the pool, the pool does not
+     * take ownership and the caller must destroy the image.
+     * \param [in] key Pool key
+     * \param [in] image Image and memory
+     * \returns \c true if the image was added to the pool
+     */
+    bool release(
+      const DxvkImagePoolKey&     key,
+            DxvkPhysicalImage&    image);
+
+    /**
+     * \brief Destroys images that have not been reused
+     *
+     * Called once per frame, destroys all images that
+     * have been in the pool for longer than the grace
+     * period.
+     */
+    void trim();
+
+  private:
+
+    struct Entry {
+      DxvkImagePoolKey                  key;
+      DxvkPhysicalImage                 image;
+      high_resolution_clock::time_point releaseTime;
+    };
+
+    DxvkDevice*           m_device;
+
+    VkDeviceSize          m_maxSize = 0;
+    VkDeviceSize          m_size    = 0;
+
+    dxvk::mutex           m_mutex;
+    std::vector<Entry>    m_entries;
+
+    void destroyImage(
+            DxvkPhysicalImage&    image);
+
+  };
+
+}
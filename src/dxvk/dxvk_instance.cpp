@@ -5,6 +5,8 @@
 #include "dxvk_openxr.h"
 #include "dxvk_platform_exts.h"
 
+#include "../util/util_time.h"
+
 #include <algorithm>
 #include <sstream>
 
@@ -17,6 +19,8 @@ namespace dxvk {
 
 
   DxvkInstance::DxvkInstance(const DxvkInstanceImportInfo& args) {
+    auto t0 = high_resolution_clock::now();
+
     Logger::info(str::format("Game: ", env::getExeName()));
     Logger::info(str::format("DXVK: ", DXVK_VERSION));
 
@@ -47,7 +51,15 @@ namespace dxvk {
       provider->initInstanceExtensions();
 
     createInstanceLoader(args);
+
+    auto t1 = high_resolution_clock::now();
     m_adapters = this->queryAdapters();
+    auto t2 = high_resolution_clock::now();
+
+    Logger::info(str::format("Startup: Created instance in ",
+      std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count(), " ms, enumerated ",
+      m_adapters.size(), " adapters in ",
+      std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count(), " ms"));
 
     for (const auto& provider : m_extProviders)
       provider->initDeviceExtensions(this);
@@ -0,0 +1,124 @@
+#include <algorithm>
+
+#include "dxvk_latency.h"
+
+namespace dxvk {
+
+  /// Minimum amount of time by which the next frame's final
+  /// submission should precede the predicted GPU completion
+  /// time, in order to compensate for the CS thread and for
+  /// prediction errors without letting the GPU run idle.
+  constexpr std::chrono::microseconds LatencySleepMargin = std::chrono::microseconds(500);
+
+
+  DxvkLatencyTracker::DxvkLatencyTracker(
+          uint64_t              frameId)
+  : m_fence(frameId) {
+
+  }
+
+
+  DxvkLatencyTracker::~DxvkLatencyTracker() {
+
+  }
+
+
+  void DxvkLatencyTracker::signal(uint64_t value) {
+    auto t = high_resolution_clock::now();
+
+    { std::lock_guard lock(m_mutex);
+
+      Frame& prev = getFrame(value - 1);
+      Frame& curr = getFrame(value);
+      curr.gpuEnd = t;
+
+      // The GPU cannot start working on a frame before the
+      // application started recording it, or before it has
+      // finished the previous frame. If it is busy all the
+      // time, this measures the actual GPU frame time.
+      if (curr.cpuBegin != TimePoint()) {
+        TimePoint gpuBegin = std::max(prev.gpuEnd, curr.cpuBegin);
+
+        if (t > gpuBegin) {
+          m_gpuTime = updateEstimate(m_gpuTime,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t - gpuBegin));
+        }
+      }
+    }
+
+    m_fence.signal(value);
+  }
+
+
+  void DxvkLatencyTracker::notifyCpuPresent(
+          uint64_t              frameId) {
+    auto t = high_resolution_clock::now();
+
+    std::lock_guard lock(m_mutex);
+
+    Frame& curr = getFrame(frameId);
+    curr.cpuPresent = t;
+    curr.gpuEnd = TimePoint();
+
+    if (curr.cpuBegin != TimePoint() && t > curr.cpuBegin) {
+      m_cpuTime = updateEstimate(m_cpuTime,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t - curr.cpuBegin));
+    }
+  }
+
+
+  void DxvkLatencyTracker::sleepAndBeginFrame(
+          uint64_t              frameId) {
+    // Never have more than one frame queued up, since
+    // any queued frame adds a full frame of latency.
+    m_fence.wait(frameId - 1);
+
+    auto t0 = high_resolution_clock::now();
+    auto t1 = t0;
+
+    { std::lock_guard lock(m_mutex);
+
+      const Frame& prev = getFrame(frameId - 1);
+      const Frame& curr = getFrame(frameId);
+
+      if (m_fence.value() < frameId
+       && m_gpuTime.count() && m_cpuTime.count()
+       && curr.cpuBegin != TimePoint()) {
+        // Predict when the GPU will be done with the current frame,
+        // and start the next frame so that the application finishes
+        // recording it right before that point. The margin scales
+        // with the GPU frame time to account for frame time jitter.
+        TimePoint gpuEnd = std::max(prev.gpuEnd, curr.cpuBegin) + m_gpuTime;
+
+        auto margin = std::max<std::chrono::nanoseconds>(LatencySleepMargin, m_gpuTime / 16);
+        auto sleep = std::min(m_gpuTime, std::chrono::duration_cast<std::chrono::nanoseconds>(
+          gpuEnd - t0 - m_cpuTime - margin));
+
+        if (sleep.count() > 0)
+          t1 = t0 + sleep;
+      }
+    }
+
+    if (t1 > t0)
+      t0 = Sleep::sleepUntil(t0, t1);
+
+    std::lock_guard lock(m_mutex);
+
+    Frame& next = getFrame(frameId + 1);
+    next = Frame();
+    next.cpuBegin = t0;
+  }
+
+
+  std::chrono::nanoseconds DxvkLatencyTracker::updateEstimate(
+          std::chrono::nanoseconds  estimate,
+          std::chrono::nanoseconds  sample) {
+    // Exponential moving average, so that the estimate
+    // adapts quickly without reacting to single spikes
+    if (!estimate.count())
+      return sample;
+
+    return (estimate * 7 + sample) / 8;
+  }
+
+}
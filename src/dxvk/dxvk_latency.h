@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "../util/thread.h"
+#include "../util/util_sleep.h"
+#include "../util/util_time.h"
+
+#include "../util/sync/sync_signal.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Latency tracker
+   *
+   * Reduces input latency in GPU-bound scenarios by delaying
+   * the start of the application's next frame, so that its
+   * final submission arrives just in time for the GPU to pick
+   * it up after finishing the previous frame, rather than
+   * having the CPU run ahead and queue up work.
+   *
+   * Implements the signal interface so that it can be signaled
+   * from a context. The submission queue signals it once all
+   * commands of a frame have completed on the GPU, which is
+   * when the completion time for that frame gets recorded.
+   */
+  class DxvkLatencyTracker : public sync::Signal {
+    constexpr static size_t FrameCount = 8;
+  public:
+
+    using TimePoint = high_resolution_clock::time_point;
+
+    explicit DxvkLatencyTracker(
+            uint64_t              frameId);
+
+    ~DxvkLatencyTracker();
+
+    uint64_t value() const {
+      return m_fence.value();
+    }
+
+    void signal(uint64_t value);
+
+    void wait(uint64_t value) {
+      m_fence.wait(value);
+    }
+
+    /**
+     * \brief Notifies the tracker of a present call
+     *
+     * Must be called when the application calls \c Present,
+     * before any waits, in order to measure the CPU time the
+     * application needed to record the frame.
+     * \param [in] frameId Frame ID of the frame being presented
+     */
+    void notifyCpuPresent(
+            uint64_t              frameId);
+
+    /**
+     * \brief Delays the start of the next frame
+     *
+     * Waits for the GPU to finish the previous frame, and then
+     * sleeps as long as the GPU is predicted to be busy with the
+     * current one, minus the CPU time that the application needs
+     * to record the next frame. Must be called at the end of
+     * \c Present, after the regular frame latency wait.
+     * \param [in] frameId Frame ID of the frame that was presented
+     */
+    void sleepAndBeginFrame(
+            uint64_t              frameId);
+
+  private:
+
+    struct Frame {
+      TimePoint cpuBegin    = TimePoint();
+      TimePoint cpuPresent  = TimePoint();
+      TimePoint gpuEnd      = TimePoint();
+    };
+
+    sync::Fence               m_fence;
+
+    dxvk::mutex               m_mutex;
+    std::array<Frame, FrameCount> m_frames = { };
+
+    std::chrono::nanoseconds  m_cpuTime = std::chrono::nanoseconds(0);
+    std::chrono::nanoseconds  m_gpuTime = std::chrono::nanoseconds(0);
+
+    Frame& getFrame(uint64_t frameId) {
+      return m_frames[frameId % FrameCount];
+    }
+
+    static std::chrono::nanoseconds updateEstimate(
+            std::chrono::nanoseconds  estimate,
+            std::chrono::nanoseconds  sample);
+
+  };
+
+}
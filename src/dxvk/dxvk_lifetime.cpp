@@ -2,7 +2,12 @@
 
 namespace dxvk {
   
-  DxvkLifetimeTracker:: DxvkLifetimeTracker() { }
+  std::atomic<uint64_t> DxvkLifetimeTracker::s_trackerId = { 0ull };
+
+
+  DxvkLifetimeTracker:: DxvkLifetimeTracker()
+  : m_trackerId(++s_trackerId) { }
+
   DxvkLifetimeTracker::~DxvkLifetimeTracker() { }
   
   
@@ -13,6 +18,10 @@ namespace dxvk {
 
   void DxvkLifetimeTracker::reset() {
     m_resources.clear();
+
+    // Use a new ID so that resources tracked
+    // previously will get tracked again
+    m_trackerId = ++s_trackerId;
   }
   
 }
\ No newline at end of file
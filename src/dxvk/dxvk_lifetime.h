@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "dxvk_resource.h"
@@ -101,7 +102,30 @@ namespace dxvk {
      */
     template<DxvkAccess Access>
     void trackResource(DxvkResource* rc) {
-      m_resources.emplace_back(rc, Access);
+      if (rc->markTracked(m_trackerId, Access))
+        m_resources.emplace_back(rc, Access);
+    }
+
+    /**
+     * \brief Checks whether a resource was tracked in the current scope
+     *
+     * \param [in] rc The resource to check
+     * \returns \c true if the resource has been tracked since
+     *    the tracker was reset or the current scope began.
+     */
+    bool isTrackedInScope(const DxvkResource* rc) const {
+      return rc->isTracked(m_trackerId);
+    }
+
+    /**
+     * \brief Begins a new tracking scope
+     *
+     * Assigns a new ID to the tracker, so that resources used
+     * from now on can be told apart from ones used earlier.
+     * Resources used in both scopes will get tracked twice.
+     */
+    void beginScope() {
+      m_trackerId = ++s_trackerId;
     }
 
     /**
@@ -122,6 +146,9 @@ namespace dxvk {
   private:
     
     std::vector<DxvkLifetime> m_resources;
+    uint64_t                  m_trackerId;
+
+    static std::atomic<uint64_t> s_trackerId;
     
   };
   
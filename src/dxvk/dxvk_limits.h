@@ -15,6 +15,7 @@ namespace dxvk {
     MaxNumQueuedCommandBuffers  =    32,
     MaxNumQueryCountPerPool     =   128,
     MaxNumSpecConstants         =    12,
+    MaxNumDynamicUniformBuffers =    16,
     MaxUniformBufferSize        = 65536,
     MaxVertexBindingStride      =  2048,
     MaxPushConstantSize         =   128,
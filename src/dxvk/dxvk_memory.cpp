@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <sstream>
 
@@ -32,7 +33,8 @@ namespace dxvk {
     m_memory  (std::exchange(other.m_memory, VkDeviceMemory(VK_NULL_HANDLE))),
     m_offset  (std::exchange(other.m_offset, 0)),
     m_length  (std::exchange(other.m_length, 0)),
-    m_mapPtr  (std::exchange(other.m_mapPtr, nullptr)) { }
+    m_mapPtr  (std::exchange(other.m_mapPtr, nullptr)),
+    m_category(other.m_category) { }
   
   
   DxvkMemory& DxvkMemory::operator = (DxvkMemory&& other) {
@@ -44,6 +46,7 @@ namespace dxvk {
     m_offset  = std::exchange(other.m_offset, 0);
     m_length  = std::exchange(other.m_length, 0);
     m_mapPtr  = std::exchange(other.m_mapPtr, nullptr);
+    m_category = other.m_category;
     return *this;
   }
   
@@ -64,13 +67,15 @@ namespace dxvk {
           DxvkMemoryType*       type,
           DxvkDeviceMemory      memory,
           DxvkMemoryFlags       hints)
-  : m_alloc(alloc), m_type(type), m_memory(memory), m_hints(hints) {
-    // Mark the entire chunk as free
-    m_freeList.push_back(FreeSlice { 0, memory.memSize });
+  : m_alloc(alloc), m_type(type), m_memory(memory), m_hints(hints),
+    m_allocator(memory.memSize) {
+    m_type->heap->stats.freeBlockCount += m_allocator.freeBlockCount();
   }
   
   
   DxvkMemoryChunk::~DxvkMemoryChunk() {
+    m_type->heap->stats.freeBlockCount -= m_allocator.freeBlockCount();
+
     // This call is technically not thread-safe, but it
     // doesn't need to be since we don't free chunks
     m_alloc->freeDeviceMemory(m_type, m_memory);
@@ -88,77 +93,51 @@ namespace dxvk {
       return DxvkMemory();
     
     // If the chunk is full, return
-    if (m_freeList.size() == 0)
+    if (m_allocator.isFull())
       return DxvkMemory();
-    
-    // Select the slice to allocate from in a worst-fit
-    // manner. This may help keep fragmentation low.
-    auto bestSlice = m_freeList.begin();
-    
-    for (auto slice = m_freeList.begin(); slice != m_freeList.end(); slice++) {
-      if (slice->length == size) {
-        bestSlice = slice;
-        break;
-      } else if (slice->length > bestSlice->length) {
-        bestSlice = slice;
-      }
-    }
-    
-    // We need to align the allocation to the requested alignment
-    const VkDeviceSize sliceStart = bestSlice->offset;
-    const VkDeviceSize sliceEnd   = bestSlice->offset + bestSlice->length;
-    
-    const VkDeviceSize allocStart = dxvk::align(sliceStart,        align);
-    const VkDeviceSize allocEnd   = dxvk::align(allocStart + size, align);
-    
-    if (allocEnd > sliceEnd)
+
+    uint32_t freeBlockCount = m_allocator.freeBlockCount();
+
+    VkDeviceSize allocSize = 0;
+    VkDeviceSize allocOffset = m_allocator.alloc(size, align, allocSize);
+
+    if (allocOffset == TlsfAllocator::InvalidOffset)
       return DxvkMemory();
-    
-    // We can use this slice, but we'll have to add
-    // the unused parts of it back to the free list.
-    m_freeList.erase(bestSlice);
-    
-    if (allocStart != sliceStart)
-      m_freeList.push_back({ sliceStart, allocStart - sliceStart });
-    
-    if (allocEnd != sliceEnd)
-      m_freeList.push_back({ allocEnd, sliceEnd - allocEnd });
+
+    m_type->heap->stats.freeBlockCount += m_allocator.freeBlockCount() - freeBlockCount;
+
+    if (m_unused) {
+      m_alloc->setMemoryPriority(m_memory, m_memory.priority);
+      m_unused = false;
+    }
     
     // Create the memory object with the aligned slice
     return DxvkMemory(m_alloc, this, m_type,
-      m_memory.memHandle, allocStart, allocEnd - allocStart,
-      reinterpret_cast<char*>(m_memory.memPointer) + allocStart);
+      m_memory.memHandle, allocOffset, allocSize,
+      reinterpret_cast<char*>(m_memory.memPointer) + allocOffset);
   }
   
   
   void DxvkMemoryChunk::free(
           VkDeviceSize  offset,
           VkDeviceSize  length) {
-    // Remove adjacent entries from the free list and then add
-    // a new slice that covers all those entries. Without doing
-    // so, the slice could not be reused for larger allocations.
-    auto curr = m_freeList.begin();
-    
-    while (curr != m_freeList.end()) {
-      if (curr->offset == offset + length) {
-        length += curr->length;
-        curr = m_freeList.erase(curr);
-      } else if (curr->offset + curr->length == offset) {
-        offset -= curr->length;
-        length += curr->length;
-        curr = m_freeList.erase(curr);
-      } else {
-        curr++;
-      }
-    }
-    
-    m_freeList.push_back({ offset, length });
+    uint32_t freeBlockCount = m_allocator.freeBlockCount();
+    m_allocator.free(offset);
+
+    m_type->heap->stats.freeBlockCount += m_allocator.freeBlockCount() - freeBlockCount;
   }
   
   
   bool DxvkMemoryChunk::isEmpty() const {
-    return m_freeList.size() == 1
-        && m_freeList[0].length == m_memory.memSize;
+    return m_allocator.isEmpty();
+  }
+
+
+  void DxvkMemoryChunk::markUnused() {
+    if (!m_unused) {
+      m_alloc->setMemoryPriority(m_memory, 0.0f);
+      m_unused = true;
+    }
   }
 
 
@@ -177,6 +156,10 @@ namespace dxvk {
     if (hints.test(DxvkMemoryFlag::IgnoreConstraints))
       mask = DxvkMemoryFlags();
 
+    // Device address support is a hard requirement, and there
+    // is no point in wasting address-capable memory either
+    mask.set(DxvkMemoryFlag::DeviceAddress);
+
     return (m_hints & mask) == (hints & mask);
   }
 
@@ -200,11 +183,26 @@ namespace dxvk {
 
     if (device->features().core.features.sparseBinding)
       m_sparseMemoryTypes = determineSparseMemoryTypes(device);
+
+    determineBarHeap();
+
+    m_reportInterval = uint32_t(std::max(device->config().memoryReportInterval, 0));
+    m_lastReport = high_resolution_clock::now();
+
+    createTraceFile(device);
   }
   
   
   DxvkMemoryAllocator::~DxvkMemoryAllocator() {
-    
+    // All resources should have been destroyed at this point,
+    // anything that is still alive was leaked by the backend.
+    bool leaked = false;
+
+    for (uint32_t i = 0; i < DxvkMemoryCategoryCount; i++)
+      leaked |= m_categoryStats.allocationCount[i] != 0;
+
+    if (leaked)
+      logCategoryStats(LogLevel::Warn, "Memory: Leaked allocations on device destruction:");
   }
   
   
@@ -212,8 +210,24 @@ namespace dxvk {
           DxvkMemoryRequirements            req,
           DxvkMemoryProperties              info,
           DxvkMemoryFlags                   hints) {
+    // Querying the budget can be slow, so don't hold the lock
+    this->updateMemoryBudget();
+
     std::lock_guard<dxvk::mutex> lock(m_mutex);
 
+    DxvkMemory result = allocMemory(req, info, hints);
+
+    if (unlikely(m_traceFile.is_open()))
+      traceAlloc(req, info, hints, result);
+
+    return result;
+  }
+
+
+  DxvkMemory DxvkMemoryAllocator::allocMemory(
+          DxvkMemoryRequirements            req,
+          DxvkMemoryProperties              info,
+          DxvkMemoryFlags                   hints) {
     // Keep small allocations together to avoid fragmenting
     // chunks for larger resources with lots of small gaps,
     // as well as resources with potentially weird lifetimes
@@ -225,7 +239,13 @@ namespace dxvk {
     // Ignore most hints for host-visible allocations since they
     // usually don't make much sense for those resources
     if (info.flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
-      hints = hints & DxvkMemoryFlag::Transient;
+      hints = hints & DxvkMemoryFlags(DxvkMemoryFlag::Transient, DxvkMemoryFlag::DeviceAddress);
+
+    // Place mappable resources in system memory if their category
+    // exceeds its share of mappable video memory, so that large
+    // streaming buffers cannot starve constant buffers.
+    if (!checkBarBudget(info.flags, req.core.memoryRequirements.size))
+      info.flags &= ~VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
     // If requested, try with a dedicated allocation first.
     if (info.dedicated.image || info.dedicated.buffer) {
@@ -269,6 +289,8 @@ namespace dxvk {
       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
       VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
 
+    VkMemoryPropertyFlags requestedFlags = info.flags;
+
     if (info.flags & optionalFlags) {
       info.flags &= ~optionalFlags;
 
@@ -278,6 +300,16 @@ namespace dxvk {
         return result;
     }
 
+    // Exceeding the budget is still better than failing the
+    // allocation, the driver may be able to page memory out.
+    info.flags = requestedFlags;
+    hints.set(DxvkMemoryFlag::IgnoreConstraints, DxvkMemoryFlag::IgnoreBudget);
+
+    DxvkMemory result = this->tryAlloc(req, info, hints);
+
+    if (result)
+      return result;
+
     // We weren't able to allocate memory for this resource form any type
     this->logMemoryError(req.core.memoryRequirements);
     this->logMemoryStats();
@@ -286,6 +318,39 @@ namespace dxvk {
   }
   
   
+  DxvkMemoryStats DxvkMemoryAllocator::getMemoryStats(uint32_t heap) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    DxvkMemoryStats result = m_memHeaps[heap].stats;
+
+    // The free block count is tracked as chunks change, and each
+    // chunk can look up its largest free range without a full walk
+    for (uint32_t i = 0; i < m_memProps.memoryTypeCount; i++) {
+      if (m_memTypes[i].heapId != heap)
+        continue;
+
+      for (const auto& chunk : m_memTypes[i].chunks)
+        result.largestFreeBlock = std::max(result.largestFreeBlock, chunk->getLargestFreeBlock());
+
+      result.chunkCount += m_memTypes[i].chunks.size();
+    }
+
+    return result;
+  }
+
+
+  DxvkBarStats DxvkMemoryAllocator::getBarStats() {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    return m_barStats;
+  }
+
+
+  DxvkMemoryCategoryStats DxvkMemoryAllocator::getCategoryStats() {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    return m_categoryStats;
+  }
+
+
   DxvkMemory DxvkMemoryAllocator::tryAlloc(
     const DxvkMemoryRequirements&           req,
     const DxvkMemoryProperties&             info,
@@ -330,15 +395,32 @@ namespace dxvk {
     bool heapBudgedExceeded = 5 * type->heap->stats.memoryUsed + size > 4 * type->heap->properties.size;
 
     if (!needsDedicatedAlocation && (!wantsDedicatedAllocation || heapBudgedExceeded)) {
-      // Attempt to suballocate from existing chunks first
-      for (uint32_t i = 0; i < type->chunks.size() && !memory; i++)
-        memory = type->chunks[i]->alloc(info.flags, size, align, hints);
+      // Attempt to suballocate from existing chunks first. Prefer the
+      // chunk with the least amount of free memory, so that sparsely
+      // used chunks can drain over time and be returned to the system.
+      DxvkMemoryChunk* bestChunk = nullptr;
+
+      for (uint32_t i = 0; i < type->chunks.size(); i++) {
+        DxvkMemoryChunk* chunk = type->chunks[i].ptr();
+
+        if (chunk->canAllocate(info.flags, size, hints)
+         && (!bestChunk || chunk->getFreeSize() < bestChunk->getFreeSize()))
+          bestChunk = chunk;
+      }
+
+      if (bestChunk)
+        memory = bestChunk->alloc(info.flags, size, align, hints);
+
+      for (uint32_t i = 0; i < type->chunks.size() && !memory; i++) {
+        if (type->chunks[i].ptr() != bestChunk)
+          memory = type->chunks[i]->alloc(info.flags, size, align, hints);
+      }
       
       // If no existing chunk can accomodate the allocation, and if a dedicated
       // allocation is not preferred, create a new chunk and suballocate from it
       if (!memory && !wantsDedicatedAllocation) {
         DxvkDeviceMemory devMem;
-        
+
         if (this->shouldFreeEmptyChunks(type->heap, chunkSize))
           this->freeEmptyChunks(type->heap);
 
@@ -369,6 +451,14 @@ namespace dxvk {
     if (memory) {
       type->heap->stats.memoryUsed += memory.m_length;
       m_device->notifyMemoryUse(type->heapId, memory.m_length);
+
+      updateBarStats(type, memory.m_length, true);
+
+      memory.m_category = info.category;
+      updateCategoryStats(type, info.category, memory.m_length, true);
+
+      if (unlikely(m_reportInterval))
+        reportMemoryStats();
     }
 
     return memory;
@@ -385,7 +475,14 @@ namespace dxvk {
     bool useMemoryPriority = (info.flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
                           && (m_device->features().extMemoryPriority.memoryPriority);
     
-    if (type->heap->budget && type->heap->stats.memoryAllocated + size > type->heap->budget)
+    // Keep device memory available for render targets and storage
+    // resources, and move everything else to slower memory types
+    // before the budget gets exceeded, since this would otherwise
+    // lead to the driver paging memory in and out to make room.
+    bool enforceBudget = (info.flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+                      && !hints.any(DxvkMemoryFlag::Small, DxvkMemoryFlag::GpuWritable, DxvkMemoryFlag::IgnoreBudget);
+
+    if (enforceBudget && type->heap->budget && type->heap->stats.memoryAllocated + size > type->heap->budget)
       return DxvkDeviceMemory();
 
     float priority = 0.0f;
@@ -403,10 +500,16 @@ namespace dxvk {
     VkMemoryPriorityAllocateInfoEXT priorityInfo = { VK_STRUCTURE_TYPE_MEMORY_PRIORITY_ALLOCATE_INFO_EXT };
     priorityInfo.priority       = priority;
 
+    VkMemoryAllocateFlagsInfo flagsInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO };
+    flagsInfo.flags             = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+
     VkMemoryAllocateInfo memoryInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
     memoryInfo.allocationSize   = size;
     memoryInfo.memoryTypeIndex  = type->memTypeId;
 
+    if (hints.test(DxvkMemoryFlag::DeviceAddress))
+      flagsInfo.pNext = std::exchange(memoryInfo.pNext, &flagsInfo);
+
     if (info.sharedExport.handleTypes)
       info.sharedExport.pNext = std::exchange(memoryInfo.pNext, &info.sharedExport);
 
@@ -441,8 +544,15 @@ namespace dxvk {
   void DxvkMemoryAllocator::free(
     const DxvkMemory&           memory) {
     std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    if (unlikely(m_traceFile.is_open()))
+      traceFree(memory);
+
     memory.m_type->heap->stats.memoryUsed -= memory.m_length;
 
+    updateBarStats(memory.m_type, memory.m_length, false);
+    updateCategoryStats(memory.m_type, memory.m_category, memory.m_length, false);
+
     if (memory.m_chunk != nullptr) {
       this->freeChunkMemory(
         memory.m_type,
@@ -476,8 +586,10 @@ namespace dxvk {
       // freed are prioritized for allocations to reduce memory pressure.
       type->chunks.erase(std::remove(type->chunks.begin(), type->chunks.end(), chunkRef));
 
-      if (!this->shouldFreeChunk(type, chunkRef))
+      if (!this->shouldFreeChunk(type, chunkRef)) {
+        chunkRef->markUnused();
         type->chunks.push_back(std::move(chunkRef));
+      }
     }
   }
   
@@ -485,8 +597,7 @@ namespace dxvk {
   void DxvkMemoryAllocator::freeDeviceMemory(
           DxvkMemoryType*       type,
           DxvkDeviceMemory      memory) {
-    auto vk = m_device->vkd();
-    vk->vkFreeMemory(vk->device(), memory.memHandle, nullptr);
+    m_device->reclaimer().freeMemory(memory.memHandle);
 
     type->heap->stats.memoryAllocated -= memory.memSize;
     m_device->notifyMemoryAlloc(type->heapId, memory.memSize);
@@ -572,6 +683,166 @@ namespace dxvk {
   }
 
 
+  void DxvkMemoryAllocator::updateMemoryBudget() {
+    if (!m_device->features().extMemoryBudget)
+      return;
+
+    // Only query the budget periodically, and make sure that
+    // only one thread does so if multiple threads get here
+    auto now = high_resolution_clock::now().time_since_epoch().count();
+    auto last = m_lastBudgetUpdate.load(std::memory_order_relaxed);
+
+    if (now - last < BudgetUpdateInterval.count()
+     || !m_lastBudgetUpdate.compare_exchange_strong(last, now, std::memory_order_relaxed))
+      return;
+
+    DxvkAdapter* adapter = m_device->adapter().ptr();
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT memBudget = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT };
+    VkPhysicalDeviceMemoryProperties2 memProps = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2, &memBudget };
+    adapter->vki()->vkGetPhysicalDeviceMemoryProperties2(adapter->handle(), &memProps);
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    for (uint32_t i = 0; i < m_memProps.memoryHeapCount; i++) {
+      DxvkMemoryHeap& heap = m_memHeaps[i];
+
+      // Memory allocated by other applications is out of our control,
+      // but never reduce the budget to the point where we'd be unable
+      // to allocate any memory at all in case the driver reports junk
+      VkDeviceSize allocated = heap.stats.memoryAllocated;
+      VkDeviceSize foreign = std::max(memBudget.heapUsage[i], allocated) - allocated;
+      VkDeviceSize minBudget = heap.properties.size / 4;
+
+      heap.budget = memBudget.heapBudget[i] > foreign + minBudget
+        ? memBudget.heapBudget[i] - foreign
+        : minBudget;
+    }
+  }
+
+
+  bool DxvkMemoryAllocator::isBarMemoryType(
+    const DxvkMemoryType*       type) const {
+    constexpr VkMemoryPropertyFlags barFlags
+      = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+      | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    return (type->memType.propertyFlags & barFlags) == barFlags;
+  }
+
+
+  bool DxvkMemoryAllocator::checkBarBudget(
+          VkMemoryPropertyFlags flags,
+          VkDeviceSize          size) const {
+    constexpr VkMemoryPropertyFlags barFlags
+      = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+      | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    if ((flags & barFlags) != barFlags || !m_barHeap)
+      return true;
+
+    uint32_t category = uint32_t(getBarCategory(size));
+
+    // Scale limits down if the driver reports a smaller budget
+    // than the heap size, e.g. because other processes use it
+    VkDeviceSize limit = m_barStats.memoryLimit[category];
+
+    if (m_barHeap->budget && m_barHeap->budget < m_barStats.heapSize)
+      limit = (limit * (m_barHeap->budget >> 20)) / (m_barStats.heapSize >> 20);
+
+    return m_barStats.memoryUsed[category] + size <= limit;
+  }
+
+
+  void DxvkMemoryAllocator::updateCategoryStats(
+    const DxvkMemoryType*       type,
+          DxvkMemoryCategory    category,
+          VkDeviceSize          size,
+          bool                  allocated) {
+    uint32_t index = uint32_t(category);
+
+    auto& used = (type->memType.propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+      ? m_categoryStats.vidmemUsed[index]
+      : m_categoryStats.sysmemUsed[index];
+
+    if (allocated) {
+      used += size;
+      m_categoryStats.allocationCount[index] += 1;
+    } else {
+      used -= size;
+      m_categoryStats.allocationCount[index] -= 1;
+    }
+  }
+
+
+  void DxvkMemoryAllocator::updateBarStats(
+    const DxvkMemoryType*       type,
+          VkDeviceSize          size,
+          bool                  allocated) {
+    if (type->heap != m_barHeap || !isBarMemoryType(type))
+      return;
+
+    uint32_t category = uint32_t(getBarCategory(size));
+
+    if (allocated)
+      m_barStats.memoryUsed[category] += size;
+    else
+      m_barStats.memoryUsed[category] -= size;
+  }
+
+
+  DxvkBarCategory DxvkMemoryAllocator::getBarCategory(
+          VkDeviceSize          size) {
+    return size <= SmallAllocationThreshold
+      ? DxvkBarCategory::Small
+      : DxvkBarCategory::Large;
+  }
+
+
+  void DxvkMemoryAllocator::determineBarHeap() {
+    // Pick the largest heap with a mappable device-local memory
+    // type. Without resizable BAR, this is a 256 MiB aperture.
+    for (uint32_t i = 0; i < m_memProps.memoryTypeCount; i++) {
+      if (!isBarMemoryType(&m_memTypes[i]))
+        continue;
+
+      if (!m_barHeap || m_barHeap->properties.size < m_memTypes[i].heap->properties.size)
+        m_barHeap = m_memTypes[i].heap;
+    }
+
+    if (!m_barHeap)
+      return;
+
+    m_barStats.heapSize  = m_barHeap->properties.size;
+    m_barStats.resizable = m_barStats.heapSize > (VkDeviceSize(256) << 20);
+
+    // Small resources benefit the most from being in video memory,
+    // so they may use the entire heap. Cap large buffers to half the
+    // aperture on small BAR systems, and to a quarter of the heap on
+    // resizable BAR systems where the heap is shared with regular
+    // device-local resources.
+    m_barStats.memoryLimit[uint32_t(DxvkBarCategory::Small)] = m_barStats.heapSize;
+    m_barStats.memoryLimit[uint32_t(DxvkBarCategory::Large)] = m_barStats.resizable
+      ? m_barStats.heapSize / 4
+      : m_barStats.heapSize / 2;
+
+    Logger::info(str::format("Memory: Mappable video memory: ", m_barStats.heapSize >> 20, " MB",
+      m_barStats.resizable ? " (resizable BAR)" : ""));
+  }
+
+
+  void DxvkMemoryAllocator::setMemoryPriority(
+    const DxvkDeviceMemory&     memory,
+          float                 priority) {
+    if (!(memory.memFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+     || !m_device->features().extPageableDeviceLocalMemory.pageableDeviceLocalMemory)
+      return;
+
+    auto vk = m_device->vkd();
+    vk->vkSetDeviceMemoryPriorityEXT(vk->device(), memory.memHandle, priority);
+  }
+
+
   uint32_t DxvkMemoryAllocator::determineSparseMemoryTypes(
           DxvkDevice*           device) const {
     auto vk = device->vkd();
@@ -698,6 +969,110 @@ namespace dxvk {
     }
 
     Logger::err(sstr.str());
+
+    logCategoryStats(LogLevel::Error, "Memory usage by category:");
+  }
+
+
+  void DxvkMemoryAllocator::logCategoryStats(
+          LogLevel              level,
+    const char*                 header) const {
+    static const std::array<const char*, DxvkMemoryCategoryCount> names = {
+      "Other", "Render targets", "Textures", "Constant buffers", "Geometry", "Staging",
+    };
+
+    std::stringstream sstr;
+    sstr << header << std::endl
+         << "Category          Vidmem (MiB)  Sysmem (MiB)  Allocations" << std::endl;
+
+    for (uint32_t i = 0; i < DxvkMemoryCategoryCount; i++) {
+      sstr << std::left << std::setw(18) << names[i] << std::right
+           << std::setw(12) << (m_categoryStats.vidmemUsed[i] >> 20) << "  "
+           << std::setw(12) << (m_categoryStats.sysmemUsed[i] >> 20) << "  "
+           << std::setw(11) << m_categoryStats.allocationCount[i] << std::endl;
+    }
+
+    // Flag heaps where we allocated more than the driver
+    // budget allows, since the driver will start paging.
+    for (uint32_t i = 0; i < m_memProps.memoryHeapCount; i++) {
+      if (m_memHeaps[i].budget && m_memHeaps[i].stats.memoryAllocated > m_memHeaps[i].budget) {
+        sstr << "Heap " << i << " overcommitted: "
+             << (m_memHeaps[i].stats.memoryAllocated >> 20) << " MiB allocated, "
+             << (m_memHeaps[i].budget >> 20) << " MiB budget" << std::endl;
+      }
+    }
+
+    Logger::log(level, sstr.str());
+  }
+
+
+  void DxvkMemoryAllocator::reportMemoryStats() {
+    auto now = high_resolution_clock::now();
+
+    if (now - m_lastReport < std::chrono::seconds(m_reportInterval))
+      return;
+
+    m_lastReport = now;
+    logCategoryStats(LogLevel::Info, "Memory: Usage snapshot:");
+  }
+
+
+  void DxvkMemoryAllocator::createTraceFile(DxvkDevice* device) {
+    std::string path = env::getEnvVar("DXVK_MEMORY_TRACE_PATH");
+
+    if (path.empty())
+      path = device->config().memoryTracePath;
+
+    if (path.empty())
+      return;
+
+    env::createDirectory(path);
+
+    // Applications may create more than one device, so
+    // give each allocator its own file within the process.
+    static std::atomic<uint32_t> s_traceIndex = { 0u };
+    uint32_t index = s_traceIndex++;
+
+    std::string fileName = str::format(path, "/", env::getExeBaseName(),
+      "_memory", index ? str::format("_", index) : std::string(), ".trace");
+
+    m_traceFile.open(str::topath(fileName.c_str()).c_str(),
+      std::ios_base::binary | std::ios_base::trunc);
+
+    if (!m_traceFile) {
+      Logger::err(str::format("Memory: Failed to create trace file ", fileName));
+      return;
+    }
+
+    Logger::info(str::format("Memory: Writing allocation trace to ", fileName));
+    m_traceFile << "# dxvk memory trace v1" << std::endl;
+  }
+
+
+  void DxvkMemoryAllocator::traceAlloc(
+    const DxvkMemoryRequirements& req,
+    const DxvkMemoryProperties& info,
+          DxvkMemoryFlags       hints,
+    const DxvkMemory&           memory) {
+    // One line per allocation, in the order of the arguments that
+    // were passed in, so that the trace can be replayed as-is.
+    // Allocations are identified by memory handle and offset.
+    m_traceFile << "a " << memory.m_memory << ":" << memory.m_offset
+      << " " << req.core.memoryRequirements.size
+      << " " << req.core.memoryRequirements.alignment
+      << " " << req.core.memoryRequirements.memoryTypeBits
+      << " " << uint32_t(req.tiling)
+      << " " << uint32_t(req.dedicated.requiresDedicatedAllocation)
+      << " " << uint32_t(info.dedicated.image || info.dedicated.buffer)
+      << " " << info.flags
+      << " " << uint32_t(info.category)
+      << " " << hints.raw() << "\n";
+  }
+
+
+  void DxvkMemoryAllocator::traceFree(
+    const DxvkMemory&           memory) {
+    m_traceFile << "f " << memory.m_memory << ":" << memory.m_offset << "\n";
   }
 
 }
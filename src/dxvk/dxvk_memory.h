@@ -1,5 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <fstream>
+
+#include "../util/util_time.h"
+#include "../util/util_tlsf.h"
+
 #include "dxvk_adapter.h"
 
 namespace dxvk {
@@ -14,8 +20,74 @@ namespace dxvk {
    * allocated and used by the application.
    */
   struct DxvkMemoryStats {
-    VkDeviceSize memoryAllocated = 0;
-    VkDeviceSize memoryUsed      = 0;
+    VkDeviceSize memoryAllocated  = 0;
+    VkDeviceSize memoryUsed       = 0;
+    VkDeviceSize largestFreeBlock = 0;
+    uint32_t     freeBlockCount   = 0;
+    uint32_t     chunkCount       = 0;
+  };
+
+
+  /**
+   * \brief Memory category
+   *
+   * Describes what kind of resource an allocation
+   * backs. Only used for memory statistics.
+   */
+  enum class DxvkMemoryCategory : uint32_t {
+    Other           = 0,  ///< Storage and other buffers
+    RenderTarget    = 1,  ///< Render targets and depth buffers
+    Texture         = 2,  ///< Sampled and storage images
+    ConstantBuffer  = 3,  ///< Uniform buffers
+    GeometryBuffer  = 4,  ///< Vertex and index buffers
+    Staging         = 5,  ///< Staging buffers and mapped images
+  };
+
+  constexpr uint32_t DxvkMemoryCategoryCount = 6;
+
+
+  /**
+   * \brief Per-category memory stats
+   *
+   * Amount of memory used by resources of each category,
+   * split by whether the memory is device-local or not.
+   */
+  struct DxvkMemoryCategoryStats {
+    std::array<VkDeviceSize, DxvkMemoryCategoryCount> vidmemUsed = { };
+    std::array<VkDeviceSize, DxvkMemoryCategoryCount> sysmemUsed = { };
+    std::array<uint32_t,     DxvkMemoryCategoryCount> allocationCount = { };
+  };
+
+
+  /**
+   * \brief Mappable video memory category
+   *
+   * Host-visible device-local memory is a limited resource
+   * unless the system supports resizable BAR, so it is
+   * budgeted separately for small resources such as
+   * constant buffers and for large streaming buffers.
+   */
+  enum class DxvkBarCategory : uint32_t {
+    Small = 0,  ///< Small allocations, i.e. constant buffers
+    Large = 1,  ///< Large dynamic and streaming buffers
+  };
+
+  constexpr uint32_t DxvkBarCategoryCount = 2;
+
+
+  /**
+   * \brief Mappable video memory stats
+   *
+   * Reports how much host-visible device-local memory
+   * is in use per category, as well as the per-category
+   * limits. If \c heapSize is zero, the device does not
+   * expose any such memory types.
+   */
+  struct DxvkBarStats {
+    VkDeviceSize heapSize   = 0;
+    bool         resizable  = false;
+    std::array<VkDeviceSize, DxvkBarCategoryCount> memoryUsed  = { };
+    std::array<VkDeviceSize, DxvkBarCategoryCount> memoryLimit = { };
   };
 
 
@@ -62,6 +134,9 @@ namespace dxvk {
    * 
    * Corresponds to a Vulkan memory heap and stores
    * its properties as well as allocation statistics.
+   * If supported, the budget is derived from the memory
+   * budget reported by the driver, minus the amount of
+   * memory allocated by other processes or devices.
    */
   struct DxvkMemoryHeap {
     VkMemoryHeap      properties;
@@ -171,6 +246,8 @@ namespace dxvk {
     VkDeviceSize          m_offset = 0;
     VkDeviceSize          m_length = 0;
     void*                 m_mapPtr = nullptr;
+
+    DxvkMemoryCategory    m_category = DxvkMemoryCategory::Other;
     
     void free();
     
@@ -189,6 +266,8 @@ namespace dxvk {
     GpuWritable       = 2,  ///< High-priority resource
     Transient         = 3,  ///< Resource is short-lived
     IgnoreConstraints = 4,  ///< Ignore most allocation flags
+    IgnoreBudget      = 5,  ///< Allow exceeding the heap budget
+    DeviceAddress     = 6,  ///< Memory must support device addresses
   };
 
   using DxvkMemoryFlags = Flags<DxvkMemoryFlag>;
@@ -199,6 +278,10 @@ namespace dxvk {
    * 
    * A single chunk of memory that provides a
    * sub-allocator. This is not thread-safe.
+   *
+   * Sub-allocation uses a TLSF allocator, so that
+   * allocating and freeing memory does not depend
+   * on the number of free ranges in the chunk.
    */
   class DxvkMemoryChunk : public RcObject {
     
@@ -254,19 +337,62 @@ namespace dxvk {
      */
     bool isCompatible(const Rc<DxvkMemoryChunk>& other) const;
 
+    /**
+     * \brief Checks whether an allocation may succeed
+     *
+     * Checks memory properties, hints and the amount of
+     * free memory. Allocation can still fail if the chunk
+     * is too fragmented to service the request.
+     * \param [in] flags Requested memory type flags
+     * \param [in] size Number of bytes to allocate
+     * \param [in] hints Memory category
+     * \returns \c true if the chunk is a candidate
+     */
+    bool canAllocate(
+            VkMemoryPropertyFlags flags,
+            VkDeviceSize          size,
+            DxvkMemoryFlags       hints) const {
+      return m_memory.memFlags == flags
+          && m_allocator.freeSize() >= size
+          && checkHints(hints);
+    }
+
+    /**
+     * \brief Queries amount of free memory
+     * \returns Number of unallocated bytes
+     */
+    VkDeviceSize getFreeSize() const {
+      return m_allocator.freeSize();
+    }
+
+    /**
+     * \brief Queries size of the largest free range
+     * \returns Largest free range, in bytes
+     */
+    VkDeviceSize getLargestFreeBlock() const {
+      return m_allocator.largestFreeBlock();
+    }
+
+    /**
+     * \brief Marks the chunk as unused
+     *
+     * Lowers the priority of the underlying memory object
+     * so that the driver can page it out first if device
+     * memory is overcommitted. The original priority is
+     * restored when memory gets allocated from the chunk.
+     */
+    void markUnused();
+
   private:
     
-    struct FreeSlice {
-      VkDeviceSize offset;
-      VkDeviceSize length;
-    };
-    
     DxvkMemoryAllocator*  m_alloc;
     DxvkMemoryType*       m_type;
     DxvkDeviceMemory      m_memory;
     DxvkMemoryFlags       m_hints;
     
-    std::vector<FreeSlice> m_freeList;
+    TlsfAllocator         m_allocator;
+
+    bool                  m_unused = false;
 
     bool checkHints(DxvkMemoryFlags hints) const;
     
@@ -291,6 +417,7 @@ namespace dxvk {
     VkImportMemoryWin32HandleInfoKHR sharedImportWin32;
     VkMemoryDedicatedAllocateInfo dedicated;
     VkMemoryPropertyFlags         flags;
+    DxvkMemoryCategory            category;
   };
 
 
@@ -305,6 +432,9 @@ namespace dxvk {
     friend class DxvkMemoryChunk;
 
     constexpr static VkDeviceSize SmallAllocationThreshold = 256 << 10;
+
+    /// Minimum time between two memory budget queries
+    constexpr static high_resolution_clock::duration BudgetUpdateInterval = std::chrono::milliseconds(100);
   public:
     
     DxvkMemoryAllocator(DxvkDevice* device);
@@ -334,14 +464,25 @@ namespace dxvk {
     /**
      * \brief Queries memory stats
      * 
-     * Returns the total amount of memory
-     * allocated and used for a given heap.
+     * Returns the total amount of memory allocated
+     * and used for a given heap, as well as info
+     * on how fragmented the heap's chunks are.
      * \param [in] heap Heap index
      * \returns Memory stats for this heap
      */
-    DxvkMemoryStats getMemoryStats(uint32_t heap) const {
-      return m_memHeaps[heap].stats;
-    }
+    DxvkMemoryStats getMemoryStats(uint32_t heap);
+
+    /**
+     * \brief Queries mappable video memory stats
+     * \returns Per-category usage and limits
+     */
+    DxvkBarStats getBarStats();
+
+    /**
+     * \brief Queries per-category memory stats
+     * \returns Memory usage by resource category
+     */
+    DxvkMemoryCategoryStats getCategoryStats();
     
   private:
 
@@ -356,6 +497,23 @@ namespace dxvk {
 
     uint32_t m_sparseMemoryTypes = 0u;
 
+    DxvkMemoryHeap*                                 m_barHeap = nullptr;
+    DxvkBarStats                                    m_barStats;
+
+    DxvkMemoryCategoryStats                         m_categoryStats;
+
+    uint32_t                                        m_reportInterval = 0u;
+    high_resolution_clock::time_point               m_lastReport;
+
+    std::atomic<high_resolution_clock::rep>         m_lastBudgetUpdate = { 0 };
+
+    std::ofstream                                   m_traceFile;
+
+    DxvkMemory allocMemory(
+            DxvkMemoryRequirements            req,
+            DxvkMemoryProperties              info,
+            DxvkMemoryFlags                   hints);
+
     DxvkMemory tryAlloc(
       const DxvkMemoryRequirements&           req,
       const DxvkMemoryProperties&             info,
@@ -402,6 +560,35 @@ namespace dxvk {
     void freeEmptyChunks(
       const DxvkMemoryHeap*       heap);
 
+    void updateMemoryBudget();
+
+    bool isBarMemoryType(
+      const DxvkMemoryType*       type) const;
+
+    bool checkBarBudget(
+            VkMemoryPropertyFlags flags,
+            VkDeviceSize          size) const;
+
+    void updateCategoryStats(
+      const DxvkMemoryType*       type,
+            DxvkMemoryCategory    category,
+            VkDeviceSize          size,
+            bool                  allocated);
+
+    void updateBarStats(
+      const DxvkMemoryType*       type,
+            VkDeviceSize          size,
+            bool                  allocated);
+
+    void determineBarHeap();
+
+    static DxvkBarCategory getBarCategory(
+            VkDeviceSize          size);
+
+    void setMemoryPriority(
+      const DxvkDeviceMemory&     memory,
+            float                 priority);
+
     uint32_t determineSparseMemoryTypes(
             DxvkDevice*           device) const;
 
@@ -413,6 +600,24 @@ namespace dxvk {
 
     void logMemoryStats() const;
 
+    void logCategoryStats(
+            LogLevel              level,
+      const char*                 header) const;
+
+    void reportMemoryStats();
+
+    void createTraceFile(
+            DxvkDevice*           device);
+
+    void traceAlloc(
+      const DxvkMemoryRequirements& req,
+      const DxvkMemoryProperties& info,
+            DxvkMemoryFlags       hints,
+      const DxvkMemory&           memory);
+
+    void traceFree(
+      const DxvkMemory&           memory);
+
   };
   
 }
@@ -1,5 +1,8 @@
+#include "dxvk_device.h"
 #include "dxvk_meta_mipgen.h"
 
+#include <dxvk_mipgen_2d.h>
+
 namespace dxvk {
 
   DxvkMetaMipGenRenderPass::DxvkMetaMipGenRenderPass(
@@ -93,5 +96,114 @@ namespace dxvk {
 
     return result;
   }
-  
+
+
+  DxvkMetaMipGenObjects::DxvkMetaMipGenObjects(const DxvkDevice* device)
+  : m_vkd         (device->vkd()),
+    m_dsetLayout  (createDescriptorSetLayout()),
+    m_pipeLayout  (createPipelineLayout()),
+    m_template    (createDescriptorUpdateTemplate()),
+    m_pipeline    (createPipeline()) {
+
+  }
+
+
+  DxvkMetaMipGenObjects::~DxvkMetaMipGenObjects() {
+    m_vkd->vkDestroyPipeline(m_vkd->device(), m_pipeline, nullptr);
+    m_vkd->vkDestroyDescriptorUpdateTemplate(m_vkd->device(), m_template, nullptr);
+    m_vkd->vkDestroyPipelineLayout(m_vkd->device(), m_pipeLayout, nullptr);
+    m_vkd->vkDestroyDescriptorSetLayout(m_vkd->device(), m_dsetLayout, nullptr);
+  }
+
+
+  VkDescriptorSetLayout DxvkMetaMipGenObjects::createDescriptorSetLayout() {
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings = {{
+      { 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,                VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+      { 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          MaxLevelsPerPass, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+    }};
+
+    VkDescriptorSetLayoutCreateInfo dsetInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    dsetInfo.bindingCount = bindings.size();
+    dsetInfo.pBindings    = bindings.data();
+
+    VkDescriptorSetLayout result = VK_NULL_HANDLE;
+    if (m_vkd->vkCreateDescriptorSetLayout(m_vkd->device(), &dsetInfo, nullptr, &result) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create descriptor set layout");
+    return result;
+  }
+
+
+  VkPipelineLayout DxvkMetaMipGenObjects::createPipelineLayout() {
+    VkPushConstantRange push = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(DxvkMetaMipGenArgs) };
+
+    VkPipelineLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layoutInfo.setLayoutCount         = 1;
+    layoutInfo.pSetLayouts            = &m_dsetLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges    = &push;
+
+    VkPipelineLayout result = VK_NULL_HANDLE;
+    if (m_vkd->vkCreatePipelineLayout(m_vkd->device(), &layoutInfo, nullptr, &result) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create pipeline layout");
+    return result;
+  }
+
+
+  VkDescriptorUpdateTemplate DxvkMetaMipGenObjects::createDescriptorUpdateTemplate() {
+    std::array<VkDescriptorUpdateTemplateEntry, 2> bindings = {{
+      { 0, 0, 1,                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, offsetof(DxvkMetaMipGenDescriptors, src), 0 },
+      { 1, 0, MaxLevelsPerPass, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          offsetof(DxvkMetaMipGenDescriptors, dst), sizeof(VkDescriptorImageInfo) },
+    }};
+
+    VkDescriptorUpdateTemplateCreateInfo templateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO };
+    templateInfo.descriptorUpdateEntryCount = bindings.size();
+    templateInfo.pDescriptorUpdateEntries   = bindings.data();
+    templateInfo.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    templateInfo.descriptorSetLayout        = m_dsetLayout;
+    templateInfo.pipelineBindPoint          = VK_PIPELINE_BIND_POINT_COMPUTE;
+    templateInfo.pipelineLayout             = m_pipeLayout;
+    templateInfo.set                        = 0;
+
+    VkDescriptorUpdateTemplate result = VK_NULL_HANDLE;
+    if (m_vkd->vkCreateDescriptorUpdateTemplate(m_vkd->device(),
+          &templateInfo, nullptr, &result) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create descriptor update template");
+    return result;
+  }
+
+
+  VkPipeline DxvkMetaMipGenObjects::createPipeline() {
+    SpirvCodeBuffer code(dxvk_mipgen_2d);
+
+    VkShaderModuleCreateInfo shaderInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    shaderInfo.codeSize = code.size();
+    shaderInfo.pCode    = code.data();
+
+    VkShaderModule module = VK_NULL_HANDLE;
+
+    if (m_vkd->vkCreateShaderModule(m_vkd->device(), &shaderInfo, nullptr, &module) != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create shader module");
+
+    VkPipelineShaderStageCreateInfo stageInfo = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    stageInfo.stage     = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module    = module;
+    stageInfo.pName     = "main";
+
+    VkComputePipelineCreateInfo pipeInfo = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipeInfo.stage      = stageInfo;
+    pipeInfo.layout     = m_pipeLayout;
+    pipeInfo.basePipelineIndex = -1;
+
+    VkPipeline result = VK_NULL_HANDLE;
+
+    VkResult status = m_vkd->vkCreateComputePipelines(
+      m_vkd->device(), VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &result);
+
+    m_vkd->vkDestroyShaderModule(m_vkd->device(), module, nullptr);
+
+    if (status != VK_SUCCESS)
+      throw DxvkError("DxvkMetaMipGenObjects: Failed to create pipeline");
+    return result;
+  }
+
 }
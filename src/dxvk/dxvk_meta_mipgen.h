@@ -145,5 +145,92 @@ namespace dxvk {
     PassViews createViews(uint32_t pass) const;
     
   };
+
+
+  /**
+   * \brief Compute mip map generation arguments
+   *
+   * Passed in as push constants
+   * to the compute shader.
+   */
+  struct DxvkMetaMipGenArgs {
+    VkExtent2D dstExtent;
+    uint32_t   levelCount;
+  };
+
+
+  /**
+   * \brief Compute mip map generation descriptors
+   */
+  struct DxvkMetaMipGenDescriptors {
+    VkDescriptorImageInfo src;
+    VkDescriptorImageInfo dst[6];
+  };
+
+
+  /**
+   * \brief Compute mip map generation pipeline
+   */
+  struct DxvkMetaMipGenPipeline {
+    VkDescriptorUpdateTemplate    dsetTemplate;
+    VkDescriptorSetLayout         dsetLayout;
+    VkPipelineLayout              pipeLayout;
+    VkPipeline                    pipeHandle;
+  };
+
+
+  /**
+   * \brief Compute mip map generation objects
+   *
+   * Stores the compute shader that generates multiple
+   * mip levels of a 2D image in one dispatch. Each
+   * workgroup reads a tile of \c TileSize texels
+   * from the source level, and writes up to
+   * \c MaxLevelsPerPass levels.
+   */
+  class DxvkMetaMipGenObjects {
+
+  public:
+
+    /// Number of levels written per dispatch
+    constexpr static uint32_t MaxLevelsPerPass = 6;
+
+    /// Source tile size for each workgroup
+    constexpr static uint32_t TileSize = 64;
+
+    DxvkMetaMipGenObjects(const DxvkDevice* device);
+    ~DxvkMetaMipGenObjects();
+
+    /**
+     * \brief Retrieves mip map generation pipeline
+     * \returns Compute pipeline
+     */
+    DxvkMetaMipGenPipeline getPipeline() const {
+      DxvkMetaMipGenPipeline result;
+      result.dsetTemplate = m_template;
+      result.dsetLayout   = m_dsetLayout;
+      result.pipeLayout   = m_pipeLayout;
+      result.pipeHandle   = m_pipeline;
+      return result;
+    }
+
+  private:
+
+    Rc<vk::DeviceFn>            m_vkd;
+
+    VkDescriptorSetLayout       m_dsetLayout;
+    VkPipelineLayout            m_pipeLayout;
+    VkDescriptorUpdateTemplate  m_template;
+    VkPipeline                  m_pipeline;
+
+    VkDescriptorSetLayout createDescriptorSetLayout();
+
+    VkPipelineLayout createPipelineLayout();
+
+    VkDescriptorUpdateTemplate createDescriptorUpdateTemplate();
+
+    VkPipeline createPipeline();
+
+  };
   
 }
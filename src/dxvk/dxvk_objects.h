@@ -11,7 +11,12 @@
 #include "dxvk_meta_resolve.h"
 #include "dxvk_pipemanager.h"
 #include "dxvk_renderpass.h"
+#include "dxvk_sampler.h"
+#include "dxvk_sparse.h"
 #include "dxvk_unbound.h"
+#include "dxvk_buffer_heap.h"
+#include "dxvk_image_pool.h"
+#include "dxvk_staging.h"
 
 #include "../util/util_lazy.h"
 
@@ -27,7 +32,21 @@ namespace dxvk {
       m_pipelineManager (device),
       m_eventPool       (device),
       m_queryPool       (device),
-      m_dummyResources  (device) {
+      m_samplerPool     (device),
+      m_dummyResources  (device),
+      m_uniformHeap     (device,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_ACCESS_UNIFORM_READ_BIT),
+      m_vertexHeap      (device,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT),
+      m_sparsePagePool  (device, m_memoryManager),
+      m_imagePool       (device),
+      m_stagingPool     (device) {
 
     }
 
@@ -51,6 +70,30 @@ namespace dxvk {
       return m_dummyResources;
     }
 
+    DxvkBufferHeap& uniformHeap() {
+      return m_uniformHeap;
+    }
+
+    DxvkBufferHeap& vertexHeap() {
+      return m_vertexHeap;
+    }
+
+    DxvkSparsePagePool& sparsePagePool() {
+      return m_sparsePagePool;
+    }
+
+    DxvkImagePool& imagePool() {
+      return m_imagePool;
+    }
+
+    DxvkStagingPool& stagingPool() {
+      return m_stagingPool;
+    }
+
+    DxvkSamplerPool& samplerPool() {
+      return m_samplerPool;
+    }
+
     DxvkMetaBlitObjects& metaBlit() {
       return m_metaBlit.get(m_device);
     }
@@ -71,6 +114,10 @@ namespace dxvk {
       return m_metaPack.get(m_device);
     }
 
+    DxvkMetaMipGenObjects& metaMipGen() {
+      return m_metaMipGen.get(m_device);
+    }
+
   private:
 
     DxvkDevice*                   m_device;
@@ -81,13 +128,20 @@ namespace dxvk {
     DxvkGpuEventPool              m_eventPool;
     DxvkGpuQueryPool              m_queryPool;
 
+    DxvkSamplerPool               m_samplerPool;
     DxvkUnboundResources          m_dummyResources;
+    DxvkBufferHeap                m_uniformHeap;
+    DxvkBufferHeap                m_vertexHeap;
+    DxvkSparsePagePool            m_sparsePagePool;
+    DxvkImagePool                 m_imagePool;
+    DxvkStagingPool               m_stagingPool;
 
     Lazy<DxvkMetaBlitObjects>     m_metaBlit;
     Lazy<DxvkMetaClearObjects>    m_metaClear;
     Lazy<DxvkMetaCopyObjects>     m_metaCopy;
     Lazy<DxvkMetaResolveObjects>  m_metaResolve;
     Lazy<DxvkMetaPackObjects>     m_metaPack;
+    Lazy<DxvkMetaMipGenObjects>   m_metaMipGen;
 
   };
 
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "dxvk_limits.h"
 #include "dxvk_options.h"
 
 namespace dxvk {
@@ -6,11 +10,50 @@ namespace dxvk {
     enableDebugUtils      = config.getOption<bool>    ("dxvk.enableDebugUtils",       false);
     enableStateCache      = config.getOption<bool>    ("dxvk.enableStateCache",       true);
     numCompilerThreads    = config.getOption<int32_t> ("dxvk.numCompilerThreads",     0);
+    adaptiveCompilerThreads = config.getOption<bool>  ("dxvk.adaptiveCompilerThreads", false);
+    pinWorkerThreads      = config.getOption<bool>    ("dxvk.pinWorkerThreads",       false);
+    compilerThreadMask    = std::strtoull(config.getOption<std::string>("dxvk.compilerThreadMask", "").c_str(), nullptr, 16);
+    raiseCsThreadPriority = config.getOption<bool>    ("dxvk.raiseCsThreadPriority",  false);
     enableGraphicsPipelineLibrary = config.getOption<Tristate>("dxvk.enableGraphicsPipelineLibrary", Tristate::Auto);
+    enableDescriptorBuffer = config.getOption<bool> ("dxvk.enableDescriptorBuffer", false);
     trackPipelineLifetime = config.getOption<Tristate>("dxvk.trackPipelineLifetime",  Tristate::Auto);
+    evictShaderCode       = config.getOption<Tristate>("dxvk.evictShaderCode",        Tristate::Auto);
     useRawSsbo            = config.getOption<Tristate>("dxvk.useRawSsbo",             Tristate::Auto);
     maxChunkSize          = config.getOption<int32_t> ("dxvk.maxChunkSize",           0);
+    enableAsyncPipelines  = config.getOption<bool>    ("dxvk.enableAsyncPipelines",   false);
+    asyncPipelineMaxSkipFrames = config.getOption<int32_t>("dxvk.asyncPipelineMaxSkipFrames", 4);
+    asyncPipelineStallBudget = config.getOption<int32_t>("dxvk.asyncPipelineStallBudget", 0);
+    logSlowShaderCount    = config.getOption<int32_t> ("dxvk.logSlowShaderCount",     0);
     hud                   = config.getOption<std::string>("dxvk.hud", "");
+    tracePath             = config.getOption<std::string>("dxvk.tracePath", "");
+    shaderOverridePath    = config.getOption<std::string>("dxvk.shaderOverridePath", "");
+    frameTimeLog          = config.getOption<std::string>("dxvk.frameTimeLog", "");
+    latencySleep          = config.getOption<bool>("dxvk.latencySleep", false);
+    enablePresentWait     = config.getOption<bool>("dxvk.enablePresentWait", true);
+    enableRefreshRatePacing = config.getOption<bool>("dxvk.enableRefreshRatePacing", false);
+    uniformHeapThreshold  = config.getOption<int32_t>("dxvk.uniformHeapThreshold", 0);
+    vertexHeapThreshold   = config.getOption<int32_t>("dxvk.vertexHeapThreshold", 0);
+    imagePoolSize         = config.getOption<int32_t>("dxvk.imagePoolSize", 0);
+    enableDeferredDestruction = config.getOption<bool>("dxvk.enableDeferredDestruction", false);
+    enableFixedRateCompression = config.getOption<bool>("dxvk.enableFixedRateCompression", false);
+    useGeneralLayout      = config.getOption<bool>("dxvk.useGeneralLayout", false);
+    upscaleSharpness      = config.getOption<float>("dxvk.upscaleSharpness", 0.0f);
+    cachePackedDepthStencil = config.getOption<bool>("dxvk.cachePackedDepthStencil", false);
+    enableRenderPassResolve = config.getOption<bool>("dxvk.enableRenderPassResolve", false);
+    sparsePageReserve     = config.getOption<int32_t>("dxvk.sparsePageReserve", 0);
+    enableQueryReadback   = config.getOption<bool>("dxvk.enableQueryReadback", false);
+    enableComputePresent  = config.getOption<bool>("dxvk.enableComputePresent", false);
+    memoryReportInterval  = config.getOption<int32_t>("dxvk.memoryReportInterval", 0);
+    memoryTracePath       = config.getOption<std::string>("dxvk.memoryTracePath", "");
+    enableTelemetry       = config.getOption<bool>("dxvk.enableTelemetry", false);
+    profilePipelineStats  = config.getOption<bool>("dxvk.profilePipelineStats", false);
+
+    uniformHeapThreshold  = std::clamp(uniformHeapThreshold, 0, int32_t(MaxUniformBufferSize));
+    vertexHeapThreshold   = std::clamp(vertexHeapThreshold, 0, int32_t(256 << 10));
+    sparsePageReserve     = std::max(sparsePageReserve, 0);
+    imagePoolSize         = std::max(imagePoolSize, 0);
+    upscaleSharpness      = std::clamp(upscaleSharpness, 0.0f, 1.0f);
+    logSlowShaderCount    = std::max(logSlowShaderCount, 0);
   }
 
 }
@@ -18,20 +18,136 @@ namespace dxvk {
     /// when using the state cache
     int32_t numCompilerThreads;
 
+    /// Scale number of compiler threads doing background
+    /// work based on its impact on frame times
+    bool adaptiveCompilerThreads;
+
+    /// Pin the CS and submission threads to performance
+    /// cores and compiler threads to efficiency cores
+    bool pinWorkerThreads;
+
+    /// Explicit CPU core mask for compiler threads
+    uint64_t compilerThreadMask;
+
+    /// Run the CS thread at raised priority
+    bool raiseCsThreadPriority;
+
     /// Enable graphics pipeline library
     Tristate enableGraphicsPipelineLibrary;
 
+    /// Use descriptor buffers instead of descriptor sets
+    bool enableDescriptorBuffer;
+
     /// Enables pipeline lifetime tracking
     Tristate trackPipelineLifetime;
 
+    /// Evicts unused shader code that is stored in the shader cache
+    Tristate evictShaderCode;
+
     /// Shader-related options
     Tristate useRawSsbo;
 
     /// Maximum memory chunk size in MiB
     int32_t maxChunkSize;
 
+    /// Skip draws instead of stalling on
+    /// pipelines that are not compiled yet
+    bool enableAsyncPipelines;
+
+    /// Maximum number of consecutive frames
+    /// in which draws may be skipped
+    int32_t asyncPipelineMaxSkipFrames;
+
+    /// Time in microseconds that the context may stall
+    /// on pipeline compilation per frame before skipping
+    int32_t asyncPipelineStallBudget;
+
+    /// Number of shaders with the highest pipeline
+    /// compile times to log on shutdown
+    int32_t logSlowShaderCount;
+
     /// HUD elements
     std::string hud;
+
+    /// Directory for timeline traces
+    std::string tracePath;
+
+    /// Directory with replacement SPIR-V shaders
+    std::string shaderOverridePath;
+
+    /// CSV file for per-frame timings
+    std::string frameTimeLog;
+
+    /// Delay frames to reduce input latency
+    bool latencySleep;
+
+    /// Pace frames based on actual present timings
+    bool enablePresentWait;
+
+    /// Pace frames to the display refresh rate
+    /// if vsync is enabled and no limit is set
+    bool enableRefreshRatePacing;
+
+    /// Maximum size of uniform buffers that get suballocated
+    /// from a shared heap and bound as dynamic uniform buffers
+    int32_t uniformHeapThreshold;
+
+    /// Maximum size of vertex buffers that get
+    /// suballocated from a shared heap
+    int32_t vertexHeapThreshold;
+
+    /// Maximum amount of memory kept alive by
+    /// recently destroyed images for reuse, in MB
+    int32_t imagePoolSize;
+
+    /// Destroy Vulkan objects and free memory
+    /// on a dedicated worker thread
+    bool enableDeferredDestruction;
+
+    /// Request lossy fixed-rate compression for
+    /// render targets and depth-stencil images
+    bool enableFixedRateCompression;
+
+    /// Keep images in the general layout instead of
+    /// transitioning them between optimal layouts
+    bool useGeneralLayout;
+
+    /// Sharpening applied when the swap chain blitter
+    /// upscales the back buffer, 0 to disable
+    float upscaleSharpness;
+
+    /// Skip depth-stencil pack operations if neither the
+    /// image nor the buffer were written since the last one
+    bool cachePackedDepthStencil;
+
+    /// Record multisampled render passes into secondary command
+    /// buffers so that resolves can be done by the render pass
+    bool enableRenderPassResolve;
+
+    /// Amount of memory to pre-allocate for sparse
+    /// pages once tiled resources are used, in MB
+    int32_t sparsePageReserve;
+
+    /// Copy occlusion query results to a host-visible
+    /// buffer at the end of each command list
+    bool enableQueryReadback;
+
+    /// Blit to the swap chain image with a compute
+    /// shader if the swap chain supports storage
+    bool enableComputePresent;
+
+    /// Interval at which memory usage by resource
+    /// category is logged, in seconds. 0 disables.
+    int32_t memoryReportInterval;
+
+    /// Directory for memory allocation traces
+    std::string memoryTracePath;
+
+    /// Publish per-frame statistics in shared memory
+    bool enableTelemetry;
+
+    /// Record pipeline statistics for each profiled pass
+    bool profilePipelineStats;
   };
 
 }
@@ -102,12 +102,24 @@ namespace dxvk {
   }
 
 
-  DxvkBindingSetLayoutKey::DxvkBindingSetLayoutKey(const DxvkBindingList& list) {
+  DxvkBindingSetLayoutKey::DxvkBindingSetLayoutKey(
+    const DxvkBindingList&  list,
+          uint32_t          dynamicBufferCount) {
     m_bindings.resize(list.getBindingCount());
 
+    uint32_t dynamicBufferIndex = 0;
+
     for (uint32_t i = 0; i < list.getBindingCount(); i++) {
       m_bindings[i].descriptorType = list.getBinding(i).descriptorType;
       m_bindings[i].stages         = list.getBinding(i).stage;
+
+      // Bindings are sorted by type and slot, so this
+      // picks the uniform buffers with the lowest slots
+      if (m_bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+       && dynamicBufferIndex < dynamicBufferCount) {
+        m_bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        dynamicBufferIndex += 1;
+      }
     }
   }
 
@@ -158,6 +170,9 @@ namespace dxvk {
     for (uint32_t i = 0; i < key.getBindingCount(); i++) {
       auto entry = key.getBinding(i);
 
+      if (entry.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+        m_dynamicBufferCount += 1;
+
       VkDescriptorSetLayoutBinding bindingInfo;
       bindingInfo.binding = i;
       bindingInfo.descriptorType = entry.descriptorType;
@@ -180,10 +195,22 @@ namespace dxvk {
     layoutInfo.bindingCount = bindingInfos.size();
     layoutInfo.pBindings = bindingInfos.data();
 
+    if (m_device->canUseDescriptorBuffer())
+      layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
     if (vk->vkCreateDescriptorSetLayout(vk->device(), &layoutInfo, nullptr, &m_layout) != VK_SUCCESS)
       throw DxvkError("DxvkBindingSetLayoutKey: Failed to create descriptor set layout");
 
-    if (layoutInfo.bindingCount) {
+    if (m_device->canUseDescriptorBuffer()) {
+      // Descriptors are written directly into descriptor buffer
+      // memory, so we need the layout size and binding offsets
+      vk->vkGetDescriptorSetLayoutSizeEXT(vk->device(), m_layout, &m_setSize);
+
+      m_bindingOffsets.resize(layoutInfo.bindingCount);
+
+      for (uint32_t i = 0; i < layoutInfo.bindingCount; i++)
+        vk->vkGetDescriptorSetLayoutBindingOffsetEXT(vk->device(), m_layout, i, &m_bindingOffsets[i]);
+    } else if (layoutInfo.bindingCount) {
       VkDescriptorUpdateTemplateCreateInfo templateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO };
       templateInfo.descriptorUpdateEntryCount = templateInfos.size();
       templateInfo.pDescriptorUpdateEntries = templateInfos.data();
@@ -324,6 +351,7 @@ namespace dxvk {
           mapping.binding = j;
 
           m_mapping.insert({ key, mapping });
+          m_slotMask.set(binding.resourceBinding, true);
         }
 
         if (bindingCount) {
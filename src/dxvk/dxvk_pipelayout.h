@@ -4,8 +4,11 @@
 #include <unordered_map>
 #include <vector>
 
+#include "../util/util_bit.h"
+
 #include "dxvk_hash.h"
 #include "dxvk_include.h"
+#include "dxvk_limits.h"
 
 namespace dxvk {
 
@@ -159,7 +162,17 @@ namespace dxvk {
 
   public:
 
-    DxvkBindingSetLayoutKey(const DxvkBindingList& list);
+    /**
+     * \brief Creates set layout key
+     *
+     * \param [in] list Binding list
+     * \param [in] dynamicBufferCount Maximum number of uniform
+     *    buffers to turn into dynamic uniform buffers
+     */
+    DxvkBindingSetLayoutKey(
+      const DxvkBindingList&  list,
+            uint32_t          dynamicBufferCount);
+
     ~DxvkBindingSetLayoutKey();
 
     /**
@@ -233,11 +246,47 @@ namespace dxvk {
       return m_template;
     }
 
+    /**
+     * \brief Queries descriptor buffer size of the set
+     *
+     * Only valid if descriptor buffers are used.
+     * \returns Size of the set, in bytes
+     */
+    VkDeviceSize getSetSize() const {
+      return m_setSize;
+    }
+
+    /**
+     * \brief Queries descriptor buffer offset of a binding
+     *
+     * Only valid if descriptor buffers are used.
+     * \param [in] binding Binding index
+     * \returns Offset of the binding within the set
+     */
+    VkDeviceSize getBindingOffset(uint32_t binding) const {
+      return m_bindingOffsets[binding];
+    }
+
+    /**
+     * \brief Queries number of dynamic uniform buffers
+     *
+     * Dynamic uniform buffers are always the first
+     * uniform buffer bindings within the set.
+     * \returns Dynamic uniform buffer count
+     */
+    uint32_t getDynamicBufferCount() const {
+      return m_dynamicBufferCount;
+    }
+
   private:
 
     DxvkDevice*                   m_device;
     VkDescriptorSetLayout         m_layout    = VK_NULL_HANDLE;
     VkDescriptorUpdateTemplate    m_template  = VK_NULL_HANDLE;
+    uint32_t                      m_dynamicBufferCount = 0;
+
+    VkDeviceSize                  m_setSize   = 0;
+    std::vector<VkDeviceSize>     m_bindingOffsets;
 
   };
 
@@ -438,6 +487,18 @@ namespace dxvk {
       return m_setMask;
     }
 
+    /**
+     * \brief Checks whether a resource slot is used
+     *
+     * Binding a resource to a slot that is not used by
+     * the layout does not require any descriptor updates.
+     * \param [in] slot Resource binding slot
+     * \returns \c true if any binding uses the slot
+     */
+    bool usesResourceSlot(uint32_t slot) const {
+      return m_slotMask.get(slot);
+    }
+
     /**
      * \brief Retrieves descriptor set layout for a given set
      *
@@ -458,6 +519,37 @@ namespace dxvk {
       return m_bindingObjects[set]->getSetUpdateTemplate();
     }
 
+    /**
+     * \brief Queries descriptor buffer size of a set
+     *
+     * \param [in] set Descriptor set index
+     * \returns Size of the set, in bytes
+     */
+    VkDeviceSize getSetSize(uint32_t set) const {
+      return m_bindingObjects[set]->getSetSize();
+    }
+
+    /**
+     * \brief Queries descriptor buffer offset of a binding
+     *
+     * \param [in] set Descriptor set index
+     * \param [in] binding Binding index within the set
+     * \returns Offset of the binding within the set
+     */
+    VkDeviceSize getBindingOffset(uint32_t set, uint32_t binding) const {
+      return m_bindingObjects[set]->getBindingOffset(binding);
+    }
+
+    /**
+     * \brief Queries number of dynamic uniform buffers in a set
+     *
+     * \param [in] set Descriptor set index
+     * \returns Dynamic uniform buffer count
+     */
+    uint32_t getDynamicBufferCount(uint32_t set) const {
+      return m_bindingObjects[set]->getDynamicBufferCount();
+    }
+
     /**
      * \brief Retrieves pipeline layout
      *
@@ -507,6 +599,8 @@ namespace dxvk {
     uint32_t            m_bindingCount      = 0;
     uint32_t            m_setMask           = 0;
 
+    bit::bitset<MaxNumResourceSlots> m_slotMask;
+
     std::array<const DxvkBindingSetLayout*, DxvkDescriptorSets::SetCount> m_bindingObjects = { };
 
     std::unordered_map<DxvkBindingKey, DxvkBindingMapping, DxvkHash, DxvkEq> m_mapping;
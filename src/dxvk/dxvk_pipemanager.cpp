@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <optional>
 
 #include "dxvk_device.h"
@@ -5,11 +6,88 @@
 #include "dxvk_state_cache.h"
 
 namespace dxvk {
+
+  void DxvkPipelineStats::addCompileTime(
+          DxvkPipelineCompileType type,
+          size_t                  shaderCount,
+    const DxvkShader* const*      shaders,
+          high_resolution_clock::time_point t0) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+      high_resolution_clock::now() - t0);
+
+    uint64_t time = uint64_t(std::max<int64_t>(us.count(), 0));
+    uint32_t bucket = getPipelineLatencyBucket(time / 1000u);
+
+    compileTime[uint32_t(type)][bucket].fetch_add(1, std::memory_order_relaxed);
+
+    if (!trackShaders)
+      return;
+
+    std::lock_guard lock(shaderMutex);
+
+    for (size_t i = 0; i < shaderCount; i++) {
+      if (!shaders[i])
+        continue;
+
+      auto& entry = shaderTimes[shaders[i]->getShaderKey()];
+      entry.count   += 1;
+      entry.totalUs += time;
+      entry.maxUs    = std::max(entry.maxUs, time);
+    }
+  }
+
+
+  void DxvkPipelineStats::logCompileTimes(
+          uint32_t                count) {
+    static const std::array<const char*, DxvkPipelineCompileTypeCount> typeNames = {
+      "Libraries", "Optimized", "Compute",
+    };
+
+    Logger::info("Pipeline compile time histograms (ms):");
+
+    for (uint32_t i = 0; i < DxvkPipelineCompileTypeCount; i++) {
+      std::string line = str::format("  ", typeNames[i], ":");
+
+      for (uint32_t j = 0; j < DxvkPipelineLatencyBuckets; j++) {
+        uint64_t n = compileTime[i][j].load(std::memory_order_relaxed);
+
+        if (n)
+          line += str::format(" <", 1u << j, ": ", n);
+      }
+
+      Logger::info(line);
+    }
+
+    std::lock_guard lock(shaderMutex);
+
+    std::vector<std::pair<DxvkShaderKey, DxvkShaderCompileTime>> entries(
+      shaderTimes.begin(), shaderTimes.end());
+
+    std::sort(entries.begin(), entries.end(), [] (
+        const std::pair<DxvkShaderKey, DxvkShaderCompileTime>& a,
+        const std::pair<DxvkShaderKey, DxvkShaderCompileTime>& b) {
+      return a.second.totalUs > b.second.totalUs;
+    });
+
+    count = std::min(count, uint32_t(entries.size()));
+
+    Logger::info(str::format("Slowest ", count, " of ", entries.size(), " shaders:"));
+
+    for (uint32_t i = 0; i < count; i++) {
+      const auto& e = entries[i];
+
+      Logger::info(str::format("  ", e.first.toString(),
+        ": ", e.second.totalUs / 1000u, " ms total",
+        ", ", e.second.count, " pipelines",
+        ", ", e.second.maxUs / 1000u, " ms max"));
+    }
+  }
+
   
   DxvkPipelineWorkers::DxvkPipelineWorkers(
           DxvkDevice*                     device)
   : m_device(device) {
-
+    m_adaptive = device->config().adaptiveCompilerThreads;
   }
 
 
@@ -26,7 +104,7 @@ namespace dxvk {
 
     m_tasksTotal += 1;
 
-    m_buckets[uint32_t(priority)].queue.emplace(library);
+    enqueue(PipelineEntry(library), priority);
     notifyWorkers(priority);
   }
 
@@ -41,7 +119,20 @@ namespace dxvk {
     pipeline->acquirePipeline();
     m_tasksTotal += 1;
 
-    m_buckets[uint32_t(priority)].queue.emplace(pipeline, state);
+    enqueue(PipelineEntry(pipeline, state), priority);
+    notifyWorkers(priority);
+  }
+
+
+  void DxvkPipelineWorkers::compileMetaPipeline(
+          std::function<void ()>&&        task,
+          DxvkPipelinePriority            priority) {
+    std::unique_lock lock(m_lock);
+    this->startWorkers();
+
+    m_tasksTotal += 1;
+
+    enqueue(PipelineEntry(std::move(task)), priority);
     notifyWorkers(priority);
   }
 
@@ -65,23 +156,216 @@ namespace dxvk {
   }
 
 
+  void DxvkPipelineWorkers::enqueue(
+          PipelineEntry&&                 entry,
+          DxvkPipelinePriority            priority) {
+    uint32_t index = uint32_t(priority);
+    auto& bucket = m_buckets[index];
+
+    // Distribute work among all workers that can process the
+    // given priority. Any other worker that can process the
+    // task may still steal it if it runs out of work.
+    uint32_t queueIndex = bucket.nextQueue;
+
+    for (uint32_t i = 0; i < m_queues.size(); i++) {
+      uint32_t candidate = (bucket.nextQueue + i) % m_queues.size();
+
+      if (uint32_t(m_queues[candidate]->maxPriority) >= index) {
+        queueIndex = candidate;
+        break;
+      }
+    }
+
+    bucket.nextQueue = (queueIndex + 1) % m_queues.size();
+
+    entry.submitTime = high_resolution_clock::now();
+
+    auto& queue = *m_queues[queueIndex];
+    std::lock_guard queueLock(queue.lock);
+    queue.entries[index].push_back(std::move(entry));
+    bucket.pendingTasks += 1;
+  }
+
+
+  void DxvkPipelineWorkers::endFrame() {
+    if (!m_adaptive)
+      return;
+
+    std::unique_lock lock(m_lock);
+
+    auto now = high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastFrame);
+
+    bool isFirstFrame = m_lastFrame == high_resolution_clock::time_point();
+    m_lastFrame = now;
+
+    if (isFirstFrame || !m_workersRunning.load())
+      return;
+
+    m_frameTimeSum += uint64_t(std::max<int64_t>(us.count(), 0));
+    m_frameCount += 1;
+
+    if (m_frameCount < AdaptiveFrameInterval)
+      return;
+
+    uint64_t frameTimeUs = m_frameTimeSum / m_frameCount;
+
+    m_frameTimeSum = 0;
+    m_frameCount = 0;
+
+    uint32_t backlog = m_buckets[uint32_t(DxvkPipelinePriority::Normal)].pendingTasks.load()
+                     + m_buckets[uint32_t(DxvkPipelinePriority::Low)].pendingTasks.load();
+
+    uint32_t oldLimit = m_backgroundLimit.load();
+    uint32_t newLimit = oldLimit;
+
+    if (!backlog) {
+      // Frame times without background work serve as the baseline
+      // to compare against. Keep the current limit so that work
+      // arriving during gameplay does not immediately hitch.
+      if (frameTimeUs < LoadingFrameTimeUs) {
+        m_baselineUs = m_baselineUs
+          ? (m_baselineUs * 3 + frameTimeUs) / 4
+          : frameTimeUs;
+      }
+    } else if (frameTimeUs >= LoadingFrameTimeUs || !m_baselineUs) {
+      // Not rendering interactively, use all workers
+      newLimit = m_backgroundWorkers;
+    } else if (frameTimeUs > m_baselineUs + m_baselineUs / 8) {
+      // Background work is slowing down the game. Always keep
+      // one worker running so that the backlog gets processed.
+      newLimit = std::max(oldLimit, 2u) - 1;
+    } else if (frameTimeUs < m_baselineUs + m_baselineUs / 16) {
+      // There is headroom, ramp up faster if the queue is long
+      uint32_t step = backlog > 8 * oldLimit ? 2 : 1;
+      newLimit = std::min(oldLimit + step, m_backgroundWorkers);
+    }
+
+    if (newLimit == oldLimit)
+      return;
+
+    m_backgroundLimit.store(newLimit);
+
+    // Wake up workers that may now process more work
+    if (newLimit > oldLimit) {
+      for (auto& bucket : m_buckets)
+        bucket.cond.notify_all();
+    }
+  }
+
+
+  DxvkPipelinePriority DxvkPipelineWorkers::getMaxPriority(
+          uint32_t                        queueIndex) const {
+    if (queueIndex >= m_backgroundLimit.load(std::memory_order_relaxed))
+      return DxvkPipelinePriority::High;
+
+    return m_queues[queueIndex]->maxPriority;
+  }
+
+
+  bool DxvkPipelineWorkers::dequeue(
+          uint32_t                        queueIndex,
+          DxvkPipelinePriority            maxPriority,
+          PipelineEntry&                  entry,
+          DxvkPipelinePriority&           priority) {
+    uint32_t maxPriorityIndex = uint32_t(maxPriority);
+
+    // Always pick the highest-priority task that is available in
+    // any queue. Tasks are taken from the front of the worker's
+    // own queue, and stolen from the back of other queues.
+    for (uint32_t i = 0; i <= maxPriorityIndex; i++) {
+      if (!m_buckets[i].pendingTasks.load())
+        continue;
+
+      for (uint32_t j = 0; j < m_queues.size(); j++) {
+        auto& queue = *m_queues[(queueIndex + j) % m_queues.size()];
+
+        std::lock_guard queueLock(queue.lock);
+        auto& list = queue.entries[i];
+
+        if (list.empty())
+          continue;
+
+        if (!j) {
+          entry = std::move(list.front());
+          list.pop_front();
+        } else {
+          entry = std::move(list.back());
+          list.pop_back();
+        }
+
+        m_buckets[i].pendingTasks -= 1;
+
+        priority = DxvkPipelinePriority(i);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+
+  bool DxvkPipelineWorkers::hasPendingTasks(
+          DxvkPipelinePriority            maxPriority) const {
+    for (uint32_t i = 0; i <= uint32_t(maxPriority); i++) {
+      if (m_buckets[i].pendingTasks.load())
+        return true;
+    }
+
+    return false;
+  }
+
+
+  bool DxvkPipelineWorkers::isStale(
+    const PipelineEntry&                  entry,
+          DxvkPipelinePriority            priority) const {
+    // Low-priority pipelines are only compiled in order to replace a
+    // linked pipeline. If an optimized pipeline has been compiled in
+    // the meantime, e.g. via the state cache, skip the task.
+    return priority == DxvkPipelinePriority::Low
+        && entry.graphicsPipeline
+        && entry.graphicsPipeline->hasOptimizedPipeline(entry.graphicsState);
+  }
+
+
+  void DxvkPipelineWorkers::recordLatency(
+    const PipelineEntry&                  entry,
+          DxvkPipelinePriority            priority) {
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+      high_resolution_clock::now() - entry.submitTime);
+
+    uint64_t ms = uint64_t(std::max<int64_t>(latency.count(), 0));
+    uint32_t bucket = getPipelineLatencyBucket(ms);
+
+    m_latency[uint32_t(priority)][bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+
   void DxvkPipelineWorkers::notifyWorkers(DxvkPipelinePriority priority) {
     uint32_t index = uint32_t(priority);
 
     // If any workers are idle in a suitable set, notify the corresponding
     // condition variable. If all workers are busy anyway, we know that the
     // job is going to be picked up at some point anyway.
+    bool throttled = m_backgroundLimit.load() < m_backgroundWorkers;
+
     for (uint32_t i = index; i < m_buckets.size(); i++) {
       if (m_buckets[i].idleWorkers) {
-        m_buckets[i].cond.notify_one();
-        break;
+        // Throttled workers wait on the same condition variable
+        // but may not be able to take the task, wake everyone.
+        if (!throttled) {
+          m_buckets[i].cond.notify_one();
+          break;
+        }
+
+        m_buckets[i].cond.notify_all();
       }
     }
   }
 
 
   void DxvkPipelineWorkers::startWorkers() {
-    if (!std::exchange(m_workersRunning, true)) {
+    if (!m_workersRunning.exchange(true)) {
       // Use all available cores by default
       uint32_t workerCount = dxvk::thread::hardware_concurrency();
 
@@ -100,23 +384,49 @@ namespace dxvk {
       uint32_t npWorkerCount = std::max(((workerCount - 1) * 5) / 7, 1u);
       uint32_t lpWorkerCount = std::max(((workerCount - 1) * 2) / 7, 1u);
 
-      m_workers.reserve(workerCount);
+      // Discard any work left over from previously stopped workers
+      m_queues.clear();
+      m_queues.reserve(workerCount);
+
+      for (auto& bucket : m_buckets) {
+        bucket.pendingTasks = 0;
+        bucket.nextQueue = 0;
+      }
+
+      m_backgroundWorkers = 0;
 
       for (size_t i = 0; i < workerCount; i++) {
-        DxvkPipelinePriority priority = DxvkPipelinePriority::Normal;
+        auto& queue = m_queues.emplace_back(std::make_unique<PipelineQueue>());
 
         if (m_device->canUseGraphicsPipelineLibrary()) {
           if (i >= npWorkerCount)
-            priority = DxvkPipelinePriority::High;
+            queue->maxPriority = DxvkPipelinePriority::High;
           else if (i < lpWorkerCount)
-            priority = DxvkPipelinePriority::Low;
+            queue->maxPriority = DxvkPipelinePriority::Low;
         }
 
-        auto& worker = m_workers.emplace_back([this, priority] {
-          runWorker(priority);
+        if (queue->maxPriority != DxvkPipelinePriority::High)
+          m_backgroundWorkers += 1;
+      }
+
+      // Workers that can process background work come first, so
+      // limiting by queue index keeps low-priority workers active
+      m_backgroundLimit = m_backgroundWorkers;
+
+      uint64_t workerMask = m_device->config().compilerThreadMask;
+
+      if (!workerMask && m_device->config().pinWorkerThreads)
+        workerMask = getCpuCoreMask(CpuCoreType::Efficiency);
+
+      m_workers.reserve(workerCount);
+
+      for (uint32_t i = 0; i < workerCount; i++) {
+        auto& worker = m_workers.emplace_back([this, i] {
+          runWorker(i);
         });
         
         worker.set_priority(ThreadPriority::Lowest);
+        worker.set_affinity(workerMask);
       }
 
       Logger::info(str::format("DXVK: Using ", workerCount, " compiler threads"));
@@ -124,46 +434,53 @@ namespace dxvk {
   }
 
 
-  void DxvkPipelineWorkers::runWorker(DxvkPipelinePriority maxPriority) {
+  void DxvkPipelineWorkers::runWorker(uint32_t queueIndex) {
     static const std::array<char, 3> suffixes = { 'h', 'n', 'l' };
 
+    const DxvkPipelinePriority maxPriority = m_queues[queueIndex]->maxPriority;
     const uint32_t maxPriorityIndex = uint32_t(maxPriority);
     env::setThreadName(str::format("dxvk-shader-", suffixes.at(maxPriorityIndex)));
 
     while (true) {
       PipelineEntry entry;
+      DxvkPipelinePriority priority = DxvkPipelinePriority::Normal;
+
+      // Skip pending work when stopping,
+      // exiting early is more important.
+      if (!m_workersRunning.load())
+        break;
 
-      { std::unique_lock lock(m_lock);
+      if (!dequeue(queueIndex, getMaxPriority(queueIndex), entry, priority)) {
+        std::unique_lock lock(m_lock);
         auto& bucket = m_buckets[maxPriorityIndex];
 
         bucket.idleWorkers += 1;
-        bucket.cond.wait(lock, [this, maxPriorityIndex, &entry] {
-          // Attempt to fetch a work item from the
-          // highest-priority queue that is not empty
-          for (uint32_t i = 0; i <= maxPriorityIndex; i++) {
-            if (!m_buckets[i].queue.empty()) {
-              entry = m_buckets[i].queue.front();
-              m_buckets[i].queue.pop();
-              return true;
-            }
-          }
-
-          return !m_workersRunning;
+        bucket.cond.wait(lock, [this, queueIndex] {
+          return hasPendingTasks(getMaxPriority(queueIndex))
+              || !m_workersRunning.load();
         });
 
         bucket.idleWorkers -= 1;
-
-        // Skip pending work, exiting early is
-        // more important in this case.
-        if (!m_workersRunning)
-          break;
+        continue;
       }
 
+      recordLatency(entry, priority);
+
       if (entry.pipelineLibrary) {
+        DxvkTraceScope zone(m_device->tracer(), "Compile pipeline library");
         entry.pipelineLibrary->compilePipeline();
       } else if (entry.graphicsPipeline) {
-        entry.graphicsPipeline->compilePipeline(entry.graphicsState);
+        if (!isStale(entry, priority)) {
+          DxvkTraceScope zone(m_device->tracer(), "Compile pipeline");
+          entry.graphicsPipeline->compilePipeline(entry.graphicsState);
+        } else {
+          m_tasksCancelled += 1;
+        }
+
         entry.graphicsPipeline->releasePipeline();
+      } else if (entry.metaTask) {
+        DxvkTraceScope zone(m_device->tracer(), "Compile meta pipeline");
+        entry.metaTask();
       }
 
       m_tasksCompleted += 1;
@@ -176,6 +493,16 @@ namespace dxvk {
   : m_device    (device),
     m_workers   (device),
     m_stateCache(device, this, &m_workers) {
+    m_stats.trackShaders = m_device->config().logSlowShaderCount > 0;
+
+    std::string overridePath = env::getEnvVar("DXVK_SHADER_OVERRIDE_PATH");
+
+    if (overridePath.empty())
+      overridePath = m_device->config().shaderOverridePath;
+
+    if (!overridePath.empty())
+      m_shaderOverrides = std::make_unique<DxvkShaderOverrides>(overridePath);
+
     Logger::info(str::format("DXVK: Graphics pipeline libraries ",
       (m_device->canUseGraphicsPipelineLibrary() ? "supported" : "not supported")));
 
@@ -187,7 +514,8 @@ namespace dxvk {
   
   
   DxvkPipelineManager::~DxvkPipelineManager() {
-    
+    if (m_stats.trackShaders)
+      m_stats.logCompileTimes(uint32_t(m_device->config().logSlowShaderCount));
   }
   
   
@@ -338,6 +666,10 @@ namespace dxvk {
   
   void DxvkPipelineManager::registerShader(
     const Rc<DxvkShader>&         shader) {
+    // Replace the code before compiling anything
+    if (unlikely(m_shaderOverrides))
+      m_shaderOverrides->registerShader(shader);
+
     if (canPrecompileShader(shader)) {
       DxvkShaderPipelineLibraryKey key;
       key.addShader(shader);
@@ -379,6 +711,62 @@ namespace dxvk {
   }
 
 
+  void DxvkPipelineManager::updateShaderOverrides() {
+    auto shaders = m_shaderOverrides->pollChanges();
+
+    if (shaders.empty())
+      return;
+
+    for (const auto& shader : shaders)
+      invalidateShader(shader);
+
+    m_invalidationCount.fetch_add(1u, std::memory_order_release);
+  }
+
+
+  void DxvkPipelineManager::invalidateShader(
+    const Rc<DxvkShader>&         shader) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    // Remove all objects that use the shader from the lookup tables,
+    // so that subsequent lookups create new ones with the new code.
+    // Pipeline objects are not thread-safe to destroy, so retire
+    // them instead and keep them around until the device dies.
+    for (auto i = m_shaderLibraries.begin(); i != m_shaderLibraries.end(); ) {
+      DxvkShaderSet set = i->first.getShaderSet();
+
+      bool match = set.vs == shader.ptr() || set.tcs == shader.ptr()
+                || set.tes == shader.ptr() || set.gs == shader.ptr()
+                || set.fs == shader.ptr() || set.cs == shader.ptr();
+
+      if (match)
+        m_retiredLibraries.push_back(m_shaderLibraries.extract(i++));
+      else
+        i++;
+    }
+
+    for (auto i = m_computePipelines.begin(); i != m_computePipelines.end(); ) {
+      if (i->first.cs == shader)
+        m_retiredComputePipelines.push_back(m_computePipelines.extract(i++));
+      else
+        i++;
+    }
+
+    for (auto i = m_graphicsPipelines.begin(); i != m_graphicsPipelines.end(); ) {
+      const DxvkGraphicsPipelineShaders& shaders = i->first;
+
+      bool match = shaders.vs == shader || shaders.tcs == shader
+                || shaders.tes == shader || shaders.gs == shader
+                || shaders.fs == shader;
+
+      if (match)
+        m_retiredGraphicsPipelines.push_back(m_graphicsPipelines.extract(i++));
+      else
+        i++;
+    }
+  }
+
+
   void DxvkPipelineManager::stopWorkerThreads() {
     m_workers.stopWorkers();
     m_stateCache.stopWorkers();
@@ -409,8 +797,10 @@ namespace dxvk {
     uint32_t setMask = layout.getSetMask();
 
     for (uint32_t i = 0; i < setLayouts.size(); i++) {
-      if (setMask & (1u << i))
-        setLayouts[i] = createDescriptorSetLayout(layout.getBindingList(i));
+      if (setMask & (1u << i)) {
+        setLayouts[i] = createDescriptorSetLayout(DxvkBindingSetLayoutKey(
+          layout.getBindingList(i), getDynamicBufferCount(layout, i)));
+      }
     }
 
     auto iter = m_pipelineLayouts.emplace(
@@ -421,6 +811,25 @@ namespace dxvk {
   }
 
 
+  uint32_t DxvkPipelineManager::getDynamicBufferCount(
+    const DxvkBindingLayout&      layout,
+          uint32_t                set) const {
+    uint32_t maxCount = m_device->getMaxDynamicUniformBuffers();
+
+    if (layout.getStages() == VK_SHADER_STAGE_COMPUTE_BIT)
+      return maxCount;
+
+    // Split dynamic buffers between the two graphics sets that contain
+    // uniform buffers. The split must not depend on the stages present
+    // in the layout, so that pipeline libraries can be linked.
+    switch (set) {
+      case DxvkDescriptorSets::FsBuffers: return maxCount / 2;
+      case DxvkDescriptorSets::VsAll:     return maxCount - maxCount / 2;
+      default:                            return 0;
+    }
+  }
+
+
   DxvkShaderPipelineLibrary* DxvkPipelineManager::createPipelineLibraryLocked(
     const DxvkShaderPipelineLibraryKey& key) {
     auto bindings = key.getBindings();
@@ -1,14 +1,20 @@
 
 #pragma once
 
+#include <algorithm>
+#include <deque>
+#include <functional>
 #include <mutex>
 #include <queue>
 #include <unordered_map>
 
 #include "dxvk_compute.h"
 #include "dxvk_graphics.h"
+#include "dxvk_shader_override.h"
 #include "dxvk_state_cache.h"
 
+#include "../util/util_time.h"
+
 namespace dxvk {
 
   class DxvkDevice;
@@ -25,27 +31,116 @@ namespace dxvk {
     uint32_t numComputePipelines;
   };
 
+  /**
+   * \brief Pipeline priority
+   */
+  enum class DxvkPipelinePriority : uint32_t {
+    High    = 0,
+    Normal  = 1,
+    Low     = 2,
+  };
+
+  constexpr uint32_t DxvkPipelinePriorityCount = 3;
+
+  /**
+   * \brief Number of latency histogram buckets
+   *
+   * Bucket 0 counts tasks that were picked up within one
+   * millisecond, bucket \c n counts latencies in the range
+   * of [2^(n-1), 2^n) ms. The last bucket counts the rest.
+   */
+  constexpr uint32_t DxvkPipelineLatencyBuckets = 16;
+
+  using DxvkPipelineLatencyHistogram = std::array<uint64_t, DxvkPipelineLatencyBuckets>;
+
+  /**
+   * \brief Computes latency histogram bucket
+   *
+   * \param [in] ms Latency, in milliseconds
+   * \returns Bucket index
+   */
+  inline uint32_t getPipelineLatencyBucket(uint64_t ms) {
+    uint32_t bucket = ms ? 64 - bit::lzcnt(ms) : 0;
+    return std::min(bucket, DxvkPipelineLatencyBuckets - 1);
+  }
+
+  /**
+   * \brief Pipeline compile type
+   */
+  enum class DxvkPipelineCompileType : uint32_t {
+    Library   = 0,
+    Optimized = 1,
+    Compute   = 2,
+  };
+
+  constexpr uint32_t DxvkPipelineCompileTypeCount = 3;
+
+  /**
+   * \brief Per-shader compile time
+   *
+   * Accumulated over all pipelines using the shader.
+   */
+  struct DxvkShaderCompileTime {
+    uint32_t count   = 0;
+    uint64_t totalUs = 0;
+    uint64_t maxUs   = 0;
+  };
+
   /**
    * \brief Pipeline stats
+   *
+   * Compile time histograms are always recorded. Compile
+   * times per shader are only tracked if requested, since
+   * that requires taking a lock for every pipeline.
    */
   struct DxvkPipelineStats {
     std::atomic<uint32_t> numGraphicsPipelines  = { 0u };
     std::atomic<uint32_t> numGraphicsLibraries  = { 0u };
     std::atomic<uint32_t> numComputePipelines   = { 0u };
-  };
 
-  struct DxvkPipelineWorkerStats {
-    uint64_t tasksCompleted;
-    uint64_t tasksTotal;
+    std::array<std::array<std::atomic<uint64_t>,
+      DxvkPipelineLatencyBuckets>,
+      DxvkPipelineCompileTypeCount> compileTime = { };
+
+    bool                  trackShaders = false;
+    dxvk::mutex           shaderMutex;
+
+    std::unordered_map<
+      DxvkShaderKey, DxvkShaderCompileTime,
+      DxvkHash, DxvkEq>   shaderTimes;
+
+    /**
+     * \brief Records pipeline compile time
+     *
+     * \param [in] type Pipeline type
+     * \param [in] shaderCount Number of shaders
+     * \param [in] shaders Shaders used by the pipeline,
+     *    may contain \c nullptr entries
+     * \param [in] t0 Time when compilation started
+     */
+    void addCompileTime(
+            DxvkPipelineCompileType type,
+            size_t                  shaderCount,
+      const DxvkShader* const*      shaders,
+            high_resolution_clock::time_point t0);
+
+    /**
+     * \brief Logs compile time statistics
+     * \param [in] count Number of shaders to log
+     */
+    void logCompileTimes(
+            uint32_t                count);
   };
 
   /**
-   * \brief Pipeline priority
+   * \brief Pipeline worker stats
    */
-  enum class DxvkPipelinePriority : uint32_t {
-    High    = 0,
-    Normal  = 1,
-    Low     = 2,
+  struct DxvkPipelineWorkerStats {
+    uint64_t tasksCompleted;
+    uint64_t tasksTotal;
+    uint64_t tasksCancelled;
+    /// Time between submission and start of execution, per priority
+    std::array<DxvkPipelineLatencyHistogram, DxvkPipelinePriorityCount> latency;
   };
 
   /**
@@ -53,6 +148,12 @@ namespace dxvk {
    *
    * Spawns worker threads to compile shader pipeline
    * libraries and optimized pipelines asynchronously.
+   *
+   * Each worker owns one queue per priority, and idle
+   * workers steal work from other workers. Workers always
+   * pick the highest-priority task available from any
+   * queue, so high-priority work is never stuck behind
+   * lower-priority work that has not started yet.
    */
   class DxvkPipelineWorkers {
 
@@ -73,6 +174,13 @@ namespace dxvk {
       DxvkPipelineWorkerStats result;
       result.tasksCompleted = m_tasksCompleted.load(std::memory_order_acquire);
       result.tasksTotal = m_tasksTotal.load(std::memory_order_relaxed);
+      result.tasksCancelled = m_tasksCancelled.load(std::memory_order_relaxed);
+
+      for (uint32_t i = 0; i < DxvkPipelinePriorityCount; i++) {
+        for (uint32_t j = 0; j < DxvkPipelineLatencyBuckets; j++)
+          result.latency[i][j] = m_latency[i][j].load(std::memory_order_relaxed);
+      }
+
       return result;
     }
 
@@ -100,6 +208,20 @@ namespace dxvk {
       const DxvkGraphicsPipelineStateInfo&  state,
             DxvkPipelinePriority            priority);
 
+    /**
+     * \brief Compiles a meta pipeline
+     *
+     * Runs an arbitrary task that creates one or more
+     * built-in pipelines, e.g. for resolves, so that
+     * they exist by the time the context needs them.
+     * The task must not outlive the device objects.
+     * \param [in] task Task to run
+     * \param [in] priority Pipeline priority
+     */
+    void compileMetaPipeline(
+            std::function<void ()>&&        task,
+            DxvkPipelinePriority            priority);
+
     /**
      * \brief Stops all worker threads
      *
@@ -108,8 +230,24 @@ namespace dxvk {
      */
     void stopWorkers();
 
+    /**
+     * \brief Notifies workers about a presented frame
+     *
+     * If adaptive compiler threads are enabled, adjusts the number
+     * of workers that may process normal- and low-priority work,
+     * based on how much background compilation affects frame times.
+     */
+    void endFrame();
+
   private:
 
+    /// Number of frames over which frame times are averaged
+    constexpr static uint32_t AdaptiveFrameInterval = 16;
+
+    /// Frame time above which the application is assumed
+    /// to be loading rather than rendering interactively
+    constexpr static uint64_t LoadingFrameTimeUs = 100000;
+
     struct PipelineEntry {
       PipelineEntry()
       : pipelineLibrary(nullptr), graphicsPipeline(nullptr) { }
@@ -120,33 +258,84 @@ namespace dxvk {
       PipelineEntry(DxvkGraphicsPipeline* p, const DxvkGraphicsPipelineStateInfo& s)
       : pipelineLibrary(nullptr), graphicsPipeline(p), graphicsState(s) { }
 
+      PipelineEntry(std::function<void ()>&& t)
+      : pipelineLibrary(nullptr), graphicsPipeline(nullptr), metaTask(std::move(t)) { }
+
       DxvkShaderPipelineLibrary*    pipelineLibrary;
       DxvkGraphicsPipeline*         graphicsPipeline;
       DxvkGraphicsPipelineStateInfo graphicsState;
+      std::function<void ()>        metaTask;
+      high_resolution_clock::time_point submitTime;
+    };
+
+    struct PipelineQueue {
+      dxvk::mutex               lock;
+      std::array<std::deque<PipelineEntry>, DxvkPipelinePriorityCount> entries;
+      DxvkPipelinePriority      maxPriority = DxvkPipelinePriority::Normal;
     };
 
     struct PipelineBucket {
       dxvk::condition_variable  cond;
-      std::queue<PipelineEntry> queue;
       uint32_t                  idleWorkers = 0;
+      std::atomic<uint32_t>     pendingTasks = { 0u };
+      uint32_t                  nextQueue = 0;
     };
 
     DxvkDevice*                       m_device;
 
     std::atomic<uint64_t>             m_tasksTotal     = { 0ull };
     std::atomic<uint64_t>             m_tasksCompleted = { 0ull };
+    std::atomic<uint64_t>             m_tasksCancelled = { 0ull };
+
+    std::array<std::array<std::atomic<uint64_t>,
+      DxvkPipelineLatencyBuckets>,
+      DxvkPipelinePriorityCount>      m_latency = { };
 
     dxvk::mutex                       m_lock;
-    std::array<PipelineBucket, 3>     m_buckets;
+    std::array<PipelineBucket, DxvkPipelinePriorityCount> m_buckets;
 
-    bool                              m_workersRunning = false;
+    std::atomic<bool>                 m_workersRunning = { false };
     std::vector<dxvk::thread>         m_workers;
+    std::vector<std::unique_ptr<PipelineQueue>> m_queues;
+
+    bool                              m_adaptive = false;
+    std::atomic<uint32_t>             m_backgroundLimit = { ~0u };
+    uint32_t                          m_backgroundWorkers = 0;
+
+    high_resolution_clock::time_point m_lastFrame = { };
+    uint64_t                          m_frameTimeSum = 0;
+    uint32_t                          m_frameCount = 0;
+    uint64_t                          m_baselineUs = 0;
+
+    void enqueue(
+            PipelineEntry&&                 entry,
+            DxvkPipelinePriority            priority);
+
+    bool dequeue(
+            uint32_t                        queueIndex,
+            DxvkPipelinePriority            maxPriority,
+            PipelineEntry&                  entry,
+            DxvkPipelinePriority&           priority);
+
+    DxvkPipelinePriority getMaxPriority(
+            uint32_t                        queueIndex) const;
+
+    bool hasPendingTasks(
+            DxvkPipelinePriority            maxPriority) const;
+
+    bool isStale(
+      const PipelineEntry&                  entry,
+            DxvkPipelinePriority            priority) const;
+
+    void recordLatency(
+      const PipelineEntry&                  entry,
+            DxvkPipelinePriority            priority);
 
     void notifyWorkers(DxvkPipelinePriority priority);
 
     void startWorkers();
 
-    void runWorker(DxvkPipelinePriority maxPriority);
+    void runWorker(uint32_t queueIndex);
 
   };
 
@@ -245,6 +434,16 @@ namespace dxvk {
     void requestCompileShader(
       const Rc<DxvkShader>&         shader);
 
+    /**
+     * \brief Compiles a meta pipeline in the background
+     *
+     * \param [in] task Task that creates the pipeline
+     */
+    void requestCompileMetaPipeline(
+            std::function<void ()>&&  task) {
+      m_workers.compileMetaPipeline(std::move(task), DxvkPipelinePriority::Normal);
+    }
+
     /**
      * \brief Retrieves total pipeline count
      * \returns Number of compute/graphics pipelines
@@ -259,6 +458,47 @@ namespace dxvk {
       return m_workers.getStats();
     }
 
+    /**
+     * \brief Checks whether pipelines are being compiled
+     *
+     * \returns \c true if the state cache or the
+     *    compiler workers have any pending work
+     */
+    bool isCompiling() {
+      // Check the state cache first since it
+      // dispatches work to the compiler workers
+      if (m_stateCache.isCompiling())
+        return true;
+
+      DxvkPipelineWorkerStats stats = m_workers.getStats();
+      return stats.tasksCompleted < stats.tasksTotal;
+    }
+
+    /**
+     * \brief Queries pipeline invalidation count
+     *
+     * Incremented whenever pipeline objects get invalidated
+     * because the code of a shader has been replaced. Contexts
+     * must discard any cached pipeline pointers when this
+     * value changes.
+     * \returns Number of pipeline invalidations
+     */
+    uint32_t getInvalidationCount() const {
+      return m_invalidationCount.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Notifies compiler threads about a presented frame
+     *
+     * Also applies any changed shader overrides.
+     */
+    void endFrame() {
+      m_workers.endFrame();
+
+      if (unlikely(m_shaderOverrides))
+        this->updateShaderOverrides();
+    }
+
     /**
      * \brief Stops async compiler threads
      */
@@ -308,17 +548,35 @@ namespace dxvk {
       DxvkGraphicsPipeline,
       DxvkHash, DxvkEq> m_graphicsPipelines;
 
+    std::unique_ptr<DxvkShaderOverrides> m_shaderOverrides;
+    std::atomic<uint32_t> m_invalidationCount = { 0u };
+
+    // Invalidated objects may still be in use by contexts or
+    // pipeline workers, so keep them alive until destruction
+    std::vector<decltype(m_shaderLibraries)::node_type>   m_retiredLibraries;
+    std::vector<decltype(m_computePipelines)::node_type>  m_retiredComputePipelines;
+    std::vector<decltype(m_graphicsPipelines)::node_type> m_retiredGraphicsPipelines;
+
     DxvkBindingSetLayout* createDescriptorSetLayout(
       const DxvkBindingSetLayoutKey& key);
 
     DxvkBindingLayoutObjects* createPipelineLayout(
       const DxvkBindingLayout& layout);
 
+    uint32_t getDynamicBufferCount(
+      const DxvkBindingLayout& layout,
+            uint32_t           set) const;
+
     DxvkShaderPipelineLibrary* createPipelineLibraryLocked(
       const DxvkShaderPipelineLibraryKey& key);
 
     DxvkShaderPipelineLibrary* createNullFsPipelineLibrary();
 
+    void updateShaderOverrides();
+
+    void invalidateShader(
+      const Rc<DxvkShader>&         shader);
+
     DxvkShaderPipelineLibrary* findPipelineLibrary(
       const DxvkShaderPipelineLibraryKey& key);
 
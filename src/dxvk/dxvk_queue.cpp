@@ -7,7 +7,11 @@ namespace dxvk {
   : m_device(device), m_callback(callback),
     m_submitThread([this] () { submitCmdLists(); }),
     m_finishThread([this] () { finishCmdLists(); }) {
-
+    if (m_device->config().pinWorkerThreads) {
+      uint64_t mask = getCpuCoreMask(CpuCoreType::Performance);
+      m_submitThread.set_affinity(mask);
+      m_finishThread.set_affinity(mask);
+    }
   }
   
   
@@ -36,8 +40,17 @@ namespace dxvk {
     DxvkSubmitEntry entry = { };
     entry.status = status;
     entry.submit = std::move(submitInfo);
+    entry.sequenceNumber = ++m_submitSequence;
+    entry.queueTime = dxvk::high_resolution_clock::now();
+
+    // Sequence numbers must be assigned in queue order, so buffer
+    // slices have to be retired while holding the lock. This is
+    // done here rather than on completion so that the finish
+    // thread does not have to touch any buffers.
+    entry.submit.cmdList->retireBufferSlices(entry.sequenceNumber);
 
     m_pending += 1;
+    m_queueDepth += m_submitQueue.size();
     m_submitQueue.push(std::move(entry));
     m_appendCond.notify_all();
   }
@@ -49,6 +62,7 @@ namespace dxvk {
     DxvkSubmitEntry entry = { };
     entry.status  = status;
     entry.present = std::move(presentInfo);
+    entry.queueTime = dxvk::high_resolution_clock::now();
 
     m_submitQueue.push(std::move(entry));
     m_appendCond.notify_all();
@@ -115,10 +129,14 @@ namespace dxvk {
         if (m_callback)
           m_callback(true);
 
-        if (entry.submit.cmdList != nullptr)
+        if (entry.submit.cmdList != nullptr) {
+          DxvkTraceScope zone(m_device->tracer(), "Submit");
           status = entry.submit.cmdList->submit();
-        else if (entry.present.presenter != nullptr)
-          status = entry.present.presenter->presentImage();
+        } else if (entry.present.presenter != nullptr) {
+          DxvkTraceScope zone(m_device->tracer(), "Present");
+          status = entry.present.presenter->presentImage(
+            entry.present.signal, entry.present.signalValue);
+        }
 
         if (m_callback)
           m_callback(false);
@@ -130,6 +148,9 @@ namespace dxvk {
 
       if (entry.status)
         entry.status->result = status;
+
+      auto t1 = dxvk::high_resolution_clock::now();
+      m_submitLatency += std::chrono::duration_cast<std::chrono::microseconds>(t1 - entry.queueTime).count();
       
       // On success, pass it on to the queue thread
       lock = std::unique_lock<dxvk::mutex>(m_mutex);
@@ -174,14 +195,26 @@ namespace dxvk {
       
       VkResult status = m_lastError.load();
       
-      if (status != VK_ERROR_DEVICE_LOST)
+      if (status != VK_ERROR_DEVICE_LOST) {
+        DxvkTraceScope zone(m_device->tracer(), "Wait for GPU");
         status = entry.submit.cmdList->synchronizeFence();
+      }
       
       if (status != VK_SUCCESS) {
         m_lastError = status;
         m_device->waitForIdle();
       }
 
+      m_completedSequence.store(entry.sequenceNumber, std::memory_order_release);
+
+      if (status == VK_SUCCESS) {
+        if (unlikely(m_device->tracer()))
+          m_device->tracer()->resolveGpuZones();
+
+        if (unlikely(m_device->gpuProfiler().isEnabled()))
+          m_device->gpuProfiler().resolvePasses();
+      }
+
       // Release resources and signal events, then immediately wake
       // up any thread that's currently waiting on a resource in
       // order to reduce delays as much as possible.
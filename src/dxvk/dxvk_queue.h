@@ -5,6 +5,7 @@
 #include <queue>
 
 #include "../util/thread.h"
+#include "../util/util_time.h"
 
 #include "../vulkan/vulkan_presenter.h"
 
@@ -44,6 +45,8 @@ namespace dxvk {
    */
   struct DxvkPresentInfo {
     Rc<vk::Presenter>   presenter;
+    Rc<sync::Signal>    signal;
+    uint64_t            signalValue = 0;
   };
 
 
@@ -54,6 +57,8 @@ namespace dxvk {
     DxvkSubmitStatus*   status;
     DxvkSubmitInfo      submit;
     DxvkPresentInfo     present;
+    uint64_t            sequenceNumber;
+    dxvk::high_resolution_clock::time_point queueTime;
   };
 
 
@@ -93,6 +98,44 @@ namespace dxvk {
       return m_gpuIdle.load();
     }
 
+    /**
+     * \brief Retrieves accumulated submission latency
+     *
+     * Monotonically increasing counter that measures how long
+     * queue entries spent waiting for the submission thread,
+     * including the time spent in the submission itself.
+     * \returns Accumulated submission latency, in us
+     */
+    uint64_t submitLatencyTicks() const {
+      return m_submitLatency.load();
+    }
+
+    /**
+     * \brief Retrieves accumulated queue depth
+     *
+     * Monotonically increasing counter that is incremented
+     * by the number of entries already in the queue every
+     * time a new entry is added. Divided by the number of
+     * submissions, this yields the average queue depth.
+     * \returns Accumulated queue depth
+     */
+    uint64_t queueDepthSum() const {
+      return m_queueDepth.load();
+    }
+
+    /**
+     * \brief Retrieves last completed sequence number
+     *
+     * Each command list submission is assigned a sequence number
+     * in submission order. Since submissions complete in order,
+     * all submissions up to and including the returned sequence
+     * number have finished executing on the GPU.
+     * \returns Sequence number of the last completed submission
+     */
+    uint64_t completedSequenceNumber() const {
+      return m_completedSequence.load(std::memory_order_acquire);
+    }
+
     /**
      * \brief Retrieves last submission error
      * 
@@ -188,6 +231,11 @@ namespace dxvk {
     std::atomic<bool>           m_stopped = { false };
     std::atomic<uint32_t>       m_pending = { 0u };
     std::atomic<uint64_t>       m_gpuIdle = { 0ull };
+    std::atomic<uint64_t>       m_submitLatency = { 0ull };
+    std::atomic<uint64_t>       m_queueDepth = { 0ull };
+
+    uint64_t                    m_submitSequence = 0ull;
+    std::atomic<uint64_t>       m_completedSequence = { 0ull };
 
     dxvk::mutex                 m_mutex;
     dxvk::mutex                 m_mutexQueue;
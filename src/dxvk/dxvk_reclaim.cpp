@@ -0,0 +1,115 @@
+#include "dxvk_reclaim.h"
+
+namespace dxvk {
+
+  DxvkObjectReclaimer::DxvkObjectReclaimer(
+    const Rc<vk::DeviceFn>&           vkd,
+          bool                        enable)
+  : m_vkd(vkd) {
+    if (enable)
+      m_thread = dxvk::thread([this] () { runWorker(); });
+  }
+
+
+  DxvkObjectReclaimer::~DxvkObjectReclaimer() {
+    if (m_thread.joinable()) {
+      { std::unique_lock<dxvk::mutex> lock(m_mutex);
+        m_stopped.store(true);
+      }
+
+      m_cond.notify_all();
+      m_thread.join();
+    }
+
+    for (const auto& entry : m_entries)
+      destroyObject(entry);
+  }
+
+
+  void DxvkObjectReclaimer::notifyFrame() {
+    if (!m_thread.joinable())
+      return;
+
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    if (!m_entries.empty()) {
+      m_wakeup = true;
+      m_cond.notify_one();
+    }
+  }
+
+
+  void DxvkObjectReclaimer::reclaim(
+    const DxvkReclaimEntry&           entry) {
+    if (!m_thread.joinable() || m_stopped.load()) {
+      destroyObject(entry);
+      return;
+    }
+
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+    m_entries.push_back(entry);
+
+    // Don't let the queue grow indefinitely if the
+    // application does not present for a long time
+    if (m_entries.size() >= BatchSize && !m_wakeup) {
+      m_wakeup = true;
+      m_cond.notify_one();
+    }
+  }
+
+
+  void DxvkObjectReclaimer::destroyObject(
+    const DxvkReclaimEntry&           entry) {
+    switch (entry.type) {
+      case DxvkReclaimType::Buffer:
+        m_vkd->vkDestroyBuffer(m_vkd->device(), entry.buffer, nullptr);
+        break;
+
+      case DxvkReclaimType::BufferView:
+        m_vkd->vkDestroyBufferView(m_vkd->device(), entry.bufferView, nullptr);
+        break;
+
+      case DxvkReclaimType::Image:
+        m_vkd->vkDestroyImage(m_vkd->device(), entry.image, nullptr);
+        break;
+
+      case DxvkReclaimType::ImageView:
+        m_vkd->vkDestroyImageView(m_vkd->device(), entry.imageView, nullptr);
+        break;
+
+      case DxvkReclaimType::Memory:
+        m_vkd->vkFreeMemory(m_vkd->device(), entry.memory, nullptr);
+        break;
+    }
+  }
+
+
+  void DxvkObjectReclaimer::runWorker() {
+    env::setThreadName("dxvk-reclaim");
+
+    std::vector<DxvkReclaimEntry> entries;
+
+    while (true) {
+      { std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+        m_cond.wait(lock, [this] {
+          return m_wakeup || m_stopped.load();
+        });
+
+        if (m_stopped.load())
+          return;
+
+        entries.swap(m_entries);
+        m_wakeup = false;
+      }
+
+      // Objects must be destroyed in release order, e.g.
+      // an image must be destroyed before its memory
+      for (const auto& entry : entries)
+        destroyObject(entry);
+
+      entries.clear();
+    }
+  }
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "../util/thread.h"
+
+#include "dxvk_include.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Reclaimed object type
+   */
+  enum class DxvkReclaimType : uint32_t {
+    Buffer,
+    BufferView,
+    Image,
+    ImageView,
+    Memory,
+  };
+
+
+  /**
+   * \brief Reclaimed object
+   *
+   * Stores a Vulkan handle along with its type.
+   */
+  struct DxvkReclaimEntry {
+    DxvkReclaimType   type;
+
+    union {
+      VkBuffer        buffer;
+      VkBufferView    bufferView;
+      VkImage         image;
+      VkImageView     imageView;
+      VkDeviceMemory  memory;
+    };
+  };
+
+
+  /**
+   * \brief Object reclaimer
+   *
+   * Destroys Vulkan objects and frees device memory on a
+   * dedicated worker thread, since some drivers spend a
+   * significant amount of time in \c vkFreeMemory and the
+   * like. Objects are queued up and destroyed in batches,
+   * either once per frame or when enough objects are
+   * pending, in the order in which they were released.
+   *
+   * All objects passed to the reclaimer must no longer be
+   * in use by the GPU. If deferred destruction is disabled,
+   * objects are destroyed immediately.
+   */
+  class DxvkObjectReclaimer {
+
+  public:
+
+    DxvkObjectReclaimer(
+      const Rc<vk::DeviceFn>&           vkd,
+            bool                        enable);
+
+    ~DxvkObjectReclaimer();
+
+    /**
+     * \brief Destroys a buffer
+     * \param [in] buffer Buffer handle
+     */
+    void destroyBuffer(VkBuffer buffer) {
+      if (buffer == VK_NULL_HANDLE)
+        return;
+
+      DxvkReclaimEntry entry;
+      entry.type = DxvkReclaimType::Buffer;
+      entry.buffer = buffer;
+      reclaim(entry);
+    }
+
+    /**
+     * \brief Destroys a buffer view
+     * \param [in] bufferView Buffer view handle
+     */
+    void destroyBufferView(VkBufferView bufferView) {
+      if (bufferView == VK_NULL_HANDLE)
+        return;
+
+      DxvkReclaimEntry entry;
+      entry.type = DxvkReclaimType::BufferView;
+      entry.bufferView = bufferView;
+      reclaim(entry);
+    }
+
+    /**
+     * \brief Destroys an image
+     * \param [in] image Image handle
+     */
+    void destroyImage(VkImage image) {
+      if (image == VK_NULL_HANDLE)
+        return;
+
+      DxvkReclaimEntry entry;
+      entry.type = DxvkReclaimType::Image;
+      entry.image = image;
+      reclaim(entry);
+    }
+
+    /**
+     * \brief Destroys an image view
+     * \param [in] imageView Image view handle
+     */
+    void destroyImageView(VkImageView imageView) {
+      if (imageView == VK_NULL_HANDLE)
+        return;
+
+      DxvkReclaimEntry entry;
+      entry.type = DxvkReclaimType::ImageView;
+      entry.imageView = imageView;
+      reclaim(entry);
+    }
+
+    /**
+     * \brief Frees device memory
+     * \param [in] memory Memory handle
+     */
+    void freeMemory(VkDeviceMemory memory) {
+      if (memory == VK_NULL_HANDLE)
+        return;
+
+      DxvkReclaimEntry entry;
+      entry.type = DxvkReclaimType::Memory;
+      entry.memory = memory;
+      reclaim(entry);
+    }
+
+    /**
+     * \brief Notifies the reclaimer about a new frame
+     *
+     * Wakes up the worker thread so that all objects
+     * released during the previous frame get destroyed.
+     */
+    void notifyFrame();
+
+  private:
+
+    constexpr static size_t BatchSize = 256;
+
+    Rc<vk::DeviceFn>                m_vkd;
+
+    std::atomic<bool>               m_stopped = { false };
+    bool                            m_wakeup  = false;
+
+    dxvk::mutex                     m_mutex;
+    dxvk::condition_variable        m_cond;
+    std::vector<DxvkReclaimEntry>   m_entries;
+
+    dxvk::thread                    m_thread;
+
+    void reclaim(
+      const DxvkReclaimEntry&           entry);
+
+    void destroyObject(
+      const DxvkReclaimEntry&           entry);
+
+    void runWorker();
+
+  };
+
+}
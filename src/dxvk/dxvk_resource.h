@@ -64,6 +64,25 @@ namespace dxvk {
       return release(DxvkAccess::None);
     }
 
+    /**
+     * \brief Increments reference count if the object is alive
+     *
+     * Used to look up objects from caches that do not own a
+     * reference. Fails if the reference count already dropped
+     * to zero, since the object is being destroyed in that case.
+     * \returns \c true if a reference was acquired
+     */
+    bool tryIncRef() {
+      uint64_t value = m_useCount.load();
+
+      do {
+        if (!(value & RefcountMask))
+          return false;
+      } while (!m_useCount.compare_exchange_weak(value, value + RefcountInc));
+
+      return true;
+    }
+
     /**
      * \brief Acquires resource with given access
      *
@@ -103,6 +122,18 @@ namespace dxvk {
       return bool(m_useCount.load() & mask);
     }
     
+    /**
+     * \brief Checks whether the resource can be reused
+     *
+     * Returns \c true if the caller holds the only
+     * reference to the resource and there are no
+     * pending GPU accesses of any kind.
+     * \returns \c true if the resource is unused
+     */
+    bool isExclusive() const {
+      return m_useCount.load() == RefcountInc;
+    }
+
     /**
      * \brief Waits for resource to become unused
      *
@@ -115,11 +146,59 @@ namespace dxvk {
         return !isInUse(access);
       });
     }
+
+    /**
+     * \brief Marks resource as tracked by a lifetime tracker
+     *
+     * Used to skip redundant tracking of the same resource within
+     * a single command list. Write access implies read access,
+     * and both imply keeping the resource alive. Concurrent use
+     * from multiple trackers can only cause redundant tracking,
+     * never missing tracking, since the stamp is only trusted if
+     * it matches the calling tracker's unique ID.
+     * \param [in] trackerId Unique ID of the tracker
+     * \param [in] access Access type to track
+     * \returns \c true if the resource needs to be tracked
+     */
+    bool markTracked(uint64_t trackerId, DxvkAccess access) {
+      uint64_t level = getTrackingLevel(access);
+      uint64_t stamp = m_trackStamp.load(std::memory_order_relaxed);
+
+      if ((stamp >> 2) == trackerId) {
+        if ((stamp & 0x3) >= level)
+          return false;
+      }
+
+      m_trackStamp.store((trackerId << 2) | level, std::memory_order_relaxed);
+      return true;
+    }
+
+    /**
+     * \brief Checks whether resource was tracked by a tracker
+     *
+     * \param [in] trackerId Unique ID of the tracker
+     * \returns \c true if the most recent tracking
+     *    stamp belongs to the given tracker
+     */
+    bool isTracked(uint64_t trackerId) const {
+      return (m_trackStamp.load(std::memory_order_relaxed) >> 2) == trackerId;
+    }
     
   private:
     
     std::atomic<uint64_t> m_useCount;
     uint64_t              m_cookie;
+    std::atomic<uint64_t> m_trackStamp = { 0ull };
+
+    static constexpr uint64_t getTrackingLevel(DxvkAccess access) {
+      switch (access) {
+        case DxvkAccess::None:  return 1;
+        case DxvkAccess::Read:  return 2;
+        case DxvkAccess::Write: return 3;
+      }
+
+      return 3;
+    }
 
     static constexpr uint64_t getIncrement(DxvkAccess access) {
       uint64_t increment = RefcountInc;
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "dxvk_sampler.h"
 #include "dxvk_device.h"
 
@@ -82,4 +84,116 @@ namespace dxvk {
     return VK_BORDER_COLOR_FLOAT_CUSTOM_EXT;
   }
 
+
+  bool DxvkSamplerCreateInfo::eq(const DxvkSamplerCreateInfo& other) const {
+    return magFilter      == other.magFilter
+        && minFilter      == other.minFilter
+        && mipmapMode     == other.mipmapMode
+        && bit::cast<uint32_t>(mipmapLodBias) == bit::cast<uint32_t>(other.mipmapLodBias)
+        && bit::cast<uint32_t>(mipmapLodMin) == bit::cast<uint32_t>(other.mipmapLodMin)
+        && bit::cast<uint32_t>(mipmapLodMax) == bit::cast<uint32_t>(other.mipmapLodMax)
+        && useAnisotropy  == other.useAnisotropy
+        && bit::cast<uint32_t>(maxAnisotropy) == bit::cast<uint32_t>(other.maxAnisotropy)
+        && addressModeU   == other.addressModeU
+        && addressModeV   == other.addressModeV
+        && addressModeW   == other.addressModeW
+        && compareToDepth == other.compareToDepth
+        && compareOp      == other.compareOp
+        && reductionMode  == other.reductionMode
+        && !std::memcmp(&borderColor, &other.borderColor, sizeof(borderColor))
+        && usePixelCoord  == other.usePixelCoord
+        && nonSeamless    == other.nonSeamless;
+  }
+
+
+  size_t DxvkSamplerCreateInfo::hash() const {
+    DxvkHashState hash;
+    hash.add(uint32_t(magFilter));
+    hash.add(uint32_t(minFilter));
+    hash.add(uint32_t(mipmapMode));
+    hash.add(bit::cast<uint32_t>(mipmapLodBias));
+    hash.add(bit::cast<uint32_t>(mipmapLodMin));
+    hash.add(bit::cast<uint32_t>(mipmapLodMax));
+    hash.add(useAnisotropy);
+    hash.add(bit::cast<uint32_t>(maxAnisotropy));
+    hash.add(uint32_t(addressModeU));
+    hash.add(uint32_t(addressModeV));
+    hash.add(uint32_t(addressModeW));
+    hash.add(compareToDepth);
+    hash.add(uint32_t(compareOp));
+    hash.add(uint32_t(reductionMode));
+
+    for (uint32_t i = 0; i < 4; i++)
+      hash.add(borderColor.uint32[i]);
+
+    hash.add(usePixelCoord);
+    hash.add(nonSeamless);
+    return hash;
+  }
+
+
+  DxvkSamplerPool::DxvkSamplerPool(
+          DxvkDevice*             device)
+  : m_device(device) {
+    // Leave some headroom for samplers that are not
+    // allocated through the pool, e.g. meta objects
+    uint32_t limit = device->properties().core.properties.limits.maxSamplerAllocationCount;
+    m_maxSamplerCount = std::clamp(limit - std::min(limit / 4u, 1024u), 256u, 65536u);
+  }
+
+
+  DxvkSamplerPool::~DxvkSamplerPool() {
+
+  }
+
+
+  Rc<DxvkSampler> DxvkSamplerPool::createSampler(
+    const DxvkSamplerCreateInfo&  info) {
+    std::lock_guard lock(m_mutex);
+
+    auto entry = m_samplers.find(info);
+
+    if (entry != m_samplers.end()) {
+      entry->second.lastUse = ++m_useCounter;
+      return entry->second.sampler;
+    }
+
+    if (m_samplers.size() >= m_maxSamplerCount)
+      evictSamplers();
+
+    Entry& newEntry = m_samplers[info];
+    newEntry.sampler = new DxvkSampler(m_device, info);
+    newEntry.lastUse = ++m_useCounter;
+
+    m_samplerCount.store(m_samplers.size());
+    return newEntry.sampler;
+  }
+
+
+  void DxvkSamplerPool::evictSamplers() {
+    // Only samplers that are referenced by nothing but the pool
+    // itself and are not in use by the GPU can be destroyed
+    std::vector<std::pair<uint64_t, DxvkSamplerCreateInfo>> candidates;
+
+    for (const auto& e : m_samplers) {
+      if (e.second.sampler->isExclusive())
+        candidates.push_back({ e.second.lastUse, e.first });
+    }
+
+    if (candidates.empty())
+      return;
+
+    // Evict the least recently used half of all candidates
+    // so that we do not have to do this on every creation
+    size_t count = (candidates.size() + 1) / 2;
+
+    std::nth_element(candidates.begin(), candidates.begin() + (count - 1), candidates.end(),
+      [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < count; i++)
+      m_samplers.erase(candidates[i].second);
+
+    m_samplerCount.store(m_samplers.size());
+  }
+
 }
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <unordered_map>
+
+#include "../util/thread.h"
+
+#include "dxvk_hash.h"
 #include "dxvk_resource.h"
 
 namespace dxvk {
@@ -44,6 +49,10 @@ namespace dxvk {
 
     /// Enables non seamless cube map filtering
     VkBool32 nonSeamless;
+
+    bool eq(const DxvkSamplerCreateInfo& other) const;
+
+    size_t hash() const;
   };
   
   
@@ -81,5 +90,64 @@ namespace dxvk {
       const DxvkSamplerCreateInfo&  info);
     
   };
+
+
+  /**
+   * \brief Sampler pool
+   *
+   * Deduplicates sampler objects across the entire device, so
+   * that identical sampler descriptions that are created by
+   * different front-end objects share one Vulkan sampler. This
+   * helps stay within the sampler allocation limit of the
+   * device. Samplers that are no longer referenced anywhere
+   * else are kept alive and evicted in LRU order once the
+   * pool grows too large.
+   */
+  class DxvkSamplerPool {
+
+  public:
+
+    DxvkSamplerPool(
+            DxvkDevice*             device);
+
+    ~DxvkSamplerPool();
+
+    /**
+     * \brief Looks up or creates a sampler
+     *
+     * \param [in] info Sampler properties
+     * \returns Sampler object
+     */
+    Rc<DxvkSampler> createSampler(
+      const DxvkSamplerCreateInfo&  info);
+
+    /**
+     * \brief Queries number of live samplers
+     * \returns Number of samplers in the pool
+     */
+    uint32_t getSamplerCount() const {
+      return m_samplerCount.load();
+    }
+
+  private:
+
+    struct Entry {
+      Rc<DxvkSampler> sampler;
+      uint64_t        lastUse = 0ull;
+    };
+
+    DxvkDevice*           m_device;
+    uint32_t              m_maxSamplerCount;
+
+    dxvk::mutex           m_mutex;
+    uint64_t              m_useCounter = 0ull;
+    std::atomic<uint32_t> m_samplerCount = { 0u };
+
+    std::unordered_map<DxvkSamplerCreateInfo,
+      Entry, DxvkHash, DxvkEq> m_samplers;
+
+    void evictSamplers();
+
+  };
   
 }
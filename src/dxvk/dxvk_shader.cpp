@@ -1,6 +1,9 @@
 #include "dxvk_device.h"
 #include "dxvk_pipemanager.h"
 #include "dxvk_shader.h"
+#include "dxvk_shader_cache.h"
+
+#include "../spirv/spirv_optimizer.h"
 
 #include <dxvk_dummy_frag.h>
 
@@ -46,7 +49,7 @@ namespace dxvk {
   DxvkShader::DxvkShader(
     const DxvkShaderCreateInfo&   info,
           SpirvCodeBuffer&&       spirv)
-  : m_info(info), m_code(spirv), m_bindings(info.stage) {
+  : m_info(info), m_bindings(info.stage) {
     m_info.uniformData = nullptr;
     m_info.bindings = nullptr;
 
@@ -73,91 +76,21 @@ namespace dxvk {
       m_info.uniformData = m_uniformData.data();
     }
 
-    // Run an analysis pass over the SPIR-V code to gather some
-    // info that we may need during pipeline compilation.
-    std::vector<BindingOffsets> bindingOffsets;
-    std::vector<uint32_t> varIds;
-
-    SpirvCodeBuffer code = std::move(spirv);
-    uint32_t o1VarId = 0;
-    
-    for (auto ins : code) {
-      if (ins.opCode() == spv::OpDecorate) {
-        if (ins.arg(2) == spv::DecorationBinding) {
-          uint32_t varId = ins.arg(1);
-          bindingOffsets.resize(std::max(bindingOffsets.size(), size_t(varId + 1)));
-          bindingOffsets[varId].bindingId = ins.arg(3);
-          bindingOffsets[varId].bindingOffset = ins.offset() + 3;
-          varIds.push_back(varId);
-        }
-
-        if (ins.arg(2) == spv::DecorationBuiltIn) {
-          if (ins.arg(3) == spv::BuiltInPosition)
-            m_flags.set(DxvkShaderFlag::ExportsPosition);
-        }
-
-        if (ins.arg(2) == spv::DecorationDescriptorSet) {
-          uint32_t varId = ins.arg(1);
-          bindingOffsets.resize(std::max(bindingOffsets.size(), size_t(varId + 1)));
-          bindingOffsets[varId].setOffset = ins.offset() + 3;
-        }
-
-        if (ins.arg(2) == spv::DecorationSpecId) {
-          if (ins.arg(3) <= MaxNumSpecConstants)
-            m_specConstantMask |= 1u << ins.arg(3);
-        }
-
-        if (ins.arg(2) == spv::DecorationLocation && ins.arg(3) == 1) {
-          m_o1LocOffset = ins.offset() + 3;
-          o1VarId = ins.arg(1);
-        }
-        
-        if (ins.arg(2) == spv::DecorationIndex && ins.arg(1) == o1VarId)
-          m_o1IdxOffset = ins.offset() + 3;
-      }
-
-      if (ins.opCode() == spv::OpMemberDecorate) {
-        if (ins.arg(3) == spv::DecorationBuiltIn) {
-          if (ins.arg(4) == spv::BuiltInPosition)
-            m_flags.set(DxvkShaderFlag::ExportsPosition);
-        }
-      }
-
-      if (ins.opCode() == spv::OpExecutionMode) {
-        if (ins.arg(2) == spv::ExecutionModeStencilRefReplacingEXT)
-          m_flags.set(DxvkShaderFlag::ExportsStencilRef);
-
-        if (ins.arg(2) == spv::ExecutionModeXfb)
-          m_flags.set(DxvkShaderFlag::HasTransformFeedback);
-      }
-
-      if (ins.opCode() == spv::OpCapability) {
-        if (ins.arg(1) == spv::CapabilitySampleRateShading)
-          m_flags.set(DxvkShaderFlag::HasSampleRateShading);
-
-        if (ins.arg(1) == spv::CapabilityShaderViewportIndex
-         || ins.arg(1) == spv::CapabilityShaderLayer)
-          m_flags.set(DxvkShaderFlag::ExportsViewportIndexLayerFromVertexStage);
-
-        if (ins.arg(1) == spv::CapabilitySparseResidency)
-          m_flags.set(DxvkShaderFlag::UsesSparseResidency);
+    // Clean up redundant code once, so that all pipelines
+    // created from this shader use the optimized code.
+    SpirvOptimizer optimizer(spirv);
+    optimizer.run();
 
-        if (ins.arg(1) == spv::CapabilityFragmentFullyCoveredEXT)
-          m_flags.set(DxvkShaderFlag::UsesFragmentCoverage);
-      }
-
-      // Ignore the actual shader code, there's nothing interesting for us in there.
-      if (ins.opCode() == spv::OpFunction)
-        break;
-    }
+    SpirvCodeBuffer code = optimizer.getCode();
+    CodeInfo codeInfo = analyzeCode(code);
 
-    // Combine spec constant IDs with other binding info
-    for (auto varId : varIds) {
-      BindingOffsets info = bindingOffsets[varId];
+    m_flags = codeInfo.flags;
+    m_specConstantMask = codeInfo.specConstantMask;
+    m_o1IdxOffset = codeInfo.o1IdxOffset;
+    m_o1LocOffset = codeInfo.o1LocOffset;
+    m_bindingOffsets = std::move(codeInfo.bindingOffsets);
 
-      if (info.bindingOffset)
-        m_bindingOffsets.push_back(info);
-    }
+    m_code = SpirvCompressedBuffer(code);
 
     // Don't set pipeline library flag if the shader
     // doesn't actually support pipeline libraries
@@ -166,18 +99,34 @@ namespace dxvk {
 
 
   DxvkShader::~DxvkShader() {
-    
+    // The cache only holds a non-owning reference, make
+    // sure it does not touch this shader after this point
+    if (m_codeSource)
+      m_codeSource->removeEvictable(this);
   }
   
   
   SpirvCodeBuffer DxvkShader::getCode(
     const DxvkBindingLayoutObjects*   layout,
     const DxvkShaderModuleCreateInfo& state) const {
+    // Take a consistent snapshot of the code and the offsets
+    // into it, since the code may be replaced at runtime
+    std::unique_lock lock(m_codeMutex);
+
+    if (!restoreCodeLocked())
+      return SpirvCodeBuffer();
+
     SpirvCodeBuffer spirvCode = m_code.decompress();
+    std::vector<BindingOffsets> bindingOffsets = m_bindingOffsets;
+
+    size_t o1IdxOffset = m_o1IdxOffset;
+    size_t o1LocOffset = m_o1LocOffset;
+    lock.unlock();
+
     uint32_t* code = spirvCode.data();
     
     // Remap resource binding IDs
-    for (const auto& info : m_bindingOffsets) {
+    for (const auto& info : bindingOffsets) {
       auto mappedBinding = layout->lookupBinding(m_info.stage, info.bindingId);
 
       if (mappedBinding) {
@@ -190,8 +139,8 @@ namespace dxvk {
 
     // For dual-source blending we need to re-map
     // location 1, index 0 to location 0, index 1
-    if (state.fsDualSrcBlend && m_o1IdxOffset && m_o1LocOffset)
-      std::swap(code[m_o1IdxOffset], code[m_o1LocOffset]);
+    if (state.fsDualSrcBlend && o1IdxOffset && o1LocOffset)
+      std::swap(code[o1IdxOffset], code[o1LocOffset]);
     
     // Replace undefined input variables with zero
     for (uint32_t u : bit::BitMask(state.undefinedInputs))
@@ -244,8 +193,196 @@ namespace dxvk {
   }
 
 
+  void DxvkShader::setCodeSource(
+          DxvkShaderCache*          cache,
+    const Sha1Hash&                 compileHash) {
+    std::lock_guard lock(m_codeMutex);
+    m_codeSource = cache;
+    m_codeCompileHash = compileHash;
+    m_codeLastUse = cache->getFrameId();
+  }
+
+
+  size_t DxvkShader::evictCode(
+          uint64_t                  frameId,
+          uint64_t                  maxAge) {
+    std::lock_guard lock(m_codeMutex);
+
+    if (!m_codeSource || m_codePinned || m_code.empty() || m_codeLastUse + maxAge > frameId)
+      return 0;
+
+    // Never free code that cannot be read back, the
+    // shader would be unusable for any new pipelines
+    if (!m_codeSource->verifyShaderCode(m_key, m_codeCompileHash, m_code)) {
+      Logger::warn(str::format("DxvkShader: Cache entry for ", debugName(), " unusable, not evicting code"));
+      m_codePinned = true;
+      return 0;
+    }
+
+    size_t size = m_code.data().size() * sizeof(uint32_t);
+    m_code.release();
+    return size;
+  }
+
+
+  bool DxvkShader::replaceCode(
+          SpirvCodeBuffer&&         spirv) {
+    CodeInfo codeInfo = analyzeCode(spirv);
+
+    // Pipelines query flags and spec constants on creation, so
+    // the replacement code must not change either of those
+    if (codeInfo.flags != m_flags || codeInfo.specConstantMask != m_specConstantMask)
+      return false;
+
+    std::unique_lock lock(m_codeMutex);
+    m_code = SpirvCompressedBuffer(spirv);
+    m_o1IdxOffset = codeInfo.o1IdxOffset;
+    m_o1LocOffset = codeInfo.o1LocOffset;
+    m_bindingOffsets = std::move(codeInfo.bindingOffsets);
+
+    // The shader cache only stores the translated code,
+    // so the replacement code must never be evicted
+    DxvkShaderCache* codeSource = std::exchange(m_codeSource, nullptr);
+
+    // Any existing pipeline library uses the old code
+    m_libraryReady.store(false);
+    m_needsLibraryCompile.store(canUsePipelineLibrary(true));
+    lock.unlock();
+
+    // The cache locks the code mutex while evicting code,
+    // so the shader must be unregistered without holding it
+    if (codeSource)
+      codeSource->removeEvictable(this);
+
+    return true;
+  }
+
+
   void DxvkShader::dump(std::ostream& outputStream) const {
-    m_code.decompress().store(outputStream);
+    decompressCode().store(outputStream);
+  }
+
+
+  SpirvCodeBuffer DxvkShader::decompressCode() const {
+    std::lock_guard lock(m_codeMutex);
+
+    if (!restoreCodeLocked())
+      return SpirvCodeBuffer();
+
+    return m_code.decompress();
+  }
+
+
+  bool DxvkShader::restoreCodeLocked() const {
+    if (!m_codeSource)
+      return true;
+
+    m_codeLastUse = m_codeSource->getFrameId();
+
+    if (likely(!m_code.empty()))
+      return true;
+
+    // This runs on worker threads, so do not throw. Code is only
+    // evicted after verifying the cache entry, so this can only
+    // fail if the cache file got modified or became unreadable.
+    if (!m_codeSource->loadShaderCode(m_key, m_codeCompileHash, m_code)) {
+      Logger::err(str::format("DxvkShader: Failed to reload code for ", debugName()));
+      return false;
+    }
+
+    return true;
+  }
+
+
+  DxvkShader::CodeInfo DxvkShader::analyzeCode(
+          SpirvCodeBuffer&          code) {
+    // Run an analysis pass over the SPIR-V code to gather some
+    // info that we may need during pipeline compilation.
+    std::vector<BindingOffsets> bindingOffsets;
+    std::vector<uint32_t> varIds;
+
+    CodeInfo result;
+    uint32_t o1VarId = 0;
+    
+    for (auto ins : code) {
+      if (ins.opCode() == spv::OpDecorate) {
+        if (ins.arg(2) == spv::DecorationBinding) {
+          uint32_t varId = ins.arg(1);
+          bindingOffsets.resize(std::max(bindingOffsets.size(), size_t(varId + 1)));
+          bindingOffsets[varId].bindingId = ins.arg(3);
+          bindingOffsets[varId].bindingOffset = ins.offset() + 3;
+          varIds.push_back(varId);
+        }
+
+        if (ins.arg(2) == spv::DecorationBuiltIn) {
+          if (ins.arg(3) == spv::BuiltInPosition)
+            result.flags.set(DxvkShaderFlag::ExportsPosition);
+        }
+
+        if (ins.arg(2) == spv::DecorationDescriptorSet) {
+          uint32_t varId = ins.arg(1);
+          bindingOffsets.resize(std::max(bindingOffsets.size(), size_t(varId + 1)));
+          bindingOffsets[varId].setOffset = ins.offset() + 3;
+        }
+
+        if (ins.arg(2) == spv::DecorationSpecId) {
+          if (ins.arg(3) <= MaxNumSpecConstants)
+            result.specConstantMask |= 1u << ins.arg(3);
+        }
+
+        if (ins.arg(2) == spv::DecorationLocation && ins.arg(3) == 1) {
+          result.o1LocOffset = ins.offset() + 3;
+          o1VarId = ins.arg(1);
+        }
+        
+        if (ins.arg(2) == spv::DecorationIndex && ins.arg(1) == o1VarId)
+          result.o1IdxOffset = ins.offset() + 3;
+      }
+
+      if (ins.opCode() == spv::OpMemberDecorate) {
+        if (ins.arg(3) == spv::DecorationBuiltIn) {
+          if (ins.arg(4) == spv::BuiltInPosition)
+            result.flags.set(DxvkShaderFlag::ExportsPosition);
+        }
+      }
+
+      if (ins.opCode() == spv::OpExecutionMode) {
+        if (ins.arg(2) == spv::ExecutionModeStencilRefReplacingEXT)
+          result.flags.set(DxvkShaderFlag::ExportsStencilRef);
+
+        if (ins.arg(2) == spv::ExecutionModeXfb)
+          result.flags.set(DxvkShaderFlag::HasTransformFeedback);
+      }
+
+      if (ins.opCode() == spv::OpCapability) {
+        if (ins.arg(1) == spv::CapabilitySampleRateShading)
+          result.flags.set(DxvkShaderFlag::HasSampleRateShading);
+
+        if (ins.arg(1) == spv::CapabilityShaderViewportIndex
+         || ins.arg(1) == spv::CapabilityShaderLayer)
+          result.flags.set(DxvkShaderFlag::ExportsViewportIndexLayerFromVertexStage);
+
+        if (ins.arg(1) == spv::CapabilitySparseResidency)
+          result.flags.set(DxvkShaderFlag::UsesSparseResidency);
+
+        if (ins.arg(1) == spv::CapabilityFragmentFullyCoveredEXT)
+          result.flags.set(DxvkShaderFlag::UsesFragmentCoverage);
+      }
+
+      // Ignore the actual shader code, there's nothing interesting for us in there.
+      if (ins.opCode() == spv::OpFunction)
+        break;
+    }
+
+    // Combine spec constant IDs with other binding info
+    for (auto varId : varIds) {
+      BindingOffsets info = bindingOffsets[varId];
+
+      if (info.bindingOffset)
+        result.bindingOffsets.push_back(info);
+    }
+
+    return result;
   }
 
 
@@ -837,8 +974,11 @@ namespace dxvk {
     moduleInfo.codeSize = codeBuffer.size();
     moduleInfo.pCode = codeBuffer.data();
 
+    if (!codeBuffer.size())
+      m_valid = false;
+
     VkShaderModule shaderModule = VK_NULL_HANDLE;
-    if (!m_device->features().extGraphicsPipelineLibrary.graphicsPipelineLibrary) {
+    if (m_valid && !m_device->features().extGraphicsPipelineLibrary.graphicsPipelineLibrary) {
       auto vk = m_device->vkd();
 
       if (vk->vkCreateShaderModule(vk->device(), &moduleInfo, nullptr, &shaderModule))
@@ -1096,6 +1236,7 @@ namespace dxvk {
     // try to get a cache hit using the shader module identifier
     // so that we don't have to decompress our SPIR-V shader again.
     VkPipeline pipeline = VK_NULL_HANDLE;
+    auto t0 = high_resolution_clock::now();
 
     if (m_compiledOnce && canUsePipelineCacheControl()) {
       pipeline = this->compileShaderPipeline(args,
@@ -1109,6 +1250,15 @@ namespace dxvk {
     if (!pipeline)
       return VK_NULL_HANDLE;
 
+    std::array<const DxvkShader*, 6> shaders = {
+      m_shaders.vs, m_shaders.tcs, m_shaders.tes,
+      m_shaders.gs, m_shaders.fs, m_shaders.cs };
+
+    m_stats->addCompileTime(m_shaders.cs
+        ? DxvkPipelineCompileType::Compute
+        : DxvkPipelineCompileType::Library,
+      shaders.size(), shaders.data(), t0);
+
     // Increment stat counter the first time this
     // shader pipeline gets compiled successfully
     if (!m_compiledOnce) {
@@ -1118,6 +1268,8 @@ namespace dxvk {
         m_stats->numGraphicsLibraries += 1;
 
       m_compiledOnce = true;
+
+      this->notifyLibraryReady();
     }
 
     return pipeline;
@@ -1158,6 +1310,12 @@ namespace dxvk {
       }
     }
 
+    if (!stageInfo.isValid())
+      return VK_NULL_HANDLE;
+
+    if (m_device->canUseDescriptorBuffer())
+      flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
     if (stageMask & VK_SHADER_STAGE_VERTEX_BIT)
       return compileVertexShaderPipeline(args, stageInfo, flags);
 
@@ -1381,7 +1539,7 @@ namespace dxvk {
     const SpirvCodeBuffer&              spirvCode) {
     auto vk = m_device->vkd();
 
-    if (!canUsePipelineCacheControl())
+    if (!canUsePipelineCacheControl() || !spirvCode.size())
       return;
 
     VkShaderModuleCreateInfo info = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
@@ -1487,6 +1645,20 @@ namespace dxvk {
   }
 
 
+  void DxvkShaderPipelineLibrary::notifyLibraryReady() const {
+    if (m_shaders.vs) {
+      if (!m_shaders.tcs && !m_shaders.tes && !m_shaders.gs)
+        m_shaders.vs->notifyLibraryReady();
+    }
+
+    if (m_shaders.fs)
+      m_shaders.fs->notifyLibraryReady();
+
+    if (m_shaders.cs)
+      m_shaders.cs->notifyLibraryReady();
+  }
+
+
   bool DxvkShaderPipelineLibrary::canUsePipelineCacheControl() const {
     const auto& features = m_device->features();
 
@@ -14,6 +14,7 @@
 namespace dxvk {
   
   class DxvkShader;
+  class DxvkShaderCache;
   class DxvkShaderModule;
   class DxvkPipelineManager;
   struct DxvkPipelineStats;
@@ -153,13 +154,84 @@ namespace dxvk {
       m_needsLibraryCompile.store(false);
     }
 
+    /**
+     * \brief Tests whether the pipeline library is ready
+     *
+     * Returns \c true once the shader's standalone pipeline
+     * library has been compiled successfully, so that pipelines
+     * using this shader can be linked without stalling.
+     * \returns \c true if the pipeline library is available
+     */
+    bool isLibraryReady() const {
+      return m_libraryReady.load();
+    }
+
+    /**
+     * \brief Notifies library availability
+     *
+     * Called when the pipeline library has been compiled.
+     * Subsequent calls to \ref isLibraryReady will return
+     * \c true.
+     */
+    void notifyLibraryReady() {
+      m_libraryReady.store(true);
+    }
+
     /**
      * \brief Gets raw code without modification
      */
     SpirvCodeBuffer getRawCode() const {
-      return m_code.decompress();
+      return decompressCode();
     }
 
+    /**
+     * \brief Accesses compressed code
+     *
+     * Reloads the code if it has been evicted, and calls
+     * the given function with the code while holding the
+     * code lock, so that the code does not get copied.
+     * \param [in] proc Function to call with the code
+     * \returns \c false if the code could not be reloaded
+     */
+    template<typename Proc>
+    bool useCompressedCode(const Proc& proc) const {
+      std::lock_guard lock(m_codeMutex);
+
+      if (!restoreCodeLocked())
+        return false;
+
+      proc(m_code);
+      return true;
+    }
+
+    /**
+     * \brief Makes shader code evictable
+     *
+     * Called by the shader cache once the code is stored in
+     * the cache file. The compressed code can then be freed
+     * with \ref evictCode and is read back on demand.
+     * \param [in] cache Shader cache that stores the code
+     * \param [in] compileHash Compile hash of the cache entry
+     */
+    void setCodeSource(
+            DxvkShaderCache*          cache,
+      const Sha1Hash&                 compileHash);
+
+    /**
+     * \brief Frees compressed code if unused
+     *
+     * Code is only freed if the shader cache entry has
+     * been verified to store the same code, otherwise
+     * the code stays resident for the shader lifetime.
+     * \param [in] frameId Current frame ID
+     * \param [in] maxAge Number of frames without use
+     *    after which the code will be freed
+     * \returns Number of bytes freed
+     */
+    size_t evictCode(
+            uint64_t                  frameId,
+            uint64_t                  maxAge);
+
     /**
      * \brief Patches code using given info
      *
@@ -167,7 +239,8 @@ namespace dxvk {
      * parts of the code depending on pipeline state.
      * \param [in] layout Biding layout
      * \param [in] state Pipeline state info
-     * \returns Uncompressed SPIR-V code buffer
+     * \returns Uncompressed SPIR-V code buffer, or an empty
+     *    buffer if evicted code could not be reloaded
      */
     SpirvCodeBuffer getCode(
       const DxvkBindingLayoutObjects*   layout,
@@ -185,6 +258,21 @@ namespace dxvk {
      */
     bool canUsePipelineLibrary(bool standalone) const;
 
+    /**
+     * \brief Replaces shader code
+     *
+     * Used to load replacement SPIR-V from disk. The new code
+     * must use the same bindings as well as the same shader
+     * flags and spec constants as the original code. Pipelines
+     * that have already been created are not affected, and
+     * the replacement code cannot be evicted.
+     * \param [in] spirv Replacement SPIR-V code
+     * \returns \c true on success, \c false if the shader
+     *    interface of the replacement code does not match
+     */
+    bool replaceCode(
+            SpirvCodeBuffer&&         spirv);
+
     /**
      * \brief Dumps SPIR-V shader
      * 
@@ -250,8 +338,22 @@ namespace dxvk {
       uint32_t setOffset;
     };
 
+    struct CodeInfo {
+      DxvkShaderFlags             flags;
+      uint32_t                    specConstantMask = 0;
+      size_t                      o1IdxOffset = 0;
+      size_t                      o1LocOffset = 0;
+      std::vector<BindingOffsets> bindingOffsets;
+    };
+
     DxvkShaderCreateInfo          m_info;
-    SpirvCompressedBuffer         m_code;
+
+    mutable dxvk::mutex           m_codeMutex;
+    mutable SpirvCompressedBuffer m_code;
+    mutable uint64_t              m_codeLastUse = 0;
+    bool                          m_codePinned  = false;
+    DxvkShaderCache*              m_codeSource  = nullptr;
+    Sha1Hash                      m_codeCompileHash;
     
     DxvkShaderFlags               m_flags;
     DxvkShaderKey                 m_key;
@@ -262,12 +364,20 @@ namespace dxvk {
 
     uint32_t                      m_specConstantMask = 0;
     std::atomic<bool>             m_needsLibraryCompile = { true };
+    std::atomic<bool>             m_libraryReady = { false };
 
     std::vector<char>             m_uniformData;
     std::vector<BindingOffsets>   m_bindingOffsets;
 
     DxvkBindingLayout             m_bindings;
 
+    SpirvCodeBuffer decompressCode() const;
+
+    static CodeInfo analyzeCode(
+            SpirvCodeBuffer&          code);
+
+    bool restoreCodeLocked() const;
+
     static void eliminateInput(
             SpirvCodeBuffer&          code,
             uint32_t                  location);
@@ -311,6 +421,17 @@ namespace dxvk {
       return m_stageCount;
     }
 
+    /**
+     * \brief Checks whether all stages have code
+     *
+     * Pipelines must not be compiled otherwise, which
+     * can happen if shader code could not be reloaded.
+     * \returns \c true if no stage has empty code
+     */
+    bool isValid() const {
+      return m_valid;
+    }
+
     /**
      * \brief Queries shader stage infos
      * \returns Pointer to shader stage infos
@@ -361,6 +482,7 @@ namespace dxvk {
     std::array<ShaderModuleInfo,                5>  m_moduleInfos = { };
     std::array<VkPipelineShaderStageCreateInfo, 5>  m_stageInfos  = { };
     uint32_t                                        m_stageCount  = 0;
+    bool                                            m_valid       = true;
 
   };
 
@@ -597,6 +719,8 @@ namespace dxvk {
 
     void notifyLibraryCompile() const;
 
+    void notifyLibraryReady() const;
+
     bool canUsePipelineCacheControl() const;
 
   };
@@ -0,0 +1,621 @@
+#include <version.h>
+
+#include "dxvk_device.h"
+#include "dxvk_shader_cache.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Serialized shader info
+   *
+   * Stores all scalar members of the shader create
+   * info, as well as the size of all variable-size
+   * data that follows it.
+   */
+  struct DxvkShaderCacheShaderInfo {
+    uint32_t stage;
+    uint32_t inputMask;
+    uint32_t outputMask;
+    uint32_t flatShadingInputs;
+    uint32_t pushConstOffset;
+    uint32_t pushConstSize;
+    uint32_t uniformSize;
+    int32_t  xfbRasterizedStream;
+    uint32_t patchVertexCount;
+    uint32_t xfbStrides[MaxNumXfbBuffers];
+    uint32_t bindingCount;
+    uint32_t codeSize;
+    uint32_t compressedSize;
+  };
+
+
+  /**
+   * \brief Shader cache entry data
+   *
+   * Provides bounds-checked serialization
+   * of a single shader cache entry.
+   */
+  class DxvkShaderCacheEntryData {
+
+  public:
+
+    DxvkShaderCacheEntryData() { }
+
+    DxvkShaderCacheEntryData(const std::vector<char>& data)
+    : m_data(data) { }
+
+    const std::vector<char>& data() const {
+      return m_data;
+    }
+
+    template<typename T>
+    void write(const T& data) {
+      write(&data, sizeof(data));
+    }
+
+    void write(const void* data, size_t size) {
+      size_t offset = m_data.size();
+      m_data.resize(offset + size);
+      std::memcpy(&m_data[offset], data, size);
+    }
+
+    template<typename T>
+    bool read(T& data) {
+      return read(&data, sizeof(data));
+    }
+
+    bool read(void* data, size_t size) {
+      if (size > m_data.size() - m_read)
+        return false;
+
+      std::memcpy(data, &m_data[m_read], size);
+      m_read += size;
+      return true;
+    }
+
+  private:
+
+    std::vector<char> m_data;
+    size_t            m_read = 0;
+
+  };
+
+
+  DxvkShaderCache::DxvkShaderCache(
+          DxvkDevice*           device) {
+    std::string useShaderCache = env::getEnvVar("DXVK_SHADER_CACHE");
+    m_enable = useShaderCache != "0" && useShaderCache != "disable" &&
+      device->config().enableStateCache;
+
+    if (!m_enable)
+      return;
+
+    bool newFile = (useShaderCache == "reset") || (!readCacheFile());
+
+    if (newFile) {
+      m_entries.clear();
+      m_readStream.close();
+
+      if (!createCacheFile()) {
+        Logger::warn("DXVK: Failed to create shader cache file");
+        m_enable = false;
+        return;
+      }
+    } else {
+      m_writeStream = std::ofstream(getCacheFileName().c_str(),
+        std::ios_base::binary | std::ios_base::app);
+    }
+
+    // The read stream may have been closed or never opened
+    // successfully, we need it to read back new entries too
+    if (!m_readStream.is_open())
+      m_readStream = std::ifstream(getCacheFileName().c_str(), std::ios_base::binary);
+
+    // Evicting code is mostly useful to save address space
+    switch (device->config().evictShaderCode) {
+      case Tristate::True:  m_evictCode = true; break;
+      case Tristate::False: m_evictCode = false; break;
+      case Tristate::Auto:  m_evictCode = env::is32BitHostPlatform(); break;
+    }
+  }
+
+
+  DxvkShaderCache::~DxvkShaderCache() {
+
+  }
+
+
+  Rc<DxvkShader> DxvkShaderCache::lookupShader(
+    const DxvkShaderKey&        key,
+    const Sha1Hash&             compileHash) {
+    if (!m_enable)
+      return nullptr;
+
+    std::vector<char> data;
+
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      const Entry* entry = findEntry(key, compileHash);
+
+      if (!entry || !readEntryData(key, *entry, data))
+        return nullptr;
+    }
+
+    Rc<DxvkShader> shader = deserializeShader(data);
+
+    if (shader == nullptr)
+      return nullptr;
+
+    shader->setShaderKey(key);
+
+    makeEvictable(shader, compileHash);
+    return shader;
+  }
+
+
+  std::vector<std::pair<DxvkShaderKey, Sha1Hash>> DxvkShaderCache::enumShaders() {
+    std::vector<std::pair<DxvkShaderKey, Sha1Hash>> result;
+
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    result.reserve(m_entries.size());
+
+    for (const auto& e : m_entries)
+      result.emplace_back(e.first, e.second.compileHash);
+
+    return result;
+  }
+
+
+  void DxvkShaderCache::addShader(
+    const Rc<DxvkShader>&       shader,
+    const Sha1Hash&             compileHash) {
+    if (!m_enable)
+      return;
+
+    std::vector<char> data = serializeShader(shader);
+
+    if (data.empty())
+      return;
+
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+    DxvkShaderKey key = shader->getShaderKey();
+
+    if (!m_writeStream)
+      return;
+
+    if (findEntry(key, compileHash)) {
+      lock.unlock();
+
+      makeEvictable(shader, compileHash);
+      return;
+    }
+
+    DxvkShaderCacheEntryHeader header;
+    header.key          = key;
+    header.compileHash  = compileHash;
+    header.dataHash     = Sha1Hash::compute(data.data(), data.size());
+    header.dataSize     = uint32_t(data.size());
+
+    m_writeStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_writeStream.write(data.data(), data.size());
+    m_writeStream.flush();
+
+    if (!m_writeStream) {
+      Logger::warn("DXVK: Failed to write shader cache entry");
+      return;
+    }
+
+    Entry entry;
+    entry.compileHash = header.compileHash;
+    entry.dataHash    = header.dataHash;
+    entry.offset      = m_fileSize + std::streamoff(sizeof(header));
+    entry.size        = header.dataSize;
+
+    m_entries.insert({ key, entry });
+    m_fileSize = entry.offset + std::streamoff(entry.size);
+
+    lock.unlock();
+
+    makeEvictable(shader, compileHash);
+  }
+
+
+  bool DxvkShaderCache::loadShaderCode(
+    const DxvkShaderKey&        key,
+    const Sha1Hash&             compileHash,
+          SpirvCompressedBuffer& code) {
+    { std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+      const Entry* entry = findEntry(key, compileHash);
+
+      if (!entry || !readEntryCode(key, *entry, code))
+        return false;
+    }
+
+    m_evictedShaders -= 1;
+    m_evictedSize -= code.data().size() * sizeof(uint32_t);
+    m_reloadCount += 1;
+    return true;
+  }
+
+
+  bool DxvkShaderCache::verifyShaderCode(
+    const DxvkShaderKey&        key,
+    const Sha1Hash&             compileHash,
+    const SpirvCompressedBuffer& code) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    Entry* entry = findEntry(key, compileHash);
+
+    if (!entry)
+      return false;
+
+    if (entry->verified)
+      return true;
+
+    SpirvCompressedBuffer storedCode;
+
+    if (!readEntryCode(key, *entry, storedCode))
+      return false;
+
+    entry->verified = storedCode.size() == code.size()
+      && storedCode.data() == code.data();
+    return entry->verified;
+  }
+
+
+  void DxvkShaderCache::endFrame() {
+    if (!m_evictCode)
+      return;
+
+    uint64_t frameId = m_frameId.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    if (frameId % EvictionInterval)
+      return;
+
+    std::lock_guard<dxvk::mutex> lock(m_evictMutex);
+
+    for (DxvkShader* shader : m_evictableShaders) {
+      size_t size = shader->evictCode(frameId, EvictionMaxAge);
+
+      if (size) {
+        m_evictedShaders += 1;
+        m_evictedSize += size;
+        m_evictionCount += 1;
+      }
+    }
+  }
+
+
+  DxvkShaderCodeStats DxvkShaderCache::getCodeStats() const {
+    DxvkShaderCodeStats result;
+    result.evictedShaders = m_evictedShaders.load();
+    result.evictedSize    = m_evictedSize.load();
+    result.evictionCount  = m_evictionCount.load();
+    result.reloadCount    = m_reloadCount.load();
+    return result;
+  }
+
+
+  bool DxvkShaderCache::readEntryData(
+    const DxvkShaderKey&        key,
+    const Entry&                entry,
+          std::vector<char>&    data) {
+    // Reset the stream state in case a previous
+    // read hit the end of the file for any reason
+    data.resize(entry.size);
+    m_readStream.clear();
+
+    if (!m_readStream.seekg(entry.offset)
+     || !m_readStream.read(data.data(), data.size()))
+      return false;
+
+    if (Sha1Hash::compute(data.data(), data.size()) != entry.dataHash) {
+      Logger::warn(str::format("DXVK: Invalid shader cache entry for ", key.toString()));
+      return false;
+    }
+
+    return true;
+  }
+
+
+  bool DxvkShaderCache::readEntryCode(
+    const DxvkShaderKey&        key,
+    const Entry&                entry,
+          SpirvCompressedBuffer& code) {
+    std::vector<char> data;
+
+    if (!readEntryData(key, entry, data))
+      return false;
+
+    // Skip everything but the code itself, the remaining
+    // shader info is still present in the shader object
+    DxvkShaderCacheEntryData reader(data);
+    DxvkShaderCacheShaderInfo shaderInfo;
+
+    if (!reader.read(shaderInfo))
+      return false;
+
+    size_t codeOffset = sizeof(shaderInfo)
+      + size_t(shaderInfo.bindingCount) * sizeof(DxvkBindingInfo)
+      + size_t(shaderInfo.uniformSize);
+
+    size_t codeSize = size_t(shaderInfo.compressedSize) * sizeof(uint32_t);
+
+    if (codeOffset + codeSize != data.size())
+      return false;
+
+    std::vector<uint32_t> words(shaderInfo.compressedSize);
+    std::memcpy(words.data(), &data[codeOffset], codeSize);
+
+    code = SpirvCompressedBuffer(shaderInfo.codeSize, std::move(words));
+    return true;
+  }
+
+
+  void DxvkShaderCache::makeEvictable(
+    const Rc<DxvkShader>&       shader,
+    const Sha1Hash&             compileHash) {
+    if (!m_evictCode)
+      return;
+
+    std::lock_guard<dxvk::mutex> lock(m_evictMutex);
+    shader->setCodeSource(this, compileHash);
+
+    m_evictableShaders.insert(shader.ptr());
+  }
+
+
+  void DxvkShaderCache::removeEvictable(
+          DxvkShader*           shader) {
+    std::lock_guard<dxvk::mutex> lock(m_evictMutex);
+    m_evictableShaders.erase(shader);
+  }
+
+
+  DxvkShaderCache::Entry* DxvkShaderCache::findEntry(
+    const DxvkShaderKey&        key,
+    const Sha1Hash&             compileHash) {
+    auto entries = m_entries.equal_range(key);
+
+    for (auto e = entries.first; e != entries.second; e++) {
+      if (e->second.compileHash == compileHash)
+        return &e->second;
+    }
+
+    return nullptr;
+  }
+
+
+  bool DxvkShaderCache::readCacheFile() {
+    m_readStream = std::ifstream(getCacheFileName().c_str(), std::ios_base::binary);
+
+    if (!m_readStream)
+      return false;
+
+    if (!readCacheHeader(m_readStream)) {
+      Logger::warn("DXVK: Shader cache out of date or invalid");
+      return false;
+    }
+
+    // Only read entry headers here in order to build the index,
+    // and use the file size to detect truncated entries, which
+    // may occur if the process got killed while writing.
+    std::streamoff offset = m_readStream.tellg();
+
+    m_readStream.seekg(0, std::ios_base::end);
+    m_fileSize = m_readStream.tellg();
+
+    while (offset < m_fileSize) {
+      DxvkShaderCacheEntryHeader header;
+
+      if (offset + std::streamoff(sizeof(header)) > m_fileSize
+       || !m_readStream.seekg(offset)
+       || !m_readStream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        Logger::warn("DXVK: Failed to read shader cache entry");
+        return false;
+      }
+
+      offset += std::streamoff(sizeof(header));
+
+      if (offset + std::streamoff(header.dataSize) > m_fileSize) {
+        Logger::warn("DXVK: Shader cache entry truncated");
+        return false;
+      }
+
+      Entry entry;
+      entry.compileHash = header.compileHash;
+      entry.dataHash    = header.dataHash;
+      entry.offset      = offset;
+      entry.size        = header.dataSize;
+
+      m_entries.insert({ header.key, entry });
+      offset += std::streamoff(header.dataSize);
+    }
+
+    Logger::info(str::format("DXVK: Found ", m_entries.size(), " shaders in shader cache"));
+    return true;
+  }
+
+
+  bool DxvkShaderCache::readCacheHeader(
+          std::istream&         stream) const {
+    DxvkShaderCacheHeader expected;
+    expected.buildHash = getBuildHash();
+
+    DxvkShaderCacheHeader header;
+
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+      return false;
+
+    for (uint32_t i = 0; i < 4; i++) {
+      if (expected.magic[i] != header.magic[i])
+        return false;
+    }
+
+    return header.version   == expected.version
+        && header.buildHash == expected.buildHash;
+  }
+
+
+  bool DxvkShaderCache::createCacheFile() {
+    m_writeStream = std::ofstream(getCacheFileName().c_str(),
+      std::ios_base::binary | std::ios_base::trunc);
+
+    if (!m_writeStream && env::createDirectory(getCacheDir())) {
+      m_writeStream = std::ofstream(getCacheFileName().c_str(),
+        std::ios_base::binary | std::ios_base::trunc);
+    }
+
+    if (!m_writeStream)
+      return false;
+
+    Logger::warn("DXVK: Creating new shader cache file");
+
+    DxvkShaderCacheHeader header;
+    header.buildHash = getBuildHash();
+
+    m_writeStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_writeStream.flush();
+
+    m_fileSize = std::streamoff(sizeof(header));
+    return bool(m_writeStream);
+  }
+
+
+  Rc<DxvkShader> DxvkShaderCache::cloneShader(
+    const Rc<DxvkShader>&       shader) {
+    Rc<DxvkShader> result = deserializeShader(serializeShader(shader));
+
+    if (result != nullptr)
+      result->setShaderKey(shader->getShaderKey());
+
+    return result;
+  }
+
+
+  std::vector<char> DxvkShaderCache::serializeShader(
+    const Rc<DxvkShader>&       shader) {
+    const DxvkShaderCreateInfo& info = shader->info();
+    const DxvkBindingLayout& bindings = shader->getBindings();
+
+    DxvkShaderCacheEntryData data;
+
+    bool success = shader->useCompressedCode([&] (const SpirvCompressedBuffer& code) {
+      DxvkShaderCacheShaderInfo shaderInfo = { };
+      shaderInfo.stage                = uint32_t(info.stage);
+      shaderInfo.inputMask            = info.inputMask;
+      shaderInfo.outputMask           = info.outputMask;
+      shaderInfo.flatShadingInputs    = info.flatShadingInputs;
+      shaderInfo.pushConstOffset      = info.pushConstOffset;
+      shaderInfo.pushConstSize        = info.pushConstSize;
+      shaderInfo.uniformSize          = info.uniformSize;
+      shaderInfo.xfbRasterizedStream  = info.xfbRasterizedStream;
+      shaderInfo.patchVertexCount     = info.patchVertexCount;
+      shaderInfo.codeSize             = uint32_t(code.size());
+      shaderInfo.compressedSize       = uint32_t(code.data().size());
+
+      for (uint32_t i = 0; i < MaxNumXfbBuffers; i++)
+        shaderInfo.xfbStrides[i] = info.xfbStrides[i];
+
+      for (uint32_t i = 0; i < DxvkDescriptorSets::SetCount; i++)
+        shaderInfo.bindingCount += bindings.getBindingCount(i);
+
+      data.write(shaderInfo);
+
+      for (uint32_t i = 0; i < DxvkDescriptorSets::SetCount; i++) {
+        for (uint32_t j = 0; j < bindings.getBindingCount(i); j++)
+          data.write(bindings.getBinding(i, j));
+      }
+
+      if (info.uniformSize)
+        data.write(info.uniformData, info.uniformSize);
+
+      data.write(code.data().data(), code.data().size() * sizeof(uint32_t));
+    });
+
+    if (!success)
+      return std::vector<char>();
+
+    return data.data();
+  }
+
+
+  Rc<DxvkShader> DxvkShaderCache::deserializeShader(
+    const std::vector<char>&    data) {
+    DxvkShaderCacheEntryData reader(data);
+    DxvkShaderCacheShaderInfo shaderInfo;
+
+    if (!reader.read(shaderInfo))
+      return nullptr;
+
+    // Validate sizes before allocating any memory
+    size_t dataSize = size_t(shaderInfo.bindingCount) * sizeof(DxvkBindingInfo)
+                    + size_t(shaderInfo.uniformSize)
+                    + size_t(shaderInfo.compressedSize) * sizeof(uint32_t);
+
+    if (sizeof(shaderInfo) + dataSize != data.size())
+      return nullptr;
+
+    std::vector<DxvkBindingInfo> bindings(shaderInfo.bindingCount);
+    std::vector<char> uniformData(shaderInfo.uniformSize);
+    std::vector<uint32_t> code(shaderInfo.compressedSize);
+
+    if (!reader.read(bindings.data(), bindings.size() * sizeof(DxvkBindingInfo))
+     || !reader.read(uniformData.data(), uniformData.size())
+     || !reader.read(code.data(), code.size() * sizeof(uint32_t)))
+      return nullptr;
+
+    DxvkShaderCreateInfo info;
+    info.stage                = VkShaderStageFlagBits(shaderInfo.stage);
+    info.bindingCount         = shaderInfo.bindingCount;
+    info.bindings             = bindings.data();
+    info.inputMask            = shaderInfo.inputMask;
+    info.outputMask           = shaderInfo.outputMask;
+    info.flatShadingInputs    = shaderInfo.flatShadingInputs;
+    info.pushConstOffset      = shaderInfo.pushConstOffset;
+    info.pushConstSize        = shaderInfo.pushConstSize;
+    info.uniformSize          = shaderInfo.uniformSize;
+    info.uniformData          = uniformData.data();
+    info.xfbRasterizedStream  = shaderInfo.xfbRasterizedStream;
+    info.patchVertexCount     = shaderInfo.patchVertexCount;
+
+    for (uint32_t i = 0; i < MaxNumXfbBuffers; i++)
+      info.xfbStrides[i] = shaderInfo.xfbStrides[i];
+
+    SpirvCompressedBuffer compressed(shaderInfo.codeSize, std::move(code));
+    return new DxvkShader(info, compressed.decompress());
+  }
+
+
+  Sha1Hash DxvkShaderCache::getBuildHash() {
+    // 32-bit and 64-bit builds may share the same cache
+    // file, nothing else about the host may differ
+    std::string build = str::format(DXVK_VERSION,
+      ":", DxvkShaderCodeRevision, ":", sizeof(void*));
+    return Sha1Hash::compute(build.data(), build.size());
+  }
+
+
+  str::path_string DxvkShaderCache::getCacheFileName() const {
+    std::string path = getCacheDir();
+
+    if (!path.empty() && *path.rbegin() != '/')
+      path += '/';
+
+    std::string exeName = env::getEnvVar("DXVK_STATE_CACHE_NAME");
+
+    if (exeName.empty())
+      exeName = env::getExeBaseName();
+
+    path += exeName + ".dxvk-shaders";
+    return str::topath(path.c_str());
+  }
+
+
+  std::string DxvkShaderCache::getCacheDir() const {
+    return env::getEnvVar("DXVK_STATE_CACHE_PATH");
+  }
+
+}
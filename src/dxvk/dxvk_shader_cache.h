@@ -0,0 +1,281 @@
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "dxvk_shader.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+
+  /**
+   * \brief Shader code revision
+   *
+   * Must be bumped whenever a change to shader processing
+   * within DXVK itself, such as the shader metadata derived
+   * from the SPIR-V code, invalidates cached shaders. Codegen
+   * changes in the compilers are covered by the compile hash.
+   */
+  constexpr uint32_t DxvkShaderCodeRevision = 1;
+
+
+  /**
+   * \brief Shader cache file header
+   *
+   * The build hash is derived from the DXVK version and
+   * shader code revision, so that shaders translated by a
+   * different build never get used, since the generated
+   * code or the shader metadata may have changed. The
+   * version must be bumped whenever the serialized format
+   * changes, including the SPIR-V compression format.
+   */
+  struct DxvkShaderCacheHeader {
+    char     magic[4]   = { 'D', 'X', 'S', 'C' };
+    uint32_t version    = 2;
+    Sha1Hash buildHash;
+  };
+
+
+  /**
+   * \brief Shader cache entry header
+   *
+   * Precedes the serialized shader data. The compile
+   * hash is provided by the client API and identifies
+   * the compiler revision as well as all options that
+   * may affect the generated code.
+   */
+  struct DxvkShaderCacheEntryHeader {
+    DxvkShaderKey key;
+    Sha1Hash      compileHash;
+    Sha1Hash      dataHash;
+    uint32_t      dataSize;
+  };
+
+
+  /**
+   * \brief Shader code eviction stats
+   */
+  struct DxvkShaderCodeStats {
+    uint64_t evictedShaders = 0;  ///< Shaders without resident code
+    uint64_t evictedSize    = 0;  ///< Size of evicted code, in bytes
+    uint64_t evictionCount  = 0;  ///< Total number of evictions
+    uint64_t reloadCount    = 0;  ///< Total number of reloads
+  };
+
+
+  /**
+   * \brief Shader cache
+   *
+   * Stores translated shaders on disk, so that subsequent
+   * runs of the same application do not need to translate
+   * shaders again. Only the index is read when the cache
+   * is created, shader data is loaded on demand.
+   *
+   * The cache is shared among all devices created from
+   * the same adapter, so that shaders added by one device
+   * are visible to all others, and so that the cache file
+   * only ever has one writer within the process.
+   */
+  class DxvkShaderCache : public RcObject {
+
+  public:
+
+    DxvkShaderCache(
+            DxvkDevice*           device);
+
+    ~DxvkShaderCache();
+
+    /**
+     * \brief Looks up a shader
+     *
+     * \param [in] key Shader key
+     * \param [in] compileHash Compile options hash
+     * \returns Shader object, or \c nullptr if the
+     *    shader is not in the cache or is invalid.
+     */
+    Rc<DxvkShader> lookupShader(
+      const DxvkShaderKey&        key,
+      const Sha1Hash&             compileHash);
+
+    /**
+     * \brief Enumerates cached shaders
+     *
+     * \returns Key and compile hash of every shader
+     *    in the cache, in no particular order
+     */
+    std::vector<std::pair<DxvkShaderKey, Sha1Hash>> enumShaders();
+
+    /**
+     * \brief Adds a shader to the cache
+     *
+     * Writes the shader to the cache file if it is
+     * not already present. The shader key must be
+     * set before calling this.
+     * \param [in] shader Newly translated shader
+     * \param [in] compileHash Compile options hash
+     */
+    void addShader(
+      const Rc<DxvkShader>&       shader,
+      const Sha1Hash&             compileHash);
+
+    /**
+     * \brief Creates an independent copy of a shader
+     *
+     * Shader objects carry per-device pipeline state, so
+     * they cannot be shared between devices. The copy
+     * uses the same code, bindings and shader key.
+     * \param [in] shader Shader to copy
+     * \returns New shader object
+     */
+    static Rc<DxvkShader> cloneShader(
+      const Rc<DxvkShader>&       shader);
+
+    /**
+     * \brief Reads compressed code of a cached shader
+     *
+     * Used to restore code of shaders that have
+     * been evicted. Thread-safe.
+     * \param [in] key Shader key
+     * \param [in] compileHash Compile options hash
+     * \param [out] code Compressed code
+     * \returns \c true on success
+     */
+    bool loadShaderCode(
+      const DxvkShaderKey&        key,
+      const Sha1Hash&             compileHash,
+            SpirvCompressedBuffer& code);
+
+    /**
+     * \brief Checks whether code can be reloaded
+     *
+     * Reads back the cache entry and compares the stored code
+     * against resident code. Shaders must only free their code
+     * if this succeeds, since the code is lost otherwise. Each
+     * entry is only read back once. Thread-safe.
+     * \param [in] key Shader key
+     * \param [in] compileHash Compile options hash
+     * \param [in] code Resident compressed code
+     * \returns \c true if the entry stores the same code
+     */
+    bool verifyShaderCode(
+      const DxvkShaderKey&        key,
+      const Sha1Hash&             compileHash,
+      const SpirvCompressedBuffer& code);
+
+    /**
+     * \brief Queries current frame ID
+     *
+     * Used by shaders to stamp their last code use.
+     * \returns Frame ID
+     */
+    uint64_t getFrameId() const {
+      return m_frameId.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Ends a frame
+     *
+     * Periodically frees code of shaders that have not
+     * been used to compile any pipelines for a while.
+     */
+    void endFrame();
+
+    /**
+     * \brief Removes shader from the eviction list
+     *
+     * Must be called before an evictable shader gets
+     * destroyed, or when its code can no longer be
+     * restored from the cache.
+     * \param [in] shader The shader
+     */
+    void removeEvictable(
+            DxvkShader*           shader);
+
+    /**
+     * \brief Queries shader code eviction stats
+     * \returns Eviction stats
+     */
+    DxvkShaderCodeStats getCodeStats() const;
+
+  private:
+
+    /// Interval at which shaders are checked for eviction, in frames
+    constexpr static uint64_t EvictionInterval = 256;
+    /// Number of frames after which unused code can be evicted
+    constexpr static uint64_t EvictionMaxAge   = 3600;
+
+    struct Entry {
+      Sha1Hash        compileHash;
+      Sha1Hash        dataHash;
+      std::streamoff  offset;
+      uint32_t        size;
+      bool            verified = false;
+    };
+
+    bool                              m_enable = false;
+
+    dxvk::mutex                       m_mutex;
+
+    std::unordered_multimap<
+      DxvkShaderKey, Entry,
+      DxvkHash, DxvkEq> m_entries;
+
+    std::ifstream                     m_readStream;
+    std::ofstream                     m_writeStream;
+    std::streamoff                    m_fileSize = 0;
+
+    bool                              m_evictCode = false;
+    std::atomic<uint64_t>             m_frameId = { 0ull };
+
+    dxvk::mutex                       m_evictMutex;
+    std::unordered_set<DxvkShader*>   m_evictableShaders;
+
+    std::atomic<uint64_t>             m_evictedShaders = { 0ull };
+    std::atomic<uint64_t>             m_evictedSize    = { 0ull };
+    std::atomic<uint64_t>             m_evictionCount  = { 0ull };
+    std::atomic<uint64_t>             m_reloadCount    = { 0ull };
+
+    bool readEntryData(
+      const DxvkShaderKey&        key,
+      const Entry&                entry,
+            std::vector<char>&    data);
+
+    bool readEntryCode(
+      const DxvkShaderKey&        key,
+      const Entry&                entry,
+            SpirvCompressedBuffer& code);
+
+    void makeEvictable(
+      const Rc<DxvkShader>&       shader,
+      const Sha1Hash&             compileHash);
+
+    Entry* findEntry(
+      const DxvkShaderKey&        key,
+      const Sha1Hash&             compileHash);
+
+    bool readCacheFile();
+
+    bool readCacheHeader(
+            std::istream&         stream) const;
+
+    bool createCacheFile();
+
+    static std::vector<char> serializeShader(
+      const Rc<DxvkShader>&       shader);
+
+    static Rc<DxvkShader> deserializeShader(
+      const std::vector<char>&    data);
+
+    static Sha1Hash getBuildHash();
+
+    str::path_string getCacheFileName() const;
+
+    std::string getCacheDir() const;
+
+  };
+
+}
@@ -0,0 +1,128 @@
+#include <fstream>
+
+#include "dxvk_shader_override.h"
+
+namespace dxvk {
+
+  DxvkShaderOverrides::DxvkShaderOverrides(
+    const std::string&              path)
+  : m_path    (str::topath(path.c_str())),
+    m_lastPoll(high_resolution_clock::now()) {
+    Logger::info(str::format("DXVK: Loading shader overrides from ", path));
+  }
+
+
+  DxvkShaderOverrides::~DxvkShaderOverrides() {
+
+  }
+
+
+  void DxvkShaderOverrides::registerShader(
+    const Rc<DxvkShader>&           shader) {
+    std::string name = shader->debugName();
+    std::filesystem::path file = m_path / str::topath(str::format(name, ".spv").c_str());
+
+    std::lock_guard lock(m_mutex);
+
+    Entry& entry = m_shaders[name];
+    entry.shader = shader;
+    entry.writeTime = { };
+
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(file, ec);
+
+    if (!ec && applyOverride(entry, file))
+      entry.writeTime = writeTime;
+  }
+
+
+  std::vector<Rc<DxvkShader>> DxvkShaderOverrides::pollChanges() {
+    std::vector<Rc<DxvkShader>> result;
+    std::lock_guard lock(m_mutex);
+
+    auto now = high_resolution_clock::now();
+
+    if (now - m_lastPoll < std::chrono::seconds(1))
+      return result;
+
+    m_lastPoll = now;
+
+    std::error_code ec;
+
+    for (const auto& file : std::filesystem::directory_iterator(m_path, ec)) {
+      if (file.path().extension() != ".spv")
+        continue;
+
+      auto entry = m_shaders.find(file.path().stem().string());
+
+      if (entry == m_shaders.end())
+        continue;
+
+      auto writeTime = file.last_write_time(ec);
+
+      if (ec || writeTime == entry->second.writeTime)
+        continue;
+
+      // Only try once per change, even if the file is invalid,
+      // in order to not spam the log with the same warning
+      entry->second.writeTime = writeTime;
+
+      if (applyOverride(entry->second, file.path()))
+        result.push_back(entry->second.shader);
+    }
+
+    return result;
+  }
+
+
+  bool DxvkShaderOverrides::applyOverride(
+          Entry&                    entry,
+    const std::filesystem::path&    file) {
+    std::string name = entry.shader->debugName();
+    std::ifstream stream(file, std::ios_base::binary);
+
+    if (!stream)
+      return false;
+
+    SpirvCodeBuffer code(stream);
+
+    if (!validateCode(code)) {
+      Logger::warn(str::format("DXVK: Invalid SPIR-V in override for ", name));
+      return false;
+    }
+
+    if (!entry.shader->replaceCode(std::move(code))) {
+      Logger::warn(str::format("DXVK: Shader interface of override for ", name, " does not match"));
+      return false;
+    }
+
+    Logger::info(str::format("DXVK: Replaced code of ", name));
+    return true;
+  }
+
+
+  bool DxvkShaderOverrides::validateCode(
+    const SpirvCodeBuffer&          code) {
+    // A SPIR-V module consists of a five-dword header
+    // followed by a sequence of non-empty instructions
+    const uint32_t* dwords = code.data();
+    uint32_t size = code.dwords();
+
+    if (size < 5 || dwords[0] != spv::MagicNumber)
+      return false;
+
+    uint32_t offset = 5;
+
+    while (offset < size) {
+      uint32_t length = dwords[offset] >> spv::WordCountShift;
+
+      if (!length || length > size - offset)
+        return false;
+
+      offset += length;
+    }
+
+    return true;
+  }
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../util/util_time.h"
+
+#include "dxvk_shader.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Shader overrides
+   *
+   * Replaces the code of registered shaders with SPIR-V
+   * loaded from \c <key>.spv files in the given directory,
+   * where the file name matches the shader's debug name as
+   * used by the shader dump. The directory is scanned for
+   * changed files periodically, so that replacement code
+   * can be edited while the application is running.
+   */
+  class DxvkShaderOverrides {
+
+  public:
+
+    DxvkShaderOverrides(
+      const std::string&              path);
+
+    ~DxvkShaderOverrides();
+
+    /**
+     * \brief Registers a shader
+     *
+     * Applies the override for the given shader if
+     * one exists, and tracks the shader so that the
+     * override can be updated later.
+     * \param [in] shader Newly created shader
+     */
+    void registerShader(
+      const Rc<DxvkShader>&           shader);
+
+    /**
+     * \brief Checks for changed override files
+     *
+     * Rate-limited, so that the directory is only
+     * scanned about once per second.
+     * \returns Shaders whose code has been replaced
+     */
+    std::vector<Rc<DxvkShader>> pollChanges();
+
+  private:
+
+    struct Entry {
+      Rc<DxvkShader>                  shader;
+      std::filesystem::file_time_type writeTime = { };
+    };
+
+    dxvk::mutex                       m_mutex;
+    std::filesystem::path             m_path;
+
+    std::unordered_map<std::string, Entry> m_shaders;
+
+    high_resolution_clock::time_point m_lastPoll;
+
+    bool applyOverride(
+            Entry&                    entry,
+      const std::filesystem::path&    file);
+
+    static bool validateCode(
+      const SpirvCodeBuffer&          code);
+
+  };
+
+}
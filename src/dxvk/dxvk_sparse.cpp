@@ -78,47 +78,71 @@ namespace dxvk {
   }
 
 
-  DxvkSparsePageAllocator::DxvkSparsePageAllocator(
+  DxvkSparsePagePool::DxvkSparsePagePool(
+          DxvkDevice*           device,
           DxvkMemoryAllocator&  memoryAllocator)
-  : m_memory(&memoryAllocator) {
+  : m_memory(&memoryAllocator), m_memoryHints(DxvkMemoryFlag::GpuReadable) {
+    // Sparse buffers get device address usage with descriptor
+    // buffers, so pages must support it as well in that case
+    if (device->canUseDescriptorBuffer())
+      m_memoryHints.set(DxvkMemoryFlag::DeviceAddress);
+
+    VkDeviceSize reservedSize = VkDeviceSize(device->config().sparsePageReserve) << 20;
 
+    m_reservedPages = uint32_t(reservedSize / SparseMemoryPageSize);
+    m_maxFreePages = std::max(m_reservedPages, MaxFreePages);
   }
 
 
-  DxvkSparsePageAllocator::~DxvkSparsePageAllocator() {
+  DxvkSparsePagePool::~DxvkSparsePagePool() {
 
   }
 
 
-  DxvkSparseMapping DxvkSparsePageAllocator::acquirePage(
-          uint32_t              page) {
+  Rc<DxvkSparsePage> DxvkSparsePagePool::allocPage() {
     std::lock_guard lock(m_mutex);
 
-    if (unlikely(page >= m_pageCount))
-      return DxvkSparseMapping();
+    // Allocate the reserved budget up front the first time any
+    // page is requested, so that apps that never use tiled
+    // resources do not waste any memory.
+    if (m_reservedPages) {
+      m_freePages.reserve(m_reservedPages);
 
-    m_useCount += 1;
-    return DxvkSparseMapping(this, m_pages[page]);
+      while (m_freePages.size() < m_reservedPages)
+        m_freePages.push_back(createPage());
+
+      m_reservedPages = 0u;
+    }
+
+    // Pages are returned in order, so the pages at the front
+    // of the list are the most likely ones to be idle
+    for (size_t i = 0; i < m_freePages.size(); i++) {
+      if (m_freePages[i]->isExclusive()) {
+        Rc<DxvkSparsePage> page = std::move(m_freePages[i]);
+
+        m_freePages[i] = std::move(m_freePages.back());
+        m_freePages.pop_back();
+        return page;
+      }
+    }
+
+    return createPage();
   }
 
 
-  void DxvkSparsePageAllocator::setCapacity(
-          uint32_t              pageCount) {
+  void DxvkSparsePagePool::freePages(
+          size_t                pageCount,
+          Rc<DxvkSparsePage>*   pages) {
     std::lock_guard lock(m_mutex);
 
-    if (pageCount < m_pageCount) {
-      if (!m_useCount)
-        m_pages.resize(pageCount);
-    } else if (pageCount > m_pageCount) {
-      while (m_pages.size() < pageCount)
-        m_pages.push_back(allocPage());
+    for (size_t i = 0; i < pageCount; i++) {
+      if (m_freePages.size() < m_maxFreePages)
+        m_freePages.push_back(std::move(pages[i]));
     }
-
-    m_pageCount = pageCount;
   }
 
 
-  Rc<DxvkSparsePage> DxvkSparsePageAllocator::allocPage() {
+  Rc<DxvkSparsePage> DxvkSparsePagePool::createPage() {
     DxvkMemoryRequirements memoryRequirements = { };
     memoryRequirements.tiling = VK_IMAGE_TILING_LINEAR;
     memoryRequirements.core = { VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
@@ -134,12 +158,62 @@ namespace dxvk {
     memoryProperties.flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
     DxvkMemory memory = m_memory->alloc(memoryRequirements,
-      memoryProperties, DxvkMemoryFlag::GpuReadable);
+      memoryProperties, m_memoryHints);
 
     return new DxvkSparsePage(std::move(memory));
   }
 
 
+  DxvkSparsePageAllocator::DxvkSparsePageAllocator(
+          DxvkSparsePagePool&   pagePool)
+  : m_pagePool(&pagePool) {
+
+  }
+
+
+  DxvkSparsePageAllocator::~DxvkSparsePageAllocator() {
+    shrinkPages(0u);
+  }
+
+
+  DxvkSparseMapping DxvkSparsePageAllocator::acquirePage(
+          uint32_t              page) {
+    std::lock_guard lock(m_mutex);
+
+    if (unlikely(page >= m_pageCount))
+      return DxvkSparseMapping();
+
+    m_useCount += 1;
+    return DxvkSparseMapping(this, m_pages[page]);
+  }
+
+
+  void DxvkSparsePageAllocator::setCapacity(
+          uint32_t              pageCount) {
+    std::lock_guard lock(m_mutex);
+
+    if (pageCount < m_pageCount) {
+      if (!m_useCount)
+        shrinkPages(pageCount);
+    } else if (pageCount > m_pageCount) {
+      while (m_pages.size() < pageCount)
+        m_pages.push_back(m_pagePool->allocPage());
+    }
+
+    m_pageCount = pageCount;
+  }
+
+
+  void DxvkSparsePageAllocator::shrinkPages(
+          uint32_t              pageCount) {
+    if (m_pages.size() <= pageCount)
+      return;
+
+    m_pagePool->freePages(m_pages.size() - pageCount, &m_pages[pageCount]);
+    m_pages.resize(pageCount);
+  }
+
+
   void DxvkSparsePageAllocator::acquirePage(
     const Rc<DxvkSparsePage>&   page) {
     std::lock_guard lock(m_mutex);
@@ -153,7 +227,7 @@ namespace dxvk {
     m_useCount -= 1;
 
     if (!m_useCount)
-      m_pages.resize(m_pageCount);
+      shrinkPages(m_pageCount);
   }
 
 
@@ -540,6 +614,35 @@ namespace dxvk {
   }
 
 
+  bool DxvkSparseBindSubmission::tryMergeImageMemoryBind(
+          VkSparseImageMemoryBind&          oldBind,
+    const VkSparseImageMemoryBind&          newBind) {
+    // Only merge null bindings since the memory layout of a region
+    // spanning multiple sparse blocks is not well-defined otherwise.
+    if (newBind.memory || oldBind.memory || newBind.flags != oldBind.flags)
+      return false;
+
+    if (newBind.subresource.aspectMask != oldBind.subresource.aspectMask
+     || newBind.subresource.mipLevel   != oldBind.subresource.mipLevel
+     || newBind.subresource.arrayLayer != oldBind.subresource.arrayLayer)
+      return false;
+
+    // Keys are ordered by z, y and x offset, so adjacent
+    // tiles within the same row will be processed in order.
+    if (newBind.offset.y != oldBind.offset.y
+     || newBind.offset.z != oldBind.offset.z
+     || newBind.extent.height != oldBind.extent.height
+     || newBind.extent.depth  != oldBind.extent.depth)
+      return false;
+
+    if (uint32_t(newBind.offset.x) != uint32_t(oldBind.offset.x) + oldBind.extent.width)
+      return false;
+
+    oldBind.extent.width += newBind.extent.width;
+    return true;
+  }
+
+
   void DxvkSparseBindSubmission::processBufferBinds(
           DxvkSparseBufferBindArrays&       buffer) {
     std::vector<std::pair<VkBuffer, VkSparseMemoryBind>> ranges;
@@ -584,7 +687,13 @@ namespace dxvk {
       bind.memory         = handle.memory;
       bind.memoryOffset   = handle.offset;
 
-      ranges.push_back({ key.image, bind });
+      bool merged = false;
+
+      if (!ranges.empty() && ranges.back().first == key.image)
+        merged = tryMergeImageMemoryBind(ranges.back().second, bind);
+
+      if (!merged)
+        ranges.push_back({ key.image, bind });
     }
 
     populateOutputArrays(image.binds, image.infos, ranges);
@@ -14,6 +14,7 @@ namespace dxvk {
   class DxvkPagedResource;
   class DxvkSparsePage;
   class DxvkSparsePageAllocator;
+  class DxvkSparsePagePool;
   class DxvkSparsePageTable;
 
   constexpr static VkDeviceSize SparseMemoryPageSize = 1ull << 16;
@@ -197,6 +198,64 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Sparse page pool
+   *
+   * Device-wide cache of sparse pages. Pages released by
+   * page allocators are kept around and recycled once the
+   * GPU no longer uses them, so that resizing tile pools
+   * does not have to allocate memory every time.
+   */
+  class DxvkSparsePagePool {
+    /// Number of free pages to keep around
+    /// if no larger budget is reserved
+    constexpr static uint32_t MaxFreePages = 256u;
+  public:
+
+    DxvkSparsePagePool(
+            DxvkDevice*           device,
+            DxvkMemoryAllocator&  memoryAllocator);
+
+    ~DxvkSparsePagePool();
+
+    /**
+     * \brief Allocates a page
+     *
+     * Returns a free page that is no longer in use by the
+     * GPU if possible, and allocates a new page otherwise.
+     * \returns New sparse page
+     */
+    Rc<DxvkSparsePage> allocPage();
+
+    /**
+     * \brief Returns pages to the pool
+     *
+     * Pages exceeding the pool's capacity are freed. Pages
+     * may still be in use by the GPU, in which case they
+     * will not be recycled until all accesses complete.
+     * \param [in] pageCount Number of pages
+     * \param [in] pages Pages to return to the pool
+     */
+    void freePages(
+            size_t                pageCount,
+            Rc<DxvkSparsePage>*   pages);
+
+  private:
+
+    DxvkMemoryAllocator*              m_memory;
+    DxvkMemoryFlags                   m_memoryHints;
+
+    dxvk::mutex                       m_mutex;
+    std::vector<Rc<DxvkSparsePage>>   m_freePages;
+
+    uint32_t                          m_maxFreePages  = 0u;
+    uint32_t                          m_reservedPages = 0u;
+
+    Rc<DxvkSparsePage> createPage();
+
+  };
+
+
   /**
    * \brief Sparse page mapping
    *
@@ -271,7 +330,7 @@ namespace dxvk {
   public:
 
     DxvkSparsePageAllocator(
-            DxvkMemoryAllocator&  memoryAllocator);
+            DxvkSparsePagePool&   pagePool);
 
     ~DxvkSparsePageAllocator();
 
@@ -299,14 +358,15 @@ namespace dxvk {
 
   private:
 
-    DxvkMemoryAllocator*              m_memory;
+    DxvkSparsePagePool*               m_pagePool;
 
     dxvk::mutex                       m_mutex;
     uint32_t                          m_pageCount = 0u;
     uint32_t                          m_useCount = 0u;
     std::vector<Rc<DxvkSparsePage>>   m_pages;
 
-    Rc<DxvkSparsePage> allocPage();
+    void shrinkPages(
+            uint32_t              pageCount);
 
     void acquirePage(
       const Rc<DxvkSparsePage>&   page);
@@ -486,10 +546,31 @@ namespace dxvk {
         : nullptr;
     }
 
+    /**
+     * \brief Queries write sequence number
+     *
+     * Incremented every time the resource is tracked for
+     * write access by a command list. If this does not
+     * change, the resource has not been written by the GPU.
+     * \returns Write sequence number
+     */
+    uint64_t getWriteSequence() const {
+      return m_writeSequence.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Increments write sequence number
+     */
+    void markWritten() {
+      m_writeSequence.fetch_add(1u, std::memory_order_release);
+    }
+
   protected:
 
     DxvkSparsePageTable m_sparsePageTable;
 
+    std::atomic<uint64_t> m_writeSequence = { 0u };
+
   };
 
 
@@ -731,6 +812,10 @@ namespace dxvk {
             VkSparseMemoryBind&               oldBind,
       const VkSparseMemoryBind&               newBind);
 
+    static bool tryMergeImageMemoryBind(
+            VkSparseImageMemoryBind&          oldBind,
+      const VkSparseImageMemoryBind&          newBind);
+
     void processBufferBinds(
             DxvkSparseBufferBindArrays&       buffer);
 
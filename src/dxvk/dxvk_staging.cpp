@@ -3,20 +3,86 @@
 
 namespace dxvk {
   
-  DxvkStagingBuffer::DxvkStagingBuffer(
-    const Rc<DxvkDevice>&     device,
-          VkDeviceSize        size)
-  : m_device(device), m_offset(0), m_size(size) {
+  /// Time after which unused pooled staging buffers are released
+  constexpr auto StagingPoolGracePeriod = std::chrono::seconds(5);
+
+
+  DxvkStagingPool::DxvkStagingPool(
+          DxvkDevice*           device)
+  : m_device(device) {
 
   }
 
 
-  DxvkStagingBuffer::~DxvkStagingBuffer() {
+  DxvkStagingPool::~DxvkStagingPool() {
 
   }
 
 
-  DxvkBufferSlice DxvkStagingBuffer::alloc(VkDeviceSize align, VkDeviceSize size) {
+  Rc<DxvkBuffer> DxvkStagingPool::getBuffer(
+          VkDeviceSize          size) {
+    auto now = high_resolution_clock::now();
+
+    std::lock_guard lock(m_mutex);
+
+    // Entries are stored in order of last use, so prefer the
+    // least recently used buffer since the GPU is most likely
+    // to be done with it.
+    for (size_t i = 0; i < m_entries.size(); i++) {
+      Entry& entry = m_entries[i];
+
+      VkDeviceSize entrySize = entry.buffer->info().size;
+
+      if (entrySize >= size && entrySize <= 2 * size && entry.buffer->isExclusive()) {
+        Entry reused = std::move(entry);
+        reused.useTime = now;
+
+        m_entries.erase(m_entries.begin() + i);
+        m_entries.push_back(std::move(reused));
+        return m_entries.back().buffer;
+      }
+    }
+
+    Rc<DxvkBuffer> buffer = createBuffer(size);
+
+    if (size > MaxSize)
+      return buffer;
+
+    // Make room by dropping the least recently used buffers. Any
+    // buffer that is still in use will be freed by its last user.
+    size_t evictCount = 0;
+
+    while (m_size + size > MaxSize)
+      m_size -= m_entries[evictCount++].buffer->info().size;
+
+    m_entries.erase(m_entries.begin(), m_entries.begin() + evictCount);
+
+    Entry& entry = m_entries.emplace_back();
+    entry.buffer = buffer;
+    entry.useTime = now;
+
+    m_size += size;
+    return buffer;
+  }
+
+
+  void DxvkStagingPool::trim() {
+    auto now = high_resolution_clock::now();
+
+    std::lock_guard lock(m_mutex);
+
+    size_t evictCount = 0;
+
+    while (evictCount < m_entries.size()
+        && now - m_entries[evictCount].useTime > StagingPoolGracePeriod)
+      m_size -= m_entries[evictCount++].buffer->info().size;
+
+    m_entries.erase(m_entries.begin(), m_entries.begin() + evictCount);
+  }
+
+
+  Rc<DxvkBuffer> DxvkStagingPool::createBuffer(
+          VkDeviceSize          size) const {
     DxvkBufferCreateInfo info;
     info.size   = size;
     info.usage  = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
@@ -28,22 +94,33 @@ namespace dxvk {
     info.access = VK_ACCESS_TRANSFER_READ_BIT
                 | VK_ACCESS_SHADER_READ_BIT;
 
+    return m_device->createBuffer(info,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  }
+
+
+  DxvkStagingBuffer::DxvkStagingBuffer(
+    const Rc<DxvkDevice>&     device,
+          VkDeviceSize        size)
+  : m_device(device), m_offset(0), m_size(size) {
+
+  }
+
+
+  DxvkStagingBuffer::~DxvkStagingBuffer() {
+
+  }
+
+
+  DxvkBufferSlice DxvkStagingBuffer::alloc(VkDeviceSize align, VkDeviceSize size) {
     VkDeviceSize alignedSize = dxvk::align(size, align);
     VkDeviceSize alignedOffset = dxvk::align(m_offset, align);
 
-    if (2 * alignedSize > m_size) {
-      return DxvkBufferSlice(m_device->createBuffer(info,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
-    }
+    if (2 * alignedSize > m_size)
+      return DxvkBufferSlice(m_device->stagingPool().getBuffer(alignedSize), 0, size);
 
     if (alignedOffset + alignedSize > m_size || m_buffer == nullptr) {
-      info.size = m_size;
-
-      // Free resources first if possible, in some rare
-      // situations this may help avoid a memory allocation.
-      m_buffer = nullptr;
-      m_buffer = m_device->createBuffer(info,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+      m_buffer = m_device->stagingPool().getBuffer(m_size);
       alignedOffset = 0;
     }
 
@@ -57,5 +134,5 @@ namespace dxvk {
     m_buffer = nullptr;
     m_offset = 0;
   }
-  
+
 }
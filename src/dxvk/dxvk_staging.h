@@ -1,6 +1,9 @@
 #pragma once
 
-#include <queue>
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_time.h"
 
 #include "dxvk_buffer.h"
 
@@ -8,11 +11,81 @@ namespace dxvk {
   
   class DxvkDevice;
 
+  /**
+   * \brief Staging buffer pool
+   *
+   * Keeps recently used staging buffers alive for a short
+   * amount of time, so that large uploads and contexts that
+   * fill up their staging buffer can reuse an existing buffer
+   * once the GPU is done with it rather than allocating a new
+   * one. The total size of pooled buffers is capped for the
+   * entire device, with the least recently used buffers being
+   * dropped first.
+   */
+  class DxvkStagingPool {
+    /// Total size of staging buffers that may be kept for reuse
+    constexpr static VkDeviceSize MaxSize = 32ull << 20;
+  public:
+
+    DxvkStagingPool(
+            DxvkDevice*           device);
+
+    ~DxvkStagingPool();
+
+    /**
+     * \brief Retrieves a staging buffer
+     *
+     * Returns a pooled buffer that is not in use by anything
+     * else and whose size is at least the requested size, but
+     * not more than twice as large. Creates and pools a new
+     * buffer if no such buffer exists. The pool keeps its own
+     * reference, so the buffer becomes available again once
+     * the caller and the GPU stop using it.
+     * \param [in] size Minimum buffer size
+     * \returns Staging buffer
+     */
+    Rc<DxvkBuffer> getBuffer(
+            VkDeviceSize          size);
+
+    /**
+     * \brief Drops buffers that have not been reused
+     *
+     * Called once per frame, releases all buffers that
+     * have not been handed out for longer than the grace
+     * period. Buffers still in use are freed by whoever
+     * holds the last reference.
+     */
+    void trim();
+
+  private:
+
+    struct Entry {
+      Rc<DxvkBuffer>                    buffer;
+      high_resolution_clock::time_point useTime;
+    };
+
+    DxvkDevice*           m_device;
+
+    VkDeviceSize          m_size = 0;
+
+    dxvk::mutex           m_mutex;
+    std::vector<Entry>    m_entries;
+
+    Rc<DxvkBuffer> createBuffer(
+            VkDeviceSize          size) const;
+
+  };
+
+
   /**
    * \brief Staging buffer
    *
    * Provides a simple linear staging buffer
-   * allocator for data uploads.
+   * allocator for data uploads. Buffers are
+   * taken from the device's staging buffer
+   * pool, and are returned to it implicitly
+   * once the allocator and the GPU are done
+   * using them.
    */
   class DxvkStagingBuffer {
 
@@ -37,7 +110,10 @@ namespace dxvk {
      * \brief Allocates staging buffer memory
      *
      * Tries to suballocate from existing buffer,
-     * or creates a new buffer if necessary.
+     * or takes a new buffer from the pool if
+     * necessary. Allocations that are too large
+     * to be suballocated get a dedicated buffer
+     * from the pool.
      * \param [in] align Minimum alignment
      * \param [in] size Number of bytes to allocate
      * \returns Allocated slice
@@ -46,6 +122,9 @@ namespace dxvk {
 
     /**
      * \brief Resets staging buffer and allocator
+     *
+     * The current buffer will be released and
+     * may be reused once it is no longer used.
      */
     void reset();
 
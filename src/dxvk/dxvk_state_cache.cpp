@@ -269,16 +269,15 @@ namespace dxvk {
     if (!m_enable)
       return;
 
-    bool newFile = (useStateCache == "reset") || (!readCacheFile());
-
-    if (newFile) {
-      auto file = openCacheFileForWrite(true);
-
-      // Write all valid entries to the cache file in
-      // case we're recovering a corrupted cache file
-      for (auto& e : m_entries)
-        writeCacheEntry(file, e);
-    }
+    // Read the file on a separate thread so that this overlaps
+    // with the remaining device and swap chain initialization.
+    // Nothing needs the index until the first shader gets created.
+    bool reset = useStateCache == "reset";
+
+    m_loaderThread = dxvk::thread([this, reset] () {
+      env::setThreadName("dxvk-cache-load");
+      loadCacheFile(reset);
+    });
   }
   
 
@@ -292,12 +291,16 @@ namespace dxvk {
     if (!m_enable || shaders.vs.eq(g_nullShaderKey))
       return;
 
+    waitForLoad();
+
     // Do not add an entry that is already in the cache
-    auto entries = m_entryMap.equal_range(shaders);
+    { std::lock_guard<dxvk::mutex> entryLock(m_entryLock);
+      auto entries = m_entryMap.equal_range(shaders);
 
-    for (auto e = entries.first; e != entries.second; e++) {
-      if (m_entries[e->second].type == DxvkStateCacheEntryType::PipelineLibrary)
-        return;
+      for (auto e = entries.first; e != entries.second; e++) {
+        if (m_entries[e->second].type == DxvkStateCacheEntryType::PipelineLibrary)
+          return;
+      }
     }
 
     // Queue a job to write this pipeline to the cache
@@ -305,7 +308,8 @@ namespace dxvk {
 
     m_writerQueue.push({
       DxvkStateCacheEntryType::PipelineLibrary, shaders,
-      DxvkGraphicsPipelineStateInfo(), g_nullHash });
+      DxvkGraphicsPipelineStateInfo(), g_nullHash,
+      m_device->getCurrentFrameId() });
     m_writerCond.notify_one();
 
     createWriter();
@@ -318,21 +322,38 @@ namespace dxvk {
     if (!m_enable || shaders.vs.eq(g_nullShaderKey))
       return;
 
-    // Do not add an entry that is already in the cache
-    auto entries = m_entryMap.equal_range(shaders);
+    waitForLoad();
 
-    for (auto e = entries.first; e != entries.second; e++) {
-      if (m_entries[e->second].type == DxvkStateCacheEntryType::MonolithicPipeline
-       && m_entries[e->second].gpState == state)
-        return;
+    DxvkStateCacheEntry entry = {
+      DxvkStateCacheEntryType::MonolithicPipeline,
+      shaders, state, g_nullHash,
+      m_device->getCurrentFrameId() };
+
+    // Do not add an entry that is already in the cache. Since we
+    // only keep the index in memory, compare serialized entries by
+    // their hash rather than comparing the actual pipeline state.
+    { std::lock_guard<dxvk::mutex> entryLock(m_entryLock);
+      auto entries = m_entryMap.equal_range(shaders);
+
+      for (auto e = entries.first; e != entries.second; e++) {
+        if (m_entries[e->second].type != DxvkStateCacheEntryType::MonolithicPipeline)
+          continue;
+
+        if (entry.hash == g_nullHash) {
+          DxvkStateCacheEntryData data;
+          serializeCacheEntry(entry, data);
+          entry.hash = data.computeHash();
+        }
+
+        if (m_entries[e->second].hash == entry.hash)
+          return;
+      }
     }
 
     // Queue a job to write this pipeline to the cache
     std::unique_lock<dxvk::mutex> lock(m_writerLock);
 
-    m_writerQueue.push({
-      DxvkStateCacheEntryType::MonolithicPipeline,
-      shaders, state, g_nullHash });
+    m_writerQueue.push(entry);
     m_writerCond.notify_one();
 
     createWriter();
@@ -347,7 +368,9 @@ namespace dxvk {
 
     if (key.eq(g_nullShaderKey))
       return;
-    
+
+    waitForLoad();
+
     // Add the shader so we can look it up by its key
     std::unique_lock<dxvk::mutex> entryLock(m_entryLock);
     m_shaderMap.insert({ key, shader });
@@ -366,6 +389,19 @@ namespace dxvk {
        || !getShaderByKey(p->second.gs,  item.gp.gs)
        || !getShaderByKey(p->second.fs,  item.gp.fs))
         continue;
+
+      // Order work by the earliest use of any pipeline
+      // with this set of shaders, so that pipelines needed
+      // at the start of the game get compiled first.
+      item.firstFrame = ~0u;
+      item.firstEntry = ~size_t(0);
+
+      auto entries = m_entryMap.equal_range(p->second);
+
+      for (auto e = entries.first; e != entries.second; e++) {
+        item.firstFrame = std::min(item.firstFrame, m_entries[e->second].firstFrame);
+        item.firstEntry = std::min(item.firstEntry, e->second);
+      }
       
       if (!workerLock)
         workerLock = std::unique_lock<dxvk::mutex>(m_workerLock);
@@ -380,7 +416,19 @@ namespace dxvk {
   }
 
 
+  bool DxvkStateCache::isCompiling() {
+    std::lock_guard<dxvk::mutex> lock(m_workerLock);
+    return m_workerBusy || !m_workerQueue.empty();
+  }
+
+
   void DxvkStateCache::stopWorkers() {
+    { std::lock_guard<dxvk::mutex> loaderLock(m_loaderLock);
+
+      if (m_loaderThread.joinable())
+        m_loaderThread.join();
+    }
+
     { std::lock_guard<dxvk::mutex> workerLock(m_workerLock);
       std::lock_guard<dxvk::mutex> writerLock(m_writerLock);
 
@@ -419,6 +467,25 @@ namespace dxvk {
   }
 
 
+  void DxvkStateCache::addCacheEntry(
+    const DxvkStateCacheKey&        shaders,
+          DxvkStateCacheEntryType   type,
+    const Sha1Hash&                 hash,
+          std::streamoff            offset,
+          uint32_t                  firstFrame) {
+    size_t entryId = m_entries.size();
+    m_entries.push_back({ type, hash, offset, firstFrame });
+
+    mapPipelineToEntry(shaders, entryId);
+
+    mapShaderToPipeline(shaders.vs,  shaders);
+    mapShaderToPipeline(shaders.tcs, shaders);
+    mapShaderToPipeline(shaders.tes, shaders);
+    mapShaderToPipeline(shaders.gs,  shaders);
+    mapShaderToPipeline(shaders.fs,  shaders);
+  }
+
+
   void DxvkStateCache::mapPipelineToEntry(
     const DxvkStateCacheKey&        key,
           size_t                    entryId) {
@@ -443,17 +510,48 @@ namespace dxvk {
     key.fs  = getShaderKey(item.gp.fs);
 
     DxvkGraphicsPipeline* pipeline = nullptr;
-    auto entries = m_entryMap.equal_range(key);
 
-    for (auto e = entries.first; e != entries.second; e++) {
-      const auto& entry = m_entries[e->second];
+    // Compile pipelines in the order in which they were first
+    // used. Entries are indexed in file order, which breaks ties.
+    std::vector<size_t> entryIds;
+    std::vector<CacheEntry> cacheEntries;
+
+    { std::lock_guard<dxvk::mutex> entryLock(m_entryLock);
+      auto entries = m_entryMap.equal_range(key);
+
+      for (auto e = entries.first; e != entries.second; e++)
+        entryIds.push_back(e->second);
+
+      std::sort(entryIds.begin(), entryIds.end(), [this] (size_t a, size_t b) {
+        if (m_entries[a].firstFrame != m_entries[b].firstFrame)
+          return m_entries[a].firstFrame < m_entries[b].firstFrame;
+
+        return a < b;
+      });
+
+      cacheEntries.reserve(entryIds.size());
+
+      for (size_t entryId : entryIds)
+        cacheEntries.push_back(m_entries[entryId]);
+    }
+
+    for (const auto& entry : cacheEntries) {
+
+      DxvkPipelinePriority priority = entry.firstFrame < EarlyFrameCount
+        ? DxvkPipelinePriority::Normal
+        : DxvkPipelinePriority::Low;
 
       switch (entry.type) {
         case DxvkStateCacheEntryType::MonolithicPipeline: {
+          DxvkGraphicsPipelineStateInfo state;
+
+          if (!loadCacheEntry(entry, state))
+            break;
+
           if (!pipeline)
             pipeline = m_pipeManager->createGraphicsPipeline(item.gp);
 
-          m_pipeWorkers->compileGraphicsPipeline(pipeline, entry.gpState, DxvkPipelinePriority::Normal);
+          m_pipeWorkers->compileGraphicsPipeline(pipeline, state, priority);
         } break;
 
         case DxvkStateCacheEntryType::PipelineLibrary: {
@@ -468,14 +566,89 @@ namespace dxvk {
           if (item.gp.gs  != nullptr) libraryKey.addShader(item.gp.gs);
 
           auto pipelineLibrary = m_pipeManager->createShaderPipelineLibrary(libraryKey);
-          m_pipeWorkers->compilePipelineLibrary(pipelineLibrary, DxvkPipelinePriority::Normal);
+          m_pipeWorkers->compilePipelineLibrary(pipelineLibrary, priority);
         } break;
       }
     }
   }
 
 
-  bool DxvkStateCache::readCacheFile() {
+  bool DxvkStateCache::loadCacheEntry(
+    const CacheEntry&               entry,
+          DxvkGraphicsPipelineStateInfo& state) {
+    // The file is only ever read by the worker thread, and
+    // existing entries do not change while the writer thread
+    // appends new entries, so we can safely keep it open.
+    if (!m_workerFile.is_open())
+      m_workerFile = openCacheFileForRead();
+
+    m_workerFile.clear();
+
+    DxvkStateCacheEntry data;
+
+    if (!m_workerFile.seekg(entry.offset)
+     || !readCacheEntry(DxvkStateCacheHeader().version, m_workerFile, data)
+     || data.hash != entry.hash) {
+      Logger::warn("DXVK: Failed to load state cache entry");
+      return false;
+    }
+
+    state = data.gpState;
+    return true;
+  }
+
+
+  void DxvkStateCache::loadCacheFile(bool reset) {
+    auto t0 = high_resolution_clock::now();
+
+    // The index is built on this thread, so hold the entry
+    // lock while modifying it. Other threads only access the
+    // index after waiting for the loader, so this should not
+    // ever block anything.
+    std::unique_lock<dxvk::mutex> entryLock(m_entryLock);
+
+    std::vector<DxvkStateCacheEntry> entries;
+    bool newFile = reset || !readCacheFile(entries);
+
+    if (newFile) {
+      auto file = openCacheFileForWrite(true);
+
+      // Write all valid entries to the cache file in case we're
+      // recovering a corrupted or outdated cache file, and index
+      // them so that they can be loaded back from the new file
+      std::streamoff offset = sizeof(DxvkStateCacheHeader);
+
+      for (auto& e : entries) {
+        size_t size = writeCacheEntry(file, e);
+        addCacheEntry(e.shaders, e.type, e.hash, offset, e.firstFrame);
+        offset += size;
+      }
+    }
+
+    entryLock.unlock();
+
+    auto t1 = high_resolution_clock::now();
+
+    Logger::info(str::format("Startup: Loaded state cache in ",
+      std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count(), " ms"));
+
+    m_loaded.store(true, std::memory_order_release);
+  }
+
+
+  void DxvkStateCache::waitForLoad() {
+    if (likely(m_loaded.load(std::memory_order_acquire)))
+      return;
+
+    std::lock_guard<dxvk::mutex> lock(m_loaderLock);
+
+    if (m_loaderThread.joinable())
+      m_loaderThread.join();
+  }
+
+
+  bool DxvkStateCache::readCacheFile(
+          std::vector<DxvkStateCacheEntry>& entries) {
     // Return success if the file was not found.
     // This way we will only create it on demand.
     std::ifstream ifile = openCacheFileForRead();
@@ -496,59 +669,89 @@ namespace dxvk {
     }
 
     // Discard caches of unsupported versions
-    if (curHeader.version < 8 || curHeader.version == 16
-     || curHeader.version > newHeader.version) {
+    if (!isSupportedVersion(curHeader.version)) {
       Logger::warn("DXVK: State cache version not supported");
       return false;
     }
 
-    // Notify user about format conversion
-    if (curHeader.version != newHeader.version)
+    // Files of the current version only need to be indexed,
+    // actual entries are parsed and verified on demand.
+    if (curHeader.version == newHeader.version) {
+      if (readCacheIndex(ifile))
+        return true;
+
+      // Read the entire file again and drop the index,
+      // since we have to rewrite the file anyway.
+      m_entries.clear();
+      m_entryMap.clear();
+      m_pipelineMap.clear();
+
+      ifile.clear();
+      ifile.seekg(sizeof(curHeader));
+    } else {
+      // Notify user about format conversion
       Logger::warn(str::format("DXVK: Updating state cache version to v", newHeader.version));
+    }
 
-    // Read actual cache entries from the file.
-    // If we encounter invalid entries, we should
-    // regenerate the entire state cache file.
+    // Read actual cache entries from the file and
+    // keep all valid ones so that they can be
+    // written back to the new cache file.
     uint32_t numInvalidEntries = 0;
 
     while (ifile) {
       DxvkStateCacheEntry entry;
 
-      if (readCacheEntry(curHeader.version, ifile, entry)) {
-        size_t entryId = m_entries.size();
-        m_entries.push_back(entry);
-
-        mapPipelineToEntry(entry.shaders, entryId);
-
-        mapShaderToPipeline(entry.shaders.vs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.tcs, entry.shaders);
-        mapShaderToPipeline(entry.shaders.tes, entry.shaders);
-        mapShaderToPipeline(entry.shaders.gs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.fs,  entry.shaders);
-      } else if (ifile) {
+      if (readCacheEntry(curHeader.version, ifile, entry))
+        entries.push_back(entry);
+      else if (ifile)
         numInvalidEntries += 1;
-      }
     }
 
     Logger::info(str::format(
-      "DXVK: Read ", m_entries.size(),
+      "DXVK: Read ", entries.size(),
       " valid state cache entries"));
 
     if (numInvalidEntries) {
       Logger::warn(str::format(
         "DXVK: Skipped ", numInvalidEntries,
         " invalid state cache entries"));
-      return false;
     }
-    
-    // Rewrite entire state cache if it is outdated
-    return curHeader.version == newHeader.version;
+
+    // Always rewrite the file at this point
+    return false;
+  }
+
+
+  bool DxvkStateCache::readCacheIndex(
+          std::istream&             stream) {
+    std::streamoff offset = sizeof(DxvkStateCacheHeader);
+
+    while (stream) {
+      CacheEntry entry;
+      entry.offset = offset;
+
+      DxvkStateCacheKey shaders;
+      size_t size = 0;
+
+      if (readCacheIndexEntry(stream, entry, shaders, size)) {
+        addCacheEntry(shaders, entry.type, entry.hash, entry.offset, entry.firstFrame);
+        offset += size;
+      } else if (stream) {
+        Logger::warn("DXVK: Invalid state cache entry found");
+        return false;
+      }
+    }
+
+    Logger::info(str::format(
+      "DXVK: Read ", m_entries.size(),
+      " state cache entries"));
+    return true;
   }
 
 
   bool DxvkStateCache::readCacheHeader(
           std::istream&             stream,
-          DxvkStateCacheHeader&     header) const {
+          DxvkStateCacheHeader&     header) {
     DxvkStateCacheHeader expected;
 
     auto data = reinterpret_cast<char*>(&header);
@@ -566,10 +769,47 @@ namespace dxvk {
   }
 
 
+  bool DxvkStateCache::isSupportedVersion(
+          uint32_t                  version) {
+    return version >= 8 && version != 16
+        && version <= DxvkStateCacheHeader().version;
+  }
+
+
+  bool DxvkStateCache::readCacheIndexEntry(
+          std::istream&             stream,
+          CacheEntry&               entry,
+          DxvkStateCacheKey&        shaders,
+          size_t&                   size) const {
+    // Only read the entry header and shader keys here, the
+    // pipeline state itself is validated when it gets used
+    DxvkStateCacheEntryHeader header;
+    DxvkStateCacheEntryData data;
+
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+     || !stream.read(reinterpret_cast<char*>(&entry.hash), sizeof(entry.hash))
+     || !stream.read(reinterpret_cast<char*>(&entry.firstFrame), sizeof(entry.firstFrame))
+     || !data.readFromStream(stream, header.entrySize))
+      return false;
+
+    VkShaderStageFlags stageMask = VkShaderStageFlags(header.stageMask);
+
+    if (stageMask & VK_SHADER_STAGE_COMPUTE_BIT)
+      return false;
+
+    if (!data.read(shaders, DxvkStateCacheHeader().version, stageMask))
+      return false;
+
+    entry.type = DxvkStateCacheEntryType(header.entryType);
+    size = sizeof(header) + sizeof(entry.hash) + sizeof(entry.firstFrame) + header.entrySize;
+    return true;
+  }
+
+
   bool DxvkStateCache::readCacheEntry(
           uint32_t                  version,
-          std::istream&             stream, 
-          DxvkStateCacheEntry&      entry) const {
+          std::istream&             stream,
+          DxvkStateCacheEntry&      entry) {
     // Read entry metadata and actual data
     DxvkStateCacheEntryHeader header;
     DxvkStateCacheEntryData data;
@@ -594,8 +834,20 @@ namespace dxvk {
       stageMask = VkShaderStageFlags(headerV8.stageMask);
     }
 
-    if (!stream.read(reinterpret_cast<char*>(&hash), sizeof(hash))
-     || !data.readFromStream(stream, header.entrySize))
+    if (!stream.read(reinterpret_cast<char*>(&hash), sizeof(hash)))
+      return false;
+
+    // v18 introduced first-use frame stamps. Older entries
+    // are treated as if they were used in the first frame,
+    // so that they get compiled in file order as before.
+    entry.firstFrame = 0;
+
+    if (version >= 18) {
+      if (!stream.read(reinterpret_cast<char*>(&entry.firstFrame), sizeof(entry.firstFrame)))
+        return false;
+    }
+
+    if (!data.readFromStream(stream, header.entrySize))
       return false;
 
     // Validate hash, skip entry if invalid
@@ -604,6 +856,7 @@ namespace dxvk {
 
     // Set up entry metadata
     entry.type = DxvkStateCacheEntryType(header.entryType);
+    entry.hash = hash;
 
     // Read shader hashes
     auto entryType = DxvkStateCacheEntryType(header.entryType);
@@ -688,10 +941,9 @@ namespace dxvk {
   }
 
 
-  void DxvkStateCache::writeCacheEntry(
-          std::ostream&             stream, 
-          DxvkStateCacheEntry&      entry) const {
-    DxvkStateCacheEntryData data;
+  VkShaderStageFlags DxvkStateCache::serializeCacheEntry(
+    const DxvkStateCacheEntry&      entry,
+          DxvkStateCacheEntryData&  data) {
     VkShaderStageFlags stageMask = 0;
 
     // Write shader hashes
@@ -750,18 +1002,31 @@ namespace dxvk {
       }
     }
 
-    // General layout: header -> hash -> data
+    return stageMask;
+  }
+
+
+  size_t DxvkStateCache::writeCacheEntry(
+          std::ostream&             stream,
+          DxvkStateCacheEntry&      entry) {
+    DxvkStateCacheEntryData data;
+    VkShaderStageFlags stageMask = serializeCacheEntry(entry, data);
+
+    // General layout: header -> hash -> first frame -> data
     DxvkStateCacheEntryHeader header;
     header.entryType = uint32_t(entry.type);
     header.stageMask = uint32_t(stageMask);
     header.entrySize = data.size();
 
-    Sha1Hash hash = data.computeHash();
+    entry.hash = data.computeHash();
 
     stream.write(reinterpret_cast<char*>(&header), sizeof(header));
-    stream.write(reinterpret_cast<char*>(&hash), sizeof(hash));
+    stream.write(reinterpret_cast<char*>(&entry.hash), sizeof(entry.hash));
+    stream.write(reinterpret_cast<char*>(&entry.firstFrame), sizeof(entry.firstFrame));
     stream.write(data.data(), data.size());
     stream.flush();
+
+    return sizeof(header) + sizeof(entry.hash) + sizeof(entry.firstFrame) + data.size();
   }
 
 
@@ -783,11 +1048,16 @@ namespace dxvk {
         if (m_workerQueue.empty())
           break;
         
-        item = m_workerQueue.front();
+        item = m_workerQueue.top();
         m_workerQueue.pop();
+
+        m_workerBusy = true;
       }
 
       compilePipelines(item);
+
+      std::lock_guard<dxvk::mutex> lock(m_workerLock);
+      m_workerBusy = false;
     }
   }
 
@@ -840,7 +1110,11 @@ namespace dxvk {
     if (!path.empty() && *path.rbegin() != '/')
       path += '/';
     
-    std::string exeName = env::getExeBaseName();
+    std::string exeName = env::getEnvVar("DXVK_STATE_CACHE_NAME");
+
+    if (exeName.empty())
+      exeName = env::getExeBaseName();
+
     path += exeName + ".dxvk-cache";
     return str::topath(path.c_str());
   }
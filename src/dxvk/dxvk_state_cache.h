@@ -13,6 +13,7 @@
 namespace dxvk {
 
   class DxvkDevice;
+  class DxvkStateCacheEntryData;
   class DxvkPipelineManager;
   class DxvkPipelineWorkers;
 
@@ -24,6 +25,10 @@ namespace dxvk {
    * game, which allows DXVK to compile them ahead
    * of time instead of compiling them on the first
    * draw.
+   *
+   * Only an index of the cache file is kept in memory.
+   * The state vector of an entry is read back from the
+   * file once all of its shaders become available.
    */
   class DxvkStateCache {
 
@@ -69,17 +74,105 @@ namespace dxvk {
     void registerShader(
       const Rc<DxvkShader>&                 shader);
 
+    /**
+     * \brief Checks whether the worker is busy
+     *
+     * \returns \c true if there are pipelines that have
+     *    not been dispatched to the compiler workers yet
+     */
+    bool isCompiling();
+
     /**
      * \brief Explicitly stops worker threads
      */
     void stopWorkers();
 
+    /**
+     * \brief Reads and validates a cache file header
+     *
+     * Only checks the magic number. Callers need
+     * to check the version number themselves.
+     * \param [in] stream Input stream
+     * \param [out] header File header
+     * \returns \c true if the header is valid
+     */
+    static bool readCacheHeader(
+            std::istream&             stream,
+            DxvkStateCacheHeader&     header);
+
+    /**
+     * \brief Checks whether a file version can be read
+     *
+     * \param [in] version File version
+     * \returns \c true if entries can be read or converted
+     */
+    static bool isSupportedVersion(
+            uint32_t                  version);
+
+    /**
+     * \brief Reads a single cache entry
+     *
+     * Entries of older file versions are converted
+     * to the current representation on the fly.
+     * \param [in] version File version
+     * \param [in] stream Input stream
+     * \param [out] entry Cache entry
+     * \returns \c true if the entry is valid
+     */
+    static bool readCacheEntry(
+            uint32_t                  version,
+            std::istream&             stream,
+            DxvkStateCacheEntry&      entry);
+
+    /**
+     * \brief Writes a single cache entry
+     *
+     * Entries are always written in the current
+     * format. Updates the hash stored in the entry.
+     * \param [in] stream Output stream
+     * \param [in,out] entry Cache entry
+     * \returns Number of bytes written
+     */
+    static size_t writeCacheEntry(
+            std::ostream&             stream,
+            DxvkStateCacheEntry&      entry);
+
   private:
 
+    /**
+     * \brief Number of frames to prioritize
+     *
+     * Pipelines that were first used within this many
+     * frames, roughly the first five minutes at 60 FPS,
+     * get compiled with normal priority. Pipelines used
+     * later on are compiled with low priority so that
+     * they do not hold up work needed right away.
+     */
+    constexpr static uint32_t EarlyFrameCount = 18000;
+
     using WriterItem = DxvkStateCacheEntry;
 
     struct WorkerItem {
       DxvkGraphicsPipelineShaders gp;
+      uint32_t                    firstFrame;
+      size_t                      firstEntry;
+    };
+
+    struct WorkerItemOrder {
+      bool operator () (const WorkerItem& a, const WorkerItem& b) const {
+        // Priority queue returns the largest element first
+        if (a.firstFrame != b.firstFrame)
+          return a.firstFrame > b.firstFrame;
+
+        return a.firstEntry > b.firstEntry;
+      }
+    };
+
+    struct CacheEntry {
+      DxvkStateCacheEntryType     type;
+      Sha1Hash                    hash;
+      std::streamoff              offset;
+      uint32_t                    firstFrame;
     };
 
     DxvkDevice*                       m_device;
@@ -87,9 +180,15 @@ namespace dxvk {
     DxvkPipelineWorkers*              m_pipeWorkers;
     bool                              m_enable = false;
 
-    std::vector<DxvkStateCacheEntry>  m_entries;
+    std::vector<CacheEntry>           m_entries;
     std::atomic<bool>                 m_stopThreads = { false };
 
+    dxvk::mutex                       m_loaderLock;
+    dxvk::thread                      m_loaderThread;
+    std::atomic<bool>                 m_loaded = { false };
+
+    /// Protects the entry index and shader map. The
+    /// index is only modified by the loader thread.
     dxvk::mutex                       m_entryLock;
 
     std::unordered_multimap<
@@ -106,8 +205,12 @@ namespace dxvk {
 
     dxvk::mutex                       m_workerLock;
     dxvk::condition_variable          m_workerCond;
-    std::queue<WorkerItem>            m_workerQueue;
+    std::priority_queue<WorkerItem,
+      std::vector<WorkerItem>,
+      WorkerItemOrder>                m_workerQueue;
     dxvk::thread                      m_workerThread;
+    std::ifstream                     m_workerFile;
+    bool                              m_workerBusy = false;
 
     dxvk::mutex                       m_writerLock;
     dxvk::condition_variable          m_writerCond;
@@ -121,6 +224,13 @@ namespace dxvk {
       const DxvkShaderKey&            key,
             Rc<DxvkShader>&           shader) const;
     
+    void addCacheEntry(
+      const DxvkStateCacheKey&        shaders,
+            DxvkStateCacheEntryType   type,
+      const Sha1Hash&                 hash,
+            std::streamoff            offset,
+            uint32_t                  firstFrame);
+
     void mapPipelineToEntry(
       const DxvkStateCacheKey&        key,
             size_t                    entryId);
@@ -132,21 +242,31 @@ namespace dxvk {
     void compilePipelines(
       const WorkerItem&               item);
 
-    bool readCacheFile();
+    bool loadCacheEntry(
+      const CacheEntry&               entry,
+            DxvkGraphicsPipelineStateInfo& state);
+
+    void loadCacheFile(
+            bool                      reset);
+
+    void waitForLoad();
+
+    bool readCacheFile(
+            std::vector<DxvkStateCacheEntry>& entries);
 
-    bool readCacheHeader(
+    bool readCacheIndex(
+            std::istream&             stream);
+
+    bool readCacheIndexEntry(
             std::istream&             stream,
-            DxvkStateCacheHeader&     header) const;
+            CacheEntry&               entry,
+            DxvkStateCacheKey&        shaders,
+            size_t&                   size) const;
+
+    static VkShaderStageFlags serializeCacheEntry(
+      const DxvkStateCacheEntry&      entry,
+            DxvkStateCacheEntryData&  data);
 
-    bool readCacheEntry(
-            uint32_t                  version,
-            std::istream&             stream, 
-            DxvkStateCacheEntry&      entry) const;
-    
-    void writeCacheEntry(
-            std::ostream&             stream, 
-            DxvkStateCacheEntry&      entry) const;
-    
     void workerFunc();
 
     void writerFunc();
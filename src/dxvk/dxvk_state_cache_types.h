@@ -42,12 +42,19 @@ namespace dxvk {
    * as the full state vector, including its render
    * pass format. This also includes a SHA-1 hash
    * that is used as a check sum to verify integrity.
+   *
+   * The first-use frame is the frame in which the
+   * pipeline was first used by the application. It
+   * is not covered by the hash since it does not
+   * affect the pipeline itself, and is only used to
+   * order pipeline compilation on subsequent runs.
    */
   struct DxvkStateCacheEntry {
     DxvkStateCacheEntryType       type;
     DxvkStateCacheKey             shaders;
     DxvkGraphicsPipelineStateInfo gpState;
     Sha1Hash                      hash;
+    uint32_t                      firstFrame;
   };
 
 
@@ -60,7 +67,7 @@ namespace dxvk {
    */
   struct DxvkStateCacheHeader {
     char     magic[4]   = { 'D', 'X', 'V', 'K' };
-    uint32_t version    = 17;
+    uint32_t version    = 18;
     uint32_t entrySize  = 0; /* no longer meaningful */
   };
 
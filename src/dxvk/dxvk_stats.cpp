@@ -1,6 +1,23 @@
 #include "dxvk_stats.h"
 
 namespace dxvk {
+
+  const char* getCsSyncReasonName(DxvkCsSyncReason reason) {
+    switch (reason) {
+      case DxvkCsSyncReason::Unknown:       return "Unknown";
+      case DxvkCsSyncReason::BufferRead:    return "Buffer read";
+      case DxvkCsSyncReason::BufferWrite:   return "Buffer write";
+      case DxvkCsSyncReason::ImageRead:     return "Image read";
+      case DxvkCsSyncReason::ImageWrite:    return "Image write";
+      case DxvkCsSyncReason::StagingMemory: return "Staging memory";
+      case DxvkCsSyncReason::Interop:       return "Interop";
+      case DxvkCsSyncReason::Device:        return "Device";
+      case DxvkCsSyncReason::Count:         break;
+    }
+
+    return "Invalid";
+  }
+
   
   DxvkStatCounters::DxvkStatCounters() {
     this->reset();
@@ -3,6 +3,35 @@
 #include "dxvk_include.h"
 
 namespace dxvk {
+
+  /**
+   * \brief CS thread synchronization reason
+   *
+   * Identifies what caused the API thread
+   * to wait for the CS thread.
+   */
+  enum class DxvkCsSyncReason : uint32_t {
+    Unknown,                  ///< Unspecified reason
+    BufferRead,               ///< CPU read from a buffer
+    BufferWrite,              ///< CPU write to a buffer that may be in use
+    ImageRead,                ///< CPU read from an image
+    ImageWrite,               ///< CPU write to an image that may be in use
+    StagingMemory,            ///< Throttling staging memory usage
+    Interop,                  ///< Interop API access
+    Device,                   ///< Device reset or destruction
+    Count
+  };
+
+  constexpr uint32_t DxvkCsSyncReasonCount = uint32_t(DxvkCsSyncReason::Count);
+
+  /**
+   * \brief Retrieves name of a CS sync reason
+   *
+   * \param [in] reason Sync reason
+   * \returns Human-readable name
+   */
+  const char* getCsSyncReasonName(DxvkCsSyncReason reason);
+
   
   /**
    * \brief Named stat counters
@@ -12,6 +41,8 @@ namespace dxvk {
    */
   enum class DxvkStatCounter : uint32_t {
     CmdDrawCalls,             ///< Number of draw calls
+    CmdDrawCallsBase,         ///< Draw calls using base pipelines
+    CmdDrawCallsSkipped,      ///< Draw calls skipped due to compilation
     CmdDispatchCalls,         ///< Number of compute calls
     CmdRenderPassCount,       ///< Number of render passes
     CmdBarrierCount,          ///< Number of pipeline barriers
@@ -22,18 +53,54 @@ namespace dxvk {
     PipeTasksTotal,           ///< Boolean indicating compiler activity
     QueueSubmitCount,         ///< Number of command buffer submissions
     QueuePresentCount,        ///< Number of present calls / frames
+    QueueSubmitLatency,       ///< Time spent in submission queue, in us
+    QueueDepthSum,            ///< Accumulated submission queue depth
+    QueueFlushPacing,         ///< Flush threshold scale, in percent
     GpuSyncCount,             ///< Number of GPU synchronizations
     GpuSyncTicks,             ///< Time spent waiting for GPU
     GpuIdleTicks,             ///< GPU idle time in microseconds
     CsSyncCount,              ///< CS thread synchronizations
     CsSyncTicks,              ///< Time spent waiting on CS
-    CsChunkCount,             ///< Submitted CS chunks
+    /// CS syncs per reason, see \ref getCsSyncCountCtr
+    CsSyncReasonCount,
+    /// CS sync time per reason, see \ref getCsSyncTicksCtr
+    CsSyncReasonTicks = CsSyncReasonCount + DxvkCsSyncReasonCount,
+    /// Submitted CS chunks
+    CsChunkCount      = CsSyncReasonTicks + DxvkCsSyncReasonCount,
+    CsRedundantCmds,          ///< Redundant state changes skipped
     DescriptorPoolCount,      ///< Descriptor pool count
     DescriptorSetCount,       ///< Descriptor sets allocated
+    DescriptorSetCacheHits,   ///< Descriptor set writes skipped
+    DescriptorSetCacheMisses, ///< Descriptor set writes performed
+    SamplerCount,             ///< Number of live samplers
+    ImagePoolHits,            ///< Images reused from the image pool
+    ImagePoolMisses,          ///< Poolable images created from scratch
+    ImageCompressedCount,     ///< Live images using fixed-rate compression
     NumCounters,              ///< Number of counters available
   };
   
   
+  /**
+   * \brief Per-reason CS sync count counter
+   *
+   * \param [in] reason Sync reason
+   * \returns Stat counter
+   */
+  inline DxvkStatCounter getCsSyncCountCtr(DxvkCsSyncReason reason) {
+    return DxvkStatCounter(uint32_t(DxvkStatCounter::CsSyncReasonCount) + uint32_t(reason));
+  }
+
+  /**
+   * \brief Per-reason CS sync time counter
+   *
+   * \param [in] reason Sync reason
+   * \returns Stat counter
+   */
+  inline DxvkStatCounter getCsSyncTicksCtr(DxvkCsSyncReason reason) {
+    return DxvkStatCounter(uint32_t(DxvkStatCounter::CsSyncReasonTicks) + uint32_t(reason));
+  }
+  
+  
   /**
    * \brief Stat counters
    * 
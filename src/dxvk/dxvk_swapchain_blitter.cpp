@@ -1,15 +1,20 @@
 #include "dxvk_swapchain_blitter.h"
 
+#include <dxvk_present_comp.h>
+#include <dxvk_present_comp_ms.h>
+
 #include <dxvk_present_frag.h>
 #include <dxvk_present_frag_blit.h>
 #include <dxvk_present_frag_ms.h>
 #include <dxvk_present_frag_ms_amd.h>
+#include <dxvk_present_frag_sharpen.h>
 #include <dxvk_present_vert.h>
 
 namespace dxvk {
   
   DxvkSwapchainBlitter::DxvkSwapchainBlitter(const Rc<DxvkDevice>& device)
-  : m_device(device) {
+  : m_device(device),
+    m_sharpness(uint32_t(device->config().upscaleSharpness * 100.0f + 0.5f)) {
     this->createSampler();
     this->createShaders();
   }
@@ -47,8 +52,25 @@ namespace dxvk {
     bool sameSize = dstRect.extent == srcRect.extent;
     bool usedResolveImage = false;
 
-    if (srcView->imageInfo().sampleCount == VK_SAMPLE_COUNT_1_BIT) {
-      this->draw(ctx, sameSize ? m_fsCopy : m_fsBlit,
+    // Only sharpen when upscaling, the plain blit
+    // is good enough for downscaling
+    bool sharpen = m_fsSharpen != nullptr
+      && (srcRect.extent.width  < dstRect.extent.width
+       || srcRect.extent.height < dstRect.extent.height);
+
+    const Rc<DxvkShader>& fsBlit = sharpen ? m_fsSharpen : m_fsBlit;
+
+    if (canCopy(dstView, dstRect, srcView, srcRect)) {
+      // Formats and sizes match and there is no gamma ramp,
+      // so skip the render pass and copy the image directly.
+      this->copy(ctx, dstView, srcView, srcRect);
+    } else if (m_csBlit != nullptr && !sharpen && (dstView->info().usage & VK_IMAGE_USAGE_STORAGE_BIT)) {
+      // Resolve, scale and apply the gamma ramp in one pass.
+      // This also clears the area outside the destination rect.
+      this->dispatch(ctx, srcView->imageInfo().sampleCount == VK_SAMPLE_COUNT_1_BIT
+        ? m_csBlit : m_csResolve, dstView, dstRect, srcView, srcRect);
+    } else if (srcView->imageInfo().sampleCount == VK_SAMPLE_COUNT_1_BIT) {
+      this->draw(ctx, sameSize ? m_fsCopy : fsBlit,
         dstView, dstRect, srcView, srcRect);
     } else if (sameSize) {
       this->draw(ctx, m_fsResolve,
@@ -60,7 +82,7 @@ namespace dxvk {
         this->createResolveImage(srcView->imageInfo());
 
       this->resolve(ctx, m_resolveView, srcView);
-      this->draw(ctx, m_fsBlit, dstView, dstRect, m_resolveView, srcRect);
+      this->draw(ctx, fsBlit, dstView, dstRect, m_resolveView, srcRect);
 
       usedResolveImage = true;
     }
@@ -102,6 +124,18 @@ namespace dxvk {
   }
 
 
+  VkImageUsageFlags DxvkSwapchainBlitter::getSwapImageUsage(
+          DxvkDevice*         device) {
+    // The swap chain format is not known in advance, so the
+    // shader has to write the image without a declared format
+    if (!device->config().enableComputePresent
+     || !device->features().core.features.shaderStorageImageWriteWithoutFormat)
+      return 0;
+
+    return VK_IMAGE_USAGE_STORAGE_BIT;
+  }
+
+
   void DxvkSwapchainBlitter::draw(
           DxvkContext*        ctx,
     const Rc<DxvkShader>&     fs,
@@ -213,9 +247,82 @@ namespace dxvk {
 
     ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_GRAPHICS, 0, srcView->imageInfo().sampleCount);
     ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_GRAPHICS, 1, m_gammaView != nullptr);
+    ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_GRAPHICS, 2, m_sharpness);
     ctx->draw(3, 1, 0, 0);
   }
 
+
+
+  void DxvkSwapchainBlitter::dispatch(
+          DxvkContext*        ctx,
+    const Rc<DxvkShader>&     cs,
+    const Rc<DxvkImageView>&  dstView,
+          VkRect2D            dstRect,
+    const Rc<DxvkImageView>&  srcView,
+          VkRect2D            srcRect) {
+    ctx->bindResourceSampler(VK_SHADER_STAGE_COMPUTE_BIT, BindingIds::Image, Rc<DxvkSampler>(m_samplerPresent));
+    ctx->bindResourceSampler(VK_SHADER_STAGE_COMPUTE_BIT, BindingIds::Gamma, Rc<DxvkSampler>(m_samplerGamma));
+
+    ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, BindingIds::Image, Rc<DxvkImageView>(srcView));
+    ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, BindingIds::Gamma, Rc<DxvkImageView>(m_gammaView));
+    ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, BindingIds::Dst,   Rc<DxvkImageView>(dstView));
+
+    ctx->bindShader<VK_SHADER_STAGE_COMPUTE_BIT>(Rc<DxvkShader>(cs));
+
+    ComputeArgs args;
+    args.srcOffset = srcRect.offset;
+    args.srcExtent = srcRect.extent;
+    args.dstOffset = dstRect.offset;
+    args.dstExtent = dstRect.extent;
+
+    ctx->pushConstants(0, sizeof(args), &args);
+
+    ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_COMPUTE, 0, srcView->imageInfo().sampleCount);
+    ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_COMPUTE, 1, m_gammaView != nullptr);
+
+    // Cover the entire image, not just the destination rect
+    VkExtent3D dstExtent = dstView->mipLevelExtent(0);
+
+    ctx->dispatch(
+      (dstExtent.width  + 7) / 8,
+      (dstExtent.height + 7) / 8, 1);
+  }
+
+
+  bool DxvkSwapchainBlitter::canCopy(
+    const Rc<DxvkImageView>&  dstView,
+          VkRect2D            dstRect,
+    const Rc<DxvkImageView>&  srcView,
+          VkRect2D            srcRect) const {
+    VkExtent3D dstExtent = dstView->mipLevelExtent(0);
+
+    return m_gammaView == nullptr
+        && srcView->imageInfo().sampleCount == VK_SAMPLE_COUNT_1_BIT
+        && srcView->imageInfo().format == dstView->imageInfo().format
+        && srcView->info().format == dstView->info().format
+        && (dstView->imageInfo().usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+        && dstRect.offset.x == 0 && dstRect.offset.y == 0
+        && dstRect.extent.width == dstExtent.width
+        && dstRect.extent.height == dstExtent.height
+        && srcRect.extent == dstRect.extent;
+  }
+
+
+  void DxvkSwapchainBlitter::copy(
+          DxvkContext*        ctx,
+    const Rc<DxvkImageView>&  dstView,
+    const Rc<DxvkImageView>&  srcView,
+          VkRect2D            srcRect) {
+    ctx->copyImage(
+      dstView->image(), VkImageSubresourceLayers { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+      VkOffset3D { 0, 0, 0 },
+      srcView->image(), VkImageSubresourceLayers { VK_IMAGE_ASPECT_COLOR_BIT,
+        srcView->info().minLevel, srcView->info().minLayer, 1 },
+      VkOffset3D { srcRect.offset.x, srcRect.offset.y, 0 },
+      VkExtent3D { srcRect.extent.width, srcRect.extent.height, 1 });
+  }
+
+
   void DxvkSwapchainBlitter::resolve(
           DxvkContext*        ctx,
     const Rc<DxvkImageView>&  dstView,
@@ -345,6 +452,32 @@ namespace dxvk {
     m_fsResolve = new DxvkShader(fsInfo, m_device->features().amdShaderFragmentMask
       ? std::move(fsCodeResolveAmd)
       : std::move(fsCodeResolve));
+
+    if (m_sharpness) {
+      SpirvCodeBuffer fsCodeSharpen(dxvk_present_frag_sharpen);
+
+      fsInfo.inputMask = 0x1;
+      m_fsSharpen = new DxvkShader(fsInfo, std::move(fsCodeSharpen));
+    }
+
+    if (getSwapImageUsage(m_device.ptr()) & VK_IMAGE_USAGE_STORAGE_BIT) {
+      SpirvCodeBuffer csCodeBlit(dxvk_present_comp);
+      SpirvCodeBuffer csCodeResolve(dxvk_present_comp_ms);
+
+      const std::array<DxvkBindingInfo, 3> csBindings = {{
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, BindingIds::Image, VK_IMAGE_VIEW_TYPE_2D, VK_SHADER_STAGE_COMPUTE_BIT, VK_ACCESS_SHADER_READ_BIT  },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, BindingIds::Gamma, VK_IMAGE_VIEW_TYPE_1D, VK_SHADER_STAGE_COMPUTE_BIT, VK_ACCESS_SHADER_READ_BIT  },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          BindingIds::Dst,   VK_IMAGE_VIEW_TYPE_2D, VK_SHADER_STAGE_COMPUTE_BIT, VK_ACCESS_SHADER_WRITE_BIT },
+      }};
+
+      DxvkShaderCreateInfo csInfo;
+      csInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+      csInfo.bindingCount = csBindings.size();
+      csInfo.bindings = csBindings.data();
+      csInfo.pushConstSize = sizeof(ComputeArgs);
+      m_csBlit = new DxvkShader(csInfo, std::move(csCodeBlit));
+      m_csResolve = new DxvkShader(csInfo, std::move(csCodeResolve));
+    }
   }
 
   void DxvkSwapchainBlitter::createResolveImage(const DxvkImageCreateInfo& info) {
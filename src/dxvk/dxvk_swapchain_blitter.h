@@ -54,11 +54,33 @@ namespace dxvk {
             uint32_t            cpCount,
       const DxvkGammaCp*        cpData);
 
+    /**
+     * \brief Queries additional swap image usage
+     *
+     * Returns the usage flags that swap chain images should
+     * be created with in order to use the compute path, if
+     * it is enabled and supported by the device. Swap chain
+     * image views must include storage usage for the blitter
+     * to use the compute path.
+     * \param [in] device The device
+     * \returns Desired swap image usage flags
+     */
+    static VkImageUsageFlags getSwapImageUsage(
+            DxvkDevice*         device);
+
   private:
 
     enum BindingIds : uint32_t {
       Image = 0,
       Gamma = 1,
+      Dst   = 2,
+    };
+
+    struct ComputeArgs {
+      VkOffset2D srcOffset;
+      VkExtent2D srcExtent;
+      VkOffset2D dstOffset;
+      VkExtent2D dstExtent;
     };
 
     struct PresenterArgs {
@@ -70,12 +92,17 @@ namespace dxvk {
     };
 
     Rc<DxvkDevice>      m_device;
+    uint32_t            m_sharpness = 0;
 
     Rc<DxvkShader>      m_fsCopy;
     Rc<DxvkShader>      m_fsBlit;
+    Rc<DxvkShader>      m_fsSharpen;
     Rc<DxvkShader>      m_fsResolve;
     Rc<DxvkShader>      m_vs;
 
+    Rc<DxvkShader>      m_csBlit;
+    Rc<DxvkShader>      m_csResolve;
+
     Rc<DxvkBuffer>      m_gammaBuffer;
     Rc<DxvkImage>       m_gammaImage;
     Rc<DxvkImageView>   m_gammaView;
@@ -97,6 +124,26 @@ namespace dxvk {
       const Rc<DxvkImageView>&  srcView,
             VkRect2D            srcRect);
 
+    bool canCopy(
+      const Rc<DxvkImageView>&  dstView,
+            VkRect2D            dstRect,
+      const Rc<DxvkImageView>&  srcView,
+            VkRect2D            srcRect) const;
+
+    void copy(
+            DxvkContext*        ctx,
+      const Rc<DxvkImageView>&  dstView,
+      const Rc<DxvkImageView>&  srcView,
+            VkRect2D            srcRect);
+
+    void dispatch(
+            DxvkContext*        ctx,
+      const Rc<DxvkShader>&     cs,
+      const Rc<DxvkImageView>&  dstView,
+            VkRect2D            dstRect,
+      const Rc<DxvkImageView>&  srcView,
+            VkRect2D            srcRect);
+
     void resolve(
             DxvkContext*        ctx,
       const Rc<DxvkImageView>&  dstView,
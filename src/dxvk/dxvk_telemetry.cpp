@@ -0,0 +1,170 @@
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "dxvk_device.h"
+#include "dxvk_telemetry.h"
+
+namespace dxvk {
+
+  DxvkTelemetry::DxvkTelemetry()
+  : m_startTime (high_resolution_clock::now()),
+    m_lastFrame (m_startTime) {
+    m_size = sizeof(DxvkTelemetryHeader)
+           + sizeof(DxvkTelemetryFrame) * DxvkTelemetryFrameCount;
+
+    if (!createMapping()) {
+      Logger::err(str::format("DXVK: Failed to create telemetry block ", m_name));
+      return;
+    }
+
+    // Shared memory is zero-initialized, so only
+    // the atomics need to be constructed in place
+    m_header = new (m_mapping) DxvkTelemetryHeader();
+    m_frames = reinterpret_cast<DxvkTelemetryFrame*>(m_header + 1);
+
+    for (uint32_t i = 0; i < DxvkTelemetryFrameCount; i++)
+      new (&m_frames[i]) DxvkTelemetryFrame();
+
+    m_header->headerSize = sizeof(DxvkTelemetryHeader);
+    m_header->frameSize  = sizeof(DxvkTelemetryFrame);
+    m_header->frameCount = DxvkTelemetryFrameCount;
+    m_header->processId  = m_processId;
+    m_header->version    = DxvkTelemetryVersion;
+
+    // Readers check the magic number last, so that a
+    // partially initialized header is never accepted
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->magic      = DxvkTelemetryMagic;
+
+    Logger::info(str::format("DXVK: Writing telemetry to ", m_name));
+  }
+
+
+  DxvkTelemetry::~DxvkTelemetry() {
+    destroyMapping();
+  }
+
+
+  void DxvkTelemetry::endFrame(
+          DxvkDevice*           device) {
+    if (!m_header)
+      return;
+
+    auto now = high_resolution_clock::now();
+
+    DxvkStatCounters counters = device->getStatCounters();
+
+    uint64_t frameId = m_header->frameIndex.load(std::memory_order_relaxed);
+    DxvkTelemetryFrame& frame = m_frames[frameId % DxvkTelemetryFrameCount];
+
+    // Mark the slot as being written before touching any data
+    frame.sequence.store(2u * frameId + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    frame.frameId       = frameId;
+    frame.timestampUs   = std::chrono::duration_cast<std::chrono::microseconds>(now - m_startTime).count();
+    frame.frameTimeUs   = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastFrame).count();
+    frame.drawCalls     = counters.getCtr(DxvkStatCounter::CmdDrawCalls);
+    frame.dispatchCalls = counters.getCtr(DxvkStatCounter::CmdDispatchCalls);
+    frame.renderPasses  = counters.getCtr(DxvkStatCounter::CmdRenderPassCount);
+    frame.submitCount   = counters.getCtr(DxvkStatCounter::QueueSubmitCount);
+    frame.gpuSyncCount  = counters.getCtr(DxvkStatCounter::GpuSyncCount);
+    frame.gpuSyncTicks  = counters.getCtr(DxvkStatCounter::GpuSyncTicks);
+    frame.gpuIdleTicks  = counters.getCtr(DxvkStatCounter::GpuIdleTicks);
+    frame.csSyncCount   = counters.getCtr(DxvkStatCounter::CsSyncCount);
+    frame.csSyncTicks   = counters.getCtr(DxvkStatCounter::CsSyncTicks);
+    frame.pipelineTasksPending = counters.getCtr(DxvkStatCounter::PipeTasksTotal)
+                               - counters.getCtr(DxvkStatCounter::PipeTasksDone);
+
+    VkPhysicalDeviceMemoryProperties memProps = device->adapter()->memoryProperties();
+    frame.heapCount = memProps.memoryHeapCount;
+
+    for (uint32_t i = 0; i < memProps.memoryHeapCount; i++) {
+      DxvkMemoryStats stats = device->getMemoryStats(i);
+      frame.heapAllocated[i] = stats.memoryAllocated;
+      frame.heapUsed[i]      = stats.memoryUsed;
+    }
+
+    frame.sequence.store(2u * frameId + 2u, std::memory_order_release);
+    m_header->frameIndex.store(frameId + 1u, std::memory_order_release);
+
+    m_lastFrame = now;
+  }
+
+
+#ifdef _WIN32
+  bool DxvkTelemetry::createMapping() {
+    m_processId = GetCurrentProcessId();
+    m_name = str::format("Local\\dxvk-telemetry-", m_processId);
+
+    HANDLE handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr,
+      PAGE_READWRITE, 0, DWORD(m_size), str::tows(m_name.c_str()).c_str());
+
+    if (!handle)
+      return false;
+
+    m_mapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, m_size);
+
+    if (!m_mapping) {
+      CloseHandle(handle);
+      return false;
+    }
+
+    m_handle = handle;
+    return true;
+  }
+
+
+  void DxvkTelemetry::destroyMapping() {
+    if (m_mapping)
+      UnmapViewOfFile(m_mapping);
+
+    if (m_handle)
+      CloseHandle(m_handle);
+  }
+#else
+  bool DxvkTelemetry::createMapping() {
+    m_processId = uint32_t(getpid());
+    m_name = str::format("/dxvk-telemetry-", m_processId);
+
+    int fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+      return false;
+
+    if (ftruncate(fd, off_t(m_size))) {
+      close(fd);
+      shm_unlink(m_name.c_str());
+      return false;
+    }
+
+    void* mapping = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+      shm_unlink(m_name.c_str());
+      return false;
+    }
+
+    m_mapping = mapping;
+    return true;
+  }
+
+
+  void DxvkTelemetry::destroyMapping() {
+    if (!m_mapping)
+      return;
+
+    munmap(m_mapping, m_size);
+    shm_unlink(m_name.c_str());
+  }
+#endif
+
+}
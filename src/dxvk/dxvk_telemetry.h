@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "../util/util_time.h"
+
+#include "dxvk_include.h"
+
+namespace dxvk {
+
+  class DxvkDevice;
+
+  /// Magic number of the shared telemetry block, 'DXVT'
+  constexpr uint32_t DxvkTelemetryMagic = 0x54565844u;
+
+  /// Layout version, bumped on any incompatible change
+  constexpr uint32_t DxvkTelemetryVersion = 1u;
+
+  /// Number of frames kept in the ring
+  constexpr uint32_t DxvkTelemetryFrameCount = 128u;
+
+  /**
+   * \brief Telemetry frame record
+   *
+   * All counters are totals since device creation, so that
+   * readers can compute per-frame values from any two records
+   * without having to observe every single frame.
+   *
+   * The sequence number implements a sequence lock: it is odd
+   * while the writer updates the record, and readers must
+   * discard any copy for which the sequence number changed.
+   */
+  struct DxvkTelemetryFrame {
+    std::atomic<uint64_t> sequence;
+    uint64_t              frameId;
+    uint64_t              timestampUs;
+    uint64_t              frameTimeUs;
+    uint64_t              drawCalls;
+    uint64_t              dispatchCalls;
+    uint64_t              renderPasses;
+    uint64_t              submitCount;
+    uint64_t              gpuSyncCount;
+    uint64_t              gpuSyncTicks;
+    uint64_t              gpuIdleTicks;
+    uint64_t              csSyncCount;
+    uint64_t              csSyncTicks;
+    uint64_t              pipelineTasksPending;
+    uint32_t              heapCount;
+    uint32_t              reserved;
+    uint64_t              heapAllocated[VK_MAX_MEMORY_HEAPS];
+    uint64_t              heapUsed[VK_MAX_MEMORY_HEAPS];
+  };
+
+  /**
+   * \brief Telemetry block header
+   *
+   * Placed at the start of the shared memory block and
+   * followed by \c frameCount frame records. \c frameIndex
+   * is the number of frames written so far, the most recent
+   * record is at index <tt>(frameIndex - 1) % frameCount</tt>.
+   */
+  struct DxvkTelemetryHeader {
+    uint32_t              magic;
+    uint32_t              version;
+    uint32_t              headerSize;
+    uint32_t              frameSize;
+    uint32_t              frameCount;
+    uint32_t              processId;
+    std::atomic<uint64_t> frameIndex;
+  };
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+    "Telemetry requires lock-free 64-bit atomics");
+
+
+  /**
+   * \brief Live telemetry export
+   *
+   * Publishes per-frame device statistics in a named shared
+   * memory block, so that external tools can monitor a running
+   * application without drawing a HUD. The block is named
+   * \c dxvk-telemetry-<pid>, in the \c Local namespace on
+   * Windows and as a POSIX shared memory object otherwise.
+   */
+  class DxvkTelemetry {
+
+  public:
+
+    DxvkTelemetry();
+
+    ~DxvkTelemetry();
+
+    /**
+     * \brief Checks whether the shared block exists
+     * \returns \c true if telemetry can be written
+     */
+    bool isValid() const {
+      return m_header != nullptr;
+    }
+
+    /**
+     * \brief Writes a frame record
+     *
+     * Called once per presented frame.
+     * \param [in] device The device
+     */
+    void endFrame(
+            DxvkDevice*           device);
+
+  private:
+
+    std::string                       m_name;
+    uint32_t                          m_processId = 0;
+
+    void*                             m_handle  = nullptr;
+    void*                             m_mapping = nullptr;
+    size_t                            m_size    = 0;
+
+    DxvkTelemetryHeader*              m_header  = nullptr;
+    DxvkTelemetryFrame*               m_frames  = nullptr;
+
+    high_resolution_clock::time_point m_startTime;
+    high_resolution_clock::time_point m_lastFrame;
+
+    bool createMapping();
+
+    void destroyMapping();
+
+  };
+
+}
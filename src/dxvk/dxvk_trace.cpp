@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "dxvk_trace.h"
+
+#include "../util/util_env.h"
+
+namespace dxvk {
+
+  /// Thread ID used for GPU zones. CPU threads
+  /// are numbered starting from one.
+  constexpr uint32_t GpuThreadId = 0;
+
+  static std::atomic<uint32_t> g_traceThreadCount = { 0u };
+  static thread_local uint32_t g_traceThreadId = 0;
+
+
+  DxvkTracer::DxvkTracer(
+    const std::string&          fileName,
+          float                 timestampPeriod)
+  : m_startTime       (high_resolution_clock::now()),
+    m_timestampPeriod (double(timestampPeriod)),
+    m_file            (str::topath(fileName.c_str()).c_str(), std::ios_base::binary | std::ios_base::trunc) {
+    if (!m_file) {
+      Logger::err(str::format("DXVK: Failed to create trace file ", fileName));
+      return;
+    }
+
+    Logger::info(str::format("DXVK: Writing trace to ", fileName));
+
+    m_file << "[\n";
+    m_threadNames.push_back({ GpuThreadId, "GPU" });
+    m_knownThreads.insert(GpuThreadId);
+  }
+
+
+  DxvkTracer::~DxvkTracer() {
+    flush();
+
+    if (m_file)
+      m_file << "\n]\n";
+  }
+
+
+  void DxvkTracer::addCpuZone(
+    const char*                 name,
+          uint64_t              start,
+          uint64_t              end) {
+    Event event;
+    event.name     = name;
+    event.threadId = getThreadId();
+    event.start    = start;
+    event.duration = end - start;
+
+    addEvent(event);
+  }
+
+
+  void DxvkTracer::addGpuZone(
+    const char*                 name,
+    const Rc<DxvkGpuQuery>&     begin,
+    const Rc<DxvkGpuQuery>&     end) {
+    GpuZone zone;
+    zone.name       = name;
+    zone.begin      = begin;
+    zone.end        = end;
+    zone.submitTime = now();
+
+    std::lock_guard lock(m_gpuMutex);
+    m_gpuZones.push(std::move(zone));
+  }
+
+
+  void DxvkTracer::addGpuPass(
+          std::string&&         name,
+    const Rc<DxvkGpuQuery>&     begin,
+    const Rc<DxvkGpuQuery>&     end,
+    const Rc<DxvkGpuQuery>&     stats) {
+    GpuZone zone;
+    zone.name       = nullptr;
+    zone.passName   = std::move(name);
+    zone.begin      = begin;
+    zone.end        = end;
+    zone.stats      = stats;
+    zone.submitTime = now();
+
+    std::lock_guard lock(m_gpuMutex);
+    m_gpuZones.push(std::move(zone));
+  }
+
+
+  void DxvkTracer::resolveGpuZones() {
+    std::lock_guard lock(m_gpuMutex);
+
+    while (!m_gpuZones.empty()) {
+      GpuZone& zone = m_gpuZones.front();
+
+      DxvkQueryData beginData = { };
+      DxvkQueryData endData = { };
+      DxvkQueryData statsData = { };
+
+      DxvkGpuQueryStatus beginStatus = zone.begin->getData(beginData);
+      DxvkGpuQueryStatus endStatus = zone.end->getData(endData);
+      DxvkGpuQueryStatus statsStatus = zone.stats != nullptr
+        ? zone.stats->getData(statsData)
+        : DxvkGpuQueryStatus::Invalid;
+
+      if (beginStatus == DxvkGpuQueryStatus::Pending
+       || endStatus   == DxvkGpuQueryStatus::Pending
+       || statsStatus == DxvkGpuQueryStatus::Pending)
+        break;
+
+      if (beginStatus == DxvkGpuQueryStatus::Available
+       && endStatus   == DxvkGpuQueryStatus::Available) {
+        int64_t gpuBegin = int64_t(double(beginData.timestamp.time) * m_timestampPeriod);
+        int64_t gpuEnd   = int64_t(double(endData.timestamp.time)   * m_timestampPeriod);
+
+        // Without calibrated timestamps, we can only bound the clock
+        // offset: The zone cannot start before the command list was
+        // submitted, and it must have ended by now. Use the tightest
+        // lower bound seen so far, which is exact whenever the GPU
+        // was idle at submission time, and clamp it to the upper
+        // bound to compensate for clock drift.
+        int64_t minOffset = int64_t(zone.submitTime) - gpuBegin;
+        int64_t maxOffset = int64_t(now()) - gpuEnd;
+
+        if (!m_gpuOffsetValid || minOffset > m_gpuOffset)
+          m_gpuOffset = minOffset;
+
+        m_gpuOffset = std::min(m_gpuOffset, maxOffset);
+        m_gpuOffsetValid = true;
+
+        uint64_t start    = uint64_t(std::max<int64_t>(gpuBegin + m_gpuOffset, 0));
+        uint64_t duration = uint64_t(std::max<int64_t>(gpuEnd - gpuBegin, 0));
+
+        if (zone.name) {
+          Event event;
+          event.name     = zone.name;
+          event.threadId = GpuThreadId;
+          event.start    = start;
+          event.duration = duration;
+
+          addEvent(event);
+        } else {
+          PassEvent event;
+          event.name     = std::move(zone.passName);
+          event.start    = start;
+          event.duration = duration;
+          event.hasStats = statsStatus == DxvkGpuQueryStatus::Available;
+          event.stats    = statsData.statistic;
+
+          std::lock_guard lock(m_mutex);
+          m_passEvents.push_back(std::move(event));
+        }
+      }
+
+      m_gpuZones.pop();
+    }
+  }
+
+
+  void DxvkTracer::flush() {
+    resolveGpuZones();
+
+    { std::lock_guard lock(m_gpuMutex);
+      m_gpuZones = std::queue<GpuZone>();
+    }
+
+    flushEvents();
+  }
+
+
+  void DxvkTracer::endFrame() {
+    // Frame markers are stored with a null name,
+    // the duration field stores the frame number.
+    Event event;
+    event.name     = nullptr;
+    event.threadId = getThreadId();
+    event.start    = now();
+    event.duration = m_frameId++;
+
+    addEvent(event);
+    flushEvents();
+  }
+
+
+  void DxvkTracer::addEvent(
+    const Event&                event) {
+    std::lock_guard lock(m_mutex);
+
+    if (unlikely(m_knownThreads.insert(event.threadId).second)) {
+      std::string name = env::getThreadName();
+
+      if (name.empty())
+        name = str::format("thread-", event.threadId);
+
+      m_threadNames.push_back({ event.threadId, std::move(name) });
+    }
+
+    m_events.push_back(event);
+  }
+
+
+  void DxvkTracer::flushEvents() {
+    std::vector<Event> events;
+    std::vector<PassEvent> passEvents;
+    std::vector<std::pair<uint32_t, std::string>> threadNames;
+
+    { std::lock_guard lock(m_mutex);
+      events = std::exchange(m_events, std::vector<Event>());
+      passEvents = std::exchange(m_passEvents, std::vector<PassEvent>());
+      threadNames = std::exchange(m_threadNames, { });
+      m_events.reserve(events.size());
+    }
+
+    std::lock_guard lock(m_fileMutex);
+
+    if (!m_file)
+      return;
+
+    char json[256];
+
+    for (const auto& thread : threadNames) {
+      std::snprintf(json, sizeof(json),
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+        thread.first, thread.second.c_str());
+      writeEvent(json);
+    }
+
+    for (const auto& event : events) {
+      // Chrome expects timestamps in microseconds
+      double ts = double(event.start) / 1000.0;
+
+      if (event.name) {
+        std::snprintf(json, sizeof(json),
+          "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+          event.name, event.threadId, ts, double(event.duration) / 1000.0);
+      } else {
+        std::snprintf(json, sizeof(json),
+          "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"frame\":%llu}}",
+          event.threadId, ts, static_cast<unsigned long long>(event.duration));
+      }
+
+      writeEvent(json);
+    }
+
+    for (const auto& event : passEvents) {
+      std::snprintf(json, sizeof(json),
+        "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+        GpuThreadId, double(event.start) / 1000.0, double(event.duration) / 1000.0);
+
+      std::string passJson = str::format("{\"name\":\"", escapeName(event.name), json);
+
+      if (event.hasStats) {
+        const auto& stats = event.stats;
+
+        passJson += str::format(",\"args\":{",
+          "\"iaVertices\":", stats.iaVertices, ",",
+          "\"iaPrimitives\":", stats.iaPrimitives, ",",
+          "\"vsInvocations\":", stats.vsInvocations, ",",
+          "\"gsInvocations\":", stats.gsInvocations, ",",
+          "\"clipPrimitives\":", stats.clipPrimitives, ",",
+          "\"psInvocations\":", stats.fsInvocations, ",",
+          "\"hsPatches\":", stats.tcsPatches, ",",
+          "\"dsInvocations\":", stats.tesInvocations, ",",
+          "\"csInvocations\":", stats.csInvocations, "}");
+      }
+
+      passJson += "}";
+      writeEvent(passJson.c_str());
+    }
+
+    m_file.flush();
+  }
+
+
+  std::string DxvkTracer::escapeName(
+    const std::string&          name) {
+    std::string result;
+    result.reserve(name.size());
+
+    for (char c : name) {
+      // Pass names come from the application, so drop
+      // anything that would need escaping in JSON
+      if (c == '"' || c == '\\' || uint8_t(c) < 0x20)
+        result.push_back('_');
+      else
+        result.push_back(c);
+    }
+
+    return result;
+  }
+
+
+  void DxvkTracer::writeEvent(
+    const char*                 json) {
+    if (!m_fileEmpty)
+      m_file << ",\n";
+
+    m_file << json;
+    m_fileEmpty = false;
+  }
+
+
+  uint32_t DxvkTracer::getThreadId() {
+    if (unlikely(!g_traceThreadId))
+      g_traceThreadId = ++g_traceThreadCount;
+
+    return g_traceThreadId;
+  }
+
+}
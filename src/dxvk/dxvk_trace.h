@@ -0,0 +1,219 @@
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <queue>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_likely.h"
+#include "../util/util_time.h"
+
+#include "dxvk_gpu_query.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Timeline tracer
+   *
+   * Records named CPU zones from any thread as well as GPU
+   * zones based on timestamp queries, and writes them to a
+   * JSON file in the Chrome trace event format, which can
+   * be loaded into \c chrome://tracing or Perfetto.
+   *
+   * Events are buffered in memory and written to the file
+   * once per frame. Zone names must be string literals or
+   * otherwise outlive the tracer, since only the pointer
+   * is stored.
+   */
+  class DxvkTracer {
+
+  public:
+
+    DxvkTracer(
+      const std::string&          fileName,
+            float                 timestampPeriod);
+
+    ~DxvkTracer();
+
+    /**
+     * \brief Queries current time
+     * \returns Time since tracer creation, in ns
+     */
+    uint64_t now() const {
+      auto t = high_resolution_clock::now();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(t - m_startTime).count();
+    }
+
+    /**
+     * \brief Adds a CPU zone
+     *
+     * The zone is attributed to the calling thread.
+     * \param [in] name Zone name
+     * \param [in] start Start time, as returned by \ref now
+     * \param [in] end End time, as returned by \ref now
+     */
+    void addCpuZone(
+      const char*                 name,
+            uint64_t              start,
+            uint64_t              end);
+
+    /**
+     * \brief Adds a GPU zone
+     *
+     * Must be called after both timestamps have been recorded,
+     * but before the command list gets submitted, since the
+     * current time is used to align GPU and CPU timelines.
+     * \param [in] name Zone name
+     * \param [in] begin Timestamp query at the start of the zone
+     * \param [in] end Timestamp query at the end of the zone
+     */
+    void addGpuZone(
+      const char*                 name,
+      const Rc<DxvkGpuQuery>&     begin,
+      const Rc<DxvkGpuQuery>&     end);
+
+    /**
+     * \brief Adds a named GPU pass
+     *
+     * Same as \ref addGpuZone, but takes ownership of the
+     * name and optionally attaches pipeline statistics,
+     * which are written as arguments of the trace event.
+     * \param [in] name Pass name
+     * \param [in] begin Timestamp query at the start of the pass
+     * \param [in] end Timestamp query at the end of the pass
+     * \param [in] stats Pipeline statistics query, may be \c nullptr
+     */
+    void addGpuPass(
+            std::string&&         name,
+      const Rc<DxvkGpuQuery>&     begin,
+      const Rc<DxvkGpuQuery>&     end,
+      const Rc<DxvkGpuQuery>&     stats);
+
+    /**
+     * \brief Resolves pending GPU zones
+     *
+     * Reads back timestamps for all GPU zones that have
+     * completed execution. Should be called whenever a
+     * command list has finished executing.
+     */
+    void resolveGpuZones();
+
+    /**
+     * \brief Flushes all pending events
+     *
+     * Resolves GPU zones, discards those that are
+     * still pending, and writes all buffered events.
+     * Must be called before the device destroys its
+     * query pools, since GPU zones reference queries.
+     */
+    void flush();
+
+    /**
+     * \brief Marks the end of a frame
+     *
+     * Adds a frame marker and writes
+     * buffered events to the trace file.
+     */
+    void endFrame();
+
+  private:
+
+    struct Event {
+      const char* name;
+      uint32_t    threadId;
+      uint64_t    start;
+      uint64_t    duration;
+    };
+
+    struct PassEvent {
+      std::string             name;
+      uint64_t                start;
+      uint64_t                duration;
+      bool                    hasStats;
+      DxvkQueryStatisticData  stats;
+    };
+
+    struct GpuZone {
+      const char*       name;
+      std::string       passName;
+      Rc<DxvkGpuQuery>  begin;
+      Rc<DxvkGpuQuery>  end;
+      Rc<DxvkGpuQuery>  stats;
+      uint64_t          submitTime;
+    };
+
+    high_resolution_clock::time_point m_startTime;
+    double                            m_timestampPeriod;
+
+    std::atomic<uint64_t>             m_frameId = { 0ull };
+
+    dxvk::mutex                       m_mutex;
+    std::vector<Event>                m_events;
+    std::vector<PassEvent>            m_passEvents;
+    std::vector<std::pair<uint32_t, std::string>> m_threadNames;
+    std::unordered_set<uint32_t>      m_knownThreads;
+
+    dxvk::mutex                       m_gpuMutex;
+    std::queue<GpuZone>               m_gpuZones;
+    int64_t                           m_gpuOffset = 0;
+    bool                              m_gpuOffsetValid = false;
+
+    dxvk::mutex                       m_fileMutex;
+    std::ofstream                     m_file;
+    bool                              m_fileEmpty = true;
+
+    void addEvent(
+      const Event&                event);
+
+    void flushEvents();
+
+    void writeEvent(
+      const char*                 json);
+
+    static uint32_t getThreadId();
+
+    static std::string escapeName(
+      const std::string&          name);
+
+  };
+
+
+  /**
+   * \brief Scoped CPU trace zone
+   *
+   * Records a CPU zone spanning the lifetime of the
+   * object. Does nothing if the tracer is \c nullptr,
+   * so that zones can be placed on hot paths.
+   */
+  class DxvkTraceScope {
+
+  public:
+
+    DxvkTraceScope(
+            DxvkTracer*           tracer,
+      const char*                 name)
+    : m_tracer(tracer), m_name(name) {
+      if (unlikely(m_tracer))
+        m_start = m_tracer->now();
+    }
+
+    ~DxvkTraceScope() {
+      if (unlikely(m_tracer))
+        m_tracer->addCpuZone(m_name, m_start, m_tracer->now());
+    }
+
+    DxvkTraceScope             (const DxvkTraceScope&) = delete;
+    DxvkTraceScope& operator = (const DxvkTraceScope&) = delete;
+
+  private:
+
+    DxvkTracer* m_tracer;
+    const char* m_name;
+    uint64_t    m_start = 0;
+
+  };
+
+}
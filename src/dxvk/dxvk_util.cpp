@@ -3,6 +3,8 @@
 #include "dxvk_format.h"
 #include "dxvk_util.h"
 
+#include "../util/util_bit.h"
+
 namespace dxvk::util {
   
   uint32_t computeMipLevelCount(VkExtent3D imageSize) {
@@ -37,19 +39,21 @@ namespace dxvk::util {
                          && ((bytesPerLayer == pitchPerLayer) || (blockCount.depth  == 1));
     
     if (directCopy) {
-      std::memcpy(dstData, srcData, bytesTotal);
+      bit::bstream(dstData, srcData, bytesTotal);
     } else {
       for (uint32_t i = 0; i < blockCount.depth; i++) {
         for (uint32_t j = 0; j < blockCount.height; j++) {
-          std::memcpy(
+          bit::bstream(
             dstData + j * bytesPerRow,
             srcData + j * pitchPerRow,
-            bytesPerRow);
+            bytesPerRow, false);
         }
         
         srcData += pitchPerLayer;
         dstData += bytesPerLayer;
       }
+
+      bit::sfence();
     }
   }
   
@@ -95,7 +99,7 @@ namespace dxvk::util {
                              && ((bytesPerSlice == srcSlicePitch && bytesPerSlice == dstSlicePitch) || (blockCount.depth  == 1));
 
         if (directCopy) {
-          std::memcpy(dstData, srcData, bytesTotal);
+          bit::bstream(dstData, srcData, bytesTotal, false);
 
           switch (imageType) {
             case VK_IMAGE_TYPE_1D:
@@ -115,10 +119,10 @@ namespace dxvk::util {
         } else {
           for (uint32_t i = 0; i < blockCount.depth; i++) {
             for (uint32_t j = 0; j < blockCount.height; j++) {
-              std::memcpy(
+              bit::bstream(
                 dstData + j * dstRowPitch,
                 srcData + j * srcRowPitch,
-                bytesPerRow);
+                bytesPerRow, false);
             }
 
             switch (imageType) {
@@ -140,6 +144,8 @@ namespace dxvk::util {
         }
       }
     }
+
+    bit::sfence();
   }
 
 
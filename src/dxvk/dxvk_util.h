@@ -251,6 +251,21 @@ namespace dxvk::util {
       std::min(extent.depth,  imageExtent.depth  - uint32_t(offset.z)) };
   }
   
+  /**
+   * \brief Checks whether two image regions overlap
+   * 
+   * \param [in] aOffset Offset of the first region
+   * \param [in] aExtent Extent of the first region
+   * \param [in] bOffset Offset of the second region
+   * \param [in] bExtent Extent of the second region
+   * \returns \c true if the regions overlap
+   */
+  inline bool checkRegionOverlap(VkOffset3D aOffset, VkExtent3D aExtent, VkOffset3D bOffset, VkExtent3D bExtent) {
+    return aOffset.x < bOffset.x + int32_t(bExtent.width)  && bOffset.x < aOffset.x + int32_t(aExtent.width)
+        && aOffset.y < bOffset.y + int32_t(bExtent.height) && bOffset.y < aOffset.y + int32_t(aExtent.height)
+        && aOffset.z < bOffset.z + int32_t(bExtent.depth)  && bOffset.z < aOffset.z + int32_t(aExtent.depth);
+  }
+  
   /**
    * \brief Computes block extent for compressed images
    * 
@@ -40,13 +40,17 @@ namespace dxvk::hud {
     addItem<HudDeviceInfoItem>("devinfo", -1, m_device);
     addItem<HudFpsItem>("fps", -1);
     addItem<HudFrameTimeItem>("frametimes", -1);
+    addItem<HudFrameStatsItem>("framestats", -1, device);
     addItem<HudSubmissionStatsItem>("submissions", -1, device);
     addItem<HudDrawCallStatsItem>("drawcalls", -1, device);
     addItem<HudPipelineStatsItem>("pipelines", -1, device);
     addItem<HudDescriptorStatsItem>("descriptors", -1, device);
     addItem<HudMemoryStatsItem>("memory", -1, device);
     addItem<HudCsThreadItem>("cs", -1, device);
+    addItem<HudCsSyncItem>("cssync", -1, device);
     addItem<HudGpuLoadItem>("gpuload", -1, device);
+    addItem<HudGpuPassItem>("gpupasses", -1, device,
+      m_hudItems.getOption<int32_t>("gpupasscount", 8));
     addItem<HudCompilerActivityItem>("compiler", -1, device);
   }
   
@@ -107,6 +111,7 @@ namespace dxvk::hud {
 
   void Hud::renderHudElements(const Rc<DxvkContext>& ctx) {
     m_hudItems.render(m_renderer);
+    m_renderer.endFrame();
   }
   
 }
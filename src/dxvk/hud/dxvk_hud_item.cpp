@@ -1,5 +1,6 @@
 #include "dxvk_hud_item.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <version.h>
 
@@ -83,6 +84,15 @@ namespace dxvk::hud {
   }
 
 
+  void HudItemSet::parseOption(const std::string& str, int32_t& value) {
+    try {
+      value = std::stoi(str);
+    } catch (const std::invalid_argument&) {
+      return;
+    }
+  }
+
+
   HudPos HudVersionItem::render(
           HudRenderer&      renderer,
           HudPos            position) {
@@ -295,6 +305,195 @@ namespace dxvk::hud {
   }
 
 
+  HudFrameStatsItem::HudFrameStatsItem(const Rc<DxvkDevice>& device)
+  : m_device(device) {
+    const std::string& logFile = m_device->config().frameTimeLog;
+
+    if (!logFile.empty()) {
+      m_log = std::ofstream(str::topath(logFile.c_str()).c_str(),
+        std::ios_base::trunc);
+
+      if (m_log) {
+        m_log << "frame,frame_time_us,cs_sync_us,gpu_sync_us" << std::endl;
+
+        DxvkStatCounters counters = m_device->getStatCounters();
+        m_prevCsSync  = counters.getCtr(DxvkStatCounter::CsSyncTicks);
+        m_prevGpuSync = counters.getCtr(DxvkStatCounter::GpuSyncTicks);
+      } else {
+        Logger::err(str::format("HUD: Failed to open frame time log ", logFile));
+      }
+    }
+  }
+
+
+  HudFrameStatsItem::~HudFrameStatsItem() {
+
+  }
+
+
+  void HudFrameStatsItem::update(dxvk::high_resolution_clock::time_point time) {
+    auto frameTime = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastFrame);
+    m_lastFrame = time;
+
+    float us = float(frameTime.count());
+
+    m_frameTimes[m_frameIndex] = us;
+    m_frameIndex = (m_frameIndex + 1) % NumFrames;
+    m_frameCount = std::min<uint32_t>(m_frameCount + 1, NumFrames);
+
+    if (m_log)
+      writeLog(us);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
+
+    if (elapsed.count() >= UpdateInterval) {
+      updateStats();
+      m_lastUpdate = time;
+    }
+  }
+
+
+  HudPos HudFrameStatsItem::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    std::array<HudGraphPoint, NumBuckets> points;
+
+    uint32_t maxCount = 1;
+
+    for (uint32_t i = 0; i < NumBuckets; i++)
+      maxCount = std::max(maxCount, m_histogram[i]);
+
+    // Color buckets the same way as the frame time graph,
+    // i.e. green for 60 FPS and red for 20 FPS or worse
+    const float targetUs = 16'666.6f;
+
+    for (uint32_t i = 0; i < NumBuckets; i++) {
+      float us = 1000.0f * std::exp2(std::log2(100.0f) * (float(i) + 0.5f) / float(NumBuckets));
+
+      float r = std::min(std::max(-1.0f + us / targetUs, 0.0f), 1.0f);
+      float g = std::min(std::max( 3.0f - us / targetUs, 0.0f), 1.0f);
+      float l = std::sqrt(r * r + g * g);
+
+      points[i].value = float(m_histogram[i]) / float(maxCount);
+      points[i].color = {
+        uint8_t(255.0f * (r / l)),
+        uint8_t(255.0f * (g / l)),
+        uint8_t(0), uint8_t(255) };
+    }
+
+    renderer.drawGraph(position,
+      HudPos { float(NumBuckets * 4), 40.0f },
+      points.size(), points.data());
+
+    position.y += 58.0f;
+
+    const std::array<std::pair<const char*, const std::string*>, 5> lines = {{
+      { "p50:",      &m_p50String     },
+      { "p99:",      &m_p99String     },
+      { "1% low:",   &m_low1String    },
+      { "0.1% low:", &m_low01String   },
+      { "Stutter:",  &m_stutterString },
+    }};
+
+    for (const auto& line : lines) {
+      renderer.drawText(12.0f,
+        { position.x, position.y },
+        { 1.0f, 0.25f, 0.25f, 1.0f },
+        line.first);
+
+      renderer.drawText(12.0f,
+        { position.x + 90.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        *line.second);
+
+      position.y += 16.0f;
+    }
+
+    position.y += 2.0f;
+    return position;
+  }
+
+
+  void HudFrameStatsItem::updateStats() {
+    if (!m_frameCount)
+      return;
+
+    std::vector<float> sorted(m_frameTimes.begin(), m_frameTimes.begin() + m_frameCount);
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t n = sorted.size();
+
+    float p50 = sorted[(n - 1) / 2];
+    float p99 = sorted[((n - 1) * 99) / 100];
+
+    // Lows are the average frame rate of the slowest
+    // 1% and 0.1% of frames, but at least one frame
+    auto computeLow = [&sorted, n] (size_t divisor) {
+      size_t count = std::max<size_t>(n / divisor, 1);
+      double sum = 0.0;
+
+      for (size_t i = n - count; i < n; i++)
+        sum += sorted[i];
+
+      return float(sum / double(count));
+    };
+
+    // Frames taking more than twice as long as
+    // the median frame are considered stutters
+    uint32_t stutters = 0;
+
+    m_histogram.fill(0);
+
+    for (uint32_t i = 0; i < n; i++) {
+      if (sorted[i] > 2.0f * p50)
+        stutters += 1;
+
+      m_histogram[computeBucket(sorted[i])] += 1;
+    }
+
+    m_p50String     = formatMs(p50);
+    m_p99String     = formatMs(p99);
+    m_low1String    = formatFps(computeLow(100));
+    m_low01String   = formatFps(computeLow(1000));
+    m_stutterString = str::format(stutters, " / ", n);
+  }
+
+
+  void HudFrameStatsItem::writeLog(float frameTimeUs) {
+    DxvkStatCounters counters = m_device->getStatCounters();
+
+    uint64_t csSync  = counters.getCtr(DxvkStatCounter::CsSyncTicks);
+    uint64_t gpuSync = counters.getCtr(DxvkStatCounter::GpuSyncTicks);
+
+    m_log << m_logFrameId++ << ","
+          << uint64_t(frameTimeUs) << ","
+          << (csSync - m_prevCsSync) << ","
+          << (gpuSync - m_prevGpuSync) << "\n";
+
+    m_prevCsSync  = csSync;
+    m_prevGpuSync = gpuSync;
+  }
+
+
+  uint32_t HudFrameStatsItem::computeBucket(float frameTimeUs) {
+    // Logarithmic buckets between 1 ms and 100 ms
+    float x = std::log2(std::max(frameTimeUs / 1000.0f, 1.0f)) / std::log2(100.0f);
+    return std::min(uint32_t(x * float(NumBuckets)), uint32_t(NumBuckets - 1));
+  }
+
+
+  std::string HudFrameStatsItem::formatMs(float us) {
+    uint32_t tenthsMs = uint32_t(us / 100.0f);
+    return str::format(tenthsMs / 10, ".", tenthsMs % 10, " ms");
+  }
+
+
+  std::string HudFrameStatsItem::formatFps(float us) {
+    uint32_t tenthsFps = us > 0.0f ? uint32_t(10'000'000.0f / us) : 0u;
+    return str::format(tenthsFps / 10, ".", tenthsFps % 10, " FPS");
+  }
+
+
   HudSubmissionStatsItem::HudSubmissionStatsItem(const Rc<DxvkDevice>& device)
   : m_device(device) {
 
@@ -312,6 +511,12 @@ namespace dxvk::hud {
     uint64_t currSubmitCount = counters.getCtr(DxvkStatCounter::QueueSubmitCount);
     uint64_t currSyncCount = counters.getCtr(DxvkStatCounter::GpuSyncCount);
     uint64_t currSyncTicks = counters.getCtr(DxvkStatCounter::GpuSyncTicks);
+    uint64_t currLatency = counters.getCtr(DxvkStatCounter::QueueSubmitLatency);
+    uint64_t currDepthSum = counters.getCtr(DxvkStatCounter::QueueDepthSum);
+
+    m_sumSubmitCount += currSubmitCount - m_prevSubmitCount;
+    m_sumLatency += currLatency - m_prevLatency;
+    m_sumDepth += currDepthSum - m_prevDepthSum;
 
     m_maxSubmitCount = std::max(m_maxSubmitCount, currSubmitCount - m_prevSubmitCount);
     m_maxSyncCount = std::max(m_maxSyncCount, currSyncCount - m_prevSyncCount);
@@ -320,6 +525,8 @@ namespace dxvk::hud {
     m_prevSubmitCount = currSubmitCount;
     m_prevSyncCount = currSyncCount;
     m_prevSyncTicks = currSyncTicks;
+    m_prevLatency = currLatency;
+    m_prevDepthSum = currDepthSum;
 
     auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
 
@@ -332,6 +539,21 @@ namespace dxvk::hud {
         ? str::format(m_maxSyncCount, " (", (syncTicks / 10), ".", (syncTicks % 10), " ms)")
         : str::format(m_maxSyncCount);
 
+      if (m_sumSubmitCount) {
+        uint64_t latency = m_sumLatency / m_sumSubmitCount;
+        uint64_t depth = (10 * m_sumDepth) / m_sumSubmitCount;
+
+        m_latencyString = str::format(latency, " us (depth ", depth / 10, ".", depth % 10, ")");
+      } else {
+        m_latencyString = "-";
+      }
+
+      m_sumSubmitCount = 0;
+      m_sumLatency = 0;
+      m_sumDepth = 0;
+
+      m_pacingString = str::format(counters.getCtr(DxvkStatCounter::QueueFlushPacing), "%");
+
       m_maxSubmitCount = 0;
       m_maxSyncCount = 0;
       m_maxSyncTicks = 0;
@@ -367,6 +589,28 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       m_syncString);
 
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 1.0f, 0.5f, 0.25f, 1.0f },
+      "Submit latency:");
+
+    renderer.drawText(16.0f,
+      { position.x + 228.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_latencyString);
+
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 1.0f, 0.5f, 0.25f, 1.0f },
+      "Flush pacing:");
+
+    renderer.drawText(16.0f,
+      { position.x + 228.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_pacingString);
+
     position.y += 8.0f;
     return position;
   }
@@ -468,9 +712,21 @@ namespace dxvk::hud {
   void HudPipelineStatsItem::update(dxvk::high_resolution_clock::time_point time) {
     DxvkStatCounters counters = m_device->getStatCounters();
 
+    DxvkStatCounters diffCounters = counters.diff(m_prevCounters);
+
     m_graphicsPipelines = counters.getCtr(DxvkStatCounter::PipeCountGraphics);
     m_graphicsLibraries = counters.getCtr(DxvkStatCounter::PipeCountLibrary);
     m_computePipelines  = counters.getCtr(DxvkStatCounter::PipeCountCompute);
+
+    uint64_t drawCount = diffCounters.getCtr(DxvkStatCounter::CmdDrawCalls);
+
+    m_baseDraws = diffCounters.getCtr(DxvkStatCounter::CmdDrawCallsBase);
+    m_optimizedDraws = drawCount - std::min(drawCount, m_baseDraws);
+    m_skippedDraws = diffCounters.getCtr(DxvkStatCounter::CmdDrawCallsSkipped);
+
+    m_codeStats = m_device->getShaderCodeStats();
+
+    m_prevCounters = counters;
   }
 
 
@@ -499,6 +755,30 @@ namespace dxvk::hud {
         { position.x + 240.0f, position.y },
         { 1.0f, 1.0f, 1.0f, 1.0f },
         str::format(m_graphicsLibraries));
+
+      position.y += 20.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 0.25f, 1.0f, 1.0f },
+        "Draws (base / opt):");
+
+      renderer.drawText(16.0f,
+        { position.x + 240.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        str::format(m_baseDraws, " / ", m_optimizedDraws));
+    }
+
+    if (m_device->config().enableAsyncPipelines) {
+      position.y += 20.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 0.25f, 1.0f, 1.0f },
+        "Skipped draws:");
+
+      renderer.drawText(16.0f,
+        { position.x + 240.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        str::format(m_skippedDraws));
     }
 
     position.y += 20.0f;
@@ -512,6 +792,30 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       str::format(m_computePipelines));
 
+    if (m_codeStats.evictionCount) {
+      position.y += 20.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 0.25f, 1.0f, 1.0f },
+        "Evicted shaders:");
+
+      renderer.drawText(16.0f,
+        { position.x + 240.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        str::format(m_codeStats.evictedShaders, " (", m_codeStats.evictedSize >> 10, " kB)"));
+
+      position.y += 20.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 0.25f, 1.0f, 1.0f },
+        "Shader reloads:");
+
+      renderer.drawText(16.0f,
+        { position.x + 240.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        str::format(m_codeStats.reloadCount, " / ", m_codeStats.evictionCount));
+    }
+
     position.y += 8.0f;
     return position;
   }
@@ -533,6 +837,7 @@ namespace dxvk::hud {
 
     m_descriptorPoolCount = counters.getCtr(DxvkStatCounter::DescriptorPoolCount);
     m_descriptorSetCount  = counters.getCtr(DxvkStatCounter::DescriptorSetCount);
+    m_samplerCount        = counters.getCtr(DxvkStatCounter::SamplerCount);
   }
 
 
@@ -561,6 +866,17 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       str::format(m_descriptorSetCount));
 
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 1.0f, 0.25f, 0.5f, 1.0f },
+      "Samplers:");
+
+    renderer.drawText(16.0f,
+      { position.x + 216.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      str::format(m_samplerCount));
+
     position.y += 8.0f;
     return position;
   }
@@ -580,6 +896,11 @@ namespace dxvk::hud {
   void HudMemoryStatsItem::update(dxvk::high_resolution_clock::time_point time) {
     for (uint32_t i = 0; i < m_memory.memoryHeapCount; i++)
       m_heaps[i] = m_device->getMemoryStats(i);
+
+    m_bar = m_device->getBarStats();
+    m_categories = m_device->getMemoryCategoryStats();
+
+    m_compressedImages = m_device->getStatCounters().getCtr(DxvkStatCounter::ImageCompressedCount);
   }
 
 
@@ -610,6 +931,67 @@ namespace dxvk::hud {
       position.y += 4.0f;
     }
 
+    if (m_bar.heapSize) {
+      uint64_t smallMib = m_bar.memoryUsed[uint32_t(DxvkBarCategory::Small)] >> 20;
+      uint64_t largeMib = m_bar.memoryUsed[uint32_t(DxvkBarCategory::Large)] >> 20;
+      uint64_t largeLimitMib = m_bar.memoryLimit[uint32_t(DxvkBarCategory::Large)] >> 20;
+
+      std::string text = str::format(std::setfill(' '), std::setw(5), smallMib, " MB small ",
+        std::setw(5), largeMib, " / ", largeLimitMib, " MB large");
+
+      position.y += 16.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 1.0f, 0.25f, 1.0f },
+        m_bar.resizable ? "ReBAR vidmem: " : "BAR vidmem: ");
+
+      renderer.drawText(16.0f,
+        { position.x + 168.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        text);
+      position.y += 4.0f;
+    }
+
+    static const std::array<const char*, DxvkMemoryCategoryCount> categoryNames = {
+      "Other:", "Render targets:", "Textures:", "Constant buffers:", "Geometry:", "Staging:",
+    };
+
+    position.y += 4.0f;
+
+    for (uint32_t i = 0; i < DxvkMemoryCategoryCount; i++) {
+      uint64_t vidmemMib = m_categories.vidmemUsed[i] >> 20;
+      uint64_t sysmemMib = m_categories.sysmemUsed[i] >> 20;
+
+      std::string text = str::format(std::setfill(' '), std::setw(5), vidmemMib, " MB vid ",
+        std::setw(5), sysmemMib, " MB sys");
+
+      position.y += 16.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 1.0f, 0.25f, 1.0f },
+        categoryNames[i]);
+
+      renderer.drawText(16.0f,
+        { position.x + 168.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        text);
+      position.y += 4.0f;
+    }
+
+    if (m_compressedImages) {
+      position.y += 20.0f;
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 1.0f, 0.25f, 1.0f },
+        "Compressed images:");
+
+      renderer.drawText(16.0f,
+        { position.x + 168.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        str::format(m_compressedImages));
+      position.y += 4.0f;
+    }
+
     position.y += 4.0f;
     return position;
   }
@@ -648,9 +1030,14 @@ namespace dxvk::hud {
       uint64_t diffCsChunks = (currCsChunks - m_prevCsChunks) / m_updateCount;
       m_prevCsChunks = currCsChunks;
 
+      uint64_t currCsSkipped = counters.getCtr(DxvkStatCounter::CsRedundantCmds);
+      uint64_t diffCsSkipped = (currCsSkipped - m_prevCsSkipped) / m_updateCount;
+      m_prevCsSkipped = currCsSkipped;
+
       uint64_t syncTicks = m_maxCsSyncTicks / 100;
 
       m_csChunkString = str::format(diffCsChunks);
+      m_csSkippedString = str::format(diffCsSkipped);
       m_csSyncString = m_maxCsSyncCount
         ? str::format(m_maxCsSyncCount, " (", (syncTicks / 10), ".", (syncTicks % 10), " ms)")
         : str::format(m_maxCsSyncCount);
@@ -689,6 +1076,99 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       m_csSyncString);
 
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 1.0f, 0.25f, 1.0f },
+      "CS skipped:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_csSkippedString);
+
+    position.y += 8.0f;
+    return position;
+  }
+
+
+  HudCsSyncItem::HudCsSyncItem(const Rc<DxvkDevice>& device)
+  : m_device(device) {
+    DxvkStatCounters counters = m_device->getStatCounters();
+
+    for (uint32_t i = 0; i < DxvkCsSyncReasonCount; i++) {
+      m_prevCount[i] = counters.getCtr(getCsSyncCountCtr(DxvkCsSyncReason(i)));
+      m_prevTicks[i] = counters.getCtr(getCsSyncTicksCtr(DxvkCsSyncReason(i)));
+    }
+  }
+
+
+  HudCsSyncItem::~HudCsSyncItem() {
+
+  }
+
+
+  void HudCsSyncItem::update(dxvk::high_resolution_clock::time_point time) {
+    uint64_t ticks = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate).count();
+
+    m_frameCount++;
+
+    if (ticks < UpdateInterval)
+      return;
+
+    DxvkStatCounters counters = m_device->getStatCounters();
+    m_entries.clear();
+
+    for (uint32_t i = 0; i < DxvkCsSyncReasonCount; i++) {
+      auto reason = DxvkCsSyncReason(i);
+
+      uint64_t currCount = counters.getCtr(getCsSyncCountCtr(reason));
+      uint64_t currTicks = counters.getCtr(getCsSyncTicksCtr(reason));
+
+      uint64_t diffCount = currCount - m_prevCount[i];
+      uint64_t diffTicks = currTicks - m_prevTicks[i];
+
+      m_prevCount[i] = currCount;
+      m_prevTicks[i] = currTicks;
+
+      if (!diffCount)
+        continue;
+
+      // Show averages per frame with one decimal place
+      uint64_t count = (10 * diffCount) / m_frameCount;
+      uint64_t syncTime = diffTicks / (100 * m_frameCount);
+
+      m_entries.push_back({ getCsSyncReasonName(reason),
+        str::format(count / 10, ".", count % 10, " (", syncTime / 10, ".", syncTime % 10, " ms)") });
+    }
+
+    m_frameCount = 0;
+    m_lastUpdate = time;
+  }
+
+
+  HudPos HudCsSyncItem::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    position.y += 16.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 1.0f, 0.25f, 1.0f },
+      m_entries.empty() ? "CS syncs: 0" : "CS syncs per frame:");
+
+    for (const auto& entry : m_entries) {
+      position.y += 20.0f;
+      renderer.drawText(16.0f,
+        { position.x + 16.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        str::format(entry.name, ":"));
+
+      renderer.drawText(16.0f,
+        { position.x + 180.0f, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        entry.text);
+    }
+
     position.y += 8.0f;
     return position;
   }
@@ -745,6 +1225,88 @@ namespace dxvk::hud {
   }
 
 
+  HudGpuPassItem::HudGpuPassItem(const Rc<DxvkDevice>& device, int32_t passCount)
+  : m_device(device), m_passCount(uint32_t(std::clamp(passCount, 1, 32))) {
+    m_device->gpuProfiler().enable();
+  }
+
+
+  HudGpuPassItem::~HudGpuPassItem() {
+
+  }
+
+
+  void HudGpuPassItem::update(dxvk::high_resolution_clock::time_point time) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
+
+    if (elapsed.count() < UpdateInterval)
+      return;
+
+    std::vector<DxvkGpuPassStats> stats = m_device->gpuProfiler().getFrameStats();
+
+    uint64_t totalNs = 0;
+
+    for (const auto& pass : stats)
+      totalNs += pass.timeNs;
+
+    m_totalString = formatTime(totalNs);
+    m_passes.clear();
+
+    for (uint32_t i = 0; i < stats.size() && i < m_passCount; i++) {
+      PassEntry entry;
+      entry.name = stats[i].name.substr(0, 24);
+
+      if (stats[i].count > 1)
+        entry.name += str::format(" (", stats[i].count, ")");
+
+      entry.time = formatTime(stats[i].timeNs);
+      m_passes.push_back(std::move(entry));
+    }
+
+    m_lastUpdate = time;
+  }
+
+
+  HudPos HudGpuPassItem::render(
+          HudRenderer&      renderer,
+          HudPos            position) {
+    position.y += 16.0f;
+
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 0.5f, 1.0f, 1.0f },
+      "GPU passes:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_totalString);
+
+    for (const auto& pass : m_passes) {
+      position.y += 20.0f;
+
+      renderer.drawText(16.0f,
+        { position.x, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        pass.time);
+
+      renderer.drawText(16.0f,
+        { position.x + 100.0f, position.y },
+        { 0.75f, 0.75f, 0.75f, 1.0f },
+        pass.name);
+    }
+
+    position.y += 8.0f;
+    return position;
+  }
+
+
+  std::string HudGpuPassItem::formatTime(uint64_t ns) {
+    uint64_t us = ns / 1000;
+    return str::format(us / 1000, ".", std::setfill('0'), std::setw(2), (us % 1000) / 10, " ms");
+  }
+
+
   HudCompilerActivityItem::HudCompilerActivityItem(const Rc<DxvkDevice>& device)
   : m_device(device) {
 
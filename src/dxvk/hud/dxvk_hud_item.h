@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <fstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -118,6 +120,8 @@ namespace dxvk::hud {
 
     static void parseOption(const std::string& str, float& value);
 
+    static void parseOption(const std::string& str, int32_t& value);
+
   };
 
 
@@ -237,6 +241,68 @@ namespace dxvk::hud {
   };
 
 
+  /**
+   * \brief HUD item to display frame time statistics
+   *
+   * Computes percentiles, lows and the number of stutters
+   * over a sliding window of frames, and draws a frame time
+   * histogram. Optionally logs every frame to a CSV file.
+   */
+  class HudFrameStatsItem : public HudItem {
+    constexpr static size_t  NumFrames      = 1000;
+    constexpr static size_t  NumBuckets     = 64;
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudFrameStatsItem(const Rc<DxvkDevice>& device);
+
+    ~HudFrameStatsItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    Rc<DxvkDevice> m_device;
+
+    dxvk::high_resolution_clock::time_point m_lastFrame
+      = dxvk::high_resolution_clock::now();
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    std::array<float, NumFrames>  m_frameTimes  = { };
+    uint32_t                      m_frameCount  = 0;
+    uint32_t                      m_frameIndex  = 0;
+
+    std::array<uint32_t, NumBuckets> m_histogram = { };
+
+    std::string m_p50String;
+    std::string m_p99String;
+    std::string m_low1String;
+    std::string m_low01String;
+    std::string m_stutterString;
+
+    std::ofstream m_log;
+    uint64_t      m_logFrameId    = 0;
+    uint64_t      m_prevCsSync    = 0;
+    uint64_t      m_prevGpuSync   = 0;
+
+    void updateStats();
+
+    void writeLog(float frameTimeUs);
+
+    static uint32_t computeBucket(float frameTimeUs);
+
+    static std::string formatMs(float us);
+
+    static std::string formatFps(float us);
+
+  };
+
+
   /**
    * \brief HUD item to display queue statistics
    */
@@ -261,6 +327,12 @@ namespace dxvk::hud {
     uint64_t        m_prevSubmitCount = 0;
     uint64_t        m_prevSyncCount   = 0;
     uint64_t        m_prevSyncTicks   = 0;
+    uint64_t        m_prevLatency     = 0;
+    uint64_t        m_prevDepthSum    = 0;
+
+    uint64_t        m_sumSubmitCount  = 0;
+    uint64_t        m_sumLatency      = 0;
+    uint64_t        m_sumDepth        = 0;
 
     uint64_t        m_maxSubmitCount  = 0;
     uint64_t        m_maxSyncCount    = 0;
@@ -268,6 +340,8 @@ namespace dxvk::hud {
 
     std::string     m_submitString;
     std::string     m_syncString;
+    std::string     m_latencyString;
+    std::string     m_pacingString;
 
     dxvk::high_resolution_clock::time_point m_lastUpdate
       = dxvk::high_resolution_clock::now();
@@ -330,10 +404,18 @@ namespace dxvk::hud {
 
     Rc<DxvkDevice> m_device;
 
+    DxvkStatCounters m_prevCounters;
+
     uint64_t m_graphicsPipelines  = 0;
     uint64_t m_graphicsLibraries  = 0;
     uint64_t m_computePipelines   = 0;
 
+    uint64_t m_baseDraws          = 0;
+    uint64_t m_optimizedDraws     = 0;
+    uint64_t m_skippedDraws       = 0;
+
+    DxvkShaderCodeStats m_codeStats;
+
   };
 
 
@@ -360,6 +442,7 @@ namespace dxvk::hud {
 
     uint64_t m_descriptorPoolCount = 0;
     uint64_t m_descriptorSetCount  = 0;
+    uint64_t m_samplerCount        = 0;
 
   };
 
@@ -386,6 +469,9 @@ namespace dxvk::hud {
     Rc<DxvkDevice>                    m_device;
     VkPhysicalDeviceMemoryProperties  m_memory;
     DxvkMemoryStats                   m_heaps[VK_MAX_MEMORY_HEAPS];
+    DxvkBarStats                      m_bar;
+    DxvkMemoryCategoryStats           m_categories;
+    uint64_t                          m_compressedImages = 0;
 
   };
 
@@ -414,6 +500,7 @@ namespace dxvk::hud {
     uint64_t m_prevCsSyncCount  = 0;
     uint64_t m_prevCsSyncTicks  = 0;
     uint64_t m_prevCsChunks     = 0;
+    uint64_t m_prevCsSkipped    = 0;
 
     uint64_t m_maxCsSyncCount   = 0;
     uint64_t m_maxCsSyncTicks   = 0;
@@ -422,6 +509,50 @@ namespace dxvk::hud {
 
     std::string m_csSyncString;
     std::string m_csChunkString;
+    std::string m_csSkippedString;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+  };
+
+
+  /**
+   * \brief HUD item to display CS thread sync causes
+   *
+   * Shows the average number of CS thread synchronizations
+   * per frame and the time spent in them, for each reason
+   * that caused a sync during the last update interval.
+   */
+  class HudCsSyncItem : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudCsSyncItem(const Rc<DxvkDevice>& device);
+
+    ~HudCsSyncItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    struct Entry {
+      const char* name;
+      std::string text;
+    };
+
+    Rc<DxvkDevice> m_device;
+
+    std::array<uint64_t, DxvkCsSyncReasonCount> m_prevCount = { };
+    std::array<uint64_t, DxvkCsSyncReasonCount> m_prevTicks = { };
+
+    uint64_t m_frameCount = 0;
+
+    std::vector<Entry> m_entries;
 
     dxvk::high_resolution_clock::time_point m_lastUpdate
       = dxvk::high_resolution_clock::now();
@@ -461,6 +592,48 @@ namespace dxvk::hud {
   };
 
 
+  /**
+   * \brief HUD item to display GPU time per pass
+   *
+   * Enables the GPU pass profiler and shows the most
+   * expensive passes of the last complete frame. Passes
+   * are named after the innermost debug label if any.
+   */
+  class HudGpuPassItem : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudGpuPassItem(const Rc<DxvkDevice>& device, int32_t passCount);
+
+    ~HudGpuPassItem();
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    struct PassEntry {
+      std::string name;
+      std::string time;
+    };
+
+    Rc<DxvkDevice> m_device;
+    uint32_t       m_passCount;
+
+    std::string             m_totalString;
+    std::vector<PassEntry>  m_passes;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    static std::string formatTime(uint64_t ns);
+
+  };
+
+
   /**
    * \brief HUD item to display pipeline compiler activity
    */
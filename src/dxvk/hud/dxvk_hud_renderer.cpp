@@ -43,6 +43,13 @@ namespace dxvk::hud {
   }
   
   
+  void HudRenderer::endFrame() {
+    flushText();
+
+    m_context = nullptr;
+  }
+  
+  
   void HudRenderer::drawText(
           float             size,
           HudPos            pos,
@@ -51,29 +58,24 @@ namespace dxvk::hud {
     if (text.empty())
       return;
 
-    beginTextRendering();
+    // Text is not drawn immediately, instead all strings of the frame
+    // are gathered and rendered with one instanced draw, one instance
+    // per string. Flush early if the batch would not fit into the
+    // data buffer anymore.
+    VkDeviceSize batchSize = (m_textDraws.size() + 1) * sizeof(HudTextDrawInfo)
+      + m_textData.size() + text.size() + CACHE_LINE_SIZE;
 
-    // Copy string into string buffer, but extend it to cover a full cache
-    // line to avoid potential CPU performance issues with the upload.
-    std::string textCopy = text;
-    textCopy.resize(align(text.size(), CACHE_LINE_SIZE), ' ');
+    if (batchSize > DataBufferSize / 2)
+      flushText();
 
-    VkDeviceSize offset = allocDataBuffer(textCopy.size());
-    std::memcpy(m_dataBuffer->mapPtr(offset), textCopy.data(), textCopy.size());
+    HudTextDrawInfo& draw = m_textDraws.emplace_back();
+    draw.color = color;
+    draw.pos = pos;
+    draw.size = size;
+    draw.packedText = uint32_t(m_textData.size()) | (uint32_t(text.size()) << 16);
 
-    // Fill in push constants for the next draw
-    HudTextPushConstants pushData;
-    pushData.color = color;
-    pushData.pos = pos;
-    pushData.offset = offset;
-    pushData.size = size;
-    pushData.scale.x = m_scale / std::max(float(m_surfaceSize.width),  1.0f);
-    pushData.scale.y = m_scale / std::max(float(m_surfaceSize.height), 1.0f);
-
-    m_context->pushConstants(0, sizeof(pushData), &pushData);
-
-    // Draw with orignal vertex count
-    m_context->draw(6 * text.size(), 1, 0, 0);
+    m_textData.insert(m_textData.end(), text.begin(), text.end());
+    m_textMaxLength = std::max(m_textMaxLength, text.size());
   }
   
   
@@ -101,6 +103,40 @@ namespace dxvk::hud {
   }
   
   
+  void HudRenderer::flushText() {
+    if (m_textDraws.empty())
+      return;
+
+    beginTextRendering();
+
+    // Upload draw infos followed by the string data. Text offsets
+    // are relative to the draw info array, so fix them up here.
+    VkDeviceSize drawSize = m_textDraws.size() * sizeof(HudTextDrawInfo);
+    VkDeviceSize offset = allocDataBuffer(drawSize + m_textData.size());
+
+    for (auto& draw : m_textDraws)
+      draw.packedText += uint32_t(offset + drawSize);
+
+    std::memcpy(m_dataBuffer->mapPtr(offset), m_textDraws.data(), drawSize);
+    std::memcpy(m_dataBuffer->mapPtr(offset + drawSize), m_textData.data(), m_textData.size());
+
+    HudTextPushConstants pushData;
+    pushData.scale.x = m_scale / std::max(float(m_surfaceSize.width),  1.0f);
+    pushData.scale.y = m_scale / std::max(float(m_surfaceSize.height), 1.0f);
+    pushData.drawIndex = offset / sizeof(HudTextDrawInfo);
+    pushData.padding = 0;
+
+    m_context->pushConstants(0, sizeof(pushData), &pushData);
+
+    // Vertices past the end of a string are discarded in the shader
+    m_context->draw(6 * m_textMaxLength, m_textDraws.size(), 0, 0);
+
+    m_textDraws.clear();
+    m_textData.clear();
+    m_textMaxLength = 0;
+  }
+
+
   void HudRenderer::beginTextRendering() {
     if (m_mode != Mode::RenderText) {
       m_mode = Mode::RenderText;
@@ -110,6 +146,7 @@ namespace dxvk::hud {
       
       m_context->bindResourceBufferView(VK_SHADER_STAGE_VERTEX_BIT, 0, Rc<DxvkBufferView>(m_fontBufferView));
       m_context->bindResourceBufferView(VK_SHADER_STAGE_VERTEX_BIT, 1, Rc<DxvkBufferView>(m_dataView));
+      m_context->bindResourceBufferView(VK_SHADER_STAGE_VERTEX_BIT, 3, Rc<DxvkBufferView>(m_dataView));
       m_context->bindResourceSampler(VK_SHADER_STAGE_FRAGMENT_BIT, 2, Rc<DxvkSampler>(m_fontSampler));
       m_context->bindResourceImageView(VK_SHADER_STAGE_FRAGMENT_BIT, 2, Rc<DxvkImageView>(m_fontView));
       
@@ -160,9 +197,10 @@ namespace dxvk::hud {
     SpirvCodeBuffer vsCode(hud_text_vert);
     SpirvCodeBuffer fsCode(hud_text_frag);
     
-    const std::array<DxvkBindingInfo, 2> vsBindings = {{
+    const std::array<DxvkBindingInfo, 3> vsBindings = {{
       { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,       0, VK_IMAGE_VIEW_TYPE_MAX_ENUM, VK_SHADER_STAGE_VERTEX_BIT, VK_ACCESS_SHADER_READ_BIT },
       { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1, VK_IMAGE_VIEW_TYPE_MAX_ENUM, VK_SHADER_STAGE_VERTEX_BIT, VK_ACCESS_SHADER_READ_BIT },
+      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,       3, VK_IMAGE_VIEW_TYPE_MAX_ENUM, VK_SHADER_STAGE_VERTEX_BIT, VK_ACCESS_SHADER_READ_BIT },
     }};
 
     const std::array<DxvkBindingInfo, 1> fsBindings = {{
@@ -54,11 +54,23 @@ namespace dxvk::hud {
    * \brief HUD push constant data
    */
   struct HudTextPushConstants {
+    HudPos scale;
+    uint32_t drawIndex;
+    uint32_t padding;
+  };
+
+  /**
+   * \brief Text draw parameters
+   *
+   * One entry per string, indexed by the instance
+   * index in the text vertex shader. The text offset
+   * and length are packed into a single dword.
+   */
+  struct HudTextDrawInfo {
     HudColor color;
     HudPos pos;
-    uint32_t offset;
     float size;
-    HudPos scale;
+    uint32_t packedText;
   };
 
   struct HudGraphPushConstants {
@@ -107,6 +119,8 @@ namespace dxvk::hud {
       const Rc<DxvkContext>&  context,
             VkExtent2D        surfaceSize,
             float             scale);
+
+    void endFrame();
     
     void drawText(
             float             size,
@@ -155,6 +169,10 @@ namespace dxvk::hud {
     Rc<DxvkBufferView>  m_dataView;
     VkDeviceSize        m_dataOffset;
 
+    std::vector<HudTextDrawInfo> m_textDraws;
+    std::vector<char>   m_textData;
+    size_t              m_textMaxLength = 0;
+
     Rc<DxvkBuffer>      m_fontBuffer;
     Rc<DxvkBufferView>  m_fontBufferView;
     Rc<DxvkImage>       m_fontImage;
@@ -167,6 +185,8 @@ namespace dxvk::hud {
     
     void beginGraphRendering();
 
+    void flushText();
+
     VkDeviceSize allocDataBuffer(VkDeviceSize size);
 
     ShaderPair createTextShaders();
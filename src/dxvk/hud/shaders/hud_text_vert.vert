@@ -18,15 +18,25 @@ readonly buffer font_buffer_t {
   glyph_info_t glyph_data[];
 };
 
+struct text_draw_t {
+  vec4 color;
+  vec2 pos;
+  float size;
+  uint packed_text;
+};
+
 layout(binding = 1) uniform usamplerBuffer text_buffer;
 
+layout(binding = 3, std430)
+readonly buffer draw_buffer_t {
+  text_draw_t draw_data[];
+};
+
 layout(push_constant)
 uniform push_data_t {
-  vec4 text_color;
-  vec2 text_pos;
-  uint text_offset;
-  float text_size;
   vec2 hud_scale;
+  uint draw_index;
+  uint padding;
 };
 
 layout(location = 0) out vec2 o_texcoord;
@@ -42,13 +52,27 @@ vec2 unpack_u16(uint v) {
 }
 
 void main() {
-  o_color = text_color;
+  // Each instance renders one string
+  text_draw_t draw = draw_data[draw_index + gl_InstanceIndex];
+
+  uint text_offset = bitfieldExtract(draw.packed_text, 0, 16);
+  uint text_length = bitfieldExtract(draw.packed_text, 16, 16);
+
+  o_color = draw.color;
 
   // Compute character index and vertex index for the current
   // character. We'll render two triangles per character.
   uint chr_idx = gl_VertexIndex / 6;
   uint vtx_idx = gl_VertexIndex - 6 * chr_idx;
 
+  // The vertex count is based on the longest string in
+  // the batch, emit degenerate triangles for the rest.
+  if (chr_idx >= text_length) {
+    o_texcoord = vec2(0.0f);
+    gl_Position = vec4(0.0f);
+    return;
+  }
+
   // Load glyph info based on vertex index
   uint glyph_idx = texelFetch(text_buffer, int(text_offset + chr_idx)).x;
   glyph_info_t glyph_info = glyph_data[glyph_idx];
@@ -64,11 +88,11 @@ void main() {
   // Compute vertex position. We can easily do this here since our
   // font is a monospace font, otherwise we'd need to preprocess
   // the strings to render in a compute shader.
-  float size_factor = text_size / font_data.size;
+  float size_factor = draw.size / font_data.size;
 
   vec2 local_pos = tex_wh * coord - unpack_u16(glyph_info.packed_origin)
     + vec2(font_data.advance * float(chr_idx), 0.0f);
-  vec2 pixel_pos = text_pos + size_factor * local_pos;
+  vec2 pixel_pos = draw.pos + size_factor * local_pos;
   vec2 scaled_pos = 2.0f * hud_scale * pixel_pos - 1.0f;
 
   gl_Position = vec4(scaled_pos, 0.0f, 1.0f);
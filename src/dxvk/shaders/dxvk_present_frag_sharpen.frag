@@ -0,0 +1,54 @@
+#version 450
+
+layout(constant_id = 1) const bool s_gamma_bound = false;
+layout(constant_id = 2) const uint s_sharpness = 0u;
+
+layout(binding = 0) uniform sampler2D s_image;
+layout(binding = 1) uniform sampler1D s_gamma;
+
+layout(location = 0) in  vec2 i_coord;
+layout(location = 0) out vec4 o_color;
+
+layout(push_constant)
+uniform present_info_t {
+  ivec2 src_offset;
+  uvec2 src_extent;
+};
+
+vec4 sample_src(vec2 coord) {
+  // The sampler clamps to a black border, so keep
+  // taps inside the source rect to avoid dark edges
+  vec2 lo = vec2(src_offset) + 0.5f;
+  vec2 hi = vec2(src_offset) + vec2(src_extent) - 0.5f;
+  return textureLod(s_image, clamp(coord, lo, hi), 0.0f);
+}
+
+void main() {
+  vec2 coord = vec2(src_offset) + vec2(src_extent) * i_coord;
+
+  // Bilinear upscale, followed by a contrast-adaptive sharpening
+  // filter on a cross of source texels around the sample point.
+  // The sharpening weight is reduced in high-contrast areas so
+  // that edges are restored without ringing.
+  vec4 c = sample_src(coord);
+  vec3 n = sample_src(coord + vec2( 0.0f, -1.0f)).rgb;
+  vec3 s = sample_src(coord + vec2( 0.0f,  1.0f)).rgb;
+  vec3 w = sample_src(coord + vec2(-1.0f,  0.0f)).rgb;
+  vec3 e = sample_src(coord + vec2( 1.0f,  0.0f)).rgb;
+
+  vec3 lo = min(c.rgb, min(min(n, s), min(w, e)));
+  vec3 hi = max(c.rgb, max(max(n, s), max(w, e)));
+
+  vec3 amp = sqrt(clamp(min(lo, 1.0f - hi) / max(hi, 1.0f / 65536.0f), 0.0f, 1.0f));
+  vec3 weight = -amp / mix(8.0f, 5.0f, float(s_sharpness) / 100.0f);
+
+  o_color = vec4((c.rgb + (n + s + w + e) * weight) / (1.0f + 4.0f * weight), c.a);
+
+  if (s_gamma_bound) {
+    o_color = vec4(
+      texture(s_gamma, o_color.r).r,
+      texture(s_gamma, o_color.g).g,
+      texture(s_gamma, o_color.b).b,
+      o_color.a);
+  }
+}
@@ -15,6 +15,12 @@ namespace dxvk {
   }
 
 
+  SpirvCodeBuffer::SpirvCodeBuffer(MemoryArena* arena)
+  : m_code(ArenaAllocator<uint32_t>(arena)) {
+
+  }
+
+
   SpirvCodeBuffer::SpirvCodeBuffer(uint32_t size, const uint32_t* data)
   : m_ptr(size) {
     m_code.resize(size);
@@ -6,6 +6,8 @@
 
 #include "spirv_instruction.h"
 
+#include "../util/util_arena.h"
+
 namespace dxvk {
   
   /**
@@ -25,6 +27,15 @@ namespace dxvk {
     SpirvCodeBuffer(SpirvCodeBuffer &&) = default;
     SpirvCodeBuffer(uint32_t size, const uint32_t* data);
     SpirvCodeBuffer(std::istream& stream);
+
+    /**
+     * \brief Creates code buffer backed by a memory arena
+     *
+     * The buffer must not outlive the arena. Copies
+     * of the buffer use regular heap memory.
+     * \param [in] arena Memory arena
+     */
+    explicit SpirvCodeBuffer(MemoryArena* arena);
     
     template<size_t N>
     SpirvCodeBuffer(const uint32_t (&data)[N])
@@ -89,6 +100,17 @@ namespace dxvk {
      */
     uint32_t allocId();
     
+    /**
+     * \brief Reserves memory for the given number of dwords
+     *
+     * Avoids repeated reallocations when the final
+     * size of the buffer is known in advance.
+     * \param [in] dwords Total number of dwords
+     */
+    void reserve(uint32_t dwords) {
+      m_code.reserve(dwords);
+    }
+    
     /**
      * \brief Merges two code buffers
      * 
@@ -220,7 +242,7 @@ namespace dxvk {
     
   private:
     
-    std::vector<uint32_t> m_code;
+    std::vector<uint32_t, ArenaAllocator<uint32_t>> m_code;
     size_t m_ptr = 0;
     
   };
@@ -1,7 +1,143 @@
+#include <array>
+#include <cstring>
+
 #include "spirv_compression.h"
 
+#include "../util/util_bit.h"
+
+#ifdef DXVK_ARCH_ARM64
+#include <arm_neon.h>
+#endif
+
 namespace dxvk {
 
+  /**
+   * \brief Decoding tables
+   *
+   * For each control byte, stores the byte shuffle that
+   * expands the four packed dwords to full dwords, as well
+   * as the total number of bytes used by the packed dwords.
+   * Shuffle indices with the top bit set produce zero.
+   */
+  struct SpirvDecodeTables {
+    std::array<std::array<uint8_t, 16>, 256> shuffle;
+    std::array<uint8_t, 256> length;
+  };
+
+
+  static constexpr SpirvDecodeTables buildDecodeTables() {
+    SpirvDecodeTables tables = { };
+
+    for (uint32_t c = 0; c < 256; c++) {
+      uint32_t offset = 0;
+
+      for (uint32_t i = 0; i < 4; i++) {
+        uint32_t length = ((c >> (2 * i)) & 0x3) + 1;
+
+        for (uint32_t j = 0; j < 4; j++)
+          tables.shuffle[c][4 * i + j] = j < length ? uint8_t(offset + j) : uint8_t(0x80);
+
+        offset += length;
+      }
+
+      tables.length[c] = uint8_t(offset);
+    }
+
+    return tables;
+  }
+
+
+  static constexpr SpirvDecodeTables g_decodeTables = buildDecodeTables();
+
+
+  static uint32_t getEncodedLength(uint32_t dw) {
+    if (dw < (1u << 8))  return 1;
+    if (dw < (1u << 16)) return 2;
+    if (dw < (1u << 24)) return 3;
+    return 4;
+  }
+
+
+  static const uint8_t* decodeGroupsScalar(
+    const uint8_t*                src,
+    const uint8_t*                ctrl,
+          uint32_t*               dst,
+          size_t                  groupCount) {
+    // The buffer is padded, so reading four bytes is always safe
+    constexpr std::array<uint32_t, 4> masks = { 0xffu, 0xffffu, 0xffffffu, 0xffffffffu };
+
+    for (size_t i = 0; i < groupCount; i++) {
+      uint32_t c = ctrl[i];
+
+      for (uint32_t j = 0; j < 4; j++) {
+        uint32_t code = (c >> (2 * j)) & 0x3;
+        uint32_t dw;
+
+        std::memcpy(&dw, src, sizeof(dw));
+        dst[4 * i + j] = dw & masks[code];
+        src += code + 1;
+      }
+    }
+
+    return src;
+  }
+
+
+#if defined(DXVK_ARCH_X86)
+  #if !defined(_MSC_VER) || defined(__clang__)
+  __attribute__((target("ssse3")))
+  #endif
+  static const uint8_t* decodeGroupsSsse3(
+    const uint8_t*                src,
+    const uint8_t*                ctrl,
+          uint32_t*               dst,
+          size_t                  groupCount) {
+    for (size_t i = 0; i < groupCount; i++) {
+      uint32_t c = ctrl[i];
+
+      __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g_decodeTables.shuffle[c].data()));
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), _mm_shuffle_epi8(data, mask));
+      src += g_decodeTables.length[c];
+    }
+
+    return src;
+  }
+
+
+  static bool hasSsse3() {
+    #if defined(__SSSE3__)
+    return true;
+    #elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return info[2] & (1 << 9);
+    #else
+    return __builtin_cpu_supports("ssse3");
+    #endif
+  }
+#elif defined(DXVK_ARCH_ARM64)
+  static const uint8_t* decodeGroupsNeon(
+    const uint8_t*                src,
+    const uint8_t*                ctrl,
+          uint32_t*               dst,
+          size_t                  groupCount) {
+    for (size_t i = 0; i < groupCount; i++) {
+      uint32_t c = ctrl[i];
+
+      uint8x16_t data = vld1q_u8(src);
+      uint8x16_t mask = vld1q_u8(g_decodeTables.shuffle[c].data());
+
+      vst1q_u32(dst + 4 * i, vreinterpretq_u32_u8(vqtbl1q_u8(data, mask)));
+      src += g_decodeTables.length[c];
+    }
+
+    return src;
+  }
+#endif
+
+
   SpirvCompressedBuffer::SpirvCompressedBuffer()
   : m_size(0) {
 
@@ -10,77 +146,42 @@ namespace dxvk {
 
   SpirvCompressedBuffer::SpirvCompressedBuffer(SpirvCodeBuffer& code)
   : m_size(code.dwords()) {
-    // The compression (detailed below) achieves roughly 55% of the
-    // original size on average and is very consistent, so an initial
-    // estimate of roughly 58% will be accurate most of the time.
     const uint32_t* data = code.data();
-    m_code.reserve((m_size * 75) / 128);
-
-    std::array<uint32_t, 16> block;
-    uint32_t blockMask = 0;
-    uint32_t blockOffset = 0;
-
-    // The algorithm used is a simple variable-to-fixed compression that
-    // encodes up to two consecutive SPIR-V tokens into one DWORD using
-    // a small number of different encodings. While not achieving great
-    // compression ratios, the main goal is to allow decompression code
-    // to be fast, with short dependency chains.
-    // Compressed tokens are stored in blocks of 16 DWORDs, each preceeded
-    // by a single DWORD which stores the layout for each DWORD, two bits
-    // each. The supported layouts, are as follows:
-    // 0x0: 1x 32-bit;  0x1: 1x 20-bit + 1x 12-bit
-    // 0x2: 2x 16-bit;  0x3: 1x 12-bit + 1x 20-bit
-    // These layouts are chosen to allow reasonably efficient encoding of
-    // opcode tokens, which usually fit into 20 bits, followed by type IDs,
-    // which tend to be low as well since most types are defined early.
-    for (size_t i = 0; i < m_size; ) {
-      if (likely(i + 1 < m_size)) {
-        uint32_t a = data[i];
-        uint32_t b = data[i + 1];
-        uint32_t schema;
-        uint32_t encode;
-
-        if (std::max(a, b) < (1u << 16)) {
-          schema = 0x2;
-          encode = a | (b << 16);
-        } else if (a < (1u << 20) && b < (1u << 12)) {
-          schema = 0x1;
-          encode = a | (b << 20);
-        } else if (a < (1u << 12) && b < (1u << 20)) {
-          schema = 0x3;
-          encode = a | (b << 12);
-        } else {
-          schema = 0x0;
-          encode = a;
-        }
-
-        block[blockOffset] = encode;
-        blockMask |= schema << (blockOffset << 1);
-        blockOffset += 1;
-
-        i += schema ? 2 : 1;
-      } else {
-        block[blockOffset] = data[i++];
-        blockOffset += 1;
-      }
 
-      if (unlikely(blockOffset == 16) || unlikely(i == m_size)) {
-        m_code.insert(m_code.end(), blockMask);
-        m_code.insert(m_code.end(), block.begin(), block.begin() + blockOffset);
+    // Compute the exact size first so that we only need to
+    // allocate once. Most SPIR-V words are small IDs, literals
+    // or opcode tokens, which fit into one to three bytes.
+    size_t dataOffset = getDataOffset(m_size);
+    size_t dataSize = 0;
 
-        blockMask = 0;
-        blockOffset = 0;
-      }
-    }
+    for (size_t i = 0; i < m_size; i++)
+      dataSize += getEncodedLength(data[i]);
+
+    // Pad the data so that decoders can always read 16 bytes
+    // starting at the first byte of any group of dwords
+    m_code.resize((dataOffset + dataSize + 3) / 4 + 4);
+
+    uint8_t* ctrl = reinterpret_cast<uint8_t*>(m_code.data());
+    uint8_t* dst = ctrl + dataOffset;
+
+    for (size_t i = 0; i < m_size; i++) {
+      uint32_t length = getEncodedLength(data[i]);
 
-    // Only shrink the array if we have lots of overhead for some reason.
-    // This should only happen on shaders where our initial estimate was
-    // too small. In general, we want to avoid reallocation here.
-    if (m_code.capacity() > (m_code.size() * 10) / 9)
-      m_code.shrink_to_fit();
+      ctrl[i / 4] |= uint8_t((length - 1) << (2 * (i % 4)));
+      std::memcpy(dst, &data[i], length);
+      dst += length;
+    }
   }
 
     
+  SpirvCompressedBuffer::SpirvCompressedBuffer(
+          size_t                  size,
+          std::vector<uint32_t>&& code)
+  : m_size(size), m_code(std::move(code)) {
+
+  }
+
+
   SpirvCompressedBuffer::~SpirvCompressedBuffer() {
 
   }
@@ -90,34 +191,39 @@ namespace dxvk {
     SpirvCodeBuffer code(m_size);
     uint32_t* data = code.data();
 
-    uint32_t srcOffset = 0;
-    uint32_t dstOffset = 0;
-
-    constexpr uint32_t shiftAmounts = 0x0c101420;
+    if (!m_size)
+      return code;
 
-    while (dstOffset < m_size) {
-      uint32_t blockMask = m_code[srcOffset];
+    const uint8_t* ctrl = reinterpret_cast<const uint8_t*>(m_code.data());
+    const uint8_t* src = ctrl + getDataOffset(m_size);
 
-      for (uint32_t i = 0; i < 16 && dstOffset < m_size; i++) {
-        // Use 64-bit integers for some of the operands so we can
-        // shift by 32 bits and not handle it as a special cases
-        uint32_t schema = (blockMask >> (i << 1)) & 0x3;
-        uint32_t shift  = (shiftAmounts >> (schema << 3)) & 0xff;
-        uint64_t mask   = ~(~0ull << shift);
-        uint64_t encode = m_code[srcOffset + i + 1];
+    // Decode full groups of four dwords with SIMD if possible
+    size_t groupCount = m_size / 4;
 
-        data[dstOffset] = encode & mask;
+#if defined(DXVK_ARCH_X86)
+    static const bool s_hasSsse3 = hasSsse3();
 
-        if (likely(schema))
-          data[dstOffset + 1] = encode >> shift;
+    if (likely(s_hasSsse3))
+      src = decodeGroupsSsse3(src, ctrl, data, groupCount);
+    else
+      src = decodeGroupsScalar(src, ctrl, data, groupCount);
+#elif defined(DXVK_ARCH_ARM64)
+    src = decodeGroupsNeon(src, ctrl, data, groupCount);
+#else
+    src = decodeGroupsScalar(src, ctrl, data, groupCount);
+#endif
 
-        dstOffset += schema ? 2 : 1;
-      }
+    // Decode remaining dwords one by one
+    for (size_t i = 4 * groupCount; i < m_size; i++) {
+      uint32_t length = ((ctrl[i / 4] >> (2 * (i % 4))) & 0x3) + 1;
+      uint32_t dw = 0;
 
-      srcOffset += 17;
+      std::memcpy(&dw, src, length);
+      data[i] = dw;
+      src += length;
     }
 
     return code;
   }
 
-}
\ No newline at end of file
+}
@@ -11,6 +11,12 @@ namespace dxvk {
    *
    * Implements a fast in-memory compression
    * to keep memory footprint low.
+   *
+   * Each dword is stored with the smallest number of bytes
+   * that can represent it, and a two-bit length code per
+   * dword is stored separately in front of the data. This
+   * allows decoding four dwords at a time with a single
+   * byte shuffle on CPUs that support it.
    */
   class SpirvCompressedBuffer {
 
@@ -19,19 +25,58 @@ namespace dxvk {
     SpirvCompressedBuffer();
 
     SpirvCompressedBuffer(SpirvCodeBuffer& code);
+
+    SpirvCompressedBuffer(
+            size_t                  size,
+            std::vector<uint32_t>&& code);
     
     ~SpirvCompressedBuffer();
     
     SpirvCodeBuffer decompress() const;
 
+    /**
+     * \brief Uncompressed code size
+     * \returns Code size, in dwords
+     */
+    size_t size() const {
+      return m_size;
+    }
+
+    /**
+     * \brief Compressed code
+     * \returns Compressed dwords
+     */
+    const std::vector<uint32_t>& data() const {
+      return m_code;
+    }
+
+    /**
+     * \brief Checks whether compressed code is present
+     * \returns \c true if the code was released
+     */
+    bool empty() const {
+      return m_code.empty();
+    }
+
+    /**
+     * \brief Frees compressed code
+     *
+     * Keeps the uncompressed size. The buffer must
+     * not be decompressed until code is restored.
+     */
+    void release() {
+      std::vector<uint32_t>().swap(m_code);
+    }
+
   private:
 
     size_t                m_size;
     std::vector<uint32_t> m_code;
 
-    void encodeDword(uint32_t dw);
-
-    uint32_t decodeDword(size_t& offset) const;
+    static size_t getDataOffset(size_t size) {
+      // One control byte per four dwords, aligned to a dword
+      return ((size + 15) / 16) * 4;
+    }
 
   };
 
@@ -5,7 +5,21 @@
 namespace dxvk {
   
   SpirvModule::SpirvModule(uint32_t version)
-  : m_version(version) {
+  : m_version       (version),
+    m_capabilities  (&m_arena),
+    m_extensions    (&m_arena),
+    m_instExt       (&m_arena),
+    m_memoryModel   (&m_arena),
+    m_entryPoints   (&m_arena),
+    m_execModeInfo  (&m_arena),
+    m_debugNames    (&m_arena),
+    m_annotations   (&m_arena),
+    m_typeConstDefs (&m_arena),
+    m_variables     (&m_arena),
+    m_code          (&m_arena),
+    m_lateConsts    (ArenaAllocator<uint32_t>(&m_arena)),
+    m_interfaceVars (ArenaAllocator<uint32_t>(&m_arena)),
+    m_declLookup    (ArenaAllocator<std::pair<const size_t, uint32_t>>(&m_arena)) {
     this->instImportGlsl450();
   }
   
@@ -16,7 +30,23 @@ namespace dxvk {
   
   
   SpirvCodeBuffer SpirvModule::compile() const {
+    // Size of the SPIR-V header, in dwords
+    constexpr uint32_t HeaderSize = 5;
+
     SpirvCodeBuffer result;
+    result.reserve(HeaderSize
+      + m_capabilities.dwords()
+      + m_extensions.dwords()
+      + m_instExt.dwords()
+      + m_memoryModel.dwords()
+      + m_entryPoints.dwords()
+      + m_execModeInfo.dwords()
+      + m_debugNames.dwords()
+      + m_annotations.dwords()
+      + m_typeConstDefs.dwords()
+      + m_variables.dwords()
+      + m_code.dwords());
+
     result.putHeader(m_version, m_id);
     result.append(m_capabilities);
     result.append(m_extensions);
@@ -765,11 +795,14 @@ namespace dxvk {
           uint32_t                typeId,
           uint32_t                length) {
     uint32_t resultId = this->allocateId();
+    uint32_t offset   = m_typeConstDefs.dwords();
     
     m_typeConstDefs.putIns (spv::OpTypeArray, 4);
     m_typeConstDefs.putWord(resultId);
     m_typeConstDefs.putWord(typeId);
     m_typeConstDefs.putWord(length);
+
+    this->addUniqueType(offset);
     return resultId;
   }
   
@@ -786,10 +819,13 @@ namespace dxvk {
   uint32_t SpirvModule::defRuntimeArrayTypeUnique(
           uint32_t                typeId) {
     uint32_t resultId = this->allocateId();
+    uint32_t offset   = m_typeConstDefs.dwords();
     
     m_typeConstDefs.putIns (spv::OpTypeRuntimeArray, 3);
     m_typeConstDefs.putWord(resultId);
     m_typeConstDefs.putWord(typeId);
+
+    this->addUniqueType(offset);
     return resultId;
   }
   
@@ -821,12 +857,15 @@ namespace dxvk {
           uint32_t                memberCount,
     const uint32_t*               memberTypes) {
     uint32_t resultId = this->allocateId();
+    uint32_t offset   = m_typeConstDefs.dwords();
     
     m_typeConstDefs.putIns (spv::OpTypeStruct, 2 + memberCount);
     m_typeConstDefs.putWord(resultId);
     
     for (uint32_t i = 0; i < memberCount; i++)
       m_typeConstDefs.putWord(memberTypes[i]);
+
+    this->addUniqueType(offset);
     return resultId;
   }
   
@@ -3707,22 +3746,17 @@ namespace dxvk {
           spv::Op                 op, 
           uint32_t                argCount,
     const uint32_t*               argIds) {
-    // Since the type info is stored in the code buffer,
-    // we can use the code buffer to look up type IDs as
-    // well. Result IDs are always stored as argument 1.
-    for (auto ins : m_typeConstDefs) {
-      bool match = ins.opCode() == op
-                && ins.length() == 2 + argCount;
-      
-      for (uint32_t i = 0; i < argCount && match; i++)
-        match &= ins.arg(2 + i) == argIds[i];
-      
-      if (match)
-        return ins.arg(1);
-    }
+    size_t hash = hashDecl(op, 0, argCount, argIds);
+
+    uint32_t resultId = this->findDecl(hash, op, 0, argCount, argIds);
+
+    if (resultId)
+      return resultId;
     
     // Type not yet declared, create a new one.
-    uint32_t resultId = this->allocateId();
+    resultId = this->allocateId();
+    this->addDecl(hash, m_typeConstDefs.dwords());
+
     m_typeConstDefs.putIns (op, 2 + argCount);
     m_typeConstDefs.putWord(resultId);
     
@@ -3737,26 +3771,20 @@ namespace dxvk {
           uint32_t                typeId,
           uint32_t                argCount,
     const uint32_t*               argIds) {
-    // Avoid declaring constants multiple times
-    for (auto ins : m_typeConstDefs) {
-      bool match = ins.opCode() == op
-                && ins.length() == 3 + argCount
-                && ins.arg(1)   == typeId;
-      
-      for (uint32_t i = 0; i < argCount && match; i++)
-        match &= ins.arg(3 + i) == argIds[i];
-      
-      if (!match)
-        continue;
-      
-      uint32_t id = ins.arg(2);
+    // Avoid declaring constants multiple times. Late constants
+    // are never added to the lookup table since their values
+    // can still change.
+    size_t hash = hashDecl(op, typeId, argCount, argIds);
 
-      if (m_lateConsts.find(id) == m_lateConsts.end())
-        return id;
-    }
+    uint32_t resultId = this->findDecl(hash, op, typeId, argCount, argIds);
+
+    if (resultId)
+      return resultId;
     
     // Constant not yet declared, make a new one
-    uint32_t resultId = this->allocateId();
+    resultId = this->allocateId();
+    this->addDecl(hash, m_typeConstDefs.dwords());
+
     m_typeConstDefs.putIns (op, 3 + argCount);
     m_typeConstDefs.putWord(typeId);
     m_typeConstDefs.putWord(resultId);
@@ -3765,6 +3793,78 @@ namespace dxvk {
       m_typeConstDefs.putWord(argIds[i]);
     return resultId;
   }
+
+
+  uint32_t SpirvModule::findDecl(
+          size_t                  hash,
+          spv::Op                 op,
+          uint32_t                typeId,
+          uint32_t                argCount,
+    const uint32_t*               argIds) {
+    // Types have their result ID as the first operand,
+    // constants have the result type first. Type IDs
+    // are never zero, so we can use that to tell them
+    // apart.
+    uint32_t argIndex = typeId ? 3 : 2;
+
+    auto range = m_declLookup.equal_range(hash);
+
+    for (auto i = range.first; i != range.second; i++) {
+      SpirvInstruction ins(m_typeConstDefs.data(), i->second, m_typeConstDefs.dwords());
+
+      bool match = ins.opCode() == op
+                && ins.length() == argIndex + argCount
+                && (!typeId || ins.arg(1) == typeId);
+
+      for (uint32_t j = 0; j < argCount && match; j++)
+        match &= ins.arg(argIndex + j) == argIds[j];
+
+      if (match)
+        return ins.arg(argIndex - 1);
+    }
+
+    return 0;
+  }
+
+
+  void SpirvModule::addDecl(
+          size_t                  hash,
+          uint32_t                offset) {
+    m_declLookup.insert({ hash, offset });
+  }
+
+
+  void SpirvModule::addUniqueType(
+          uint32_t                offset) {
+    // Regular type declarations may resolve to a unique type
+    // if it was declared first, so make it visible to lookups
+    // unless an identical type already exists.
+    SpirvInstruction ins(m_typeConstDefs.data(), offset, m_typeConstDefs.dwords());
+
+    spv::Op op = ins.opCode();
+    uint32_t argCount = ins.length() - 2;
+    const uint32_t* argIds = m_typeConstDefs.data() + offset + 2;
+
+    size_t hash = hashDecl(op, 0, argCount, argIds);
+
+    if (!this->findDecl(hash, op, 0, argCount, argIds))
+      this->addDecl(hash, offset);
+  }
+
+
+  size_t SpirvModule::hashDecl(
+          spv::Op                 op,
+          uint32_t                typeId,
+          uint32_t                argCount,
+    const uint32_t*               argIds) {
+    size_t hash = (size_t(op) << 16) | argCount;
+    hash = hash * 31 + typeId;
+
+    for (uint32_t i = 0; i < argCount; i++)
+      hash = hash * 31 + argIds[i];
+
+    return hash;
+  }
   
   
   void SpirvModule::instImportGlsl450() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include <unordered_set>
 
 #include "spirv_code_buffer.h"
@@ -77,6 +78,17 @@ namespace dxvk {
       return m_blockId;
     }
 
+    /**
+     * \brief Retrieves memory arena
+     *
+     * Compilers can use this to allocate intermediate
+     * data that does not need to outlive the module.
+     * \returns Memory arena owned by the module
+     */
+    MemoryArena* getArena() {
+      return &m_arena;
+    }
+
     uint32_t allocateId();
     
     bool hasCapability(
@@ -1270,6 +1282,10 @@ namespace dxvk {
     uint32_t m_id             = 1;
     uint32_t m_instExtGlsl450 = 0;
     uint32_t m_blockId        = 0;
+
+    // All intermediate code buffers and tables are allocated
+    // from the arena, so that it must be declared first
+    MemoryArena m_arena;
     
     SpirvCodeBuffer m_capabilities;
     SpirvCodeBuffer m_extensions;
@@ -1283,9 +1299,20 @@ namespace dxvk {
     SpirvCodeBuffer m_variables;
     SpirvCodeBuffer m_code;
 
-    std::unordered_set<uint32_t> m_lateConsts;
+    std::unordered_set<uint32_t,
+      std::hash<uint32_t>,
+      std::equal_to<uint32_t>,
+      ArenaAllocator<uint32_t>> m_lateConsts;
 
-    std::vector<uint32_t> m_interfaceVars;
+    std::vector<uint32_t, ArenaAllocator<uint32_t>> m_interfaceVars;
+
+    // Maps the hash of a type or constant declaration to
+    // the dword offset of that declaration within the
+    // type and constant declaration buffer.
+    std::unordered_multimap<size_t, uint32_t,
+      std::hash<size_t>,
+      std::equal_to<size_t>,
+      ArenaAllocator<std::pair<const size_t, uint32_t>>> m_declLookup;
 
     uint32_t defType(
             spv::Op                 op, 
@@ -1298,6 +1325,26 @@ namespace dxvk {
             uint32_t                argCount,
       const uint32_t*               argIds);
     
+    uint32_t findDecl(
+            size_t                  hash,
+            spv::Op                 op,
+            uint32_t                typeId,
+            uint32_t                argCount,
+      const uint32_t*               argIds);
+
+    void addDecl(
+            size_t                  hash,
+            uint32_t                offset);
+
+    void addUniqueType(
+            uint32_t                offset);
+
+    static size_t hashDecl(
+            spv::Op                 op,
+            uint32_t                typeId,
+            uint32_t                argCount,
+      const uint32_t*               argIds);
+
     void instImportGlsl450();
     
     uint32_t getMemoryOperandWordCount(
@@ -0,0 +1,788 @@
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "spirv_optimizer.h"
+
+namespace dxvk {
+
+  SpirvOptimizer::SpirvOptimizer(
+    const SpirvCodeBuffer&        code)
+  : m_words(code.data(), code.data() + code.dwords()) {
+    if (m_words.size() < 5 || m_words[0] != spv::MagicNumber)
+      return;
+
+    size_t offset = 5;
+
+    while (offset < m_words.size()) {
+      uint32_t length = m_words[offset] >> spv::WordCountShift;
+
+      if (!length || offset + length > m_words.size())
+        return;
+
+      Instruction ins = { uint32_t(offset), length, false };
+
+      if (getOpCode(ins) == spv::OpFunction && !m_functionIndex)
+        m_functionIndex = m_ins.size();
+
+      if (getOpCode(ins) == spv::OpExtInstImport && length > 2) {
+        // The string is null-terminated within the instruction
+        const char* name = reinterpret_cast<const char*>(&m_words[offset + 2]);
+
+        if (!std::strcmp(name, "GLSL.std.450"))
+          m_glslExtSet = getArg(ins, 1);
+      }
+
+      m_ins.push_back(ins);
+      offset += length;
+    }
+
+    if (!m_functionIndex)
+      m_functionIndex = m_ins.size();
+
+    m_valid = true;
+  }
+
+
+  SpirvOptimizer::~SpirvOptimizer() {
+
+  }
+
+
+  void SpirvOptimizer::run() {
+    if (!m_valid)
+      return;
+
+    // Each pass may expose more work for the others, e.g. folded
+    // constants make selects trivial, which in turn makes the
+    // unselected values dead. Shader code is usually simple
+    // enough that a couple of iterations reach a fixed point.
+    constexpr uint32_t MaxIterations = 4;
+
+    for (uint32_t i = 0; i < MaxIterations; i++) {
+      bool progress = false;
+      progress |= eliminateRedundantLoads();
+      progress |= foldConstants();
+      progress |= eliminateDeadCode();
+
+      if (!progress)
+        break;
+    }
+  }
+
+
+  bool SpirvOptimizer::eliminateRedundantLoads() {
+    if (!m_valid)
+      return false;
+
+    // Maps pointers to the variable they point into. Pointers
+    // that are not in this map may point to any variable.
+    std::unordered_map<uint32_t, uint32_t> roots;
+
+    // Variables whose contents can only be changed by instructions
+    // within the current function, i.e. function and private
+    // variables that never get aliased by non-trivial pointers.
+    std::unordered_set<uint32_t> candidates;
+
+    for (const auto& ins : m_ins) {
+      if (ins.removed)
+        continue;
+
+      switch (getOpCode(ins)) {
+        case spv::OpVariable: {
+          uint32_t varId = getArg(ins, 2);
+          roots.insert({ varId, varId });
+
+          auto storage = spv::StorageClass(getArg(ins, 3));
+
+          if (storage == spv::StorageClassFunction
+           || storage == spv::StorageClassPrivate)
+            candidates.insert(varId);
+        } break;
+
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain: {
+          auto root = roots.find(getArg(ins, 3));
+
+          if (root != roots.end())
+            roots.insert({ getArg(ins, 2), root->second });
+        } break;
+
+        case spv::OpFunctionParameter:
+          // Pointer parameters could alias any variable,
+          // none of the compilers emit them anyway.
+          return false;
+
+        case spv::OpPhi:
+        case spv::OpSelect:
+        case spv::OpCopyObject:
+        case spv::OpPtrAccessChain:
+        case spv::OpBitcast: {
+          // Pointers derived this way are not tracked, so
+          // exclude any variable they may point into
+          for (uint32_t i = 3; i < ins.length; i++) {
+            auto root = roots.find(getArg(ins, i));
+
+            if (root != roots.end())
+              candidates.erase(root->second);
+          }
+        } break;
+
+        default:;
+      }
+    }
+
+    if (candidates.empty())
+      return false;
+
+    // Maps variables to the ID of their current value
+    std::unordered_map<uint32_t, uint32_t> values;
+    bool progress = false;
+
+    for (size_t i = m_functionIndex; i < m_ins.size(); i++) {
+      auto& ins = m_ins[i];
+
+      if (ins.removed)
+        continue;
+
+      switch (getOpCode(ins)) {
+        case spv::OpFunction:
+        case spv::OpFunctionCall:
+        case spv::OpLabel:
+          values.clear();
+          break;
+
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain:
+          break;
+
+        case spv::OpLoad: {
+          uint32_t ptrId = getArg(ins, 3);
+
+          if (candidates.find(ptrId) == candidates.end())
+            break;
+
+          if (ins.length > 4 && (getArg(ins, 4) & spv::MemoryAccessVolatileMask)) {
+            values.erase(ptrId);
+            break;
+          }
+
+          auto value = values.find(ptrId);
+
+          if (value != values.end()) {
+            replaceWithCopy(ins, value->second);
+            progress = true;
+          } else {
+            values.insert({ ptrId, getArg(ins, 2) });
+          }
+        } break;
+
+        case spv::OpStore: {
+          uint32_t ptrId = getArg(ins, 1);
+          auto root = roots.find(ptrId);
+
+          if (root == roots.end()) {
+            values.clear();
+          } else if (root->second == ptrId
+                  && candidates.find(ptrId) != candidates.end()
+                  && !(ins.length > 3 && (getArg(ins, 3) & spv::MemoryAccessVolatileMask))) {
+            values[ptrId] = getArg(ins, 2);
+          } else {
+            values.erase(root->second);
+          }
+        } break;
+
+        default: {
+          // Conservatively assume that any other instruction
+          // consuming a pointer may write through it
+          for (uint32_t j = 1; j < ins.length && !values.empty(); j++) {
+            auto root = roots.find(getArg(ins, j));
+
+            if (root != roots.end())
+              values.erase(root->second);
+          }
+        }
+      }
+    }
+
+    return progress;
+  }
+
+
+  bool SpirvOptimizer::foldConstants() {
+    if (!m_valid)
+      return false;
+
+    std::unordered_set<uint32_t> intTypes;
+    std::unordered_set<uint32_t> boolTypes;
+
+    std::unordered_map<uint32_t, Constant> constants;
+    std::unordered_map<uint32_t, uint32_t> composites;
+    std::unordered_map<uint64_t, uint32_t> lookup;
+
+    for (size_t i = 0; i < m_functionIndex; i++) {
+      const auto& ins = m_ins[i];
+
+      if (ins.removed)
+        continue;
+
+      switch (getOpCode(ins)) {
+        case spv::OpTypeInt:
+          if (getArg(ins, 2) == 32)
+            intTypes.insert(getArg(ins, 1));
+          break;
+
+        case spv::OpTypeBool:
+          boolTypes.insert(getArg(ins, 1));
+          break;
+
+        case spv::OpConstant:
+          if (ins.length == 4 && intTypes.find(getArg(ins, 1)) != intTypes.end()) {
+            Constant constant = { getArg(ins, 1), getArg(ins, 3) };
+            constants.insert({ getArg(ins, 2), constant });
+            lookup.insert({ (uint64_t(constant.typeId) << 32) | constant.value, getArg(ins, 2) });
+          }
+          break;
+
+        case spv::OpConstantTrue:
+        case spv::OpConstantFalse: {
+          Constant constant = { getArg(ins, 1), getOpCode(ins) == spv::OpConstantTrue ? 1u : 0u };
+          constants.insert({ getArg(ins, 2), constant });
+          lookup.insert({ (uint64_t(constant.typeId) << 32) | constant.value, getArg(ins, 2) });
+        } break;
+
+        case spv::OpConstantComposite:
+          composites.insert({ getArg(ins, 2), uint32_t(i) });
+          break;
+
+        default:;
+      }
+    }
+
+    if (constants.empty() && composites.empty())
+      return false;
+
+    bool progress = false;
+
+    for (size_t i = m_functionIndex; i < m_ins.size(); i++) {
+      auto& ins = m_ins[i];
+
+      if (ins.removed)
+        continue;
+
+      spv::Op op = getOpCode(ins);
+
+      uint32_t typeId = getArg(ins, 1);
+      uint32_t resultId = getArg(ins, 2);
+
+      switch (op) {
+        case spv::OpCopyObject: {
+          auto constant = constants.find(getArg(ins, 3));
+
+          if (constant != constants.end())
+            constants.insert({ resultId, constant->second });
+
+          auto composite = composites.find(getArg(ins, 3));
+
+          if (composite != composites.end())
+            composites.insert({ resultId, composite->second });
+        } break;
+
+        case spv::OpCompositeExtract: {
+          if (ins.length != 5)
+            break;
+
+          auto composite = composites.find(getArg(ins, 3));
+
+          if (composite == composites.end())
+            break;
+
+          const auto& def = m_ins[composite->second];
+          uint32_t index = getArg(ins, 4);
+
+          if (index >= def.length - 3)
+            break;
+
+          uint32_t memberId = getArg(def, 3 + index);
+          replaceWithCopy(ins, memberId);
+          progress = true;
+
+          auto constant = constants.find(memberId);
+
+          if (constant != constants.end())
+            constants.insert({ resultId, constant->second });
+
+          auto member = composites.find(memberId);
+
+          if (member != composites.end())
+            composites.insert({ resultId, member->second });
+        } break;
+
+        case spv::OpSelect: {
+          auto cond = constants.find(getArg(ins, 3));
+
+          if (cond == constants.end() || boolTypes.find(cond->second.typeId) == boolTypes.end())
+            break;
+
+          uint32_t valueId = getArg(ins, cond->second.value ? 4 : 5);
+          replaceWithCopy(ins, valueId);
+          progress = true;
+
+          auto constant = constants.find(valueId);
+
+          if (constant != constants.end())
+            constants.insert({ resultId, constant->second });
+        } break;
+
+        default: {
+          bool isBool = boolTypes.find(typeId) != boolTypes.end();
+          bool isInt = intTypes.find(typeId) != intTypes.end();
+
+          if ((!isBool && !isInt) || ins.length < 4 || ins.length > 5)
+            break;
+
+          auto a = constants.find(getArg(ins, 3));
+
+          if (a == constants.end())
+            break;
+
+          uint32_t b = 0;
+
+          if (ins.length == 5) {
+            auto e = constants.find(getArg(ins, 4));
+
+            if (e == constants.end())
+              break;
+
+            b = e->second.value;
+          }
+
+          // Unary and binary opcodes are disjoint, but make sure
+          // the operand count matches what we actually evaluate
+          bool isUnary = op == spv::OpNot || op == spv::OpSNegate || op == spv::OpLogicalNot;
+
+          if (isUnary != (ins.length == 4))
+            break;
+
+          uint32_t value = 0;
+
+          if (!foldIntOp(op, a->second.value, b, value))
+            break;
+
+          // Declaring a new constant inserts an instruction
+          // before the current one, so adjust the index.
+          size_t insCount = m_ins.size();
+          uint32_t constantId = declareConstant(lookup, typeId, value, isBool);
+
+          i += m_ins.size() - insCount;
+          replaceWithCopy(m_ins[i], constantId);
+
+          constants.insert({ constantId, { typeId, value } });
+          constants.insert({ resultId,   { typeId, value } });
+          progress = true;
+        }
+      }
+    }
+
+    return progress;
+  }
+
+
+  bool SpirvOptimizer::eliminateDeadCode() {
+    if (!m_valid)
+      return false;
+
+    uint32_t bound = getBound();
+
+    std::vector<uint32_t> uses(bound, 0u);
+    std::vector<uint32_t> defs(bound, ~0u);
+
+    for (size_t i = 0; i < m_ins.size(); i++) {
+      const auto& ins = m_ins[i];
+
+      if (ins.removed)
+        continue;
+
+      bool pure = isPure(ins);
+
+      if (pure && getArg(ins, 2) < bound)
+        defs[getArg(ins, 2)] = i;
+
+      uint32_t first, last;
+      getOperandRange(ins, first, last);
+
+      for (uint32_t j = first; j < last; j++) {
+        uint32_t id = getArg(ins, j);
+
+        if ((!pure || j != 2) && id < bound)
+          uses[id] += 1;
+      }
+    }
+
+    std::vector<uint32_t> worklist;
+
+    for (uint32_t id = 0; id < bound; id++) {
+      if (defs[id] != ~0u && !uses[id])
+        worklist.push_back(defs[id]);
+    }
+
+    if (worklist.empty())
+      return false;
+
+    while (!worklist.empty()) {
+      auto& ins = m_ins[worklist.back()];
+      worklist.pop_back();
+
+      if (ins.removed)
+        continue;
+
+      ins.removed = true;
+
+      uint32_t first, last;
+      getOperandRange(ins, first, last);
+
+      for (uint32_t j = first; j < last; j++) {
+        uint32_t id = getArg(ins, j);
+
+        if (j == 2 || id >= bound)
+          continue;
+
+        if (!(--uses[id]) && defs[id] != ~0u)
+          worklist.push_back(defs[id]);
+      }
+    }
+
+    // Remove debug names and decorations of removed instructions
+    for (auto& ins : m_ins) {
+      spv::Op op = getOpCode(ins);
+
+      if (ins.removed || (op != spv::OpName
+       && op != spv::OpDecorate
+       && op != spv::OpDecorateId
+       && op != spv::OpDecorateString))
+        continue;
+
+      uint32_t id = getArg(ins, 1);
+
+      if (id < bound && defs[id] != ~0u && m_ins[defs[id]].removed)
+        ins.removed = true;
+    }
+
+    return true;
+  }
+
+
+  SpirvCodeBuffer SpirvOptimizer::getCode() const {
+    if (!m_valid)
+      return SpirvCodeBuffer(uint32_t(m_words.size()), m_words.data());
+
+    std::vector<uint32_t> code(m_words.begin(), m_words.begin() + 5);
+    code.reserve(m_words.size());
+
+    for (const auto& ins : m_ins) {
+      if (ins.removed)
+        continue;
+
+      code.push_back((m_words[ins.offset] & spv::OpCodeMask) | (ins.length << spv::WordCountShift));
+      code.insert(code.end(), &m_words[ins.offset + 1], &m_words[ins.offset + ins.length]);
+    }
+
+    return SpirvCodeBuffer(uint32_t(code.size()), code.data());
+  }
+
+
+  bool SpirvOptimizer::isPure(
+    const Instruction&            ins) const {
+    switch (getOpCode(ins)) {
+      case spv::OpLoad:
+        return ins.length == 4 || !(getArg(ins, 4) & spv::MemoryAccessVolatileMask);
+
+      case spv::OpExtInst:
+        return getArg(ins, 3) == m_glslExtSet
+            && getArg(ins, 4) != GLSLstd450Modf
+            && getArg(ins, 4) != GLSLstd450Frexp;
+
+      case spv::OpConstant:
+      case spv::OpConstantTrue:
+      case spv::OpConstantFalse:
+      case spv::OpConstantComposite:
+      case spv::OpConstantNull:
+      case spv::OpUndef:
+      case spv::OpCopyObject:
+      case spv::OpAccessChain:
+      case spv::OpInBoundsAccessChain:
+      case spv::OpVectorExtractDynamic:
+      case spv::OpVectorInsertDynamic:
+      case spv::OpVectorShuffle:
+      case spv::OpCompositeConstruct:
+      case spv::OpCompositeExtract:
+      case spv::OpCompositeInsert:
+      case spv::OpSampledImage:
+      case spv::OpImage:
+      case spv::OpImageSampleImplicitLod:
+      case spv::OpImageSampleExplicitLod:
+      case spv::OpImageSampleDrefImplicitLod:
+      case spv::OpImageSampleDrefExplicitLod:
+      case spv::OpImageSampleProjImplicitLod:
+      case spv::OpImageSampleProjExplicitLod:
+      case spv::OpImageSampleProjDrefImplicitLod:
+      case spv::OpImageSampleProjDrefExplicitLod:
+      case spv::OpImageFetch:
+      case spv::OpImageGather:
+      case spv::OpImageDrefGather:
+      case spv::OpImageQuerySizeLod:
+      case spv::OpImageQuerySize:
+      case spv::OpImageQueryLod:
+      case spv::OpImageQueryLevels:
+      case spv::OpImageQuerySamples:
+      case spv::OpConvertFToU:
+      case spv::OpConvertFToS:
+      case spv::OpConvertSToF:
+      case spv::OpConvertUToF:
+      case spv::OpUConvert:
+      case spv::OpSConvert:
+      case spv::OpFConvert:
+      case spv::OpBitcast:
+      case spv::OpSNegate:
+      case spv::OpFNegate:
+      case spv::OpIAdd:
+      case spv::OpFAdd:
+      case spv::OpISub:
+      case spv::OpFSub:
+      case spv::OpIMul:
+      case spv::OpFMul:
+      case spv::OpUDiv:
+      case spv::OpSDiv:
+      case spv::OpFDiv:
+      case spv::OpUMod:
+      case spv::OpSRem:
+      case spv::OpSMod:
+      case spv::OpFRem:
+      case spv::OpFMod:
+      case spv::OpVectorTimesScalar:
+      case spv::OpMatrixTimesScalar:
+      case spv::OpVectorTimesMatrix:
+      case spv::OpMatrixTimesVector:
+      case spv::OpMatrixTimesMatrix:
+      case spv::OpDot:
+      case spv::OpAny:
+      case spv::OpAll:
+      case spv::OpIsNan:
+      case spv::OpIsInf:
+      case spv::OpLogicalEqual:
+      case spv::OpLogicalNotEqual:
+      case spv::OpLogicalOr:
+      case spv::OpLogicalAnd:
+      case spv::OpLogicalNot:
+      case spv::OpSelect:
+      case spv::OpIEqual:
+      case spv::OpINotEqual:
+      case spv::OpUGreaterThan:
+      case spv::OpSGreaterThan:
+      case spv::OpUGreaterThanEqual:
+      case spv::OpSGreaterThanEqual:
+      case spv::OpULessThan:
+      case spv::OpSLessThan:
+      case spv::OpULessThanEqual:
+      case spv::OpSLessThanEqual:
+      case spv::OpFOrdEqual:
+      case spv::OpFUnordEqual:
+      case spv::OpFOrdNotEqual:
+      case spv::OpFUnordNotEqual:
+      case spv::OpFOrdLessThan:
+      case spv::OpFUnordLessThan:
+      case spv::OpFOrdGreaterThan:
+      case spv::OpFUnordGreaterThan:
+      case spv::OpFOrdLessThanEqual:
+      case spv::OpFUnordLessThanEqual:
+      case spv::OpFOrdGreaterThanEqual:
+      case spv::OpFUnordGreaterThanEqual:
+      case spv::OpShiftRightLogical:
+      case spv::OpShiftRightArithmetic:
+      case spv::OpShiftLeftLogical:
+      case spv::OpBitwiseOr:
+      case spv::OpBitwiseXor:
+      case spv::OpBitwiseAnd:
+      case spv::OpNot:
+      case spv::OpBitFieldInsert:
+      case spv::OpBitFieldSExtract:
+      case spv::OpBitFieldUExtract:
+      case spv::OpBitReverse:
+      case spv::OpBitCount:
+      case spv::OpDPdx:
+      case spv::OpDPdy:
+      case spv::OpFwidth:
+      case spv::OpDPdxFine:
+      case spv::OpDPdyFine:
+      case spv::OpFwidthFine:
+      case spv::OpDPdxCoarse:
+      case spv::OpDPdyCoarse:
+      case spv::OpFwidthCoarse:
+      case spv::OpPhi:
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+
+  void SpirvOptimizer::getOperandRange(
+    const Instruction&            ins,
+          uint32_t&               first,
+          uint32_t&               last) const {
+    first = 1;
+    last = ins.length;
+
+    // Skip trailing literals for common instructions. Anything
+    // else that may be a literal is counted as a use, which may
+    // keep some dead instructions alive but is always safe.
+    switch (getOpCode(ins)) {
+      case spv::OpSource:
+      case spv::OpSourceExtension:
+      case spv::OpString:
+      case spv::OpName:
+      case spv::OpMemberName:
+      case spv::OpExtension:
+      case spv::OpExtInstImport:
+      case spv::OpCapability:
+      case spv::OpMemoryModel:
+      case spv::OpDecorate:
+      case spv::OpMemberDecorate:
+      case spv::OpDecorateString:
+      case spv::OpTypeVoid:
+      case spv::OpTypeBool:
+      case spv::OpTypeInt:
+      case spv::OpTypeFloat:
+      case spv::OpTypeSampler:
+      case spv::OpLabel:
+        // Debug names and decoration targets are not uses,
+        // they get removed along with the target instead
+        last = 0;
+        break;
+
+      case spv::OpDecorateId:
+        first = 3;
+        break;
+
+      case spv::OpExecutionMode:
+      case spv::OpConstant:
+        last = std::min(last, 2u);
+        break;
+
+      case spv::OpTypeVector:
+      case spv::OpTypeMatrix:
+        first = 2;
+        last = std::min(last, 3u);
+        break;
+
+      case spv::OpCompositeExtract:
+        last = std::min(last, 4u);
+        break;
+
+      case spv::OpCompositeInsert:
+      case spv::OpVectorShuffle:
+        last = std::min(last, 5u);
+        break;
+
+      default:;
+    }
+  }
+
+
+  void SpirvOptimizer::replaceWithCopy(
+          Instruction&            ins,
+          uint32_t                valueId) {
+    // All instructions we replace have a result type, a
+    // result ID and at least one operand, so this fits.
+    m_words[ins.offset] = spv::OpCopyObject | (4u << spv::WordCountShift);
+    m_words[ins.offset + 3] = valueId;
+    ins.length = 4;
+  }
+
+
+  uint32_t SpirvOptimizer::declareConstant(
+          std::unordered_map<uint64_t, uint32_t>& lookup,
+          uint32_t                typeId,
+          uint32_t                value,
+          bool                    isBool) {
+    uint64_t key = (uint64_t(typeId) << 32) | value;
+    auto entry = lookup.find(key);
+
+    if (entry != lookup.end())
+      return entry->second;
+
+    uint32_t constantId = m_words[3]++;
+
+    // Append the declaration to the word list and insert it
+    // right before the first function, after all types.
+    Instruction ins = { uint32_t(m_words.size()), isBool ? 3u : 4u, false };
+
+    if (isBool) {
+      m_words.push_back((value ? spv::OpConstantTrue : spv::OpConstantFalse) | (3u << spv::WordCountShift));
+      m_words.push_back(typeId);
+      m_words.push_back(constantId);
+    } else {
+      m_words.push_back(spv::OpConstant | (4u << spv::WordCountShift));
+      m_words.push_back(typeId);
+      m_words.push_back(constantId);
+      m_words.push_back(value);
+    }
+
+    m_ins.insert(m_ins.begin() + m_functionIndex, ins);
+    m_functionIndex += 1;
+
+    lookup.insert({ key, constantId });
+    return constantId;
+  }
+
+
+  bool SpirvOptimizer::foldIntOp(
+          spv::Op                 op,
+          uint32_t                a,
+          uint32_t                b,
+          uint32_t&               result) {
+    switch (op) {
+      case spv::OpIAdd:                 result = a + b; return true;
+      case spv::OpISub:                 result = a - b; return true;
+      case spv::OpIMul:                 result = a * b; return true;
+      case spv::OpBitwiseAnd:           result = a & b; return true;
+      case spv::OpBitwiseOr:            result = a | b; return true;
+      case spv::OpBitwiseXor:           result = a ^ b; return true;
+      case spv::OpNot:                  result = ~a;    return true;
+      case spv::OpSNegate:              result = -a;    return true;
+      case spv::OpIEqual:               result = a == b; return true;
+      case spv::OpINotEqual:            result = a != b; return true;
+      case spv::OpUGreaterThan:         result = a >  b; return true;
+      case spv::OpUGreaterThanEqual:    result = a >= b; return true;
+      case spv::OpULessThan:            result = a <  b; return true;
+      case spv::OpULessThanEqual:       result = a <= b; return true;
+      case spv::OpSGreaterThan:         result = int32_t(a) >  int32_t(b); return true;
+      case spv::OpSGreaterThanEqual:    result = int32_t(a) >= int32_t(b); return true;
+      case spv::OpSLessThan:            result = int32_t(a) <  int32_t(b); return true;
+      case spv::OpSLessThanEqual:       result = int32_t(a) <= int32_t(b); return true;
+      case spv::OpLogicalAnd:           result = a && b; return true;
+      case spv::OpLogicalOr:            result = a || b; return true;
+      case spv::OpLogicalEqual:         result = a == b; return true;
+      case spv::OpLogicalNotEqual:      result = a != b; return true;
+      case spv::OpLogicalNot:           result = !a;    return true;
+
+      // Shifts by the bit width or more are undefined
+      case spv::OpShiftLeftLogical:
+        if (b >= 32) return false;
+        result = a << b; return true;
+
+      case spv::OpShiftRightLogical:
+        if (b >= 32) return false;
+        result = a >> b; return true;
+
+      case spv::OpShiftRightArithmetic:
+        if (b >= 32) return false;
+        result = uint32_t(int32_t(a) >> b); return true;
+
+      default:
+        return false;
+    }
+  }
+
+}
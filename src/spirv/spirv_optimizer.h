@@ -0,0 +1,135 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "spirv_code_buffer.h"
+
+namespace dxvk {
+
+  /**
+   * \brief SPIR-V optimizer
+   *
+   * Implements a small set of conservative passes that clean
+   * up redundant code emitted by the shader compilers. Passes
+   * never renumber IDs and never move instructions, so that
+   * decorations and other metadata remain valid. Instructions
+   * that can be replaced by an existing value are turned into
+   * \c OpCopyObject, which drivers trivially eliminate.
+   */
+  class SpirvOptimizer {
+
+  public:
+
+    explicit SpirvOptimizer(
+      const SpirvCodeBuffer&        code);
+
+    ~SpirvOptimizer();
+
+    /**
+     * \brief Runs all optimization passes
+     *
+     * Passes are repeated as long as they make
+     * progress, up to a fixed number of iterations.
+     */
+    void run();
+
+    /**
+     * \brief Eliminates redundant loads
+     *
+     * Within a block, replaces loads from function and private
+     * variables with the value that was last stored to or
+     * loaded from the same variable, as long as no instruction
+     * in between may have written to the variable.
+     * \returns \c true if any instruction was changed
+     */
+    bool eliminateRedundantLoads();
+
+    /**
+     * \brief Folds constant expressions
+     *
+     * Evaluates 32-bit integer arithmetic, integer comparisons,
+     * selects and composite extracts with constant operands.
+     * Float operations are left alone so that results do not
+     * depend on the host's floating point behaviour.
+     * \returns \c true if any instruction was changed
+     */
+    bool foldConstants();
+
+    /**
+     * \brief Eliminates dead code
+     *
+     * Removes side effect free instructions and constants whose
+     * results are not used, as well as their names and decorations.
+     * \returns \c true if any instruction was removed
+     */
+    bool eliminateDeadCode();
+
+    /**
+     * \brief Retrieves optimized code
+     * \returns Code buffer
+     */
+    SpirvCodeBuffer getCode() const;
+
+  private:
+
+    struct Instruction {
+      uint32_t offset;
+      uint32_t length;
+      bool     removed;
+    };
+
+    struct Constant {
+      uint32_t typeId;
+      uint32_t value;
+    };
+
+    std::vector<uint32_t>     m_words;
+    std::vector<Instruction>  m_ins;
+
+    bool                      m_valid         = false;
+    size_t                    m_functionIndex = 0;
+    uint32_t                  m_glslExtSet    = 0;
+
+    spv::Op getOpCode(
+      const Instruction&            ins) const {
+      return spv::Op(m_words[ins.offset] & spv::OpCodeMask);
+    }
+
+    uint32_t getArg(
+      const Instruction&            ins,
+            uint32_t                idx) const {
+      return idx < ins.length ? m_words[ins.offset + idx] : 0;
+    }
+
+    uint32_t getBound() const {
+      return m_words[3];
+    }
+
+    bool isPure(
+      const Instruction&            ins) const;
+
+    void getOperandRange(
+      const Instruction&            ins,
+            uint32_t&               first,
+            uint32_t&               last) const;
+
+    void replaceWithCopy(
+            Instruction&            ins,
+            uint32_t                valueId);
+
+    uint32_t declareConstant(
+            std::unordered_map<uint64_t, uint32_t>& lookup,
+            uint32_t                typeId,
+            uint32_t                value,
+            bool                    isBool);
+
+    static bool foldIntOp(
+            spv::Op                 op,
+            uint32_t                a,
+            uint32_t                b,
+            uint32_t&               result);
+
+  };
+
+}
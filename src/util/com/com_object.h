@@ -71,6 +71,10 @@ namespace dxvk {
     ULONG GetPrivateRefCount() {
       return m_refPrivate.load();
     }
+
+    ULONG GetRefCount() {
+      return m_refCount.load();
+    }
     
   protected:
     
@@ -1,4 +1,5 @@
 #include <array>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -1011,13 +1012,99 @@ namespace dxvk {
   }
 
 
+  /**
+   * \brief App profile index
+   *
+   * Most app profiles only match a plain executable name,
+   * which can be looked up in a hash map. Only the remaining
+   * profiles need to be matched with regular expressions,
+   * which are compiled once.
+   */
+  struct AppConfigIndex {
+    std::unordered_map<std::string, size_t>   names;
+    std::vector<std::pair<size_t, std::regex>> patterns;
+  };
+
+
+  static std::string toLowerAscii(std::string str) {
+    for (auto& c : str) {
+      if (c >= 'A' && c <= 'Z')
+        c += 'a' - 'A';
+    }
+
+    return str;
+  }
+
+
+  static bool getAppConfigName(const char* pattern, std::string& name) {
+    // Patterns of the form \\name\.exe$, where the name
+    // itself is a literal, match the executable name only
+    std::string str = pattern;
+
+    if (str.size() < 8 || str.compare(0, 2, "\\\\")
+     || str.compare(str.size() - 6, 6, "\\.exe$"))
+      return false;
+
+    str = str.substr(2, str.size() - 8);
+
+    for (char c : str) {
+      if (std::strchr("\\.[]{}()*+?|^$", c))
+        return false;
+    }
+
+    name = toLowerAscii(str + ".exe");
+    return true;
+  }
+
+
+  static const AppConfigIndex& getAppConfigIndex() {
+    static const AppConfigIndex s_index = [] {
+      AppConfigIndex index;
+
+      for (size_t i = 0; i < g_appDefaults.size(); i++) {
+        std::string name;
+
+        if (getAppConfigName(g_appDefaults[i].first, name)) {
+          index.names.insert({ name, i });
+        } else {
+          index.patterns.emplace_back(i, std::regex(g_appDefaults[i].first,
+            std::regex::extended | std::regex::icase));
+        }
+      }
+
+      return index;
+    } ();
+
+    return s_index;
+  }
+
+
   Config Config::getAppConfig(const std::string& appName) {
-    auto appConfig = std::find_if(g_appDefaults.begin(), g_appDefaults.end(),
-      [&appName] (const std::pair<const char*, Config>& pair) {
-        std::regex expr(pair.first, std::regex::extended | std::regex::icase);
-        return std::regex_search(appName, expr);
-      });
-    
+    const AppConfigIndex& index = getAppConfigIndex();
+
+    // Preserve the order of profiles, the first match wins
+    size_t match = g_appDefaults.size();
+    size_t separator = appName.find_last_of('\\');
+
+    if (separator != std::string::npos) {
+      auto entry = index.names.find(toLowerAscii(appName.substr(separator + 1)));
+
+      if (entry != index.names.end())
+        match = entry->second;
+    }
+
+    for (const auto& pattern : index.patterns) {
+      if (pattern.first >= match)
+        break;
+
+      if (std::regex_search(appName, pattern.second)) {
+        match = pattern.first;
+        break;
+      }
+    }
+
+    auto appConfig = g_appDefaults.begin() + match;
+
     if (appConfig != g_appDefaults.end()) {
       // Inform the user that we loaded a default config
       Logger::info(str::format("Found built-in config:"));
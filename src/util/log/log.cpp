@@ -5,6 +5,9 @@
 #include "../util_env.h"
 
 namespace dxvk {
+
+  static const std::array<const char*, 5> s_prefixes
+    = {{ "trace: ", "debug: ", "info:  ", "warn:  ", "err:   " }};
   
   Logger::Logger(const std::string& fileName)
   : m_minLevel(getMinLogLevel()), m_fileName(fileName) {
@@ -12,7 +15,12 @@ namespace dxvk {
   }
   
   
-  Logger::~Logger() { }
+  Logger::~Logger() {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    flushMsgs();
+    writeRepeatCount();
+  }
   
   
   void Logger::trace(const std::string& message) {
@@ -47,47 +55,114 @@ namespace dxvk {
   
   void Logger::emitMsg(LogLevel level, const std::string& message) {
     if (level >= m_minLevel) {
-      std::lock_guard<dxvk::mutex> lock(m_mutex);
-      
-      static std::array<const char*, 5> s_prefixes
-        = {{ "trace: ", "debug: ", "info:  ", "warn:  ", "err:   " }};
-      
-      const char* prefix = s_prefixes.at(static_cast<uint32_t>(level));
-
-      if (!std::exchange(m_initialized, true)) {
+      LogEntry* entry = new LogEntry { level, message, m_queue.load(std::memory_order_relaxed) };
+
+      while (!m_queue.compare_exchange_weak(entry->next, entry,
+          std::memory_order_release, std::memory_order_relaxed))
+        continue;
+
+      // Only one thread writes messages at a time. If another thread
+      // is currently writing, it will also pick up our message, so we
+      // don't have to wait. Check the queue again after unlocking in
+      // case a message got added just before the lock was released.
+      while (m_queue.load(std::memory_order_acquire) && m_mutex.try_lock()) {
+        flushMsgs();
+        m_mutex.unlock();
+      }
+    }
+  }
+
+
+  void Logger::flushMsgs() {
+    LogEntry* entry = m_queue.exchange(nullptr, std::memory_order_acquire);
+
+    // Entries are pushed in reverse order, so
+    // reverse the list to write them in order
+    LogEntry* head = nullptr;
+
+    while (entry) {
+      LogEntry* next = entry->next;
+      entry->next = head;
+      head = entry;
+      entry = next;
+    }
+
+    while (head) {
+      LogEntry* next = head->next;
+      writeMsg(head->level, head->message);
+      delete head;
+      head = next;
+    }
+  }
+
+
+  void Logger::writeMsg(LogLevel level, const std::string& message) {
+    const char* prefix = s_prefixes.at(static_cast<uint32_t>(level));
+
+    if (!std::exchange(m_initialized, true)) {
 #ifdef _WIN32
-        HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+      HMODULE ntdll = GetModuleHandleA("ntdll.dll");
 
-        if (ntdll)
-          m_wineLogOutput = reinterpret_cast<PFN_wineLogOutput>(GetProcAddress(ntdll, "__wine_dbg_output"));
+      if (ntdll)
+        m_wineLogOutput = reinterpret_cast<PFN_wineLogOutput>(GetProcAddress(ntdll, "__wine_dbg_output"));
 #endif
-        auto path = getFileName(m_fileName);
+      auto path = getFileName(m_fileName);
 
-        if (!path.empty())
-          m_fileStream = std::ofstream(str::topath(path.c_str()).c_str());
-      }
+      if (!path.empty())
+        m_fileStream = std::ofstream(str::topath(path.c_str()).c_str());
+    }
 
-      std::stringstream stream(message);
-      std::string line;
+    // Collapse repeated messages, which commonly happens
+    // when warnings are emitted for every draw or resource.
+    if (level == m_lastLevel && message == m_lastMessage) {
+      m_repeatCount += 1;
+      return;
+    }
+
+    writeRepeatCount();
 
-      while (std::getline(stream, line, '\n')) {
-        std::stringstream outstream;
-        outstream << prefix << line << std::endl;
+    m_lastLevel = level;
+    m_lastMessage = message;
 
-        std::string adjusted = outstream.str();
+    std::stringstream stream(message);
+    std::string line;
 
-        if (!adjusted.empty()) {
-          if (m_wineLogOutput)
-            m_wineLogOutput(adjusted.c_str());
-          else
-            std::cerr << adjusted;
-        }
+    while (std::getline(stream, line, '\n')) {
+      std::stringstream outstream;
+      outstream << prefix << line << std::endl;
 
-        if (m_fileStream)
-          m_fileStream << adjusted;
+      std::string adjusted = outstream.str();
+
+      if (!adjusted.empty()) {
+        if (m_wineLogOutput)
+          m_wineLogOutput(adjusted.c_str());
+        else
+          std::cerr << adjusted;
       }
+
+      if (m_fileStream)
+        m_fileStream << adjusted;
     }
   }
+
+
+  void Logger::writeRepeatCount() {
+    if (!m_repeatCount)
+      return;
+
+    std::string adjusted = str::format(
+      s_prefixes.at(static_cast<uint32_t>(m_lastLevel)), "Last message repeated ", m_repeatCount, " times\n");
+
+    if (m_wineLogOutput)
+      m_wineLogOutput(adjusted.c_str());
+    else
+      std::cerr << adjusted;
+
+    if (m_fileStream)
+      m_fileStream << adjusted;
+
+    m_repeatCount = 0;
+  }
   
   
   std::string Logger::getFileName(const std::string& base) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -25,6 +26,11 @@ namespace dxvk {
    * 
    * Logger for one DLL. Creates a text file and
    * writes all log messages to that file.
+   *
+   * Messages are pushed to a lock-free queue, and
+   * whichever thread manages to acquire the lock
+   * writes out all pending messages. Other threads
+   * return immediately rather than waiting for I/O.
    */
   class Logger {
     
@@ -45,11 +51,19 @@ namespace dxvk {
     }
     
   private:
+
+    struct LogEntry {
+      LogLevel    level;
+      std::string message;
+      LogEntry*   next;
+    };
     
     static Logger     s_instance;
     
     const LogLevel    m_minLevel;
     const std::string m_fileName;
+
+    std::atomic<LogEntry*> m_queue = { nullptr };
     
     dxvk::mutex       m_mutex;
     std::ofstream     m_fileStream;
@@ -57,7 +71,17 @@ namespace dxvk {
     bool              m_initialized = false;
     PFN_wineLogOutput m_wineLogOutput = nullptr;
 
+    LogLevel          m_lastLevel = LogLevel::None;
+    std::string       m_lastMessage;
+    uint32_t          m_repeatCount = 0;
+
     void emitMsg(LogLevel level, const std::string& message);
+
+    void flushMsgs();
+
+    void writeMsg(LogLevel level, const std::string& message);
+
+    void writeRepeatCount();
     
     std::string getFileName(
       const std::string& base);
@@ -1,7 +1,150 @@
 #include "sha1.h"
 #include "sha1_util.h"
 
+#include <algorithm>
+
+#include "../util_bit.h"
+
+#if defined(DXVK_ARCH_X86) && (!defined(_MSC_VER) || defined(__clang__))
+  #include <cpuid.h>
+#endif
+
 namespace dxvk {
+
+#if defined(DXVK_ARCH_X86)
+  #if !defined(_MSC_VER) || defined(__clang__)
+  __attribute__((target("sha,sse4.1")))
+  #endif
+  static void sha1TransformShaNi(
+          uint32_t*       state,
+    const uint8_t*        data,
+          size_t          blockCount) {
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ull, 0x08090a0b0c0d0e0full);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1b);
+    __m128i e0 = _mm_set_epi32(int32_t(state[4]), 0, 0, 0);
+    __m128i e1;
+
+    __m128i msg0, msg1, msg2, msg3;
+
+    // Four rounds per step, with the message schedule for
+    // subsequent steps being computed in the same step
+    #define SHA1_STEP(eIn, eOut, m0, m1, m2, m3, fn)  \
+      eIn  = _mm_sha1nexte_epu32(eIn, m0);            \
+      eOut = abcd;                                    \
+      m1   = _mm_sha1msg2_epu32(m1, m0);              \
+      abcd = _mm_sha1rnds4_epu32(abcd, eIn, fn);      \
+      m3   = _mm_sha1msg1_epu32(m3, m0);              \
+      m2   = _mm_xor_si128(m2, m0);
+
+    for (size_t i = 0; i < blockCount; i++) {
+      __m128i abcdSave = abcd;
+      __m128i e0Save = e0;
+
+      msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data +  0)), mask);
+      msg1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), mask);
+      msg2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), mask);
+      msg3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), mask);
+
+      e0   = _mm_add_epi32(e0, msg0);
+      e1   = abcd;
+      abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+      e1   = _mm_sha1nexte_epu32(e1, msg1);
+      e0   = abcd;
+      abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+      msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+      e0   = _mm_sha1nexte_epu32(e0, msg2);
+      e1   = abcd;
+      abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+      msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+      msg0 = _mm_xor_si128(msg0, msg2);
+
+      SHA1_STEP(e1, e0, msg3, msg0, msg1, msg2, 0);
+      SHA1_STEP(e0, e1, msg0, msg1, msg2, msg3, 0);
+      SHA1_STEP(e1, e0, msg1, msg2, msg3, msg0, 1);
+      SHA1_STEP(e0, e1, msg2, msg3, msg0, msg1, 1);
+      SHA1_STEP(e1, e0, msg3, msg0, msg1, msg2, 1);
+      SHA1_STEP(e0, e1, msg0, msg1, msg2, msg3, 1);
+      SHA1_STEP(e1, e0, msg1, msg2, msg3, msg0, 1);
+      SHA1_STEP(e0, e1, msg2, msg3, msg0, msg1, 2);
+      SHA1_STEP(e1, e0, msg3, msg0, msg1, msg2, 2);
+      SHA1_STEP(e0, e1, msg0, msg1, msg2, msg3, 2);
+      SHA1_STEP(e1, e0, msg1, msg2, msg3, msg0, 2);
+      SHA1_STEP(e0, e1, msg2, msg3, msg0, msg1, 2);
+      SHA1_STEP(e1, e0, msg3, msg0, msg1, msg2, 3);
+      SHA1_STEP(e0, e1, msg0, msg1, msg2, msg3, 3);
+      SHA1_STEP(e1, e0, msg1, msg2, msg3, msg0, 3);
+      SHA1_STEP(e0, e1, msg2, msg3, msg0, msg1, 3);
+      SHA1_STEP(e1, e0, msg3, msg0, msg1, msg2, 3);
+
+      e0   = _mm_sha1nexte_epu32(e0, e0Save);
+      abcd = _mm_add_epi32(abcd, abcdSave);
+
+      data += SHA1_BLOCK_LENGTH;
+    }
+
+    #undef SHA1_STEP
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+  }
+
+
+  static bool hasShaNi() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+    int info1[4], info7[4];
+    __cpuid(info1, 1);
+    __cpuidex(info7, 7, 0);
+    #else
+    unsigned int info1[4] = { }, info7[4] = { };
+    __get_cpuid(1, &info1[0], &info1[1], &info1[2], &info1[3]);
+    __get_cpuid_count(7, 0, &info7[0], &info7[1], &info7[2], &info7[3]);
+    #endif
+
+    // Require SSSE3, SSE4.1 and SHA extensions
+    return (info1[2] & (1 << 9))
+        && (info1[2] & (1 << 19))
+        && (info7[1] & (1 << 29));
+  }
+#endif
+
+
+  static void sha1Update(
+          SHA1_CTX*       ctx,
+    const uint8_t*        data,
+          size_t          size) {
+#if defined(DXVK_ARCH_X86)
+    static const bool s_hasShaNi = hasShaNi();
+
+    if (likely(s_hasShaNi)) {
+      // Fill up any partially filled block first, then feed
+      // complete blocks from the source data to the fast path
+      size_t offset = size_t((ctx->count >> 3) & 63);
+      size_t head = offset ? std::min(size, SHA1_BLOCK_LENGTH - offset) : 0;
+
+      if (head) {
+        SHA1Update(ctx, data, head);
+        data += head;
+        size -= head;
+      }
+
+      size_t blockCount = size / SHA1_BLOCK_LENGTH;
+
+      if (blockCount) {
+        sha1TransformShaNi(ctx->state, data, blockCount);
+        ctx->count += uint64_t(blockCount * SHA1_BLOCK_LENGTH) << 3;
+
+        data += blockCount * SHA1_BLOCK_LENGTH;
+        size -= blockCount * SHA1_BLOCK_LENGTH;
+      }
+    }
+#endif
+
+    SHA1Update(ctx, data, size);
+  }
+
   
   std::string Sha1Hash::toString() const {
     static const char nibbles[]
@@ -38,7 +181,7 @@ namespace dxvk {
     
     for (size_t i = 0; i < numChunks; i++) {
       auto ptr = reinterpret_cast<const uint8_t*>(chunks[i].data);
-      SHA1Update(&ctx, ptr, chunks[i].size);
+      sha1Update(&ctx, ptr, chunks[i].size);
     }
 
     SHA1Final(digest.data(), &ctx);
@@ -0,0 +1,65 @@
+#include "sync_futex.h"
+
+#ifndef _WIN32
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace dxvk::sync {
+
+#ifdef _WIN32
+
+  using PFN_WaitOnAddress = BOOL (WINAPI *)(volatile void*, void*, SIZE_T, DWORD);
+  using PFN_WakeByAddressAll = void (WINAPI *)(void*);
+
+  struct FutexProcs {
+    FutexProcs() {
+      HMODULE module = ::GetModuleHandleW(L"kernelbase.dll");
+
+      if (module) {
+        WaitOnAddress = reinterpret_cast<PFN_WaitOnAddress>(
+          ::GetProcAddress(module, "WaitOnAddress"));
+        WakeByAddressAll = reinterpret_cast<PFN_WakeByAddressAll>(
+          ::GetProcAddress(module, "WakeByAddressAll"));
+      }
+    }
+
+    PFN_WaitOnAddress     WaitOnAddress     = nullptr;
+    PFN_WakeByAddressAll  WakeByAddressAll  = nullptr;
+  };
+
+  static const FutexProcs g_futexProcs;
+
+
+  void futexWait(std::atomic<uint32_t>& word, uint32_t value) {
+    // Without WaitOnAddress, degrade to a plain yield loop
+    if (likely(g_futexProcs.WaitOnAddress))
+      g_futexProcs.WaitOnAddress(&word, &value, sizeof(value), INFINITE);
+    else
+      ::Sleep(0);
+  }
+
+
+  void futexWakeAll(std::atomic<uint32_t>& word) {
+    if (likely(g_futexProcs.WakeByAddressAll))
+      g_futexProcs.WakeByAddressAll(&word);
+  }
+
+#else
+
+  void futexWait(std::atomic<uint32_t>& word, uint32_t value) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word),
+      FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+  }
+
+
+  void futexWakeAll(std::atomic<uint32_t>& word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word),
+      FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+  }
+
+#endif
+
+}
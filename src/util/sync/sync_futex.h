@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+
+#include "sync_spinlock.h"
+
+namespace dxvk::sync {
+
+  /**
+   * \brief Blocks on an address
+   *
+   * Puts the calling thread to sleep as long as \c word
+   * contains \c value. May return spuriously.
+   * \param [in] word Address to wait on
+   * \param [in] value Expected value
+   */
+  void futexWait(std::atomic<uint32_t>& word, uint32_t value);
+
+  /**
+   * \brief Wakes up all threads waiting on an address
+   * \param [in] word Address to wake up waiters for
+   */
+  void futexWakeAll(std::atomic<uint32_t>& word);
+
+
+  /**
+   * \brief Futex-based condition
+   *
+   * Lightweight replacement for a mutex and condition
+   * variable pair when the wait condition only depends
+   * on atomic state. Notifying is a single atomic load
+   * if no thread is waiting, and waiters spin briefly
+   * before going to sleep in order to avoid a context
+   * switch on short waits.
+   */
+  class FutexCondition {
+
+  public:
+
+    /**
+     * \brief Waits for a condition to become true
+     *
+     * \param [in] spinCount Number of probes before sleeping
+     * \param [in] pred Condition to test
+     */
+    template<typename Pred>
+    void wait(uint32_t spinCount, const Pred& pred) {
+      if (pred())
+        return;
+
+      for (uint32_t i = 1; i < spinCount; i++) {
+        pause();
+
+        if (pred())
+          return;
+      }
+
+      m_waiters.fetch_add(1);
+
+      // Pairs with the fence in notifyAll. Without it, the
+      // predicate may observe stale state even though the
+      // notifying thread does not see the waiter yet.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      while (true) {
+        uint32_t epoch = m_epoch.load();
+
+        if (pred())
+          break;
+
+        futexWait(m_epoch, epoch);
+      }
+
+      m_waiters.fetch_sub(1);
+    }
+
+    /**
+     * \brief Wakes up all waiting threads
+     *
+     * Must be called after changing any state that a
+     * waiter's condition depends on. A full fence keeps the
+     * waiter check from being reordered with those stores.
+     */
+    void notifyAll() {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (m_waiters.load()) {
+        m_epoch.fetch_add(1);
+        futexWakeAll(m_epoch);
+      }
+    }
+
+  private:
+
+    std::atomic<uint32_t> m_epoch   = { 0u };
+    std::atomic<uint32_t> m_waiters = { 0u };
+
+  };
+
+}
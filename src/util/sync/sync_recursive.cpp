@@ -1,14 +1,75 @@
 #include "sync_recursive.h"
 #include "sync_spinlock.h"
 
+#include "../log/log.h"
+
+#include "../util_string.h"
+
+#ifndef _WIN32
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace dxvk::sync {
 
+  /**
+   * \brief Checks whether process-wide barriers are supported
+   *
+   * Revoking ownership requires forcing a full memory barrier
+   * on the owning thread, since the owner does not use atomic
+   * read-modify-write operations on its fast path.
+   */
+  static bool canElideLocks() {
+#ifdef _WIN32
+    return true;
+#else
+    long mask = ::syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+    return mask > 0 && (mask & MEMBARRIER_CMD_GLOBAL);
+#endif
+  }
+
+
+  static void flushProcessBarrier() {
+#ifdef _WIN32
+    ::FlushProcessWriteBuffers();
+#else
+    ::syscall(SYS_membarrier, MEMBARRIER_CMD_GLOBAL, 0);
+#endif
+  }
+
+
+  static const bool g_canElideLocks = canElideLocks();
+
+
   void RecursiveSpinlock::lock() {
-    spin(2000, [this] { return try_lock(); });
+    uint32_t threadId = dxvk::this_thread::get_id();
+
+    if (likely(tryLockBiased(threadId)))
+      return;
+
+    spin(2000, [this, threadId] { return tryLockShared(threadId); });
+
+    if (unlikely(!m_biasRevoked.load(std::memory_order_relaxed)))
+      revokeBias();
+
+    // The former owner may still be inside the lock
+    spin(200, [this] {
+      return !m_biasDepth.load(std::memory_order_acquire);
+    });
   }
 
 
   void RecursiveSpinlock::unlock() {
+    uint32_t depth = m_biasDepth.load(std::memory_order_relaxed);
+
+    // Only the owner can observe a non-zero depth here,
+    // since any other thread would have to revoke first
+    if (likely(depth && m_biasOwner.load(std::memory_order_relaxed) == dxvk::this_thread::get_id())) {
+      m_biasDepth.store(depth - 1, std::memory_order_release);
+      return;
+    }
+
     if (likely(m_counter == 0))
       m_owner.store(0, std::memory_order_release);
     else
@@ -18,6 +79,65 @@ namespace dxvk::sync {
 
   bool RecursiveSpinlock::try_lock() {
     uint32_t threadId = dxvk::this_thread::get_id();
+
+    if (tryLockBiased(threadId))
+      return true;
+
+    if (!tryLockShared(threadId))
+      return false;
+
+    if (unlikely(!m_biasRevoked.load(std::memory_order_relaxed)))
+      revokeBias();
+
+    // Never block on the former owner here, callers such as
+    // D3DLOCK_DONOTWAIT rely on try_lock returning immediately.
+    // Revocation is permanent, so a later attempt will succeed.
+    if (likely(!m_biasDepth.load(std::memory_order_acquire)))
+      return true;
+
+    if (likely(m_counter == 0))
+      m_owner.store(0, std::memory_order_release);
+    else
+      m_counter -= 1;
+
+    return false;
+  }
+
+
+  bool RecursiveSpinlock::tryLockBiased(uint32_t threadId) {
+    uint32_t owner = m_biasOwner.load(std::memory_order_relaxed);
+
+    if (unlikely(owner != threadId)) {
+      if (owner || !g_canElideLocks || m_biasRevoked.load())
+        return false;
+
+      if (!m_biasOwner.compare_exchange_strong(owner, threadId))
+        return false;
+    }
+
+    uint32_t depth = m_biasDepth.load(std::memory_order_relaxed);
+    m_biasDepth.store(depth + 1, std::memory_order_relaxed);
+
+    // A revoking thread waits for the depth to drop
+    // to zero, so nested acquisitions are always safe
+    if (depth)
+      return true;
+
+    // Pairs with the process-wide barrier in revokeBias,
+    // which orders the depth store against this load.
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    if (likely(!m_biasRevoked.load(std::memory_order_relaxed))) {
+      m_biasCount += 1;
+      return true;
+    }
+
+    m_biasDepth.store(0, std::memory_order_release);
+    return false;
+  }
+
+
+  bool RecursiveSpinlock::tryLockShared(uint32_t threadId) {
     uint32_t expected = 0;
 
     bool status = m_owner.compare_exchange_weak(
@@ -33,4 +153,18 @@ namespace dxvk::sync {
     return true;
   }
 
+
+  void RecursiveSpinlock::revokeBias() {
+    // We hold the shared lock at this point, so any other thread
+    // will block on it. The owner may still be inside the lock
+    // after this, the caller needs to check the depth.
+    m_biasRevoked.store(true);
+    flushProcessBarrier();
+
+    if (m_biasOwner.load()) {
+      Logger::debug(str::format("Device lock: Cross-thread access after ",
+        m_biasCount, " elided acquisitions, using regular locking"));
+    }
+  }
+
 }
@@ -11,6 +11,13 @@ namespace dxvk::sync {
    * 
    * Implements a spinlock that can be acquired
    * by the same thread multiple times.
+   *
+   * The first thread to acquire the lock becomes its
+   * owner and can acquire and release it without any
+   * atomic read-modify-write operations, as long as no
+   * other thread ever tries to take the lock. The first
+   * time that happens, ownership is revoked and the lock
+   * permanently falls back to a regular spinlock.
    */
   class RecursiveSpinlock {
 
@@ -26,6 +33,17 @@ namespace dxvk::sync {
 
     std::atomic<uint32_t> m_owner   = { 0u };
     uint32_t              m_counter = { 0u };
+
+    std::atomic<uint32_t> m_biasOwner   = { 0u };
+    std::atomic<uint32_t> m_biasDepth   = { 0u };
+    std::atomic<bool>     m_biasRevoked = { false };
+    uint64_t              m_biasCount   = 0u;
+
+    bool tryLockBiased(uint32_t threadId);
+
+    bool tryLockShared(uint32_t threadId);
+
+    void revokeBias();
     
   };
 
@@ -8,6 +8,8 @@
 
 #include "../thread.h"
 
+#include "sync_futex.h"
+
 namespace dxvk::sync {
   
   /**
@@ -20,6 +22,9 @@ namespace dxvk::sync {
   class Signal : public RcObject {
     
   public:
+
+    /// Number of probes before a waiting thread goes to sleep
+    constexpr static uint32_t SpinCount = 200;
     
     virtual ~Signal() { }
 
@@ -72,14 +77,12 @@ namespace dxvk::sync {
     }
 
     void signal(uint64_t value) {
-      std::unique_lock<dxvk::mutex> lock(m_mutex);
-      m_value.store(value, std::memory_order_release);
-      m_cond.notify_all();
+      m_value.store(value);
+      m_cond.notifyAll();
     }
     
     void wait(uint64_t value) {
-      std::unique_lock<dxvk::mutex> lock(m_mutex);
-      m_cond.wait(lock, [this, value] {
+      m_cond.wait(SpinCount, [this, value] {
         return value <= m_value.load(std::memory_order_acquire);
       });
     }
@@ -87,8 +90,7 @@ namespace dxvk::sync {
   private:
 
     std::atomic<uint64_t>    m_value;
-    dxvk::mutex              m_mutex;
-    dxvk::condition_variable m_cond;
+    FutexCondition           m_cond;
 
   };
 
@@ -115,8 +117,8 @@ namespace dxvk::sync {
 
     void signal(uint64_t value) {
       std::unique_lock<dxvk::mutex> lock(m_mutex);
-      m_value.store(value, std::memory_order_release);
-      m_cond.notify_all();
+      m_value.store(value);
+      m_cond.notifyAll();
 
       for (auto i = m_callbacks.begin(); i != m_callbacks.end(); ) {
         if (value >= i->first) {
@@ -129,8 +131,7 @@ namespace dxvk::sync {
     }
 
     void wait(uint64_t value) {
-      std::unique_lock<dxvk::mutex> lock(m_mutex);
-      m_cond.wait(lock, [this, value] {
+      m_cond.wait(SpinCount, [this, value] {
         return value <= m_value.load(std::memory_order_acquire);
       });
     }
@@ -151,7 +152,7 @@ namespace dxvk::sync {
 
     std::atomic<uint64_t>    m_value;
     dxvk::mutex              m_mutex;
-    dxvk::condition_variable m_cond;
+    FutexCondition           m_cond;
 
     std::list<std::pair<uint64_t, std::function<void ()>>> m_callbacks;
 
@@ -1,12 +1,110 @@
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
 
 #include "thread.h"
 #include "util_likely.h"
 
+namespace dxvk {
+
+  /**
+   * \brief Per-processor performance ranks
+   *
+   * Higher values denote faster cores. The absolute
+   * values are meaningless, only the order matters.
+   */
+  struct CpuCoreRanks {
+    std::array<uint32_t, 64> ranks = { };
+    uint32_t                 count = 0;
+  };
+
+
+  static CpuCoreRanks queryCpuCoreRanks();
+
+
+  static std::array<uint64_t, 2> computeCpuCoreMasks() {
+    CpuCoreRanks info = queryCpuCoreRanks();
+
+    uint32_t maxRank = 0;
+    uint32_t minRank = ~0u;
+
+    for (uint32_t i = 0; i < info.count; i++) {
+      maxRank = std::max(maxRank, info.ranks[i]);
+      minRank = std::min(minRank, info.ranks[i]);
+    }
+
+    // Leave homogeneous CPUs alone entirely
+    std::array<uint64_t, 2> masks = { };
+
+    if (!info.count || minRank == maxRank)
+      return masks;
+
+    for (uint32_t i = 0; i < info.count; i++) {
+      uint32_t index = info.ranks[i] == maxRank
+        ? uint32_t(CpuCoreType::Performance)
+        : uint32_t(CpuCoreType::Efficiency);
+
+      masks[index] |= uint64_t(1) << i;
+    }
+
+    return masks;
+  }
+
+
+  uint64_t getCpuCoreMask(CpuCoreType type) {
+    static const std::array<uint64_t, 2> s_masks = computeCpuCoreMasks();
+    return s_masks[uint32_t(type)];
+  }
+
+}
+
 #ifdef _WIN32
 
 namespace dxvk {
 
+  static CpuCoreRanks queryCpuCoreRanks() {
+    CpuCoreRanks result;
+
+    DWORD size = 0;
+    ::GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &size);
+
+    if (!size)
+      return result;
+
+    std::vector<char> data(size);
+
+    if (!::GetLogicalProcessorInformationEx(RelationProcessorCore,
+        reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(data.data()), &size))
+      return result;
+
+    for (DWORD offset = 0; offset < size; ) {
+      auto entry = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(&data[offset]);
+      offset += entry->Size;
+
+      // Affinity masks only ever cover one processor group
+      // anyway, so ignore anything outside the first one.
+      const auto& core = entry->Processor;
+
+      for (WORD i = 0; i < core.GroupCount; i++) {
+        if (core.GroupMask[i].Group)
+          continue;
+
+        for (uint32_t j = 0; j < 64; j++) {
+          if (uint64_t(core.GroupMask[i].Mask) & (uint64_t(1) << j)) {
+            result.ranks[j] = core.EfficiencyClass;
+            result.count = std::max(result.count, j + 1);
+          }
+        }
+      }
+    }
+
+    return result;
+  }
+
+
   thread::thread(ThreadProc&& proc)
   : m_data(new ThreadData(std::move(proc))) {
     m_data->handle = ::CreateThread(nullptr, 0x100000,
@@ -46,6 +144,7 @@ namespace dxvk {
       default:
       case ThreadPriority::Normal: value = THREAD_PRIORITY_NORMAL; break;
       case ThreadPriority::Lowest: value = THREAD_PRIORITY_LOWEST; break;
+      case ThreadPriority::Highest: value = THREAD_PRIORITY_HIGHEST; break;
     }
 
     if (m_data)
@@ -53,6 +152,12 @@ namespace dxvk {
   }
 
 
+  void thread::set_affinity(uint64_t mask) {
+    if (m_data && mask)
+      ::SetThreadAffinityMask(m_data->handle, DWORD_PTR(mask));
+  }
+
+
   uint32_t thread::hardware_concurrency() {
     SYSTEM_INFO info = { };
     ::GetSystemInfo(&info);
@@ -92,6 +197,36 @@ namespace dxvk::this_thread {
 
 #else
 
+namespace dxvk {
+
+  static bool readSysfsValue(const std::string& path, uint32_t& value) {
+    std::ifstream file(path);
+    return bool(file >> value);
+  }
+
+
+  static CpuCoreRanks queryCpuCoreRanks() {
+    CpuCoreRanks result;
+
+    // Prefer the scheduler's capacity values where available,
+    // and fall back to the maximum frequency on x86 since
+    // hybrid Intel CPUs do not expose any capacity info.
+    for (uint32_t i = 0; i < result.ranks.size(); i++) {
+      std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(i);
+
+      if (!readSysfsValue(base + "/cpu_capacity", result.ranks[i])
+       && !readSysfsValue(base + "/cpufreq/cpuinfo_max_freq", result.ranks[i]))
+        break;
+
+      result.count = i + 1;
+    }
+
+    return result;
+  }
+
+}
+
+
 namespace dxvk::this_thread {
   
   static std::atomic<uint32_t> g_threadCtr = { 0u };
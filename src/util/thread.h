@@ -22,8 +22,34 @@ namespace dxvk {
   enum class ThreadPriority : int32_t {
     Normal,
     Lowest,
+    Highest,
   };
 
+
+  /**
+   * \brief CPU core type
+   *
+   * Used to query the set of cores of a given
+   * type on CPUs with heterogeneous cores.
+   */
+  enum class CpuCoreType : uint32_t {
+    Performance,
+    Efficiency,
+  };
+
+
+  /**
+   * \brief Queries mask of CPU cores of a given type
+   *
+   * Each bit represents one logical processor, only the
+   * first 64 processors are considered. The topology is
+   * detected once and cached.
+   * \param [in] type Core type
+   * \returns Core mask, or 0 if the CPU does not have
+   *    heterogeneous cores or detection failed.
+   */
+  uint64_t getCpuCoreMask(CpuCoreType type);
+
 #ifdef _WIN32
 
   using ThreadProc = std::function<void()>;
@@ -108,6 +134,8 @@ namespace dxvk {
 
     void set_priority(ThreadPriority priority);
 
+    void set_affinity(uint64_t mask);
+
     static uint32_t hardware_concurrency();
 
   private:
@@ -315,11 +343,29 @@ namespace dxvk {
       int32_t policy;
       switch (priority) {
         default:
+        // Raising the priority of a SCHED_OTHER thread
+        // requires privileges we cannot expect to have
+        case ThreadPriority::Highest:
         case ThreadPriority::Normal: policy = SCHED_OTHER; break;
         case ThreadPriority::Lowest: policy = SCHED_IDLE;  break;
       }
       ::pthread_setschedparam(this->native_handle(), policy, &param);
     }
+
+    void set_affinity(uint64_t mask) {
+      if (!mask)
+        return;
+
+      cpu_set_t set;
+      CPU_ZERO(&set);
+
+      for (uint32_t i = 0; i < 64; i++) {
+        if (mask & (uint64_t(1) << i))
+          CPU_SET(i, &set);
+      }
+
+      ::pthread_setaffinity_np(this->native_handle(), sizeof(set), &set);
+    }
   };
 
   using mutex              = std::mutex;
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "util_arena.h"
+
+namespace dxvk {
+
+  MemoryArena::MemoryArena() {
+
+  }
+
+
+  MemoryArena::~MemoryArena() {
+    while (m_chunks) {
+      Chunk* next = m_chunks->next;
+      std::free(m_chunks);
+      m_chunks = next;
+    }
+  }
+
+
+  void* MemoryArena::allocChunk(size_t size, size_t alignment) {
+    // Large allocations get a dedicated chunk so that the
+    // remainder of the current chunk does not go to waste
+    size_t chunkSize = sizeof(Chunk) + size + alignment;
+    bool dedicated = chunkSize > ChunkSize / 4;
+
+    if (!dedicated)
+      chunkSize = ChunkSize;
+
+    auto chunk = static_cast<Chunk*>(std::malloc(chunkSize));
+
+    if (!chunk)
+      throw std::bad_alloc();
+
+    chunk->next = m_chunks;
+    chunk->size = chunkSize;
+
+    m_chunks = chunk;
+    m_allocatedSize += chunkSize;
+
+    uintptr_t base = reinterpret_cast<uintptr_t>(chunk) + sizeof(Chunk);
+    uintptr_t ptr = (base + alignment - 1) & ~uintptr_t(alignment - 1);
+
+    if (!dedicated) {
+      m_ptr = ptr + size;
+      m_end = reinterpret_cast<uintptr_t>(chunk) + chunkSize;
+    }
+
+    return reinterpret_cast<void*>(ptr);
+  }
+
+}
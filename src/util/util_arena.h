@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "util_likely.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Memory arena
+   *
+   * Simple bump allocator that hands out memory from large
+   * chunks. Individual allocations are never freed, instead
+   * all memory is released at once when the arena is destroyed.
+   * Intended for short-lived objects with many small allocations,
+   * such as shader compilers. This is not thread-safe.
+   */
+  class MemoryArena {
+    constexpr static size_t ChunkSize = 64ull << 10;
+  public:
+
+    MemoryArena();
+
+    ~MemoryArena();
+
+    MemoryArena             (const MemoryArena&) = delete;
+    MemoryArena& operator = (const MemoryArena&) = delete;
+
+    /**
+     * \brief Allocates memory
+     *
+     * \param [in] size Number of bytes to allocate
+     * \param [in] alignment Required alignment, must
+     *    be a power of two
+     * \returns Pointer to allocated memory
+     */
+    void* alloc(size_t size, size_t alignment) {
+      uintptr_t ptr = (m_ptr + alignment - 1) & ~uintptr_t(alignment - 1);
+
+      if (likely(ptr + size <= m_end)) {
+        m_ptr = ptr + size;
+        return reinterpret_cast<void*>(ptr);
+      }
+
+      return allocChunk(size, alignment);
+    }
+
+    /**
+     * \brief Queries total amount of memory allocated
+     * \returns Size of all chunks, in bytes
+     */
+    size_t getAllocatedSize() const {
+      return m_allocatedSize;
+    }
+
+  private:
+
+    struct Chunk {
+      Chunk*    next;
+      size_t    size;
+    };
+
+    Chunk*    m_chunks        = nullptr;
+    uintptr_t m_ptr           = 0;
+    uintptr_t m_end           = 0;
+    size_t    m_allocatedSize = 0;
+
+    void* allocChunk(size_t size, size_t alignment);
+
+  };
+
+
+  /**
+   * \brief Arena allocator
+   *
+   * Standard allocator that allocates memory from a memory
+   * arena, or falls back to regular heap allocations if no
+   * arena is set. Copies of a container do not inherit the
+   * arena, so that they can safely outlive it, but moving
+   * a container does, and still depends on the arena.
+   */
+  template<typename T>
+  class ArenaAllocator {
+    template<typename U> friend class ArenaAllocator;
+  public:
+
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment  = std::false_type;
+    using propagate_on_container_move_assignment  = std::false_type;
+    using propagate_on_container_swap             = std::true_type;
+    using is_always_equal                         = std::false_type;
+
+    ArenaAllocator() { }
+
+    explicit ArenaAllocator(MemoryArena* arena)
+    : m_arena(arena) { }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+    : m_arena(other.m_arena) { }
+
+    T* allocate(size_t n) {
+      if (!m_arena)
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+
+      return static_cast<T*>(m_arena->alloc(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+      if (!m_arena)
+        ::operator delete(p);
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const {
+      return ArenaAllocator();
+    }
+
+    template<typename U>
+    bool operator == (const ArenaAllocator<U>& other) const {
+      return m_arena == other.m_arena;
+    }
+
+    template<typename U>
+    bool operator != (const ArenaAllocator<U>& other) const {
+      return m_arena != other.m_arena;
+    }
+
+  private:
+
+    MemoryArena* m_arena = nullptr;
+
+  };
+
+}
@@ -151,6 +151,20 @@ namespace dxvk::bit {
     #endif
   }
 
+  inline uint32_t lzcnt(uint64_t n) {
+    #if defined(DXVK_ARCH_X86_64) && ((defined(_MSC_VER) && !defined(__clang__)) || defined(__LZCNT__))
+    return uint32_t(_lzcnt_u64(n));
+    #elif defined(__GNUC__) || defined(__clang__)
+    return n != 0 ? __builtin_clzll(n) : 64;
+    #else
+    uint32_t hi = uint32_t(n >> 32);
+
+    return hi
+      ? lzcnt(hi)
+      : lzcnt(uint32_t(n)) + 32;
+    #endif
+  }
+
   template<typename T>
   uint32_t pack(T& dst, uint32_t& shift, T src, uint32_t count) {
     constexpr uint32_t Bits = 8 * sizeof(T);
@@ -221,6 +235,170 @@ namespace dxvk::bit {
     #endif
   }
 
+  /**
+   * \brief Hashes a struct bit by bit
+   *
+   * Processes the struct in 16-byte blocks using two
+   * 64-bit accumulators in the style of XXH3, which is
+   * considerably faster than combining individual members
+   * for large structs. Any padding must be initialized.
+   * The result is only meant for in-memory lookups.
+   * \param [in] object The struct to hash
+   * \returns Hash of the raw object data
+   */
+  template<typename T>
+  uint64_t bhash(const T* object) {
+    constexpr size_t BlockCount = sizeof(T) / 16;
+    constexpr size_t TailSize = sizeof(T) % 16;
+
+    constexpr uint64_t Secret0 = 0xbe4ba423396cfeb8ull;
+    constexpr uint64_t Secret1 = 0x1cad21f72c81017cull;
+
+    auto data = reinterpret_cast<const char*>(object);
+
+    uint64_t block[2] = { };
+    uint64_t acc[2];
+
+    #if defined(DXVK_ARCH_X86) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+    auto accumulate = [] (__m128i a, __m128i v) {
+      __m128i secret = _mm_set_epi64x(int64_t(Secret1), int64_t(Secret0));
+      __m128i key = _mm_xor_si128(v, secret);
+      __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+      __m128i swapped = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+      return _mm_add_epi64(a, _mm_add_epi64(product, swapped));
+    };
+
+    __m128i a = _mm_set_epi64x(int64_t(sizeof(T)), int64_t(~sizeof(T)));
+
+    for (size_t i = 0; i < BlockCount; i++)
+      a = accumulate(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)));
+
+    if constexpr (TailSize != 0) {
+      std::memcpy(block, data + 16 * BlockCount, TailSize);
+      a = accumulate(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc), a);
+    #else
+    auto accumulate = [] (uint64_t* a, const uint64_t* v) {
+      uint64_t k0 = v[0] ^ Secret0;
+      uint64_t k1 = v[1] ^ Secret1;
+      a[0] += (k0 & 0xffffffffull) * (k0 >> 32) + v[1];
+      a[1] += (k1 & 0xffffffffull) * (k1 >> 32) + v[0];
+    };
+
+    acc[0] = ~uint64_t(sizeof(T));
+    acc[1] = uint64_t(sizeof(T));
+
+    for (size_t i = 0; i < BlockCount; i++) {
+      std::memcpy(block, data + 16 * i, 16);
+      accumulate(acc, block);
+    }
+
+    if constexpr (TailSize != 0) {
+      block[0] = 0;
+      block[1] = 0;
+
+      std::memcpy(block, data + 16 * BlockCount, TailSize);
+      accumulate(acc, block);
+    }
+    #endif
+
+    // Merge accumulators and avalanche the result
+    uint64_t h = acc[0] ^ (acc[1] * 0x9e3779b185ebca87ull);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /**
+   * \brief Orders non-temporal stores
+   *
+   * Must be called after a series of \ref bstream
+   * calls that did not issue a fence themselves.
+   */
+  inline void sfence() {
+    #if defined(DXVK_ARCH_X86) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+    _mm_sfence();
+    #endif
+  }
+
+  /**
+   * \brief Copies data to write-combined memory
+   *
+   * Uses non-temporal stores for the 16-byte aligned part of
+   * the copy, so that uploads to mapped GPU memory neither
+   * pollute the cache nor read back destination cache lines.
+   * \param [in] dst Destination pointer
+   * \param [in] src Source pointer
+   * \param [in] size Number of bytes to copy
+   * \param [in] fence Whether to issue a store fence. Callers
+   *    that copy many small ranges can defer this to a single
+   *    \ref sfence call at the end.
+   */
+  inline void bstream(void* dst, const void* src, size_t size, bool fence = true) {
+    #if defined(DXVK_ARCH_X86) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+    auto dstBytes = reinterpret_cast<char*>(dst);
+    auto srcBytes = reinterpret_cast<const char*>(src);
+
+    // Copy the unaligned head with regular stores. Not worth
+    // it for tiny copies that do not cover a full vector.
+    size_t head = (16u - (reinterpret_cast<uintptr_t>(dst) & 0xf)) & 0xf;
+
+    if (likely(size >= head + 16)) {
+      if (head) {
+        std::memcpy(dstBytes, srcBytes, head);
+        dstBytes += head;
+        srcBytes += head;
+        size -= head;
+      }
+
+      auto di = reinterpret_cast<__m128i*>(dstBytes);
+      auto si = reinterpret_cast<const __m128i*>(srcBytes);
+
+      size_t count = size / 16;
+
+      for (size_t i = 0; i < count; i++)
+        _mm_stream_si128(di + i, _mm_loadu_si128(si + i));
+
+      if (size & 0xf) {
+        std::memcpy(di + count, si + count, size & 0xf);
+      }
+
+      if (fence)
+        _mm_sfence();
+      return;
+    }
+    #endif
+
+    std::memcpy(dst, src, size);
+  }
+
+  /**
+   * \brief Copies data to mapped GPU memory
+   *
+   * Uses \ref bstream for large copies into write-combined
+   * memory. Small copies are not worth the store fence, and
+   * cached memory may well be read back by the CPU, so both
+   * use a regular \c memcpy.
+   * \param [in] dst Destination pointer
+   * \param [in] src Source pointer
+   * \param [in] size Number of bytes to copy
+   * \param [in] writeCombined Whether the destination
+   *    memory is host-visible, but not host-cached
+   */
+  inline void bcopyMapped(void* dst, const void* src, size_t size, bool writeCombined) {
+    constexpr size_t StreamThreshold = 4096;
+
+    if (writeCombined && size >= StreamThreshold)
+      bstream(dst, src, size);
+    else
+      std::memcpy(dst, src, size);
+  }
+
   template <size_t Bits>
   class bitset {
     static constexpr size_t Dwords = align(Bits, 32) / 32;
@@ -310,11 +488,15 @@ namespace dxvk::bit {
       return m_dwords[idx];
     }
 
-    constexpr size_t bitCount() {
+    constexpr uint32_t dword(uint32_t idx) const {
+      return m_dwords[idx];
+    }
+
+    constexpr size_t bitCount() const {
       return Bits;
     }
 
-    constexpr size_t dwordCount() {
+    constexpr size_t dwordCount() const {
       return Dwords;
     }
 
@@ -14,6 +14,9 @@
 
 namespace dxvk::env {
 
+  static thread_local std::string g_threadName;
+
+
   std::string getEnvVar(const char* name) {
 #ifdef _WIN32
     std::vector<WCHAR> result;
@@ -30,6 +33,15 @@ namespace dxvk::env {
   }
 
 
+  void setEnvVar(const char* name, const char* value) {
+#ifdef _WIN32
+    ::SetEnvironmentVariableW(str::tows(name).c_str(), str::tows(value).c_str());
+#else
+    ::setenv(name, value, 1);
+#endif
+  }
+
+
   size_t matchFileExtension(const std::string& name, const char* ext) {
     auto pos = name.find_last_of('.');
 
@@ -90,6 +102,8 @@ namespace dxvk::env {
   
   
   void setThreadName(const std::string& name) {
+    g_threadName = name;
+
 #ifdef _WIN32
     using SetThreadDescriptionProc = HRESULT (WINAPI *) (HANDLE, PCWSTR);
 
@@ -113,6 +127,11 @@ namespace dxvk::env {
   }
 
 
+  std::string getThreadName() {
+    return g_threadName;
+  }
+
+
   bool createDirectory(const std::string& path) {
 #ifdef _WIN32
     std::array<WCHAR, MAX_PATH + 1> widePath;
@@ -27,6 +27,16 @@ namespace dxvk::env {
    * \returns Value of the variable
    */
   std::string getEnvVar(const char* name);
+
+  /**
+   * \brief Sets environment variable
+   *
+   * Only affects the current process. Mostly useful for
+   * tools that need to control DXVK's behaviour.
+   * \param [in] name Name of the variable
+   * \param [in] value New value
+   */
+  void setEnvVar(const char* name, const char* value);
   
   /**
    * \brief Checks whether a file name has a given extension
@@ -68,6 +78,15 @@ namespace dxvk::env {
    */
   void setThreadName(const std::string& name);
 
+  /**
+   * \brief Gets name of the calling thread
+   *
+   * Only returns names that were previously
+   * set through \ref setThreadName.
+   * \returns Thread name, may be empty
+   */
+  std::string getThreadName();
+
   /**
    * \brief Creates a directory
    * 
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dxvk {
+
+  /**
+   * \brief Flat hash map
+   *
+   * Insert-only open-addressing hash map using Robin Hood
+   * probing. Entries are stored inline in a single array
+   * along with the lower bits of their hash, so that lookups
+   * rarely touch more than one cache line and key comparisons
+   * are only performed on hash matches.
+   *
+   * Meant for caches on hot paths which only ever grow. Since
+   * entries move when the map grows, pointers to values are
+   * only valid until the next insertion.
+   */
+  template<typename K, typename V,
+    typename Hash = std::hash<K>,
+    typename Eq   = std::equal_to<K>>
+  class flat_hash_map {
+
+    struct Entry {
+      K key;
+      V value;
+    };
+
+    struct Slot {
+      uint32_t dist = 0;
+      uint32_t hash = 0;
+      alignas(Entry) unsigned char data[sizeof(Entry)];
+
+      Entry* get() {
+        return std::launder(reinterpret_cast<Entry*>(data));
+      }
+    };
+
+    constexpr static size_t MinCapacity = 16;
+
+  public:
+
+    flat_hash_map() { }
+
+    flat_hash_map             (const flat_hash_map&) = delete;
+    flat_hash_map& operator = (const flat_hash_map&) = delete;
+
+    ~flat_hash_map() {
+      clear();
+    }
+
+    /**
+     * \brief Number of entries
+     * \returns Entry count
+     */
+    size_t size() const {
+      return m_size;
+    }
+
+    /**
+     * \brief Looks up an entry
+     *
+     * \param [in] key Key to look up
+     * \returns Pointer to the value, or \c nullptr
+     *    if no entry with the given key exists
+     */
+    V* find(const K& key) {
+      if (!m_size)
+        return nullptr;
+
+      size_t hash = m_hash(key);
+      size_t mask = m_slots.size() - 1;
+
+      for (uint32_t d = 1, i = hash & mask; ; d++, i = (i + 1) & mask) {
+        Slot& slot = m_slots[i];
+
+        // An empty slot or an entry closer to its home slot than
+        // we are to ours means that the key cannot be in the map.
+        if (slot.dist < d)
+          return nullptr;
+
+        if (slot.hash == uint32_t(hash) && m_eq(slot.get()->key, key))
+          return &slot.get()->value;
+      }
+    }
+
+    /**
+     * \brief Inserts an entry
+     *
+     * Constructs a new value from the given arguments if no
+     * entry with the given key exists yet. Otherwise, the
+     * existing entry is returned and no value is created.
+     * \param [in] key Key to insert
+     * \param [in] args Value constructor arguments
+     * \returns Reference to the value
+     */
+    template<typename... Args>
+    V& emplace(const K& key, Args&&... args) {
+      V* value = find(key);
+
+      if (value)
+        return *value;
+
+      if ((m_size + 1) * 8 > m_slots.size() * 7)
+        grow();
+
+      m_size += 1;
+
+      return *insertNew(m_hash(key),
+        Entry { key, V(std::forward<Args>(args)...) });
+    }
+
+    /**
+     * \brief Iterates over all entries
+     *
+     * Entries are visited in no particular order.
+     * The map must not be modified from the callback.
+     * \param [in] fn Callback taking key and value
+     */
+    template<typename Fn>
+    void for_each(const Fn& fn) {
+      for (auto& slot : m_slots) {
+        if (slot.dist)
+          fn(slot.get()->key, slot.get()->value);
+      }
+    }
+
+    /**
+     * \brief Removes all entries
+     */
+    void clear() {
+      for (auto& slot : m_slots) {
+        if (slot.dist) {
+          slot.get()->~Entry();
+          slot.dist = 0;
+        }
+      }
+
+      m_size = 0;
+    }
+
+  private:
+
+    std::vector<Slot> m_slots;
+    size_t            m_size = 0;
+
+    Hash              m_hash;
+    Eq                m_eq;
+
+    V* insertNew(size_t hash, Entry&& entry) {
+      size_t mask = m_slots.size() - 1;
+      size_t index = hash & mask;
+
+      uint32_t dist = 1;
+      uint32_t hashBits = uint32_t(hash);
+
+      V* result = nullptr;
+
+      while (true) {
+        Slot& slot = m_slots[index];
+
+        if (!slot.dist) {
+          new (slot.data) Entry(std::move(entry));
+          slot.dist = dist;
+          slot.hash = hashBits;
+          return result ? result : &slot.get()->value;
+        }
+
+        // Take the slot from entries that are closer to their
+        // home slot and keep probing with the displaced entry.
+        if (slot.dist < dist) {
+          std::swap(*slot.get(), entry);
+          std::swap(slot.dist, dist);
+          std::swap(slot.hash, hashBits);
+
+          if (!result)
+            result = &slot.get()->value;
+        }
+
+        index = (index + 1) & mask;
+        dist += 1;
+      }
+    }
+
+    void grow() {
+      std::vector<Slot> slots(std::max(m_slots.size() * 2, MinCapacity));
+      std::swap(slots, m_slots);
+
+      for (auto& slot : slots) {
+        if (slot.dist) {
+          Entry* entry = slot.get();
+          insertNew(m_hash(entry->key), std::move(*entry));
+          entry->~Entry();
+        }
+      }
+    }
+
+  };
+
+}
@@ -2,14 +2,44 @@
 
 namespace dxvk {
 
+  void GpuFlushPacer::update(
+          uint64_t              gpuIdleUs) {
+    constexpr uint32_t sampleIntervalUs = 50000u;
+
+    // Raise thresholds if the GPU was idle less than this
+    // fraction of time, and lower them if it was idle more
+    constexpr uint32_t busyIdlePermille =  5u;
+    constexpr uint32_t idleIdlePermille = 20u;
+
+    auto now = dxvk::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastSample).count();
+
+    if (elapsed < sampleIntervalUs)
+      return;
+
+    uint64_t idleUs = gpuIdleUs - m_lastIdleUs;
+    uint64_t idlePermille = (1000u * idleUs) / uint64_t(elapsed);
+
+    if (idlePermille > idleIdlePermille)
+      m_scale = std::max(MinScale, m_scale - m_scale / 4u);
+    else if (idlePermille < busyIdlePermille)
+      m_scale = std::min(MaxScale, m_scale + 5u);
+
+    m_lastIdleUs = gpuIdleUs;
+    m_lastSample = now;
+  }
+
+
   bool GpuFlushTracker::considerFlush(
           GpuFlushType          flushType,
           uint64_t              chunkId,
           uint32_t              lastCompleteSubmissionId) {
     constexpr uint32_t minPendingSubmissions = 2;
 
-    constexpr uint32_t minChunkCount =  3u;
-    constexpr uint32_t maxChunkCount = 20u;
+    // Chunk count thresholds are adjusted based on
+    // how often the GPU runs out of work to do
+    uint32_t minChunkCount = m_pacer.scale( 3u);
+    uint32_t maxChunkCount = m_pacer.scale(20u);
 
     // Do not flush if there is nothing to flush
     uint32_t chunkCount = uint32_t(chunkId - m_lastFlushChunkId);
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include "util_time.h"
+
 namespace dxvk {
 
   /**
@@ -24,6 +27,60 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Adaptive flush pacing
+   *
+   * Periodically samples how long the GPU has been idle and
+   * derives a scaling factor for flush thresholds from it. If
+   * the GPU frequently runs out of work, thresholds are lowered
+   * so that work gets submitted sooner, otherwise they are
+   * slowly raised again in order to reduce submission overhead.
+   */
+  class GpuFlushPacer {
+    constexpr static uint32_t MinScale      =  25u;
+    constexpr static uint32_t MaxScale      = 200u;
+    constexpr static uint32_t DefaultScale  = 100u;
+  public:
+
+    /**
+     * \brief Updates pacing from GPU idle time
+     *
+     * Only takes a new sample if enough time has passed
+     * since the previous one, so this is cheap to call.
+     * \param [in] gpuIdleUs Total GPU idle time, in microseconds
+     */
+    void update(
+            uint64_t              gpuIdleUs);
+
+    /**
+     * \brief Scales a flush threshold
+     *
+     * \param [in] value Unscaled threshold
+     * \returns Scaled threshold, at least 1
+     */
+    uint32_t scale(uint32_t value) const {
+      return std::max(1u, (value * m_scale) / DefaultScale);
+    }
+
+    /**
+     * \brief Queries current scaling factor
+     * \returns Scaling factor, in percent
+     */
+    uint32_t getScale() const {
+      return m_scale;
+    }
+
+  private:
+
+    uint32_t m_scale      = DefaultScale;
+    uint64_t m_lastIdleUs = 0ull;
+
+    dxvk::high_resolution_clock::time_point m_lastSample
+      = dxvk::high_resolution_clock::now();
+
+  };
+
+
   /**
    * \brief GPU flush tracker
    *
@@ -59,8 +116,28 @@ namespace dxvk {
             uint64_t              chunkId,
             uint64_t              submissionId);
 
+    /**
+     * \brief Updates flush pacing
+     *
+     * \param [in] gpuIdleUs Total GPU idle time, in microseconds
+     */
+    void updatePacing(
+            uint64_t              gpuIdleUs) {
+      m_pacer.update(gpuIdleUs);
+    }
+
+    /**
+     * \brief Queries flush pacing
+     * \returns Flush pacer
+     */
+    const GpuFlushPacer& getPacing() const {
+      return m_pacer;
+    }
+
   private:
 
+    GpuFlushPacer m_pacer;
+
     GpuFlushType  m_lastMissedType        = GpuFlushType::ImplicitWeakHint;
 
     uint64_t      m_lastFlushChunkId      = 0ull;
@@ -45,8 +45,8 @@ namespace dxvk {
   }
 
 
-  void FpsLimiter::delay(bool vsyncEnabled) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+  void FpsLimiter::delay(bool vsyncEnabled, uint64_t frameId) {
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
 
     if (!isEnabled())
       return;
@@ -54,27 +54,78 @@ namespace dxvk {
     auto t0 = m_lastFrame;
     auto t1 = dxvk::high_resolution_clock::now();
 
-    auto frameTime = std::chrono::duration_cast<TimerDuration>(t1 - t0);
+    if (m_presentLatencyValid && frameId > m_presentFrameId
+     && frameId - m_presentFrameId < FrameCount) {
+      // Predict when the current frame will be displayed based on the
+      // last frame we know the actual present time of, and release the
+      // application so that the time between releasing a frame and it
+      // being displayed stays constant. Don't sleep for more than one
+      // interval so that we recover quickly if a present was delayed.
+      TimePoint displayTime = m_presentTime + m_targetInterval * int64_t(frameId - m_presentFrameId);
+      TimePoint target = std::min(displayTime - m_presentLatency, t1 + m_targetInterval);
 
-    if (frameTime * 100 > m_targetInterval * 103 - m_deviation * 100) {
-      // If we have a slow frame, reset the deviation since we
-      // do not want to compensate for low performance later on
       m_deviation = TimerDuration::zero();
+
+      if (target > t1) {
+        // Don't hold the lock while sleeping, otherwise
+        // present notifications would get delayed.
+        lock.unlock();
+        t1 = Sleep::sleepUntil(t1, target);
+        lock.lock();
+      }
     } else {
-      // Don't call sleep if the amount of time to sleep is shorter
-      // than the time the function calls are likely going to take
-      TimerDuration sleepDuration = m_targetInterval - m_deviation - frameTime;
-      t1 = Sleep::sleepFor(t1, sleepDuration);
-
-      // Compensate for any sleep inaccuracies in the next frame, and
-      // limit cumulative deviation in order to avoid stutter in case we
-      // have a number of slow frames immediately followed by a fast one.
-      frameTime = std::chrono::duration_cast<TimerDuration>(t1 - t0);
-      m_deviation += frameTime - m_targetInterval;
-      m_deviation = std::min(m_deviation, m_targetInterval / 16);
+      auto frameTime = std::chrono::duration_cast<TimerDuration>(t1 - t0);
+
+      if (frameTime * 100 > m_targetInterval * 103 - m_deviation * 100) {
+        // If we have a slow frame, reset the deviation since we
+        // do not want to compensate for low performance later on
+        m_deviation = TimerDuration::zero();
+      } else {
+        // Don't call sleep if the amount of time to sleep is shorter
+        // than the time the function calls are likely going to take
+        TimerDuration sleepDuration = m_targetInterval - m_deviation - frameTime;
+
+        lock.unlock();
+        t1 = Sleep::sleepFor(t1, sleepDuration);
+        lock.lock();
+
+        // Compensate for any sleep inaccuracies in the next frame, and
+        // limit cumulative deviation in order to avoid stutter in case we
+        // have a number of slow frames immediately followed by a fast one.
+        frameTime = std::chrono::duration_cast<TimerDuration>(t1 - t0);
+        m_deviation += frameTime - m_targetInterval;
+        m_deviation = std::min(m_deviation, m_targetInterval / 16);
+      }
     }
 
     m_lastFrame = t1;
+    m_lastFrameId = frameId;
+    m_releaseTimes[frameId % FrameCount] = t1;
+  }
+
+
+  void FpsLimiter::notifyPresent(uint64_t frameId, TimePoint time) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    if (frameId <= m_presentFrameId)
+      return;
+
+    m_presentFrameId = frameId;
+    m_presentTime = time;
+
+    // Ignore frames whose release time has already been overwritten,
+    // as well as frames that have not been released yet.
+    if (frameId > m_lastFrameId || m_lastFrameId - frameId >= FrameCount)
+      return;
+
+    auto latency = std::chrono::duration_cast<TimerDuration>(
+      time - m_releaseTimes[frameId % FrameCount]);
+
+    m_presentLatency = m_presentLatencyValid
+      ? (m_presentLatency * 7 + latency) / 8
+      : latency;
+
+    m_presentLatencyValid = true;
   }
 
 
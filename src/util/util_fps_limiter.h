@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "thread.h"
 #include "util_time.h"
 
@@ -10,11 +12,18 @@ namespace dxvk {
    *
    * Provides functionality to stall an application
    * thread in order to maintain a given frame rate.
+   *
+   * If the times at which frames actually get displayed are
+   * known, frames are paced relative to the most recent present
+   * rather than to the previous CPU-side sleep, so that pacing
+   * follows the display and sleep errors do not accumulate.
    */
   class FpsLimiter {
-
+    constexpr static uint32_t FrameCount = 16;
   public:
 
+    using TimePoint = dxvk::high_resolution_clock::time_point;
+
     /**
      * \brief Creates frame rate limiter
      */
@@ -35,8 +44,19 @@ namespace dxvk {
      * and the time since the last call to \ref delay is
      * shorter than the target interval.
      * \param [in] vsyncEnabled \c true if vsync is enabled
+     * \param [in] frameId ID of the frame that was just presented
+     */
+    void delay(bool vsyncEnabled, uint64_t frameId);
+
+    /**
+     * \brief Notifies the limiter of a completed present
+     *
+     * May be called from any thread, in any order
+     * relative to \ref delay for the same frame.
+     * \param [in] frameId ID of the frame that was displayed
+     * \param [in] time Time at which the frame was displayed
      */
-    void delay(bool vsyncEnabled);
+    void notifyPresent(uint64_t frameId, TimePoint time);
 
     /**
      * \brief Checks whether the frame rate limiter is enabled
@@ -48,7 +68,6 @@ namespace dxvk {
 
   private:
 
-    using TimePoint = dxvk::high_resolution_clock::time_point;
     using TimerDuration = std::chrono::nanoseconds;
 
     dxvk::mutex     m_mutex;
@@ -57,6 +76,14 @@ namespace dxvk {
     TimerDuration   m_deviation       = TimerDuration::zero();
     TimePoint       m_lastFrame;
 
+    uint64_t        m_lastFrameId     = 0;
+    std::array<TimePoint, FrameCount> m_releaseTimes = { };
+
+    uint64_t        m_presentFrameId  = 0;
+    TimePoint       m_presentTime;
+    TimerDuration   m_presentLatency  = TimerDuration::zero();
+    bool            m_presentLatencyValid = false;
+
     bool            m_initialized     = false;
     bool            m_envOverride     = false;
 
@@ -1,14 +1,63 @@
+#include "util_bit.h"
 #include "util_sleep.h"
 #include "util_string.h"
 
 #include "./log/log.h"
 
+#ifdef _WIN32
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x2
+#endif
+#endif
+
 using namespace std::chrono_literals;
 
 namespace dxvk {
 
   Sleep Sleep::s_instance;
 
+#ifdef _WIN32
+  /**
+   * \brief Per-thread high-resolution timer
+   *
+   * Waitable timers cannot be shared between threads
+   * that sleep concurrently, so each thread gets its
+   * own timer on first use.
+   */
+  struct SleepTimer {
+    HANDLE handle = nullptr;
+    bool   initialized = false;
+
+    ~SleepTimer() {
+      if (handle)
+        ::CloseHandle(handle);
+    }
+
+    HANDLE get() {
+      if (!initialized) {
+        // Only supported on Windows 10 1803 and newer. Regular
+        // waitable timers are no better than NtDelayExecution.
+        handle = ::CreateWaitableTimerExW(nullptr, nullptr,
+          CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        initialized = true;
+      }
+
+      return handle;
+    }
+  };
+
+  static thread_local SleepTimer g_sleepTimer;
+#endif
+
+
+  static inline void spinPause() {
+#if defined(DXVK_ARCH_X86)
+    _mm_pause();
+#elif defined(DXVK_ARCH_ARM64)
+    __asm__ __volatile__ ("yield");
+#endif
+  }
+
 
   Sleep::Sleep() {
 
@@ -29,6 +78,12 @@ namespace dxvk {
     initializePlatformSpecifics();
     m_sleepThreshold = 4 * m_sleepGranularity;
 
+    // Start out assuming that sleeps overshoot by about one timer
+    // period, the estimate will be refined as sleeps complete.
+    auto granularity = std::chrono::duration_cast<std::chrono::nanoseconds>(m_sleepGranularity);
+    m_overshootAvg.store(granularity.count());
+    m_overshootDev.store(granularity.count() / 2);
+
     m_initialized.store(true, std::memory_order_release);
   }
 
@@ -76,39 +131,47 @@ namespace dxvk {
     if (!m_initialized.load(std::memory_order_acquire))
       initialize();
 
-    // Busy-wait for the last couple of milliseconds since sleeping
-    // on Windows is highly inaccurate and inconsistent.
-    TimerDuration sleepThreshold = m_sleepThreshold;
+    // Sleep until we are close enough to the target that the
+    // system sleep is unlikely to overshoot, then busy-wait.
+    TimePoint target = t0 + duration;
+    TimerDuration spinThreshold = getSpinThreshold();
 
-    if (m_sleepGranularity != TimerDuration::zero())
-      sleepThreshold += duration / 6;
-
-    TimerDuration remaining = duration;
     TimePoint t1 = t0;
 
-    while (remaining > sleepThreshold) {
-      TimerDuration sleepDuration = remaining - sleepThreshold;
+    while (target - t1 > spinThreshold) {
+      TimerDuration sleepDuration = std::chrono::duration_cast<TimerDuration>(target - t1) - spinThreshold;
 
       systemSleep(sleepDuration);
 
-      t1 = dxvk::high_resolution_clock::now();
-      remaining -= std::chrono::duration_cast<TimerDuration>(t1 - t0);
-      t0 = t1;
+      TimePoint t2 = dxvk::high_resolution_clock::now();
+      updateOvershoot(std::chrono::duration_cast<std::chrono::nanoseconds>((t2 - t1) - sleepDuration));
+      t1 = t2;
     }
 
-    // Busy-wait until we have slept long enough
-    while (remaining > TimerDuration::zero()) {
+    while (t1 < target) {
+      spinPause();
       t1 = dxvk::high_resolution_clock::now();
-      remaining -= std::chrono::duration_cast<TimerDuration>(t1 - t0);
-      t0 = t1;
     }
 
+    updateStats(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - target));
     return t1;
   }
 
 
   void Sleep::systemSleep(TimerDuration duration) {
 #ifdef _WIN32
+    HANDLE timer = g_sleepTimer.get();
+
+    if (timer) {
+      LARGE_INTEGER ticks;
+      ticks.QuadPart = -duration.count();
+
+      if (::SetWaitableTimer(timer, &ticks, 0, nullptr, nullptr, FALSE)) {
+        ::WaitForSingleObject(timer, INFINITE);
+        return;
+      }
+    }
+
     if (NtDelayExecution) {
       LARGE_INTEGER ticks;
       ticks.QuadPart = -duration.count();
@@ -122,4 +185,58 @@ namespace dxvk {
 #endif
   }
 
+
+  Sleep::TimerDuration Sleep::getSpinThreshold() const {
+    // Cover the average overshoot plus some safety margin. Never
+    // spin for longer than the static threshold, which is only
+    // reached if sleeps are extremely inconsistent.
+    int64_t avg = m_overshootAvg.load(std::memory_order_relaxed);
+    int64_t dev = m_overshootDev.load(std::memory_order_relaxed);
+
+    auto threshold = std::chrono::duration_cast<TimerDuration>(
+      std::chrono::nanoseconds(std::max<int64_t>(avg + 4 * dev, 0)));
+
+    return std::min(threshold, m_sleepThreshold);
+  }
+
+
+  void Sleep::updateOvershoot(std::chrono::nanoseconds overshoot) {
+    // Exponential moving averages of the overshoot and its mean
+    // deviation. Concurrent updates may get lost, which is fine.
+    int64_t sample = overshoot.count();
+    int64_t avg = m_overshootAvg.load(std::memory_order_relaxed);
+    int64_t dev = m_overshootDev.load(std::memory_order_relaxed);
+
+    int64_t delta = sample - avg;
+
+    m_overshootAvg.store(avg + delta / 8, std::memory_order_relaxed);
+    m_overshootDev.store(dev + (std::abs(delta) - dev) / 4, std::memory_order_relaxed);
+  }
+
+
+  void Sleep::updateStats(std::chrono::nanoseconds overshoot) {
+    uint64_t ns = uint64_t(std::max<int64_t>(overshoot.count(), 0));
+
+    uint64_t count = m_statCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint64_t total = m_statTotalNs.fetch_add(ns, std::memory_order_relaxed) + ns;
+    uint64_t maxNs = m_statMaxNs.load(std::memory_order_relaxed);
+
+    while (ns > maxNs && !m_statMaxNs.compare_exchange_weak(maxNs, ns, std::memory_order_relaxed))
+      continue;
+
+    if (!(count % 10000)) {
+      Logger::debug(str::format("Sleep: ", count, " sleeps, average overshoot ",
+        double(total) / double(count * 1000), " us, max ", double(std::max(ns, maxNs)) / 1000.0, " us"));
+    }
+  }
+
+
+  SleepStats Sleep::stats() const {
+    SleepStats result;
+    result.sleepCount     = m_statCount.load(std::memory_order_relaxed);
+    result.totalOvershoot = std::chrono::nanoseconds(m_statTotalNs.load(std::memory_order_relaxed));
+    result.maxOvershoot   = std::chrono::nanoseconds(m_statMaxNs.load(std::memory_order_relaxed));
+    return result;
+  }
+
 }
@@ -5,8 +5,26 @@
 
 namespace dxvk {
 
+  /**
+   * \brief Sleep statistics
+   *
+   * Overshoot is the amount of time by which
+   * a sleep exceeded the requested duration.
+   */
+  struct SleepStats {
+    uint64_t                  sleepCount;
+    std::chrono::nanoseconds  totalOvershoot;
+    std::chrono::nanoseconds  maxOvershoot;
+  };
+
+
   /**
    * \brief Utility class for accurate sleeping
+   *
+   * Sleeps using the most precise system timer available, and
+   * busy-waits for the remaining time. The busy-wait threshold
+   * is calibrated at runtime based on how much system sleeps
+   * tend to overshoot, so that spinning is kept to a minimum.
    */
   class Sleep {
 
@@ -41,6 +59,14 @@ namespace dxvk {
       return sleepFor(t0, t1 - t0);
     }
 
+    /**
+     * \brief Queries sleep statistics
+     * \returns Statistics for all sleeps so far
+     */
+    static SleepStats getStats() {
+      return s_instance.stats();
+    }
+
   private:
 
     static Sleep s_instance;
@@ -63,6 +89,14 @@ namespace dxvk {
     TimerDuration m_sleepGranularity = TimerDuration::zero();
     TimerDuration m_sleepThreshold   = TimerDuration::zero();
 
+    // Running estimates of the system sleep overshoot, in ns
+    std::atomic<int64_t>  m_overshootAvg = { 0 };
+    std::atomic<int64_t>  m_overshootDev = { 0 };
+
+    std::atomic<uint64_t> m_statCount     = { 0ull };
+    std::atomic<uint64_t> m_statTotalNs   = { 0ull };
+    std::atomic<uint64_t> m_statMaxNs     = { 0ull };
+
     Sleep();
 
     void initialize();
@@ -73,6 +107,14 @@ namespace dxvk {
 
     void systemSleep(TimerDuration duration);
 
+    TimerDuration getSpinThreshold() const;
+
+    void updateOvershoot(std::chrono::nanoseconds overshoot);
+
+    void updateStats(std::chrono::nanoseconds overshoot);
+
+    SleepStats stats() const;
+
   };
 
 }
@@ -0,0 +1,307 @@
+#include <algorithm>
+
+#include "util_bit.h"
+#include "util_math.h"
+#include "util_tlsf.h"
+
+namespace dxvk {
+
+  TlsfAllocator::TlsfAllocator(uint64_t size)
+  : m_size(size) {
+    for (auto& list : m_freeHeads)
+      list.fill(InvalidIndex);
+
+    if (size) {
+      uint32_t index = createBlock();
+
+      Block& block = m_blocks[index];
+      block.offset = 0;
+      block.size   = size;
+
+      insertFreeBlock(index);
+      m_freeSize = size;
+    }
+  }
+
+
+  TlsfAllocator::~TlsfAllocator() {
+
+  }
+
+
+  uint64_t TlsfAllocator::alloc(
+          uint64_t              size,
+          uint64_t              alignment,
+          uint64_t&             allocSize) {
+    if (!alignment)
+      alignment = 1;
+
+    uint64_t alignedSize = align(std::max<uint64_t>(size, 1), alignment);
+
+    // Try the first block of the matching size class first. If that
+    // does not satisfy the alignment requirement, look for a block
+    // which is large enough to fit the allocation at any offset.
+    uint32_t index = tryAllocFromBlock(findFreeBlock(alignedSize), alignedSize, alignment);
+
+    if (index == InvalidIndex && alignment > 1)
+      index = tryAllocFromBlock(findFreeBlock(alignedSize + alignment - 1), alignedSize, alignment);
+
+    if (index == InvalidIndex)
+      return InvalidOffset;
+
+    const Block& block = m_blocks[index];
+    m_freeSize -= block.size;
+    m_allocations.insert({ block.offset, index });
+
+    allocSize = block.size;
+    return block.offset;
+  }
+
+
+  void TlsfAllocator::free(
+          uint64_t              offset) {
+    auto entry = m_allocations.find(offset);
+
+    if (entry == m_allocations.end())
+      return;
+
+    uint32_t index = entry->second;
+    m_allocations.erase(entry);
+
+    m_freeSize += m_blocks[index].size;
+
+    // Merge with the previous block. Free blocks are always
+    // merged, so there is no need to recursively check.
+    uint32_t prev = m_blocks[index].prevPhys;
+
+    if (prev != InvalidIndex && m_blocks[prev].isFree) {
+      removeFreeBlock(prev);
+
+      m_blocks[prev].size += m_blocks[index].size;
+      m_blocks[prev].nextPhys = m_blocks[index].nextPhys;
+
+      if (m_blocks[prev].nextPhys != InvalidIndex)
+        m_blocks[m_blocks[prev].nextPhys].prevPhys = prev;
+
+      destroyBlock(index);
+      index = prev;
+    }
+
+    // Merge with the next block
+    uint32_t next = m_blocks[index].nextPhys;
+
+    if (next != InvalidIndex && m_blocks[next].isFree) {
+      removeFreeBlock(next);
+
+      m_blocks[index].size += m_blocks[next].size;
+      m_blocks[index].nextPhys = m_blocks[next].nextPhys;
+
+      if (m_blocks[index].nextPhys != InvalidIndex)
+        m_blocks[m_blocks[index].nextPhys].prevPhys = index;
+
+      destroyBlock(next);
+    }
+
+    insertFreeBlock(index);
+  }
+
+
+  uint64_t TlsfAllocator::largestFreeBlock() const {
+    if (!m_flBitmask)
+      return 0;
+
+    uint32_t fl = 63 - bit::lzcnt(m_flBitmask);
+    uint32_t sl = 31 - bit::lzcnt(m_slBitmask[fl]);
+
+    uint64_t result = 0;
+
+    for (uint32_t i = m_freeHeads[fl][sl]; i != InvalidIndex; i = m_blocks[i].nextFree)
+      result = std::max(result, m_blocks[i].size);
+
+    return result;
+  }
+
+
+  uint32_t TlsfAllocator::findFreeBlock(
+          uint64_t              size) const {
+    // Round the size up to the next size class so that
+    // any block in the selected free list is large enough
+    uint64_t granularity = SmallSize >> SlShift;
+
+    if (size >= SmallSize)
+      granularity = 1ull << (63 - bit::lzcnt(size) - SlShift);
+
+    uint32_t fl, sl;
+    mapSize(size + granularity - 1, fl, sl);
+
+    if (fl >= FlCount)
+      return InvalidIndex;
+
+    uint32_t slMask = m_slBitmask[fl] & (~0u << sl);
+
+    if (!slMask) {
+      uint64_t flMask = m_flBitmask & (~0ull << fl) & ~(1ull << fl);
+
+      if (!flMask)
+        return InvalidIndex;
+
+      fl = bit::tzcnt(flMask);
+      slMask = m_slBitmask[fl];
+    }
+
+    sl = bit::tzcnt(slMask);
+    return m_freeHeads[fl][sl];
+  }
+
+
+  uint32_t TlsfAllocator::tryAllocFromBlock(
+          uint32_t              index,
+          uint64_t              size,
+          uint64_t              alignment) {
+    if (index == InvalidIndex)
+      return InvalidIndex;
+
+    uint64_t offset = m_blocks[index].offset;
+    uint64_t padding = align(offset, alignment) - offset;
+
+    if (padding + size > m_blocks[index].size)
+      return InvalidIndex;
+
+    removeFreeBlock(index);
+
+    // Return the unused part at the start of the block to
+    // the free list. The previous block is never free.
+    if (padding) {
+      uint32_t head = index;
+      index = splitBlock(head, padding);
+      insertFreeBlock(head);
+    }
+
+    if (m_blocks[index].size > size)
+      insertFreeBlock(splitBlock(index, size));
+
+    return index;
+  }
+
+
+  uint32_t TlsfAllocator::splitBlock(
+          uint32_t              index,
+          uint64_t              size) {
+    uint32_t next = createBlock();
+
+    Block& a = m_blocks[index];
+    Block& b = m_blocks[next];
+
+    b.offset   = a.offset + size;
+    b.size     = a.size - size;
+    b.prevPhys = index;
+    b.nextPhys = a.nextPhys;
+
+    if (a.nextPhys != InvalidIndex)
+      m_blocks[a.nextPhys].prevPhys = next;
+
+    a.nextPhys = next;
+    a.size     = size;
+    return next;
+  }
+
+
+  void TlsfAllocator::insertFreeBlock(
+          uint32_t              index) {
+    Block& block = m_blocks[index];
+
+    uint32_t fl, sl;
+    mapSize(block.size, fl, sl);
+
+    uint32_t& head = m_freeHeads[fl][sl];
+
+    block.isFree   = true;
+    block.prevFree = InvalidIndex;
+    block.nextFree = head;
+
+    if (head != InvalidIndex)
+      m_blocks[head].prevFree = index;
+
+    head = index;
+
+    m_flBitmask     |= 1ull << fl;
+    m_slBitmask[fl] |= 1u << sl;
+
+    m_freeBlockCount += 1;
+  }
+
+
+  void TlsfAllocator::removeFreeBlock(
+          uint32_t              index) {
+    Block& block = m_blocks[index];
+
+    uint32_t fl, sl;
+    mapSize(block.size, fl, sl);
+
+    if (block.prevFree != InvalidIndex)
+      m_blocks[block.prevFree].nextFree = block.nextFree;
+    else
+      m_freeHeads[fl][sl] = block.nextFree;
+
+    if (block.nextFree != InvalidIndex)
+      m_blocks[block.nextFree].prevFree = block.prevFree;
+
+    if (m_freeHeads[fl][sl] == InvalidIndex) {
+      m_slBitmask[fl] &= ~(1u << sl);
+
+      if (!m_slBitmask[fl])
+        m_flBitmask &= ~(1ull << fl);
+    }
+
+    block.isFree   = false;
+    block.prevFree = InvalidIndex;
+    block.nextFree = InvalidIndex;
+
+    m_freeBlockCount -= 1;
+  }
+
+
+  uint32_t TlsfAllocator::createBlock() {
+    uint32_t index;
+
+    if (!m_unusedBlocks.empty()) {
+      index = m_unusedBlocks.back();
+      m_unusedBlocks.pop_back();
+    } else {
+      index = uint32_t(m_blocks.size());
+      m_blocks.emplace_back();
+    }
+
+    Block& block = m_blocks[index];
+    block.offset   = 0;
+    block.size     = 0;
+    block.prevPhys = InvalidIndex;
+    block.nextPhys = InvalidIndex;
+    block.prevFree = InvalidIndex;
+    block.nextFree = InvalidIndex;
+    block.isFree   = false;
+    return index;
+  }
+
+
+  void TlsfAllocator::destroyBlock(
+          uint32_t              index) {
+    m_unusedBlocks.push_back(index);
+  }
+
+
+  void TlsfAllocator::mapSize(
+          uint64_t              size,
+          uint32_t&             fl,
+          uint32_t&             sl) {
+    if (size < SmallSize) {
+      fl = 0;
+      sl = uint32_t(size >> (SmallShift - SlShift));
+    } else {
+      uint32_t msb = 63 - bit::lzcnt(size);
+      fl = msb - SmallShift + 1;
+      sl = uint32_t(size >> (msb - SlShift)) & (SlCount - 1);
+    }
+  }
+
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dxvk {
+
+  /**
+   * \brief Two-level segregated fit allocator
+   *
+   * Manages an abstract address range, for example the
+   * contents of a Vulkan memory object, without storing
+   * any metadata inside the managed range itself.
+   *
+   * Free blocks are sorted into size classes, where the
+   * first level is the power of two of the block size and
+   * the second level linearly subdivides that range. Both
+   * allocation and deallocation are O(1), and adjacent free
+   * blocks are always merged. This is not thread-safe.
+   */
+  class TlsfAllocator {
+    constexpr static uint32_t InvalidIndex = ~0u;
+
+    constexpr static uint32_t SlShift     = 4;
+    constexpr static uint32_t SlCount     = 1u << SlShift;
+    constexpr static uint32_t SmallShift  = 8;
+    constexpr static uint64_t SmallSize   = 1ull << SmallShift;
+    constexpr static uint32_t FlCount     = 64 - SmallShift + 1;
+  public:
+
+    constexpr static uint64_t InvalidOffset = ~0ull;
+
+    explicit TlsfAllocator(uint64_t size);
+
+    ~TlsfAllocator();
+
+    TlsfAllocator             (const TlsfAllocator&) = delete;
+    TlsfAllocator& operator = (const TlsfAllocator&) = delete;
+
+    /**
+     * \brief Allocates a range
+     *
+     * The size of the allocated range will be rounded
+     * up to a multiple of the alignment. Alignment must
+     * be a power of two.
+     * \param [in] size Number of bytes to allocate
+     * \param [in] alignment Required alignment
+     * \param [out] allocSize Actual allocation size
+     * \returns Offset of the allocation, or \c InvalidOffset
+     *    if no free block is large enough.
+     */
+    uint64_t alloc(
+            uint64_t              size,
+            uint64_t              alignment,
+            uint64_t&             allocSize);
+
+    /**
+     * \brief Frees a range
+     *
+     * \param [in] offset Offset of an allocation
+     *    previously returned by \c alloc.
+     */
+    void free(
+            uint64_t              offset);
+
+    /**
+     * \brief Checks whether no allocations are left
+     * \returns \c true if the entire range is free
+     */
+    bool isEmpty() const {
+      return m_freeSize == m_size;
+    }
+
+    /**
+     * \brief Queries total amount of free space
+     * \returns Number of bytes not allocated
+     */
+    uint64_t freeSize() const {
+      return m_freeSize;
+    }
+
+    /**
+     * \brief Checks whether the allocator is full
+     * \returns \c true if there are no free blocks
+     */
+    bool isFull() const {
+      return !m_flBitmask;
+    }
+
+    /**
+     * \brief Queries number of free blocks
+     *
+     * Tracked on every insertion and removal,
+     * so this does not walk the free lists.
+     * \returns Number of free blocks
+     */
+    uint32_t freeBlockCount() const {
+      return m_freeBlockCount;
+    }
+
+    /**
+     * \brief Queries size of the largest free block
+     *
+     * Only needs to look at the blocks in the largest
+     * non-empty size class, which is found using the
+     * size class bitmasks.
+     * \returns Size of the largest free block
+     */
+    uint64_t largestFreeBlock() const;
+
+  private:
+
+    struct Block {
+      uint64_t offset;
+      uint64_t size;
+      uint32_t prevPhys;
+      uint32_t nextPhys;
+      uint32_t prevFree;
+      uint32_t nextFree;
+      bool     isFree;
+    };
+
+    uint64_t m_size     = 0;
+    uint64_t m_freeSize = 0;
+    uint32_t m_freeBlockCount = 0;
+
+    uint64_t                                m_flBitmask = 0;
+    std::array<uint32_t, FlCount>           m_slBitmask = { };
+    std::array<std::array<uint32_t, SlCount>, FlCount> m_freeHeads;
+
+    std::vector<Block>                      m_blocks;
+    std::vector<uint32_t>                   m_unusedBlocks;
+
+    std::unordered_map<uint64_t, uint32_t>  m_allocations;
+
+    uint32_t findFreeBlock(
+            uint64_t              size) const;
+
+    uint32_t tryAllocFromBlock(
+            uint32_t              index,
+            uint64_t              size,
+            uint64_t              alignment);
+
+    uint32_t splitBlock(
+            uint32_t              index,
+            uint64_t              size);
+
+    void insertFreeBlock(
+            uint32_t              index);
+
+    void removeFreeBlock(
+            uint32_t              index);
+
+    uint32_t createBlock();
+
+    void destroyBlock(
+            uint32_t              index);
+
+    static void mapSize(
+            uint64_t              size,
+            uint32_t&             fl,
+            uint32_t&             sl);
+
+  };
+
+}
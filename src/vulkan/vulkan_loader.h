@@ -349,6 +349,10 @@ namespace dxvk::vk {
     VULKAN_FN(vkQueuePresentKHR);
     #endif
 
+    #ifdef VK_KHR_present_wait
+    VULKAN_FN(vkWaitForPresentKHR);
+    #endif
+
     #ifdef VK_EXT_conditional_rendering
     VULKAN_FN(vkCmdBeginConditionalRenderingEXT);
     VULKAN_FN(vkCmdEndConditionalRenderingEXT);
@@ -362,6 +366,14 @@ namespace dxvk::vk {
     VULKAN_FN(vkSetDebugUtilsObjectTagEXT);
     #endif
 
+    #ifdef VK_EXT_descriptor_buffer
+    VULKAN_FN(vkGetDescriptorSetLayoutSizeEXT);
+    VULKAN_FN(vkGetDescriptorSetLayoutBindingOffsetEXT);
+    VULKAN_FN(vkGetDescriptorEXT);
+    VULKAN_FN(vkCmdBindDescriptorBuffersEXT);
+    VULKAN_FN(vkCmdSetDescriptorBufferOffsetsEXT);
+    #endif
+
     #ifdef VK_EXT_extended_dynamic_state3
     VULKAN_FN(vkCmdSetTessellationDomainOriginEXT);
     VULKAN_FN(vkCmdSetDepthClampEnableEXT);
@@ -390,6 +402,19 @@ namespace dxvk::vk {
     VULKAN_FN(vkSetHdrMetadataEXT);
     #endif
 
+    #ifdef VK_EXT_host_image_copy
+    VULKAN_FN(vkCopyMemoryToImageEXT);
+    VULKAN_FN(vkTransitionImageLayoutEXT);
+    #endif
+
+    #ifdef VK_EXT_image_compression_control
+    VULKAN_FN(vkGetImageSubresourceLayout2EXT);
+    #endif
+
+    #ifdef VK_EXT_pageable_device_local_memory
+    VULKAN_FN(vkSetDeviceMemoryPriorityEXT);
+    #endif
+
     #ifdef VK_EXT_shader_module_identifier
     VULKAN_FN(vkGetShaderModuleCreateInfoIdentifierEXT);
     VULKAN_FN(vkGetShaderModuleIdentifierEXT);
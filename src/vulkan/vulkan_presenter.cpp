@@ -2,6 +2,8 @@
 
 #include "../dxvk/dxvk_format.h"
 
+#include "../util/util_env.h"
+
 #include "../wsi/wsi_window.h"
 
 namespace dxvk::vk {
@@ -50,9 +52,23 @@ namespace dxvk::vk {
   }
 
 
-  VkResult Presenter::presentImage() {
+  VkResult Presenter::presentImage(
+    const Rc<sync::Signal>& signal,
+          uint64_t        signalValue) {
     PresenterSync sync = m_semaphores.at(m_frameIndex);
 
+    // Only track present timings if the frame rate limiter
+    // or the caller can make use of them, since waiting is
+    // not free.
+    bool presentWait = m_device.features.presentWait
+      && (m_fpsLimiter.isEnabled() || signal != nullptr);
+
+    uint64_t presentId = m_presentId + 1;
+
+    VkPresentIdKHR presentIdInfo = { VK_STRUCTURE_TYPE_PRESENT_ID_KHR };
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds    = &presentId;
+
     VkPresentInfoKHR info = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
     info.waitSemaphoreCount = 1;
     info.pWaitSemaphores    = &sync.present;
@@ -60,10 +76,39 @@ namespace dxvk::vk {
     info.pSwapchains        = &m_swapchain;
     info.pImageIndices      = &m_imageIndex;
 
+    if (m_device.features.presentWait)
+      info.pNext = &presentIdInfo;
+
     VkResult status = m_vkd->vkQueuePresentKHR(m_device.queue, &info);
 
-    if (status != VK_SUCCESS && status != VK_SUBOPTIMAL_KHR)
+    if (status != VK_SUCCESS && status != VK_SUBOPTIMAL_KHR) {
+      // Never leave the caller waiting for a frame that will
+      // not be presented, the swap chain gets recreated anyway
+      if (signal != nullptr)
+        signal->signal(signalValue);
+
       return status;
+    }
+
+    m_presentId = presentId;
+
+    if (presentWait) {
+      std::lock_guard lock(m_frameMutex);
+
+      if (!m_frameThread.joinable())
+        m_frameThread = dxvk::thread([this] () { runFrameThread(); });
+
+      PresenterFrame frame;
+      frame.swapchain   = m_swapchain;
+      frame.presentId   = presentId;
+      frame.signal      = signal;
+      frame.signalValue = signalValue;
+
+      m_frameQueue.push(std::move(frame));
+      m_frameCond.notify_one();
+    } else if (signal != nullptr) {
+      signal->signal(signalValue);
+    }
 
     // Try to acquire next image already, in order to hide
     // potential delays from the application thread.
@@ -79,7 +124,7 @@ namespace dxvk::vk {
     bool vsync = m_info.presentMode == VK_PRESENT_MODE_FIFO_KHR
               || m_info.presentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR;
 
-    m_fpsLimiter.delay(vsync);
+    m_fpsLimiter.delay(vsync, presentId);
     return status;
   }
 
@@ -97,9 +142,27 @@ namespace dxvk::vk {
 
 
   VkResult Presenter::recreateSwapChain(const PresenterDesc& desc) {
-    if (m_swapchain)
-      destroySwapchain();
+    // Retire the current swap chain instead of destroying it up front
+    // so that it can be passed in as the old swap chain. This allows
+    // the implementation to reuse resources and keep the window
+    // contents intact until the new swap chain is in use.
+    VkSwapchainKHR oldSwapchain = retireSwapchain();
+
+    VkResult status = recreateSwapChainInternal(desc, oldSwapchain);
+
+    if (oldSwapchain)
+      m_vkd->vkDestroySwapchainKHR(m_vkd->device(), oldSwapchain, nullptr);
 
+    // The present mode may have changed
+    updateFrameRateLimit();
+
+    return status;
+  }
+
+
+  VkResult Presenter::recreateSwapChainInternal(
+    const PresenterDesc&  desc,
+          VkSwapchainKHR  oldSwapchain) {
     if (!m_surface)
       return VK_ERROR_SURFACE_LOST_KHR;
 
@@ -127,6 +190,7 @@ namespace dxvk::vk {
     m_info.presentMode  = pickPresentMode(modes.size(), modes.data(), desc.numPresentModes, desc.presentModes);
     m_info.imageExtent  = pickImageExtent(caps, desc.imageExtent);
     m_info.imageCount   = pickImageCount(caps, m_info.presentMode, desc.imageCount);
+    m_info.imageUsage   = pickImageUsage(caps, m_info.format.format, desc.imageUsage);
 
     if (!m_info.imageExtent.width || !m_info.imageExtent.height) {
       m_info.imageCount = 0;
@@ -144,14 +208,13 @@ namespace dxvk::vk {
     swapInfo.imageColorSpace        = m_info.format.colorSpace;
     swapInfo.imageExtent            = m_info.imageExtent;
     swapInfo.imageArrayLayers       = 1;
-    swapInfo.imageUsage             = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
-                                    | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    swapInfo.imageUsage             = m_info.imageUsage;
     swapInfo.imageSharingMode       = VK_SHARING_MODE_EXCLUSIVE;
     swapInfo.preTransform           = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
     swapInfo.compositeAlpha         = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     swapInfo.presentMode            = m_info.presentMode;
     swapInfo.clipped                = VK_TRUE;
-    swapInfo.oldSwapchain           = VK_NULL_HANDLE;
+    swapInfo.oldSwapchain           = oldSwapchain;
 
     if (m_device.features.fullScreenExclusive)
       swapInfo.pNext = &fullScreenInfo;
@@ -235,7 +298,17 @@ namespace dxvk::vk {
 
 
   void Presenter::setFrameRateLimit(double frameRate) {
-    m_fpsLimiter.setTargetFrameRate(frameRate);
+    m_frameRateLimit = frameRate;
+    updateFrameRateLimit();
+  }
+
+
+  void Presenter::setDisplayRefreshRate(
+          double          refreshRate,
+          bool            variableRefresh) {
+    m_refreshRate = refreshRate;
+    m_variableRefresh = variableRefresh;
+    updateFrameRateLimit();
   }
 
 
@@ -245,6 +318,27 @@ namespace dxvk::vk {
   }
 
 
+  void Presenter::updateFrameRateLimit() {
+    double frameRate = m_frameRateLimit;
+
+    bool vsync = m_info.presentMode == VK_PRESENT_MODE_FIFO_KHR
+              || m_info.presentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+
+    if (frameRate == 0.0 && m_refreshRate > 0.0 && vsync) {
+      // With variable refresh, stay slightly below the maximum refresh
+      // rate so that frames never have to wait for vblank. Otherwise,
+      // release frames in time for the next vblank, which relies on
+      // present timings since the display clock drifts from ours.
+      if (m_variableRefresh)
+        frameRate = m_refreshRate * 0.97;
+      else if (m_device.features.presentWait)
+        frameRate = m_refreshRate;
+    }
+
+    m_fpsLimiter.setTargetFrameRate(frameRate);
+  }
+
+
   VkResult Presenter::getSupportedFormats(std::vector<VkSurfaceFormatKHR>& formats, VkFullScreenExclusiveEXT fullScreenExclusive) const {
     uint32_t numFormats = 0;
 
@@ -428,7 +522,40 @@ namespace dxvk::vk {
   }
 
 
+  VkImageUsageFlags Presenter::pickImageUsage(
+    const VkSurfaceCapabilitiesKHR& caps,
+          VkFormat                  format,
+          VkImageUsageFlags         desired) {
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+                            | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    // Optional usage flags are only enabled if both the surface
+    // and the format support them. Most notably, sRGB formats
+    // usually do not support storage image usage.
+    desired &= caps.supportedUsageFlags;
+
+    if (desired & VK_IMAGE_USAGE_STORAGE_BIT) {
+      VkFormatProperties formatProps = { };
+      m_vki->vkGetPhysicalDeviceFormatProperties(m_device.adapter, format, &formatProps);
+
+      if (formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)
+        usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+
+    return usage;
+  }
+
+
   void Presenter::destroySwapchain() {
+    VkSwapchainKHR swapchain = retireSwapchain();
+    m_vkd->vkDestroySwapchainKHR(m_vkd->device(), swapchain, nullptr);
+  }
+
+
+  VkSwapchainKHR Presenter::retireSwapchain() {
+    // The frame thread may still be waiting on the swap chain
+    stopFrameThread();
+
     for (const auto& img : m_images)
       m_vkd->vkDestroyImageView(m_vkd->device(), img.view, nullptr);
     
@@ -437,12 +564,62 @@ namespace dxvk::vk {
       m_vkd->vkDestroySemaphore(m_vkd->device(), sem.present, nullptr);
     }
 
-    m_vkd->vkDestroySwapchainKHR(m_vkd->device(), m_swapchain, nullptr);
-
     m_images.clear();
     m_semaphores.clear();
 
+    VkSwapchainKHR swapchain = m_swapchain;
     m_swapchain = VK_NULL_HANDLE;
+    return swapchain;
+  }
+
+
+  void Presenter::stopFrameThread() {
+    { std::lock_guard lock(m_frameMutex);
+
+      if (!m_frameThread.joinable())
+        return;
+
+      m_frameQueue.push(PresenterFrame());
+      m_frameCond.notify_one();
+    }
+
+    m_frameThread.join();
+  }
+
+
+  void Presenter::runFrameThread() {
+    env::setThreadName("dxvk-frame");
+
+    while (true) {
+      PresenterFrame frame;
+
+      { std::unique_lock lock(m_frameMutex);
+
+        m_frameCond.wait(lock, [this] {
+          return !m_frameQueue.empty();
+        });
+
+        frame = std::move(m_frameQueue.front());
+        m_frameQueue.pop();
+      }
+
+      if (!frame.swapchain)
+        break;
+
+      // Use a timeout so that a present that never completes, e.g.
+      // because the window got minimized, cannot block swap chain
+      // destruction indefinitely. Just skip the frame in that case.
+      VkResult vr = m_vkd->vkWaitForPresentKHR(m_vkd->device(),
+        frame.swapchain, frame.presentId, 100'000'000ull);
+
+      if (vr == VK_SUCCESS)
+        m_fpsLimiter.notifyPresent(frame.presentId, high_resolution_clock::now());
+
+      // Signal even if the wait failed or timed out so
+      // that the application does not deadlock
+      if (frame.signal != nullptr)
+        frame.signal->signal(frame.signalValue);
+    }
   }
 
 
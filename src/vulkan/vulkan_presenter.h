@@ -1,10 +1,15 @@
 #pragma once
 
 #include <functional>
+#include <queue>
 #include <vector>
 
 #include "../util/log/log.h"
 
+#include "../util/thread.h"
+
+#include "../util/sync/sync_signal.h"
+
 #include "../util/util_error.h"
 #include "../util/util_fps_limiter.h"
 #include "../util/util_math.h"
@@ -29,6 +34,7 @@ namespace dxvk::vk {
     uint32_t            numPresentModes;
     VkPresentModeKHR    presentModes[4];
     VkFullScreenExclusiveEXT fullScreenExclusive;
+    VkImageUsageFlags   imageUsage;
   };
 
   /**
@@ -42,6 +48,7 @@ namespace dxvk::vk {
     VkPresentModeKHR    presentMode;
     VkExtent2D          imageExtent;
     uint32_t            imageCount;
+    VkImageUsageFlags   imageUsage;
   };
 
   /**
@@ -50,6 +57,7 @@ namespace dxvk::vk {
   struct PresenterFeatures {
     bool                fullScreenExclusive : 1;
     bool                hdrMetadata : 1;
+    bool                presentWait : 1;
   };
   
   /**
@@ -70,6 +78,16 @@ namespace dxvk::vk {
     VkImageView view  = VK_NULL_HANDLE;
   };
 
+  /**
+   * \brief Frame waiting for present completion
+   */
+  struct PresenterFrame {
+    VkSwapchainKHR    swapchain   = VK_NULL_HANDLE;
+    uint64_t          presentId   = 0;
+    Rc<sync::Signal>  signal;
+    uint64_t          signalValue = 0;
+  };
+
   /**
    * \brief Presenter semaphores
    * 
@@ -139,9 +157,29 @@ namespace dxvk::vk {
      * Presents the current image. If this returns
      * an error, the swap chain must be recreated,
      * but do not present before acquiring an image.
+     *
+     * If a signal is given and present wait is supported,
+     * it will be signaled once the image has actually been
+     * presented. Otherwise, it is signaled immediately.
+     * \param [in] signal Optional signal
+     * \param [in] signalValue Value to signal
      * \returns Status of the operation
      */
-    VkResult presentImage();
+    VkResult presentImage(
+      const Rc<sync::Signal>& signal = nullptr,
+            uint64_t        signalValue = 0);
+
+    /**
+     * \brief Checks whether present wait is supported
+     *
+     * If this returns \c true, signals passed to
+     * \ref presentImage will be signaled on present
+     * completion rather than on submission.
+     * \returns \c true if present wait is enabled
+     */
+    bool supportsPresentWait() const {
+      return m_device.features.presentWait;
+    }
 
     /**
      * \brief Changes and takes ownership of surface
@@ -172,6 +210,20 @@ namespace dxvk::vk {
      */
     void setFrameRateLimit(double frameRate);
 
+    /**
+     * \brief Sets display refresh rate
+     *
+     * If no frame rate limit is set and vsync is enabled,
+     * frames are paced to the refresh rate so that they do
+     * not queue up behind vblank. On displays without
+     * variable refresh, this requires present timings.
+     * \param [in] refreshRate Refresh rate, or 0 if unknown
+     * \param [in] variableRefresh Whether the display supports VRR
+     */
+    void setDisplayRefreshRate(
+            double          refreshRate,
+            bool            variableRefresh);
+
     /**
      * \brief Checks whether a Vulkan swap chain exists
      *
@@ -205,7 +257,7 @@ namespace dxvk::vk {
     Rc<DeviceFn>      m_vkd;
 
     PresenterDevice   m_device;
-    PresenterInfo     m_info;
+    PresenterInfo     m_info = { };
 
     VkSurfaceKHR      m_surface     = VK_NULL_HANDLE;
     VkSwapchainKHR    m_swapchain   = VK_NULL_HANDLE;
@@ -220,8 +272,22 @@ namespace dxvk::vk {
 
     FpsLimiter m_fpsLimiter;
 
+    double m_frameRateLimit  = 0.0;
+    double m_refreshRate     = 0.0;
+    bool   m_variableRefresh = false;
+
+    uint64_t m_presentId = 0;
+
+    dxvk::mutex               m_frameMutex;
+    dxvk::condition_variable  m_frameCond;
+    dxvk::thread              m_frameThread;
+    std::queue<PresenterFrame> m_frameQueue;
+
     VkResult recreateSwapChainInternal(
-      const PresenterDesc&  desc);
+      const PresenterDesc&  desc,
+            VkSwapchainKHR  oldSwapchain);
+
+    void updateFrameRateLimit();
 
     VkResult getSupportedFormats(
             std::vector<VkSurfaceFormatKHR>& formats,
@@ -255,10 +321,21 @@ namespace dxvk::vk {
             VkPresentModeKHR          presentMode,
             uint32_t                  desired);
 
+    VkImageUsageFlags pickImageUsage(
+      const VkSurfaceCapabilitiesKHR& caps,
+            VkFormat                  format,
+            VkImageUsageFlags         desired);
+
     VkResult createSurface();
 
     void destroySwapchain();
 
+    VkSwapchainKHR retireSwapchain();
+
+    void stopFrameThread();
+
+    void runFrameThread();
+
     void destroySurface();
 
   };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <utility>
 
 #include "vulkan_loader.h"
@@ -88,6 +89,23 @@ namespace dxvk::vk {
         && a.baseArrayLayer + a.layerCount >= b.baseArrayLayer + b.layerCount;
   }
 
+  inline VkImageSubresourceRange unionSubresourceRange(
+    const VkImageSubresourceRange&  a,
+    const VkImageSubresourceRange&  b) {
+    uint32_t minLevel = std::min(a.baseMipLevel, b.baseMipLevel);
+    uint32_t maxLevel = std::max(a.baseMipLevel + a.levelCount, b.baseMipLevel + b.levelCount);
+    uint32_t minLayer = std::min(a.baseArrayLayer, b.baseArrayLayer);
+    uint32_t maxLayer = std::max(a.baseArrayLayer + a.layerCount, b.baseArrayLayer + b.layerCount);
+
+    VkImageSubresourceRange result;
+    result.aspectMask     = a.aspectMask | b.aspectMask;
+    result.baseMipLevel   = minLevel;
+    result.levelCount     = maxLevel - minLevel;
+    result.baseArrayLayer = minLayer;
+    result.layerCount     = maxLayer - minLayer;
+    return result;
+  }
+
   inline VkImageAspectFlags getWritableAspectsForLayout(VkImageLayout layout) {
     switch (layout) {
       case VK_IMAGE_LAYOUT_ATTACHMENT_FEEDBACK_LOOP_OPTIMAL_EXT:
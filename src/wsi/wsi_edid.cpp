@@ -68,4 +68,37 @@ namespace dxvk::wsi {
     return metadata;
   }
 
+
+  std::optional<WsiRefreshRateRange> parseVariableRefreshRange(
+    const WsiEdidData&        edidData) {
+    di_info* info = di_info_parse_edid(edidData.data(), edidData.size());
+
+    if (!info) {
+      Logger::err(str::format("wsi: parseVariableRefreshRange: Failed to get parse edid."));
+      return std::nullopt;
+    }
+
+    const di_edid* edid = di_info_get_edid(info);
+
+    std::optional<WsiRefreshRateRange> result;
+
+    for (auto descs = di_edid_get_display_descriptors(edid); *descs != nullptr; descs++) {
+      const di_edid_display_range_limits* limits = di_edid_display_descriptor_get_range_limits(*descs);
+
+      if (!limits || limits->type != DI_EDID_DISPLAY_RANGE_LIMITS_BARE)
+        continue;
+
+      if (limits->max_vert_rate_hz - limits->min_vert_rate_hz > 10) {
+        result = WsiRefreshRateRange {
+          uint32_t(limits->min_vert_rate_hz),
+          uint32_t(limits->max_vert_rate_hz) };
+      }
+
+      break;
+    }
+
+    di_info_destroy(info);
+    return result;
+  }
+
 }
\ No newline at end of file
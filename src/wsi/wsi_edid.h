@@ -26,6 +26,14 @@ namespace dxvk::wsi {
     float maxFullFrameLuminance;
   };
 
+  /**
+   * \brief Display refresh rate range
+   */
+  struct WsiRefreshRateRange {
+    uint32_t minRefreshRate;
+    uint32_t maxRefreshRate;
+  };
+
   /**
     * \brief Parse colorimetry info from the EDID
     *
@@ -35,4 +43,17 @@ namespace dxvk::wsi {
   std::optional<WsiDisplayMetadata> parseColorimetryInfo(
     const WsiEdidData&        edidData);
 
+  /**
+    * \brief Parse variable refresh rate range from the EDID
+    *
+    * Follows the heuristic used by Linux display drivers:
+    * a display range limits descriptor which only lists
+    * the supported range and spans more than 10 Hz means
+    * that the display supports adaptive sync.
+    * \param [in] edidData The edid blob
+    * \returns The refresh rate range if the display is VRR-capable
+    */
+  std::optional<WsiRefreshRateRange> parseVariableRefreshRange(
+    const WsiEdidData&        edidData);
+
 }
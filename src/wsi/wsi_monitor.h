@@ -2,6 +2,7 @@
 
 #include <windows.h>
 
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <cstdint>
@@ -149,4 +150,47 @@ namespace dxvk::wsi {
     */
   WsiEdidData getMonitorEdid(HMONITOR hMonitor);
 
+  /**
+   * \brief Monitor refresh info
+   */
+  struct WsiRefreshInfo {
+    double refreshRate;
+    bool   variableRefresh;
+  };
+
+  /**
+    * \brief Get the refresh rate of a monitor
+    *
+    * Helper function to query the refresh rate of the current
+    * display mode, and whether the display supports variable
+    * refresh rates, which requires the EDID to be available.
+    * \param [in] hMonitor The monitor
+    * \param [out] pInfo Refresh rate info
+    * \returns \c true on success
+    */
+  inline bool getMonitorRefreshInfo(
+          HMONITOR                hMonitor,
+          WsiRefreshInfo*         pInfo) {
+    WsiMode mode = { };
+
+    if (!getCurrentDisplayMode(hMonitor, &mode) || !mode.refreshRate.denominator)
+      return false;
+
+    pInfo->refreshRate = double(mode.refreshRate.numerator) / double(mode.refreshRate.denominator);
+    pInfo->variableRefresh = false;
+
+    WsiEdidData edid = getMonitorEdid(hMonitor);
+
+    if (!edid.empty()) {
+      auto range = parseVariableRefreshRange(edid);
+
+      if (range) {
+        pInfo->refreshRate = std::min(pInfo->refreshRate, double(range->maxRefreshRate));
+        pInfo->variableRefresh = true;
+      }
+    }
+
+    return true;
+  }
+
 }
@@ -0,0 +1,638 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <d3d9.h>
+#include <d3d11.h>
+
+#if defined(DXVK_WSI_SDL2)
+#include <SDL2/SDL.h>
+#elif defined(DXVK_WSI_GLFW)
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#endif
+
+#include "../../src/util/com/com_pointer.h"
+
+#include "../../src/util/util_time.h"
+
+namespace dxvk {
+
+  /**
+   * \brief State changes between draws
+   */
+  enum class DrawBenchChurn : uint32_t {
+    None      = 0,  ///< Same state for every draw
+    Constants = 1,  ///< Constant data update per draw
+    State     = 2,  ///< Pipeline state change per draw
+  };
+
+  static const char* getChurnName(DrawBenchChurn churn) {
+    switch (churn) {
+      case DrawBenchChurn::None:      return "none";
+      case DrawBenchChurn::Constants: return "constants";
+      case DrawBenchChurn::State:     return "state";
+    }
+
+    return "unknown";
+  }
+
+
+  /**
+   * \brief Draw benchmark results
+   *
+   * All times are averaged per draw. The API time is spent on
+   * the calling thread, while the backend time covers the time
+   * it takes for the CS thread to process and submit the draws
+   * after the application stopped recording them. The render
+   * target is tiny, so GPU time is negligible.
+   */
+  struct DrawBenchStats {
+    double    apiNsMin      = 0.0;
+    double    apiNsAvg      = 0.0;
+    double    backendNsMin  = 0.0;
+    double    backendNsAvg  = 0.0;
+  };
+
+
+  /**
+   * \brief Builds a minimal DXBC container
+   *
+   * DXVK does not validate the checksum, so it is left zeroed.
+   * Signature elements only declare one float4 register each.
+   */
+  class DxbcBuilder {
+
+  public:
+
+    void addSignature(const char* tag, const char* name, uint32_t systemValue) {
+      std::vector<uint32_t> data;
+
+      if (name) {
+        // Element count, element offset, one element,
+        // followed by the semantic name string
+        data = { 1u, 8u, 32u, 0u, systemValue, 3u, 0u, 0xf0fu };
+
+        size_t offset = data.size();
+        size_t length = std::strlen(name) + 1;
+
+        data.resize(offset + (length + 3) / 4);
+        std::memcpy(&data[offset], name, length);
+      } else {
+        data = { 0u, 8u };
+      }
+
+      addChunk(tag, data);
+    }
+
+    void addCode(const std::vector<uint32_t>& code) {
+      addChunk("SHDR", code);
+    }
+
+    std::vector<uint32_t> build() const {
+      uint32_t headerSize = 8 + m_chunks.size();
+      uint32_t totalSize = headerSize;
+
+      for (const auto& chunk : m_chunks)
+        totalSize += chunk.size();
+
+      std::vector<uint32_t> result(headerSize);
+      std::memcpy(&result[0], "DXBC", 4);
+      result[5] = 1u;
+      result[6] = totalSize * sizeof(uint32_t);
+      result[7] = m_chunks.size();
+
+      for (const auto& chunk : m_chunks) {
+        result[8 + (&chunk - m_chunks.data())] = result.size() * sizeof(uint32_t);
+        result.insert(result.end(), chunk.begin(), chunk.end());
+      }
+
+      return result;
+    }
+
+  private:
+
+    std::vector<std::vector<uint32_t>> m_chunks;
+
+    void addChunk(const char* tag, const std::vector<uint32_t>& data) {
+      std::vector<uint32_t> chunk(2);
+      std::memcpy(&chunk[0], tag, 4);
+      chunk[1] = data.size() * sizeof(uint32_t);
+      chunk.insert(chunk.end(), data.begin(), data.end());
+      m_chunks.push_back(std::move(chunk));
+    }
+
+  };
+
+
+  /**
+   * \brief D3D11 draw benchmark
+   *
+   * Renders a single triangle with DrawIndexed into a small
+   * off-screen render target, so no window is needed.
+   */
+  class D3D11DrawBench {
+    // vs_4_0: add o0, v0, cb0[0]
+    static std::vector<uint32_t> getVsCode() {
+      return { 0x00010040u, 22u,
+        0x04000059u, 0x00208e46u, 0u, 1u,
+        0x0300005fu, 0x001010f2u, 0u,
+        0x04000067u, 0x001020f2u, 0u, 1u,
+        0x08000000u, 0x001020f2u, 0u, 0x00101e46u, 0u, 0x00208e46u, 0u, 0u,
+        0x0100003eu };
+    }
+
+    // ps_4_0: mov o0, l(1.0, 1.0, 1.0, 1.0)
+    static std::vector<uint32_t> getPsCode() {
+      return { 0x00000040u, 14u,
+        0x03000065u, 0x001020f2u, 0u,
+        0x08000036u, 0x001020f2u, 0u, 0x00004002u,
+        0x3f800000u, 0x3f800000u, 0x3f800000u, 0x3f800000u,
+        0x0100003eu };
+    }
+  public:
+
+    bool init() {
+      if (FAILED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr,
+          0, nullptr, 0, D3D11_SDK_VERSION, &m_device, nullptr, &m_context))) {
+        std::cerr << "Failed to create D3D11 device" << std::endl;
+        return false;
+      }
+
+      DxbcBuilder vs;
+      vs.addSignature("ISGN", "POSITION", 0u);
+      vs.addSignature("OSGN", "SV_POSITION", 1u);
+      vs.addCode(getVsCode());
+
+      DxbcBuilder ps;
+      ps.addSignature("ISGN", nullptr, 0u);
+      ps.addSignature("OSGN", "SV_TARGET", 0u);
+      ps.addCode(getPsCode());
+
+      std::vector<uint32_t> vsCode = vs.build();
+      std::vector<uint32_t> psCode = ps.build();
+
+      D3D11_INPUT_ELEMENT_DESC ilElement = {
+        "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+
+      D3D11_TEXTURE2D_DESC rtDesc = { };
+      rtDesc.Width            = 64;
+      rtDesc.Height           = 64;
+      rtDesc.MipLevels        = 1;
+      rtDesc.ArraySize        = 1;
+      rtDesc.Format           = DXGI_FORMAT_R8G8B8A8_UNORM;
+      rtDesc.SampleDesc.Count = 1;
+      rtDesc.Usage            = D3D11_USAGE_DEFAULT;
+      rtDesc.BindFlags        = D3D11_BIND_RENDER_TARGET;
+
+      const float vertices[] = {
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         0.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+      };
+
+      const uint16_t indices[] = { 0, 1, 2 };
+
+      D3D11_BUFFER_DESC vbDesc = { sizeof(vertices), D3D11_USAGE_IMMUTABLE, D3D11_BIND_VERTEX_BUFFER };
+      D3D11_BUFFER_DESC ibDesc = { sizeof(indices),  D3D11_USAGE_IMMUTABLE, D3D11_BIND_INDEX_BUFFER };
+      D3D11_BUFFER_DESC cbDesc = { 16, D3D11_USAGE_DYNAMIC, D3D11_BIND_CONSTANT_BUFFER, D3D11_CPU_ACCESS_WRITE };
+
+      D3D11_SUBRESOURCE_DATA vbData = { vertices };
+      D3D11_SUBRESOURCE_DATA ibData = { indices };
+
+      D3D11_QUERY_DESC queryDesc = { D3D11_QUERY_EVENT };
+
+      if (FAILED(m_device->CreateVertexShader(vsCode.data(), vsCode.size() * sizeof(uint32_t), nullptr, &m_vs))
+       || FAILED(m_device->CreatePixelShader(psCode.data(), psCode.size() * sizeof(uint32_t), nullptr, &m_ps))
+       || FAILED(m_device->CreateInputLayout(&ilElement, 1, vsCode.data(), vsCode.size() * sizeof(uint32_t), &m_layout))
+       || FAILED(m_device->CreateTexture2D(&rtDesc, nullptr, &m_rt))
+       || FAILED(m_device->CreateRenderTargetView(m_rt.ptr(), nullptr, &m_rtv))
+       || FAILED(m_device->CreateBuffer(&vbDesc, &vbData, &m_vb))
+       || FAILED(m_device->CreateBuffer(&ibDesc, &ibData, &m_ib))
+       || FAILED(m_device->CreateBuffer(&cbDesc, nullptr, &m_cb))
+       || FAILED(m_device->CreateQuery(&queryDesc, &m_query))) {
+        std::cerr << "Failed to create D3D11 resources" << std::endl;
+        return false;
+      }
+
+      for (uint32_t i = 0; i < 2; i++) {
+        D3D11_BLEND_DESC blendDesc = { };
+        blendDesc.RenderTarget[0].BlendEnable           = i;
+        blendDesc.RenderTarget[0].SrcBlend              = D3D11_BLEND_SRC_ALPHA;
+        blendDesc.RenderTarget[0].DestBlend             = D3D11_BLEND_INV_SRC_ALPHA;
+        blendDesc.RenderTarget[0].BlendOp               = D3D11_BLEND_OP_ADD;
+        blendDesc.RenderTarget[0].SrcBlendAlpha         = D3D11_BLEND_ONE;
+        blendDesc.RenderTarget[0].DestBlendAlpha        = D3D11_BLEND_ZERO;
+        blendDesc.RenderTarget[0].BlendOpAlpha          = D3D11_BLEND_OP_ADD;
+        blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+        D3D11_RASTERIZER_DESC rsDesc = { };
+        rsDesc.FillMode         = D3D11_FILL_SOLID;
+        rsDesc.CullMode         = i ? D3D11_CULL_BACK : D3D11_CULL_NONE;
+        rsDesc.DepthClipEnable  = TRUE;
+
+        if (FAILED(m_device->CreateBlendState(&blendDesc, &m_blendStates[i]))
+         || FAILED(m_device->CreateRasterizerState(&rsDesc, &m_rsStates[i]))) {
+          std::cerr << "Failed to create D3D11 state objects" << std::endl;
+          return false;
+        }
+      }
+
+      UINT stride = 4 * sizeof(float);
+      UINT offset = 0;
+
+      D3D11_VIEWPORT viewport = { 0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f };
+
+      m_context->IASetInputLayout(m_layout.ptr());
+      m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+      m_context->IASetVertexBuffers(0, 1, &m_vb, &stride, &offset);
+      m_context->IASetIndexBuffer(m_ib.ptr(), DXGI_FORMAT_R16_UINT, 0);
+      m_context->VSSetShader(m_vs.ptr(), nullptr, 0);
+      m_context->VSSetConstantBuffers(0, 1, &m_cb);
+      m_context->PSSetShader(m_ps.ptr(), nullptr, 0);
+      m_context->RSSetViewports(1, &viewport);
+      m_context->OMSetRenderTargets(1, &m_rtv, nullptr);
+      return true;
+    }
+
+    void draw(DrawBenchChurn churn, uint32_t count) {
+      for (uint32_t i = 0; i < count; i++) {
+        if (churn == DrawBenchChurn::Constants) {
+          D3D11_MAPPED_SUBRESOURCE sr;
+
+          if (SUCCEEDED(m_context->Map(m_cb.ptr(), 0, D3D11_MAP_WRITE_DISCARD, 0, &sr))) {
+            float data[4] = { float(i & 1) * 0.01f, 0.0f, 0.0f, 0.0f };
+            std::memcpy(sr.pData, data, sizeof(data));
+            m_context->Unmap(m_cb.ptr(), 0);
+          }
+        } else if (churn == DrawBenchChurn::State) {
+          m_context->OMSetBlendState(m_blendStates[i & 1].ptr(), nullptr, ~0u);
+          m_context->RSSetState(m_rsStates[i & 1].ptr());
+        }
+
+        m_context->DrawIndexed(3, 0, 0);
+      }
+    }
+
+    void finish() {
+      m_context->End(m_query.ptr());
+      m_context->Flush();
+
+      BOOL done = FALSE;
+
+      while (m_context->GetData(m_query.ptr(), &done, sizeof(done), 0) != S_OK)
+        continue;
+    }
+
+  private:
+
+    Com<ID3D11Device>             m_device;
+    Com<ID3D11DeviceContext>      m_context;
+
+    Com<ID3D11VertexShader>       m_vs;
+    Com<ID3D11PixelShader>        m_ps;
+    Com<ID3D11InputLayout>        m_layout;
+    Com<ID3D11Texture2D>          m_rt;
+    Com<ID3D11RenderTargetView>   m_rtv;
+    Com<ID3D11Buffer>             m_vb;
+    Com<ID3D11Buffer>             m_ib;
+    Com<ID3D11Buffer>             m_cb;
+    Com<ID3D11Query>              m_query;
+
+    Com<ID3D11BlendState>         m_blendStates[2];
+    Com<ID3D11RasterizerState>    m_rsStates[2];
+
+  };
+
+
+  /**
+   * \brief D3D9 draw benchmark
+   *
+   * Renders a single triangle with DrawIndexedPrimitive into
+   * the back buffer of a small hidden window, since D3D9 devices
+   * always need one.
+   */
+  class D3D9DrawBench {
+    // vs_2_0: dcl_position v0; add oPos, v0, c0
+    static constexpr DWORD VsCode[] = {
+      0xfffe0200u,
+      0x0200001fu, 0x80000000u, 0x900f0000u,
+      0x03000002u, 0xc00f0000u, 0x90e40000u, 0xa0e40000u,
+      0x0000ffffu,
+    };
+
+    // ps_2_0: def c0, 1, 1, 1, 1; mov oC0, c0
+    static constexpr DWORD PsCode[] = {
+      0xffff0200u,
+      0x05000051u, 0xa00f0000u, 0x3f800000u, 0x3f800000u, 0x3f800000u, 0x3f800000u,
+      0x02000001u, 0x800f0800u, 0xa0e40000u,
+      0x0000ffffu,
+    };
+  public:
+
+    ~D3D9DrawBench() {
+      m_query = nullptr;
+      m_decl = nullptr;
+      m_vs = nullptr;
+      m_ps = nullptr;
+      m_vb = nullptr;
+      m_ib = nullptr;
+      m_device = nullptr;
+      m_d3d9 = nullptr;
+
+      destroyWindow();
+    }
+
+    bool init() {
+      if (!createWindow()) {
+        std::cerr << "Failed to create window" << std::endl;
+        return false;
+      }
+
+      m_d3d9 = Direct3DCreate9(D3D_SDK_VERSION);
+
+      if (m_d3d9 == nullptr) {
+        std::cerr << "Failed to create D3D9 interface" << std::endl;
+        return false;
+      }
+
+      D3DPRESENT_PARAMETERS pp = { };
+      pp.BackBufferWidth      = 64;
+      pp.BackBufferHeight     = 64;
+      pp.BackBufferFormat     = D3DFMT_X8R8G8B8;
+      pp.BackBufferCount      = 1;
+      pp.SwapEffect           = D3DSWAPEFFECT_DISCARD;
+      pp.hDeviceWindow        = m_window;
+      pp.Windowed             = TRUE;
+      pp.PresentationInterval = D3DPRESENT_INTERVAL_IMMEDIATE;
+
+      if (FAILED(m_d3d9->CreateDevice(D3DADAPTER_DEFAULT, D3DDEVTYPE_HAL, m_window,
+          D3DCREATE_HARDWARE_VERTEXPROCESSING, &pp, &m_device))) {
+        std::cerr << "Failed to create D3D9 device" << std::endl;
+        return false;
+      }
+
+      const float vertices[] = {
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         0.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+      };
+
+      const uint16_t indices[] = { 0, 1, 2 };
+
+      const D3DVERTEXELEMENT9 elements[] = {
+        { 0, 0, D3DDECLTYPE_FLOAT4, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0 },
+        D3DDECL_END(),
+      };
+
+      if (FAILED(m_device->CreateVertexShader(VsCode, &m_vs))
+       || FAILED(m_device->CreatePixelShader(PsCode, &m_ps))
+       || FAILED(m_device->CreateVertexDeclaration(elements, &m_decl))
+       || FAILED(m_device->CreateVertexBuffer(sizeof(vertices), D3DUSAGE_WRITEONLY, 0, D3DPOOL_DEFAULT, &m_vb, nullptr))
+       || FAILED(m_device->CreateIndexBuffer(sizeof(indices), D3DUSAGE_WRITEONLY, D3DFMT_INDEX16, D3DPOOL_DEFAULT, &m_ib, nullptr))
+       || FAILED(m_device->CreateQuery(D3DQUERYTYPE_EVENT, &m_query))) {
+        std::cerr << "Failed to create D3D9 resources" << std::endl;
+        return false;
+      }
+
+      void* data = nullptr;
+
+      if (FAILED(m_vb->Lock(0, 0, &data, 0)))
+        return false;
+
+      std::memcpy(data, vertices, sizeof(vertices));
+      m_vb->Unlock();
+
+      if (FAILED(m_ib->Lock(0, 0, &data, 0)))
+        return false;
+
+      std::memcpy(data, indices, sizeof(indices));
+      m_ib->Unlock();
+
+      const float constants[4] = { };
+
+      m_device->SetVertexShader(m_vs.ptr());
+      m_device->SetPixelShader(m_ps.ptr());
+      m_device->SetVertexDeclaration(m_decl.ptr());
+      m_device->SetVertexShaderConstantF(0, constants, 1);
+      m_device->SetStreamSource(0, m_vb.ptr(), 0, 4 * sizeof(float));
+      m_device->SetIndices(m_ib.ptr());
+      m_device->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+      m_device->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+      m_device->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+      return true;
+    }
+
+    void draw(DrawBenchChurn churn, uint32_t count) {
+      m_device->BeginScene();
+
+      for (uint32_t i = 0; i < count; i++) {
+        if (churn == DrawBenchChurn::Constants) {
+          float data[4] = { float(i & 1) * 0.01f, 0.0f, 0.0f, 0.0f };
+          m_device->SetVertexShaderConstantF(0, data, 1);
+        } else if (churn == DrawBenchChurn::State) {
+          m_device->SetRenderState(D3DRS_ALPHABLENDENABLE, i & 1);
+          m_device->SetRenderState(D3DRS_CULLMODE, (i & 1) ? D3DCULL_CCW : D3DCULL_NONE);
+        }
+
+        m_device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, 3, 0, 1);
+      }
+
+      m_device->EndScene();
+    }
+
+    void finish() {
+      m_query->Issue(D3DISSUE_END);
+
+      while (m_query->GetData(nullptr, 0, D3DGETDATA_FLUSH) != S_OK)
+        continue;
+    }
+
+  private:
+
+    HWND                                m_window = nullptr;
+
+    Com<IDirect3D9>                     m_d3d9;
+    Com<IDirect3DDevice9>               m_device;
+
+    Com<IDirect3DVertexShader9>         m_vs;
+    Com<IDirect3DPixelShader9>          m_ps;
+    Com<IDirect3DVertexDeclaration9>    m_decl;
+    Com<IDirect3DVertexBuffer9>         m_vb;
+    Com<IDirect3DIndexBuffer9>          m_ib;
+    Com<IDirect3DQuery9>                m_query;
+
+    bool createWindow() {
+#if defined(DXVK_WSI_WIN32)
+      m_window = ::CreateWindowExW(0, L"STATIC", L"dxvk-draw-bench",
+        WS_OVERLAPPEDWINDOW, 0, 0, 64, 64, nullptr, nullptr,
+        ::GetModuleHandleW(nullptr), nullptr);
+#elif defined(DXVK_WSI_SDL2)
+      if (SDL_Init(SDL_INIT_VIDEO))
+        return false;
+
+      m_window = reinterpret_cast<HWND>(SDL_CreateWindow("dxvk-draw-bench",
+        SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64,
+        SDL_WINDOW_VULKAN | SDL_WINDOW_HIDDEN));
+#elif defined(DXVK_WSI_GLFW)
+      if (!glfwInit())
+        return false;
+
+      glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+      glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+      m_window = reinterpret_cast<HWND>(glfwCreateWindow(
+        64, 64, "dxvk-draw-bench", nullptr, nullptr));
+#endif
+      return m_window != nullptr;
+    }
+
+    void destroyWindow() {
+      if (!m_window)
+        return;
+
+#if defined(DXVK_WSI_WIN32)
+      ::DestroyWindow(m_window);
+#elif defined(DXVK_WSI_SDL2)
+      SDL_DestroyWindow(reinterpret_cast<SDL_Window*>(m_window));
+      SDL_Quit();
+#elif defined(DXVK_WSI_GLFW)
+      glfwDestroyWindow(reinterpret_cast<GLFWwindow*>(m_window));
+      glfwTerminate();
+#endif
+    }
+
+  };
+
+
+  /**
+   * \brief Runs one benchmark configuration
+   *
+   * Runs one warm-up iteration so that pipelines are compiled
+   * and resources are allocated, then measures the remaining
+   * iterations individually.
+   */
+  template<typename Bench>
+  static DrawBenchStats runBench(
+          Bench&                  bench,
+          DrawBenchChurn          churn,
+          uint32_t                draws,
+          uint32_t                iterations) {
+    DrawBenchStats stats;
+    stats.apiNsMin     = 1e30;
+    stats.backendNsMin = 1e30;
+
+    bench.draw(churn, draws);
+    bench.finish();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+      auto t0 = high_resolution_clock::now();
+      bench.draw(churn, draws);
+      auto t1 = high_resolution_clock::now();
+      bench.finish();
+      auto t2 = high_resolution_clock::now();
+
+      double apiNs     = double(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) / double(draws);
+      double backendNs = double(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count()) / double(draws);
+
+      stats.apiNsMin      = std::min(stats.apiNsMin, apiNs);
+      stats.apiNsAvg     += apiNs / double(iterations);
+      stats.backendNsMin  = std::min(stats.backendNsMin, backendNs);
+      stats.backendNsAvg += backendNs / double(iterations);
+    }
+
+    return stats;
+  }
+
+
+  static void printStats(
+    const std::string&            api,
+          DrawBenchChurn          churn,
+          uint32_t                draws,
+          uint32_t                iterations,
+    const DrawBenchStats&         stats) {
+    std::cout << "{\"api\":\"" << api << "\""
+      << ",\"churn\":\"" << getChurnName(churn) << "\""
+      << ",\"draws\":" << draws
+      << ",\"iterations\":" << iterations
+      << ",\"api_ns_min\":" << stats.apiNsMin
+      << ",\"api_ns_avg\":" << stats.apiNsAvg
+      << ",\"backend_ns_min\":" << stats.backendNsMin
+      << ",\"backend_ns_avg\":" << stats.backendNsAvg
+      << "}" << std::endl;
+  }
+
+
+  template<typename Bench>
+  static bool runApi(
+    const std::string&                  api,
+    const std::vector<DrawBenchChurn>&  churns,
+          uint32_t                      draws,
+          uint32_t                      iterations) {
+    Bench bench;
+
+    if (!bench.init())
+      return false;
+
+    for (auto churn : churns)
+      printStats(api, churn, draws, iterations, runBench(bench, churn, draws, iterations));
+
+    return true;
+  }
+
+}
+
+
+int main(int argc, char** argv) {
+  using namespace dxvk;
+
+  std::string api = "all";
+  std::string churn = "all";
+
+  uint32_t draws = 10000u;
+  uint32_t iterations = 10u;
+
+  for (int i = 1; i < argc; i++) {
+    if (!std::strcmp(argv[i], "-a") && i + 1 < argc) {
+      api = argv[++i];
+    } else if (!std::strcmp(argv[i], "-c") && i + 1 < argc) {
+      churn = argv[++i];
+    } else if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+      draws = uint32_t(std::max(std::atoi(argv[++i]), 1));
+    } else if (!std::strcmp(argv[i], "-i") && i + 1 < argc) {
+      iterations = uint32_t(std::max(std::atoi(argv[++i]), 1));
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [-a d3d9|d3d11|all] [-c none|constants|state|all] [-n draws] [-i iterations]" << std::endl
+        << std::endl
+        << "Measures CPU time per draw on the API thread, and the time it takes" << std::endl
+        << "the backend to process and submit the draws. Results are printed as" << std::endl
+        << "one JSON object per line." << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<DrawBenchChurn> churns;
+
+  for (auto c : { DrawBenchChurn::None, DrawBenchChurn::Constants, DrawBenchChurn::State }) {
+    if (churn == "all" || churn == getChurnName(c))
+      churns.push_back(c);
+  }
+
+  if (churns.empty()) {
+    std::cerr << "Unknown state churn mode: " << churn << std::endl;
+    return 1;
+  }
+
+  bool success = true;
+
+  if (api == "all" || api == "d3d11")
+    success &= runApi<D3D11DrawBench>("d3d11", churns, draws, iterations);
+
+  if (api == "all" || api == "d3d9")
+    success &= runApi<D3D9DrawBench>("d3d9", churns, draws, iterations);
+
+  return success ? 0 : 1;
+}
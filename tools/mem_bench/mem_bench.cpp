@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../src/dxvk/dxvk_device.h"
+#include "../../src/dxvk/dxvk_instance.h"
+#include "../../src/dxvk/dxvk_memory.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Traced allocation
+   *
+   * Arguments of a single allocation as they
+   * were passed to the memory allocator.
+   */
+  struct MemBenchAlloc {
+    VkDeviceSize          size              = 0;
+    VkDeviceSize          alignment         = 0;
+    uint32_t              memoryTypeBits    = 0;
+    uint32_t              tiling            = 0;
+    uint32_t              requiresDedicated = 0;
+    uint32_t              prefersDedicated  = 0;
+    uint32_t              flags             = 0;
+    uint32_t              category          = 0;
+    uint32_t              hints             = 0;
+  };
+
+
+  /**
+   * \brief Replay statistics
+   */
+  struct MemBenchStats {
+    uint32_t              linesInvalid      = 0;
+    uint32_t              allocsSkipped     = 0;
+    uint32_t              freesUnmatched    = 0;
+    uint32_t              dedicatedDropped  = 0;
+
+    std::vector<uint64_t> allocNs;
+    std::vector<uint64_t> freeNs;
+
+    std::array<DxvkMemoryStats, VK_MAX_MEMORY_HEAPS> peak = { };
+  };
+
+
+  /**
+   * \brief Memory trace replay
+   *
+   * Replays a trace written by the memory allocator against
+   * a fresh allocator instance on the given device. Dedicated
+   * allocations cannot be replayed without the resource they
+   * were made for, so those are sub-allocated instead unless
+   * the resource required a dedicated allocation, in which
+   * case they are skipped.
+   */
+  class MemBench {
+
+  public:
+
+    MemBench(const Rc<DxvkDevice>& device)
+    : m_device    (device),
+      m_memProps  (device->adapter()->memoryProperties()),
+      m_allocator (device.ptr()) { }
+
+    ~MemBench() {
+      m_allocations.clear();
+    }
+
+    /**
+     * \brief Replays a trace file
+     *
+     * \param [in] path Trace file
+     * \returns \c true on success
+     */
+    bool replay(const std::string& path) {
+      std::ifstream file(path);
+
+      if (!file) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+      }
+
+      std::string line;
+
+      while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+          continue;
+
+        std::istringstream stream(line);
+
+        std::string op;
+        std::string id;
+        stream >> op >> id;
+
+        if (op == "a") {
+          MemBenchAlloc alloc;
+          stream >> alloc.size >> alloc.alignment >> alloc.memoryTypeBits
+                 >> alloc.tiling >> alloc.requiresDedicated >> alloc.prefersDedicated
+                 >> alloc.flags >> alloc.category >> alloc.hints;
+
+          if (stream)
+            replayAlloc(id, alloc);
+          else
+            m_stats.linesInvalid += 1;
+        } else if (op == "f" && !id.empty()) {
+          replayFree(id);
+        } else {
+          m_stats.linesInvalid += 1;
+        }
+      }
+
+      return true;
+    }
+
+    /**
+     * \brief Prints replay statistics
+     */
+    void printStats() {
+      std::cout << m_stats.allocNs.size() << " allocations, "
+        << m_stats.freeNs.size() << " frees, "
+        << m_stats.allocsSkipped << " skipped, "
+        << m_stats.dedicatedDropped << " dedicated sub-allocated, "
+        << m_stats.freesUnmatched << " unmatched frees, "
+        << m_stats.linesInvalid << " invalid lines" << std::endl
+        << std::endl;
+
+      printLatency("Alloc", m_stats.allocNs);
+      printLatency("Free",  m_stats.freeNs);
+
+      std::cout << std::endl;
+
+      for (uint32_t i = 0; i < m_memProps.memoryHeapCount; i++) {
+        DxvkMemoryStats stats = m_allocator.getMemoryStats(i);
+        const DxvkMemoryStats& peak = m_stats.peak[i];
+
+        if (!peak.memoryAllocated)
+          continue;
+
+        std::cout << "Heap " << i << ": "
+          << (stats.memoryAllocated >> 20) << " MB allocated, "
+          << (stats.memoryUsed >> 20) << " MB used, "
+          << stats.chunkCount << " chunks, "
+          << "fragmentation " << getFragmentation(stats) << std::endl
+          << "  peak: "
+          << (peak.memoryAllocated >> 20) << " MB allocated, "
+          << (peak.memoryUsed >> 20) << " MB used, "
+          << peak.chunkCount << " chunks, "
+          << "fragmentation " << getFragmentation(peak) << std::endl;
+      }
+    }
+
+  private:
+
+    Rc<DxvkDevice>                  m_device;
+    VkPhysicalDeviceMemoryProperties m_memProps;
+
+    DxvkMemoryAllocator             m_allocator;
+
+    std::unordered_map<std::string, DxvkMemory> m_allocations;
+
+    MemBenchStats                   m_stats;
+
+    void replayAlloc(const std::string& id, const MemBenchAlloc& alloc) {
+      uint32_t typeMask = m_memProps.memoryTypeCount < 32
+        ? (1u << m_memProps.memoryTypeCount) - 1u : ~0u;
+
+      if (alloc.requiresDedicated || !(alloc.memoryTypeBits & typeMask)) {
+        m_stats.allocsSkipped += 1;
+        return;
+      }
+
+      if (alloc.prefersDedicated)
+        m_stats.dedicatedDropped += 1;
+
+      DxvkMemoryRequirements req = { };
+      req.tiling    = VkImageTiling(alloc.tiling);
+      req.dedicated = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
+      req.core      = { VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+      req.core.memoryRequirements.size           = alloc.size;
+      req.core.memoryRequirements.alignment      = alloc.alignment;
+      req.core.memoryRequirements.memoryTypeBits = alloc.memoryTypeBits & typeMask;
+
+      DxvkMemoryProperties info = { };
+      info.flags    = alloc.flags;
+      info.category = DxvkMemoryCategory(alloc.category);
+
+      DxvkMemoryFlags hints;
+
+      for (uint32_t i = 0; i < 32; i++) {
+        if (alloc.hints & (1u << i))
+          hints.set(DxvkMemoryFlag(i));
+      }
+
+      DxvkMemory memory;
+
+      try {
+        auto t0 = high_resolution_clock::now();
+        memory = m_allocator.alloc(req, info, hints);
+        auto t1 = high_resolution_clock::now();
+
+        m_stats.allocNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+      } catch (const DxvkError&) {
+        m_stats.allocsSkipped += 1;
+        return;
+      }
+
+      // Memory usage can only grow on allocation, so this
+      // is sufficient to keep track of peak memory usage
+      updatePeakStats();
+
+      m_allocations[id] = std::move(memory);
+    }
+
+    void replayFree(const std::string& id) {
+      auto entry = m_allocations.find(id);
+
+      if (entry == m_allocations.end()) {
+        m_stats.freesUnmatched += 1;
+        return;
+      }
+
+      auto t0 = high_resolution_clock::now();
+      entry->second = DxvkMemory();
+      auto t1 = high_resolution_clock::now();
+
+      m_stats.freeNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+      m_allocations.erase(entry);
+    }
+
+    void updatePeakStats() {
+      for (uint32_t i = 0; i < m_memProps.memoryHeapCount; i++) {
+        DxvkMemoryStats stats = m_allocator.getMemoryStats(i);
+
+        if (stats.memoryAllocated > m_stats.peak[i].memoryAllocated)
+          m_stats.peak[i] = stats;
+      }
+    }
+
+    static double getFragmentation(const DxvkMemoryStats& stats) {
+      VkDeviceSize freeSize = stats.memoryAllocated - stats.memoryUsed;
+
+      if (!freeSize)
+        return 0.0;
+
+      return 1.0 - double(stats.largestFreeBlock) / double(freeSize);
+    }
+
+    static void printLatency(const char* name, std::vector<uint64_t>& samples) {
+      if (samples.empty())
+        return;
+
+      std::sort(samples.begin(), samples.end());
+
+      auto percentile = [&samples] (uint32_t p) {
+        return samples[(samples.size() - 1) * p / 100];
+      };
+
+      std::cout << name << " latency (ns): "
+        << "p50 " << percentile(50) << ", "
+        << "p90 " << percentile(90) << ", "
+        << "p99 " << percentile(99) << ", "
+        << "max " << samples.back() << std::endl;
+    }
+
+  };
+
+}
+
+
+int main(int argc, char** argv) {
+  using namespace dxvk;
+
+  std::string tracePath;
+  uint32_t adapterIndex = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!std::strcmp(argv[i], "-a") && i + 1 < argc)
+      adapterIndex = uint32_t(std::max(std::atoi(argv[++i]), 0));
+    else if (tracePath.empty())
+      tracePath = argv[i];
+    else
+      tracePath.clear();
+  }
+
+  if (tracePath.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [-a <adapter>] <trace>" << std::endl
+      << std::endl
+      << "Replays a memory allocation trace recorded with DXVK_MEMORY_TRACE_PATH" << std::endl
+      << "and reports allocation latency, chunk count, fragmentation and peak" << std::endl
+      << "memory usage per heap." << std::endl;
+    return 1;
+  }
+
+  try {
+    Rc<DxvkInstance> instance = new DxvkInstance();
+    Rc<DxvkAdapter> adapter = instance->enumAdapters(adapterIndex);
+
+    if (adapter == nullptr) {
+      std::cerr << "Adapter " << adapterIndex << " not found" << std::endl;
+      return 1;
+    }
+
+    Rc<DxvkDevice> device = adapter->createDevice(instance, DxvkDeviceFeatures());
+
+    MemBench bench(device);
+
+    if (!bench.replay(tracePath))
+      return 1;
+
+    bench.printStats();
+  } catch (const DxvkError& e) {
+    std::cerr << e.message() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
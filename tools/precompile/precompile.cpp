@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../../src/dxvk/dxvk_device.h"
+#include "../../src/dxvk/dxvk_instance.h"
+#include "../../src/dxvk/dxvk_shader_cache.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Offline pipeline precompiler
+   *
+   * Registers every shader from a shader cache file with
+   * a headless device, so that the state cache compiles
+   * all pipelines recorded for those shaders on the
+   * pipeline compiler workers. This populates the Vulkan
+   * driver's own on-disk shader cache.
+   */
+  class Precompiler {
+
+  public:
+
+    Precompiler(const Rc<DxvkDevice>& device)
+    : m_device(device) { }
+
+    /**
+     * \brief Registers all cached shaders
+     * \returns Number of shaders registered
+     */
+    uint32_t registerShaders() {
+      Rc<DxvkShaderCache> shaderCache = m_device->adapter()->getShaderCache(m_device.ptr());
+      uint32_t count = 0;
+
+      for (const auto& entry : shaderCache->enumShaders()) {
+        Rc<DxvkShader> shader = m_device->lookupShader(entry.first, entry.second);
+
+        if (shader == nullptr) {
+          std::cerr << "Failed to load " << entry.first.toString() << std::endl;
+          continue;
+        }
+
+        m_device->registerShader(shader);
+        count += 1;
+      }
+
+      return count;
+    }
+
+    /**
+     * \brief Waits for all pipelines to compile
+     *
+     * Prints progress about once per second.
+     */
+    void waitForPipelines() {
+      auto lastReport = high_resolution_clock::now();
+
+      while (m_device->isCompilingPipelines()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        auto now = high_resolution_clock::now();
+
+        if (now - lastReport >= std::chrono::seconds(1)) {
+          DxvkStatCounters counters = m_device->getStatCounters();
+
+          std::cout << counters.getCtr(DxvkStatCounter::PipeTasksDone) << " / "
+            << counters.getCtr(DxvkStatCounter::PipeTasksTotal) << " tasks" << std::endl;
+
+          lastReport = now;
+        }
+      }
+    }
+
+    /**
+     * \brief Prints compiled pipeline counts
+     */
+    void printStats() {
+      DxvkStatCounters counters = m_device->getStatCounters();
+
+      std::cout << counters.getCtr(DxvkStatCounter::PipeCountGraphics) << " graphics pipelines, "
+        << counters.getCtr(DxvkStatCounter::PipeCountLibrary) << " pipeline libraries, "
+        << counters.getCtr(DxvkStatCounter::PipeCountCompute) << " compute pipelines" << std::endl;
+    }
+
+  private:
+
+    Rc<DxvkDevice> m_device;
+
+  };
+
+
+  /**
+   * \brief Queries features to enable
+   *
+   * Mirrors the features that the client APIs would enable,
+   * since some of them may affect pipeline compilation.
+   * \param [in] adapter The adapter
+   * \returns Device features
+   */
+  DxvkDeviceFeatures getDeviceFeatures(const Rc<DxvkAdapter>& adapter) {
+    DxvkDeviceFeatures supported = adapter->features();
+    DxvkDeviceFeatures enabled = { };
+
+    enabled.core.features = supported.core.features;
+
+    enabled.vk11.shaderDrawParameters = supported.vk11.shaderDrawParameters;
+    enabled.vk12.samplerFilterMinmax = supported.vk12.samplerFilterMinmax;
+    enabled.vk12.samplerMirrorClampToEdge = supported.vk12.samplerMirrorClampToEdge;
+    enabled.vk13.shaderDemoteToHelperInvocation = supported.vk13.shaderDemoteToHelperInvocation;
+
+    enabled.extCustomBorderColor.customBorderColors = supported.extCustomBorderColor.customBorderColorWithoutFormat;
+    enabled.extCustomBorderColor.customBorderColorWithoutFormat = supported.extCustomBorderColor.customBorderColorWithoutFormat;
+
+    enabled.extFragmentShaderInterlock.fragmentShaderSampleInterlock = supported.extFragmentShaderInterlock.fragmentShaderSampleInterlock;
+    enabled.extFragmentShaderInterlock.fragmentShaderPixelInterlock = supported.extFragmentShaderInterlock.fragmentShaderPixelInterlock;
+
+    enabled.extTransformFeedback.transformFeedback = supported.extTransformFeedback.transformFeedback;
+    enabled.extTransformFeedback.geometryStreams = supported.extTransformFeedback.geometryStreams;
+
+    enabled.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor = supported.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor;
+    enabled.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor = supported.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor;
+    return enabled;
+  }
+
+}
+
+
+int main(int argc, char** argv) {
+  using namespace dxvk;
+
+  std::string cacheDir;
+  std::string cacheName;
+  uint32_t adapterIndex = 0;
+  bool valid = true;
+
+  for (int i = 1; i < argc; i++) {
+    if (!std::strcmp(argv[i], "-a") && i + 1 < argc)
+      adapterIndex = uint32_t(std::max(std::atoi(argv[++i]), 0));
+    else if (cacheDir.empty())
+      cacheDir = argv[i];
+    else if (cacheName.empty())
+      cacheName = argv[i];
+    else
+      valid = false;
+  }
+
+  if (!valid || cacheName.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [-a <adapter>] <directory> <name>" << std::endl
+      << std::endl
+      << "Compiles all pipelines from <directory>/<name>.dxvk-cache, using the" << std::endl
+      << "shaders from <directory>/<name>.dxvk-shaders, in order to populate the" << std::endl
+      << "driver's shader cache for the given adapter ahead of time." << std::endl;
+    return 1;
+  }
+
+  // The caches locate their files through these
+  env::setEnvVar("DXVK_STATE_CACHE", "1");
+  env::setEnvVar("DXVK_SHADER_CACHE", "1");
+  env::setEnvVar("DXVK_STATE_CACHE_PATH", cacheDir.c_str());
+  env::setEnvVar("DXVK_STATE_CACHE_NAME", cacheName.c_str());
+
+  try {
+    Rc<DxvkInstance> instance = new DxvkInstance();
+    Rc<DxvkAdapter> adapter = instance->enumAdapters(adapterIndex);
+
+    if (adapter == nullptr) {
+      std::cerr << "Adapter " << adapterIndex << " not found" << std::endl;
+      return 1;
+    }
+
+    Rc<DxvkDevice> device = adapter->createDevice(instance, getDeviceFeatures(adapter));
+
+    auto t0 = high_resolution_clock::now();
+
+    Precompiler precompiler(device);
+    uint32_t shaderCount = precompiler.registerShaders();
+
+    if (!shaderCount) {
+      std::cerr << "No shaders found" << std::endl;
+      return 1;
+    }
+
+    precompiler.waitForPipelines();
+
+    auto t1 = high_resolution_clock::now();
+
+    std::cout << shaderCount << " shaders, ";
+    precompiler.printStats();
+
+    std::cout << "Finished in " << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
+      << " ms" << std::endl;
+  } catch (const DxvkError& e) {
+    std::cerr << e.message() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,569 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../../src/dxbc/dxbc_module.h"
+#include "../../src/dxso/dxso_modinfo.h"
+#include "../../src/dxso/dxso_module.h"
+#include "../../src/d3d9/d3d9_caps.h"
+
+#include "../../src/spirv/spirv_compression.h"
+
+#include "../../src/util/util_time.h"
+
+namespace {
+
+  std::atomic<uint64_t> g_allocCount = { 0ull };
+  std::atomic<uint64_t> g_allocBytes = { 0ull };
+
+}
+
+void* operator new(size_t size) {
+  g_allocCount.fetch_add(1, std::memory_order_relaxed);
+  g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+
+  if (void* ptr = std::malloc(size ? size : 1))
+    return ptr;
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace dxvk {
+
+  /**
+   * \brief Shader translation statistics
+   *
+   * Accumulated over all iterations of one shader,
+   * or over all shaders for the final summary.
+   */
+  struct ShaderBenchStats {
+    uint32_t  shaderCount   = 0;
+    uint32_t  failureCount  = 0;
+    uint64_t  inputBytes    = 0;
+    uint64_t  outputBytes   = 0;
+    uint64_t  allocCount    = 0;
+    uint64_t  allocBytes    = 0;
+    uint64_t  timeNs        = 0;
+
+    void add(const ShaderBenchStats& other) {
+      shaderCount  += other.shaderCount;
+      failureCount += other.failureCount;
+      inputBytes   += other.inputBytes;
+      outputBytes  += other.outputBytes;
+      allocCount   += other.allocCount;
+      allocBytes   += other.allocBytes;
+      timeNs       += other.timeNs;
+    }
+  };
+
+
+  /**
+   * \brief Translates a DXBC shader once
+   *
+   * Uses default compiler options, which match what the
+   * D3D11 device uses on a fully featured Vulkan device
+   * closely enough for profiling purposes.
+   * \returns Generated SPIR-V code
+   */
+  static SpirvCodeBuffer translateDxbc(
+    const std::vector<char>&  data,
+    const std::string&        name) {
+    DxbcReader reader(data.data(), data.size());
+    DxbcModule module(reader);
+
+    DxbcTessInfo tessInfo;
+    tessInfo.maxTessFactor = 64.0f;
+
+    DxbcModuleInfo moduleInfo;
+    moduleInfo.options = DxbcOptions();
+    moduleInfo.tess    = &tessInfo;
+    moduleInfo.xfb     = nullptr;
+
+    Rc<DxvkShader> shader = module.compile(moduleInfo, name);
+    return shader->getRawCode();
+  }
+
+
+  /**
+   * \brief Translates a DXSO shader once
+   *
+   * Uses the constant layout that a device without
+   * software vertex processing would use.
+   * \returns Generated SPIR-V code
+   */
+  static SpirvCodeBuffer translateDxso(
+    const std::vector<char>&  data,
+    const std::string&        name) {
+    DxsoReader reader(data.data());
+    DxsoModule module(reader);
+
+    DxsoModuleInfo moduleInfo;
+    moduleInfo.options.strictConstantCopies   = false;
+    moduleInfo.options.d3d9FloatEmulation     = D3D9FloatEmulation::Enabled;
+    moduleInfo.options.strictPow              = true;
+    moduleInfo.options.shaderModel            = 3;
+    moduleInfo.options.invariantPosition      = true;
+    moduleInfo.options.forceSamplerTypeSpecConstants = false;
+    moduleInfo.options.forceSampleRateShading = false;
+    moduleInfo.options.vertexFloatConstantBufferAsSSBO = false;
+    moduleInfo.options.longMad                = false;
+    moduleInfo.options.robustness2Supported   = true;
+
+    bool isVertexShader = module.info().type() == DxsoProgramTypes::VertexShader;
+
+    D3D9ConstantLayout layout;
+    layout.floatCount   = isVertexShader ? caps::MaxFloatConstantsVS : caps::MaxFloatConstantsPS;
+    layout.intCount     = caps::MaxOtherConstants;
+    layout.boolCount    = caps::MaxOtherConstants;
+    layout.bitmaskCount = align(layout.boolCount, 32) / 32;
+
+    DxsoAnalysisInfo analysis = module.analyze();
+    Rc<DxvkShader> shader = module.compile(moduleInfo, name, analysis, layout);
+    return shader->getRawCode();
+  }
+
+
+  /**
+   * \brief Previous SPIR-V compression format
+   *
+   * Encodes up to two consecutive tokens into one dword, in
+   * blocks of 16 dwords preceded by a dword with the two-bit
+   * layout of each. Kept here to compare the current format
+   * against, and must not be used for anything else.
+   */
+  namespace legacy {
+
+    struct CompressedBuffer {
+      size_t                size = 0;
+      std::vector<uint32_t> code;
+
+      const std::vector<uint32_t>& data() const {
+        return code;
+      }
+    };
+
+
+    static CompressedBuffer compress(
+      const SpirvCodeBuffer&      code) {
+      const uint32_t* data = code.data();
+      size_t size = code.dwords();
+
+      CompressedBuffer compressed;
+      compressed.size = size;
+
+      std::vector<uint32_t>& result = compressed.code;
+      result.reserve((size * 75) / 128);
+
+      std::array<uint32_t, 16> block;
+      uint32_t blockMask = 0;
+      uint32_t blockOffset = 0;
+
+      for (size_t i = 0; i < size; ) {
+        if (likely(i + 1 < size)) {
+          uint32_t a = data[i];
+          uint32_t b = data[i + 1];
+          uint32_t schema;
+          uint32_t encode;
+
+          if (std::max(a, b) < (1u << 16)) {
+            schema = 0x2;
+            encode = a | (b << 16);
+          } else if (a < (1u << 20) && b < (1u << 12)) {
+            schema = 0x1;
+            encode = a | (b << 20);
+          } else if (a < (1u << 12) && b < (1u << 20)) {
+            schema = 0x3;
+            encode = a | (b << 12);
+          } else {
+            schema = 0x0;
+            encode = a;
+          }
+
+          block[blockOffset] = encode;
+          blockMask |= schema << (blockOffset << 1);
+          blockOffset += 1;
+
+          i += schema ? 2 : 1;
+        } else {
+          block[blockOffset] = data[i++];
+          blockOffset += 1;
+        }
+
+        if (unlikely(blockOffset == 16) || unlikely(i == size)) {
+          result.insert(result.end(), blockMask);
+          result.insert(result.end(), block.begin(), block.begin() + blockOffset);
+
+          blockMask = 0;
+          blockOffset = 0;
+        }
+      }
+
+      if (result.capacity() > (result.size() * 10) / 9)
+        result.shrink_to_fit();
+
+      return compressed;
+    }
+
+
+    static SpirvCodeBuffer decompress(
+      const CompressedBuffer&     buffer) {
+      const std::vector<uint32_t>& compressed = buffer.code;
+      size_t size = buffer.size;
+
+      SpirvCodeBuffer code(size);
+      uint32_t* data = code.data();
+
+      uint32_t srcOffset = 0;
+      uint32_t dstOffset = 0;
+
+      constexpr uint32_t shiftAmounts = 0x0c101420;
+
+      while (dstOffset < size) {
+        uint32_t blockMask = compressed[srcOffset];
+
+        for (uint32_t i = 0; i < 16 && dstOffset < size; i++) {
+          uint32_t schema = (blockMask >> (i << 1)) & 0x3;
+          uint32_t shift  = (shiftAmounts >> (schema << 3)) & 0xff;
+          uint64_t mask   = ~(~0ull << shift);
+          uint64_t encode = compressed[srcOffset + i + 1];
+
+          data[dstOffset] = encode & mask;
+
+          if (likely(schema))
+            data[dstOffset + 1] = encode >> shift;
+
+          dstOffset += schema ? 2 : 1;
+        }
+
+        srcOffset += 17;
+      }
+
+      return code;
+    }
+
+  }
+
+
+  /**
+   * \brief Compression statistics
+   *
+   * Per-iteration timings and output sizes of one codec,
+   * accumulated over all shaders for the final summary.
+   */
+  struct CompressionBenchStats {
+    uint64_t  inputBytes    = 0;
+    uint64_t  outputBytes   = 0;
+    uint64_t  encodeNs      = 0;
+    uint64_t  decodeNs      = 0;
+    uint32_t  mismatchCount = 0;
+
+    void add(const CompressionBenchStats& other) {
+      inputBytes    += other.inputBytes;
+      outputBytes   += other.outputBytes;
+      encodeNs      += other.encodeNs;
+      decodeNs      += other.decodeNs;
+      mismatchCount += other.mismatchCount;
+    }
+  };
+
+
+  static bool isSameCode(
+    const SpirvCodeBuffer&        a,
+    const SpirvCodeBuffer&        b) {
+    return a.dwords() == b.dwords()
+        && !std::memcmp(a.data(), b.data(), a.size());
+  }
+
+
+  template<typename Encode, typename Decode>
+  static CompressionBenchStats benchCodec(
+          SpirvCodeBuffer&        code,
+          uint32_t                iterations,
+    const Encode&                 encode,
+    const Decode&                 decode) {
+    CompressionBenchStats stats;
+    stats.inputBytes = code.size();
+
+    auto compressed = encode(code);
+    stats.outputBytes = compressed.data().size() * sizeof(uint32_t);
+
+    if (!isSameCode(decode(compressed), code))
+      stats.mismatchCount = 1;
+
+    auto t0 = high_resolution_clock::now();
+
+    for (uint32_t i = 0; i < iterations; i++)
+      encode(code);
+
+    auto t1 = high_resolution_clock::now();
+
+    for (uint32_t i = 0; i < iterations; i++)
+      decode(compressed);
+
+    auto t2 = high_resolution_clock::now();
+
+    stats.encodeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / iterations;
+    stats.decodeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / iterations;
+    return stats;
+  }
+
+
+  static void printCompressionStats(
+    const std::string&            name,
+    const CompressionBenchStats&  stats) {
+    auto mbs = [&stats] (uint64_t ns) {
+      return ns ? double(stats.inputBytes) * 1000.0 / double(ns) : 0.0;
+    };
+
+    double ratio = stats.inputBytes
+      ? 100.0 * double(stats.outputBytes) / double(stats.inputBytes)
+      : 0.0;
+
+    std::cout << "  " << name
+      << ": " << stats.inputBytes << " -> " << stats.outputBytes << " bytes"
+      << " (" << ratio << "%)"
+      << ", encode " << mbs(stats.encodeNs) << " MB/s"
+      << ", decode " << mbs(stats.decodeNs) << " MB/s"
+      << (stats.mismatchCount ? ", ROUND TRIP FAILED" : "")
+      << std::endl;
+  }
+
+
+  static bool readFile(
+    const std::filesystem::path&  path,
+          std::vector<char>&      data) {
+    std::ifstream file(path, std::ios_base::binary | std::ios_base::ate);
+
+    if (!file)
+      return false;
+
+    data.resize(size_t(file.tellg()));
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    return bool(file);
+  }
+
+
+  static ShaderBenchStats benchShader(
+    const std::filesystem::path&  path,
+          uint32_t                iterations) {
+    ShaderBenchStats stats;
+
+    std::vector<char> data;
+
+    if (!readFile(path, data)) {
+      std::cerr << "Failed to read " << path.string() << std::endl;
+      stats.failureCount += 1;
+      return stats;
+    }
+
+    std::string name = path.stem().string();
+    bool isDxso = path.extension() == ".dxso";
+
+    stats.shaderCount = 1;
+
+    try {
+      uint64_t allocCount = g_allocCount.load();
+      uint64_t allocBytes = g_allocBytes.load();
+
+      auto t0 = high_resolution_clock::now();
+
+      for (uint32_t i = 0; i < iterations; i++) {
+        size_t size = isDxso
+          ? translateDxso(data, name).size()
+          : translateDxbc(data, name).size();
+
+        if (!i)
+          stats.outputBytes = size;
+      }
+
+      auto t1 = high_resolution_clock::now();
+
+      stats.inputBytes = data.size();
+      stats.timeNs     = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / iterations;
+      stats.allocCount = (g_allocCount.load() - allocCount) / iterations;
+      stats.allocBytes = (g_allocBytes.load() - allocBytes) / iterations;
+    } catch (const DxvkError& e) {
+      std::cerr << name << ": " << e.message() << std::endl;
+      stats.shaderCount  = 0;
+      stats.failureCount = 1;
+    }
+
+    return stats;
+  }
+
+
+  /**
+   * \brief Benchmarks SPIR-V compression of a shader
+   *
+   * Translates the shader once, then compresses and
+   * decompresses the generated code with both the
+   * current and the previous compression format.
+   * \returns \c false if translation failed
+   */
+  static bool benchCompression(
+    const std::filesystem::path&  path,
+          uint32_t                iterations,
+          CompressionBenchStats&  current,
+          CompressionBenchStats&  previous) {
+    std::vector<char> data;
+
+    if (!readFile(path, data)) {
+      std::cerr << "Failed to read " << path.string() << std::endl;
+      return false;
+    }
+
+    std::string name = path.stem().string();
+
+    try {
+      SpirvCodeBuffer code = path.extension() == ".dxso"
+        ? translateDxso(data, name)
+        : translateDxbc(data, name);
+
+      current = benchCodec(code, iterations,
+        [] (SpirvCodeBuffer& c) { return SpirvCompressedBuffer(c); },
+        [] (const SpirvCompressedBuffer& c) { return c.decompress(); });
+
+      previous = benchCodec(code, iterations,
+        [] (SpirvCodeBuffer& c) { return legacy::compress(c); },
+        [] (const legacy::CompressedBuffer& c) { return legacy::decompress(c); });
+
+      std::cout << name << ":" << std::endl;
+      printCompressionStats("current ", current);
+      printCompressionStats("previous", previous);
+      return true;
+    } catch (const DxvkError& e) {
+      std::cerr << name << ": " << e.message() << std::endl;
+      return false;
+    }
+  }
+
+
+  static void printStats(
+    const std::string&            name,
+    const ShaderBenchStats&       stats) {
+    double us = double(stats.timeNs) / 1000.0;
+    double mbs = stats.timeNs ? double(stats.inputBytes) * 1000.0 / double(stats.timeNs) : 0.0;
+
+    std::cout << name
+      << ": " << us << " us"
+      << ", " << mbs << " MB/s"
+      << ", " << stats.allocCount << " allocs"
+      << " (" << stats.allocBytes << " bytes)"
+      << ", " << stats.inputBytes << " -> " << stats.outputBytes << " bytes"
+      << std::endl;
+  }
+
+}
+
+
+int main(int argc, char** argv) {
+  using namespace dxvk;
+
+  // Benchmarks SPIR-V compression instead of translation
+  bool compression = argc > 1 && std::strcmp(argv[1], "--compression") == 0;
+
+  if (compression) {
+    argc -= 1;
+    argv += 1;
+  }
+
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " [--compression] <shader dump dir> [iterations]" << std::endl;
+    return 1;
+  }
+
+  uint32_t iterations = argc > 2 ? uint32_t(std::max(std::atoi(argv[2]), 1)) : 10u;
+
+  std::vector<std::filesystem::path> files;
+
+  for (const auto& entry : std::filesystem::directory_iterator(argv[1])) {
+    auto ext = entry.path().extension();
+
+    if (entry.is_regular_file() && (ext == ".dxbc" || ext == ".dxso"))
+      files.push_back(entry.path());
+  }
+
+  std::sort(files.begin(), files.end());
+
+  if (files.empty()) {
+    std::cerr << "No .dxbc or .dxso files found in " << argv[1] << std::endl;
+    return 1;
+  }
+
+  if (compression) {
+    CompressionBenchStats totalCurrent;
+    CompressionBenchStats totalPrevious;
+    uint32_t failureCount = 0;
+
+    for (const auto& file : files) {
+      CompressionBenchStats current;
+      CompressionBenchStats previous;
+
+      if (benchCompression(file, iterations, current, previous)) {
+        totalCurrent.add(current);
+        totalPrevious.add(previous);
+      } else {
+        failureCount += 1;
+      }
+    }
+
+    std::cout << std::endl
+      << files.size() - failureCount << " shaders, "
+      << failureCount << " failed, "
+      << iterations << " iterations each" << std::endl
+      << "Total:" << std::endl;
+
+    printCompressionStats("current ", totalCurrent);
+    printCompressionStats("previous", totalPrevious);
+
+    return (failureCount || totalCurrent.mismatchCount || totalPrevious.mismatchCount) ? 1 : 0;
+  }
+
+  ShaderBenchStats total;
+
+  for (const auto& file : files) {
+    ShaderBenchStats stats = benchShader(file, iterations);
+
+    if (stats.shaderCount)
+      printStats(file.stem().string(), stats);
+
+    total.add(stats);
+  }
+
+  std::cout << std::endl
+    << total.shaderCount << " shaders, "
+    << total.failureCount << " failed, "
+    << iterations << " iterations each" << std::endl;
+
+  printStats("Total", total);
+  return total.failureCount ? 1 : 0;
+}
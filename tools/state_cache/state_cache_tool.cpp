@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../src/dxvk/dxvk_state_cache.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Merged state cache entry
+   *
+   * Stores an entry as it will be written to the
+   * output file, along with its input position
+   * so that sorting is stable across inputs.
+   */
+  struct StateCacheToolEntry {
+    DxvkStateCacheEntry entry;
+    size_t              index;
+  };
+
+
+  /**
+   * \brief State cache merge statistics
+   */
+  struct StateCacheToolStats {
+    uint32_t  entriesRead       = 0;
+    uint32_t  entriesInvalid    = 0;
+    uint32_t  entriesDuplicate  = 0;
+    uint32_t  entriesDropped    = 0;
+  };
+
+
+  /**
+   * \brief State cache merge tool
+   *
+   * Reads any number of state cache files of any
+   * supported version, and writes all unique, valid
+   * entries to a single file in the current format.
+   */
+  class StateCacheTool {
+
+  public:
+
+    /**
+     * \brief Adds shaders from a shader dump directory
+     *
+     * Shader dumps are named after their shader key, so the
+     * file names can be used to check which shaders exist.
+     * \param [in] path Shader dump directory
+     * \returns \c true on success
+     */
+    bool addShaderDir(const std::filesystem::path& path) {
+      std::error_code ec;
+
+      for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+        if (entry.is_regular_file())
+          m_shaders.insert(entry.path().stem().string());
+      }
+
+      m_filterShaders = true;
+      return !ec;
+    }
+
+    /**
+     * \brief Reads all entries from a cache file
+     *
+     * \param [in] path Input file
+     * \returns \c true on success
+     */
+    bool addCacheFile(const std::filesystem::path& path) {
+      std::ifstream file(path, std::ios_base::binary);
+
+      if (!file) {
+        std::cerr << "Failed to open " << path.string() << std::endl;
+        return false;
+      }
+
+      DxvkStateCacheHeader header;
+
+      if (!DxvkStateCache::readCacheHeader(file, header)) {
+        std::cerr << path.string() << ": Not a state cache file" << std::endl;
+        return false;
+      }
+
+      if (!DxvkStateCache::isSupportedVersion(header.version)) {
+        std::cerr << path.string() << ": Unsupported version v" << header.version << std::endl;
+        return false;
+      }
+
+      StateCacheToolStats stats;
+
+      while (file) {
+        DxvkStateCacheEntry entry;
+
+        if (DxvkStateCache::readCacheEntry(header.version, file, entry)) {
+          stats.entriesRead += 1;
+          addEntry(entry, stats);
+        } else if (file) {
+          stats.entriesInvalid += 1;
+        }
+      }
+
+      std::cout << path.string()
+        << " (v" << header.version << "): "
+        << stats.entriesRead << " entries, "
+        << stats.entriesInvalid << " invalid, "
+        << stats.entriesDuplicate << " duplicate, "
+        << stats.entriesDropped << " dropped" << std::endl;
+
+      m_stats.entriesRead       += stats.entriesRead;
+      m_stats.entriesInvalid    += stats.entriesInvalid;
+      m_stats.entriesDuplicate  += stats.entriesDuplicate;
+      m_stats.entriesDropped    += stats.entriesDropped;
+      return true;
+    }
+
+    /**
+     * \brief Writes merged cache file
+     *
+     * Entries are written in order of their first use,
+     * which is also the order in which they are loaded.
+     * \param [in] path Output file
+     * \returns \c true on success
+     */
+    bool writeCacheFile(const std::filesystem::path& path) {
+      std::vector<StateCacheToolEntry*> entries;
+      entries.reserve(m_entries.size());
+
+      for (auto& e : m_entries)
+        entries.push_back(&e);
+
+      std::sort(entries.begin(), entries.end(), [] (
+          const StateCacheToolEntry* a,
+          const StateCacheToolEntry* b) {
+        if (a->entry.firstFrame != b->entry.firstFrame)
+          return a->entry.firstFrame < b->entry.firstFrame;
+
+        return a->index < b->index;
+      });
+
+      std::ofstream file(path, std::ios_base::binary | std::ios_base::trunc);
+
+      if (!file) {
+        std::cerr << "Failed to create " << path.string() << std::endl;
+        return false;
+      }
+
+      DxvkStateCacheHeader header;
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      size_t size = sizeof(header);
+
+      for (auto e : entries)
+        size += DxvkStateCache::writeCacheEntry(file, e->entry);
+
+      if (!file) {
+        std::cerr << "Failed to write " << path.string() << std::endl;
+        return false;
+      }
+
+      std::cout << path.string()
+        << " (v" << header.version << "): "
+        << entries.size() << " entries, "
+        << size << " bytes" << std::endl;
+      return true;
+    }
+
+    /**
+     * \brief Queries total stats
+     * \returns Merge statistics
+     */
+    const StateCacheToolStats& getStats() const {
+      return m_stats;
+    }
+
+  private:
+
+    std::vector<StateCacheToolEntry>        m_entries;
+    std::unordered_map<std::string, size_t> m_entryMap;
+
+    bool                                    m_filterShaders = false;
+    std::unordered_set<std::string>         m_shaders;
+
+    StateCacheToolStats                     m_stats;
+
+    void addEntry(
+            DxvkStateCacheEntry&      entry,
+            StateCacheToolStats&      stats) {
+      if (!hasShaders(entry.shaders)) {
+        stats.entriesDropped += 1;
+        return;
+      }
+
+      // Re-serialize the entry to compute the hash in the current
+      // format, since entries converted from older versions would
+      // otherwise not be recognized as duplicates.
+      std::ostringstream stream;
+      DxvkStateCache::writeCacheEntry(stream, entry);
+
+      std::string key = str::format(uint32_t(entry.type), ":", entry.hash.toString());
+      auto existing = m_entryMap.find(key);
+
+      if (existing != m_entryMap.end()) {
+        auto& e = m_entries[existing->second].entry;
+        e.firstFrame = std::min(e.firstFrame, entry.firstFrame);
+
+        stats.entriesDuplicate += 1;
+        return;
+      }
+
+      m_entryMap.insert({ key, m_entries.size() });
+      m_entries.push_back({ entry, m_entries.size() });
+    }
+
+    bool hasShaders(const DxvkStateCacheKey& key) const {
+      if (!m_filterShaders)
+        return true;
+
+      return hasShader(key.vs)
+          && hasShader(key.tcs)
+          && hasShader(key.tes)
+          && hasShader(key.gs)
+          && hasShader(key.fs);
+    }
+
+    bool hasShader(const DxvkShaderKey& key) const {
+      if (key.eq(DxvkShaderKey()))
+        return true;
+
+      return m_shaders.find(key.toString()) != m_shaders.end();
+    }
+
+  };
+
+}
+
+
+int main(int argc, char** argv) {
+  using namespace dxvk;
+
+  std::filesystem::path outputPath;
+  std::vector<std::filesystem::path> inputPaths;
+
+  StateCacheTool tool;
+
+  for (int i = 1; i < argc; i++) {
+    if (!std::strcmp(argv[i], "-o") && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (!std::strcmp(argv[i], "-s") && i + 1 < argc) {
+      if (!tool.addShaderDir(argv[++i])) {
+        std::cerr << "Failed to read shader directory " << argv[i] << std::endl;
+        return 1;
+      }
+    } else {
+      inputPaths.push_back(argv[i]);
+    }
+  }
+
+  if (outputPath.empty() || inputPaths.empty()) {
+    std::cerr << "Usage: " << argv[0] << " -o <output> [-s <shader dump dir>] <input>..." << std::endl
+      << std::endl
+      << "Merges, validates and compacts state cache files. If a shader dump" << std::endl
+      << "directory is given, entries using any other shaders are dropped." << std::endl;
+    return 1;
+  }
+
+  // Read all inputs before creating the
+  // output, which may be one of the inputs
+  for (const auto& path : inputPaths) {
+    if (!tool.addCacheFile(path))
+      return 1;
+  }
+
+  if (!tool.writeCacheFile(outputPath))
+    return 1;
+
+  const auto& stats = tool.getStats();
+
+  std::cout << std::endl
+    << stats.entriesRead << " entries read, "
+    << stats.entriesInvalid << " invalid, "
+    << stats.entriesDuplicate << " duplicate, "
+    << stats.entriesDropped << " dropped" << std::endl;
+  return 0;
+}